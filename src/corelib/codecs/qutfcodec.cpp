@@ -44,10 +44,38 @@
 #include "qendian.h"
 #include "qchar.h"
 
+#include "private/qsimd_p.h"
+
 QT_BEGIN_NAMESPACE
 
 enum { Endian = 0, Data = 1 };
 
+#if defined(__SSE2__)
+// Widens the ASCII characters at the start of src, 16 at a time, for as
+// long as at least 16 bytes are left. Returns the number of characters
+// converted; dst must have room for len characters.
+static inline int simdDecodeAscii(ushort *dst, const uchar *src, int len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for ( ; i + 16 <= len; i += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi8(data, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpackhi_epi8(data, zero));
+        uint mask = _mm_movemask_epi8(data);
+        if (mask) {
+            // keep the characters in front of the first non-ASCII byte
+            while (!(mask & 1)) {
+                mask >>= 1;
+                ++i;
+            }
+            return i;
+        }
+    }
+    return i;
+}
+#endif
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::ConverterState *state)
 {
     uchar replacement = '?';
@@ -173,6 +201,18 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     int invalid = 0;
 
     for (int i = 0; i < len; ++i) {
+#if defined(__SSE2__)
+        if (!need && len - i >= 16) {
+            const int ascii = simdDecodeAscii(qch, reinterpret_cast<const uchar *>(chars) + i, len - i);
+            if (ascii) {
+                qch += ascii;
+                i += ascii;
+                headerdone = true;
+                if (i == len)
+                    break;
+            }
+        }
+#endif
         ch = chars[i];
         if (need) {
             if ((ch&0xc0) == 0x80) {
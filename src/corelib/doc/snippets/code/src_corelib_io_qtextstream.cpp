@@ -127,3 +127,12 @@ stream << '\n' << flush;
 QTextStream out(&file);
 out.setCodec("UTF-8");
 //! [10]
+
+
+//! [11]
+QTextStream in(&file);
+QString line;
+while (in.readLineInto(&line)) {
+    ...
+}
+//! [11]
@@ -2,7 +2,10 @@
 
 HEADERS +=  \
         io/qabstractfileengine_p.h \
+        io/qasyncfile.h \
+        io/qasyncfile_p.h \
         io/qbuffer.h \
+        io/qcompressor_p.h \
         io/qdatastream.h \
         io/qdatastream_p.h \
         io/qdataurl_p.h \
@@ -36,6 +39,7 @@ HEADERS +=  \
         io/qurl_p.h \
         io/qurlquery.h \
         io/qurltlds_p.h \
+        io/qurlview_p.h \
         io/qtldurl_p.h \
         io/qsettings.h \
         io/qsettings_p.h \
@@ -51,7 +55,9 @@ HEADERS +=  \
 
 SOURCES += \
         io/qabstractfileengine.cpp \
+        io/qasyncfile.cpp \
         io/qbuffer.cpp \
+        io/qcompressor.cpp \
         io/qdatastream.cpp \
         io/qdataurl.cpp \
         io/qtldurl.cpp \
@@ -132,6 +138,8 @@ win32 {
             SOURCES += io/qstandardpaths_unix.cpp
         }
 
+        linux: SOURCES += io/qasyncfile_uring.cpp
+
         linux|if(qnx:contains(QT_CONFIG, inotify)) {
             SOURCES += io/qfilesystemwatcher_inotify.cpp
             HEADERS += io/qfilesystemwatcher_inotify_p.h
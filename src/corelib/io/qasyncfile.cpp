@@ -0,0 +1,552 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+#include "qasyncfile.h"
+#include "private/qasyncfile_p.h"
+
+#ifndef QT_NO_QFUTURE
+
+#include "qcoreapplication.h"
+#include "qrunnable.h"
+#include "qthread.h"
+#include "qthreadpool.h"
+
+#include <errno.h>
+
+#ifdef Q_OS_WIN
+#  include <io.h>
+#endif
+
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#  define QT_PREAD      ::pread64
+#  define QT_PWRITE     ::pwrite64
+#else
+#  define QT_PREAD      ::pread
+#  define QT_PWRITE     ::pwrite
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QAsyncFileRequest::QAsyncFileRequest(QAsyncFilePrivate *owner, Operation op, qint64 pos)
+    : file(owner), operation(op), handle(owner->handle), offset(pos), done(0)
+{
+    if (operation == Read)
+        readResult.reportStarted();
+    else
+        writeResult.reportStarted();
+}
+
+bool QAsyncFileRequest::isCanceled() const
+{
+    return operation == Read ? readResult.isCanceled() : writeResult.isCanceled();
+}
+
+/*!
+    \internal
+
+    Transfers what is left of the request on the calling thread. Returns 0
+    on success (including a short transfer at the end of the file), or the
+    system error code.
+*/
+int QAsyncFileRequest::perform()
+{
+    const int size = buffer.size();
+    while (done < size) {
+#ifdef Q_OS_WIN
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = DWORD(offset + done);
+        overlapped.OffsetHigh = DWORD((offset + done) >> 32);
+        DWORD transferred = 0;
+        BOOL ok;
+        if (operation == Read)
+            ok = ReadFile(handle, buffer.data() + done, DWORD(size - done), &transferred, &overlapped);
+        else
+            ok = WriteFile(handle, buffer.constData() + done, DWORD(size - done), &transferred, &overlapped);
+        if (!ok) {
+            const DWORD errorCode = GetLastError();
+            if (errorCode == ERROR_HANDLE_EOF)
+                break;
+            return int(errorCode);
+        }
+#else
+        qint64 transferred;
+        do {
+            if (operation == Read)
+                transferred = QT_PREAD(handle, buffer.data() + done, size - done, offset + done);
+            else
+                transferred = QT_PWRITE(handle, buffer.constData() + done, size - done, offset + done);
+        } while (transferred == -1 && errno == EINTR);
+        if (transferred == -1)
+            return errno;
+#endif
+        if (transferred == 0)
+            break;
+        done += int(transferred);
+    }
+    return 0;
+}
+
+/*!
+    \internal
+
+    Reports the outcome of the request to its future and to the file, then
+    deletes the request.
+*/
+void QAsyncFileRequest::finish(int errorCode)
+{
+    // set the error before reporting the result, so that it is visible to
+    // whoever waits for the future
+    if (errorCode)
+        file->setRequestError(operation, errorCode);
+
+    if (operation == Read) {
+        if (errorCode)
+            buffer.clear();
+        else
+            buffer.resize(done);
+        readResult.reportFinished(&buffer);
+    } else {
+        const qint64 written = errorCode ? qint64(-1) : qint64(done);
+        writeResult.reportFinished(&written);
+    }
+
+    // last, as close() and the destructor wait for it
+    file->requestFinished();
+    delete this;
+}
+
+namespace {
+class QAsyncFileRunnable : public QRunnable
+{
+public:
+    QAsyncFileRunnable(QAsyncFileRequest *r) : request(r) { }
+
+    void run()
+    {
+        request->finish(request->isCanceled() ? 0 : request->perform());
+    }
+
+    QAsyncFileRequest *request;
+};
+
+class QThreadPoolFileBackend : public QAsyncFileBackend
+{
+public:
+    QThreadPoolFileBackend()
+    {
+        // The threads spend their time blocked in the kernel rather than
+        // on a CPU, so allow a few more of them than there are cores.
+        pool.setMaxThreadCount(qMax(8, QThread::idealThreadCount() * 2));
+    }
+
+    void submit(QAsyncFileRequest *request)
+    {
+        pool.start(new QAsyncFileRunnable(request));
+    }
+
+    QThreadPool pool;
+};
+}
+
+Q_GLOBAL_STATIC(QThreadPoolFileBackend, threadPoolFileBackend)
+
+QAsyncFileBackend *QAsyncFileBackend::threadPoolBackend()
+{
+    return threadPoolFileBackend();
+}
+
+QAsyncFileBackend *QAsyncFileBackend::defaultBackend()
+{
+#ifdef QT_ASYNCFILE_IO_URING
+    if (QAsyncFileBackend *ring = ioUringBackend())
+        return ring;
+#endif
+    return threadPoolBackend();
+}
+
+QAsyncFilePrivate::QAsyncFilePrivate(const QString &fileName)
+    : file(fileName),
+#ifdef Q_OS_WIN
+      handle(INVALID_HANDLE_VALUE),
+#else
+      handle(-1),
+#endif
+      backend(0),
+      pending(0),
+      fileError(QFileDevice::NoError)
+{
+}
+
+void QAsyncFilePrivate::addRequest()
+{
+    QMutexLocker locker(&mutex);
+    ++pending;
+}
+
+void QAsyncFilePrivate::setRequestError(QAsyncFileRequest::Operation operation, int errorCode)
+{
+    QMutexLocker locker(&mutex);
+    if (fileError == QFileDevice::NoError) {
+        fileError = operation == QAsyncFileRequest::Read ? QFileDevice::ReadError : QFileDevice::WriteError;
+        fileErrorString = qt_error_string(errorCode);
+    }
+}
+
+void QAsyncFilePrivate::requestFinished()
+{
+    QMutexLocker locker(&mutex);
+    if (--pending == 0)
+        noPendingRequests.wakeAll();
+}
+
+void QAsyncFilePrivate::setError(QFileDevice::FileError err, const QString &errStr)
+{
+    QMutexLocker locker(&mutex);
+    fileError = err;
+    fileErrorString = errStr;
+}
+
+template <typename T>
+static QFuture<T> qt_finishedFuture(const T &result)
+{
+    QFutureInterface<T> futureInterface;
+    futureInterface.reportStarted();
+    futureInterface.reportFinished(&result);
+    return futureInterface.future();
+}
+
+/*!
+    \class QAsyncFile
+    \inmodule QtCore
+    \brief The QAsyncFile class provides positioned reads and writes on a
+    file that do not block the calling thread.
+
+    \ingroup io
+    \ingroup thread
+
+    \reentrant
+
+    \since 5.2
+
+    QFile reads and writes block the calling thread until the operating
+    system has transferred the data, which can take a long time on a slow
+    disk or a network file system. QAsyncFile instead queues each read()
+    and write() and returns a QFuture that reports the result once the
+    transfer has completed. Any number of requests can be outstanding on
+    the same file at once; each of them names the offset it applies to,
+    so they do not depend on one another and may complete in any order.
+
+    \snippet code/src_corelib_io_qasyncfile.cpp 0
+
+    Use QFutureWatcher to be notified with a signal when a request has
+    finished, or QFuture::waitForFinished() to block for it.
+
+    On Linux the requests are handed to the kernel through io_uring when it
+    is available, so that no thread is needed for each transfer in
+    flight. Elsewhere, or if the \c QT_NO_IO_URING environment variable is
+    set, they are run by a pool of threads shared by all QAsyncFile
+    objects.
+
+    Only local files can be opened; files in the Qt resource system or
+    provided by a custom file engine are not supported.
+
+    \sa QFile, QFuture, QFutureWatcher
+*/
+
+/*!
+    Constructs a QAsyncFile for the file called \a fileName.
+*/
+QAsyncFile::QAsyncFile(const QString &fileName)
+    : d_ptr(new QAsyncFilePrivate(fileName))
+{
+}
+
+/*!
+    Destroys the QAsyncFile, after waiting for the pending requests to
+    finish.
+*/
+QAsyncFile::~QAsyncFile()
+{
+    close();
+}
+
+/*!
+    Returns the name of the file.
+*/
+QString QAsyncFile::fileName() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.fileName();
+}
+
+/*!
+    Opens the file with the given \a mode, returning true if successful;
+    otherwise returns false.
+
+    QIODevice::Append is not supported, since every write names the offset
+    it applies to.
+
+    \sa QFile::open()
+*/
+bool QAsyncFile::open(QIODevice::OpenMode mode)
+{
+    Q_D(QAsyncFile);
+    if (d->file.isOpen()) {
+        qWarning("QAsyncFile::open: File (%s) already open", qPrintable(fileName()));
+        return false;
+    }
+    if (mode & QIODevice::Append) {
+        qWarning("QAsyncFile::open: Append mode is not supported");
+        return false;
+    }
+
+    unsetError();
+    if (!d->file.open(mode | QIODevice::Unbuffered)) {
+        d->setError(d->file.error(), d->file.errorString());
+        return false;
+    }
+
+    const int fd = d->file.handle();
+    if (fd == -1) {
+        d->file.close();
+        d->setError(QFileDevice::OpenError,
+                    QCoreApplication::translate("QAsyncFile", "Not a local file"));
+        return false;
+    }
+#ifdef Q_OS_WIN
+    d->handle = Qt::HANDLE(_get_osfhandle(fd));
+#else
+    d->handle = fd;
+#endif
+    d->backend = QAsyncFileBackend::defaultBackend();
+    return true;
+}
+
+/*!
+    Returns true if the file is open; otherwise returns false.
+*/
+bool QAsyncFile::isOpen() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.isOpen();
+}
+
+/*!
+    Returns the mode the file was opened with.
+*/
+QIODevice::OpenMode QAsyncFile::openMode() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.openMode() & ~QIODevice::Unbuffered;
+}
+
+/*!
+    Waits for the pending requests to finish, then closes the file.
+
+    \sa waitForPendingRequests()
+*/
+void QAsyncFile::close()
+{
+    Q_D(QAsyncFile);
+    if (!d->file.isOpen())
+        return;
+    waitForPendingRequests();
+    d->file.close();
+#ifdef Q_OS_WIN
+    d->handle = INVALID_HANDLE_VALUE;
+#else
+    d->handle = -1;
+#endif
+}
+
+/*!
+    Returns the size of the file.
+
+    Unlike read() and write(), this function asks the file system directly
+    and may block.
+*/
+qint64 QAsyncFile::size() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.size();
+}
+
+/*!
+    Queues a read of at most \a maxSize bytes starting at \a offset in the
+    file. The returned future reports the data that was read, which is
+    shorter than \a maxSize when the end of the file is reached, and empty
+    if \a offset is at or past the end of the file or if an error occurred.
+
+    Canceling the future before the request has started skips the read.
+
+    \sa write(), error()
+*/
+QFuture<QByteArray> QAsyncFile::read(qint64 offset, qint64 maxSize)
+{
+    Q_D(QAsyncFile);
+    if (!d->file.isOpen()) {
+        qWarning("QAsyncFile::read: File not open");
+        return qt_finishedFuture(QByteArray());
+    }
+    if (!(d->file.openMode() & QIODevice::ReadOnly)) {
+        qWarning("QAsyncFile::read: WriteOnly file");
+        return qt_finishedFuture(QByteArray());
+    }
+    if (offset < 0 || maxSize < 0) {
+        qWarning("QAsyncFile::read: Called with negative offset or maxSize");
+        return qt_finishedFuture(QByteArray());
+    }
+    if (maxSize > INT_MAX) {
+        qWarning("QAsyncFile::read: maxSize argument exceeds QByteArray size limit");
+        maxSize = INT_MAX;
+    }
+
+    QAsyncFileRequest *request = new QAsyncFileRequest(d, QAsyncFileRequest::Read, offset);
+    request->buffer.resize(int(maxSize));
+    const QFuture<QByteArray> future = request->readResult.future();
+    d->addRequest();
+    d->backend->submit(request);
+    return future;
+}
+
+/*!
+    Queues a write of \a data at \a offset in the file, growing the file if
+    needed. The returned future reports the number of bytes that were
+    written, or -1 if an error occurred.
+
+    The data is copied implicitly, so \a data can be modified right after
+    this function returns.
+
+    \sa read(), error()
+*/
+QFuture<qint64> QAsyncFile::write(qint64 offset, const QByteArray &data)
+{
+    Q_D(QAsyncFile);
+    if (!d->file.isOpen()) {
+        qWarning("QAsyncFile::write: File not open");
+        return qt_finishedFuture(qint64(-1));
+    }
+    if (!(d->file.openMode() & QIODevice::WriteOnly)) {
+        qWarning("QAsyncFile::write: ReadOnly file");
+        return qt_finishedFuture(qint64(-1));
+    }
+    if (offset < 0) {
+        qWarning("QAsyncFile::write: Called with negative offset");
+        return qt_finishedFuture(qint64(-1));
+    }
+
+    QAsyncFileRequest *request = new QAsyncFileRequest(d, QAsyncFileRequest::Write, offset);
+    request->buffer = data;
+    const QFuture<qint64> future = request->writeResult.future();
+    d->addRequest();
+    d->backend->submit(request);
+    return future;
+}
+
+/*!
+    Returns the number of requests that have been queued and have not
+    finished yet. A request is counted until shortly after its future has
+    reported the result.
+
+    \sa waitForPendingRequests()
+*/
+int QAsyncFile::pendingRequests() const
+{
+    Q_D(const QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    return d->pending;
+}
+
+/*!
+    Blocks until all the queued requests have finished and their futures
+    have reported the results.
+*/
+void QAsyncFile::waitForPendingRequests()
+{
+    Q_D(QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    while (d->pending)
+        d->noPendingRequests.wait(&d->mutex);
+}
+
+/*!
+    Returns the first error that occurred since the file was opened or
+    unsetError() was called. Errors of read and write requests are reported
+    as QFileDevice::ReadError and QFileDevice::WriteError.
+
+    \sa unsetError()
+*/
+QFileDevice::FileError QAsyncFile::error() const
+{
+    Q_D(const QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    return d->fileError;
+}
+
+/*!
+    Returns a human-readable description of the error returned by error().
+*/
+QString QAsyncFile::errorString() const
+{
+    Q_D(const QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    return d->fileError == QFileDevice::NoError
+            ? QCoreApplication::translate("QAsyncFile", "No error")
+            : d->fileErrorString;
+}
+
+/*!
+    Sets the file's error to QFileDevice::NoError.
+
+    \sa error()
+*/
+void QAsyncFile::unsetError()
+{
+    Q_D(QAsyncFile);
+    d->setError(QFileDevice::NoError, QString());
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_QFUTURE
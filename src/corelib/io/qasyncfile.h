@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QASYNCFILE_H
+#define QASYNCFILE_H
+
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qscopedpointer.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_QFUTURE
+
+class QAsyncFilePrivate;
+
+class Q_CORE_EXPORT QAsyncFile
+{
+public:
+    explicit QAsyncFile(const QString &fileName);
+    ~QAsyncFile();
+
+    QString fileName() const;
+
+    bool open(QIODevice::OpenMode mode);
+    bool isOpen() const;
+    QIODevice::OpenMode openMode() const;
+    void close();
+
+    qint64 size() const;
+
+    QFuture<QByteArray> read(qint64 offset, qint64 maxSize);
+    QFuture<qint64> write(qint64 offset, const QByteArray &data);
+
+    int pendingRequests() const;
+    void waitForPendingRequests();
+
+    QFileDevice::FileError error() const;
+    QString errorString() const;
+    void unsetError();
+
+protected:
+    QScopedPointer<QAsyncFilePrivate> d_ptr;
+
+private:
+    Q_DECLARE_PRIVATE(QAsyncFile)
+    Q_DISABLE_COPY(QAsyncFile)
+};
+
+#endif // QT_NO_QFUTURE
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QASYNCFILE_H
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QASYNCFILE_P_H
+#define QASYNCFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasyncfile.h"
+#include <QtCore/qfile.h>
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+
+#ifndef QT_NO_QFUTURE
+
+#if defined(Q_OS_LINUX) && defined(Q_CC_GNU) && !defined(QT_NO_IO_URING)
+#  define QT_ASYNCFILE_IO_URING
+#  include <sys/uio.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+class QAsyncFilePrivate;
+
+// One positioned read or write, handed to a QAsyncFileBackend. The backend
+// transfers the data (perform() does it synchronously on the calling
+// thread) and then calls finish(), which reports the result to the future
+// and deletes the request.
+class QAsyncFileRequest
+{
+public:
+    enum Operation { Read, Write };
+
+    QAsyncFileRequest(QAsyncFilePrivate *owner, Operation op, qint64 pos);
+
+    bool isCanceled() const;
+    int perform();
+    void finish(int errorCode);
+
+    QAsyncFilePrivate *file;
+    Operation operation;
+#ifdef Q_OS_WIN
+    Qt::HANDLE handle;
+#else
+    int handle;
+#endif
+    qint64 offset;
+    QByteArray buffer;
+    int done;               // bytes transferred so far
+#ifdef QT_ASYNCFILE_IO_URING
+    struct iovec iov;
+#endif
+
+    QFutureInterface<QByteArray> readResult;
+    QFutureInterface<qint64> writeResult;
+};
+
+class Q_AUTOTEST_EXPORT QAsyncFileBackend
+{
+public:
+    virtual ~QAsyncFileBackend() { }
+    virtual void submit(QAsyncFileRequest *request) = 0;
+
+    static QAsyncFileBackend *defaultBackend();
+    static QAsyncFileBackend *threadPoolBackend();
+#ifdef QT_ASYNCFILE_IO_URING
+    static QAsyncFileBackend *ioUringBackend();
+#endif
+};
+
+class QAsyncFilePrivate
+{
+public:
+    QAsyncFilePrivate(const QString &fileName);
+
+    void addRequest();
+    void setRequestError(QAsyncFileRequest::Operation operation, int errorCode);
+    void requestFinished();
+    void setError(QFileDevice::FileError err, const QString &errStr);
+
+    static QAsyncFilePrivate *get(QAsyncFile *file) { return file->d_func(); }
+
+    QFile file;
+#ifdef Q_OS_WIN
+    Qt::HANDLE handle;
+#else
+    int handle;
+#endif
+    QAsyncFileBackend *backend;
+
+    mutable QMutex mutex;
+    QWaitCondition noPendingRequests;
+    int pending;
+    QFileDevice::FileError fileError;
+    QString fileErrorString;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_QFUTURE
+
+#endif // QASYNCFILE_P_H
@@ -0,0 +1,480 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+#include "private/qasyncfile_p.h"
+
+#ifdef QT_ASYNCFILE_IO_URING
+
+#include "qqueue.h"
+#include "private/qcore_unix_p.h"
+#include "qthread.h"
+#include "qvarlengtharray.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// The io_uring system calls and structures are declared here rather than
+// taken from <linux/io_uring.h>, so that building does not depend on the
+// kernel headers being recent enough. The ABI is stable.
+#if !defined(SYS_io_uring_setup)
+#  if defined(__alpha__)
+#    define SYS_io_uring_setup 535
+#    define SYS_io_uring_enter 536
+#  else
+#    define SYS_io_uring_setup 425
+#    define SYS_io_uring_enter 426
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct qt_io_sqring_offsets
+{
+    quint32 head, tail, ring_mask, ring_entries, flags, dropped, array, resv1;
+    quint64 resv2;
+};
+
+struct qt_io_cqring_offsets
+{
+    quint32 head, tail, ring_mask, ring_entries, overflow, cqes, flags, resv1;
+    quint64 resv2;
+};
+
+struct qt_io_uring_params
+{
+    quint32 sq_entries, cq_entries, flags, sq_thread_cpu, sq_thread_idle, features, wq_fd, resv[3];
+    qt_io_sqring_offsets sq_off;
+    qt_io_cqring_offsets cq_off;
+};
+
+struct qt_io_uring_sqe
+{
+    quint8 opcode;
+    quint8 flags;
+    quint16 ioprio;
+    qint32 fd;
+    quint64 off;
+    quint64 addr;
+    quint32 len;
+    quint32 rw_flags;
+    quint64 user_data;
+    quint64 pad[3];
+};
+
+struct qt_io_uring_cqe
+{
+    quint64 user_data;
+    qint32 res;
+    quint32 flags;
+};
+
+Q_STATIC_ASSERT(sizeof(qt_io_uring_params) == 120);
+Q_STATIC_ASSERT(sizeof(qt_io_uring_sqe) == 64);
+Q_STATIC_ASSERT(sizeof(qt_io_uring_cqe) == 16);
+
+enum {
+    IoUringOpNop = 0,
+    IoUringOpReadv = 1,
+    IoUringOpWritev = 2
+};
+
+enum {
+    IoUringOffSqRing = 0,
+    IoUringOffCqRing = 0x8000000,
+    IoUringOffSqes = 0x10000000
+};
+
+enum {
+    IoUringEnterGetEvents = 1
+};
+
+// Kept small: the rings are locked memory, which is limited for
+// unprivileged processes. Requests beyond this wait in the backlog.
+enum { IoUringQueueDepth = 64 };
+
+class QIoUringFileBackend : public QAsyncFileBackend
+{
+public:
+    QIoUringFileBackend();
+    ~QIoUringFileBackend();
+
+    bool isValid() const { return ringFd != -1; }
+    void submit(QAsyncFileRequest *request);
+
+private:
+    class CompletionThread : public QThread
+    {
+    public:
+        CompletionThread(QIoUringFileBackend *owner) : backend(owner) { }
+        void run() { backend->processCompletions(); }
+
+        QIoUringFileBackend *backend;
+    };
+
+    struct Completion
+    {
+        QAsyncFileRequest *request;
+        int errorCode;
+    };
+    typedef QVarLengthArray<Completion, IoUringQueueDepth> CompletionList;
+
+    bool setup();
+    void release();
+    void fillQueue(CompletionList *finished);
+    int publish(quint32 tail);
+    void processCompletions();
+
+    int ringFd;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    qt_io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    quint32 *sqHead;
+    quint32 *sqTail;
+    quint32 *sqArray;
+    quint32 sqMask;
+    quint32 sqEntries;
+    quint32 *cqHead;
+    quint32 *cqTail;
+    quint32 cqMask;
+    qt_io_uring_cqe *cqes;
+
+    // protects the submission queue and the fields below
+    QMutex mutex;
+    QQueue<QAsyncFileRequest *> backlog;
+    quint32 inFlight;
+
+    CompletionThread thread;
+};
+}
+
+QIoUringFileBackend::QIoUringFileBackend()
+    : ringFd(-1), sqRing(MAP_FAILED), sqRingSize(0), cqRing(MAP_FAILED), cqRingSize(0),
+      sqes(static_cast<qt_io_uring_sqe *>(MAP_FAILED)), sqesSize(0), inFlight(0), thread(this)
+{
+    if (setup())
+        thread.start();
+    else
+        release();
+}
+
+QIoUringFileBackend::~QIoUringFileBackend()
+{
+    if (thread.isRunning()) {
+        // A NOP without a request tells the completion thread to exit. There
+        // is always room for it, see fillQueue().
+        QMutexLocker locker(&mutex);
+        int error;
+        forever {
+            const quint32 tail = *sqTail;
+            const quint32 index = tail & sqMask;
+            memset(sqes + index, 0, sizeof(qt_io_uring_sqe));
+            sqes[index].opcode = IoUringOpNop;
+            sqArray[index] = index;
+            error = publish(tail + 1);
+            if (error != EAGAIN && error != EBUSY)
+                break;
+            // the kernel is short of resources or has completions to
+            // deliver first, which the completion thread picks up
+            __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+            locker.unlock();
+            QThread::yieldCurrentThread();
+            locker.relock();
+        }
+        locker.unlock();
+        if (error) {
+            // the thread cannot be stopped and still uses the ring
+            return;
+        }
+        thread.wait();
+    }
+    release();
+}
+
+bool QIoUringFileBackend::setup()
+{
+    qt_io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = syscall(SYS_io_uring_setup, IoUringQueueDepth, &params);
+    if (ringFd == -1)
+        return false;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(quint32);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(qt_io_uring_cqe);
+    sqesSize = params.sq_entries * sizeof(qt_io_uring_sqe);
+    sqRing = ::mmap(0, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ringFd, IoUringOffSqRing);
+    cqRing = ::mmap(0, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ringFd, IoUringOffCqRing);
+    sqes = static_cast<qt_io_uring_sqe *>(::mmap(0, sqesSize, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE,
+                                                 ringFd, IoUringOffSqes));
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == MAP_FAILED)
+        return false;
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<quint32 *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<quint32 *>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<quint32 *>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<quint32 *>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<quint32 *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<quint32 *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<quint32 *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<qt_io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void QIoUringFileBackend::release()
+{
+    if (sqes != MAP_FAILED)
+        ::munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED)
+        ::munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        ::munmap(sqRing, sqRingSize);
+    if (ringFd != -1)
+        qt_safe_close(ringFd);
+    ringFd = -1;
+}
+
+void QIoUringFileBackend::submit(QAsyncFileRequest *request)
+{
+    CompletionList finished;
+    {
+        QMutexLocker locker(&mutex);
+        backlog.enqueue(request);
+        fillQueue(&finished);
+    }
+    for (int i = 0; i < finished.size(); ++i)
+        finished.at(i).request->finish(finished.at(i).errorCode);
+}
+
+/*!
+    \internal
+
+    Moves requests from the backlog to the submission queue and hands them
+    to the kernel. One entry is kept free for the NOP sent on destruction;
+    as the completion queue is twice as large as the submission queue, it
+    never overflows. Must be called with the mutex locked.
+
+    Canceled requests, and requests the kernel refused with nothing else
+    in flight to retry them after, are added to \a finished.
+*/
+void QIoUringFileBackend::fillQueue(CompletionList *finished)
+{
+    quint32 tail = *sqTail;
+    bool queued = false;
+    while (!backlog.isEmpty() && inFlight < sqEntries - 1) {
+        QAsyncFileRequest *request = backlog.dequeue();
+        if (request->done == 0 && request->isCanceled()) {
+            Completion completion = { request, 0 };
+            finished->append(completion);
+            continue;
+        }
+
+        const quint32 index = tail & sqMask;
+        qt_io_uring_sqe *sqe = sqes + index;
+        memset(sqe, 0, sizeof(qt_io_uring_sqe));
+        request->iov.iov_base = const_cast<char *>(request->buffer.constData()) + request->done;
+        request->iov.iov_len = request->buffer.size() - request->done;
+        sqe->opcode = request->operation == QAsyncFileRequest::Read ? IoUringOpReadv : IoUringOpWritev;
+        sqe->fd = request->handle;
+        sqe->off = request->offset + request->done;
+        sqe->addr = quintptr(&request->iov);
+        sqe->len = 1;
+        sqe->user_data = quintptr(request);
+        sqArray[index] = index;
+
+        ++tail;
+        ++inFlight;
+        queued = true;
+    }
+    if (!queued)
+        return;
+
+    const int error = publish(tail);
+    if (!error)
+        return;
+
+    // Take back the entries the kernel did not consume. Only io_uring_enter()
+    // with entries to submit consumes them, and that is always called with
+    // the mutex locked.
+    const quint32 head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+    inFlight -= tail - head;
+    const bool retry = inFlight > 0 && (error == EAGAIN || error == EBUSY);
+    for (quint32 i = tail; i != head; --i) {
+        QAsyncFileRequest *request =
+                reinterpret_cast<QAsyncFileRequest *>(quintptr(sqes[(i - 1) & sqMask].user_data));
+        if (retry) {
+            // submitted again when a request in flight completes
+            backlog.prepend(request);
+        } else {
+            Completion completion = { request, error };
+            finished->append(completion);
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Makes the entries of the submission queue up to \a tail visible to the
+    kernel and submits them. Returns 0 if the kernel consumed all of them,
+    otherwise an error code; EAGAIN and EBUSY mean that it should be tried
+    again later. The entries that were not consumed stay in the queue.
+*/
+int QIoUringFileBackend::publish(quint32 tail)
+{
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    const quint32 toSubmit = tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    int ret;
+    do {
+        ret = syscall(SYS_io_uring_enter, ringFd, toSubmit, 0, 0, 0, 0);
+    } while (ret == -1 && errno == EINTR);
+    if (ret == -1) {
+        const int error = errno;
+        if (error != EAGAIN && error != EBUSY)
+            qErrnoWarning(error, "QAsyncFile: io_uring_enter() failed");
+        return error;
+    }
+    // a submission stops early when the kernel runs short of resources
+    return quint32(ret) < toSubmit ? EAGAIN : 0;
+}
+
+void QIoUringFileBackend::processCompletions()
+{
+    forever {
+        const int ret = syscall(SYS_io_uring_enter, ringFd, 0, 1, IoUringEnterGetEvents, 0, 0);
+        if (ret == -1 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            qErrnoWarning("QAsyncFile: io_uring_enter() failed");
+            return;
+        }
+
+        CompletionList finished;
+        QVarLengthArray<QAsyncFileRequest *, IoUringQueueDepth> unfinished;
+        quint32 completed = 0;
+        bool stop = false;
+
+        quint32 head = *cqHead;
+        const quint32 tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for ( ; head != tail; ++head) {
+            const qt_io_uring_cqe &cqe = cqes[head & cqMask];
+            QAsyncFileRequest *request = reinterpret_cast<QAsyncFileRequest *>(quintptr(cqe.user_data));
+            if (!request) {
+                stop = true;
+                continue;
+            }
+            ++completed;
+
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                unfinished.append(request);
+            } else if (cqe.res < 0) {
+                Completion completion = { request, -cqe.res };
+                finished.append(completion);
+            } else if (cqe.res > 0 && (request->done += cqe.res) < request->buffer.size()) {
+                // short transfer: ask for the rest, a read stops at the end
+                // of the file when it gets 0 bytes back
+                unfinished.append(request);
+            } else {
+                Completion completion = { request, 0 };
+                finished.append(completion);
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        if (completed) {
+            QMutexLocker locker(&mutex);
+            inFlight -= completed;
+            for (int i = unfinished.size() - 1; i >= 0; --i)
+                backlog.prepend(unfinished.at(i));
+            fillQueue(&finished);
+        }
+        for (int i = 0; i < finished.size(); ++i)
+            finished.at(i).request->finish(finished.at(i).errorCode);
+
+        if (stop)
+            return;
+    }
+}
+
+namespace {
+struct QIoUringHolder
+{
+    QIoUringHolder()
+        : backend(0)
+    {
+        if (qEnvironmentVariableIsSet("QT_NO_IO_URING"))
+            return;
+        QIoUringFileBackend *ring = new QIoUringFileBackend;
+        if (ring->isValid())
+            backend = ring;
+        else
+            delete ring;
+    }
+    ~QIoUringHolder() { delete backend; }
+
+    QIoUringFileBackend *backend;
+};
+}
+
+Q_GLOBAL_STATIC(QIoUringHolder, ioUringHolder)
+
+QAsyncFileBackend *QAsyncFileBackend::ioUringBackend()
+{
+    QIoUringHolder *holder = ioUringHolder();
+    return holder ? holder->backend : 0;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_ASYNCFILE_IO_URING
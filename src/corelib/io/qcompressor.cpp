@@ -0,0 +1,783 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcompressor_p.h"
+
+#ifndef QT_NO_COMPRESS
+
+#include "private/qiodevice_p.h"
+#include "private/qbytedata_p.h"
+
+#include <limits.h>
+#include <zlib.h>
+
+QT_BEGIN_NAMESPACE
+
+// Size of the buffer each stream keeps for its input or output. All data
+// passes through it, so the memory used by a stream does not depend on the
+// amount of data or on the size of the chunks it is given.
+enum { BufferSize = 32 * 1024 };
+
+// zlib counts in uInt, so longer input is handed over in pieces
+static const qint64 MaxChunkSize = Q_INT64_C(1) << 30;
+
+static QString zlibErrorString(const z_stream &stream, int ret)
+{
+    if (stream.msg)
+        return QString::fromLatin1(stream.msg);
+    if (ret == Z_MEM_ERROR)
+        return QIODevice::tr("Not enough memory");
+    return QIODevice::tr("Invalid compressed data");
+}
+
+static inline bool isEndOfInput(QIODevice *device, qint64 haveRead)
+{
+    // sequential devices signal the end with -1, random-access ones by
+    // returning no data at the end of the device
+    return haveRead < 0 || (haveRead == 0 && !device->isSequential() && device->atEnd());
+}
+
+/*!
+    \internal
+    \class QCompressor
+    \inmodule QtCore
+
+    \brief The QCompressor class compresses a stream of data with zlib.
+
+    QCompressor can be used in three ways:
+
+    \list
+    \li Opened in ReadOnly mode on top of a readable device, reading from
+        it returns the compressed contents of that device.
+    \li Opened in WriteOnly mode on top of a writable device, the data
+        written to it is compressed and written to that device. The stream
+        is completed by close().
+    \li Without a device, compress() and finish() compress data chunk by
+        chunk and append the result to a QByteDataBuffer.
+    \endlist
+
+    The data only passes through a fixed size buffer, so the memory used is
+    independent of the size of the stream. When reading, the compressed
+    data is written directly into the caller's buffer.
+
+    \sa QDecompressor
+*/
+
+class QCompressorPrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QCompressor)
+public:
+    QCompressorPrivate(QIODevice *device, QCompressor::Format format, int compressionLevel);
+    ~QCompressorPrivate();
+
+    bool initialize();
+    int deflateInto(char *out, int outSize, int flush, int *produced);
+    bool flushBuffer();
+
+    QIODevice *device;
+    QCompressor::Format format;
+    int compressionLevel;
+    z_stream stream;
+    bool initialized;
+    bool inputAtEnd;
+    bool streamEnd;
+    int bufferUsed;
+    char buffer[BufferSize];
+};
+
+QCompressorPrivate::QCompressorPrivate(QIODevice *device, QCompressor::Format format, int compressionLevel)
+    : device(device),
+      format(format),
+      compressionLevel(compressionLevel),
+      initialized(false),
+      inputAtEnd(false),
+      streamEnd(false),
+      bufferUsed(0)
+{
+    memset(&stream, 0, sizeof stream);
+    initialize();
+}
+
+QCompressorPrivate::~QCompressorPrivate()
+{
+    if (initialized)
+        deflateEnd(&stream);
+}
+
+bool QCompressorPrivate::initialize()
+{
+    inputAtEnd = false;
+    streamEnd = false;
+    bufferUsed = 0;
+    if (initialized) {
+        initialized = (deflateReset(&stream) == Z_OK);
+    } else {
+        int windowBits = MAX_WBITS;
+        if (format == QCompressor::GzipFormat)
+            windowBits += 16;
+        else if (format == QCompressor::RawDeflateFormat)
+            windowBits = -windowBits;
+        const int level = compressionLevel < 0 ? Z_DEFAULT_COMPRESSION : qMin(compressionLevel, 9);
+        const int ret = deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+        initialized = (ret == Z_OK);
+        if (!initialized)
+            errorString = zlibErrorString(stream, ret);
+    }
+    return initialized;
+}
+
+int QCompressorPrivate::deflateInto(char *out, int outSize, int flush, int *produced)
+{
+    stream.next_out = reinterpret_cast<Bytef *>(out);
+    stream.avail_out = uInt(outSize);
+    const int ret = deflate(&stream, flush);
+    *produced = outSize - int(stream.avail_out);
+    if (ret == Z_STREAM_END)
+        streamEnd = true;
+    else if (ret == Z_STREAM_ERROR)
+        errorString = zlibErrorString(stream, ret);
+    return ret;
+}
+
+bool QCompressorPrivate::flushBuffer()
+{
+    if (bufferUsed && device->write(buffer, bufferUsed) != bufferUsed) {
+        errorString = device->errorString();
+        return false;
+    }
+    bufferUsed = 0;
+    return true;
+}
+
+/*!
+    Constructs a compressor for use with compress() and finish(), producing
+    a stream of the given \a format at \a compressionLevel (0 to 9, -1 for
+    the zlib default).
+*/
+QCompressor::QCompressor(Format format, int compressionLevel)
+    : QIODevice(*new QCompressorPrivate(0, format, compressionLevel), 0)
+{
+}
+
+/*!
+    Constructs a compressor on top of \a device, with the given \a parent.
+    Open it in ReadOnly mode to read the compressed contents of \a device,
+    or in WriteOnly mode to compress the data written to it into \a device.
+*/
+QCompressor::QCompressor(QIODevice *device, Format format, int compressionLevel, QObject *parent)
+    : QIODevice(*new QCompressorPrivate(device, format, compressionLevel), parent)
+{
+}
+
+/*!
+    Destroys the compressor, closing it first if it is open.
+*/
+QCompressor::~QCompressor()
+{
+    close();
+}
+
+QCompressor::Format QCompressor::format() const
+{
+    Q_D(const QCompressor);
+    return d->format;
+}
+
+QIODevice *QCompressor::device() const
+{
+    Q_D(const QCompressor);
+    return d->device;
+}
+
+/*!
+    \reimp
+
+    Opens the compressor in either ReadOnly or WriteOnly mode. The
+    underlying device has to be open in the same mode. Opening the
+    compressor again after close() starts a new stream.
+*/
+bool QCompressor::open(OpenMode mode)
+{
+    Q_D(QCompressor);
+    const OpenMode direction = mode & ReadWrite;
+    if (!d->device || (direction != ReadOnly && direction != WriteOnly)) {
+        qWarning("QCompressor::open: needs a device and either ReadOnly or WriteOnly mode");
+        return false;
+    }
+    if ((d->device->openMode() & direction) != direction) {
+        setErrorString(tr("The underlying device is not open"));
+        return false;
+    }
+    if (!d->initialize())
+        return false;
+
+    if (direction == ReadOnly) {
+        connect(d->device, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+        connect(d->device, SIGNAL(readChannelFinished()), this, SIGNAL(readyRead()));
+    }
+    return QIODevice::open(mode | Unbuffered);
+}
+
+/*!
+    \reimp
+
+    In WriteOnly mode, this completes the compressed stream and writes
+    the rest of it to the underlying device.
+*/
+void QCompressor::close()
+{
+    Q_D(QCompressor);
+    if (!isOpen())
+        return;
+
+    if ((openMode() & WriteOnly) && d->initialized && !d->streamEnd) {
+        d->stream.next_in = 0;
+        d->stream.avail_in = 0;
+        forever {
+            int produced;
+            const int ret = d->deflateInto(d->buffer + d->bufferUsed, BufferSize - d->bufferUsed,
+                                           Z_FINISH, &produced);
+            d->bufferUsed += produced;
+            if (!d->flushBuffer() || ret == Z_STREAM_END || ret == Z_STREAM_ERROR)
+                break;
+        }
+    }
+    if (d->device)
+        disconnect(d->device, 0, this, 0);
+    QIODevice::close();
+}
+
+bool QCompressor::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    Returns true once the end of the compressed stream has been produced.
+*/
+bool QCompressor::atEnd() const
+{
+    Q_D(const QCompressor);
+    return d->streamEnd;
+}
+
+bool QCompressor::waitForReadyRead(int msecs)
+{
+    Q_D(QCompressor);
+    return d->device && d->device->waitForReadyRead(msecs);
+}
+
+/*!
+    Compresses \a size bytes at \a data and appends the compressed data
+    that is ready to \a out. Returns false if an error occurred.
+
+    \sa finish()
+*/
+bool QCompressor::compress(const char *data, qint64 size, QByteDataBuffer *out)
+{
+    Q_D(QCompressor);
+    if (!d->initialized || d->streamEnd)
+        return false;
+
+    while (size > 0) {
+        const qint64 chunk = qMin(size, MaxChunkSize);
+        d->stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        d->stream.avail_in = uInt(chunk);
+        forever {
+            int produced;
+            if (d->deflateInto(d->buffer, BufferSize, Z_NO_FLUSH, &produced) == Z_STREAM_ERROR)
+                return false;
+            if (produced)
+                out->append(QByteArray(d->buffer, produced));
+            if (d->stream.avail_in == 0 && produced < BufferSize)
+                break;
+        }
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/*!
+    Completes the compressed stream and appends the rest of it to \a out.
+    Returns false if an error occurred.
+
+    \sa compress()
+*/
+bool QCompressor::finish(QByteDataBuffer *out)
+{
+    Q_D(QCompressor);
+    if (!d->initialized || d->streamEnd)
+        return false;
+
+    d->stream.next_in = 0;
+    d->stream.avail_in = 0;
+    forever {
+        int produced;
+        const int ret = d->deflateInto(d->buffer, BufferSize, Z_FINISH, &produced);
+        if (ret == Z_STREAM_ERROR)
+            return false;
+        if (produced)
+            out->append(QByteArray(d->buffer, produced));
+        if (ret == Z_STREAM_END)
+            return true;
+    }
+}
+
+qint64 QCompressor::readData(char *data, qint64 maxSize)
+{
+    Q_D(QCompressor);
+    if (!d->initialized || d->streamEnd)
+        return -1;
+
+    qint64 total = 0;
+    while (total < maxSize && !d->streamEnd) {
+        if (d->stream.avail_in == 0 && !d->inputAtEnd) {
+            const qint64 haveRead = d->device->read(d->buffer, BufferSize);
+            if (isEndOfInput(d->device, haveRead)) {
+                d->inputAtEnd = true;
+            } else if (haveRead == 0) {
+                break; // read more later
+            } else {
+                d->stream.next_in = reinterpret_cast<Bytef *>(d->buffer);
+                d->stream.avail_in = uInt(haveRead);
+            }
+        }
+
+        int produced;
+        const int chunk = int(qMin(maxSize - total, qint64(INT_MAX)));
+        const int ret = d->deflateInto(data + total, chunk, d->inputAtEnd ? Z_FINISH : Z_NO_FLUSH, &produced);
+        if (ret == Z_STREAM_ERROR)
+            return total ? total : qint64(-1);
+        total += produced;
+    }
+    return total;
+}
+
+qint64 QCompressor::writeData(const char *data, qint64 size)
+{
+    Q_D(QCompressor);
+    if (!d->initialized || d->streamEnd)
+        return -1;
+
+    for (qint64 written = 0; written < size; ) {
+        const qint64 chunk = qMin(size - written, MaxChunkSize);
+        d->stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data + written));
+        d->stream.avail_in = uInt(chunk);
+        forever {
+            int produced;
+            if (d->deflateInto(d->buffer + d->bufferUsed, BufferSize - d->bufferUsed,
+                               Z_NO_FLUSH, &produced) == Z_STREAM_ERROR) {
+                return -1;
+            }
+            d->bufferUsed += produced;
+            if (d->bufferUsed == BufferSize && !d->flushBuffer())
+                return -1;
+            if (d->stream.avail_in == 0 && d->bufferUsed < BufferSize)
+                break;
+        }
+        written += chunk;
+    }
+    return size;
+}
+
+/*!
+    \internal
+    \class QDecompressor
+    \inmodule QtCore
+
+    \brief The QDecompressor class decompresses a zlib, gzip or raw
+    deflate stream.
+
+    Like QCompressor, it can be read from on top of a device holding the
+    compressed data, written to on top of a device receiving the
+    decompressed data, or be fed with chunks of compressed data through
+    decompress().
+
+    AutoDetectFormat accepts zlib and gzip streams, and raw deflate data
+    as sent by some HTTP servers for "Content-Encoding: deflate".
+
+    \sa QCompressor
+*/
+
+class QDecompressorPrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QDecompressor)
+public:
+    QDecompressorPrivate(QIODevice *device, QDecompressor::Format format);
+    ~QDecompressorPrivate();
+
+    bool initialize(int windowBits);
+    void setInput(const char *data, qint64 size);
+    bool restartAsRawDeflate();
+    int inflateInto(char *out, int outSize, int *produced);
+    void fail(int ret);
+
+    QIODevice *device;
+    QDecompressor::Format format;
+    z_stream stream;
+    bool initialized;
+    bool streamEnd;
+    bool failed;
+    bool triedRawDeflate;
+    // the input that started the stream, for restarting it as raw deflate
+    const char *firstInput;
+    qint64 firstInputSize;
+    char buffer[BufferSize];
+};
+
+QDecompressorPrivate::QDecompressorPrivate(QIODevice *device, QDecompressor::Format format)
+    : device(device),
+      format(format),
+      initialized(false),
+      streamEnd(false),
+      failed(false),
+      triedRawDeflate(false),
+      firstInput(0),
+      firstInputSize(0)
+{
+    memset(&stream, 0, sizeof stream);
+}
+
+QDecompressorPrivate::~QDecompressorPrivate()
+{
+    if (initialized)
+        inflateEnd(&stream);
+}
+
+bool QDecompressorPrivate::initialize(int windowBits)
+{
+    if (initialized)
+        inflateEnd(&stream);
+    memset(&stream, 0, sizeof stream);
+    streamEnd = false;
+    failed = false;
+    firstInput = 0;
+    firstInputSize = 0;
+
+    const int ret = inflateInit2(&stream, windowBits);
+    initialized = (ret == Z_OK);
+    if (!initialized) {
+        errorString = zlibErrorString(stream, ret);
+        failed = true;
+    }
+    return initialized;
+}
+
+void QDecompressorPrivate::setInput(const char *data, qint64 size)
+{
+    if (stream.total_in == 0 && !triedRawDeflate) {
+        firstInput = data;
+        firstInputSize = size;
+    } else {
+        firstInput = 0;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = uInt(size);
+}
+
+bool QDecompressorPrivate::restartAsRawDeflate()
+{
+    // Some servers send raw deflate data for "deflate" instead of a zlib
+    // stream. That can only be told apart from corrupt data by the first
+    // error, so start over as raw deflate if nothing was produced yet.
+    if (format != QDecompressor::AutoDetectFormat || triedRawDeflate
+        || !firstInput || stream.total_out != 0) {
+        return false;
+    }
+    const char *data = firstInput;
+    const qint64 size = firstInputSize;
+    triedRawDeflate = true;
+    if (!initialize(-MAX_WBITS))
+        return false;
+    setInput(data, size);
+    return true;
+}
+
+int QDecompressorPrivate::inflateInto(char *out, int outSize, int *produced)
+{
+    stream.next_out = reinterpret_cast<Bytef *>(out);
+    stream.avail_out = uInt(outSize);
+    const int ret = inflate(&stream, Z_NO_FLUSH);
+    *produced = outSize - int(stream.avail_out);
+    if (ret == Z_STREAM_END)
+        streamEnd = true;
+    return ret;
+}
+
+void QDecompressorPrivate::fail(int ret)
+{
+    failed = true;
+    errorString = zlibErrorString(stream, ret);
+}
+
+static inline bool isInflateError(int ret)
+{
+    // Z_BUF_ERROR only means that no progress was possible
+    return ret == Z_NEED_DICT || (ret < 0 && ret != Z_BUF_ERROR);
+}
+
+static int windowBitsForFormat(QDecompressor::Format format)
+{
+    switch (format) {
+    case QDecompressor::ZlibFormat:
+        return MAX_WBITS;
+    case QDecompressor::GzipFormat:
+        return MAX_WBITS + 16;
+    case QDecompressor::RawDeflateFormat:
+        return -MAX_WBITS;
+    case QDecompressor::AutoDetectFormat:
+        break;
+    }
+    return MAX_WBITS + 32;
+}
+
+/*!
+    Constructs a decompressor for use with decompress(), expecting data of
+    the given \a format.
+*/
+QDecompressor::QDecompressor(Format format)
+    : QIODevice(*new QDecompressorPrivate(0, format), 0)
+{
+    Q_D(QDecompressor);
+    d->initialize(windowBitsForFormat(format));
+}
+
+/*!
+    Constructs a decompressor on top of \a device, with the given \a parent.
+    Open it in ReadOnly mode to read the decompressed contents of \a device,
+    or in WriteOnly mode to decompress the data written to it into
+    \a device.
+*/
+QDecompressor::QDecompressor(QIODevice *device, Format format, QObject *parent)
+    : QIODevice(*new QDecompressorPrivate(device, format), parent)
+{
+    Q_D(QDecompressor);
+    d->initialize(windowBitsForFormat(format));
+}
+
+/*!
+    Destroys the decompressor, closing it first if it is open.
+*/
+QDecompressor::~QDecompressor()
+{
+    close();
+}
+
+QDecompressor::Format QDecompressor::format() const
+{
+    Q_D(const QDecompressor);
+    return d->format;
+}
+
+QIODevice *QDecompressor::device() const
+{
+    Q_D(const QDecompressor);
+    return d->device;
+}
+
+/*!
+    \reimp
+
+    Opens the decompressor in either ReadOnly or WriteOnly mode. The
+    underlying device has to be open in the same mode. Opening the
+    decompressor again after close() starts a new stream.
+*/
+bool QDecompressor::open(OpenMode mode)
+{
+    Q_D(QDecompressor);
+    const OpenMode direction = mode & ReadWrite;
+    if (!d->device || (direction != ReadOnly && direction != WriteOnly)) {
+        qWarning("QDecompressor::open: needs a device and either ReadOnly or WriteOnly mode");
+        return false;
+    }
+    if ((d->device->openMode() & direction) != direction) {
+        setErrorString(tr("The underlying device is not open"));
+        return false;
+    }
+    d->triedRawDeflate = false;
+    if (!d->initialize(windowBitsForFormat(d->format)))
+        return false;
+
+    if (direction == ReadOnly) {
+        connect(d->device, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+        connect(d->device, SIGNAL(readChannelFinished()), this, SIGNAL(readyRead()));
+    }
+    return QIODevice::open(mode | Unbuffered);
+}
+
+void QDecompressor::close()
+{
+    Q_D(QDecompressor);
+    if (!isOpen())
+        return;
+    if (d->device)
+        disconnect(d->device, 0, this, 0);
+    QIODevice::close();
+}
+
+bool QDecompressor::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    Returns true once the end of the compressed stream has been reached.
+*/
+bool QDecompressor::atEnd() const
+{
+    Q_D(const QDecompressor);
+    return d->streamEnd;
+}
+
+bool QDecompressor::waitForReadyRead(int msecs)
+{
+    Q_D(QDecompressor);
+    return d->device && d->device->waitForReadyRead(msecs);
+}
+
+/*!
+    Decompresses \a size bytes at \a data and appends the result to \a out.
+    Data following the end of the compressed stream is ignored. Returns
+    false if the data is not valid.
+
+    \sa atEnd()
+*/
+bool QDecompressor::decompress(const char *data, qint64 size, QByteDataBuffer *out)
+{
+    Q_D(QDecompressor);
+    if (d->failed)
+        return false;
+
+    while (size > 0 && !d->streamEnd) {
+        const qint64 chunk = qMin(size, MaxChunkSize);
+        d->setInput(data, chunk);
+        forever {
+            int produced;
+            const int ret = d->inflateInto(d->buffer, BufferSize, &produced);
+            if (ret == Z_DATA_ERROR && d->restartAsRawDeflate())
+                continue;
+            if (isInflateError(ret)) {
+                d->fail(ret);
+                return false;
+            }
+            if (produced)
+                out->append(QByteArray(d->buffer, produced));
+            if (d->streamEnd || (d->stream.avail_in == 0 && produced < BufferSize))
+                break;
+        }
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+qint64 QDecompressor::readData(char *data, qint64 maxSize)
+{
+    Q_D(QDecompressor);
+    if (d->failed || d->streamEnd)
+        return -1;
+
+    qint64 total = 0;
+    while (total < maxSize && !d->streamEnd) {
+        if (d->stream.avail_in == 0) {
+            const qint64 haveRead = d->device->read(d->buffer, BufferSize);
+            if (isEndOfInput(d->device, haveRead)) {
+                d->failed = true;
+                d->errorString = tr("Unexpected end of compressed data");
+                break;
+            } else if (haveRead == 0) {
+                break; // read more later
+            }
+            d->setInput(d->buffer, haveRead);
+        }
+
+        int produced;
+        const int chunk = int(qMin(maxSize - total, qint64(INT_MAX)));
+        const int ret = d->inflateInto(data + total, chunk, &produced);
+        if (ret == Z_DATA_ERROR && d->restartAsRawDeflate())
+            continue;
+        if (isInflateError(ret)) {
+            d->fail(ret);
+            break;
+        }
+        total += produced;
+    }
+    return (total == 0 && d->failed) ? qint64(-1) : total;
+}
+
+qint64 QDecompressor::writeData(const char *data, qint64 size)
+{
+    Q_D(QDecompressor);
+    if (d->failed)
+        return -1;
+
+    for (qint64 written = 0; written < size && !d->streamEnd; ) {
+        const qint64 chunk = qMin(size - written, MaxChunkSize);
+        d->setInput(data + written, chunk);
+        forever {
+            int produced;
+            const int ret = d->inflateInto(d->buffer, BufferSize, &produced);
+            if (ret == Z_DATA_ERROR && d->restartAsRawDeflate())
+                continue;
+            if (isInflateError(ret)) {
+                d->fail(ret);
+                return -1;
+            }
+            if (produced && d->device->write(d->buffer, produced) != produced) {
+                d->errorString = d->device->errorString();
+                return -1;
+            }
+            if (d->streamEnd || (d->stream.avail_in == 0 && produced < BufferSize))
+                break;
+        }
+        written += chunk;
+    }
+    return size;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_COMPRESS
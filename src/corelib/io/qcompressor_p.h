@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCOMPRESSOR_P_H
+#define QCOMPRESSOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qiodevice.h>
+
+#ifndef QT_NO_COMPRESS
+
+QT_BEGIN_NAMESPACE
+
+class QByteDataBuffer;
+class QCompressorPrivate;
+class QDecompressorPrivate;
+
+class Q_CORE_EXPORT QCompressor : public QIODevice
+{
+public:
+    enum Format {
+        ZlibFormat,
+        GzipFormat,
+        RawDeflateFormat
+    };
+
+    explicit QCompressor(Format format = ZlibFormat, int compressionLevel = -1);
+    explicit QCompressor(QIODevice *device, Format format = ZlibFormat, int compressionLevel = -1,
+                         QObject *parent = 0);
+    ~QCompressor();
+
+    Format format() const;
+    QIODevice *device() const;
+
+    bool open(OpenMode mode);
+    void close();
+    bool isSequential() const;
+    bool atEnd() const;
+    bool waitForReadyRead(int msecs);
+
+    bool compress(const char *data, qint64 size, QByteDataBuffer *out);
+    bool finish(QByteDataBuffer *out);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 size);
+
+private:
+    Q_DECLARE_PRIVATE(QCompressor)
+    Q_DISABLE_COPY(QCompressor)
+};
+
+class Q_CORE_EXPORT QDecompressor : public QIODevice
+{
+public:
+    enum Format {
+        AutoDetectFormat,
+        ZlibFormat,
+        GzipFormat,
+        RawDeflateFormat
+    };
+
+    explicit QDecompressor(Format format = AutoDetectFormat);
+    explicit QDecompressor(QIODevice *device, Format format = AutoDetectFormat, QObject *parent = 0);
+    ~QDecompressor();
+
+    Format format() const;
+    QIODevice *device() const;
+
+    bool open(OpenMode mode);
+    void close();
+    bool isSequential() const;
+    bool atEnd() const;
+    bool waitForReadyRead(int msecs);
+
+    bool decompress(const char *data, qint64 size, QByteDataBuffer *out);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 size);
+
+private:
+    Q_DECLARE_PRIVATE(QDecompressor)
+    Q_DISABLE_COPY(QDecompressor)
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_COMPRESS
+
+#endif // QCOMPRESSOR_P_H
@@ -167,6 +167,9 @@ public:
     QDataStream &writeBytes(const char *, uint len);
     int writeRawData(const char *, int len);
 
+    int readArray(char *data, int count, int elementSize);
+    int writeArray(const char *data, int count, int elementSize);
+
     int skipRawData(int len);
 
 private:
@@ -223,6 +226,32 @@ inline QDataStream &QDataStream::operator<<(quint32 i)
 inline QDataStream &QDataStream::operator<<(quint64 i)
 { return *this << qint64(i); }
 
+namespace QtPrivate {
+// Whether a T is serialized as the sizeof(T) bytes of its value, so that
+// an array of them can go through readArray() and writeArray()
+template <typename T>
+inline bool isArrayStreamable(const QDataStream &, const T *) { return false; }
+
+inline bool isArrayStreamable(const QDataStream &, const qint8 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &, const quint8 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &, const qint16 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &, const quint16 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &, const qint32 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &, const quint32 *) { return true; }
+inline bool isArrayStreamable(const QDataStream &s, const qint64 *) { return s.version() >= 6; }
+inline bool isArrayStreamable(const QDataStream &s, const quint64 *) { return s.version() >= 6; }
+inline bool isArrayStreamable(const QDataStream &s, const float *)
+{
+    return s.version() < QDataStream::Qt_4_6
+        || s.floatingPointPrecision() == QDataStream::SinglePrecision;
+}
+inline bool isArrayStreamable(const QDataStream &s, const double *)
+{
+    return s.version() < QDataStream::Qt_4_6
+        || s.floatingPointPrecision() == QDataStream::DoublePrecision;
+}
+}
+
 template <typename T>
 QDataStream& operator>>(QDataStream& s, QList<T>& l)
 {
@@ -280,9 +309,21 @@ QDataStream& operator<<(QDataStream& s, const QLinkedList<T>& l)
 template<typename T>
 QDataStream& operator>>(QDataStream& s, QVector<T>& v)
 {
-    v.clear();
     quint32 c;
     s >> c;
+    if (QtPrivate::isArrayStreamable(s, static_cast<const T *>(0))) {
+        // keeps the memory of v if it is large enough
+        v.resize(c);
+        int n = s.readArray(reinterpret_cast<char *>(v.data()), c, sizeof(T));
+        if (n != int(c)) {
+            T *d = v.data();
+            for (int i = qMax(n, 0); i < int(c); ++i)
+                d[i] = T();
+            s.setStatus(QDataStream::ReadPastEnd);
+        }
+        return s;
+    }
+    v.clear();
     v.resize(c);
     for(quint32 i = 0; i < c; ++i) {
         T t;
@@ -296,6 +337,10 @@ template<typename T>
 QDataStream& operator<<(QDataStream& s, const QVector<T>& v)
 {
     s << quint32(v.size());
+    if (QtPrivate::isArrayStreamable(s, static_cast<const T *>(0))) {
+        s.writeArray(reinterpret_cast<const char *>(v.constData()), v.size(), sizeof(T));
+        return s;
+    }
     for (typename QVector<T>::const_iterator it = v.begin(); it != v.end(); ++it)
         s << *it;
     return s;
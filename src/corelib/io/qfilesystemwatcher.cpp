@@ -47,7 +47,9 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qdiriterator.h>
 #include <qfileinfo.h>
+#include <qpointer.h>
 #include <qset.h>
 #include <qtimer.h>
 
@@ -82,7 +84,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), coalescingInterval(0), coalescingTimer(0)
 {
 }
 
@@ -99,6 +101,10 @@ void QFileSystemWatcherPrivate::init()
                          SIGNAL(directoryChanged(QString,bool)),
                          q,
                          SLOT(_q_directoryChanged(QString,bool)));
+        QObject::connect(native,
+                         SIGNAL(overflow()),
+                         q,
+                         SLOT(_q_overflow()));
     }
 }
 
@@ -119,28 +125,140 @@ void QFileSystemWatcherPrivate::initPollerEngine()
                      SLOT(_q_directoryChanged(QString,bool)));
 }
 
+bool QFileSystemWatcherPrivate::isInRecursiveTree(const QString &directory) const
+{
+    foreach (const QString &root, recursiveRoots) {
+        if (directory == root)
+            return true;
+        if (directory.startsWith(root)
+            && (root.endsWith(QLatin1Char('/')) || directory.at(root.size()) == QLatin1Char('/')))
+            return true;
+    }
+    return false;
+}
+
+// appends all directories below \a directory that are not watched yet to \a result
+void QFileSystemWatcherPrivate::collectSubdirectories(const QString &directory, QStringList *result) const
+{
+    QDirIterator it(directory,
+                    QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!watched.contains(path))
+            result->append(path);
+    }
+}
+
+// starts watching the subdirectories that appeared in \a directory, which
+// is part of a recursively watched tree, together with their own subtrees
+bool QFileSystemWatcherPrivate::watchNewSubdirectories(const QString &directory)
+{
+    Q_Q(QFileSystemWatcher);
+    QStringList added;
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (watched.contains(path))
+            continue;
+        added.append(path);
+        collectSubdirectories(path, &added);
+    }
+    return added.isEmpty() || q->addPaths(added).isEmpty();
+}
+
+void QFileSystemWatcherPrivate::queueChange(const QString &path, bool isDirectory)
+{
+    QSet<QString> &set = isDirectory ? pendingDirectorySet : pendingFileSet;
+    const int count = set.size();
+    set.insert(path);
+    if (set.size() != count)
+        (isDirectory ? pendingDirectories : pendingFiles).append(path);
+
+    // the timer is not restarted by further changes, so a steady stream of
+    // changes is still delivered once per interval
+    if (!coalescingTimer->isActive())
+        coalescingTimer->start(coalescingInterval);
+}
+
 void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
 {
     Q_Q(QFileSystemWatcher);
-    if (!files.contains(path)) {
+    if (!watched.contains(path)) {
         // the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
+    if (removed) {
         files.removeAll(path);
-    emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+        watched.remove(path);
+    }
+    if (coalescingInterval > 0)
+        queueChange(path, false);
+    else
+        emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
 {
     Q_Q(QFileSystemWatcher);
-    if (!directories.contains(path)) {
+    if (!watched.contains(path)) {
         // perhaps the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
+    if (removed) {
         directories.removeAll(path);
-    emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+        watched.remove(path);
+        recursiveRoots.removeAll(path);
+    } else if (!recursiveRoots.isEmpty() && isInRecursiveTree(path)) {
+        watchNewSubdirectories(path);
+    }
+    if (coalescingInterval > 0)
+        queueChange(path, true);
+    else
+        emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+}
+
+void QFileSystemWatcherPrivate::_q_overflow()
+{
+    Q_Q(QFileSystemWatcher);
+    // directories created while events were being dropped are not watched yet
+    QStringList missing;
+    foreach (const QString &root, recursiveRoots)
+        collectSubdirectories(root, &missing);
+    if (!missing.isEmpty())
+        q->addPaths(missing);
+
+    emit q->rescanRequired(QFileSystemWatcher::QPrivateSignal());
+}
+
+void QFileSystemWatcherPrivate::_q_deliverPendingChanges()
+{
+    Q_Q(QFileSystemWatcher);
+    if (coalescingTimer)
+        coalescingTimer->stop();
+    if (pendingFiles.isEmpty() && pendingDirectories.isEmpty())
+        return;
+
+    const QStringList changedFiles = pendingFiles;
+    const QStringList changedDirectories = pendingDirectories;
+    pendingFiles.clear();
+    pendingDirectories.clear();
+    pendingFileSet.clear();
+    pendingDirectorySet.clear();
+
+    // a receiver may delete the watcher
+    QPointer<QFileSystemWatcher> guard(q);
+    foreach (const QString &path, changedFiles) {
+        emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+        if (!guard)
+            return;
+    }
+    foreach (const QString &path, changedDirectories) {
+        emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+        if (!guard)
+            return;
+    }
+    emit q->pathsChanged(changedFiles + changedDirectories, QFileSystemWatcher::QPrivateSignal());
 }
 
 
@@ -171,6 +289,17 @@ void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool re
     they have been renamed or removed from disk, and directories once
     they have been removed from disk.
 
+    A directory tree can be watched as a whole with addRecursivePath().
+    Subdirectories created inside the tree later on are watched
+    automatically.
+
+    Changes that happen in quick succession can be coalesced by setting
+    a coalescingInterval(). The watcher then reports each changed path
+    at most once per interval and additionally emits pathsChanged() with
+    all paths of the batch. If the operating system drops change events,
+    for instance because its event queue overflowed, rescanRequired() is
+    emitted and the application should re-examine the watched paths.
+
     \note On systems running a Linux kernel without inotify support,
     file systems that contain watched paths cannot be unmounted.
 
@@ -321,12 +450,59 @@ QStringList QFileSystemWatcher::addPaths(const QStringList &paths)
         }
     }
 
-    if(engine)
+    if(engine) {
+        const int fileCount = d->files.size();
+        const int directoryCount = d->directories.size();
         p = engine->addPaths(p, &d->files, &d->directories);
+        for (int i = fileCount; i < d->files.size(); ++i)
+            d->watched.insert(d->files.at(i));
+        for (int i = directoryCount; i < d->directories.size(); ++i)
+            d->watched.insert(d->directories.at(i));
+    }
 
     return p;
 }
 
+/*!
+    \since 5.2
+
+    Adds \a directory and all directories below it to the file system
+    watcher. Symbolic links to directories are not followed.
+
+    Directories that are created inside the tree later on are watched
+    as soon as the directoryChanged() signal for their parent directory
+    is emitted. Removing \a directory with removePath() or removePaths()
+    stops watching the whole tree.
+
+    Returns true if every directory in the tree could be watched;
+    otherwise returns false. Watching a large tree can exceed the
+    system dependent limit on the number of monitored paths, in which
+    case the directories that could not be added are not monitored.
+
+    \sa addPath(), directories()
+*/
+bool QFileSystemWatcher::addRecursivePath(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addRecursivePath: path is empty");
+        return false;
+    }
+
+    const QString root = QDir::cleanPath(directory);
+    if (!QFileInfo(root).isDir())
+        return false;
+    if (!d->watched.contains(root) && !addPath(root))
+        return false;
+    if (!d->recursiveRoots.contains(root))
+        d->recursiveRoots.append(root);
+
+    QStringList subdirectories;
+    d->collectSubdirectories(root, &subdirectories);
+    return subdirectories.isEmpty() || addPaths(subdirectories).isEmpty();
+}
+
 /*!
     Removes the specified \a path from the file system watcher.
 
@@ -377,11 +553,38 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         return QStringList();
     }
 
+    if (!d->recursiveRoots.isEmpty()) {
+        // removing the root of a recursively watched tree removes the whole tree
+        QStringList subdirectories;
+        foreach (const QString &path, p) {
+            if (d->recursiveRoots.removeAll(path) == 0)
+                continue;
+            const QString prefix = path.endsWith(QLatin1Char('/')) ? path : path + QLatin1Char('/');
+            foreach (const QString &directory, d->directories) {
+                if (directory.startsWith(prefix) && !d->isInRecursiveTree(directory))
+                    subdirectories.append(directory);
+            }
+        }
+        p += subdirectories;
+    }
+
+    const QStringList requested = p;
     if (d->native)
         p = d->native->removePaths(p, &d->files, &d->directories);
     if (d->poller)
         p = d->poller->removePaths(p, &d->files, &d->directories);
 
+    const QSet<QString> notRemoved = p.toSet();
+    foreach (const QString &path, requested) {
+        if (notRemoved.contains(path))
+            continue;
+        d->watched.remove(path);
+        if (d->pendingFileSet.remove(path))
+            d->pendingFiles.removeOne(path);
+        if (d->pendingDirectorySet.remove(path))
+            d->pendingDirectories.removeOne(path);
+    }
+
     return p;
 }
 
@@ -407,6 +610,75 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa fileChanged()
 */
 
+/*!
+    \fn void QFileSystemWatcher::pathsChanged(const QStringList &paths)
+    \since 5.2
+
+    This signal is emitted once per coalescingInterval() with all
+    \a paths that changed during the interval, after fileChanged() and
+    directoryChanged() have been emitted for each of them. It is not
+    emitted if the coalescing interval is 0.
+
+    \sa setCoalescingInterval()
+*/
+
+/*!
+    \fn void QFileSystemWatcher::rescanRequired()
+    \since 5.2
+
+    This signal is emitted when change notifications have been lost,
+    for instance because the operating system's event queue
+    overflowed. Any watched path may have changed without a
+    fileChanged() or directoryChanged() signal being emitted, so the
+    application should re-examine the paths it is interested in.
+
+    Subdirectories of trees added with addRecursivePath() that were
+    created in the meantime are watched before this signal is emitted.
+
+    \note Only the inotify backend on Linux currently detects lost
+    notifications.
+*/
+
+/*!
+    \property QFileSystemWatcher::coalescingInterval
+    \since 5.2
+    \brief the interval in milliseconds over which changes are coalesced
+
+    If the interval is greater than 0, changes are not reported
+    immediately. Instead, the first change starts the interval and
+    every path that changed until it elapses is reported once with
+    fileChanged() or directoryChanged(), followed by a single
+    pathsChanged() signal for the whole batch. Since further changes do
+    not extend the interval, a continuous burst of changes is delivered
+    at most once per interval.
+
+    The default is 0, which reports every change as soon as it is
+    detected. Setting the interval to 0 delivers pending changes
+    immediately.
+
+    \sa pathsChanged()
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    d->coalescingInterval = qMax(msecs, 0);
+    if (d->coalescingInterval == 0) {
+        d->_q_deliverPendingChanges();
+        return;
+    }
+    if (!d->coalescingTimer) {
+        d->coalescingTimer = new QTimer(this);
+        d->coalescingTimer->setSingleShot(true);
+        connect(d->coalescingTimer, SIGNAL(timeout()), SLOT(_q_deliverPendingChanges()));
+    }
+}
+
 /*!
     \fn QStringList QFileSystemWatcher::directories() const
 
@@ -55,6 +55,7 @@ class Q_CORE_EXPORT QFileSystemWatcher : public QObject
 {
     Q_OBJECT
     Q_DECLARE_PRIVATE(QFileSystemWatcher)
+    Q_PROPERTY(int coalescingInterval READ coalescingInterval WRITE setCoalescingInterval)
 
 public:
     QFileSystemWatcher(QObject *parent = 0);
@@ -65,10 +66,14 @@ public:
     QStringList addPaths(const QStringList &files);
     bool removePath(const QString &file);
     QStringList removePaths(const QStringList &files);
+    bool addRecursivePath(const QString &directory);
 
     QStringList files() const;
     QStringList directories() const;
 
+    int coalescingInterval() const;
+    void setCoalescingInterval(int msecs);
+
 Q_SIGNALS:
     void fileChanged(const QString &path
 #if !defined(Q_QDOC)
@@ -78,12 +83,24 @@ Q_SIGNALS:
     void directoryChanged(const QString &path
 #if !defined(Q_QDOC)
         , QPrivateSignal
+#endif
+    );
+    void pathsChanged(const QStringList &paths
+#if !defined(Q_QDOC)
+        , QPrivateSignal
+#endif
+    );
+    void rescanRequired(
+#if !defined(Q_QDOC)
+        QPrivateSignal
 #endif
     );
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
     Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &path, bool removed))
+    Q_PRIVATE_SLOT(d_func(), void _q_overflow())
+    Q_PRIVATE_SLOT(d_func(), void _q_deliverPendingChanges())
 };
 
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@
 #include <qdebug.h>
 #include <qfile.h>
 #include <qfileinfo.h>
+#include <qset.h>
 #include <qsocketnotifier.h>
 #include <qvarlengtharray.h>
 
@@ -218,6 +219,24 @@ QT_END_NAMESPACE
 
 QT_BEGIN_NAMESPACE
 
+static void removeFromList(QStringList *list, const QSet<QString> &removed)
+{
+    if (removed.isEmpty())
+        return;
+    if (removed.size() == 1) {
+        list->removeAll(*removed.constBegin());
+        return;
+    }
+
+    QStringList remaining;
+    remaining.reserve(list->size() - removed.size());
+    foreach (const QString &path, *list) {
+        if (!removed.contains(path))
+            remaining.append(path);
+    }
+    *list = remaining;
+}
+
 QInotifyFileSystemWatcherEngine *QInotifyFileSystemWatcherEngine::create(QObject *parent)
 {
     register int fd = -1;
@@ -244,9 +263,8 @@ QInotifyFileSystemWatcherEngine::QInotifyFileSystemWatcherEngine(int fd, QObject
 QInotifyFileSystemWatcherEngine::~QInotifyFileSystemWatcherEngine()
 {
     notifier.setEnabled(false);
-    foreach (int id, pathToID)
-        inotify_rm_watch(inotifyFd, id < 0 ? -id : id);
-
+    // closing the descriptor releases all of its watches at once, which
+    // is much cheaper than one inotify_rm_watch() call per watched path
     ::close(inotifyFd);
 }
 
@@ -258,15 +276,10 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
+        if (pathToID.contains(path))
+            continue;
         QFileInfo fi(path);
         bool isDir = fi.isDir();
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
 
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
@@ -311,6 +324,7 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
                                                          QStringList *directories)
 {
     QStringList p = paths;
+    QSet<QString> removedFiles, removedDirectories;
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
@@ -325,12 +339,16 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
 
         it.remove();
         if (id < 0) {
-            directories->removeAll(path);
+            removedDirectories.insert(path);
         } else {
-            files->removeAll(path);
+            removedFiles.insert(path);
         }
     }
 
+    // a single pass over each list, instead of one per removed path
+    removeFromList(files, removedFiles);
+    removeFromList(directories, removedDirectories);
+
     return p;
 }
 
@@ -345,16 +363,23 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char *at = buffer.data();
     char * const end = at + buffSize;
 
+    bool overflowed = false;
     QHash<int, inotify_event *> eventForId;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
+        at += sizeof(inotify_event) + event->len;
 
-        if (eventForId.contains(event->wd))
-            eventForId[event->wd]->mask |= event->mask;
-        else
-            eventForId.insert(event->wd, event);
+        if (event->mask & IN_Q_OVERFLOW) {
+            // the kernel dropped events, it reports this with a wd of -1
+            overflowed = true;
+            continue;
+        }
 
-        at += sizeof(inotify_event) + event->len;
+        inotify_event *&coalesced = eventForId[event->wd];
+        if (coalesced)
+            coalesced->mask |= event->mask;
+        else
+            coalesced = event;
     }
 
     QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
@@ -392,6 +417,9 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
                 emit fileChanged(path, false);
         }
     }
+
+    if (overflowed)
+        emit overflow();
 }
 
 QT_END_NAMESPACE
@@ -59,10 +59,13 @@
 
 #include <private/qobject_p.h>
 
+#include <QtCore/qset.h>
 #include <QtCore/qstringlist.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -89,6 +92,9 @@ public:
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // emitted when the engine lost track of changes, e.g. because the
+    // kernel's event queue overflowed
+    void overflow();
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -102,12 +108,27 @@ public:
     void init();
     void initPollerEngine();
 
+    bool isInRecursiveTree(const QString &directory) const;
+    void collectSubdirectories(const QString &directory, QStringList *result) const;
+    bool watchNewSubdirectories(const QString &directory);
+    void queueChange(const QString &path, bool isDirectory);
+
     QFileSystemWatcherEngine *native, *poller;
     QStringList files, directories;
+    // mirrors files and directories for constant time lookups
+    QSet<QString> watched;
+    QStringList recursiveRoots;
+
+    int coalescingInterval;
+    QTimer *coalescingTimer;
+    QStringList pendingFiles, pendingDirectories;
+    QSet<QString> pendingFileSet, pendingDirectorySet;
 
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_overflow();
+    void _q_deliverPendingChanges();
 };
 
 
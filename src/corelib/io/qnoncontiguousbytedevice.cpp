@@ -363,6 +363,14 @@ bool QNonContiguousByteDeviceIoDeviceImpl::advanceReadPointer(qint64 amount)
     // advancing over that what has actually been read before
     if (currentReadBufferPosition > currentReadBufferAmount) {
         qint64 i = currentReadBufferPosition - currentReadBufferAmount;
+        if (!device->isSequential()) {
+            // e.g. the data was sent by other means straight from the file, don't read it
+            if (!device->seek(device->pos() + i)) {
+                emit readProgress(totalAdvancements - i, size());
+                return false;
+            }
+            i = 0;
+        }
         while (i > 0) {
             if (device->getChar(0) == false) {
                 emit readProgress(totalAdvancements - i, size());
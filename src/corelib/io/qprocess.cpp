@@ -782,6 +782,7 @@ QProcessPrivate::QProcessPrivate()
 #endif // Q_OS_WIN
 #ifdef Q_OS_UNIX
     serial = 0;
+    usesPidfd = false;
 #endif
 }
 
@@ -858,6 +859,7 @@ void QProcessPrivate::cleanup()
     destroyPipe(deathPipe);
 #ifdef Q_OS_UNIX
     serial = 0;
+    usesPidfd = false;
 #endif
 }
 
@@ -306,6 +306,9 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
     void execChild(const char *workingDirectory, char **path, char **argv, char **envp);
+#  if defined(Q_OS_LINUX)
+    pid_t vforkChild(const char *workingDirectory, char **path, char **argv, char **envp);
+#  endif
 #elif defined(Q_OS_QNX)
     pid_t spawnChild(const char *workingDirectory, char **argv, char **envp);
 #endif
@@ -329,6 +332,7 @@ public:
     bool crashed;
 #ifdef Q_OS_UNIX
     int serial;
+    bool usesPidfd;
 #endif
 
     bool waitForStarted(int msecs = 30000);
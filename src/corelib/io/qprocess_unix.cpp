@@ -113,6 +113,17 @@ QT_END_NAMESPACE
 #include <sys/neutrino.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#  if !defined(SYS_pidfd_open) && !defined(__alpha__)
+#    define SYS_pidfd_open 434
+#  endif
+#  if !defined(QT_NO_RTTI) && (!defined(Q_CC_GNU) || defined(__GXX_RTTI))
+#    include <typeinfo>
+#    define QPROCESS_USE_VFORK
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 // POSIX requires PIPE_BUF to be 512 or larger
@@ -134,6 +145,45 @@ static void qt_sa_sigchld_handler(int signum)
         oldAction(signum);
 }
 
+static int qt_pidfd_open(pid_t pid)
+{
+#if defined(SYS_pidfd_open)
+    return ::syscall(SYS_pidfd_open, pid, 0);
+#else
+    Q_UNUSED(pid);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/*
+    Returns true if the death of a child can be watched through a pidfd,
+    a descriptor that becomes readable when the child exits. The process
+    manager's thread, SIGCHLD handler and child table are not needed then.
+
+    Children of a process that ignores SIGCHLD are reaped by the kernel and
+    their exit status is lost, so fall back to the process manager (which
+    installs its own handler) in that case.
+*/
+static bool qt_use_pidfd()
+{
+    static QBasicAtomicInt supported = Q_BASIC_ATOMIC_INITIALIZER(-1);
+    int isSupported = supported.load();
+    if (isSupported == -1) {
+        int fd = qt_pidfd_open(::getpid());
+        isSupported = fd != -1;
+        if (fd != -1)
+            qt_safe_close(fd);
+        supported.store(isSupported);
+    }
+    if (!isSupported)
+        return false;
+
+    struct sigaction currentAction;
+    ::sigaction(SIGCHLD, 0, &currentAction);
+    return currentAction.sa_handler != SIG_IGN && !(currentAction.sa_flags & SA_NOCLDWAIT);
+}
+
 static inline void add_fd(int &nfds, int fd, fd_set *fdset)
 {
     FD_SET(fd, fdset);
@@ -547,7 +597,9 @@ void QProcessPrivate::startProcess()
     qDebug("QProcessPrivate::startProcess()");
 #endif
 
-    processManager()->start();
+    usesPidfd = qt_use_pidfd();
+    if (!usesPidfd)
+        processManager()->start();
 
     // Initialize pipes
     if (!createChannel(stdinChannel) ||
@@ -567,11 +619,6 @@ void QProcessPrivate::startProcess()
                                                     QSocketNotifier::Read, q);
         QObject::connect(startupSocketNotifier, SIGNAL(activated(int)),
                          q, SLOT(_q_startupNotification()));
-
-        deathNotifier = new QSocketNotifier(deathPipe[0],
-                                            QSocketNotifier::Read, q);
-        QObject::connect(deathNotifier, SIGNAL(activated(int)),
-                         q, SLOT(_q_processDied()));
     }
 
     // Start the process (platform dependent)
@@ -652,11 +699,20 @@ void QProcessPrivate::startProcess()
     }
 
     // Start the process manager, and fork off the child process.
-    processManager()->lock();
+    if (!usesPidfd)
+        processManager()->lock();
 #if defined(Q_OS_QNX)
     pid_t childPid = spawnChild(workingDirPtr, argv, envp);
+#else
+    // A reimplementation of setupChildProcess() may do anything in the
+    // child, so only a plain QProcess can use vfork().
+#if defined(QPROCESS_USE_VFORK)
+    pid_t childPid = typeid(*q) == typeid(QProcess)
+                     ? vforkChild(workingDirPtr, path, argv, envp)
+                     : fork();
 #else
     pid_t childPid = fork();
+#endif
     int lastForkErrno = errno;
 #endif
     if (childPid != 0) {
@@ -689,7 +745,8 @@ void QProcessPrivate::startProcess()
 #if defined (QPROCESS_DEBUG)
         qDebug("fork failed: %s", qPrintable(qt_error_string(lastForkErrno)));
 #endif
-        processManager()->unlock();
+        if (!usesPidfd)
+            processManager()->unlock();
         q->setProcessState(QProcess::NotRunning);
         processError = QProcess::FailedToStart;
         q->setErrorString(QProcess::tr("Resource error (fork failure): %1").arg(qt_error_string(lastForkErrno)));
@@ -705,11 +762,38 @@ void QProcessPrivate::startProcess()
     }
 #endif
 
-    // Register the child. In the mean time, we can get a SIGCHLD, so we need
-    // to keep the lock held to avoid a race to catch the child.
-    processManager()->add(childPid, q);
     pid = Q_PID(childPid);
-    processManager()->unlock();
+    if (usesPidfd) {
+        // Watch the child through its pidfd instead of the death pipe. If
+        // we cannot get one (we are probably out of descriptors), hand the
+        // child over to the process manager and poke the death pipe, in
+        // case the child has died before the manager saw it.
+        int pidfd = qt_pidfd_open(childPid);
+        if (pidfd != -1) {
+            ::fcntl(pidfd, F_SETFD, FD_CLOEXEC);
+            destroyPipe(deathPipe);
+            deathPipe[0] = pidfd;
+        } else {
+            usesPidfd = false;
+            processManager()->start();
+            processManager()->lock();
+            processManager()->add(childPid, q);
+            processManager()->unlock();
+            qt_safe_write(deathPipe[1], "", 1);
+        }
+    } else {
+        // Register the child. In the mean time, we can get a SIGCHLD, so we need
+        // to keep the lock held to avoid a race to catch the child.
+        processManager()->add(childPid, q);
+        processManager()->unlock();
+    }
+
+    if (threadData->hasEventDispatcher()) {
+        deathNotifier = new QSocketNotifier(deathPipe[0],
+                                            QSocketNotifier::Read, q);
+        QObject::connect(deathNotifier, SIGNAL(activated(int)),
+                         q, SLOT(_q_processDied()));
+    }
 
     // parent
     // close the ends we don't use and make all pipes non-blocking
@@ -901,6 +985,86 @@ void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv
     qt_safe_close(childStartedPipe[1]);
     childStartedPipe[1] = -1;
 }
+
+#if defined(QPROCESS_USE_VFORK)
+/*
+    Starts the child with vfork(), which does not copy the page tables of
+    the parent; the cost of fork() grows with the size of the parent.
+
+    The child borrows our memory and stack until it calls execve() or
+    _exit(), so it only makes async-signal-safe calls and reports back
+    through local variables. Signals are blocked around vfork() so that
+    none of our handlers can run in the child.
+*/
+pid_t QProcessPrivate::vforkChild(const char *workingDir, char **path, char **argv, char **envp)
+{
+    volatile int childErrno = 0;
+    volatile bool chdirFailed = false;
+
+    sigset_t allSignals;
+    sigset_t oldMask;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &oldMask);
+
+    pid_t childPid = vfork();
+    if (childPid == 0) {
+        // restore the default action of every signal we handle before
+        // unblocking them, then reset the signal that we ignored
+        for (int sig = 1; sig < NSIG; ++sig) {
+            struct sigaction action;
+            if (::sigaction(sig, 0, &action) == 0
+                && action.sa_handler != SIG_DFL && action.sa_handler != SIG_IGN) {
+                memset(&action, 0, sizeof(action));
+                action.sa_handler = SIG_DFL;
+                ::sigaction(sig, &action, 0);
+            }
+        }
+        ::signal(SIGPIPE, SIG_DFL);
+        ::sigprocmask(SIG_SETMASK, &oldMask, 0);
+
+        qt_safe_dup2(stdinChannel.pipe[0], STDIN_FILENO, 0);
+        if (processChannelMode != QProcess::ForwardedChannels) {
+            qt_safe_dup2(stdoutChannel.pipe[1], STDOUT_FILENO, 0);
+            if (processChannelMode == QProcess::MergedChannels)
+                qt_safe_dup2(STDOUT_FILENO, STDERR_FILENO, 0);
+            else
+                qt_safe_dup2(stderrChannel.pipe[1], STDERR_FILENO, 0);
+        }
+
+        if (workingDir && QT_CHDIR(workingDir) == -1)
+            chdirFailed = true;
+
+        if (!envp) {
+            qt_safe_execvp(argv[0], argv);
+        } else if (path) {
+            for (char **arg = path; *arg; ++arg) {
+                argv[0] = *arg;
+                qt_safe_execve(argv[0], argv, envp);
+            }
+        } else {
+            qt_safe_execve(argv[0], argv, envp);
+        }
+
+        childErrno = errno;
+        ::_exit(-1);
+    }
+    int forkErrno = errno;
+    pthread_sigmask(SIG_SETMASK, &oldMask, 0);
+
+    if (childPid > 0) {
+        if (chdirFailed)
+            qWarning("QProcessPrivate::execChild() failed to chdir to %s", workingDir);
+        if (childErrno) {
+            // report the failure as execChild() would have done
+            QString error = qt_error_string(childErrno);
+            qt_safe_write(childStartedPipe[1], error.data(), error.length() * sizeof(QChar));
+        }
+    }
+
+    errno = forkErrno;
+    return childPid;
+}
+#endif
 #endif
 
 bool QProcessPrivate::processStarted()
@@ -1271,21 +1435,35 @@ bool QProcessPrivate::waitForWrite(int msecs)
 void QProcessPrivate::findExitCode()
 {
     Q_Q(QProcess);
-    processManager()->remove(q);
+    if (!usesPidfd)
+        processManager()->remove(q);
 }
 
 bool QProcessPrivate::waitForDeadChild()
 {
     Q_Q(QProcess);
 
-    // read a byte from the death pipe
-    char c;
-    qt_safe_read(deathPipe[0], &c, 1);
+    // read a byte from the death pipe; a pidfd has nothing to read
+    if (!usesPidfd) {
+        char c;
+        qt_safe_read(deathPipe[0], &c, 1);
+    }
 
     // check if our process is dead
     int exitStatus;
     if (qt_safe_waitpid(pid_t(pid), &exitStatus, WNOHANG) > 0) {
-        processManager()->remove(q);
+        if (usesPidfd) {
+            // the pidfd stays readable from now on; put an idle pipe in its
+            // place, so that the death pipe is only readable once per death
+            int idlePipe[2];
+            if (qt_safe_pipe(idlePipe, O_NONBLOCK) == 0) {
+                qt_safe_dup2(idlePipe[0], deathPipe[0]);
+                qt_safe_close(idlePipe[0]);
+                deathPipe[1] = idlePipe[1];
+            }
+        } else {
+            processManager()->remove(q);
+        }
         crashed = !WIFEXITED(exitStatus);
         exitCode = WEXITSTATUS(exitStatus);
 #if defined QPROCESS_DEBUG
@@ -1460,7 +1638,8 @@ bool QProcessPrivate::startDetached(const QString &program, const QStringList &a
 
 void QProcessPrivate::initializeProcessManager()
 {
-    (void) processManager();
+    if (!qt_use_pidfd())
+        (void) processManager();
 }
 
 QT_END_NAMESPACE
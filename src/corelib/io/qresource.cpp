@@ -52,6 +52,7 @@
 #include "qdatetime.h"
 #include "qbytearray.h"
 #include "qstringlist.h"
+#include "qcache.h"
 #include <qshareddata.h>
 #include <qplatformdefs.h>
 #include "private/qabstractfileengine_p.h"
@@ -103,17 +104,29 @@ class QResourceRoot
         Compressed = 0x01,
         Directory = 0x02
     };
+    // where a path was found in the tree: the first node with that name
+    // and the end of its sibling range, for the locale variants
+    struct IndexEntry
+    {
+        int node;
+        int end;
+    };
+    typedef QHash<QString, IndexEntry> Index;
+
     const uchar *tree, *names, *payloads;
+    mutable QAtomicPointer<Index> pathIndex;
     inline int findOffset(int node) const { return node * 14; } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
     short flags(int node) const;
+    const Index *index() const;
+    int findLocale(int node, int end, const QStringRef &segment, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
     inline QResourceRoot(): tree(0), names(0), payloads(0) {}
     inline QResourceRoot(const uchar *t, const uchar *n, const uchar *d) { setSource(t, n, d); }
-    virtual ~QResourceRoot() { }
+    virtual ~QResourceRoot();
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
     inline bool isCompressed(int node) const { return flags(node) & Compressed; }
@@ -134,6 +147,9 @@ protected:
         names = n;
         payloads = d;
     }
+
+private:
+    Q_DISABLE_COPY(QResourceRoot)
 };
 
 static QString cleanPath(const QString &_path)
@@ -155,6 +171,66 @@ Q_GLOBAL_STATIC(ResourceList, resourceList)
 
 Q_GLOBAL_STATIC(QStringList, resourceSearchPaths)
 
+#ifndef QT_NO_COMPRESS
+// Compressed resources opened through QFile used to be uncompressed again
+// every time. The results are now kept, up to a total size that can be
+// changed with QT_RESOURCE_CACHE_LIMIT (in kilobytes).
+class QResourceUncompressedCache
+{
+public:
+    QResourceUncompressedCache()
+    {
+        bool ok;
+        const int limit = qgetenv("QT_RESOURCE_CACHE_LIMIT").toInt(&ok);
+        cache.setMaxCost(ok && limit >= 0 ? limit * 1024 : 4 * 1024 * 1024);
+    }
+
+    QByteArray uncompressed(const QResourceRoot *root, const uchar *data, qint64 size);
+    void remove(const QResourceRoot *root);
+
+private:
+    struct Entry
+    {
+        const QResourceRoot *root;
+        QByteArray data;
+    };
+
+    QMutex mutex;
+    QCache<const uchar *, Entry> cache;
+};
+
+QByteArray QResourceUncompressedCache::uncompressed(const QResourceRoot *root,
+                                                    const uchar *data, qint64 size)
+{
+    {
+        QMutexLocker lock(&mutex);
+        if (Entry *entry = cache.object(data))
+            return entry->data;
+    }
+
+    Entry *entry = new Entry;
+    entry->root = root;
+    entry->data = qUncompress(data, size);
+    const QByteArray result = entry->data;
+
+    QMutexLocker lock(&mutex);
+    cache.insert(data, entry, result.size()); // deletes entry if it is too big
+    return result;
+}
+
+void QResourceUncompressedCache::remove(const QResourceRoot *root)
+{
+    QMutexLocker lock(&mutex);
+    const QList<const uchar *> keys = cache.keys();
+    for (int i = 0; i < keys.size(); ++i) {
+        if (cache.object(keys.at(i))->root == root)
+            cache.remove(keys.at(i));
+    }
+}
+
+Q_GLOBAL_STATIC(QResourceUncompressedCache, uncompressedCache)
+#endif // QT_NO_COMPRESS
+
 /*!
     \class QResource
     \inmodule QtCore
@@ -586,6 +662,16 @@ QResource::searchPaths()
     return *resourceSearchPaths();
 }
 
+QResourceRoot::~QResourceRoot()
+{
+#ifndef QT_NO_COMPRESS
+    // the payload addresses may be reused by the next root
+    if (uncompressedCache.exists())
+        uncompressedCache()->remove(this);
+#endif
+    delete pathIndex.load();
+}
+
 inline uint QResourceRoot::hash(int node) const
 {
     if(!node) //root
@@ -646,6 +732,17 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if(path == QLatin1String("/"))
         return 0;
 
+    // cleaned absolute paths are looked up in the index, anything else
+    // takes the walk through the tree below
+    if (path.startsWith(QLatin1Char('/')) && !path.endsWith(QLatin1Char('/'))
+        && !path.contains(QLatin1String("//"))) {
+        const Index::const_iterator it = index()->constFind(path);
+        if (it == index()->constEnd())
+            return -1;
+        const int slash = path.lastIndexOf(QLatin1Char('/'));
+        return findLocale(it->node, it->end, path.midRef(slash + 1), locale);
+    }
+
     //the root node is always first
     int child_count = (tree[6] << 24) + (tree[7] << 16) +
                       (tree[8] << 8) + (tree[9] << 0);
@@ -751,6 +848,79 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 #endif
     return node;
 }
+/*
+    Returns the node for the file or directory named \a segment that best
+    matches \a locale, starting the search at \a node, the first node with
+    that name among its siblings, which end at \a end.
+*/
+int QResourceRoot::findLocale(int node, int end, const QStringRef &segment,
+                              const QLocale &locale) const
+{
+    const uint h = hash(node);
+    int ret = -1;
+    for (int sub_node = node; sub_node < end && hash(sub_node) == h; ++sub_node) {
+        if (sub_node != node && name(sub_node) != segment)
+            continue;
+        int offset = findOffset(sub_node) + 4; //jump past name
+        const short flags = (tree[offset+0] << 8) + (tree[offset+1] << 0);
+        offset += 2;
+        if (flags & Directory)
+            return sub_node;
+
+        const short country = (tree[offset+0] << 8) + (tree[offset+1] << 0);
+        offset += 2;
+        const short language = (tree[offset+0] << 8) + (tree[offset+1] << 0);
+        if (country == locale.country() && language == locale.language()) {
+            return sub_node;
+        } else if ((country == QLocale::AnyCountry && language == locale.language()) ||
+                   (country == QLocale::AnyCountry && language == QLocale::C && ret == -1)) {
+            ret = sub_node;
+        }
+    }
+    return ret;
+}
+
+/*
+    Returns the path index of this tree, building it on first use. It maps
+    every absolute path in the tree, without the mapping root, to the
+    first node with that name.
+*/
+const QResourceRoot::Index *QResourceRoot::index() const
+{
+    if (const Index *idx = pathIndex.loadAcquire())
+        return idx;
+
+    Index *idx = new Index;
+    QVector<QPair<int, QString> > pending;
+    pending.append(qMakePair(0, QString()));
+    while (!pending.isEmpty()) {
+        const QPair<int, QString> dir = pending.takeLast();
+        // the root node is always first; its child fields sit where
+        // those of every other directory node do
+        const int offset = findOffset(dir.first) + 6;
+        const int child_count = (tree[offset+0] << 24) + (tree[offset+1] << 16) +
+                                (tree[offset+2] << 8) + (tree[offset+3] << 0);
+        const int child = (tree[offset+4] << 24) + (tree[offset+5] << 16) +
+                          (tree[offset+6] << 8) + (tree[offset+7] << 0);
+        for (int i = child; i < child + child_count; ++i) {
+            const QString path = dir.second + QLatin1Char('/') + name(i);
+            if (idx->contains(path))
+                continue; // another locale of a file we already have
+            const IndexEntry entry = { i, child + child_count };
+            idx->insert(path, entry);
+            if (isContainer(i))
+                pending.append(qMakePair(i, path));
+        }
+    }
+
+    if (!pathIndex.testAndSetOrdered(0, idx)) {
+        // another thread was faster
+        delete idx;
+        idx = pathIndex.loadAcquire();
+    }
+    return idx;
+}
+
 short QResourceRoot::flags(int node) const
 {
     if(node == -1)
@@ -1185,6 +1355,7 @@ protected:
 private:
     uchar *map(qint64 offset, qint64 size, QFile::MemoryMapFlags flags);
     bool unmap(uchar *ptr);
+    void uncompress(const QResourcePrivate *res);
     qint64 offset;
     QResource resource;
     QByteArray uncompressed;
@@ -1222,13 +1393,7 @@ QResourceFileEngine::QResourceFileEngine(const QString &file) :
 {
     Q_D(QResourceFileEngine);
     d->resource.setFileName(file);
-    if(d->resource.isCompressed() && d->resource.size()) {
-#ifndef QT_NO_COMPRESS
-        d->uncompressed = qUncompress(d->resource.data(), d->resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
-#endif
-    }
+    d->uncompress(d->resource.d_func());
 }
 
 QResourceFileEngine::~QResourceFileEngine()
@@ -1239,6 +1404,7 @@ void QResourceFileEngine::setFileName(const QString &file)
 {
     Q_D(QResourceFileEngine);
     d->resource.setFileName(file);
+    d->uncompress(d->resource.d_func());
 }
 
 bool QResourceFileEngine::open(QIODevice::OpenMode flags)
@@ -1252,6 +1418,8 @@ bool QResourceFileEngine::open(QIODevice::OpenMode flags)
         return false;
     if(!d->resource.isValid())
        return false;
+    if (d->uncompressed.isNull())
+        d->uncompress(d->resource.d_func()); // after close()
     return true;
 }
 
@@ -1469,14 +1637,33 @@ uchar *QResourceFileEnginePrivate::map(qint64 offset, qint64 size, QFile::Memory
 {
     Q_Q(QResourceFileEngine);
     Q_UNUSED(flags);
-    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > resource.size()) {
+    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > q->size()) {
         q->setError(QFile::UnspecifiedError, QString());
         return 0;
     }
-    uchar *address = const_cast<uchar *>(resource.data());
+    // compressed resources are mapped from the uncompressed copy, without
+    // detaching it from the cache
+    uchar *address = resource.isCompressed()
+        ? reinterpret_cast<uchar *>(const_cast<char *>(uncompressed.constData()))
+        : const_cast<uchar *>(resource.data());
     return (address + offset);
 }
 
+void QResourceFileEnginePrivate::uncompress(const QResourcePrivate *res)
+{
+    uncompressed.clear();
+    if (!resource.isCompressed() || !resource.size())
+        return;
+#ifndef QT_NO_COMPRESS
+    // the data comes from the first root the resource was found in
+    uncompressed = uncompressedCache()->uncompressed(res->related.first(), resource.data(),
+                                                     resource.size());
+#else
+    Q_UNUSED(res);
+    Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
+#endif
+}
+
 bool QResourceFileEnginePrivate::unmap(uchar *ptr)
 {
     Q_UNUSED(ptr);
@@ -47,7 +47,9 @@
 
 #include "qsettings_p.h"
 #include "qcache.h"
+#include "qdatastream.h"
 #include "qfile.h"
+#include "qsavefile.h"
 #include "qdir.h"
 #include "qfileinfo.h"
 #include "qmutex.h"
@@ -222,8 +224,22 @@ static bool unixLock(int handle, int lockType)
 }
 #endif
 
+#ifndef Q_OS_WIN
+static bool qt_isFileReplaced(const QFile &file)
+{
+    QT_STATBUF opened;
+    QT_STATBUF current;
+    if (QT_FSTAT(file.handle(), &opened) != 0)
+        return false;
+    if (QT_STAT(QFile::encodeName(file.fileName()).constData(), &current) != 0)
+        return true;
+    return opened.st_ino != current.st_ino || opened.st_dev != current.st_dev;
+}
+#endif
+
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
-    : name(fileName), size(0), ref(1), userPerms(_userPerms)
+    : name(fileName), size(0), indexGeneration(0), journalStart(0), journalEnd(0),
+      ref(1), userPerms(_userPerms)
 {
     usedHashFunc()->insert(name, this);
 }
@@ -982,7 +998,12 @@ QStringList QSettingsPrivate::splitArgs(const QString &s, int idx)
 
 void QConfFileSettingsPrivate::initFormat()
 {
-    extension = (format == QSettings::NativeFormat) ? QLatin1String(".conf") : QLatin1String(".ini");
+    if (format == QSettings::NativeFormat)
+        extension = QLatin1String(".conf");
+    else if (format == QSettings::IndexedFormat)
+        extension = QLatin1String(".qsi");
+    else
+        extension = QLatin1String(".ini");
     readFunc = 0;
     writeFunc = 0;
 #if defined(Q_OS_MAC)
@@ -991,7 +1012,7 @@ void QConfFileSettingsPrivate::initFormat()
     caseSensitivity = IniCaseSensitivity;
 #endif
 
-    if (format > QSettings::IniFormat) {
+    if (format > QSettings::IndexedFormat) {
         QMutexLocker locker(&settingsGlobalMutex);
         const CustomFormatVector *customFormatVector = customFormatVectorFunc();
 
@@ -1009,7 +1030,7 @@ void QConfFileSettingsPrivate::initFormat()
 void QConfFileSettingsPrivate::initAccess()
 {
     if (confFiles[spec]) {
-        if (format > QSettings::IniFormat) {
+        if (format > QSettings::IndexedFormat) {
             if (!readFunc)
                 setStatus(QSettings::AccessError);
         }
@@ -1388,7 +1409,7 @@ QString QConfFileSettingsPrivate::fileName() const
 
 bool QConfFileSettingsPrivate::isWritable() const
 {
-    if (format > QSettings::IniFormat && !writeFunc)
+    if (format > QSettings::IndexedFormat && !writeFunc)
         return false;
 
     QConfFile *confFile = confFiles[spec].data();
@@ -1477,8 +1498,19 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
         }
     }
 #else
-    if (file.isOpen())
+    if (file.isOpen()) {
         unixLock(file.handle(), readOnly ? F_RDLCK : F_WRLCK);
+
+        // IndexedFormat compacts a file by replacing it with a new one, so
+        // make sure that we hold the lock on the file that is in place now
+        while (format == QSettings::IndexedFormat && qt_isFileReplaced(file)) {
+            QIODevice::OpenMode mode = file.openMode();
+            file.close();
+            if (!file.open(mode))
+                break;
+            unixLock(file.handle(), readOnly ? F_RDLCK : F_WRLCK);
+        }
+    }
 #endif
 
     // If we have created the file, apply the file perms
@@ -1502,7 +1534,17 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
         mustReadFile = (confFile->size != fileInfo.size()
                         || (confFile->size != 0 && confFile->timeStamp != fileInfo.lastModified()));
 
-    if (mustReadFile) {
+    if (mustReadFile && format == QSettings::IndexedFormat) {
+#ifndef QT_NO_DATASTREAM
+        if (!readIndexedFile(confFile, file))
+            setStatus(QSettings::FormatError);
+#else
+        // the values of IndexedFormat files are stored with QDataStream
+        setStatus(QSettings::FormatError);
+#endif
+        confFile->size = fileInfo.size();
+        confFile->timeStamp = fileInfo.lastModified();
+    } else if (mustReadFile) {
         confFile->unparsedIniSections.clear();
         confFile->originalKeys.clear();
 
@@ -1552,7 +1594,19 @@ void QConfFileSettingsPrivate::syncConfFile(int confFileNo)
         We also need to save the file. We still hold the file lock,
         so everything is under control.
     */
-    if (!readOnly) {
+    if (!readOnly && format == QSettings::IndexedFormat) {
+#ifndef QT_NO_DATASTREAM
+        if (file.isWritable() && writeIndexedFile(confFile, file)) {
+            QFileInfo fileInfo(confFile->name);
+            confFile->size = fileInfo.size();
+            confFile->timeStamp = fileInfo.lastModified();
+        } else {
+            setStatus(QSettings::AccessError);
+        }
+#else
+        setStatus(QSettings::FormatError);
+#endif
+    } else if (!readOnly) {
         ensureAllSectionsParsed(confFile);
         ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
 
@@ -1960,8 +2014,434 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
     return !writeError;
 }
 
+/*
+    IndexedFormat files start with the indexed part written by the last
+    compaction:
+
+        QSettingsIndexHeader
+        QSettingsIndexEntry[count], sorted by key
+        pool of keys (UTF-16) and values (QDataStream)
+
+    followed by the journal, a sequence of QSettingsJournalRecord, each
+    followed by the original key (UTF-16) and, for Set records, the value,
+    padded to a multiple of 4 bytes. Writers append records to the journal
+    and compact the file (by writing a new one and renaming it over the old
+    one) when the journal gets large. Readers only look at the part of the
+    journal that was appended since they last read the file.
+
+    All numbers are in host byte order; files with another byte order are
+    rejected by the magic number check.
+*/
+
+struct QSettingsIndexHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 generation; // changes on every compaction
+    quint32 count;
+    quint32 journalStart;
+    quint32 reserved[3];
+};
+
+struct QSettingsIndexEntry
+{
+    quint32 keyOffset;
+    quint32 keyLength;
+    quint32 originalKeyOffset;
+    quint32 originalKeyLength;
+    quint32 valueOffset;
+    quint32 valueLength;
+};
+
+struct QSettingsJournalRecord
+{
+    enum Type { Set = 1, Remove = 2 };
+    quint32 type;
+    quint32 keyLength;
+    quint32 valueLength;
+};
+
+enum {
+    QSettingsIndexMagic = 0x51534958, // "QSIX"
+    QSettingsIndexVersion = 1,
+    QSettingsMinimumJournalSize = 64 * 1024
+};
+
+static inline quint32 qt_alignIndexed(quint32 offset)
+{
+    return (offset + 3) & ~quint32(3);
+}
+
+static inline void qt_padIndexed(QByteArray &data)
+{
+    while (data.size() & 3)
+        data.append('\0');
+}
+
+#ifndef QT_NO_DATASTREAM
+static QByteArray qt_indexedValue(const QVariant &value)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << value;
+    return result;
+}
+#endif
+
+QSettingsIndex::QSettingsIndex()
+    : file(0), data(0), entries(0)
+{
+}
+
+QSettingsIndex::~QSettingsIndex()
+{
+    clear();
+}
+
+/*
+    Maps the first \a size bytes of \a fileName, the indexed part of the file,
+    and checks that all the entries point inside of it.
+*/
+bool QSettingsIndex::load(const QString &fileName, qint64 size)
+{
+    clear();
+
+    file = new QFile(fileName);
+    if (!file->open(QFile::ReadOnly))
+        return false;
+#ifndef Q_OS_WIN
+    // a compacted file is never modified in place on Unix, only replaced,
+    // so it is safe to keep it mapped
+    data = file->map(0, size);
+#endif
+    if (!data) {
+        buffer = file->read(size);
+        delete file;
+        file = 0;
+        if (buffer.size() != size) {
+            buffer.clear();
+            return false;
+        }
+        data = reinterpret_cast<const uchar *>(buffer.constData());
+    }
+
+    const QSettingsIndexHeader *header = reinterpret_cast<const QSettingsIndexHeader *>(data);
+    quint64 entriesEnd = sizeof(QSettingsIndexHeader) + quint64(header->count) * sizeof(QSettingsIndexEntry);
+    bool ok = size >= qint64(sizeof(QSettingsIndexHeader)) && header->magic == QSettingsIndexMagic
+              && entriesEnd <= quint64(size);
+
+    const QSettingsIndexEntry *entry = reinterpret_cast<const QSettingsIndexEntry *>(header + 1);
+    for (quint32 i = 0; ok && i < header->count; ++i, ++entry) {
+        ok = (entry->keyOffset & 1) == 0 && (entry->originalKeyOffset & 1) == 0
+             && entry->keyOffset + 2 * quint64(entry->keyLength) <= quint64(size)
+             && entry->originalKeyOffset + 2 * quint64(entry->originalKeyLength) <= quint64(size)
+             && entry->valueOffset + quint64(entry->valueLength) <= quint64(size);
+    }
+    if (!ok) {
+        clear();
+        return false;
+    }
+    entries = header->count;
+    return true;
+}
+
+void QSettingsIndex::clear()
+{
+    delete file; // unmaps the file
+    file = 0;
+    buffer.clear();
+    data = 0;
+    entries = 0;
+}
+
+int QSettingsIndex::lowerBound(const QString &key) const
+{
+    int first = 0;
+    int count = entries;
+    while (count > 0) {
+        int half = count / 2;
+        if (this->key(first + half) < key) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+QString QSettingsIndex::key(int i) const
+{
+    const QSettingsIndexEntry *entry = reinterpret_cast<const QSettingsIndexEntry *>(
+                data + sizeof(QSettingsIndexHeader)) + i;
+    return QString::fromRawData(reinterpret_cast<const QChar *>(data + entry->keyOffset),
+                                entry->keyLength);
+}
+
+QString QSettingsIndex::originalKey(int i) const
+{
+    const QSettingsIndexEntry *entry = reinterpret_cast<const QSettingsIndexEntry *>(
+                data + sizeof(QSettingsIndexHeader)) + i;
+    return QString(reinterpret_cast<const QChar *>(data + entry->originalKeyOffset),
+                   entry->originalKeyLength);
+}
+
+bool QSettingsIndex::value(int i, QVariant *result) const
+{
+    const QSettingsIndexEntry *entry = reinterpret_cast<const QSettingsIndexEntry *>(
+                data + sizeof(QSettingsIndexHeader)) + i;
+#ifndef QT_NO_DATASTREAM
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(data + entry->valueOffset),
+                                             entry->valueLength);
+    QDataStream stream(raw);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream >> *result;
+    return stream.status() == QDataStream::Ok;
+#else
+    Q_UNUSED(entry);
+    Q_UNUSED(result);
+    return false;
+#endif
+}
+
+void QConfFileSettingsPrivate::loadIndexedKey(QConfFile *confFile, int i) const
+{
+    QSettingsKey key(confFile->index.originalKey(i), caseSensitivity);
+    if (confFile->originalKeys.contains(key) || confFile->journalRemovedKeys.contains(key))
+        return;
+
+    QVariant value;
+    if (confFile->index.value(i, &value))
+        confFile->originalKeys.insert(key, value);
+    else
+        setStatus(QSettings::FormatError);
+}
+
+#ifndef QT_NO_DATASTREAM
+/*
+    Replays the complete records of \a journal into the keys of \a confFile
+    and returns the number of bytes they take. A record that is cut short
+    was not completely written and is ignored.
+*/
+qint64 QConfFileSettingsPrivate::replayIndexedJournal(QConfFile *confFile,
+                                                      const QByteArray &journal) const
+{
+    const char *data = journal.constData();
+    const quint32 size = journal.size();
+    quint32 pos = 0;
+
+    while (size - pos >= sizeof(QSettingsJournalRecord)) {
+        QSettingsJournalRecord record;
+        memcpy(&record, data + pos, sizeof(record));
+        quint64 end = pos + sizeof(record) + 2 * quint64(record.keyLength) + record.valueLength;
+        if (end > size)
+            break;
+
+        const char *keyData = data + pos + sizeof(record);
+        QSettingsKey key(QString(reinterpret_cast<const QChar *>(keyData), record.keyLength),
+                         caseSensitivity);
+        if (record.type == QSettingsJournalRecord::Set) {
+            QByteArray raw = QByteArray::fromRawData(keyData + 2 * record.keyLength,
+                                                     record.valueLength);
+            QDataStream stream(raw);
+            stream.setVersion(QDataStream::Qt_5_0);
+            QVariant value;
+            stream >> value;
+            if (stream.status() != QDataStream::Ok)
+                setStatus(QSettings::FormatError);
+            confFile->originalKeys.insert(key, value);
+            confFile->journalRemovedKeys.remove(key);
+        } else if (record.type == QSettingsJournalRecord::Remove) {
+            confFile->originalKeys.remove(key);
+            confFile->journalRemovedKeys.insert(key, QVariant());
+        } else {
+            setStatus(QSettings::FormatError);
+        }
+        pos = qMin(size, qt_alignIndexed(end));
+    }
+    return pos;
+}
+
+bool QConfFileSettingsPrivate::readIndexedFile(QConfFile *confFile, QFile &file)
+{
+    const qint64 size = file.isReadable() ? file.size() : 0;
+
+    QSettingsIndexHeader header;
+    bool ok = size >= qint64(sizeof(header)) && file.seek(0)
+              && file.read(reinterpret_cast<char *>(&header), sizeof(header)) == sizeof(header)
+              && header.magic == QSettingsIndexMagic && header.version == QSettingsIndexVersion
+              && header.journalStart >= sizeof(header) && header.journalStart <= size;
+
+    /*
+        Unless the file was only appended to since we read it, start over.
+        Files that are empty (or that we can't read) are treated as empty
+        settings, like INI files.
+    */
+    if (!ok || header.generation != confFile->indexGeneration
+        || header.journalStart != confFile->journalStart || size < confFile->journalEnd) {
+        confFile->unparsedIniSections.clear();
+        confFile->originalKeys.clear();
+        confFile->journalRemovedKeys.clear();
+        confFile->index.clear();
+        confFile->indexGeneration = 0;
+        confFile->journalStart = 0;
+        confFile->journalEnd = 0;
+
+        if (!ok)
+            return size == 0;
+        if (!confFile->index.load(confFile->name, header.journalStart))
+            return false;
+        confFile->indexGeneration = header.generation;
+        confFile->journalStart = header.journalStart;
+        confFile->journalEnd = header.journalStart;
+    }
+
+    if (size > confFile->journalEnd) {
+        file.seek(confFile->journalEnd);
+        confFile->journalEnd += replayIndexedJournal(confFile, file.read(size - confFile->journalEnd));
+    }
+    return true;
+}
+
+/*
+    Saves the pending changes of \a confFile: appended to the journal if it
+    is still small, or else by compacting everything into a new file.
+*/
+bool QConfFileSettingsPrivate::writeIndexedFile(QConfFile *confFile, QFile &file)
+{
+    QByteArray journal;
+    ParsedSettingsMap::const_iterator i;
+    for (int pass = 0; pass < 2; ++pass) {
+        const ParsedSettingsMap &keys = pass == 0 ? confFile->removedKeys : confFile->addedKeys;
+        for (i = keys.constBegin(); i != keys.constEnd(); ++i) {
+            const QString key = i.key().originalCaseKey();
+            QByteArray value;
+            if (pass == 1)
+                value = qt_indexedValue(i.value());
+
+            QSettingsJournalRecord record;
+            record.type = pass == 0 ? QSettingsJournalRecord::Remove : QSettingsJournalRecord::Set;
+            record.keyLength = key.size();
+            record.valueLength = value.size();
+            journal.append(reinterpret_cast<const char *>(&record), sizeof(record));
+            journal.append(reinterpret_cast<const char *>(key.constData()), 2 * key.size());
+            journal.append(value);
+            qt_padIndexed(journal);
+        }
+    }
+
+    bool compact = confFile->journalStart == 0
+                   || confFile->journalEnd - confFile->journalStart + journal.size()
+                      > qMax(confFile->journalStart, qint64(QSettingsMinimumJournalSize));
+
+    if (compact) {
+        ensureAllSectionsParsed(confFile);
+        ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
+
+        QSettingsIndexHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = QSettingsIndexMagic;
+        header.version = QSettingsIndexVersion;
+        header.generation = quint32(QDateTime::currentMSecsSinceEpoch());
+        if (header.generation == confFile->indexGeneration)
+            ++header.generation;
+        header.count = mergedKeys.size();
+
+        QVector<QSettingsIndexEntry> entries(mergedKeys.size());
+        QByteArray pool;
+        quint32 poolStart = sizeof(header) + entries.size() * sizeof(QSettingsIndexEntry);
+        int n = 0;
+        for (i = mergedKeys.constBegin(); i != mergedKeys.constEnd(); ++i, ++n) {
+            const QString &key = i.key();
+            const QString originalKey = i.key().originalCaseKey();
+            QSettingsIndexEntry &entry = entries[n];
+
+            entry.keyOffset = poolStart + pool.size();
+            entry.keyLength = key.size();
+            pool.append(reinterpret_cast<const char *>(key.constData()), 2 * key.size());
+            if (originalKey == key) {
+                entry.originalKeyOffset = entry.keyOffset;
+            } else {
+                entry.originalKeyOffset = poolStart + pool.size();
+                pool.append(reinterpret_cast<const char *>(originalKey.constData()),
+                            2 * originalKey.size());
+            }
+            entry.originalKeyLength = originalKey.size();
+
+            QByteArray value = qt_indexedValue(i.value());
+            entry.valueOffset = poolStart + pool.size();
+            entry.valueLength = value.size();
+            pool.append(value);
+            qt_padIndexed(pool);
+        }
+        header.journalStart = poolStart + pool.size();
+
+        bool ok;
+#ifdef Q_OS_WIN
+        // nobody maps the file on Windows, and it can't be renamed while
+        // other processes have it open
+        file.seek(0);
+        file.resize(0);
+        ok = file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header)
+             && file.write(reinterpret_cast<const char *>(entries.constData()),
+                           entries.size() * sizeof(QSettingsIndexEntry))
+                == qint64(entries.size() * sizeof(QSettingsIndexEntry))
+             && file.write(pool) == pool.size()
+             && file.flush();
+#else
+        // other processes may have the current file mapped, so write a new
+        // one and replace the current one with it
+        QSaveFile newFile(confFile->name);
+        ok = newFile.open(QIODevice::WriteOnly)
+             && newFile.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header)
+             && newFile.write(reinterpret_cast<const char *>(entries.constData()),
+                              entries.size() * sizeof(QSettingsIndexEntry))
+                == qint64(entries.size() * sizeof(QSettingsIndexEntry))
+             && newFile.write(pool) == pool.size()
+             && newFile.commit();
+#endif
+        if (!ok)
+            return false;
+
+        confFile->originalKeys = mergedKeys;
+        confFile->journalRemovedKeys.clear();
+        confFile->indexGeneration = header.generation;
+        confFile->journalStart = header.journalStart;
+        confFile->journalEnd = header.journalStart;
+    } else {
+        // drop what is left of a record that was cut short
+        if (file.size() > confFile->journalEnd)
+            file.resize(confFile->journalEnd);
+        if (!file.seek(confFile->journalEnd) || file.write(journal) != journal.size()
+            || !file.flush())
+            return false;
+
+        for (i = confFile->removedKeys.constBegin(); i != confFile->removedKeys.constEnd(); ++i) {
+            confFile->originalKeys.remove(i.key());
+            confFile->journalRemovedKeys.insert(i.key(), QVariant());
+        }
+        for (i = confFile->addedKeys.constBegin(); i != confFile->addedKeys.constEnd(); ++i) {
+            confFile->originalKeys.insert(i.key(), i.value());
+            confFile->journalRemovedKeys.remove(i.key());
+        }
+        confFile->journalEnd += journal.size();
+    }
+
+    confFile->addedKeys.clear();
+    confFile->removedKeys.clear();
+    return true;
+}
+#endif // QT_NO_DATASTREAM
+
 void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) const
 {
+    if (!confFile->index.isNull()) {
+        for (int i = 0; i < confFile->index.count(); ++i)
+            loadIndexedKey(confFile, i);
+        confFile->index.clear();
+    }
+
     UnparsedSettingsMap::const_iterator i = confFile->unparsedIniSections.constBegin();
     const UnparsedSettingsMap::const_iterator end = confFile->unparsedIniSections.constEnd();
 
@@ -1975,6 +2455,19 @@ void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) cons
 void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                                                    const QSettingsKey &key) const
 {
+    if (!confFile->index.isNull()) {
+        const QSettingsIndex &index = confFile->index;
+        if (key.endsWith(QLatin1Char('/'))) {
+            for (int i = index.lowerBound(key); i < index.count() && index.key(i).startsWith(key); ++i)
+                loadIndexedKey(confFile, i);
+        } else if (!confFile->originalKeys.contains(key)) {
+            int i = index.lowerBound(key);
+            if (i < index.count() && index.key(i) == key)
+                loadIndexedKey(confFile, i);
+        }
+        return;
+    }
+
     if (confFile->unparsedIniSections.isEmpty())
         return;
 
@@ -2475,6 +2968,8 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                          API; on Unix, this means textual
                          configuration files in INI format.
     \value IniFormat  Store the settings in INI files.
+    \value IndexedFormat  Store the settings in indexed binary files
+                          (see below). This value was introduced in Qt 5.2.
     \value InvalidFormat Special value returned by registerFormat().
     \omitvalue CustomFormat1
     \omitvalue CustomFormat2
@@ -2497,6 +2992,17 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
     that the file extension is different (\c .conf for NativeFormat,
     \c .ini for IniFormat).
 
+    IndexedFormat files (extension \c .qsi) are meant for large settings
+    files that are shared by many processes. The keys are kept sorted in
+    an index that is mapped into memory, so that reading a key does not
+    require parsing the whole file. Changes are appended to a journal at
+    the end of the file, which is merged back into the index once it grows
+    large; other processes only read the part of the journal they have not
+    seen yet. The values are stored with QDataStream and keep their type.
+    The files are not meant to be edited by hand, and can only be read on
+    machines with the same byte order. IndexedFormat uses the same paths
+    as IniFormat.
+
     The INI file format is a Windows file format that Qt supports on
     all platforms. In the absence of an INI standard, we try to
     follow what Microsoft does, with the following exceptions:
@@ -86,6 +86,7 @@ public:
     enum Format {
         NativeFormat,
         IniFormat,
+        IndexedFormat,
 
         InvalidFormat = 16,
         CustomFormat1,
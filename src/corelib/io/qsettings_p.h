@@ -143,6 +143,40 @@ inline QString QSettingsGroup::toString() const
     return result;
 }
 
+class QFile;
+
+/*
+    The indexed part of an IndexedFormat file: a header, a table of entries
+    sorted by key and a pool holding the keys (as UTF-16) and the values (as
+    QDataStream data). It is mapped into memory where possible, so that
+    single keys can be found without reading the whole file.
+*/
+class QSettingsIndex
+{
+public:
+    QSettingsIndex();
+    ~QSettingsIndex();
+
+    bool load(const QString &fileName, qint64 size);
+    void clear();
+
+    inline bool isNull() const { return data == 0; }
+    inline int count() const { return entries; }
+
+    int lowerBound(const QString &key) const;
+    QString key(int i) const; // valid until the index is cleared
+    QString originalKey(int i) const;
+    bool value(int i, QVariant *result) const;
+
+private:
+    Q_DISABLE_COPY(QSettingsIndex)
+
+    QFile *file;
+    QByteArray buffer;
+    const uchar *data;
+    int entries;
+};
+
 class Q_AUTOTEST_EXPORT QConfFile
 {
 public:
@@ -161,6 +195,15 @@ public:
     ParsedSettingsMap originalKeys;
     ParsedSettingsMap addedKeys;
     ParsedSettingsMap removedKeys;
+
+    // IndexedFormat: keys are loaded from the index into originalKeys on
+    // demand; journalRemovedKeys hides the entries that the journal removed
+    QSettingsIndex index;
+    ParsedSettingsMap journalRemovedKeys;
+    quint32 indexGeneration;
+    qint64 journalStart;
+    qint64 journalEnd;
+
     QAtomicInt ref;
     QMutex mutex;
     bool userPerms;
@@ -297,6 +340,12 @@ private:
     void initAccess();
     void syncConfFile(int confFileNo);
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
+#ifndef QT_NO_DATASTREAM
+    bool readIndexedFile(QConfFile *confFile, QFile &file);
+    bool writeIndexedFile(QConfFile *confFile, QFile &file);
+    qint64 replayIndexedJournal(QConfFile *confFile, const QByteArray &journal) const;
+#endif
+    void loadIndexedKey(QConfFile *confFile, int i) const;
 #ifdef Q_OS_MAC
     bool readPlistFile(const QString &fileName, ParsedSettingsMap *map) const;
     bool writePlistFile(const QString &fileName, const ParsedSettingsMap &map) const;
@@ -234,6 +234,7 @@ static const int QTEXTSTREAM_BUFFERSIZE = 16384;
 #include <locale.h>
 #endif
 #include "private/qlocale_p.h"
+#include "private/qsimd_p.h"
 
 #include <stdlib.h>
 #include <limits.h>
@@ -627,6 +628,30 @@ QString QTextStreamPrivate::read(int maxlen)
     return ret;
 }
 
+/*!
+    \internal
+
+    Returns a pointer to the first '\\n' in [\a ptr, \a end), or 0.
+*/
+static inline const QChar *findLineFeed(const QChar *ptr, const QChar *end)
+{
+#if defined(__SSE2__)
+    // compare eight QChars at a time; the scalar loop below then finds
+    // the exact position within the block that matched
+    const __m128i lineFeed = _mm_set1_epi16('\n');
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(chunk, lineFeed)))
+            break;
+    }
+#endif
+    for ( ; ptr != end; ++ptr) {
+        if (ptr->unicode() == '\n')
+            return ptr;
+    }
+    return 0;
+}
+
 /*!
     \internal
 
@@ -656,6 +681,26 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
         }
         chPtr += startOffset;
 
+        if (delimiter == EndOfLine) {
+            int count = endOffset - startOffset;
+            if (maxlen && count > maxlen - totalSize)
+                count = maxlen - totalSize;
+            if (count > 0) {
+                const QChar *lineFeed = findLineFeed(chPtr, chPtr + count);
+                if (lineFeed) {
+                    const QChar before = lineFeed != chPtr ? lineFeed[-1] : lastChar;
+                    foundToken = true;
+                    delimSize = (before == QLatin1Char('\r')) ? 2 : 1;
+                    consumeDelimiter = true;
+                    count = lineFeed - chPtr + 1;
+                }
+                lastChar = chPtr[count - 1];
+                totalSize += count;
+                startOffset += count;
+            }
+            continue;
+        }
+
         for (; !foundToken && startOffset < endOffset && (!maxlen || totalSize < maxlen); ++startOffset) {
             const QChar ch = *chPtr++;
             ++totalSize;
@@ -674,12 +719,6 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
                 }
                 break;
             case EndOfLine:
-                if (ch == QLatin1Char('\n')) {
-                    foundToken = true;
-                    delimSize = (lastChar == QLatin1Char('\r')) ? 2 : 1;
-                    consumeDelimiter = true;
-                }
-                lastChar = ch;
                 break;
             }
         }
@@ -1447,14 +1486,17 @@ QTextStream::RealNumberNotation QTextStream::realNumberNotation() const
     describes the number of fraction digits QTextStream should
     write when generating real numbers.
 
-    The precision cannot be a negative value. The default value is 6.
+    The precision cannot be a negative value, except for
+    QLocale::FloatingPointShortest, which makes QTextStream write the
+    shortest representation that reads back as the same number. The
+    default value is 6.
 
     \sa realNumberPrecision(), setRealNumberNotation()
 */
 void QTextStream::setRealNumberPrecision(int precision)
 {
     Q_D(QTextStream);
-    if (precision < 0) {
+    if (precision < 0 && precision != QLocale::FloatingPointShortest) {
         qWarning("QTextStream::setRealNumberPrecision: Invalid precision (%d)", precision);
         d->params.realNumberPrecision = 6;
         return;
@@ -1583,6 +1625,46 @@ QString QTextStream::readLine(qint64 maxlen)
     return tmp;
 }
 
+/*!
+    \since 5.2
+
+    Reads one line of text from the stream into \a line, and returns
+    true if a line was read, or false if the stream has read to the
+    end of its data. \a maxlen and the handling of end-of-line
+    characters are the same as for readLine().
+
+    Unlike readLine(), this function reuses the memory already
+    allocated by \a line, so reading a file line by line into the same
+    QString does not allocate a new string for every line. If \a line
+    is 0, the line is read and discarded.
+
+    \snippet code/src_corelib_io_qtextstream.cpp 11
+
+    \sa readLine()
+*/
+bool QTextStream::readLineInto(QString *line, qint64 maxlen)
+{
+    Q_D(QTextStream);
+    if (line && !line->isNull())
+        line->resize(0);
+    CHECK_VALID_STREAM(false);
+
+    const QChar *readPtr;
+    int length;
+    if (!d->scan(&readPtr, &length, int(maxlen), QTextStreamPrivate::EndOfLine))
+        return false;
+
+    if (line) {
+        // reserving makes resize() keep the memory for shorter lines
+        if (line->capacity() < length)
+            line->reserve(length);
+        line->resize(length);
+        memcpy(line->data(), readPtr, length * sizeof(QChar));
+    }
+    d->consumeLastToken();
+    return true;
+}
+
 /*!
     \since 4.1
 
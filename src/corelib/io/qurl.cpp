@@ -316,6 +316,7 @@
 #include "qtldurl_p.h"
 #include "private/qipaddress_p.h"
 #include "qurlquery.h"
+#include "qurlview_p.h"
 #if defined(Q_OS_WINCE_WM)
 #pragma optimize("g", off)
 #endif
@@ -838,6 +839,27 @@ inline void QUrlPrivate::appendQuery(QString &appendTo, QUrl::FormattingOptions
 
 // setXXX functions
 
+// Returns the position of the first character in p[0, len) that isn't
+// allowed in a scheme, or -1 if they're all valid. needsLowercasing is set to
+// the position of the last uppercase letter, if any.
+static inline int findInvalidSchemeChar(const ushort *p, int len, int *needsLowercasing)
+{
+    for (int i = 0; i < len; ++i) {
+        if (p[i] >= 'a' && p[i] <= 'z')
+            continue;
+        if (p[i] >= 'A' && p[i] <= 'Z') {
+            *needsLowercasing = i;
+            continue;
+        }
+        if (p[i] >= '0' && p[i] <= '9' && i > 0)
+            continue;
+        if (p[i] == '+' || p[i] == '-' || p[i] == '.')
+            continue;
+        return i;
+    }
+    return -1;
+}
+
 inline bool QUrlPrivate::setScheme(const QString &value, int len, bool doSetError)
 {
     // schemes are strictly RFC-compliant:
@@ -856,18 +878,8 @@ inline bool QUrlPrivate::setScheme(const QString &value, int len, bool doSetErro
     // validate it:
     int needsLowercasing = -1;
     const ushort *p = reinterpret_cast<const ushort *>(value.constData());
-    for (int i = 0; i < len; ++i) {
-        if (p[i] >= 'a' && p[i] <= 'z')
-            continue;
-        if (p[i] >= 'A' && p[i] <= 'Z') {
-            needsLowercasing = i;
-            continue;
-        }
-        if (p[i] >= '0' && p[i] <= '9' && i > 0)
-            continue;
-        if (p[i] == '+' || p[i] == '-' || p[i] == '.')
-            continue;
-
+    int i = findInvalidSchemeChar(p, len, &needsLowercasing);
+    if (i != -1) {
         // found something else
         // don't call setError needlessly:
         // if we've been called from parse(), it will try to recover
@@ -890,6 +902,43 @@ inline bool QUrlPrivate::setScheme(const QString &value, int len, bool doSetErro
     return true;
 }
 
+// Returns the position of the ':' separating the host from the port in
+// auth[from, end), or -1 if there's no port delimiter. Colons inside an
+// IP-literal ("[...]") don't count.
+static inline int findPortDelimiter(const QString &auth, int from, int end)
+{
+    int colonIndex = auth.lastIndexOf(QLatin1Char(':'), end - 1);
+    if (colonIndex < from)
+        return -1;
+
+    if (auth.at(from).unicode() == '[') {
+        // check if colonIndex isn't inside the "[...]" part
+        int closingBracket = auth.indexOf(QLatin1Char(']'), from);
+        if (uint(closingBracket) > uint(colonIndex))
+            return -1;
+    }
+    return colonIndex;
+}
+
+// Parses the port number in auth[from, end); returns -1 if it isn't made of
+// digits only or is out of range
+static inline int parsePort(const QString &auth, int from, int end)
+{
+    unsigned long x = 0;
+    for (int i = from; i < end; ++i) {
+        ushort c = auth.at(i).unicode();
+        if (c >= '0' && c <= '9') {
+            x *= 10;
+            x += c - '0';
+        } else {
+            return -1;
+        }
+        if (x != ushort(x))
+            return -1;
+    }
+    return int(x);
+}
+
 inline void QUrlPrivate::setAuthority(const QString &auth, int from, int end, QUrl::ParsingMode mode)
 {
     sectionIsPresent &= ~Authority;
@@ -905,36 +954,14 @@ inline void QUrlPrivate::setAuthority(const QString &auth, int from, int end, QU
             from = userInfoIndex + 1;
         }
 
-        int colonIndex = auth.lastIndexOf(QLatin1Char(':'), end - 1);
-        if (colonIndex < from)
-            colonIndex = -1;
-
-        if (uint(colonIndex) < uint(end)) {
-            if (auth.at(from).unicode() == '[') {
-                // check if colonIndex isn't inside the "[...]" part
-                int closingBracket = auth.indexOf(QLatin1Char(']'), from);
-                if (uint(closingBracket) > uint(colonIndex))
-                    colonIndex = -1;
-            }
-        }
-
+        int colonIndex = findPortDelimiter(auth, from, end);
         if (colonIndex == end - 1) {
             // found a colon but no digits after it
             setError(PortEmptyError, auth, colonIndex + 1);
         } else if (uint(colonIndex) < uint(end)) {
-            unsigned long x = 0;
-            for (int i = colonIndex + 1; i < end; ++i) {
-                ushort c = auth.at(i).unicode();
-                if (c >= '0' && c <= '9') {
-                    x *= 10;
-                    x += c - '0';
-                } else {
-                    x = ulong(-1); // x != ushort(x)
-                    break;
-                }
-            }
-            if (x == ushort(x)) {
-                port = ushort(x);
+            int x = parsePort(auth, colonIndex + 1, end);
+            if (x != -1) {
+                port = x;
             } else {
                 setError(InvalidPortError, auth, colonIndex + 1);
                 if (mode == QUrl::StrictMode)
@@ -1136,6 +1163,39 @@ static bool parseIp6(QString &host, const QChar *begin, const QChar *end)
     return true;
 }
 
+// Returns true if [begin, end) is a reg-name made of non-empty labels of at
+// most 63 US-ASCII letters, digits, hyphens and underscores, with no label
+// starting or ending with a hyphen and none in ACE form. Those pass the STD 3
+// check as they are and need no nameprepping, only lowercasing.
+static bool isPlainAsciiHost(const QChar *begin, const QChar *end)
+{
+    const QChar *label = begin;
+    for (const QChar *p = begin; ; ++p) {
+        if (p == end || p->unicode() == '.') {
+            const int labelLength = p - label;
+            if (labelLength == 0) {
+                // only a trailing dot is allowed
+                return p == end && p != begin;
+            }
+            if (labelLength > 63 || label[0].unicode() == '-' || p[-1].unicode() == '-')
+                return false;
+            if (labelLength >= 4 && (label[0].unicode() | 0x20) == 'x' && (label[1].unicode() | 0x20) == 'n'
+                    && label[2].unicode() == '-' && label[3].unicode() == '-')
+                return false;
+            if (p == end)
+                return true;
+            label = p + 1;
+            continue;
+        }
+
+        register ushort c = p->unicode();
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || c == '-' || c == '_')
+            continue;
+        return false;
+    }
+}
+
 inline bool QUrlPrivate::setHost(const QString &value, int from, int iend, QUrl::ParsingMode mode)
 {
     const QChar *begin = value.constData() + from;
@@ -1179,6 +1239,17 @@ inline bool QUrlPrivate::setHost(const QString &value, int from, int iend, QUrl:
         return true;
     }
 
+    if (isPlainAsciiHost(begin, end)) {
+        // the common case: qt_ACE_do would only lowercase it
+        host.resize(len);
+        QChar *out = host.data();
+        for (const QChar *in = begin; in != end; ++in, ++out) {
+            register ushort uc = in->unicode();
+            *out = (uc >= 'A' && uc <= 'Z') ? QChar(uc | 0x20) : *in;
+        }
+        return true;
+    }
+
     // This is probably a reg-name.
     // But it can also be an encoded string that, when decoded becomes one
     // of the types above.
@@ -1222,6 +1293,39 @@ inline bool QUrlPrivate::setHost(const QString &value, int from, int iend, QUrl:
     return true;
 }
 
+// Finds the first ':' and the first '?' that come before the first '#', and
+// that '#'. Each is set to -1 if not present.
+static inline void findDelimiters(const ushort *data, int len, int *colon, int *question, int *hash)
+{
+    *colon = *question = *hash = -1;
+    for (int i = 0; i < len; ++i) {
+        register uint uc = data[i];
+        if (uc == '#') {
+            *hash = i;
+
+            // nothing more to be found
+            break;
+        }
+
+        if (*question == -1) {
+            if (uc == ':' && *colon == -1)
+                *colon = i;
+            else if (uc == '?')
+                *question = i;
+        }
+    }
+}
+
+// the authority ends at the first slash after the "//"
+static inline int findAuthorityEnd(const ushort *data, int from, int hierEnd)
+{
+    for (int i = from; i < hierEnd; ++i) {
+        if (data[i] == '/')
+            return i;
+    }
+    return hierEnd;
+}
+
 inline void QUrlPrivate::parse(const QString &url, QUrl::ParsingMode parsingMode)
 {
     //   URI-reference = URI / relative-ref
@@ -1236,29 +1340,10 @@ inline void QUrlPrivate::parse(const QString &url, QUrl::ParsingMode parsingMode
     clearError();
 
     // find the important delimiters
-    int colon = -1;
-    int question = -1;
-    int hash = -1;
+    int colon, question, hash;
     const int len = url.length();
-    const QChar *const begin = url.constData();
-    const ushort *const data = reinterpret_cast<const ushort *>(begin);
-
-    for (int i = 0; i < len; ++i) {
-        register uint uc = data[i];
-        if (uc == '#' && hash == -1) {
-            hash = i;
-
-            // nothing more to be found
-            break;
-        }
-
-        if (question == -1) {
-            if (uc == ':' && colon == -1)
-                colon = i;
-            else if (uc == '?')
-                question = i;
-        }
-    }
+    const ushort *const data = reinterpret_cast<const ushort *>(url.constData());
+    findDelimiters(data, len, &colon, &question, &hash);
 
     // check if we have a scheme
     int hierStart;
@@ -1275,14 +1360,7 @@ inline void QUrlPrivate::parse(const QString &url, QUrl::ParsingMode parsingMode
     int hierEnd = qMin<uint>(qMin<uint>(question, hash), len);
     if (hierEnd - hierStart >= 2 && data[hierStart] == '/' && data[hierStart + 1] == '/') {
         // we have an authority, it ends at the first slash after these
-        int authorityEnd = hierEnd;
-        for (int i = hierStart + 2; i < authorityEnd ; ++i) {
-            if (data[i] == '/') {
-                authorityEnd = i;
-                break;
-            }
-        }
-
+        int authorityEnd = findAuthorityEnd(data, hierStart + 2, hierEnd);
         setAuthority(url, hierStart + 2, authorityEnd, parsingMode);
 
         // even if we failed to set the authority properly, let's try to recover
@@ -3926,4 +4004,462 @@ QUrl QUrl::fromUserInput(const QString &userInput)
 }
 // end of BSD code
 
+/*!
+    \class QUrlView
+    \internal
+
+    \brief The QUrlView class provides read-only access to the components of
+    a URL string without copying them.
+
+    Parsing a URL with QUrl splits it into separate strings for the scheme,
+    user info, host, path, query and fragment, and recodes each of them.
+    Applications that parse a large number of URLs but only look at one or
+    two of their components, such as the host or the path, pay for
+    components they never use.
+
+    QUrlView validates the string exactly as QUrl would and records where
+    each component is, without copying or decoding anything for the common
+    case of US-ASCII host names. The view shares the data of the QString it
+    was constructed from, which is not copied.
+
+    The component accessors, like host() or path(), decode the component
+    when they are called and return the same string as the corresponding
+    QUrl function would, including its ComponentFormattingOptions handling.
+    The functions ending in \c Ref, like hostRef(), return the component
+    exactly as it appears in the string, without any decoding.
+
+    If the URL is not valid, the accessors return the components as far as
+    the tolerant parser could identify them, which may differ from what
+    QUrl would return.
+
+    \sa QUrl
+*/
+
+/*!
+    Constructs an empty QUrlView.
+*/
+QUrlView::QUrlView()
+    : m_schemeEnd(-1), m_authorityBegin(-1), m_userInfoEnd(-1), m_hostEnd(-1),
+      m_pathBegin(0), m_pathEnd(0), m_question(-1), m_hash(-1), m_port(-1),
+      m_mode(QUrl::TolerantMode), m_valid(false)
+{
+}
+
+/*!
+    Constructs a view of the URL \a url, parsed according to \a mode.
+
+    \sa setUrl()
+*/
+QUrlView::QUrlView(const QString &url, QUrl::ParsingMode mode)
+{
+    setUrl(url, mode);
+}
+
+/*!
+    Parses \a url according to \a mode and makes this view refer to it. The
+    string is validated and the position of each component recorded, but
+    the components are not decoded until they are requested.
+
+    As with QUrl::setUrl(), QUrl::DecodedMode is not permitted; the view is
+    left empty in that case.
+
+    \sa url(), isValid()
+*/
+void QUrlView::setUrl(const QString &url, QUrl::ParsingMode mode)
+{
+    clear();
+    if (mode == QUrl::DecodedMode) {
+        qWarning("QUrlView: QUrl::DecodedMode is not permitted when parsing a full URL");
+        return;
+    }
+
+    m_url = url;
+    m_mode = mode;
+    if (url.isEmpty())
+        return;
+
+    // this follows QUrlPrivate::parse(), recording the positions of the
+    // components instead of storing them
+    const int len = url.length();
+    const ushort *const data = reinterpret_cast<const ushort *>(url.constData());
+    int colon;
+    findDelimiters(data, len, &colon, &m_question, &m_hash);
+
+    int hierStart = 0;
+    if (colon > 0) {
+        int needsLowercasing;
+        if (findInvalidSchemeChar(data, colon, &needsLowercasing) == -1) {
+            m_schemeEnd = colon;
+            hierStart = colon + 1;
+        }
+    }
+
+    QUrlPrivate d;  // only used for the rare cases below
+    m_valid = true;
+    m_pathEnd = qMin<uint>(qMin<uint>(m_question, m_hash), len);
+    if (m_pathEnd - hierStart >= 2 && data[hierStart] == '/' && data[hierStart + 1] == '/') {
+        m_authorityBegin = hierStart + 2;
+        m_pathBegin = findAuthorityEnd(data, m_authorityBegin, m_pathEnd);
+
+        int from = m_authorityBegin;
+        const int end = m_pathBegin;
+        m_hostEnd = end;
+        if (from != end) {
+            int userInfoIndex = url.indexOf(QLatin1Char('@'), from);
+            if (uint(userInfoIndex) < uint(end)) {
+                m_userInfoEnd = userInfoIndex;
+                if (mode == QUrl::StrictMode && !d.validateComponent(QUrlPrivate::UserInfo, url, from, userInfoIndex))
+                    m_valid = false;
+                from = userInfoIndex + 1;
+            }
+
+            int colonIndex = findPortDelimiter(url, from, end);
+            if (colonIndex != -1) {
+                m_hostEnd = colonIndex;
+                if (colonIndex == end - 1 || (m_port = parsePort(url, colonIndex + 1, end)) == -1)
+                    m_valid = false;
+            }
+
+            const QChar *hostBegin = url.constData() + from;
+            const QChar *hostEnd = url.constData() + m_hostEnd;
+            if (hostBegin != hostEnd && !isPlainAsciiHost(hostBegin, hostEnd)) {
+                // IPv4 addresses are checked in place; IP-literals,
+                // percent-encoded and internationalized names need the full parser
+                QIPAddressUtils::IPv4Address ip4;
+                bool ok = (hostBegin->unicode() != '[' && QIPAddressUtils::parseIp4(ip4, hostBegin, hostEnd))
+                        || d.setHost(url, from, m_hostEnd, mode);
+                if (!ok || (mode == QUrl::StrictMode && !d.validateComponent(QUrlPrivate::Host, url, from, m_hostEnd)))
+                    m_valid = false;
+            }
+        }
+    } else {
+        m_pathBegin = hierStart;
+        if (m_pathBegin > m_pathEnd)
+            m_pathBegin = m_pathEnd;
+    }
+
+    if (m_valid && mode == QUrl::StrictMode) {
+        m_valid = d.validateComponent(QUrlPrivate::Path, url, m_pathBegin, m_pathEnd)
+                && (m_question == -1 || d.validateComponent(QUrlPrivate::Query, url, m_question + 1, queryEnd()))
+                && (m_hash == -1 || d.validateComponent(QUrlPrivate::Fragment, url, m_hash + 1, len));
+    }
+
+    if (m_valid && m_schemeEnd == -1 && m_authorityBegin == -1) {
+        // see QUrlPrivate::validityError(): a relative path can't have a
+        // colon before the first slash
+        for (int i = m_pathBegin; i < m_pathEnd; ++i) {
+            register ushort c = data[i];
+            if (c == '/')
+                break;
+            if (c == ':') {
+                m_valid = false;
+                break;
+            }
+            if (c == '%') {
+                // it may decode to a colon
+                d.setPath(url, m_pathBegin, m_pathEnd);
+                m_valid = d.validityError() == QUrlPrivate::NoError;
+                break;
+            }
+        }
+    }
+}
+
+/*!
+    \fn QString QUrlView::url() const
+
+    Returns the string this view refers to, exactly as it was passed to the
+    constructor or to setUrl().
+*/
+
+/*!
+    Returns a QUrl parsed from the string this view refers to, using the
+    same parsing mode.
+*/
+QUrl QUrlView::toUrl() const
+{
+    return QUrl(m_url, m_mode);
+}
+
+/*!
+    \fn bool QUrlView::isValid() const
+
+    Returns true if the URL is non-empty and valid; otherwise returns false.
+    This is the same as calling QUrl::isValid() on a QUrl parsed from the
+    same string in the same mode.
+*/
+
+/*!
+    \fn bool QUrlView::isEmpty() const
+
+    Returns true if the view refers to an empty string.
+*/
+
+/*!
+    \fn bool QUrlView::isRelative() const
+
+    Returns true if the URL is relative; otherwise returns false. A URL is
+    relative if its scheme is undefined.
+
+    \sa QUrl::isRelative()
+*/
+
+/*!
+    Resets the view so that it refers to an empty string.
+*/
+void QUrlView::clear()
+{
+    *this = QUrlView();
+}
+
+/*!
+    Returns the scheme of the URL, converted to lowercase, or an empty
+    string if it is undefined.
+
+    \sa QUrl::scheme(), schemeRef()
+*/
+QString QUrlView::scheme() const
+{
+    if (m_schemeEnd == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setScheme(m_url, m_schemeEnd, false);
+    return d.scheme;
+}
+
+/*!
+    Returns the user name of the URL if it is defined; otherwise an empty
+    string is returned. The \a options argument controls how to format the
+    user name component.
+
+    \sa QUrl::userName()
+*/
+QString QUrlView::userName(QUrl::ComponentFormattingOptions options) const
+{
+    if (m_userInfoEnd == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setUserInfo(m_url, m_authorityBegin, m_userInfoEnd);
+    QString result;
+    d.appendUserName(result, options);
+    return result;
+}
+
+/*!
+    Returns the password of the URL if it is defined; otherwise an empty
+    string is returned. The \a options argument controls how to format the
+    password component.
+
+    \sa QUrl::password()
+*/
+QString QUrlView::password(QUrl::ComponentFormattingOptions options) const
+{
+    if (m_userInfoEnd == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setUserInfo(m_url, m_authorityBegin, m_userInfoEnd);
+    QString result;
+    d.appendPassword(result, options);
+    return result;
+}
+
+/*!
+    Returns the host of the URL if it is defined; otherwise an empty string
+    is returned. The \a options argument controls how the host name will be
+    formatted, as in QUrl::host().
+
+    \sa QUrl::host(), hostRef()
+*/
+QString QUrlView::host(QUrl::ComponentFormattingOptions options) const
+{
+    if (m_authorityBegin == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setHost(m_url, hostBegin(), m_hostEnd, m_mode);
+    QString result;
+    d.appendHost(result, options);
+    if (result.startsWith(QLatin1Char('[')))
+        return result.mid(1, result.length() - 2);
+    return result;
+}
+
+/*!
+    \fn int QUrlView::port(int defaultPort) const
+
+    Returns the port of the URL, or \a defaultPort if the port is
+    unspecified.
+
+    \sa QUrl::port()
+*/
+
+/*!
+    Returns the path of the URL. The \a options argument controls how to
+    format the path component.
+
+    \sa QUrl::path(), pathRef()
+*/
+QString QUrlView::path(QUrl::ComponentFormattingOptions options) const
+{
+    QUrlPrivate d;
+    if (m_pathBegin < m_pathEnd)
+        d.setPath(m_url, m_pathBegin, m_pathEnd);
+    QString result;
+    d.appendPath(result, options, QUrlPrivate::Path);
+    return result;
+}
+
+/*!
+    \fn bool QUrlView::hasQuery() const
+
+    Returns true if the URL contains a query, even an empty one.
+
+    \sa query(), QUrl::hasQuery()
+*/
+
+/*!
+    Returns the query string of the URL if there's a query string, or an
+    empty result if not. The \a options argument controls how to format
+    the query component.
+
+    \sa QUrl::query(), queryRef()
+*/
+QString QUrlView::query(QUrl::ComponentFormattingOptions options) const
+{
+    if (m_question == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setQuery(m_url, m_question + 1, queryEnd());
+    QString result;
+    d.appendQuery(result, options, QUrlPrivate::Query);
+    if (result.isNull())
+        result.detach();
+    return result;
+}
+
+/*!
+    \fn bool QUrlView::hasFragment() const
+
+    Returns true if the URL contains a fragment, even an empty one.
+
+    \sa fragment(), QUrl::hasFragment()
+*/
+
+/*!
+    Returns the fragment of the URL, or an empty result if there is none.
+    The \a options argument controls how to format the fragment component.
+
+    \sa QUrl::fragment(), fragmentRef()
+*/
+QString QUrlView::fragment(QUrl::ComponentFormattingOptions options) const
+{
+    if (m_hash == -1)
+        return QString();
+
+    QUrlPrivate d;
+    d.setFragment(m_url, m_hash + 1, m_url.length());
+    QString result;
+    d.appendFragment(result, options);
+    if (result.isNull())
+        result.detach();
+    return result;
+}
+
+/*!
+    Returns a reference to the scheme as it appears in the string, without
+    lowercasing it, or a null reference if the scheme is undefined.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+
+    \sa scheme()
+*/
+QStringRef QUrlView::schemeRef() const
+{
+    if (m_schemeEnd == -1)
+        return QStringRef();
+    return QStringRef(&m_url, 0, m_schemeEnd);
+}
+
+/*!
+    Returns a reference to the authority (user info, host and port) as it
+    appears in the string, or a null reference if the URL has no authority.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+*/
+QStringRef QUrlView::authorityRef() const
+{
+    if (m_authorityBegin == -1)
+        return QStringRef();
+    return QStringRef(&m_url, m_authorityBegin, m_pathBegin - m_authorityBegin);
+}
+
+/*!
+    Returns a reference to the host as it appears in the string, without
+    any decoding or normalization, or a null reference if the URL has no
+    authority. Unlike host(), IP-literals keep their square brackets.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+
+    \sa host()
+*/
+QStringRef QUrlView::hostRef() const
+{
+    if (m_authorityBegin == -1)
+        return QStringRef();
+    return QStringRef(&m_url, hostBegin(), m_hostEnd - hostBegin());
+}
+
+/*!
+    Returns a reference to the path as it appears in the string, without
+    any decoding.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+
+    \sa path()
+*/
+QStringRef QUrlView::pathRef() const
+{
+    return QStringRef(&m_url, m_pathBegin, m_pathEnd - m_pathBegin);
+}
+
+/*!
+    Returns a reference to the query as it appears in the string, or a null
+    reference if there is no query.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+
+    \sa query()
+*/
+QStringRef QUrlView::queryRef() const
+{
+    if (m_question == -1)
+        return QStringRef();
+    return QStringRef(&m_url, m_question + 1, queryEnd() - m_question - 1);
+}
+
+/*!
+    Returns a reference to the fragment as it appears in the string, or a
+    null reference if there is no fragment.
+
+    The reference is valid for as long as this view is not modified or
+    destroyed.
+
+    \sa fragment()
+*/
+QStringRef QUrlView::fragmentRef() const
+{
+    if (m_hash == -1)
+        return QStringRef();
+    return QStringRef(&m_url, m_hash + 1, m_url.length() - m_hash - 1);
+}
+
 QT_END_NAMESPACE
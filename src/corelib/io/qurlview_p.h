@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QURLVIEW_P_H
+#define QURLVIEW_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists for the convenience of
+// qurl.cpp. This header file may change from version to version without
+// notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qstring.h"
+#include "qurl.h"
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QUrlView
+{
+public:
+    QUrlView();
+    explicit QUrlView(const QString &url, QUrl::ParsingMode mode = QUrl::TolerantMode);
+
+    void setUrl(const QString &url, QUrl::ParsingMode mode = QUrl::TolerantMode);
+    QString url() const { return m_url; }
+    QUrl toUrl() const;
+
+    bool isValid() const { return m_valid; }
+    bool isEmpty() const { return m_url.isEmpty(); }
+    bool isRelative() const { return m_schemeEnd == -1; }
+    void clear();
+
+    QString scheme() const;
+    QString userName(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+    QString password(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+    QString host(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+    int port(int defaultPort = -1) const { return m_port == -1 ? defaultPort : m_port; }
+    QString path(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+    bool hasQuery() const { return m_question != -1; }
+    QString query(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+    bool hasFragment() const { return m_hash != -1; }
+    QString fragment(QUrl::ComponentFormattingOptions options = QUrl::PrettyDecoded) const;
+
+    QStringRef schemeRef() const;
+    QStringRef authorityRef() const;
+    QStringRef hostRef() const;
+    QStringRef pathRef() const;
+    QStringRef queryRef() const;
+    QStringRef fragmentRef() const;
+
+private:
+    int hostBegin() const { return m_userInfoEnd == -1 ? m_authorityBegin : m_userInfoEnd + 1; }
+    int queryEnd() const { return m_hash == -1 ? m_url.length() : m_hash; }
+
+    QString m_url;
+    int m_schemeEnd;        // the ':' after the scheme, or -1
+    int m_authorityBegin;   // just past the "//", or -1
+    int m_userInfoEnd;      // the '@' after the user info, or -1
+    int m_hostEnd;          // the ':' before the port, or the end of the authority
+    int m_pathBegin;
+    int m_pathEnd;
+    int m_question;         // the '?' starting the query, or -1
+    int m_hash;             // the '#' starting the fragment, or -1
+    int m_port;
+    QUrl::ParsingMode m_mode;
+    bool m_valid;
+};
+
+Q_DECLARE_TYPEINFO(QUrlView, Q_MOVABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QURLVIEW_P_H
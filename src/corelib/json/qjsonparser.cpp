@@ -45,6 +45,7 @@
 #include <qdebug.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
+#include "private/qlocale_tools_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -679,32 +680,27 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
-
-    if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            val->int_value = n;
-            val->latinOrIntValue = true;
-            END;
-            return true;
-        }
-    }
+    DEBUG << "numberstring" << QByteArray(start, json - start);
 
     bool ok;
     union {
         quint64 ui;
         double d;
     };
-    d = number.toDouble(&ok);
+    d = qt_asciiToDouble(start, json - start, &ok);
 
     if (!ok) {
         lastError = QJsonParseError::IllegalNumber;
         return false;
     }
 
+    if (isInt && d < (1<<25) && d > -(1<<25)) {
+        val->int_value = int(d);
+        val->latinOrIntValue = true;
+        END;
+        return true;
+    }
+
     int pos = reserveSpace(sizeof(double));
     *(quint64 *)(data + pos) = qToLittleEndian(ui);
     val->value = pos - baseOffset;
@@ -41,6 +41,7 @@
 
 #include "qjsonwriter_p.h"
 #include "qjson_p.h"
+#include "qlocale.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -170,7 +171,7 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
         json += v.toBoolean() ? "true" : "false";
         break;
     case QJsonValue::Double:
-        json += QByteArray::number(v.toDouble(b));
+        json += QByteArray::number(v.toDouble(b), 'g', QLocale::FloatingPointShortest);
         break;
     case QJsonValue::String:
         json += '"';
@@ -60,6 +60,7 @@
 #include <qset.h>
 #include <qsemaphore.h>
 #include <qsharedpointer.h>
+#include <qfreelistpool.h>
 
 #include <private/qorderedmutexlocker_p.h>
 
@@ -468,6 +469,45 @@ QMetaCallEvent::~QMetaCallEvent()
         slotObj_->destroyIfLastRef();
 }
 
+// Queued connections create a QMetaCallEvent for every emission and delete it
+// in the receiver's thread. The pool is never destroyed, as events may still be
+// queued when static objects are destroyed.
+static QFreeListPool<QMetaCallEvent> *metaCallEventPool()
+{
+    static QBasicAtomicPointer<QFreeListPool<QMetaCallEvent> > pool = Q_BASIC_ATOMIC_INITIALIZER(0);
+    QFreeListPool<QMetaCallEvent> *p = pool.loadAcquire();
+    if (!p) {
+        p = new QFreeListPool<QMetaCallEvent>;
+        if (!pool.testAndSetRelease(0, p)) {
+            delete p;
+            p = pool.loadAcquire();
+        }
+    }
+    return p;
+}
+
+/*!
+    \internal
+ */
+void *QMetaCallEvent::operator new(size_t size)
+{
+    // subclasses, like the QtDBus call events, are allocated normally
+    if (size != sizeof(QMetaCallEvent))
+        return ::operator new(size);
+    return metaCallEventPool()->allocate();
+}
+
+/*!
+    \internal
+ */
+void QMetaCallEvent::operator delete(void *ptr, size_t size)
+{
+    if (size != sizeof(QMetaCallEvent))
+        ::operator delete(ptr);
+    else
+        metaCallEventPool()->deallocate(static_cast<QMetaCallEvent *>(ptr));
+}
+
 /*!
     \internal
  */
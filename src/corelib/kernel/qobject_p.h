@@ -362,6 +362,9 @@ public:
 
     ~QMetaCallEvent();
 
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     inline int id() const { return method_offset_ + method_relative_; }
     inline const QObject *sender() const { return sender_; }
     inline int signalId() const { return signalId_; }
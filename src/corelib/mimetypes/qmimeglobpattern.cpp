@@ -41,7 +41,6 @@
 
 #include "qmimeglobpattern_p.h"
 
-#include <QRegExp>
 #include <QStringList>
 #include <QDebug>
 
@@ -91,61 +90,67 @@ void QMimeGlobMatchResult::addMatch(const QString &mimeType, int weight, const Q
     \sa QMimeType, QMimeDatabase, QMimeMagicRuleMatcher, QMimeMagicRule
 */
 
-bool QMimeGlobPattern::matchFileName(const QString &inputFilename) const
+// The type of a pattern is determined once, so that matching a file name
+// doesn't have to scan the pattern for wildcards again.
+QMimeGlobPattern::PatternType QMimeGlobPattern::detectPatternType(const QString &pattern)
+{
+    const int patternLength = pattern.length();
+    if (!patternLength || pattern.contains(QLatin1Char('[')) || pattern.contains(QLatin1Char('?')))
+        return OtherPattern;
+
+    const int starCount = pattern.count(QLatin1Char('*'));
+    if (starCount == 0)
+        return LiteralPattern;
+    if (starCount == 1) {
+        if (pattern.at(0) == QLatin1Char('*'))
+            return SuffixPattern;
+        if (pattern.at(patternLength - 1) == QLatin1Char('*'))
+            return PrefixPattern;
+    }
+    return OtherPattern;
+}
+
+bool QMimeGlobPattern::matchFileName(const QString &filename) const
 {
     // "Applications MUST match globs case-insensitively, except when the case-sensitive
     // attribute is set to true."
     // The constructor takes care of putting case-insensitive patterns in lowercase.
-    const QString filename = m_caseSensitivity == Qt::CaseInsensitive ? inputFilename.toLower() : inputFilename;
+    if (m_caseSensitivity == Qt::CaseInsensitive)
+        return matchFileName(filename, filename.toLower());
+    return matchFileName(filename, filename);
+}
 
+bool QMimeGlobPattern::matchFileName(const QString &fileName, const QString &lowerCaseFileName) const
+{
+    const QString &filename = m_caseSensitivity == Qt::CaseInsensitive ? lowerCaseFileName : fileName;
     const int pattern_len = m_pattern.length();
-    if (!pattern_len)
-        return false;
-    const int len = filename.length();
 
-    const int starCount = m_pattern.count(QLatin1Char('*'));
-
-    // Patterns like "*~", "*.extension"
-    if (m_pattern[0] == QLatin1Char('*') && m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 1)
-    {
-        if (len + 1 < pattern_len) return false;
-
-        const QChar *c1 = m_pattern.unicode() + pattern_len - 1;
-        const QChar *c2 = filename.unicode() + len - 1;
-        int cnt = 1;
-        while (cnt < pattern_len && *c1-- == *c2--)
-            ++cnt;
-        return cnt == pattern_len;
-    }
-
-    // Patterns like "README*" (well this is currently the only one like that...)
-    if (starCount == 1 && m_pattern.at(pattern_len - 1) == QLatin1Char('*')) {
-        if (len + 1 < pattern_len) return false;
-        if (m_pattern.at(0) == QLatin1Char('*'))
-            return filename.indexOf(m_pattern.mid(1, pattern_len - 2)) != -1;
-
-        const QChar *c1 = m_pattern.unicode();
-        const QChar *c2 = filename.unicode();
-        int cnt = 1;
-        while (cnt < pattern_len && *c1++ == *c2++)
-           ++cnt;
-        return cnt == pattern_len;
+    switch (m_patternType) {
+    case SuffixPattern:
+        // Patterns like "*~", "*.extension"
+        return filename.endsWith(QStringRef(&m_pattern, 1, pattern_len - 1));
+    case PrefixPattern:
+        // Patterns like "README*" (well this is currently the only one like that...)
+        return filename.startsWith(QStringRef(&m_pattern, 0, pattern_len - 1));
+    case LiteralPattern:
+        // Names without any wildcards like "README"
+        return m_pattern == filename;
+    case OtherPattern:
+        break;
     }
 
-    // Names without any wildcards like "README"
-    if (m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 0 && m_pattern.indexOf(QLatin1Char('?')))
-        return (m_pattern == filename);
+    if (!pattern_len)
+        return false;
 
     // Other (quite rare) patterns, like "*.anim[1-9j]": use slow but correct method
-    QRegExp rx(m_pattern, Qt::CaseSensitive, QRegExp::WildcardUnix);
-    return rx.exactMatch(filename);
+    return m_regExp.exactMatch(filename);
 }
 
 static bool isFastPattern(const QString &pattern)
 {
-   // starts with "*.", has no other '*' and no other '.'
+   // starts with "*.", has no other '*', like "*.txt" or "*.tar.gz"
    return pattern.lastIndexOf(QLatin1Char('*')) == 0
-      && pattern.lastIndexOf(QLatin1Char('.')) == 1
+      && pattern.startsWith(QLatin1String("*."))
       // and contains no other special character
       && !pattern.contains(QLatin1Char('?'))
       && !pattern.contains(QLatin1Char('['))
@@ -189,43 +194,50 @@ void QMimeAllGlobPatterns::removeMimeType(const QString &mimeType)
 }
 
 void QMimeGlobPatternList::match(QMimeGlobMatchResult &result,
-                                 const QString &fileName) const
+                                 const QString &fileName, const QString &lowerCaseFileName) const
 {
 
     QMimeGlobPatternList::const_iterator it = this->constBegin();
     const QMimeGlobPatternList::const_iterator endIt = this->constEnd();
     for (; it != endIt; ++it) {
         const QMimeGlobPattern &glob = *it;
-        if (glob.matchFileName(fileName))
+        if (glob.matchFileName(fileName, lowerCaseFileName))
             result.addMatch(glob.mimeType(), glob.weight(), glob.pattern());
     }
 }
 
 QStringList QMimeAllGlobPatterns::matchingGlobs(const QString &fileName, QString *foundSuffix) const
 {
+    // toLower because fast patterns are always case-insensitive and saved as lowercase,
+    // and the other case-insensitive patterns are lowercase too
+    const QString lowerCaseFileName = fileName.toLower();
+
     // First try the high weight matches (>50), if any.
     QMimeGlobMatchResult result;
-    m_highWeightGlobs.match(result, fileName);
+    m_highWeightGlobs.match(result, fileName, lowerCaseFileName);
     if (result.m_matchingMimeTypes.isEmpty()) {
 
         // Now use the "fast patterns" dict, for simple *.foo patterns with weight 50
-        // (which is most of them, so this optimization is definitely worth it)
-        const int lastDot = fileName.lastIndexOf(QLatin1Char('.'));
-        if (lastDot != -1) { // if no '.', skip the extension lookup
-            const int ext_len = fileName.length() - lastDot - 1;
-            const QString simpleExtension = fileName.right(ext_len).toLower();
-            // (toLower because fast patterns are always case-insensitive and saved as lowercase)
-
-            const QStringList matchingMimeTypes = m_fastPatterns.value(simpleExtension);
-            foreach (const QString &mime, matchingMimeTypes) {
-                result.addMatch(mime, 50, QLatin1String("*.") + simpleExtension);
-            }
-            // Can't return yet; *.tar.bz2 has to win over *.bz2, so we need the low-weight mimetypes anyway,
-            // at least those with weight 50.
+        // (which is most of them, so this optimization is definitely worth it).
+        // Patterns like *.tar.bz2 are in there too, so look up every suffix that
+        // follows a '.', from the longest to the shortest. addMatch() then keeps
+        // *.tar.bz2 over *.bz2.
+        const QChar *data = lowerCaseFileName.constData();
+        const int length = lowerCaseFileName.length();
+        for (int dot = lowerCaseFileName.indexOf(QLatin1Char('.')); dot != -1;
+             dot = lowerCaseFileName.indexOf(QLatin1Char('.'), dot + 1)) {
+            // no need to copy the suffix for the lookup
+            const QString extension = QString::fromRawData(data + dot + 1, length - dot - 1);
+            const PatternsMap::const_iterator it = m_fastPatterns.constFind(extension);
+            if (it == m_fastPatterns.constEnd())
+                continue;
+            const QString pattern = QLatin1String("*.") + extension;
+            foreach (const QString &mime, it.value())
+                result.addMatch(mime, 50, pattern);
         }
 
         // Finally, try the low weight matches (<=50)
-        m_lowWeightGlobs.match(result, fileName);
+        m_lowWeightGlobs.match(result, fileName, lowerCaseFileName);
     }
     if (foundSuffix)
         *foundSuffix = result.m_foundSuffix;
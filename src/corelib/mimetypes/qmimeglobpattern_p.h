@@ -44,6 +44,7 @@
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qregexp.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,10 +75,16 @@ public:
         if (s == Qt::CaseInsensitive) {
             m_pattern = m_pattern.toLower();
         }
+        m_patternType = detectPatternType(m_pattern);
+        if (m_patternType == OtherPattern)
+            m_regExp = QRegExp(m_pattern, Qt::CaseSensitive, QRegExp::WildcardUnix);
     }
     ~QMimeGlobPattern() {}
 
     bool matchFileName(const QString &filename) const;
+    // lowerCaseFileName is used by case insensitive patterns, so that
+    // callers matching many patterns only need to convert it once
+    bool matchFileName(const QString &fileName, const QString &lowerCaseFileName) const;
 
     inline const QString &pattern() const { return m_pattern; }
     inline unsigned weight() const { return m_weight; }
@@ -85,10 +92,20 @@ public:
     inline bool isCaseSensitive() const { return m_caseSensitivity == Qt::CaseSensitive; }
 
 private:
+    enum PatternType {
+        SuffixPattern,  // "*~", "*.extension"
+        PrefixPattern,  // "README*"
+        LiteralPattern, // "README"
+        OtherPattern    // "*.anim[1-9j]", matched using m_regExp
+    };
+    static PatternType detectPatternType(const QString &pattern);
+
     QString m_pattern;
     QString m_mimeType;
     int m_weight;
     Qt::CaseSensitivity m_caseSensitivity;
+    PatternType m_patternType;
+    QRegExp m_regExp;
 };
 
 class QMimeGlobPatternList : public QList<QMimeGlobPattern>
@@ -116,13 +133,13 @@ public:
         }
     }
 
-    void match(QMimeGlobMatchResult &result, const QString &fileName) const;
+    void match(QMimeGlobMatchResult &result, const QString &fileName, const QString &lowerCaseFileName) const;
 };
 
 /*!
     Result of the globs parsing, as data structures ready for efficient MIME type matching.
     This contains:
-    1) a map of fast regular patterns (e.g. *.txt is stored as "txt" in a qhash's key)
+    1) a map of fast regular patterns (e.g. *.txt is stored as "txt" and *.tar.gz as "tar.gz" in a qhash's key)
     2) a linear list of high-weight globs
     3) a linear list of low-weight globs
  */
@@ -305,6 +305,7 @@ QMimeMagicRule::QMimeMagicRule(QMimeMagicRule::Type theType,
 }
 
 QMimeMagicRule::QMimeMagicRule(const QMimeMagicRule &other) :
+    m_subMatches(other.m_subMatches),
     d(new QMimeMagicRulePrivate(*other.d))
 {
 }
@@ -315,6 +316,7 @@ QMimeMagicRule::~QMimeMagicRule()
 
 QMimeMagicRule &QMimeMagicRule::operator=(const QMimeMagicRule &other)
 {
+    m_subMatches = other.m_subMatches;
     *d = *other.d;
     return *this;
 }
@@ -360,6 +362,21 @@ bool QMimeMagicRule::isValid() const
     return d->matchFunction;
 }
 
+// Returns the bytes a String rule looks for, if it compares them without a
+// mask; otherwise returns an empty array. Sub-rules are not taken into account.
+QByteArray QMimeMagicRule::unmaskedPattern() const
+{
+    if (d->type != String || !d->matchFunction)
+        return QByteArray();
+    const char *m = d->mask.constData();
+    const char *e = m + d->mask.size();
+    for ( ; m < e; ++m) {
+        if (*m != char(-1))
+            return QByteArray();
+    }
+    return d->pattern;
+}
+
 bool QMimeMagicRule::matches(const QByteArray &data) const
 {
     const bool ok = d->matchFunction && d->matchFunction(d.data(), data);
@@ -71,6 +71,7 @@ public:
     bool isValid() const;
 
     bool matches(const QByteArray &data) const;
+    QByteArray unmaskedPattern() const;
 
     QList<QMimeMagicRule> m_subMatches;
 
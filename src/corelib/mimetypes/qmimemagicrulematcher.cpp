@@ -45,6 +45,11 @@
 
 #include "qmimetype_p.h"
 
+#include <QtCore/qmap.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -105,4 +110,169 @@ unsigned QMimeMagicRuleMatcher::priority() const
     return m_priority;
 }
 
+QMimeAllMagicMatchers::QMimeAllMagicMatchers()
+    : m_compiled(false)
+{
+}
+
+void QMimeAllMagicMatchers::addMatcher(const QMimeMagicRuleMatcher &matcher)
+{
+    m_matchers.append(matcher);
+    m_compiled = false;
+}
+
+void QMimeAllMagicMatchers::clear()
+{
+    m_matchers.clear();
+    m_compiled = false;
+}
+
+namespace {
+struct HigherPriority
+{
+    explicit HigherPriority(const QList<QMimeMagicRuleMatcher> &matchers) : m_matchers(matchers) {}
+    bool operator()(int lhs, int rhs) const
+    { return m_matchers.at(lhs).priority() > m_matchers.at(rhs).priority(); }
+    const QList<QMimeMagicRuleMatcher> &m_matchers;
+};
+}
+
+void QMimeAllMagicMatchers::compile()
+{
+    m_rules.clear();
+    m_firstRule.clear();
+    m_inTrie.clear();
+    m_anchors.clear();
+    m_nodes.clear();
+    m_edgeBytes.clear();
+    m_edgeTargets.clear();
+    m_nodeRules.clear();
+
+    // build the tries...
+    QVector<QMap<uchar, int> > children;
+    QVector<QVector<int> > rulesEndingAt;
+    QMap<int, int> rootForOffset;
+    for (int i = 0; i < m_matchers.size(); ++i) {
+        m_firstRule.append(m_rules.size());
+        foreach (const QMimeMagicRule &rule, m_matchers.at(i).magicRules()) {
+            const int ruleIndex = m_rules.size();
+            m_rules.append(rule);
+            const QByteArray pattern = rule.startPos() == rule.endPos()
+                    ? rule.unmaskedPattern() : QByteArray();
+            m_inTrie.append(!pattern.isEmpty());
+            if (pattern.isEmpty())
+                continue;
+
+            int node = rootForOffset.value(rule.startPos(), -1);
+            if (node == -1) {
+                node = children.size();
+                children.append(QMap<uchar, int>());
+                rulesEndingAt.append(QVector<int>());
+                rootForOffset.insert(rule.startPos(), node);
+            }
+            for (int j = 0; j < pattern.size(); ++j) {
+                const uchar c = pattern.at(j);
+                int child = children.at(node).value(c, -1);
+                if (child == -1) {
+                    child = children.size();
+                    children[node].insert(c, child);
+                    children.append(QMap<uchar, int>());
+                    rulesEndingAt.append(QVector<int>());
+                }
+                node = child;
+            }
+            rulesEndingAt[node].append(ruleIndex);
+        }
+    }
+    m_firstRule.append(m_rules.size());
+
+    // ...and store them in flat arrays
+    m_nodes.resize(children.size());
+    for (int i = 0; i < children.size(); ++i) {
+        Node &node = m_nodes[i];
+        node.firstEdge = m_edgeBytes.size();
+        node.edgeCount = children.at(i).size();
+        for (QMap<uchar, int>::const_iterator it = children.at(i).constBegin(); it != children.at(i).constEnd(); ++it) {
+            m_edgeBytes.append(it.key());
+            m_edgeTargets.append(it.value());
+        }
+        node.firstRule = m_nodeRules.size();
+        node.ruleCount = rulesEndingAt.at(i).size();
+        m_nodeRules += rulesEndingAt.at(i);
+    }
+    for (QMap<int, int>::const_iterator it = rootForOffset.constBegin(); it != rootForOffset.constEnd(); ++it) {
+        const Anchor anchor = { it.key(), it.value() };
+        m_anchors.append(anchor);
+    }
+
+    m_order.resize(m_matchers.size());
+    for (int i = 0; i < m_order.size(); ++i)
+        m_order[i] = i;
+    std::stable_sort(m_order.begin(), m_order.end(), HigherPriority(m_matchers));
+
+    m_compiled = true;
+}
+
+int QMimeAllMagicMatchers::findChild(int node, uchar c) const
+{
+    const Node &n = m_nodes.at(node);
+    const uchar *begin = m_edgeBytes.constData() + n.firstEdge;
+    const uchar *end = begin + n.edgeCount;
+    const uchar *it = std::lower_bound(begin, end, c);
+    if (it == end || *it != c)
+        return -1;
+    return m_edgeTargets.at(n.firstEdge + (it - begin));
+}
+
+static bool subRulesMatch(const QMimeMagicRule &rule, const QByteArray &data)
+{
+    if (rule.m_subMatches.isEmpty())
+        return true;
+    foreach (const QMimeMagicRule &subRule, rule.m_subMatches) {
+        if (subRule.matches(data))
+            return true;
+    }
+    return false;
+}
+
+QString QMimeAllMagicMatchers::match(const QByteArray &data, int *accuracyPtr)
+{
+    if (!m_compiled)
+        compile();
+
+    // find all the rules in the tries that match, in a single pass per offset
+    QVarLengthArray<bool, 1024> hits(m_rules.size());
+    memset(hits.data(), 0, hits.size() * sizeof(bool));
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    const int size = data.size();
+    foreach (const Anchor &anchor, m_anchors) {
+        int node = anchor.root;
+        for (int pos = anchor.offset; pos < size; ++pos) {
+            node = findChild(node, bytes[pos]);
+            if (node == -1)
+                break;
+            const Node &n = m_nodes.at(node);
+            for (int i = n.firstRule; i < n.firstRule + n.ruleCount; ++i)
+                hits[m_nodeRules.at(i)] = true;
+            if (!n.edgeCount)
+                break;
+        }
+    }
+
+    foreach (int i, m_order) {
+        const QMimeMagicRuleMatcher &matcher = m_matchers.at(i);
+        const int priority = matcher.priority();
+        if (priority <= *accuracyPtr)
+            break; // the remaining matchers can't do better
+        for (int r = m_firstRule.at(i); r < m_firstRule.at(i + 1); ++r) {
+            const QMimeMagicRule &rule = m_rules.at(r);
+            if (m_inTrie.at(r) ? (hits[r] && subRulesMatch(rule, data)) : rule.matches(data)) {
+                *accuracyPtr = priority;
+                return matcher.mimetype();
+            }
+        }
+    }
+    return QString();
+}
+
 QT_END_NAMESPACE
@@ -45,6 +45,7 @@
 #include <QtCore/qbytearray.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
 
 #include "qmimemagicrule_p.h"
 
@@ -73,6 +74,58 @@ private:
     QString m_mimetype;
 };
 
+/*
+   All the magic matchers of a provider, compiled for matching them together.
+   The top-level string rules that compare bytes at a fixed offset, which is
+   most of them, are merged into one trie per offset. The data is walked once
+   per offset instead of once per rule, and the remaining rules are checked
+   individually. Matchers are tried by decreasing priority, so matching stops
+   at the first one that matches.
+ */
+class QMimeAllMagicMatchers
+{
+public:
+    QMimeAllMagicMatchers();
+
+    void addMatcher(const QMimeMagicRuleMatcher &matcher);
+    void clear();
+
+    // Returns the MIME type of the first matcher with the highest priority
+    // that matches \a data, if that priority is higher than *accuracyPtr.
+    QString match(const QByteArray &data, int *accuracyPtr);
+
+private:
+    void compile();
+    int findChild(int node, uchar c) const;
+
+    struct Node {
+        int firstEdge;
+        int edgeCount;
+        int firstRule;  // index into m_nodeRules of the rules ending at this node
+        int ruleCount;
+    };
+    struct Anchor {
+        int offset;
+        int root;
+    };
+
+    QList<QMimeMagicRuleMatcher> m_matchers;
+    bool m_compiled;
+
+    // indexes into m_matchers, highest priority first
+    QVector<int> m_order;
+    // the top-level rules of matcher i are m_rules[m_firstRule[i]] .. m_rules[m_firstRule[i + 1] - 1]
+    QList<QMimeMagicRule> m_rules;
+    QVector<int> m_firstRule;
+    QVector<bool> m_inTrie;
+
+    QVector<Anchor> m_anchors;
+    QVector<Node> m_nodes;
+    QVector<uchar> m_edgeBytes; // sorted for each node
+    QVector<int> m_edgeTargets;
+    QVector<int> m_nodeRules;
+};
+
 QT_END_NAMESPACE
 
 #endif // QMIMEMAGICRULEMATCHER_P_H
@@ -730,17 +730,7 @@ QMimeType QMimeXMLProvider::findByMagic(const QByteArray &data, int *accuracyPtr
 {
     ensureLoaded();
 
-    QString candidate;
-
-    foreach (const QMimeMagicRuleMatcher &matcher, m_magicMatchers) {
-        if (matcher.matches(data)) {
-            const int priority = matcher.priority();
-            if (priority > *accuracyPtr) {
-                *accuracyPtr = priority;
-                candidate = matcher.mimetype();
-            }
-        }
-    }
+    const QString candidate = m_magicMatchers.match(data, accuracyPtr);
     return mimeTypeForName(candidate);
 }
 
@@ -864,7 +854,7 @@ QList<QMimeType> QMimeXMLProvider::allMimeTypes()
 
 void QMimeXMLProvider::addMagicMatcher(const QMimeMagicRuleMatcher &matcher)
 {
-    m_magicMatchers.append(matcher);
+    m_magicMatchers.addMatcher(matcher);
 }
 
 QT_END_NAMESPACE
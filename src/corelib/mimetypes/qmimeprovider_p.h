@@ -44,12 +44,11 @@
 
 #include <QtCore/qdatetime.h>
 #include "qmimedatabase_p.h"
+#include "qmimemagicrulematcher_p.h"
 #include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
-class QMimeMagicRuleMatcher;
-
 class QMimeProviderBase
 {
 public:
@@ -159,7 +158,7 @@ private:
     ParentsHash m_parents;
     QMimeAllGlobPatterns m_mimeTypeGlobs;
 
-    QList<QMimeMagicRuleMatcher> m_magicMatchers;
+    QMimeAllMagicMatchers m_magicMatchers;
     QStringList m_allFiles;
 };
 
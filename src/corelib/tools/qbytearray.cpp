@@ -46,6 +46,7 @@
 #include "qlist.h"
 #include "qlocale.h"
 #include "qlocale_p.h"
+#include "qlocale_tools_p.h"
 #include "qscopedpointer.h"
 #include <qdatastream.h>
 
@@ -2747,13 +2748,29 @@ QDataStream &operator<<(QDataStream &out, const QByteArray &ba)
 
 QDataStream &operator>>(QDataStream &in, QByteArray &ba)
 {
-    ba.clear();
     quint32 len;
     in >> len;
-    if (len == 0xffffffff)
+    if (len == 0xffffffff) {
+        ba.clear();
         return in;
+    }
 
+    // When the device already holds all of the data, read it in one go
+    // into the existing array, which keeps its memory if it is large
+    // enough. Otherwise grow in steps, so that a corrupt length does not
+    // allocate gigabytes before the read fails.
     const quint32 Step = 1024 * 1024;
+    QIODevice *device = in.device();
+    if (len <= Step || (device && quint64(device->bytesAvailable()) >= len)) {
+        ba.resize(int(len));
+        if (in.readRawData(ba.data(), int(len)) != int(len)) {
+            ba.clear();
+            in.setStatus(QDataStream::ReadPastEnd);
+        }
+        return in;
+    }
+
+    ba.clear();
     quint32 allocated = 0;
 
     do {
@@ -3511,7 +3528,7 @@ ushort QByteArray::toUShort(bool *ok, int base) const
 
 double QByteArray::toDouble(bool *ok) const
 {
-    return QLocalePrivate::bytearrayToDouble(nulTerminated().constData(), ok);
+    return qt_asciiToDouble(constData(), size(), ok);
 }
 
 /*!
@@ -3731,8 +3748,7 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
             break;
     }
 
-    QLocale locale(QLocale::C);
-    *this = locale.d->doubleToString(n, prec, form, -1, flags).toLatin1();
+    *this = QLocalePrivate::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
     return *this;
 }
 
@@ -3826,7 +3842,9 @@ QByteArray QByteArray::number(qulonglong n, int base)
 
     With 'e', 'E', and 'f', \a prec is the number of digits after the
     decimal point. With 'g' and 'G', \a prec is the maximum number of
-    significant digits (trailing zeroes are omitted).
+    significant digits (trailing zeroes are omitted). If \a prec is
+    QLocale::FloatingPointShortest, the shortest representation that
+    converts back to \a n is used.
 
     \snippet code/src_corelib_tools_qbytearray.cpp 42
 
@@ -182,6 +182,9 @@ class QFreeList
         return (n & ConstantsType::IndexMask) | ((o + ConstantsType::SerialCounter) & ConstantsType::SerialMask);
     }
 
+    // return the element for the index \a x, allocating its block if necessary
+    inline ElementType *element(int x);
+
     // the blocks
     QAtomicPointer<ElementType> _v[ConstantsType::BlockCount];
     // the next free id
@@ -204,6 +207,13 @@ public:
     */
     inline int next();
     inline void release(int id);
+
+    /*
+        Bulk versions of the above: take \a count ids at once, or release
+        \a count ids at once, with a single atomic operation on the list head.
+    */
+    inline void next(int *ids, int count);
+    inline void release(const int *ids, int count);
 };
 
 template <typename T, typename ConstantsType>
@@ -232,29 +242,32 @@ inline typename QFreeList<T, ConstantsType>::ReferenceType QFreeList<T, Constant
     return (_v[block].load())[x].t();
 }
 
+template <typename T, typename ConstantsType>
+inline typename QFreeList<T, ConstantsType>::ElementType *QFreeList<T, ConstantsType>::element(int x)
+{
+    int at = x;
+    const int block = blockfor(at);
+    ElementType *v = _v[block].loadAcquire();
+
+    if (!v) {
+        v = allocate(x - at, ConstantsType::Sizes[block]);
+        if (!_v[block].testAndSetRelease(0, v)) {
+            // race with another thread lost
+            delete [] v;
+            v = _v[block].loadAcquire();
+            Q_ASSERT(v != 0);
+        }
+    }
+    return v + at;
+}
+
 template <typename T, typename ConstantsType>
 inline int QFreeList<T, ConstantsType>::next()
 {
-    int id, newid, at;
-    ElementType *v;
+    int id, newid;
     do {
         id = _next.load();
-
-        at = id & ConstantsType::IndexMask;
-        const int block = blockfor(at);
-        v = _v[block].loadAcquire();
-
-        if (!v) {
-            v = allocate((id & ConstantsType::IndexMask) - at, ConstantsType::Sizes[block]);
-            if (!_v[block].testAndSetRelease(0, v)) {
-                // race with another thread lost
-                delete [] v;
-                v = _v[block].loadAcquire();
-                Q_ASSERT(v != 0);
-            }
-        }
-
-        newid = v[at].next | (id & ~ConstantsType::IndexMask);
+        newid = element(id & ConstantsType::IndexMask)->next | (id & ~ConstantsType::IndexMask);
     } while (!_next.testAndSetRelaxed(id, newid));
     // qDebug("QFreeList::next(): returning %d (_next now %d, serial %d)",
     //        id & ConstantsType::IndexMask,
@@ -284,6 +297,49 @@ inline void QFreeList<T, ConstantsType>::release(int id)
     //        (newid & ~ConstantsType::IndexMask) >> 24);
 }
 
+template <typename T, typename ConstantsType>
+inline void QFreeList<T, ConstantsType>::next(int *ids, int count)
+{
+    Q_ASSERT(count > 0);
+    int id, newid;
+    do {
+        // walk the list; if another thread changes it meanwhile, the
+        // head changes too and we start over
+        id = _next.load();
+        int x = id & ConstantsType::IndexMask;
+        for (int i = 0; i < count; ++i) {
+            ids[i] = x;
+            x = element(x)->next;
+        }
+        newid = x | (id & ~ConstantsType::IndexMask);
+    } while (!_next.testAndSetRelaxed(id, newid));
+}
+
+template <typename T, typename ConstantsType>
+inline void QFreeList<T, ConstantsType>::release(const int *ids, int count)
+{
+    Q_ASSERT(count > 0);
+
+    // chain the ids together, then splice the chain in front of the list
+    for (int i = 0; i < count - 1; ++i) {
+        int at = ids[i] & ConstantsType::IndexMask;
+        const int block = blockfor(at);
+        _v[block].load()[at].next = ids[i + 1] & ConstantsType::IndexMask;
+    }
+
+    int at = ids[count - 1] & ConstantsType::IndexMask;
+    const int block = blockfor(at);
+    ElementType *v = _v[block].load();
+
+    int x, newid;
+    do {
+        x = _next.loadAcquire();
+        v[at].next = x & ConstantsType::IndexMask;
+
+        newid = incrementserial(x, ids[0]);
+    } while (!_next.testAndSetRelease(x, newid));
+}
+
 QT_END_NAMESPACE
 
 #endif // QFREELIST_P_H
@@ -0,0 +1,441 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfreelistpool.h"
+
+#include <QtCore/qthread.h>
+#include <private/qfreelist_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// blocks grow by a factor of four, so that a pool that only ever holds a
+// few objects stays small
+struct FreeListPoolConstants : public QFreeListDefaultConstants
+{
+    enum {
+        BlockCount = 10
+    };
+    static const int Sizes[BlockCount];
+    static const int Offsets[BlockCount];
+};
+
+const int FreeListPoolConstants::Sizes[FreeListPoolConstants::BlockCount] = {
+    0x40,
+    0x100 - 0x40,
+    0x400 - 0x100,
+    0x1000 - 0x400,
+    0x4000 - 0x1000,
+    0x10000 - 0x4000,
+    0x40000 - 0x10000,
+    0x100000 - 0x40000,
+    0x400000 - 0x100000,
+    FreeListPoolConstants::MaxIndex - 0x400000
+};
+
+const int FreeListPoolConstants::Offsets[FreeListPoolConstants::BlockCount] = {
+    0, 0x40, 0x100, 0x400, 0x1000, 0x4000, 0x10000, 0x40000, 0x100000, 0x400000
+};
+
+// returns the block holding the given id; block n > 0 starts at 0x40 << 2(n - 1)
+static inline int blockFor(int id)
+{
+    if (id < 0x40)
+        return 0;
+#if defined(Q_CC_GNU)
+    return (31 - __builtin_clz(id) - 4) / 2;
+#else
+    int block = 0;
+    for (int x = id >> 6; x; x >>= 2)
+        ++block;
+    return block;
+#endif
+}
+
+enum {
+    MagazineSize = 64,
+    StripeCount = 16,
+    CacheLineSize = 64
+};
+
+// a small stack of free slots, used by one thread at a time
+struct Magazine
+{
+    int count;
+    void *free[MagazineSize];
+};
+
+// the threads are spread over the stripes by their id; a thread takes the
+// magazine of its stripe out while using it, and falls back to the shared
+// free list if another thread on the same stripe has it
+struct Stripe
+{
+    QAtomicPointer<Magazine> magazine;
+    char padding[CacheLineSize - sizeof(QAtomicPointer<Magazine>)];
+};
+}
+
+class QFreeListPoolPrivate
+{
+public:
+    QFreeListPoolPrivate(size_t objectSize, size_t alignment);
+    ~QFreeListPoolPrivate();
+
+    char *storage(int id);
+    int idOf(const void *ptr) const;
+    void refill(Magazine *m);
+    void flush(Magazine *m);
+    Stripe &currentStripe();
+
+    QFreeList<void, FreeListPoolConstants> freeList;
+    QAtomicPointer<char> blocks[FreeListPoolConstants::BlockCount];
+    const size_t objectSize;
+    const size_t alignment;
+    const size_t stride;
+    Stripe stripes[StripeCount];
+};
+
+QFreeListPoolPrivate::QFreeListPoolPrivate(size_t size, size_t align)
+    : objectSize(size), alignment(qMax<size_t>(align, sizeof(void *))),
+      stride((qMax<size_t>(size, 1) + alignment - 1) & ~(alignment - 1))
+{
+    Q_ASSERT_X((alignment & (alignment - 1)) == 0, "QFreeListPool", "alignment must be a power of two");
+    for (int i = 0; i < StripeCount; ++i) {
+        Magazine *m = new Magazine;
+        m->count = 0;
+        stripes[i].magazine.store(m);
+    }
+}
+
+QFreeListPoolPrivate::~QFreeListPoolPrivate()
+{
+    for (int i = 0; i < StripeCount; ++i)
+        delete stripes[i].magazine.load();
+    for (int i = 0; i < FreeListPoolConstants::BlockCount; ++i)
+        qFreeAligned(blocks[i].load());
+}
+
+// returns the storage for the object with the given id, allocating the block
+// it is in if necessary
+char *QFreeListPoolPrivate::storage(int id)
+{
+    const int block = blockFor(id);
+
+    char *v = blocks[block].loadAcquire();
+    if (!v) {
+        v = static_cast<char *>(qMallocAligned(FreeListPoolConstants::Sizes[block] * stride, alignment));
+        Q_CHECK_PTR(v);
+        if (!blocks[block].testAndSetRelease(0, v)) {
+            // race with another thread lost
+            qFreeAligned(v);
+            v = blocks[block].loadAcquire();
+        }
+    }
+    return v + (id - FreeListPoolConstants::Offsets[block]) * stride;
+}
+
+// returns the id of the object at \a ptr, or -1 if it wasn't allocated from
+// this pool
+int QFreeListPoolPrivate::idOf(const void *ptr) const
+{
+    const char *p = static_cast<const char *>(ptr);
+    // most objects live in the largest blocks, so start there; blocks may
+    // be allocated out of order when threads race
+    for (int block = FreeListPoolConstants::BlockCount - 1; block >= 0; --block) {
+        const char *v = blocks[block].load();
+        if (v && p >= v && p < v + FreeListPoolConstants::Sizes[block] * stride) {
+            Q_ASSERT((p - v) % stride == 0);
+            return FreeListPoolConstants::Offsets[block] + int((p - v) / stride);
+        }
+    }
+    return -1;
+}
+
+// takes half a magazine's worth of slots from the free list
+void QFreeListPoolPrivate::refill(Magazine *m)
+{
+    int ids[MagazineSize / 2];
+    freeList.next(ids, MagazineSize / 2);
+    for (int i = 0; i < MagazineSize / 2; ++i)
+        m->free[i] = storage(ids[i]);
+    m->count = MagazineSize / 2;
+}
+
+// gives the older half of a full magazine back to the free list, keeping
+// the recently used slots
+void QFreeListPoolPrivate::flush(Magazine *m)
+{
+    int ids[MagazineSize / 2];
+    for (int i = 0; i < MagazineSize / 2; ++i)
+        ids[i] = idOf(m->free[i]);
+    freeList.release(ids, MagazineSize / 2);
+    memmove(m->free, m->free + MagazineSize / 2, MagazineSize / 2 * sizeof(void *));
+    m->count = MagazineSize / 2;
+}
+
+Stripe &QFreeListPoolPrivate::currentStripe()
+{
+#ifndef QT_NO_THREAD
+    // thread ids are usually pointers or small integers; mix the bits so
+    // that neighbouring ids land on different stripes
+    quintptr t = quintptr(QThread::currentThreadId());
+    uint h = uint(t ^ (t >> 16) ^ (quint64(t) >> 32)) * 0x9e3779b1U;
+    return stripes[h >> 28];
+#else
+    return stripes[0];
+#endif
+}
+
+/*!
+    \class QFreeListPool
+    \inmodule QtCore
+    \since 5.2
+
+    \brief The QFreeListPool class is a lock-free pool of storage for objects
+    of type T.
+
+    \threadsafe
+    \ingroup tools
+
+    Programs that allocate and free many objects of the same type, such as
+    events, network buffers or QRunnable jobs, often spend a noticeable
+    amount of time in the memory allocator, especially when the objects
+    are created in one thread and deleted in another. QFreeListPool keeps
+    the storage of freed objects and hands it out again, without taking
+    any lock.
+
+    Each thread first uses a small cache of free slots of its own, so that
+    threads allocating and freeing concurrently rarely touch the same
+    memory. When a thread's cache runs empty or full, it exchanges half of
+    it with the pool's shared free list in a single atomic operation.
+
+    create() returns a default-constructed object and destroy() destroys it
+    and returns its storage to the pool. For other constructors, construct
+    the object in the storage returned by allocate(), and give the storage
+    back with deallocate() after destroying it. A common pattern is a
+    class-specific \c{operator new} and \c{operator delete}:
+
+    \snippet code/src_corelib_tools_qfreelistpool.cpp 0
+
+    Objects that are freed in batches can be returned all at once with the
+    overloads of destroy() and deallocate() that take an array, which is
+    cheaper than returning them one by one.
+
+    The pool never gives memory back to the system while it exists. When
+    the pool is destroyed, all of its storage is freed; the objects that
+    were still allocated must not be used afterwards, and their
+    destructors are not called. A pool that serves objects which may
+    outlive static destruction, such as events that are still posted when
+    the application exits, should therefore be created with \c new and
+    never be deleted, as in the example above. A pool can hold up to
+    16777215 objects.
+*/
+
+/*!
+    \fn QFreeListPool::QFreeListPool()
+
+    Constructs an empty pool. No memory is allocated until the first
+    object is.
+*/
+
+/*!
+    \fn T *QFreeListPool::allocate()
+
+    Returns uninitialized storage for one object of type T. Use placement
+    \c new to construct the object, and deallocate() to return the storage
+    to the pool.
+
+    \sa create(), deallocate()
+*/
+
+/*!
+    \fn void QFreeListPool::deallocate(T *ptr)
+
+    Returns the storage at \a ptr, which must have been obtained from
+    allocate() on this pool, to the pool. The object must have been
+    destroyed already.
+
+    \sa allocate(), destroy()
+*/
+
+/*!
+    \fn void QFreeListPool::deallocate(T * const *ptrs, int count)
+
+    Returns the storage of the \a count objects in the array \a ptrs to the
+    pool at once. Null pointers in the array are ignored.
+*/
+
+/*!
+    \fn bool QFreeListPool::owns(const T *ptr) const
+
+    Returns true if \a ptr points to storage that belongs to this pool.
+*/
+
+/*!
+    \fn T *QFreeListPool::create()
+
+    Allocates and default-constructs an object.
+
+    \sa destroy()
+*/
+
+/*!
+    \fn void QFreeListPool::destroy(T *ptr)
+
+    Destroys the object at \a ptr, which must have been allocated from this
+    pool, and returns its storage to the pool. Does nothing if \a ptr is
+    null.
+
+    \sa create()
+*/
+
+/*!
+    \fn void QFreeListPool::destroy(T * const *ptrs, int count)
+
+    Destroys the \a count objects in the array \a ptrs and returns their
+    storage to the pool at once. None of the pointers may be null.
+*/
+
+/*!
+    \class QFreeListPoolBase
+    \inmodule QtCore
+    \internal
+
+    The untyped implementation of QFreeListPool. It hands out storage of \a
+    objectSize bytes with the given alignment.
+*/
+
+/*!
+    \internal
+*/
+QFreeListPoolBase::QFreeListPoolBase(size_t objectSize, size_t alignment)
+    : d(new QFreeListPoolPrivate(objectSize, alignment))
+{
+}
+
+/*!
+    \internal
+*/
+QFreeListPoolBase::~QFreeListPoolBase()
+{
+    delete d;
+}
+
+/*!
+    \internal
+*/
+void *QFreeListPoolBase::allocate()
+{
+    Stripe &stripe = d->currentStripe();
+    Magazine *m = stripe.magazine.fetchAndStoreAcquire(0);
+    if (!m)
+        return d->storage(d->freeList.next());
+
+    if (m->count == 0)
+        d->refill(m);
+    void *ptr = m->free[--m->count];
+    stripe.magazine.storeRelease(m);
+    return ptr;
+}
+
+/*!
+    \internal
+*/
+void QFreeListPoolBase::deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Q_ASSERT_X(d->idOf(ptr) != -1, "QFreeListPool::deallocate", "pointer was not allocated from this pool");
+
+    Stripe &stripe = d->currentStripe();
+    Magazine *m = stripe.magazine.fetchAndStoreAcquire(0);
+    if (!m) {
+        d->freeList.release(d->idOf(ptr));
+        return;
+    }
+
+    if (m->count == MagazineSize)
+        d->flush(m);
+    m->free[m->count++] = ptr;
+    stripe.magazine.storeRelease(m);
+}
+
+/*!
+    \internal
+*/
+void QFreeListPoolBase::deallocate(void * const *ptrs, int count)
+{
+    int ids[MagazineSize];
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!ptrs[i])
+            continue;
+        ids[n] = d->idOf(ptrs[i]);
+        Q_ASSERT_X(ids[n] != -1, "QFreeListPool::deallocate", "pointer was not allocated from this pool");
+        if (++n == MagazineSize) {
+            d->freeList.release(ids, n);
+            n = 0;
+        }
+    }
+    if (n)
+        d->freeList.release(ids, n);
+}
+
+/*!
+    \internal
+*/
+bool QFreeListPoolBase::owns(const void *ptr) const
+{
+    return d->idOf(ptr) != -1;
+}
+
+/*!
+    \internal
+*/
+size_t QFreeListPoolBase::objectSize() const
+{
+    return d->objectSize;
+}
+
+QT_END_NAMESPACE
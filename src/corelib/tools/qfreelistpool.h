@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFREELISTPOOL_H
+#define QFREELISTPOOL_H
+
+#include <QtCore/qglobal.h>
+
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+class QFreeListPoolPrivate;
+
+class Q_CORE_EXPORT QFreeListPoolBase
+{
+public:
+    explicit QFreeListPoolBase(size_t objectSize, size_t alignment);
+    ~QFreeListPoolBase();
+
+    void *allocate();
+    void deallocate(void *ptr);
+    void deallocate(void * const *ptrs, int count);
+    bool owns(const void *ptr) const;
+
+    size_t objectSize() const;
+
+private:
+    Q_DISABLE_COPY(QFreeListPoolBase)
+    QFreeListPoolPrivate *d;
+};
+
+template <typename T>
+class QFreeListPool : private QFreeListPoolBase
+{
+public:
+    inline QFreeListPool() : QFreeListPoolBase(sizeof(T), Q_ALIGNOF(T)) { }
+
+    inline T *allocate() { return static_cast<T *>(QFreeListPoolBase::allocate()); }
+    inline void deallocate(T *ptr) { QFreeListPoolBase::deallocate(ptr); }
+    inline void deallocate(T * const *ptrs, int count)
+    { QFreeListPoolBase::deallocate(reinterpret_cast<void * const *>(ptrs), count); }
+    inline bool owns(const T *ptr) const { return QFreeListPoolBase::owns(ptr); }
+
+    inline T *create() { return ::new (allocate()) T(); }
+    inline void destroy(T *ptr)
+    {
+        if (ptr) {
+            ptr->~T();
+            deallocate(ptr);
+        }
+    }
+    void destroy(T * const *ptrs, int count);
+
+private:
+    Q_DISABLE_COPY(QFreeListPool)
+};
+
+template <typename T>
+void QFreeListPool<T>::destroy(T * const *ptrs, int count)
+{
+    for (int i = 0; i < count; ++i)
+        ptrs[i]->~T();
+    deallocate(ptrs, count);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFREELISTPOOL_H
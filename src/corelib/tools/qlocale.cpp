@@ -60,8 +60,12 @@
 #include "qstringlist.h"
 #include "qvariant.h"
 #include "qstringbuilder.h"
+#include "qvarlengtharray.h"
 #include "private/qnumeric_p.h"
 #include "private/qsystemlibrary_p.h"
+
+#include <math.h>
+
 #ifdef Q_OS_WIN
 #   include <qt_windows.h>
 #   include <time.h>
@@ -713,6 +717,28 @@ static quint16 localeDataIndex(const QLocaleData *p)
     return index;
 }
 
+// The C locale is never destroyed: QString::number() and friends may be
+// called from global destructors, after a Q_GLOBAL_STATIC is gone.
+static QBasicAtomicPointer<const QLocalePrivate> c_private = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// Shared by the locale independent conversions in QString and QByteArray,
+// which would otherwise create a QLocalePrivate for every call.
+const QLocalePrivate *QLocalePrivate::c()
+{
+    const QLocalePrivate *c = c_private.loadAcquire();
+    if (!c) {
+        // locale_data[0] is the C locale
+        QLocalePrivate *x = new QLocalePrivate(0);
+        if (c_private.testAndSetOrdered(0, x)) {
+            c = x;
+        } else {
+            delete x;
+            c = c_private.loadAcquire();
+        }
+    }
+    return c;
+}
+
 /*!
  \internal
 */
@@ -2818,6 +2844,7 @@ QString QLocalePrivate::doubleToString(const QChar _zero, const QChar plus, cons
         QString digits;
 
 #ifdef QT_QLOCALE_USES_FCVT
+        const int cutoff = precision;
         // NOT thread safe!
         if (form == DFDecimal) {
             digits = QLatin1String(fcvt(d, precision, &decpt, &sign));
@@ -2841,33 +2868,33 @@ QString QLocalePrivate::doubleToString(const QChar _zero, const QChar plus, cons
         }
 
 #else
-        int mode;
-        if (form == DFDecimal)
-            mode = 3;
+        // room for all the digits qdtoa() may produce
+        int bufSize;
+        if (precision == QLocale::FloatingPointShortest)
+            bufSize = 17;
+        else if (form == DFDecimal)
+            bufSize = (qAbs(d) >= 1 ? int(log10(qAbs(d))) + 2 : 1) + precision;
         else
-            mode = 2;
-
-        /* This next bit is a bit quirky. In DFExponent form, the precision
-           is the number of digits after decpt. So that would suggest using
-           mode=3 for qdtoa. But qdtoa behaves strangely when mode=3 and
-           precision=0. So we get around this by using mode=2 and reasoning
-           that we want precision+1 significant digits, since the decimal
-           point in this mode is always after the first digit. */
-        int pr = precision;
-        if (form == DFExponent)
-            ++pr;
-
-        char *rve = 0;
-        char *buff = 0;
-        QT_TRY {
-            digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
-        } QT_CATCH(...) {
-            if (buff != 0)
-                free(buff);
-            QT_RETHROW;
+            bufSize = qMax(precision, 1) + 1;
+        QVarLengthArray<char, 64> buf(bufSize);
+        bool negativeSign;
+        int length;
+        qt_doubleToAscii(d, form, precision, buf.data(), bufSize, negativeSign, length, decpt);
+        sign = negativeSign;
+        digits = QString::fromLatin1(buf.constData(), length);
+
+        // the shortest form has exactly the digits produced; 'g' still
+        // switches to exponent form beyond the 17 digits of a double
+        int cutoff = precision;
+        if (precision == QLocale::FloatingPointShortest) {
+            cutoff = 17;
+            if (form == DFExponent)
+                precision = digits.length() - 1;
+            else if (form == DFDecimal)
+                precision = qMax(digits.length() - decpt, 0);
+            else
+                precision = digits.length();
         }
-        if (buff != 0)
-            free(buff);
 #endif // QT_QLOCALE_USES_FCVT
 
         if (_zero.unicode() != '0') {
@@ -2894,7 +2921,7 @@ QString QLocalePrivate::doubleToString(const QChar _zero, const QChar plus, cons
                 PrecisionMode mode = (flags & Alternate) ?
                             PMSignificantDigits : PMChopTrailingZeros;
 
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
+                if (decpt != digits.length() && (decpt <= -4 || decpt > cutoff))
                     num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
                                            digits, decpt, precision, mode,
                                            always_show_decpt);
@@ -3404,9 +3431,13 @@ double QLocalePrivate::bytearrayToDouble(const char *num, bool *ok, bool *overfl
     if (qstrcmp(num, "-inf") == 0)
         return -qt_inf();
 
+    double d;
+    if (qt_fastAsciiToDouble(num, qstrlen(num), &d))
+        return d;
+
     bool _ok;
     const char *endptr;
-    double d = qstrtod(num, &endptr, &_ok);
+    d = qstrtod(num, &endptr, &_ok);
 
     if (!_ok) {
         // the only way strtod can fail with *endptr != '\0' on a non-empty
@@ -805,6 +805,10 @@ public:
         CurrencyDisplayName
     };
 
+    enum FloatingPointPrecisionOption {
+        FloatingPointShortest = -128
+    };
+
     QLocale();
     QLocale(const QString &name);
     QLocale(Language language, Country country = AnyCountry);
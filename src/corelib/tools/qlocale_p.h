@@ -248,6 +248,7 @@ public:
     static void getLangAndCountry(const QString &name, QLocale::Language &lang,
                                   QLocale::Script &script, QLocale::Country &cntry);
     static const QLocaleData *dataPointerForIndex(quint16 index);
+    static const QLocalePrivate *c();
 
     QLocale::MeasurementSystem measurementSystem() const;
 
@@ -43,6 +43,8 @@
 #include "qlocale_p.h"
 #include "qstring.h"
 
+#include "qvarlengtharray.h"
+
 #include <ctype.h>
 #include <float.h>
 #include <limits.h>
@@ -119,6 +121,9 @@ QString &decimalForm(QChar zero, QChar decimal, QChar group,
                      bool always_show_decpt,
                      bool thousands_group)
 {
+    digits.reserve(qMax(decpt, 0) + qMax(-decpt, int(precision)) + digits.length() + 2
+                   + (thousands_group ? decpt / 3 : 0));
+
     if (decpt < 0) {
         for (int i = 0; i < -decpt; ++i)
             digits.prepend(zero);
@@ -163,6 +168,8 @@ QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
 {
     int exp = decpt - 1;
 
+    digits.reserve(qMax(uint(digits.length()), precision) + 7);
+
     if (pm == PMDecimalDigits) {
         for (uint i = digits.length(); i < precision + 1; ++i)
             digits.append(zero);
@@ -2935,4 +2942,616 @@ Q_CORE_EXPORT double qstrtod(const char *s00, const char **se, bool *ok)
 
 #endif // QT_QLOCALE_USES_FCVT
 
+/*
+    Fast conversions between doubles and their decimal representation.
+
+    Formatting uses Florian Loitsch's Grisu3 algorithm ("Printing
+    Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010),
+    which only needs 64-bit integer arithmetic. It produces the same digits
+    as qdtoa() for the shortest representation and for a given number of
+    significant digits, and detects the cases where it cannot guarantee
+    that, about 0.5% of all doubles; qt_doubleToAscii() then falls back to
+    qdtoa().
+
+    Parsing uses Clinger's fast path: when the significand fits in 53 bits
+    and the power of ten is exact, a single IEEE multiplication or division
+    is correctly rounded. Anything else is handed to qstrtod().
+*/
+
+namespace {
+struct QDiyFp
+{
+    quint64 f;
+    int e;
+};
+
+struct QCachedPowerOfTen
+{
+    quint64 significand;
+    short binaryExponent;
+    short decimalExponent;
+};
+}
+
+// 10^-348 to 10^340 in steps of 8, as normalized 64-bit significands
+static const QCachedPowerOfTen qt_cachedPowersOfTen[] = {
+    { Q_UINT64_C(0xfa8fd5a0081c0288), -1220, -348 },
+    { Q_UINT64_C(0xbaaee17fa23ebf76), -1193, -340 },
+    { Q_UINT64_C(0x8b16fb203055ac76), -1166, -332 },
+    { Q_UINT64_C(0xcf42894a5dce35ea), -1140, -324 },
+    { Q_UINT64_C(0x9a6bb0aa55653b2d), -1113, -316 },
+    { Q_UINT64_C(0xe61acf033d1a45df), -1087, -308 },
+    { Q_UINT64_C(0xab70fe17c79ac6ca), -1060, -300 },
+    { Q_UINT64_C(0xff77b1fcbebcdc4f), -1034, -292 },
+    { Q_UINT64_C(0xbe5691ef416bd60c), -1007, -284 },
+    { Q_UINT64_C(0x8dd01fad907ffc3c), -980, -276 },
+    { Q_UINT64_C(0xd3515c2831559a83), -954, -268 },
+    { Q_UINT64_C(0x9d71ac8fada6c9b5), -927, -260 },
+    { Q_UINT64_C(0xea9c227723ee8bcb), -901, -252 },
+    { Q_UINT64_C(0xaecc49914078536d), -874, -244 },
+    { Q_UINT64_C(0x823c12795db6ce57), -847, -236 },
+    { Q_UINT64_C(0xc21094364dfb5637), -821, -228 },
+    { Q_UINT64_C(0x9096ea6f3848984f), -794, -220 },
+    { Q_UINT64_C(0xd77485cb25823ac7), -768, -212 },
+    { Q_UINT64_C(0xa086cfcd97bf97f4), -741, -204 },
+    { Q_UINT64_C(0xef340a98172aace5), -715, -196 },
+    { Q_UINT64_C(0xb23867fb2a35b28e), -688, -188 },
+    { Q_UINT64_C(0x84c8d4dfd2c63f3b), -661, -180 },
+    { Q_UINT64_C(0xc5dd44271ad3cdba), -635, -172 },
+    { Q_UINT64_C(0x936b9fcebb25c996), -608, -164 },
+    { Q_UINT64_C(0xdbac6c247d62a584), -582, -156 },
+    { Q_UINT64_C(0xa3ab66580d5fdaf6), -555, -148 },
+    { Q_UINT64_C(0xf3e2f893dec3f126), -529, -140 },
+    { Q_UINT64_C(0xb5b5ada8aaff80b8), -502, -132 },
+    { Q_UINT64_C(0x87625f056c7c4a8b), -475, -124 },
+    { Q_UINT64_C(0xc9bcff6034c13053), -449, -116 },
+    { Q_UINT64_C(0x964e858c91ba2655), -422, -108 },
+    { Q_UINT64_C(0xdff9772470297ebd), -396, -100 },
+    { Q_UINT64_C(0xa6dfbd9fb8e5b88f), -369, -92 },
+    { Q_UINT64_C(0xf8a95fcf88747d94), -343, -84 },
+    { Q_UINT64_C(0xb94470938fa89bcf), -316, -76 },
+    { Q_UINT64_C(0x8a08f0f8bf0f156b), -289, -68 },
+    { Q_UINT64_C(0xcdb02555653131b6), -263, -60 },
+    { Q_UINT64_C(0x993fe2c6d07b7fac), -236, -52 },
+    { Q_UINT64_C(0xe45c10c42a2b3b06), -210, -44 },
+    { Q_UINT64_C(0xaa242499697392d3), -183, -36 },
+    { Q_UINT64_C(0xfd87b5f28300ca0e), -157, -28 },
+    { Q_UINT64_C(0xbce5086492111aeb), -130, -20 },
+    { Q_UINT64_C(0x8cbccc096f5088cc), -103, -12 },
+    { Q_UINT64_C(0xd1b71758e219652c), -77, -4 },
+    { Q_UINT64_C(0x9c40000000000000), -50, 4 },
+    { Q_UINT64_C(0xe8d4a51000000000), -24, 12 },
+    { Q_UINT64_C(0xad78ebc5ac620000), 3, 20 },
+    { Q_UINT64_C(0x813f3978f8940984), 30, 28 },
+    { Q_UINT64_C(0xc097ce7bc90715b3), 56, 36 },
+    { Q_UINT64_C(0x8f7e32ce7bea5c70), 83, 44 },
+    { Q_UINT64_C(0xd5d238a4abe98068), 109, 52 },
+    { Q_UINT64_C(0x9f4f2726179a2245), 136, 60 },
+    { Q_UINT64_C(0xed63a231d4c4fb27), 162, 68 },
+    { Q_UINT64_C(0xb0de65388cc8ada8), 189, 76 },
+    { Q_UINT64_C(0x83c7088e1aab65db), 216, 84 },
+    { Q_UINT64_C(0xc45d1df942711d9a), 242, 92 },
+    { Q_UINT64_C(0x924d692ca61be758), 269, 100 },
+    { Q_UINT64_C(0xda01ee641a708dea), 295, 108 },
+    { Q_UINT64_C(0xa26da3999aef774a), 322, 116 },
+    { Q_UINT64_C(0xf209787bb47d6b85), 348, 124 },
+    { Q_UINT64_C(0xb454e4a179dd1877), 375, 132 },
+    { Q_UINT64_C(0x865b86925b9bc5c2), 402, 140 },
+    { Q_UINT64_C(0xc83553c5c8965d3d), 428, 148 },
+    { Q_UINT64_C(0x952ab45cfa97a0b3), 455, 156 },
+    { Q_UINT64_C(0xde469fbd99a05fe3), 481, 164 },
+    { Q_UINT64_C(0xa59bc234db398c25), 508, 172 },
+    { Q_UINT64_C(0xf6c69a72a3989f5c), 534, 180 },
+    { Q_UINT64_C(0xb7dcbf5354e9bece), 561, 188 },
+    { Q_UINT64_C(0x88fcf317f22241e2), 588, 196 },
+    { Q_UINT64_C(0xcc20ce9bd35c78a5), 614, 204 },
+    { Q_UINT64_C(0x98165af37b2153df), 641, 212 },
+    { Q_UINT64_C(0xe2a0b5dc971f303a), 667, 220 },
+    { Q_UINT64_C(0xa8d9d1535ce3b396), 694, 228 },
+    { Q_UINT64_C(0xfb9b7cd9a4a7443c), 720, 236 },
+    { Q_UINT64_C(0xbb764c4ca7a44410), 747, 244 },
+    { Q_UINT64_C(0x8bab8eefb6409c1a), 774, 252 },
+    { Q_UINT64_C(0xd01fef10a657842c), 800, 260 },
+    { Q_UINT64_C(0x9b10a4e5e9913129), 827, 268 },
+    { Q_UINT64_C(0xe7109bfba19c0c9d), 853, 276 },
+    { Q_UINT64_C(0xac2820d9623bf429), 880, 284 },
+    { Q_UINT64_C(0x80444b5e7aa7cf85), 907, 292 },
+    { Q_UINT64_C(0xbf21e44003acdd2d), 933, 300 },
+    { Q_UINT64_C(0x8e679c2f5e44ff8f), 960, 308 },
+    { Q_UINT64_C(0xd433179d9c8cb841), 986, 316 },
+    { Q_UINT64_C(0x9e19db92b4e31ba9), 1013, 324 },
+    { Q_UINT64_C(0xeb96bf6ebadf77d9), 1039, 332 },
+    { Q_UINT64_C(0xaf87023b9bf0ee6b), 1066, 340 },
+};
+
+enum {
+    CachedPowersOffset = 348,       // -qt_cachedPowersOfTen[0].decimalExponent
+    CachedPowersDistance = 8,
+    MinimalTargetExponent = -60,
+    MaximalTargetExponent = -32,
+    MaximalSignificantDigits = 17   // enough for any double to round-trip
+};
+
+static const quint32 qt_smallPowersOfTen[] = {
+    0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// the product, rounded to the upper 64 bits
+static inline QDiyFp qt_diyFpTimes(QDiyFp x, QDiyFp y)
+{
+    const quint64 M32 = 0xffffffffu;
+    const quint64 a = x.f >> 32, b = x.f & M32;
+    const quint64 c = y.f >> 32, d = y.f & M32;
+    const quint64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    quint64 tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    tmp += Q_UINT64_C(1) << 31;
+    QDiyFp r = { ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 };
+    return r;
+}
+
+static inline QDiyFp qt_diyFpNormalize(QDiyFp x)
+{
+    while (!(x.f & (Q_UINT64_C(1) << 63))) {
+        x.f <<= 1;
+        --x.e;
+    }
+    return x;
+}
+
+static inline quint64 qt_doubleBits(double d)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+// v must be positive and finite
+static inline QDiyFp qt_doubleToDiyFp(double v)
+{
+    const quint64 bits = qt_doubleBits(v);
+    const quint64 significand = bits & Q_UINT64_C(0x000fffffffffffff);
+    const int biasedExponent = int(bits >> 52);
+    QDiyFp r;
+    if (biasedExponent) {
+        r.f = significand | Q_UINT64_C(0x0010000000000000);
+        r.e = biasedExponent - 1075;
+    } else {
+        r.f = significand;
+        r.e = -1074;
+    }
+    return r;
+}
+
+// The boundaries between v and its neighbors, with the exponent of the
+// normalized v.
+static void qt_normalizedBoundaries(double v, QDiyFp *minus, QDiyFp *plus)
+{
+    const QDiyFp w = qt_doubleToDiyFp(v);
+    QDiyFp p = { (w.f << 1) + 1, w.e - 1 };
+    p = qt_diyFpNormalize(p);
+
+    // the lower neighbor is closer if v is a power of two (and normal)
+    const quint64 bits = qt_doubleBits(v);
+    QDiyFp m;
+    if ((bits & Q_UINT64_C(0x000fffffffffffff)) == 0 && (bits >> 52) > 1) {
+        m.f = (w.f << 2) - 1;
+        m.e = w.e - 2;
+    } else {
+        m.f = (w.f << 1) - 1;
+        m.e = w.e - 1;
+    }
+    m.f <<= m.e - p.e;
+    m.e = p.e;
+
+    *minus = m;
+    *plus = p;
+}
+
+// A cached power of ten c such that the binary exponent of w * c falls in
+// [MinimalTargetExponent, MaximalTargetExponent]; c is about 10^mk.
+static inline QDiyFp qt_cachedPowerFor(QDiyFp w, int *mk)
+{
+    const int minExponent = MinimalTargetExponent - (w.e + 64);
+    const int k = int(ceil((minExponent + 63) * 0.30102999566398114));
+    const int index = (CachedPowersOffset + k - 1) / CachedPowersDistance + 1;
+    const QCachedPowerOfTen &cached = qt_cachedPowersOfTen[index];
+    Q_ASSERT(minExponent <= cached.binaryExponent
+             && cached.binaryExponent <= MaximalTargetExponent - (w.e + 64));
+    *mk = cached.decimalExponent;
+    QDiyFp c = { cached.significand, cached.binaryExponent };
+    return c;
+}
+
+static inline void qt_biggestPowerTen(quint32 number, quint32 *power, int *exponentPlusOne)
+{
+    int i = 10;
+    while (i > 1 && number < qt_smallPowersOfTen[i])
+        --i;
+    *power = qt_smallPowersOfTen[i];
+    *exponentPlusOne = i;
+}
+
+// Moves the last digit of buffer closer to w, and checks whether the result
+// is guaranteed to be the closest shortest representation.
+static bool qt_grisuRoundWeed(char *buffer, int length, quint64 distanceTooHighW,
+                              quint64 unsafeInterval, quint64 rest, quint64 tenKappa,
+                              quint64 unit)
+{
+    const quint64 smallDistance = distanceTooHighW - unit;
+    const quint64 bigDistance = distanceTooHighW + unit;
+    while (rest < smallDistance
+           && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        --buffer[length - 1];
+        rest += tenKappa;
+    }
+    if (rest < bigDistance
+            && unsafeInterval - rest >= tenKappa
+            && (rest + tenKappa < bigDistance
+                || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return false;
+    }
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+static bool qt_grisuDigitGen(QDiyFp low, QDiyFp w, QDiyFp high,
+                             char *buffer, int *length, int *kappa)
+{
+    quint64 unit = 1;
+    const QDiyFp tooLow = { low.f - unit, low.e };
+    const QDiyFp tooHigh = { high.f + unit, high.e };
+    quint64 unsafeInterval = tooHigh.f - tooLow.f;
+    const int shift = -w.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(tooHigh.f >> shift);
+    quint64 fractionals = tooHigh.f & (one - 1);
+
+    quint32 divisor;
+    qt_biggestPowerTen(integrals, &divisor, kappa);
+    *length = 0;
+    while (*kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        if (rest < unsafeInterval) {
+            return qt_grisuRoundWeed(buffer, *length, tooHigh.f - w.f, unsafeInterval,
+                                     rest, quint64(divisor) << shift, unit);
+        }
+        divisor /= 10;
+    }
+
+    forever {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[(*length)++] = char('0' + int(fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        if (fractionals < unsafeInterval) {
+            return qt_grisuRoundWeed(buffer, *length, (tooHigh.f - w.f) * unit, unsafeInterval,
+                                     fractionals, one, unit);
+        }
+    }
+}
+
+// The shortest digits that read back as v, v being positive and finite.
+static bool qt_grisuShortest(double v, char *buffer, int *length, int *decpt)
+{
+    const QDiyFp w = qt_diyFpNormalize(qt_doubleToDiyFp(v));
+    QDiyFp minus, plus;
+    qt_normalizedBoundaries(v, &minus, &plus);
+    Q_ASSERT(plus.e == w.e);
+
+    int mk;
+    const QDiyFp tenMk = qt_cachedPowerFor(w, &mk);
+    int kappa;
+    if (!qt_grisuDigitGen(qt_diyFpTimes(minus, tenMk), qt_diyFpTimes(w, tenMk),
+                          qt_diyFpTimes(plus, tenMk), buffer, length, &kappa))
+        return false;
+    *decpt = *length - mk + kappa;
+    return true;
+}
+
+// Checks whether rest, the part of w below the last generated digit, can be
+// rounded safely given the error unit, rounding the digits up if needed.
+static bool qt_grisuRoundWeedCounted(char *buffer, int length, quint64 rest,
+                                     quint64 tenKappa, quint64 unit, int *kappa)
+{
+    if (unit >= tenKappa || tenKappa - unit <= unit)
+        return false;
+    if (tenKappa - rest > rest && tenKappa - 2 * rest >= 2 * unit)
+        return true;
+    if (rest > unit && tenKappa - (rest - unit) <= rest - unit) {
+        ++buffer[length - 1];
+        for (int i = length - 1; i > 0; --i) {
+            if (buffer[i] != '0' + 10)
+                break;
+            buffer[i] = '0';
+            ++buffer[i - 1];
+        }
+        if (buffer[0] == '0' + 10) {
+            buffer[0] = '1';
+            ++*kappa;
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool qt_grisuDigitGenCounted(QDiyFp w, int requestedDigits, char *buffer,
+                                    int *length, int *kappa)
+{
+    quint64 error = 1;
+    const int shift = -w.e;
+    const quint64 one = Q_UINT64_C(1) << shift;
+    quint32 integrals = quint32(w.f >> shift);
+    quint64 fractionals = w.f & (one - 1);
+
+    quint32 divisor;
+    qt_biggestPowerTen(integrals, &divisor, kappa);
+    *length = 0;
+    while (*kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        if (--requestedDigits == 0)
+            break;
+        divisor /= 10;
+    }
+    if (requestedDigits == 0) {
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        return qt_grisuRoundWeedCounted(buffer, *length, rest, quint64(divisor) << shift,
+                                        error, kappa);
+    }
+
+    while (requestedDigits > 0 && fractionals > error) {
+        fractionals *= 10;
+        error *= 10;
+        buffer[(*length)++] = char('0' + int(fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        --requestedDigits;
+    }
+    if (requestedDigits != 0)
+        return false;
+    return qt_grisuRoundWeedCounted(buffer, *length, fractionals, one, error, kappa);
+}
+
+// v rounded to requestedDigits significant digits, v being positive and
+// finite.
+static bool qt_grisuCounted(double v, int requestedDigits, char *buffer, int *length, int *decpt)
+{
+    const QDiyFp w = qt_diyFpNormalize(qt_doubleToDiyFp(v));
+    int mk;
+    const QDiyFp tenMk = qt_cachedPowerFor(w, &mk);
+    int kappa;
+    if (!qt_grisuDigitGenCounted(qt_diyFpTimes(w, tenMk), requestedDigits, buffer, length, &kappa))
+        return false;
+    *decpt = *length - mk + kappa;
+    return true;
+}
+
+static bool qt_fastDoubleToAscii(double v, QLocalePrivate::DoubleForm form, int precision,
+                                 char *buf, int bufSize, int &length, int &decpt)
+{
+    char digits[MaximalSignificantDigits + 1];
+    if (precision == QLocale::FloatingPointShortest) {
+        if (!qt_grisuShortest(v, digits, &length, &decpt))
+            return false;
+    } else if (form == QLocalePrivate::DFDecimal) {
+        // The number of significant digits depends on where the decimal
+        // point is, so find that out first. The guess can only be too high,
+        // when the shortest representation rounds up to a power of ten.
+        int guessedDecpt;
+        if (!qt_grisuShortest(v, digits, &length, &guessedDecpt))
+            return false;
+        forever {
+            const int requested = guessedDecpt + precision;
+            if (requested < 1 || requested > MaximalSignificantDigits)
+                return false;
+            if (!qt_grisuCounted(v, requested, digits, &length, &decpt))
+                return false;
+            if (decpt >= guessedDecpt)
+                break;
+            guessedDecpt = decpt;
+        }
+    } else {
+        const int requested = form == QLocalePrivate::DFExponent ? precision + 1 : qMax(precision, 1);
+        if (requested > MaximalSignificantDigits)
+            return false;
+        if (!qt_grisuCounted(v, requested, digits, &length, &decpt))
+            return false;
+    }
+
+    while (length > 1 && digits[length - 1] == '0')
+        --length;
+    if (length > bufSize)
+        return false;
+    memcpy(buf, digits, length);
+    return true;
+}
+
+/*!
+    \internal
+
+    Converts the finite double \a d to decimal digits the way qdtoa() does
+    for \a form and \a precision, which may be QLocale::FloatingPointShortest.
+    The digits, without trailing zeros, are written to \a buf, which must be
+    large enough for them, and counted in \a length; \a decpt is set to the
+    position of the decimal point relative to the first digit, and \a sign
+    to whether \a d is negative.
+*/
+void qt_doubleToAscii(double d, QLocalePrivate::DoubleForm form, int precision,
+                      char *buf, int bufSize, bool &sign, int &length, int &decpt)
+{
+    sign = qt_doubleBits(d) >> 63;
+    if (d != 0 && qt_fastDoubleToAscii(qAbs(d), form, precision, buf, bufSize, length, decpt))
+        return;
+
+    int mode;
+    int ndigits = precision;
+    if (precision == QLocale::FloatingPointShortest) {
+        mode = 0;
+        ndigits = 0;
+    } else if (form == QLocalePrivate::DFDecimal) {
+        mode = 3;
+    } else {
+        /* In DFExponent form, the precision is the number of digits after
+           decpt. So that would suggest using mode=3 for qdtoa. But qdtoa
+           behaves strangely when mode=3 and precision=0. So we get around
+           this by using mode=2 and reasoning that we want precision+1
+           significant digits, since the decimal point in this mode is
+           always after the first digit. */
+        mode = 2;
+        if (form == QLocalePrivate::DFExponent)
+            ++ndigits;
+    }
+
+    char *rve = 0;
+    char *buff = 0;
+    int qdtoaSign = 0;
+    QT_TRY {
+        const char *digits = qdtoa(d, mode, ndigits, &decpt, &qdtoaSign, &rve, &buff);
+        length = qMin(int(qstrlen(digits)), bufSize);
+        memcpy(buf, digits, length);
+    } QT_CATCH(...) {
+        if (buff != 0)
+            free(buff);
+        QT_RETHROW;
+    }
+    if (buff != 0)
+        free(buff);
+    sign = qdtoaSign != 0;
+}
+
+#if defined(FLT_EVAL_METHOD)
+#  if FLT_EVAL_METHOD == 0
+#    define QT_DOUBLE_PARSING_FAST_PATH
+#  endif
+#elif defined(Q_PROCESSOR_X86_64)
+#  define QT_DOUBLE_PARSING_FAST_PATH
+#endif
+
+#ifdef QT_DOUBLE_PARSING_FAST_PATH
+static const double qt_exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#endif
+
+/*!
+    \internal
+
+    Converts the C locale representation of a double, "[+-]digits[.digits]"
+    optionally followed by an exponent, that spans all of the \a numLen
+    characters of \a num, when that can be done exactly with double
+    arithmetic. Returns false otherwise, leaving \a result alone.
+*/
+bool qt_fastAsciiToDouble(const char *num, int numLen, double *result)
+{
+#ifdef QT_DOUBLE_PARSING_FAST_PATH
+    const char *p = num;
+    const char *const end = num + numLen;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    quint64 significand = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool haveDigits = false;
+    for ( ; p < end && *p >= '0' && *p <= '9'; ++p) {
+        haveDigits = true;
+        if (significand || *p != '0') {
+            if (++significantDigits > 19)
+                return false;
+            significand = significand * 10 + (*p - '0');
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            haveDigits = true;
+            if (significand || *p != '0') {
+                if (++significantDigits > 19)
+                    return false;
+                significand = significand * 10 + (*p - '0');
+            }
+            --exponent;
+        }
+    }
+    if (!haveDigits)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+        if (p == end)
+            return false;
+        int e = 0;
+        for ( ; p < end && *p >= '0' && *p <= '9'; ++p) {
+            if (e < 10000)
+                e = e * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (p != end)
+        return false;
+
+    const quint64 maxExactSignificand = Q_UINT64_C(1) << 53;
+    if (significand > maxExactSignificand)
+        return false;
+
+    double value;
+    if (significand == 0) {
+        value = 0;
+    } else if (exponent < 0) {
+        if (exponent < -22)
+            return false;
+        value = double(significand) / qt_exactPowersOfTen[-exponent];
+    } else {
+        // 123e25 is 123000e22, which is still exact
+        for ( ; exponent > 22; --exponent) {
+            significand *= 10;
+            if (significand > maxExactSignificand)
+                return false;
+        }
+        value = double(significand) * qt_exactPowersOfTen[exponent];
+    }
+    *result = negative ? -value : value;
+    return true;
+#else
+    Q_UNUSED(num);
+    Q_UNUSED(numLen);
+    Q_UNUSED(result);
+    return false;
+#endif
+}
+
+/*!
+    \internal
+
+    Converts the C locale representation of a double in the first \a numLen
+    characters of \a num, which need not be '\\0'-terminated, like
+    QLocalePrivate::bytearrayToDouble() does.
+*/
+double qt_asciiToDouble(const char *num, int numLen, bool *ok)
+{
+    double d;
+    if (qt_fastAsciiToDouble(num, numLen, &d)) {
+        if (ok)
+            *ok = true;
+        return d;
+    }
+
+    QVarLengthArray<char, 128> terminated(numLen + 1);
+    memcpy(terminated.data(), num, numLen);
+    terminated[numLen] = '\0';
+    return QLocalePrivate::bytearrayToDouble(terminated.constData(), ok);
+}
+
 QT_END_NAMESPACE
@@ -110,6 +110,11 @@ bool removeGroupSeparators(QLocalePrivate::CharBuff *num);
 Q_CORE_EXPORT char *qdtoa(double d, int mode, int ndigits, int *decpt,
                           int *sign, char **rve, char **digits_str);
 Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
+
+Q_CORE_EXPORT void qt_doubleToAscii(double d, QLocalePrivate::DoubleForm form, int precision,
+                                    char *buf, int bufSize, bool &sign, int &length, int &decpt);
+Q_CORE_EXPORT bool qt_fastAsciiToDouble(const char *num, int numLen, double *result);
+Q_CORE_EXPORT double qt_asciiToDouble(const char *num, int numLen, bool *ok);
 qlonglong qstrtoll(const char *nptr, const char **endptr, register int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, register int base, bool *ok);
 
@@ -1012,6 +1012,9 @@
     Writes the vector \a vector to stream \a out.
 
     This function requires the value type to implement \c operator<<().
+    Vectors of integers, and of floating point numbers in the stream's
+    floating point precision, are written with a single
+    QDataStream::writeArray() call.
 
     \sa{Serializing Qt Data Types}{Format of the QDataStream operators}
 */
@@ -1022,6 +1025,9 @@
     Reads a vector from stream \a in into \a vector.
 
     This function requires the value type to implement \c operator>>().
+    Vectors of integers, and of floating point numbers in the stream's
+    floating point precision, are read with a single
+    QDataStream::readArray() call into the memory \a vector already has.
 
     \sa{Serializing Qt Data Types}{Format of the QDataStream operators}
 */
@@ -18,6 +18,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qeasingcurve.h \
         tools/qfreelist_p.h \
+        tools/qfreelistpool.h \
         tools/qhash.h \
         tools/qiterator.h \
         tools/qline.h \
@@ -74,6 +75,7 @@ SOURCES += \
         tools/qeasingcurve.cpp \
         tools/qelapsedtimer.cpp \
         tools/qfreelist.cpp \
+        tools/qfreelistpool.cpp \
         tools/qhash.cpp \
         tools/qline.cpp \
         tools/qlinkedlist.cpp \
@@ -0,0 +1,553 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhpack_p.h"
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct QHPackStaticEntry {
+    const char *name;
+    const char *value;
+};
+
+// RFC 7541, Appendix A
+static const QHPackStaticEntry staticTable[QHPackTable::StaticTableSize] = {
+    { ":authority", "" },
+    { ":method", "GET" },
+    { ":method", "POST" },
+    { ":path", "/" },
+    { ":path", "/index.html" },
+    { ":scheme", "http" },
+    { ":scheme", "https" },
+    { ":status", "200" },
+    { ":status", "204" },
+    { ":status", "206" },
+    { ":status", "304" },
+    { ":status", "400" },
+    { ":status", "404" },
+    { ":status", "500" },
+    { "accept-charset", "" },
+    { "accept-encoding", "gzip, deflate" },
+    { "accept-language", "" },
+    { "accept-ranges", "" },
+    { "accept", "" },
+    { "access-control-allow-origin", "" },
+    { "age", "" },
+    { "allow", "" },
+    { "authorization", "" },
+    { "cache-control", "" },
+    { "content-disposition", "" },
+    { "content-encoding", "" },
+    { "content-language", "" },
+    { "content-length", "" },
+    { "content-location", "" },
+    { "content-range", "" },
+    { "content-type", "" },
+    { "cookie", "" },
+    { "date", "" },
+    { "etag", "" },
+    { "expect", "" },
+    { "expires", "" },
+    { "from", "" },
+    { "host", "" },
+    { "if-match", "" },
+    { "if-modified-since", "" },
+    { "if-none-match", "" },
+    { "if-range", "" },
+    { "if-unmodified-since", "" },
+    { "last-modified", "" },
+    { "link", "" },
+    { "location", "" },
+    { "max-forwards", "" },
+    { "proxy-authenticate", "" },
+    { "proxy-authorization", "" },
+    { "range", "" },
+    { "referer", "" },
+    { "refresh", "" },
+    { "retry-after", "" },
+    { "server", "" },
+    { "set-cookie", "" },
+    { "strict-transport-security", "" },
+    { "transfer-encoding", "" },
+    { "user-agent", "" },
+    { "vary", "" },
+    { "via", "" },
+    { "www-authenticate", "" }
+};
+
+// RFC 7541, Appendix B
+static const struct {
+    quint32 code;
+    quint8 bitLength;
+} huffmanCodes[257] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+    {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+    {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+    {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+    {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+    {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+    {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+    {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+    {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+    {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+    {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+    {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+    {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+    {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+    {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+    {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+    {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+    {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+    {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+    {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+    {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+    {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+    {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+    {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+    {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+    {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+    {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+    {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+    {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+    {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+    {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+    {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+    {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+    {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+    {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+    {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+    {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+    {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+    {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+    {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+    {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+    {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+    {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+    {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+    {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+    {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+    {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+    {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+    {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+    {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+    {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+    {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+    {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+    {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+    {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+    {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+    {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+    {0x3fffffff, 30}
+};
+
+// the symbols ordered by code, the codes are canonical
+static const quint16 huffmanSymbols[257] = {
+    48, 49, 50, 97, 99, 101, 105, 111, 115, 116, 32, 37,
+    45, 46, 47, 51, 52, 53, 54, 55, 56, 57, 61, 65,
+    95, 98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+    58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+    77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+    106, 107, 113, 118, 119, 120, 121, 122, 38, 42, 44, 59,
+    88, 90, 33, 34, 40, 41, 63, 39, 43, 124, 35, 62,
+    0, 36, 64, 91, 93, 126, 94, 125, 60, 96, 123, 92,
+    195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+    167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+    132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+    173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+    233, 1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+    151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+    183, 188, 191, 197, 231, 239, 9, 142, 144, 145, 148, 159,
+    171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+    200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+    255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+    246, 247, 248, 250, 251, 252, 253, 254, 2, 3, 4, 5,
+    6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20,
+    21, 23, 24, 25, 26, 27, 28, 29, 30, 31, 127, 220,
+    249, 10, 13, 22, 256
+};
+
+// for each code length from 5 to 30 bits: the first code, the index of its
+// symbol in huffmanSymbols and the number of codes of that length
+static const struct {
+    quint32 firstCode;
+    quint16 firstIndex;
+    quint16 count;
+} huffmanLengths[26] = {
+    {0x0, 0, 10}, {0x14, 10, 26}, {0x5c, 36, 32}, {0xf8, 68, 6},
+    {0, 0, 0}, {0x3f8, 74, 5}, {0x7fa, 79, 3}, {0xffa, 82, 2},
+    {0x1ff8, 84, 6}, {0x3ffc, 90, 2}, {0x7ffc, 92, 3}, {0, 0, 0},
+    {0, 0, 0}, {0, 0, 0}, {0x7fff0, 95, 3}, {0xfffe6, 98, 8},
+    {0x1fffdc, 106, 13}, {0x3fffd2, 119, 26}, {0x7fffd8, 145, 29}, {0xffffea, 174, 12},
+    {0x1ffffec, 186, 4}, {0x3ffffe0, 190, 15}, {0x7ffffde, 205, 19}, {0xfffffe2, 224, 29},
+    {0, 0, 0}, {0x3ffffffc, 253, 4}
+};
+
+static inline void encodeInteger(quint32 value, int prefixBits, uchar pattern, QByteArray *out)
+{
+    const quint32 prefixMax = (1u << prefixBits) - 1;
+    if (value < prefixMax) {
+        out->append(char(pattern | value));
+        return;
+    }
+    out->append(char(pattern | prefixMax));
+    value -= prefixMax;
+    while (value >= 0x80) {
+        out->append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+static bool decodeInteger(const uchar *&p, const uchar *end, int prefixBits, quint32 *value)
+{
+    if (p == end)
+        return false;
+    const quint32 prefixMax = (1u << prefixBits) - 1;
+    quint64 result = *p++ & prefixMax;
+    if (result == prefixMax) {
+        int shift = 0;
+        uchar byte;
+        do {
+            if (p == end || shift > 28)
+                return false;
+            byte = *p++;
+            result += quint64(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        if (result > 0xffffffffU)
+            return false;
+    }
+    *value = quint32(result);
+    return true;
+}
+
+static void encodeString(const QByteArray &string, bool huffman, QByteArray *out)
+{
+    if (huffman) {
+        const int encodedSize = qHuffmanEncodedSize(string);
+        if (encodedSize < string.size()) {
+            encodeInteger(encodedSize, 7, 0x80, out);
+            qHuffmanEncode(string, out);
+            return;
+        }
+    }
+    encodeInteger(string.size(), 7, 0x00, out);
+    out->append(string);
+}
+
+static bool decodeString(const uchar *&p, const uchar *end, QByteArray *string)
+{
+    if (p == end)
+        return false;
+    const bool huffman = *p & 0x80;
+    quint32 length;
+    if (!decodeInteger(p, end, 7, &length) || length > quint32(end - p))
+        return false;
+    const char *data = reinterpret_cast<const char *>(p);
+    p += length;
+    if (!huffman) {
+        *string = QByteArray(data, length);
+        return true;
+    }
+    string->clear();
+    return qHuffmanDecode(data, length, string);
+}
+
+static inline bool isSensitive(const QByteArray &name)
+{
+    // never put credentials into a compression context
+    return name == "authorization" || name == "proxy-authorization";
+}
+
+} // namespace
+
+void qHuffmanEncode(const QByteArray &data, QByteArray *out)
+{
+    quint64 bits = 0;
+    int bitCount = 0;
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *end = p + data.size();
+    for ( ; p != end; ++p) {
+        bits = (bits << huffmanCodes[*p].bitLength) | huffmanCodes[*p].code;
+        bitCount += huffmanCodes[*p].bitLength;
+        while (bitCount >= 8) {
+            bitCount -= 8;
+            out->append(char(bits >> bitCount));
+        }
+    }
+    if (bitCount > 0) {
+        // pad with the most significant bits of EOS, i.e. ones
+        bits = (bits << (8 - bitCount)) | ((1u << (8 - bitCount)) - 1);
+        out->append(char(bits));
+    }
+}
+
+int qHuffmanEncodedSize(const QByteArray &data)
+{
+    qint64 bitCount = 0;
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *end = p + data.size();
+    for ( ; p != end; ++p)
+        bitCount += huffmanCodes[*p].bitLength;
+    return int((bitCount + 7) / 8);
+}
+
+bool qHuffmanDecode(const char *data, int size, QByteArray *out)
+{
+    quint32 code = 0;
+    int bitLength = 0;
+    for (int i = 0; i < size; ++i) {
+        const uchar byte = data[i];
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1);
+            ++bitLength;
+            if (bitLength < 5)
+                continue;
+            if (bitLength > 30)
+                return false;
+            const quint32 offset = code - huffmanLengths[bitLength - 5].firstCode;
+            if (offset < huffmanLengths[bitLength - 5].count) {
+                const quint16 symbol = huffmanSymbols[huffmanLengths[bitLength - 5].firstIndex + offset];
+                if (symbol == 256)
+                    return false; // EOS must not appear in the data
+                out->append(char(symbol));
+                code = 0;
+                bitLength = 0;
+            }
+        }
+    }
+    // the rest must be padding: less than a byte of the EOS prefix
+    return bitLength < 8 && code == (1u << bitLength) - 1;
+}
+
+QHPackTable::QHPackTable(quint32 maxSize)
+    : maximumSize(maxSize), currentSize(0)
+{
+}
+
+void QHPackTable::setMaxSize(quint32 size)
+{
+    maximumSize = size;
+    evict(0);
+}
+
+void QHPackTable::evict(quint32 required)
+{
+    while (!entries.isEmpty() && currentSize + required > maximumSize) {
+        const QHPackHeaderField &last = entries.last();
+        currentSize -= last.first.size() + last.second.size() + EntryOverhead;
+        entries.removeLast();
+    }
+}
+
+void QHPackTable::add(const QByteArray &name, const QByteArray &value)
+{
+    const quint32 entrySize = name.size() + value.size() + EntryOverhead;
+    if (entrySize > maximumSize) {
+        // not an error, it just empties the table
+        entries.clear();
+        currentSize = 0;
+        return;
+    }
+    evict(entrySize);
+    entries.prepend(qMakePair(name, value));
+    currentSize += entrySize;
+}
+
+bool QHPackTable::field(quint32 index, QHPackHeaderField *field) const
+{
+    if (index == 0)
+        return false;
+    if (index <= StaticTableSize) {
+        const QHPackStaticEntry &entry = staticTable[index - 1];
+        field->first = QByteArray::fromRawData(entry.name, qstrlen(entry.name));
+        field->second = QByteArray::fromRawData(entry.value, qstrlen(entry.value));
+        return true;
+    }
+    index -= StaticTableSize + 1;
+    if (index >= quint32(entries.size()))
+        return false;
+    *field = entries.at(index);
+    return true;
+}
+
+quint32 QHPackTable::find(const QByteArray &name, const QByteArray &value, quint32 *nameIndex) const
+{
+    *nameIndex = 0;
+    for (int i = 0; i < StaticTableSize; ++i) {
+        if (qstrcmp(name.constData(), staticTable[i].name) != 0)
+            continue;
+        if (qstrcmp(value.constData(), staticTable[i].value) == 0)
+            return i + 1;
+        if (!*nameIndex)
+            *nameIndex = i + 1;
+    }
+    for (int i = 0; i < entries.size(); ++i) {
+        const QHPackHeaderField &entry = entries.at(i);
+        if (entry.first != name)
+            continue;
+        if (entry.second == value)
+            return StaticTableSize + 1 + i;
+        if (!*nameIndex)
+            *nameIndex = StaticTableSize + 1 + i;
+    }
+    return 0;
+}
+
+QHPackEncoder::QHPackEncoder(quint32 maxTableSize)
+    : table(maxTableSize), pendingSizeUpdate(0), sizeUpdatePending(false), huffman(true)
+{
+}
+
+void QHPackEncoder::setMaxTableSize(quint32 size)
+{
+    // we never need more than the default, but must follow a smaller limit
+    const quint32 newSize = qMin<quint32>(size, QHPackTable::DefaultMaxSize);
+    if (newSize != table.maxSize() || sizeUpdatePending) {
+        pendingSizeUpdate = newSize;
+        sizeUpdatePending = true;
+    }
+}
+
+void QHPackEncoder::encode(const QHPackHeaderList &headers, QByteArray *out)
+{
+    if (sizeUpdatePending) {
+        encodeInteger(pendingSizeUpdate, 5, 0x20, out);
+        table.setMaxSize(pendingSizeUpdate);
+        sizeUpdatePending = false;
+    }
+    for (int i = 0; i < headers.size(); ++i)
+        encodeField(headers.at(i).first, headers.at(i).second, out);
+}
+
+void QHPackEncoder::encodeField(const QByteArray &name, const QByteArray &value, QByteArray *out)
+{
+    quint32 nameIndex;
+    const quint32 index = table.find(name, value, &nameIndex);
+    if (index) {
+        // indexed header field
+        encodeInteger(index, 7, 0x80, out);
+        return;
+    }
+
+    const quint32 entrySize = name.size() + value.size() + QHPackTable::EntryOverhead;
+    if (isSensitive(name)) {
+        // literal never indexed
+        encodeInteger(nameIndex, 4, 0x10, out);
+    } else if (entrySize > table.maxSize() / 2) {
+        // literal without indexing, it would flush most of the table
+        encodeInteger(nameIndex, 4, 0x00, out);
+    } else {
+        // literal with incremental indexing
+        encodeInteger(nameIndex, 6, 0x40, out);
+        table.add(name, value);
+    }
+    if (!nameIndex)
+        encodeString(name, huffman, out);
+    encodeString(value, huffman, out);
+}
+
+QHPackDecoder::QHPackDecoder(quint32 maxTableSize)
+    : table(maxTableSize), settingsMaxSize(maxTableSize)
+{
+}
+
+bool QHPackDecoder::decode(const char *data, int size, QHPackHeaderList *headers)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    const uchar *end = p + size;
+    bool fieldSeen = false;
+
+    while (p != end) {
+        const uchar first = *p;
+        quint32 index;
+        QHPackHeaderField field;
+
+        if (first & 0x80) {
+            // indexed header field
+            if (!decodeInteger(p, end, 7, &index) || !table.field(index, &field))
+                return false;
+            headers->append(field);
+            fieldSeen = true;
+            continue;
+        }
+
+        if ((first & 0xe0) == 0x20) {
+            // dynamic table size update, only allowed at the beginning of a block
+            if (fieldSeen || !decodeInteger(p, end, 5, &index) || index > settingsMaxSize)
+                return false;
+            table.setMaxSize(index);
+            continue;
+        }
+
+        const bool incremental = (first & 0x40);
+        if (!decodeInteger(p, end, incremental ? 6 : 4, &index))
+            return false;
+        if (index) {
+            if (!table.field(index, &field))
+                return false;
+        } else if (!decodeString(p, end, &field.first)) {
+            return false;
+        }
+        if (!decodeString(p, end, &field.second))
+            return false;
+        if (incremental)
+            table.add(field.first, field.second);
+        headers->append(field);
+        fieldSeen = true;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
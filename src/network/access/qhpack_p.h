@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHPACK_P_H
+#define QHPACK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+// HPACK header compression for HTTP/2, see RFC 7541
+
+typedef QPair<QByteArray, QByteArray> QHPackHeaderField;
+typedef QList<QHPackHeaderField> QHPackHeaderList;
+
+class Q_AUTOTEST_EXPORT QHPackTable
+{
+public:
+    enum { StaticTableSize = 61, DefaultMaxSize = 4096, EntryOverhead = 32 };
+
+    explicit QHPackTable(quint32 maxSize = DefaultMaxSize);
+
+    quint32 maxSize() const { return maximumSize; }
+    void setMaxSize(quint32 size);
+    quint32 size() const { return currentSize; }
+    int dynamicCount() const { return entries.size(); }
+
+    void add(const QByteArray &name, const QByteArray &value);
+    bool field(quint32 index, QHPackHeaderField *field) const;
+
+    // returns the index of an entry matching name and value or 0; if there
+    // is none, *nameIndex is set to an entry with just the same name (or 0)
+    quint32 find(const QByteArray &name, const QByteArray &value, quint32 *nameIndex) const;
+
+private:
+    void evict(quint32 required);
+
+    QList<QHPackHeaderField> entries; // newest first
+    quint32 maximumSize;
+    quint32 currentSize;
+};
+
+class Q_AUTOTEST_EXPORT QHPackEncoder
+{
+public:
+    explicit QHPackEncoder(quint32 maxTableSize = QHPackTable::DefaultMaxSize);
+
+    // the peer's SETTINGS_HEADER_TABLE_SIZE; announced in the next header block
+    void setMaxTableSize(quint32 size);
+    void setCompressStrings(bool enable) { huffman = enable; }
+
+    void encode(const QHPackHeaderList &headers, QByteArray *out);
+
+private:
+    void encodeField(const QByteArray &name, const QByteArray &value, QByteArray *out);
+
+    QHPackTable table;
+    quint32 pendingSizeUpdate;
+    bool sizeUpdatePending;
+    bool huffman;
+};
+
+class Q_AUTOTEST_EXPORT QHPackDecoder
+{
+public:
+    explicit QHPackDecoder(quint32 maxTableSize = QHPackTable::DefaultMaxSize);
+
+    // decodes one complete header block; returns false on a compression error,
+    // the decoder can't be used anymore afterwards
+    bool decode(const char *data, int size, QHPackHeaderList *headers);
+
+private:
+    QHPackTable table;
+    quint32 settingsMaxSize;
+};
+
+Q_AUTOTEST_EXPORT void qHuffmanEncode(const QByteArray &data, QByteArray *out);
+Q_AUTOTEST_EXPORT int qHuffmanEncodedSize(const QByteArray &data);
+Q_AUTOTEST_EXPORT bool qHuffmanDecode(const char *data, int size, QByteArray *out);
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHPACK_P_H
@@ -0,0 +1,1039 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttp2protocolhandler_p.h"
+#include "qhttpnetworkconnection_p.h"
+#include "qhttpnetworkconnectionchannel_p.h"
+#include "private/qnoncontiguousbytedevice_p.h"
+
+#include <qcoreapplication.h>
+#include <qendian.h>
+
+#ifndef QT_NO_COMPRESS
+#include <private/qcompressor_p.h>
+#endif
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+static const char connectionPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+static inline quint32 readUInt32(const char *data)
+{
+    return qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(data));
+}
+
+static inline void appendUInt32(QByteArray *out, quint32 value)
+{
+    uchar buffer[4];
+    qToBigEndian<quint32>(value, buffer);
+    out->append(reinterpret_cast<const char *>(buffer), 4);
+}
+
+static inline void appendSetting(QByteArray *out, quint16 id, quint32 value)
+{
+    uchar buffer[2];
+    qToBigEndian<quint16>(id, buffer);
+    out->append(reinterpret_cast<const char *>(buffer), 2);
+    appendUInt32(out, value);
+}
+
+// the part of a DATA or HEADERS payload that is left after removing the padding
+static bool unpaddedRange(const QByteArray &payload, quint8 flags, int *offset, int *size)
+{
+    *offset = 0;
+    *size = payload.size();
+    if (flags & QHttp2ProtocolHandler::PaddedFlag) {
+        if (payload.isEmpty())
+            return false;
+        int padding = uchar(payload.at(0));
+        *offset = 1;
+        *size = payload.size() - 1 - padding;
+    }
+    return *size >= 0;
+}
+
+static bool isIdempotent(const QHttpNetworkRequest &request)
+{
+    switch (request.operation()) {
+    case QHttpNetworkRequest::Get:
+    case QHttpNetworkRequest::Head:
+    case QHttpNetworkRequest::Options:
+    case QHttpNetworkRequest::Trace:
+    case QHttpNetworkRequest::Put:
+    case QHttpNetworkRequest::Delete:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel)
+    : QObject(channel), channel(channel), socket(channel->socket),
+      nextStreamId(1), goingAway(false), settingsReceived(false),
+      frameHeaderRead(0), framePayloadRead(0), frameType(0), frameFlags(0), frameStreamId(0),
+      continuedStreamId(0), continuedEndStream(false),
+      maxConcurrentStreams(100), peerMaxFrameSize(DefaultMaxFrameSize),
+      peerInitialWindowSize(DefaultWindowSize), sessionSendWindow(DefaultWindowSize),
+      sessionRecvWindow(DefaultWindowSize), sessionConsumed(0)
+{
+}
+
+QHttp2ProtocolHandler::~QHttp2ProtocolHandler()
+{
+}
+
+void QHttp2ProtocolHandler::start()
+{
+    outgoing.append(connectionPreface, sizeof(connectionPreface) - 1);
+
+    // we never accept pushed streams, and let the server send more per
+    // stream than the 64K default before it has to wait for us
+    QByteArray settings;
+    appendSetting(&settings, EnablePushSetting, 0);
+    appendSetting(&settings, InitialWindowSizeSetting, StreamReceiveWindow);
+    appendFrame(SettingsFrame, NoFlags, 0, settings.constData(), settings.size());
+
+    // the connection window can't be set with SETTINGS, only grown
+    appendWindowUpdate(0, SessionReceiveWindow - DefaultWindowSize);
+    sessionRecvWindow = SessionReceiveWindow;
+
+    flushOutgoing();
+}
+
+void QHttp2ProtocolHandler::sendRequests()
+{
+    if (!socket || socket->state() != QAbstractSocket::ConnectedState || !socket->isValid())
+        return;
+
+    QHttpNetworkConnectionPrivate *connectionPrivate = channel->connection->d_func();
+    while (!goingAway && connectionPrivate->state == QHttpNetworkConnectionPrivate::RunningState
+           && quint32(streams.size()) < maxConcurrentStreams) {
+        if (nextStreamId > MaxStreamId) {
+            // stream ids can't be reused, continue on a new connection
+            goingAway = true;
+            break;
+        }
+
+        HttpMessagePair messagePair;
+        if (!connectionPrivate->highPriorityQueue.isEmpty())
+            messagePair = connectionPrivate->highPriorityQueue.takeLast();
+        else if (!connectionPrivate->lowPriorityQueue.isEmpty())
+            messagePair = connectionPrivate->lowPriorityQueue.takeLast();
+        else
+            break;
+
+        if (!messagePair.second->d_func()->requestIsPrepared)
+            connectionPrivate->prepareRequest(messagePair);
+        openStream(messagePair.first, messagePair.second);
+    }
+
+    // continue the uploads waiting for window or data
+    QList<quint32> ids = streams.keys();
+    for (int i = 0; i < ids.size(); ++i) {
+        QHash<quint32, Stream>::const_iterator it = streams.constFind(ids.at(i));
+        if (it != streams.constEnd() && it->uploading)
+            sendUploadData(ids.at(i));
+    }
+
+    flushOutgoing();
+    closeIfIdle();
+}
+
+void QHttp2ProtocolHandler::openStream(const QHttpNetworkRequest &request, QHttpNetworkReply *reply)
+{
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    replyPrivate->clear();
+    replyPrivate->connection = channel->connection;
+    replyPrivate->connectionChannel = channel;
+    replyPrivate->autoDecompress = request.d->autoDecompress;
+    replyPrivate->pipeliningUsed = false;
+    replyPrivate->http2Used = true;
+
+    QHPackHeaderList headers;
+    headers << qMakePair(QByteArray(":method"), request.d->methodName())
+            << qMakePair(QByteArray(":scheme"), QByteArray(request.isSsl() ? "https" : "http"))
+            << qMakePair(QByteArray(":authority"), request.headerField("host"))
+            << qMakePair(QByteArray(":path"), request.d->uri(false));
+
+    const QList<QPair<QByteArray, QByteArray> > fields = request.header();
+    for (int i = 0; i < fields.size(); ++i) {
+        // HTTP/2 has its own framing, the HTTP/1 connection specific fields must not be sent
+        const QByteArray name = fields.at(i).first.toLower();
+        if (name == "connection" || name == "keep-alive" || name == "proxy-connection"
+            || name == "transfer-encoding" || name == "upgrade" || name == "host" || name == "te")
+            continue;
+        headers << qMakePair(name, fields.at(i).second);
+    }
+    // see QHttpNetworkRequestPrivate::header()
+    if (request.operation() == QHttpNetworkRequest::Post && request.headerField("content-type").isEmpty())
+        headers << qMakePair(QByteArray("content-type"), QByteArray("application/x-www-form-urlencoded"));
+
+    Stream stream;
+    stream.id = nextStreamId;
+    nextStreamId += 2;
+    stream.request = request;
+    stream.reply = reply;
+    stream.sendWindow = peerInitialWindowSize;
+    stream.recvWindow = StreamReceiveWindow;
+
+    QNonContiguousByteDevice *uploadByteDevice = request.uploadByteDevice();
+    if (uploadByteDevice && request.contentLength() != 0) {
+        stream.uploading = true;
+        stream.uploadTotal = request.contentLength();
+        QObject::connect(uploadByteDevice, SIGNAL(readyRead()), this, SLOT(_q_uploadDataReadyRead()));
+    }
+
+    QByteArray block;
+    encoder.encode(headers, &block);
+    int offset = 0;
+    do {
+        const int size = qMin<int>(block.size() - offset, peerMaxFrameSize);
+        quint8 flags = (offset + size == block.size()) ? EndHeadersFlag : NoFlags;
+        if (offset == 0 && !stream.uploading)
+            flags |= EndStreamFlag;
+        appendFrame(offset == 0 ? HeadersFrame : ContinuationFrame, flags, stream.id,
+                    block.constData() + offset, size);
+        offset += size;
+    } while (offset < block.size());
+
+    streams.insert(stream.id, stream);
+    if (stream.uploading)
+        sendUploadData(stream.id);
+}
+
+void QHttp2ProtocolHandler::sendUploadData(quint32 streamId)
+{
+    QHash<quint32, Stream>::iterator it = streams.find(streamId);
+    if (it == streams.end())
+        return;
+    Stream &stream = *it;
+    QNonContiguousByteDevice *uploadByteDevice = stream.request.uploadByteDevice();
+
+    bool progressed = false;
+    bool prematureEnd = false;
+    while (stream.uploaded < stream.uploadTotal) {
+        // don't run ahead of the socket, we are called again on bytesWritten()
+        if (socket->bytesToWrite() > 0)
+            break;
+        const qint64 window = qMin(stream.sendWindow, sessionSendWindow);
+        if (window <= 0)
+            break;
+
+        const qint64 chunk = qMin(qMin<qint64>(window, peerMaxFrameSize), stream.uploadTotal - stream.uploaded);
+        qint64 available = 0;
+        const char *data = uploadByteDevice->readPointer(chunk, available);
+        if (available == -1) {
+            prematureEnd = true;
+            break;
+        }
+        if (!data || available == 0)
+            break; // we are called again on readyRead()
+        available = qMin(available, chunk);
+
+        stream.uploaded += available;
+        stream.sendWindow -= available;
+        sessionSendWindow -= available;
+        const bool last = stream.uploaded == stream.uploadTotal;
+        appendFrame(DataFrame, last ? EndStreamFlag : NoFlags, stream.id, data, available);
+        uploadByteDevice->advanceReadPointer(available);
+        progressed = true;
+
+        if (outgoing.size() >= 4 * DefaultMaxFrameSize)
+            flushOutgoing();
+    }
+
+    if (stream.uploaded == stream.uploadTotal && stream.uploading) {
+        stream.uploading = false;
+        disconnectUpload(stream);
+    }
+
+    // the stream might be gone after emitting signals
+    QPointer<QHttpNetworkReply> reply = stream.reply;
+    const qint64 uploaded = stream.uploaded;
+    const qint64 uploadTotal = stream.uploadTotal;
+
+    if (prematureEnd) {
+        streamError(streamId, InternalError, QNetworkReply::UnknownNetworkError,
+                    QCoreApplication::translate("QHttp", "Upload data ended prematurely"));
+        return;
+    }
+    if (progressed && reply)
+        emit reply->dataSendProgress(uploaded, uploadTotal);
+}
+
+void QHttp2ProtocolHandler::_q_uploadDataReadyRead()
+{
+    sendRequests();
+}
+
+void QHttp2ProtocolHandler::receiveReply()
+{
+    // the connection is being destructed, see QHttpNetworkConnectionChannel::_q_receiveReply()
+    if (!qobject_cast<QHttpNetworkConnection*>(channel->connection))
+        return;
+
+    forever {
+        if (frameHeaderRead < FrameHeaderSize) {
+            const qint64 haveRead = socket->read(frameHeader + frameHeaderRead, FrameHeaderSize - frameHeaderRead);
+            if (haveRead <= 0)
+                break;
+            frameHeaderRead += haveRead;
+            if (frameHeaderRead < FrameHeaderSize)
+                break;
+
+            const int length = (uchar(frameHeader[0]) << 16) | (uchar(frameHeader[1]) << 8) | uchar(frameHeader[2]);
+            frameType = frameHeader[3];
+            frameFlags = frameHeader[4];
+            frameStreamId = readUInt32(frameHeader + 5) & MaxStreamId;
+            // we never raised SETTINGS_MAX_FRAME_SIZE
+            if (length > DefaultMaxFrameSize) {
+                connectionError(FrameSizeError, "frame too large");
+                return;
+            }
+            framePayload.resize(length);
+            framePayloadRead = 0;
+        }
+
+        if (framePayloadRead < framePayload.size()) {
+            const qint64 haveRead = socket->read(framePayload.data() + framePayloadRead,
+                                                 framePayload.size() - framePayloadRead);
+            if (haveRead <= 0)
+                break;
+            framePayloadRead += haveRead;
+            if (framePayloadRead < framePayload.size())
+                break;
+        }
+
+        frameHeaderRead = 0;
+        if (!handleFrame())
+            return;
+    }
+
+    // new streams might be possible and uploads might continue now
+    sendRequests();
+}
+
+bool QHttp2ProtocolHandler::handleFrame()
+{
+    // the server preface is a SETTINGS frame
+    if (!settingsReceived && frameType != SettingsFrame) {
+        connectionError(ProtocolError, "expected SETTINGS");
+        return false;
+    }
+    // a header block must not be interrupted by any other frame
+    if (continuedStreamId && frameType != ContinuationFrame) {
+        connectionError(ProtocolError, "expected CONTINUATION");
+        return false;
+    }
+
+    switch (frameType) {
+    case DataFrame:
+        return handleData();
+    case HeadersFrame:
+        return handleHeaders();
+    case PriorityFrame:
+        return true; // we don't prioritize, nothing is sent by the server this way either
+    case RstStreamFrame:
+        return handleRstStream();
+    case SettingsFrame:
+        return handleSettings();
+    case PushPromiseFrame:
+        connectionError(ProtocolError, "server push is disabled");
+        return false;
+    case PingFrame:
+        return handlePing();
+    case GoawayFrame:
+        return handleGoaway();
+    case WindowUpdateFrame:
+        return handleWindowUpdate();
+    case ContinuationFrame:
+        return handleContinuation();
+    default:
+        return true; // unknown frame types are ignored
+    }
+}
+
+bool QHttp2ProtocolHandler::handleData()
+{
+    if (frameStreamId == 0) {
+        connectionError(ProtocolError, "DATA on stream 0");
+        return false;
+    }
+
+    // flow control covers the whole payload, padding included
+    const qint32 length = framePayload.size();
+    if (length > sessionRecvWindow) {
+        connectionError(FlowControlError, "connection window exceeded");
+        return false;
+    }
+    sessionRecvWindow -= length;
+    sessionConsumed += length;
+    if (sessionConsumed >= SessionReceiveWindow / 2) {
+        appendWindowUpdate(0, sessionConsumed);
+        sessionRecvWindow += sessionConsumed;
+        sessionConsumed = 0;
+    }
+
+    int offset;
+    int size;
+    if (!unpaddedRange(framePayload, frameFlags, &offset, &size)) {
+        connectionError(ProtocolError, "invalid padding");
+        return false;
+    }
+
+    const quint32 streamId = frameStreamId;
+    QHash<quint32, Stream>::iterator it = streams.find(streamId);
+    if (it == streams.end()) {
+        // data still in flight for a stream we reset is fine
+        if (streamId >= nextStreamId) {
+            connectionError(ProtocolError, "DATA on idle stream");
+            return false;
+        }
+        return true;
+    }
+    Stream &stream = *it;
+    if (!stream.headersReceived) {
+        streamError(streamId, ProtocolError, QNetworkReply::ProtocolFailure,
+                    QCoreApplication::translate("QHttp", "Data received before the response headers"));
+        return true;
+    }
+    if (length > stream.recvWindow) {
+        streamError(streamId, FlowControlError, QNetworkReply::ProtocolFailure,
+                    QCoreApplication::translate("QHttp", "Stream window exceeded"));
+        return true;
+    }
+    stream.recvWindow -= length;
+    stream.consumed += length;
+
+    QPointer<QHttpNetworkReply> reply = stream.reply;
+    if (reply && size > 0) {
+        QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+        const QByteArray data = (offset == 0 && size == length) ? framePayload : framePayload.mid(offset, size);
+#ifndef QT_NO_COMPRESS
+        if (replyPrivate->autoDecompress) {
+            QByteDataBuffer in;
+            QByteDataBuffer out;
+            in.append(data);
+            if (replyPrivate->uncompressBodyData(&in, &out) < 0) {
+                streamError(streamId, InternalError, QNetworkReply::ProtocolFailure,
+                            QCoreApplication::translate("QHttp", "Data corrupted"));
+                return true;
+            }
+            replyPrivate->responseData.append(out);
+        } else
+#endif
+        {
+            replyPrivate->responseData.append(data);
+        }
+        replyPrivate->totalProgress += size;
+        emit reply->readyRead();
+        if (reply)
+            emit reply->dataReadProgress(replyPrivate->totalProgress, replyPrivate->bodyLength);
+    }
+
+    // the slots might have removed the reply, and its stream with it
+    it = streams.find(streamId);
+    if (it == streams.end())
+        return true;
+    if (frameFlags & EndStreamFlag)
+        finishStream(streamId);
+    else
+        updateStreamWindow(*it, false);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleHeaders()
+{
+    if (frameStreamId == 0) {
+        connectionError(ProtocolError, "HEADERS on stream 0");
+        return false;
+    }
+
+    int offset;
+    int size;
+    if (!unpaddedRange(framePayload, frameFlags, &offset, &size)) {
+        connectionError(ProtocolError, "invalid padding");
+        return false;
+    }
+    if (frameFlags & PriorityFlag) {
+        // stream dependency and weight, which are of no use to a client
+        if (size < 5) {
+            connectionError(FrameSizeError, "HEADERS too short");
+            return false;
+        }
+        offset += 5;
+        size -= 5;
+    }
+
+    headerBlock = framePayload.mid(offset, size);
+    if (frameFlags & EndHeadersFlag)
+        return handleHeaderBlock(frameStreamId, frameFlags & EndStreamFlag);
+
+    continuedStreamId = frameStreamId;
+    continuedEndStream = frameFlags & EndStreamFlag;
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleContinuation()
+{
+    if (!continuedStreamId || frameStreamId != continuedStreamId) {
+        connectionError(ProtocolError, "unexpected CONTINUATION");
+        return false;
+    }
+    if (headerBlock.size() + framePayload.size() > MaxHeaderBlockSize) {
+        connectionError(EnhanceYourCalmError, "header block too large");
+        return false;
+    }
+
+    headerBlock += framePayload;
+    if (!(frameFlags & EndHeadersFlag))
+        return true;
+
+    const quint32 streamId = continuedStreamId;
+    continuedStreamId = 0;
+    return handleHeaderBlock(streamId, continuedEndStream);
+}
+
+bool QHttp2ProtocolHandler::handleHeaderBlock(quint32 streamId, bool endStream)
+{
+    // decoded even for streams we don't care about anymore, the HPACK
+    // context is shared by the whole connection
+    QHPackHeaderList headers;
+    const bool decoded = decoder.decode(headerBlock.constData(), headerBlock.size(), &headers);
+    headerBlock.clear();
+    if (!decoded) {
+        connectionError(CompressionError, "header block can't be decoded");
+        return false;
+    }
+
+    QHash<quint32, Stream>::iterator it = streams.find(streamId);
+    if (it == streams.end()) {
+        if (streamId >= nextStreamId) {
+            connectionError(ProtocolError, "HEADERS on idle stream");
+            return false;
+        }
+        return true;
+    }
+    Stream &stream = *it;
+    QPointer<QHttpNetworkReply> reply = stream.reply;
+    if (!reply) {
+        disconnectUpload(stream);
+        streams.erase(it);
+        appendRstStream(streamId, CancelError);
+        return true;
+    }
+
+    if (stream.headersReceived) {
+        // trailers, nothing we would pass on
+        if (endStream)
+            finishStream(streamId);
+        else
+            streamError(streamId, ProtocolError, QNetworkReply::ProtocolFailure,
+                        QCoreApplication::translate("QHttp", "Invalid HTTP response header"));
+        return true;
+    }
+
+    int statusCode = -1;
+    bool malformed = false;
+    QList<QPair<QByteArray, QByteArray> > fields;
+    for (int i = 0; i < headers.size(); ++i) {
+        const QHPackHeaderField &field = headers.at(i);
+        if (field.first.startsWith(':')) {
+            // :status is the only pseudo-header of a response, and it comes first
+            if (field.first != ":status" || statusCode != -1 || !fields.isEmpty()) {
+                malformed = true;
+                break;
+            }
+            bool ok;
+            statusCode = field.second.toInt(&ok);
+            if (!ok || field.second.size() != 3)
+                malformed = true;
+        } else {
+            fields.append(field);
+        }
+    }
+    if (malformed || statusCode == -1 || (statusCode < 200 && endStream)) {
+        streamError(streamId, ProtocolError, QNetworkReply::ProtocolFailure,
+                    QCoreApplication::translate("QHttp", "Invalid HTTP response header"));
+        return true;
+    }
+    if (statusCode < 200)
+        return true; // informational, the final response follows
+
+    stream.headersReceived = true;
+
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    replyPrivate->statusCode = statusCode;
+    replyPrivate->majorVersion = 2;
+    replyPrivate->minorVersion = 0;
+    replyPrivate->fields = fields;
+    replyPrivate->state = QHttpNetworkReplyPrivate::ReadingDataState;
+    replyPrivate->bodyLength = replyPrivate->contentLength();
+    replyPrivate->chunkedTransferEncoding = false;
+    replyPrivate->connectionCloseEnabled = false;
+    if (replyPrivate->autoDecompress && replyPrivate->isCompressed()) {
+        replyPrivate->removeAutoDecompressHeader();
+#ifndef QT_NO_COMPRESS
+        delete replyPrivate->decompressor;
+        replyPrivate->decompressor = new QDecompressor(QDecompressor::AutoDetectFormat);
+#endif
+    } else {
+        replyPrivate->autoDecompress = false;
+    }
+
+    emit reply->headerChanged();
+
+    if (endStream && streams.contains(streamId))
+        finishStream(streamId);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleRstStream()
+{
+    if (frameStreamId == 0) {
+        connectionError(ProtocolError, "RST_STREAM on stream 0");
+        return false;
+    }
+    if (framePayload.size() != 4) {
+        connectionError(FrameSizeError, "invalid RST_STREAM");
+        return false;
+    }
+
+    QHash<quint32, Stream>::iterator it = streams.find(frameStreamId);
+    if (it == streams.end()) {
+        if (frameStreamId >= nextStreamId) {
+            connectionError(ProtocolError, "RST_STREAM on idle stream");
+            return false;
+        }
+        return true;
+    }
+
+    const quint32 errorCode = readUInt32(framePayload.constData());
+    Stream stream = *it;
+    streams.erase(it);
+    disconnectUpload(stream);
+
+    if (errorCode == RefusedStreamError) {
+        // the server did not process anything, it is safe to try again
+        requeueStream(stream);
+    } else if (stream.reply) {
+        const QString errorString = QCoreApplication::translate("QHttp", "Stream reset by the server (error %1)").arg(errorCode);
+        stream.reply->d_func()->errorString = errorString;
+        emit stream.reply->finishedWithError(QNetworkReply::ProtocolFailure, errorString);
+    }
+    closeIfIdle();
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleSettings()
+{
+    if (frameStreamId != 0) {
+        connectionError(ProtocolError, "SETTINGS on a stream");
+        return false;
+    }
+    if (frameFlags & AckFlag) {
+        if (!framePayload.isEmpty()) {
+            connectionError(FrameSizeError, "SETTINGS ACK with payload");
+            return false;
+        }
+        return true;
+    }
+    if (framePayload.size() % 6) {
+        connectionError(FrameSizeError, "invalid SETTINGS");
+        return false;
+    }
+
+    const char *data = framePayload.constData();
+    for (int i = 0; i < framePayload.size(); i += 6) {
+        const quint16 id = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(data + i));
+        const quint32 value = readUInt32(data + i + 2);
+        switch (id) {
+        case HeaderTableSizeSetting:
+            encoder.setMaxTableSize(value);
+            break;
+        case EnablePushSetting:
+            if (value > 1) {
+                connectionError(ProtocolError, "invalid SETTINGS_ENABLE_PUSH");
+                return false;
+            }
+            break;
+        case MaxConcurrentStreamsSetting:
+            maxConcurrentStreams = value;
+            break;
+        case InitialWindowSizeSetting: {
+            if (value > quint32(MaxWindowSize)) {
+                connectionError(FlowControlError, "invalid SETTINGS_INITIAL_WINDOW_SIZE");
+                return false;
+            }
+            // applies to the open streams too, with what they already used
+            const qint64 delta = qint64(value) - peerInitialWindowSize;
+            for (QHash<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it) {
+                it->sendWindow += delta;
+                if (it->sendWindow > MaxWindowSize) {
+                    connectionError(FlowControlError, "stream window too large");
+                    return false;
+                }
+            }
+            peerInitialWindowSize = value;
+            break;
+        }
+        case MaxFrameSizeSetting:
+            if (value < DefaultMaxFrameSize || value > 0xffffff) {
+                connectionError(ProtocolError, "invalid SETTINGS_MAX_FRAME_SIZE");
+                return false;
+            }
+            peerMaxFrameSize = value;
+            break;
+        default:
+            break; // SETTINGS_MAX_HEADER_LIST_SIZE is advisory, unknown ones are ignored
+        }
+    }
+
+    settingsReceived = true;
+    appendFrame(SettingsFrame, AckFlag, 0, 0, 0);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handlePing()
+{
+    if (frameStreamId != 0) {
+        connectionError(ProtocolError, "PING on a stream");
+        return false;
+    }
+    if (framePayload.size() != 8) {
+        connectionError(FrameSizeError, "invalid PING");
+        return false;
+    }
+    if (!(frameFlags & AckFlag))
+        appendFrame(PingFrame, AckFlag, 0, framePayload.constData(), framePayload.size());
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleGoaway()
+{
+    if (frameStreamId != 0) {
+        connectionError(ProtocolError, "GOAWAY on a stream");
+        return false;
+    }
+    if (framePayload.size() < 8) {
+        connectionError(FrameSizeError, "invalid GOAWAY");
+        return false;
+    }
+
+    const quint32 lastStreamId = readUInt32(framePayload.constData()) & MaxStreamId;
+    const quint32 errorCode = readUInt32(framePayload.constData() + 4);
+    goingAway = true;
+
+    QList<quint32> ids = streams.keys();
+    qSort(ids);
+    for (int i = 0; i < ids.size(); ++i) {
+        QHash<quint32, Stream>::iterator it = streams.find(ids.at(i));
+        if (it == streams.end())
+            continue;
+        Stream stream = *it;
+        if (stream.id <= lastStreamId && errorCode == NoError)
+            continue; // still being answered
+        streams.erase(it);
+        disconnectUpload(stream);
+        if (stream.id > lastStreamId) {
+            // never processed by the server, send it again on a new connection
+            requeueStream(stream);
+        } else if (stream.reply) {
+            const QString errorString = QCoreApplication::translate("QHttp", "Connection closed by the server (error %1)").arg(errorCode);
+            stream.reply->d_func()->errorString = errorString;
+            emit stream.reply->finishedWithError(QNetworkReply::RemoteHostClosedError, errorString);
+        }
+    }
+
+    closeIfIdle();
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleWindowUpdate()
+{
+    if (framePayload.size() != 4) {
+        connectionError(FrameSizeError, "invalid WINDOW_UPDATE");
+        return false;
+    }
+
+    const quint32 increment = readUInt32(framePayload.constData()) & MaxWindowSize;
+    if (frameStreamId == 0) {
+        if (increment == 0) {
+            connectionError(ProtocolError, "zero WINDOW_UPDATE");
+            return false;
+        }
+        sessionSendWindow += increment;
+        if (sessionSendWindow > MaxWindowSize) {
+            connectionError(FlowControlError, "connection window too large");
+            return false;
+        }
+        return true;
+    }
+
+    QHash<quint32, Stream>::iterator it = streams.find(frameStreamId);
+    if (it == streams.end())
+        return true; // the stream might have been closed meanwhile
+    if (increment == 0 || it->sendWindow + increment > MaxWindowSize) {
+        streamError(frameStreamId, increment ? FlowControlError : ProtocolError, QNetworkReply::ProtocolFailure,
+                    QCoreApplication::translate("QHttp", "Invalid window update"));
+        return true;
+    }
+    it->sendWindow += increment;
+    return true;
+}
+
+bool QHttp2ProtocolHandler::removeReply(QHttpNetworkReply *reply)
+{
+    for (QHash<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it) {
+        if (it->reply == reply) {
+            const quint32 streamId = it->id;
+            disconnectUpload(*it);
+            streams.erase(it);
+            // the server can stop sending, the rest of the connection is not affected
+            if (socket && socket->state() == QAbstractSocket::ConnectedState) {
+                appendRstStream(streamId, CancelError);
+                flushOutgoing();
+            }
+            closeIfIdle();
+            return true;
+        }
+    }
+    return false;
+}
+
+void QHttp2ProtocolHandler::readMoreLater(QHttpNetworkReply *reply)
+{
+    for (QHash<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it) {
+        if (it->reply == reply) {
+            updateStreamWindow(*it, true);
+            flushOutgoing();
+            return;
+        }
+    }
+}
+
+// Gives the window back to the server once half of it is used up,
+// unless the user is not reading (see QHttpNetworkReply::setDownstreamLimited())
+void QHttp2ProtocolHandler::updateStreamWindow(Stream &stream, bool force)
+{
+    if (stream.consumed == 0)
+        return;
+    if (!force) {
+        if (stream.consumed < StreamReceiveWindow / 2)
+            return;
+        QHttpNetworkReply *reply = stream.reply;
+        if (reply) {
+            QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+            if (replyPrivate->downstreamLimited && replyPrivate->readBufferMaxSize
+                && replyPrivate->responseData.byteAmount() >= replyPrivate->readBufferMaxSize)
+                return;
+        }
+    }
+    appendWindowUpdate(stream.id, stream.consumed);
+    stream.recvWindow += stream.consumed;
+    stream.consumed = 0;
+}
+
+void QHttp2ProtocolHandler::handleConnectionClosure(QNetworkReply::NetworkError errorCode,
+                                                    const QString &errorString)
+{
+    QList<quint32> ids = streams.keys();
+    qSort(ids);
+    bool requeued = false;
+    for (int i = 0; i < ids.size(); ++i) {
+        QHash<quint32, Stream>::iterator it = streams.find(ids.at(i));
+        if (it == streams.end())
+            continue;
+        Stream stream = *it;
+        streams.erase(it);
+        disconnectUpload(stream);
+        if (!stream.reply)
+            continue;
+
+        // like for HTTP/1, a request without any response yet is tried again
+        if (!stream.headersReceived && isIdempotent(stream.request) && channel->reconnectAttempts > 0) {
+            requeueStream(stream);
+            requeued = true;
+        } else {
+            stream.reply->d_func()->errorString = errorString;
+            emit stream.reply->finishedWithError(errorCode, errorString);
+        }
+    }
+    if (requeued)
+        channel->reconnectAttempts--;
+}
+
+void QHttp2ProtocolHandler::finishStream(quint32 streamId)
+{
+    Stream stream = streams.take(streamId);
+    disconnectUpload(stream);
+    channel->reconnectAttempts = 2;
+
+    if (QHttpNetworkReply *reply = stream.reply) {
+        reply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
+        // queued for the same reason as in QHttpNetworkConnectionChannel::allDone()
+        QMetaObject::invokeMethod(reply, "finished", Qt::QueuedConnection);
+    }
+    closeIfIdle();
+}
+
+void QHttp2ProtocolHandler::streamError(quint32 streamId, ErrorCode errorCode,
+                                        QNetworkReply::NetworkError replyError, const QString &message)
+{
+    appendRstStream(streamId, errorCode);
+    Stream stream = streams.take(streamId);
+    disconnectUpload(stream);
+    if (stream.reply) {
+        stream.reply->d_func()->errorString = message;
+        emit stream.reply->finishedWithError(replyError, message);
+    }
+    closeIfIdle();
+}
+
+void QHttp2ProtocolHandler::connectionError(ErrorCode errorCode, const char *message)
+{
+    QByteArray payload;
+    appendUInt32(&payload, 0); // the last stream the server opened, it can't open any
+    appendUInt32(&payload, errorCode);
+    appendFrame(GoawayFrame, NoFlags, 0, payload.constData(), payload.size());
+    flushOutgoing();
+    goingAway = true;
+
+    const QString errorString = QCoreApplication::translate("QHttp", "HTTP/2 protocol error: %1")
+            .arg(QLatin1String(message));
+    QList<quint32> ids = streams.keys();
+    qSort(ids);
+    for (int i = 0; i < ids.size(); ++i) {
+        QHash<quint32, Stream>::iterator it = streams.find(ids.at(i));
+        if (it == streams.end())
+            continue;
+        Stream stream = *it;
+        streams.erase(it);
+        disconnectUpload(stream);
+        if (stream.reply) {
+            stream.reply->d_func()->errorString = errorString;
+            emit stream.reply->finishedWithError(QNetworkReply::ProtocolFailure, errorString);
+        }
+    }
+    channel->close();
+}
+
+void QHttp2ProtocolHandler::requeueStream(const Stream &stream)
+{
+    QHttpNetworkReply *reply = stream.reply;
+    if (!reply)
+        return;
+    QNonContiguousByteDevice *uploadByteDevice = stream.request.uploadByteDevice();
+    if (uploadByteDevice && !uploadByteDevice->reset()) {
+        const QString errorString = QCoreApplication::translate("QHttp", "Request could not be resent");
+        reply->d_func()->errorString = errorString;
+        emit reply->finishedWithError(QNetworkReply::ContentReSendError, errorString);
+        return;
+    }
+    reply->d_func()->clearHttpLayerInformation();
+    channel->connection->d_func()->requeueRequest(qMakePair(stream.request, reply));
+}
+
+void QHttp2ProtocolHandler::disconnectUpload(const Stream &stream)
+{
+    if (stream.uploading && stream.request.uploadByteDevice())
+        QObject::disconnect(stream.request.uploadByteDevice(), SIGNAL(readyRead()),
+                            this, SLOT(_q_uploadDataReadyRead()));
+}
+
+void QHttp2ProtocolHandler::closeIfIdle()
+{
+    if (!goingAway || !streams.isEmpty() || !socket)
+        return;
+    if (socket->state() != QAbstractSocket::ConnectedState)
+        return;
+    flushOutgoing();
+    channel->close();
+}
+
+void QHttp2ProtocolHandler::flushOutgoing()
+{
+    if (outgoing.isEmpty() || !socket || socket->state() != QAbstractSocket::ConnectedState
+        || !socket->isValid())
+        return;
+    if (socket->write(outgoing) < 0) {
+        // The unbuffered socket closes its engine on EPIPE/ECONNRESET without
+        // telling anybody, let the channel tear the connection down
+        QMetaObject::invokeMethod(channel, "_q_error", Qt::QueuedConnection,
+                                  Q_ARG(QAbstractSocket::SocketError, socket->error()));
+    }
+    outgoing.clear();
+}
+
+void QHttp2ProtocolHandler::appendFrame(FrameType type, quint8 flags, quint32 streamId,
+                                        const char *payload, int size)
+{
+    char header[FrameHeaderSize];
+    header[0] = char(size >> 16);
+    header[1] = char(size >> 8);
+    header[2] = char(size);
+    header[3] = char(type);
+    header[4] = char(flags);
+    qToBigEndian<quint32>(streamId, reinterpret_cast<uchar *>(header + 5));
+    outgoing.append(header, FrameHeaderSize);
+    if (size)
+        outgoing.append(payload, size);
+}
+
+void QHttp2ProtocolHandler::appendWindowUpdate(quint32 streamId, quint32 increment)
+{
+    QByteArray payload;
+    appendUInt32(&payload, increment);
+    appendFrame(WindowUpdateFrame, NoFlags, streamId, payload.constData(), payload.size());
+}
+
+void QHttp2ProtocolHandler::appendRstStream(quint32 streamId, ErrorCode errorCode)
+{
+    QByteArray payload;
+    appendUInt32(&payload, errorCode);
+    appendFrame(RstStreamFrame, NoFlags, streamId, payload.constData(), payload.size());
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHTTP2PROTOCOLHANDLER_P_H
+#define QHTTP2PROTOCOLHANDLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qobject.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
+#include <QtNetwork/qnetworkreply.h>
+
+#include <private/qhttpnetworkrequest_p.h>
+#include <private/qhpack_p.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+class QHttpNetworkConnectionChannel;
+class QHttpNetworkReply;
+class QAbstractSocket;
+
+// Speaks HTTP/2 (RFC 7540) on the socket of a connection channel, with
+// prior knowledge, i.e. without an upgrade from HTTP/1.1. All requests of
+// the connection are multiplexed as streams over this one socket.
+class QHttp2ProtocolHandler : public QObject
+{
+    Q_OBJECT
+public:
+    enum FrameType {
+        DataFrame = 0x0,
+        HeadersFrame = 0x1,
+        PriorityFrame = 0x2,
+        RstStreamFrame = 0x3,
+        SettingsFrame = 0x4,
+        PushPromiseFrame = 0x5,
+        PingFrame = 0x6,
+        GoawayFrame = 0x7,
+        WindowUpdateFrame = 0x8,
+        ContinuationFrame = 0x9
+    };
+
+    enum FrameFlag {
+        NoFlags = 0x0,
+        EndStreamFlag = 0x1,
+        AckFlag = 0x1,
+        EndHeadersFlag = 0x4,
+        PaddedFlag = 0x8,
+        PriorityFlag = 0x20
+    };
+
+    enum Setting {
+        HeaderTableSizeSetting = 0x1,
+        EnablePushSetting = 0x2,
+        MaxConcurrentStreamsSetting = 0x3,
+        InitialWindowSizeSetting = 0x4,
+        MaxFrameSizeSetting = 0x5,
+        MaxHeaderListSizeSetting = 0x6
+    };
+
+    enum ErrorCode {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeoutError = 0x4,
+        StreamClosedError = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStreamError = 0x7,
+        CancelError = 0x8,
+        CompressionError = 0x9,
+        ConnectError = 0xa,
+        EnhanceYourCalmError = 0xb,
+        InadequateSecurityError = 0xc,
+        Http11RequiredError = 0xd
+    };
+
+    enum {
+        FrameHeaderSize = 9,
+        DefaultMaxFrameSize = 16384,
+        DefaultWindowSize = 65535,
+        MaxWindowSize = 0x7fffffff,
+        MaxStreamId = 0x7fffffff,
+        MaxHeaderBlockSize = 256 * 1024,
+        // what we allow the server to send ahead of our reading
+        StreamReceiveWindow = 1024 * 1024,
+        SessionReceiveWindow = 16 * 1024 * 1024
+    };
+
+    explicit QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel);
+    ~QHttp2ProtocolHandler();
+
+    void start(); // connection preface, once the socket is connected
+    void sendRequests(); // opens streams for queued requests, continues uploads
+    void receiveReply(); // reads and handles the frames available on the socket
+    bool removeReply(QHttpNetworkReply *reply); // false if the reply has no stream here
+    void readMoreLater(QHttpNetworkReply *reply);
+    void handleConnectionClosure(QNetworkReply::NetworkError errorCode, const QString &errorString);
+
+private Q_SLOTS:
+    void _q_uploadDataReadyRead();
+
+private:
+    struct Stream {
+        Stream() : id(0), sendWindow(0), recvWindow(0), consumed(0),
+            uploaded(0), uploadTotal(0), uploading(false), headersReceived(false) {}
+        quint32 id;
+        QHttpNetworkRequest request;
+        QPointer<QHttpNetworkReply> reply;
+        qint64 sendWindow;
+        qint32 recvWindow;
+        qint32 consumed; // received, but not yet given back with a WINDOW_UPDATE
+        qint64 uploaded;
+        qint64 uploadTotal;
+        bool uploading;
+        bool headersReceived;
+    };
+
+    void openStream(const QHttpNetworkRequest &request, QHttpNetworkReply *reply);
+    void sendUploadData(quint32 streamId);
+    void updateStreamWindow(Stream &stream, bool force);
+    void flushOutgoing();
+    void appendFrame(FrameType type, quint8 flags, quint32 streamId, const char *payload, int size);
+    void appendWindowUpdate(quint32 streamId, quint32 increment);
+    void appendRstStream(quint32 streamId, ErrorCode errorCode);
+
+    bool handleFrame();
+    bool handleData();
+    bool handleHeaders();
+    bool handleContinuation();
+    bool handleHeaderBlock(quint32 streamId, bool endStream);
+    bool handleRstStream();
+    bool handleSettings();
+    bool handlePing();
+    bool handleGoaway();
+    bool handleWindowUpdate();
+
+    void connectionError(ErrorCode errorCode, const char *message);
+    void streamError(quint32 streamId, ErrorCode errorCode, QNetworkReply::NetworkError replyError,
+                     const QString &message);
+    void finishStream(quint32 streamId);
+    void requeueStream(const Stream &stream);
+    void disconnectUpload(const Stream &stream);
+    void closeIfIdle();
+
+    QHttpNetworkConnectionChannel *channel;
+    QAbstractSocket *socket;
+    QHash<quint32, Stream> streams;
+    quint32 nextStreamId;
+    bool goingAway; // no new streams, close once the active ones are done
+    bool settingsReceived;
+
+    QHPackEncoder encoder;
+    QHPackDecoder decoder;
+    QByteArray outgoing;
+
+    // the frame currently being read
+    char frameHeader[FrameHeaderSize];
+    int frameHeaderRead;
+    QByteArray framePayload;
+    int framePayloadRead;
+    quint8 frameType;
+    quint8 frameFlags;
+    quint32 frameStreamId;
+
+    // a header block spread over HEADERS and CONTINUATION frames
+    quint32 continuedStreamId;
+    bool continuedEndStream;
+    QByteArray headerBlock;
+
+    // peer settings and flow control
+    quint32 maxConcurrentStreams;
+    quint32 peerMaxFrameSize;
+    qint32 peerInitialWindowSize;
+    qint64 sessionSendWindow;
+    qint32 sessionRecvWindow;
+    qint32 sessionConsumed;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTP2PROTOCOLHANDLER_P_H
@@ -42,6 +42,7 @@
 #include "qhttpnetworkconnection_p.h"
 #include <private/qabstractsocket_p.h>
 #include "qhttpnetworkconnectionchannel_p.h"
+#include "qhttp2protocolhandler_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 #include <private/qnetworkrequest_p.h>
 #include <private/qobject_p.h>
@@ -77,11 +78,13 @@ const int QHttpNetworkConnectionPrivate::defaultPipelineLength = 3;
 const int QHttpNetworkConnectionPrivate::defaultRePipelineLength = 2;
 
 
-QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName, quint16 port, bool encrypt)
+QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName, quint16 port, bool encrypt,
+                                                             QHttpNetworkConnection::ConnectionType type)
 : state(RunningState),
   networkLayerState(Unknown),
-  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  channelCount(defaultChannelCount)
+  hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true), connectionType(type),
+  // HTTP/2 multiplexes all requests over a single connection
+  channelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2 ? 1 : defaultChannelCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -92,7 +95,7 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
 QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 channelCount, const QString &hostName, quint16 port, bool encrypt)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  channelCount(channelCount)
+  connectionType(QHttpNetworkConnection::ConnectionTypeHTTP), channelCount(channelCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -797,6 +800,12 @@ void QHttpNetworkConnectionPrivate::removeReply(QHttpNetworkReply *reply)
 {
     Q_Q(QHttpNetworkConnection);
 
+    // an HTTP/2 stream is reset, the connection stays
+    if (channels[0].protocolHandler && channels[0].protocolHandler->removeReply(reply)) {
+        QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
+        return;
+    }
+
     // check if the reply is currently being processed or it is pipelined in
     for (int i = 0; i < channelCount; ++i) {
         // is the reply associated the currently processing of this channel?
@@ -898,6 +907,22 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
     // return fast if there is nothing to do
     if (highPriorityQueue.isEmpty() && lowPriorityQueue.isEmpty())
         return;
+
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+        // all requests become streams on the one channel once it is connected
+        QHttpNetworkConnectionChannel &channel = channels[0];
+        if (channel.protocolHandler) {
+            channel.protocolHandler->sendRequests();
+        } else if (!channel.socket || channel.socket->state() == QAbstractSocket::UnconnectedState) {
+            if (networkLayerState == IPv4)
+                channel.networkLayerPreference = QAbstractSocket::IPv4Protocol;
+            else if (networkLayerState == IPv6)
+                channel.networkLayerPreference = QAbstractSocket::IPv6Protocol;
+            channel.ensureConnection();
+        }
+        return;
+    }
+
     // try to get a free AND connected socket
     for (int i = 0; i < channelCount; ++i) {
         if (channels[i].socket) {
@@ -956,6 +981,10 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
 
 void QHttpNetworkConnectionPrivate::readMoreLater(QHttpNetworkReply *reply)
 {
+    if (channels[0].protocolHandler) {
+        channels[0].protocolHandler->readMoreLater(reply);
+        return;
+    }
     for (int i = 0 ; i < channelCount; ++i) {
         if (channels[i].reply ==  reply) {
             // emulate a readyRead() from the socket
@@ -1112,8 +1141,9 @@ void QHttpNetworkConnectionPrivate::_q_connectDelayedChannel()
 }
 
 #ifndef QT_NO_BEARERMANAGEMENT
-QHttpNetworkConnection::QHttpNetworkConnection(const QString &hostName, quint16 port, bool encrypt, QObject *parent, QSharedPointer<QNetworkSession> networkSession)
-    : QObject(*(new QHttpNetworkConnectionPrivate(hostName, port, encrypt)), parent)
+QHttpNetworkConnection::QHttpNetworkConnection(const QString &hostName, quint16 port, bool encrypt, QObject *parent, QSharedPointer<QNetworkSession> networkSession,
+                                               ConnectionType connectionType)
+    : QObject(*(new QHttpNetworkConnectionPrivate(hostName, port, encrypt, connectionType)), parent)
 {
     Q_D(QHttpNetworkConnection);
     d->networkSession = networkSession;
@@ -1128,8 +1158,9 @@ QHttpNetworkConnection::QHttpNetworkConnection(quint16 connectionCount, const QS
     d->init();
 }
 #else
-QHttpNetworkConnection::QHttpNetworkConnection(const QString &hostName, quint16 port, bool encrypt, QObject *parent)
-    : QObject(*(new QHttpNetworkConnectionPrivate(hostName, port, encrypt)), parent)
+QHttpNetworkConnection::QHttpNetworkConnection(const QString &hostName, quint16 port, bool encrypt, QObject *parent,
+                                               ConnectionType connectionType)
+    : QObject(*(new QHttpNetworkConnectionPrivate(hostName, port, encrypt, connectionType)), parent)
 {
     Q_D(QHttpNetworkConnection);
     d->init();
@@ -1171,6 +1202,12 @@ bool QHttpNetworkConnection::isSsl() const
     return d->encrypt;
 }
 
+QHttpNetworkConnection::ConnectionType QHttpNetworkConnection::connectionType() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->connectionType;
+}
+
 QHttpNetworkConnectionChannel *QHttpNetworkConnection::channels() const
 {
     return d_func()->channels;
@@ -94,11 +94,18 @@ class Q_AUTOTEST_EXPORT QHttpNetworkConnection : public QObject
     Q_OBJECT
 public:
 
+    enum ConnectionType {
+        ConnectionTypeHTTP,
+        ConnectionTypeHTTP2 // prior knowledge, all requests multiplexed over one socket
+    };
+
 #ifndef QT_NO_BEARERMANAGEMENT
-    explicit QHttpNetworkConnection(const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0, QSharedPointer<QNetworkSession> networkSession = QSharedPointer<QNetworkSession>());
+    explicit QHttpNetworkConnection(const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0, QSharedPointer<QNetworkSession> networkSession = QSharedPointer<QNetworkSession>(),
+                                    ConnectionType connectionType = ConnectionTypeHTTP);
     QHttpNetworkConnection(quint16 channelCount, const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0, QSharedPointer<QNetworkSession> networkSession = QSharedPointer<QNetworkSession>());
 #else
-    explicit QHttpNetworkConnection(const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0);
+    explicit QHttpNetworkConnection(const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0,
+                                    ConnectionType connectionType = ConnectionTypeHTTP);
     QHttpNetworkConnection(quint16 channelCount, const QString &hostName, quint16 port = 80, bool encrypt = false, QObject *parent = 0);
 #endif
     ~QHttpNetworkConnection();
@@ -121,6 +128,8 @@ public:
 
     bool isSsl() const;
 
+    ConnectionType connectionType() const;
+
     QHttpNetworkConnectionChannel *channels() const;
 
 #ifndef QT_NO_SSL
@@ -137,6 +146,7 @@ private:
     friend class QHttpNetworkReply;
     friend class QHttpNetworkReplyPrivate;
     friend class QHttpNetworkConnectionChannel;
+    friend class QHttp2ProtocolHandler;
 
     Q_PRIVATE_SLOT(d_func(), void _q_startNextRequest())
     Q_PRIVATE_SLOT(d_func(), void _q_hostLookupFinished(QHostInfo))
@@ -168,7 +178,8 @@ public:
         IPv6
     };
 
-    QHttpNetworkConnectionPrivate(const QString &hostName, quint16 port, bool encrypt);
+    QHttpNetworkConnectionPrivate(const QString &hostName, quint16 port, bool encrypt,
+                                  QHttpNetworkConnection::ConnectionType type);
     QHttpNetworkConnectionPrivate(quint16 channelCount, const QString &hostName, quint16 port, bool encrypt);
     ~QHttpNetworkConnectionPrivate();
     void init();
@@ -217,6 +228,7 @@ public:
     quint16 port;
     bool encrypt;
     bool delayIpv4;
+    QHttpNetworkConnection::ConnectionType connectionType;
 
     const int channelCount;
     QTimer delayedConnectionTimer;
@@ -41,7 +41,9 @@
 
 #include "qhttpnetworkconnectionchannel_p.h"
 #include "qhttpnetworkconnection_p.h"
+#include "qhttp2protocolhandler_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
+#include "private/qabstractsocket_p.h"
 
 #include <qpair.h>
 #include <qdebug.h>
@@ -82,6 +84,7 @@ QHttpNetworkConnectionChannel::QHttpNetworkConnectionChannel()
     , ignoreAllSslErrors(false)
 #endif
     , pipeliningSupported(PipeliningSupportUnknown)
+    , protocolHandler(0)
     , networkLayerPreference(QAbstractSocket::AnyIPProtocol)
     , connection(0)
 {
@@ -272,6 +275,42 @@ bool QHttpNetworkConnectionChannel::sendRequest()
             break;
         }
 
+        if (request.uploadFileDescriptor() != -1) {
+            // The upload data is a plain file: once the header has left the socket's
+            // write buffer, send the body from the file without copying it around.
+            const qint64 socketFileWriteMaxSize = 1024*1024;
+            QAbstractSocketPrivate *socketPrivate = static_cast<QAbstractSocketPrivate *>(QObjectPrivate::get(socket));
+            while (socket->bytesToWrite() == 0 && bytesTotal != written) {
+                qint64 currentWriteSize = socketPrivate->sendFile(request.uploadFileDescriptor(),
+                                                                  request.uploadFileOffset() + written,
+                                                                  qMin(socketFileWriteMaxSize, bytesTotal - written));
+                if (currentWriteSize == -2 && written == 0) {
+                    // not possible with this socket (e.g. a SOCKS proxy), use the byte device
+                    request.setUploadFileDescriptor(-1, 0);
+                    break;
+                } else if (currentWriteSize < 0) {
+                    connection->d_func()->emitReplyError(socket, reply, QNetworkReply::UnknownNetworkError);
+                    return false;
+                } else if (currentWriteSize == 0) {
+                    // socket is full, _q_bytesWritten will call us again
+                    break;
+                }
+
+                written += currentWriteSize;
+                // the byte device only does the progress reporting here
+                uploadByteDevice->advanceReadPointer(currentWriteSize);
+                emit reply->dataSendProgress(written, bytesTotal);
+
+                if (written == bytesTotal) {
+                    state = QHttpNetworkConnectionChannel::WaitingState;
+                    sendRequest();
+                    return true;
+                }
+            }
+            if (request.uploadFileDescriptor() != -1)
+                break;
+        }
+
         // only feed the QTcpSocket buffer when there is less than 32 kB in it
         const qint64 socketBufferFill = 32*1024;
         const qint64 socketWriteMaxSize = 16*1024;
@@ -462,7 +501,21 @@ void QHttpNetworkConnectionChannel::_q_receiveReply()
                return;
            }
 
-           if (replyPrivate->userProvidedDownloadBuffer) {
+           if (replyPrivate->downloadFileDescriptor != -1) {
+               // the body goes straight into a file, the user only gets progress signals
+               qint64 haveRead = replyPrivate->readBodyToFile(socket);
+               if (haveRead > 0) {
+                   bytes += haveRead;
+                   replyPrivate->totalProgress += haveRead;
+                   emit reply->dataReadProgress(replyPrivate->totalProgress, replyPrivate->bodyLength);
+               } else if (haveRead < 0) {
+                   // the socket has been aborted, fail the reply before the queued _q_error() arrives
+                   connection->d_func()->emitReplyError(socket, reply,
+                       socket->error() == QAbstractSocket::RemoteHostClosedError
+                       ? QNetworkReply::RemoteHostClosedError : QNetworkReply::UnknownNetworkError);
+                   return;
+               }
+           } else if (replyPrivate->userProvidedDownloadBuffer) {
                // the user provided a direct buffer where we should put all our data in.
                // this only works when we can tell the user the content length and he/she can allocate
                // the buffer in that size.
@@ -987,6 +1040,15 @@ void QHttpNetworkConnectionChannel::_q_readyRead()
         }
     }
 
+    if (protocolHandler) {
+        protocolHandler->receiveReply();
+        // a failed read on the unbuffered socket resets it silently
+        if (protocolHandler && state != QHttpNetworkConnectionChannel::ClosingState
+            && socket->state() != QAbstractSocket::ConnectedState)
+            _q_error(socket->error());
+        return;
+    }
+
     if (isSocketWaiting() || isSocketReading()) {
         state = QHttpNetworkConnectionChannel::ReadingState;
         if (reply)
@@ -997,6 +1059,10 @@ void QHttpNetworkConnectionChannel::_q_readyRead()
 void QHttpNetworkConnectionChannel::_q_bytesWritten(qint64 bytes)
 {
     Q_UNUSED(bytes);
+    if (protocolHandler) {
+        protocolHandler->sendRequests();
+        return;
+    }
     // bytes have been written to the socket. write even more of them :)
     if (isSocketWriting())
         sendRequest();
@@ -1005,6 +1071,16 @@ void QHttpNetworkConnectionChannel::_q_bytesWritten(qint64 bytes)
 
 void QHttpNetworkConnectionChannel::_q_disconnected()
 {
+    if (protocolHandler) {
+        // read the frames still available before giving up on the streams
+        protocolHandler->receiveReply();
+        closeProtocolHandler(QNetworkReply::RemoteHostClosedError,
+                             connection->d_func()->errorDetail(QNetworkReply::RemoteHostClosedError, socket));
+        state = QHttpNetworkConnectionChannel::IdleState;
+        QMetaObject::invokeMethod(connection, "_q_startNextRequest", Qt::QueuedConnection);
+        return;
+    }
+
     if (state == QHttpNetworkConnectionChannel::ClosingState) {
         state = QHttpNetworkConnectionChannel::IdleState;
         QMetaObject::invokeMethod(connection, "_q_startNextRequest", Qt::QueuedConnection);
@@ -1084,6 +1160,14 @@ void QHttpNetworkConnectionChannel::_q_connected()
 #endif
     } else {
         state = QHttpNetworkConnectionChannel::IdleState;
+        if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2) {
+            // with prior knowledge the connection speaks HTTP/2 from the first byte
+            delete protocolHandler;
+            protocolHandler = new QHttp2ProtocolHandler(this);
+            protocolHandler->start();
+            protocolHandler->sendRequests();
+            return;
+        }
         if (!reply)
             connection->d_func()->dequeueRequest(socket);
         if (reply)
@@ -1184,6 +1268,15 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
     if (!connection->d_func()->shouldEmitChannelError(socket))
         return;
 
+    // All streams of an HTTP/2 connection fail (or are sent again) together
+    if (protocolHandler) {
+        closeProtocolHandler(errorCode, errorString);
+        QMetaObject::invokeMethod(that, "_q_startNextRequest", Qt::QueuedConnection);
+        if (that)
+            close();
+        return;
+    }
+
     // Need to dequeu the request so that we can emit the error.
     if (!reply)
         connection->d_func()->dequeueRequest(socket);
@@ -1256,6 +1349,16 @@ void QHttpNetworkConnectionChannel::_q_encryptedBytesWritten(qint64 bytes)
 
 #endif
 
+void QHttpNetworkConnectionChannel::closeProtocolHandler(QNetworkReply::NetworkError errorCode,
+                                                         const QString &errorString)
+{
+    // the handler might be on the stack
+    QHttp2ProtocolHandler *handler = protocolHandler;
+    protocolHandler = 0;
+    handler->handleConnectionClosure(errorCode, errorString);
+    handler->deleteLater();
+}
+
 void QHttpNetworkConnectionChannel::setConnection(QHttpNetworkConnection *c)
 {
     // Inlining this function in the header leads to compiler error on
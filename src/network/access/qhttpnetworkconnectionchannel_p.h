@@ -82,6 +82,7 @@ QT_BEGIN_NAMESPACE
 class QHttpNetworkRequest;
 class QHttpNetworkReply;
 class QByteArray;
+class QHttp2ProtocolHandler;
 
 #ifndef HttpMessagePair
 typedef QPair<QHttpNetworkRequest, QHttpNetworkReply*> HttpMessagePair;
@@ -143,6 +144,11 @@ public:
     void requeueCurrentlyPipelinedRequests();
     void detectPipeliningSupport();
 
+    // for QHttpNetworkConnection::ConnectionTypeHTTP2, while the socket is connected;
+    // request and reply above are not used then
+    QHttp2ProtocolHandler *protocolHandler;
+    void closeProtocolHandler(QNetworkReply::NetworkError errorCode, const QString &errorString);
+
     QHttpNetworkConnectionChannel();
 
     QAbstractSocket::NetworkLayerProtocol networkLayerPreference;
@@ -39,10 +39,10 @@
 **
 ****************************************************************************/
 
+#include "qplatformdefs.h"
 #include "qhttpnetworkreply_p.h"
 #include "qhttpnetworkconnection_p.h"
-
-#include <qbytearraymatcher.h>
+#include "private/qabstractsocket_p.h"
 
 #ifndef QT_NO_HTTP
 
@@ -53,7 +53,7 @@
 #endif
 
 #ifndef QT_NO_COMPRESS
-#include <zlib.h>
+#include <private/qcompressor_p.h>
 #endif
 
 QT_BEGIN_NAMESPACE
@@ -69,11 +69,6 @@ QHttpNetworkReply::~QHttpNetworkReply()
     if (d->connection) {
         d->connection->d_func()->removeReply(this);
     }
-
-#ifndef QT_NO_COMPRESS
-    if (d->autoDecompress && d->isCompressed() && d->inflateStrm)
-        inflateEnd(d->inflateStrm);
-#endif
 }
 
 QUrl QHttpNetworkReply::url() const
@@ -239,7 +234,8 @@ void QHttpNetworkReply::setReadBufferSize(qint64 size)
 bool QHttpNetworkReply::supportsUserProvidedDownloadBuffer()
 {
     Q_D(QHttpNetworkReply);
-    return (!d->isChunked() && !d->autoDecompress && d->bodyLength > 0 && d->statusCode == 200);
+    // the HTTP/2 streams of a connection are read interleaved, only through responseData
+    return (!d->http2Used && !d->isChunked() && !d->autoDecompress && d->bodyLength > 0 && d->statusCode == 200);
 }
 
 void QHttpNetworkReply::setUserProvidedDownloadBuffer(char* b)
@@ -255,6 +251,21 @@ char* QHttpNetworkReply::userProvidedDownloadBuffer()
     return d->userProvidedDownloadBuffer;
 }
 
+// The body is written to the file instead of being made available through read().
+// Has the same requirements as the user provided download buffer.
+void QHttpNetworkReply::setDownloadFileDescriptor(int fd)
+{
+    Q_D(QHttpNetworkReply);
+    if (supportsUserProvidedDownloadBuffer())
+        d->downloadFileDescriptor = fd;
+}
+
+int QHttpNetworkReply::downloadFileDescriptor() const
+{
+    Q_D(const QHttpNetworkReply);
+    return d->downloadFileDescriptor;
+}
+
 bool QHttpNetworkReply::isFinished() const
 {
     return d_func()->state == QHttpNetworkReplyPrivate::AllDoneState;
@@ -265,6 +276,11 @@ bool QHttpNetworkReply::isPipeliningUsed() const
     return d_func()->pipeliningUsed;
 }
 
+bool QHttpNetworkReply::isHttp2Used() const
+{
+    return d_func()->http2Used;
+}
+
 QHttpNetworkConnection* QHttpNetworkReply::connection()
 {
     return d_func()->connection;
@@ -283,10 +299,11 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       lastChunkRead(false),
       currentChunkSize(0), currentChunkRead(0), readBufferMaxSize(0), connection(0),
       autoDecompress(false), responseData(), requestIsPrepared(false)
-      ,pipeliningUsed(false), downstreamLimited(false)
+      ,pipeliningUsed(false), http2Used(false), downstreamLimited(false)
       ,userProvidedDownloadBuffer(0)
+      ,downloadFileDescriptor(-1)
 #ifndef QT_NO_COMPRESS
-      ,inflateStrm(0)
+      ,decompressor(0)
 #endif
 
 {
@@ -295,8 +312,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
 QHttpNetworkReplyPrivate::~QHttpNetworkReplyPrivate()
 {
 #ifndef QT_NO_COMPRESS
-      if (inflateStrm)
-          delete inflateStrm;
+    delete decompressor;
 #endif
 }
 
@@ -312,8 +328,8 @@ void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
     lastChunkRead = false;
     connectionCloseEnabled = true;
 #ifndef QT_NO_COMPRESS
-    if (autoDecompress && inflateStrm)
-        inflateEnd(inflateStrm);
+    delete decompressor;
+    decompressor = 0;
 #endif
     fields.clear();
 }
@@ -394,6 +410,28 @@ QAuthenticatorPrivate::Method QHttpNetworkReplyPrivate::authenticationMethod(boo
     return method;
 }
 
+// Appends the rest of the current line, or as much of it as has been
+// received, to \a fragment. Returns the number of bytes read, 0 if there
+// is nothing to read yet and -1 if the connection has been closed.
+static qint64 readLineInto(QAbstractSocket *socket, QByteArray &fragment)
+{
+    const qint64 available = socket->bytesAvailable();
+    if (available <= 0)
+        return socket->state() == QAbstractSocket::ConnectedState ? 0 : -1;
+
+    const int oldSize = fragment.size();
+    // one more byte for the '\0' written by readLine()
+    fragment.resize(oldSize + int(qMin(available, qint64(16 * 1024))) + 1);
+    const qint64 haveRead = socket->readLine(fragment.data() + oldSize, fragment.size() - oldSize);
+    fragment.resize(oldSize + int(qMax(haveRead, qint64(0))));
+    return haveRead;
+}
+
+static inline bool isLWS(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
 qint64 QHttpNetworkReplyPrivate::readStatus(QAbstractSocket *socket)
 {
     if (fragment.isEmpty()) {
@@ -402,26 +440,37 @@ qint64 QHttpNetworkReplyPrivate::readStatus(QAbstractSocket *socket)
     }
 
     qint64 bytes = 0;
-    char c;
-    qint64 haveRead = 0;
-
-    do {
-        haveRead = socket->read(&c, 1);
+    forever {
+        const int oldSize = fragment.size();
+        const qint64 haveRead = readLineInto(socket, fragment);
         if (haveRead == -1)
             return -1; // unexpected EOF
         else if (haveRead == 0)
             break; // read more later
-        else if (haveRead == 1 && fragment.size() == 0 && (c == 11 || c == '\n' || c == '\r' || c == ' ' || c == 31))
-            continue; // Ignore all whitespace that was trailing froma previous request on that socket
+        bytes += haveRead;
 
-        bytes++;
+        if (oldSize == 0) {
+            // Ignore all whitespace that was trailing froma previous request on that socket
+            int skip = 0;
+            while (skip < fragment.size() && (isLWS(fragment.at(skip)) || fragment.at(skip) == 31))
+                ++skip;
+            if (skip) {
+                fragment.remove(0, skip);
+                bytes -= skip;
+                if (fragment.isEmpty())
+                    continue;
+            }
+        }
+
+        // is this a valid reply?
+        if (fragment.length() >= 5 && !fragment.startsWith("HTTP/")) {
+            fragment.clear();
+            return -1;
+        }
 
         // allow both CRLF & LF (only) line endings
-        if (c == '\n') {
-            // remove the CR at the end
-            if (fragment.endsWith('\r')) {
-                fragment.truncate(fragment.length()-1);
-            }
+        if (fragment.endsWith('\n')) {
+            fragment.chop(fragment.endsWith("\r\n") ? 2 : 1);
             bool ok = parseStatus(fragment);
             state = ReadingHeaderState;
             fragment.clear();
@@ -429,17 +478,8 @@ qint64 QHttpNetworkReplyPrivate::readStatus(QAbstractSocket *socket)
                 return -1;
             }
             break;
-        } else {
-            fragment.append(c);
         }
-
-        // is this a valid reply?
-        if (fragment.length() >= 5 && !fragment.startsWith("HTTP/"))
-        {
-            fragment.clear();
-            return -1;
-        }
-    } while (haveRead == 1);
+    }
 
     return bytes;
 }
@@ -469,13 +509,21 @@ bool QHttpNetworkReplyPrivate::parseStatus(const QByteArray &status)
     majorVersion = status.at(dotPos - 1) - '0';
     minorVersion = status.at(dotPos + 1) - '0';
 
-    int i = spacePos;
-    int j = status.indexOf(' ', i + 1); // j == -1 || at(j) == ' ' so j+1 == 0 && j+1 <= length()
-    const QByteArray code = status.mid(i + 1, j - i - 1);
-
-    bool ok;
-    statusCode = code.toInt(&ok);
-    reasonPhrase = QString::fromLatin1(status.constData() + j + 1);
+    const char *p = status.constData() + spacePos + 1;
+    const char *const end = status.constData() + status.length();
+    bool ok = p < end && *p != ' ';
+    statusCode = 0;
+    for ( ; p < end && *p != ' '; ++p) {
+        if (*p < '0' || *p > '9' || statusCode > 99999) {
+            ok = false;
+            break;
+        }
+        statusCode = statusCode * 10 + (*p - '0');
+    }
+    if (!ok)
+        statusCode = 0;
+    p = static_cast<const char *>(memchr(p, ' ', end - p));
+    reasonPhrase = p ? QString::fromLatin1(p + 1, end - p - 1) : QString();
 
     return ok && uint(majorVersion) <= 9 && uint(minorVersion) <= 9;
 }
@@ -490,37 +538,27 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
     }
 
     qint64 bytes = 0;
-    char c = 0;
     bool allHeaders = false;
-    qint64 haveRead = 0;
-    do {
-        haveRead = socket->read(&c, 1);
+    while (!allHeaders) {
+        const qint64 haveRead = readLineInto(socket, fragment);
         if (haveRead == 0) {
             // read more later
             break;
         } else if (haveRead == -1) {
             // connection broke down
             return -1;
-        } else {
-            fragment.append(c);
-            bytes++;
-
-            if (c == '\n') {
-                // check for possible header endings. As per HTTP rfc,
-                // the header endings will be marked by CRLFCRLF. But
-                // we will allow CRLFCRLF, CRLFLF, LFLF
-                if (fragment.endsWith("\r\n\r\n")
-                    || fragment.endsWith("\r\n\n")
-                    || fragment.endsWith("\n\n"))
-                    allHeaders = true;
-
-                // there is another case: We have no headers. Then the fragment equals just the line ending
-                if ((fragment.length() == 2 && fragment.endsWith("\r\n"))
-                    || (fragment.length() == 1 && fragment.endsWith("\n")))
-                    allHeaders = true;
-            }
         }
-    } while (!allHeaders && haveRead > 0);
+        bytes += haveRead;
+
+        // check for possible header endings. As per HTTP rfc,
+        // the header endings will be marked by CRLFCRLF. But
+        // we will allow CRLFCRLF, CRLFLF, LFLF.
+        // There is another case: We have no headers. Then the fragment equals just the line ending
+        if (fragment.endsWith('\n')) {
+            allHeaders = fragment.endsWith("\n\n") || fragment.endsWith("\n\r\n")
+                    || fragment == "\n" || fragment == "\r\n";
+        }
+    }
 
     // we received all headers now parse them
     if (allHeaders) {
@@ -542,56 +580,113 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
 
 #ifndef QT_NO_COMPRESS
         if (autoDecompress && isCompressed()) {
-            // allocate inflate state
-            if (!inflateStrm)
-                inflateStrm = new z_stream;
-            inflateStrm->zalloc = Z_NULL;
-            inflateStrm->zfree = Z_NULL;
-            inflateStrm->opaque = Z_NULL;
-            inflateStrm->avail_in = 0;
-            inflateStrm->next_in = Z_NULL;
-            // "windowBits can also be greater than 15 for optional gzip decoding.
-            // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
-            // http://www.zlib.net/manual.html
-            int ret = inflateInit2(inflateStrm, MAX_WBITS+32);
-            if (ret != Z_OK)
-                return -1;
+            // gzip, zlib or raw deflate, whatever the server sends for "gzip" and "deflate"
+            delete decompressor;
+            decompressor = new QDecompressor(QDecompressor::AutoDetectFormat);
         }
 #endif
-
     }
     return bytes;
 }
 
+namespace {
+// The header names seen in almost every response. Names matching one of
+// these exactly share its data instead of allocating a copy for every reply.
+static const char * const knownHeaderNames[] = {
+    "Accept-Ranges", "Age", "Cache-Control", "Connection", "Content-Disposition",
+    "Content-Encoding", "Content-Language", "Content-Length", "Content-Location",
+    "Content-Range", "Content-Type", "Date", "ETag", "Expires", "Keep-Alive",
+    "Last-Modified", "Link", "Location", "Pragma", "Proxy-Authenticate",
+    "Proxy-Connection", "Server", "Set-Cookie", "Strict-Transport-Security",
+    "Transfer-Encoding", "Vary", "Via", "WWW-Authenticate", "X-Content-Type-Options",
+    "X-Frame-Options", "X-Powered-By", "X-XSS-Protection"
+};
+static const int knownHeaderNameCount = sizeof knownHeaderNames / sizeof *knownHeaderNames;
+
+struct QHttpHeaderNameTable
+{
+    QHttpHeaderNameTable()
+    {
+        // both the canonical spelling and the all lowercase one used by many servers
+        for (int i = 0; i < knownHeaderNameCount; ++i) {
+            names[2 * i] = QByteArray(knownHeaderNames[i]);
+            names[2 * i + 1] = names[2 * i].toLower();
+        }
+    }
+
+    QByteArray intern(const char *name, int length) const
+    {
+        for (int i = 0; i < 2 * knownHeaderNameCount; ++i) {
+            const QByteArray &known = names[i];
+            if (known.size() == length && memcmp(known.constData(), name, length) == 0)
+                return known;
+        }
+        return QByteArray(name, length);
+    }
+
+    QByteArray names[2 * knownHeaderNameCount];
+};
+}
+
+Q_GLOBAL_STATIC(QHttpHeaderNameTable, headerNameTable)
+
 void QHttpNetworkReplyPrivate::parseHeader(const QByteArray &header)
 {
     // see rfc2616, sec 4 for information about HTTP/1.1 headers.
     // allows relaxed parsing here, accepts both CRLF & LF line endings
-    const QByteArrayMatcher lf("\n");
-    const QByteArrayMatcher colon(":");
-    int i = 0;
-    while (i < header.count()) {
-        int j = colon.indexIn(header, i); // field-name
-        if (j == -1)
-            break;
-        const QByteArray field = header.mid(i, j - i).trimmed();
-        j++;
-        // any number of LWS is allowed before and after the value
+    const QHttpHeaderNameTable *nameTable = headerNameTable();
+    const char *p = header.constData();
+    const char *const end = p + header.size();
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!lineEnd)
+            break; // something is wrong
+        const char *colon = static_cast<const char *>(memchr(p, ':', lineEnd - p));
+        if (!colon) {
+            // not a header field, e.g. the empty line ending the header
+            p = lineEnd + 1;
+            continue;
+        }
+
+        // field-name
+        const char *nameBegin = p;
+        const char *nameEnd = colon;
+        while (nameBegin < nameEnd && isLWS(*nameBegin))
+            ++nameBegin;
+        while (nameEnd > nameBegin && isLWS(nameEnd[-1]))
+            --nameEnd;
+        const QByteArray field = nameTable ? nameTable->intern(nameBegin, nameEnd - nameBegin)
+                                           : QByteArray(nameBegin, nameEnd - nameBegin);
+
+        // any number of LWS is allowed before and after the value, and the
+        // value may be continued on lines starting with a space or a tab
         QByteArray value;
-        do {
-            i = lf.indexIn(header, j);
-            if (i == -1)
+        const char *valueBegin = colon + 1;
+        forever {
+            const char *valueEnd = lineEnd;
+            while (valueBegin < valueEnd && isLWS(*valueBegin))
+                ++valueBegin;
+            while (valueEnd > valueBegin && isLWS(valueEnd[-1]))
+                --valueEnd;
+            if (valueBegin < valueEnd) {
+                if (value.isEmpty()) {
+                    value = QByteArray(valueBegin, valueEnd - valueBegin);
+                } else {
+                    value += ' ';
+                    value.append(valueBegin, valueEnd - valueBegin);
+                }
+            }
+
+            p = lineEnd + 1;
+            if (p >= end || (*p != ' ' && *p != '\t'))
                 break;
-            if (!value.isEmpty())
-                value += ' ';
-            // check if we have CRLF or only LF
-            bool hasCR = (i && header[i-1] == '\r');
-            int length = i -(hasCR ? 1: 0) - j;
-            value += header.mid(j, length).trimmed();
-            j = ++i;
-        } while (i < header.count() && (header.at(i) == ' ' || header.at(i) == '\t'));
-        if (i == -1)
-            break; // something is wrong
+            lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (!lineEnd) {
+                p = end;
+                break;
+            }
+            valueBegin = p;
+        }
 
         fields.append(qMakePair(field, value));
     }
@@ -626,6 +721,33 @@ qint64 QHttpNetworkReplyPrivate::readBodyVeryFast(QAbstractSocket *socket, char
     return haveRead;
 }
 
+// note this function can only be used for non-chunked, non-compressed with
+// known content length
+qint64 QHttpNetworkReplyPrivate::readBodyToFile(QAbstractSocket *socket)
+{
+    QAbstractSocketPrivate *socketPrivate = static_cast<QAbstractSocketPrivate *>(QObjectPrivate::get(socket));
+    qint64 haveRead = socketPrivate->receiveFile(downloadFileDescriptor, bodyLength - contentRead);
+    if (haveRead == -2) {
+        // the socket cannot hand its data to the file directly (e.g. SSL), copy it
+        char buffer[16384];
+        haveRead = socket->read(buffer, qMin<qint64>(bodyLength - contentRead, sizeof buffer));
+        for (qint64 written = 0; written < haveRead; ) {
+            qint64 r = QT_WRITE(downloadFileDescriptor, buffer + written, haveRead - written);
+            if (r <= 0)
+                return -1;
+            written += r;
+        }
+    }
+    if (haveRead == -1)
+        return -1;
+    contentRead += haveRead;
+
+    if (contentRead == bodyLength)
+        state = AllDoneState;
+
+    return haveRead;
+}
+
 // note this function can only be used for non-chunked, non-compressed with
 // known content length
 qint64 QHttpNetworkReplyPrivate::readBodyFast(QAbstractSocket *socket, QByteDataBuffer *rb)
@@ -700,50 +822,13 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
 #ifndef QT_NO_COMPRESS
 qint64 QHttpNetworkReplyPrivate::uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out)
 {
-    if (!inflateStrm)
+    if (!decompressor)
         return -1;
 
-    bool triedRawDeflate = false;
-    for (int i = 0; i < in->bufferCount(); i++) {
-        QByteArray &bIn = (*in)[i];
-
-        inflateStrm->avail_in = bIn.size();
-        inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-
-        do {
-            QByteArray bOut;
-            // make a wild guess about the uncompressed size.
-            bOut.reserve(inflateStrm->avail_in * 3 + 512);
-            inflateStrm->avail_out = bOut.capacity();
-            inflateStrm->next_out = reinterpret_cast<Bytef*>(bOut.data());
-
-            int ret = inflate(inflateStrm, Z_NO_FLUSH);
-            //All negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
-            // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
-            if (ret == Z_DATA_ERROR && !triedRawDeflate) {
-                inflateEnd(inflateStrm);
-                triedRawDeflate = true;
-                inflateStrm->zalloc = Z_NULL;
-                inflateStrm->zfree = Z_NULL;
-                inflateStrm->opaque = Z_NULL;
-                inflateStrm->avail_in = 0;
-                inflateStrm->next_in = Z_NULL;
-                int ret = inflateInit2(inflateStrm, -MAX_WBITS);
-                if (ret != Z_OK) {
-                    return -1;
-                } else {
-                    inflateStrm->avail_in = bIn.size();
-                    inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-                    continue;
-                }
-            } else if (ret < 0 || ret == Z_NEED_DICT) {
-                return -1;
-            }
-            bOut.resize(bOut.capacity() - inflateStrm->avail_out);
-            out->append(bOut);
-            if (ret == Z_STREAM_END)
-                return out->byteAmount();
-        } while (inflateStrm->avail_in > 0);
+    for (int i = 0; i < in->bufferCount() && !decompressor->atEnd(); i++) {
+        const QByteArray &bIn = (*in)[i];
+        if (!decompressor->decompress(bIn.constData(), bIn.size(), out))
+            return -1;
     }
 
     return out->byteAmount();
@@ -55,10 +55,6 @@
 #include <qplatformdefs.h>
 #ifndef QT_NO_HTTP
 
-#ifndef QT_NO_COMPRESS
-struct z_stream_s;
-#endif
-
 #include <QtNetwork/qtcpsocket.h>
 // it's safe to include these even if SSL support is not enabled
 #include <QtNetwork/qsslsocket.h>
@@ -82,6 +78,9 @@ class QHttpNetworkConnectionChannel;
 class QHttpNetworkRequest;
 class QHttpNetworkConnectionPrivate;
 class QHttpNetworkReplyPrivate;
+#ifndef QT_NO_COMPRESS
+class QDecompressor;
+#endif
 class Q_AUTOTEST_EXPORT QHttpNetworkReply : public QObject, public QHttpNetworkHeader
 {
     Q_OBJECT
@@ -129,9 +128,13 @@ public:
     void setUserProvidedDownloadBuffer(char*);
     char* userProvidedDownloadBuffer();
 
+    void setDownloadFileDescriptor(int fd);
+    int downloadFileDescriptor() const;
+
     bool isFinished() const;
 
     bool isPipeliningUsed() const;
+    bool isHttp2Used() const;
 
     QHttpNetworkConnection* connection();
 
@@ -164,6 +167,7 @@ private:
     friend class QHttpNetworkConnection;
     friend class QHttpNetworkConnectionPrivate;
     friend class QHttpNetworkConnectionChannel;
+    friend class QHttp2ProtocolHandler;
 };
 
 
@@ -179,6 +183,7 @@ public:
     qint64 readBody(QAbstractSocket *socket, QByteDataBuffer *out);
     qint64 readBodyVeryFast(QAbstractSocket *socket, char *b);
     qint64 readBodyFast(QAbstractSocket *socket, QByteDataBuffer *rb);
+    qint64 readBodyToFile(QAbstractSocket *socket);
     bool findChallenge(bool forProxy, QByteArray &challenge) const;
     QAuthenticatorPrivate::Method authenticationMethod(bool isProxy) const;
     void clear();
@@ -235,12 +240,14 @@ public:
     bool requestIsPrepared;
 
     bool pipeliningUsed;
+    bool http2Used;
     bool downstreamLimited;
 
     char* userProvidedDownloadBuffer;
+    int downloadFileDescriptor;
 
 #ifndef QT_NO_COMPRESS
-    z_stream_s *inflateStrm;
+    QDecompressor *decompressor;
     qint64 uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out);
 #endif
 };
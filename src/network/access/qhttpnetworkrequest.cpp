@@ -49,7 +49,8 @@ QT_BEGIN_NAMESPACE
 QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Operation op,
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
-      autoDecompress(false), pipeliningAllowed(false), withCredentials(true)
+      uploadFileDescriptor(-1), uploadFileOffset(0), autoDecompress(false), pipeliningAllowed(false), withCredentials(true),
+      http2Direct(false)
 {
 }
 
@@ -59,11 +60,14 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
     operation = other.operation;
     priority = other.priority;
     uploadByteDevice = other.uploadByteDevice;
+    uploadFileDescriptor = other.uploadFileDescriptor;
+    uploadFileOffset = other.uploadFileOffset;
     autoDecompress = other.autoDecompress;
     pipeliningAllowed = other.pipeliningAllowed;
     customVerb = other.customVerb;
     withCredentials = other.withCredentials;
     ssl = other.ssl;
+    http2Direct = other.http2Direct;
 }
 
 QHttpNetworkRequestPrivate::~QHttpNetworkRequestPrivate()
@@ -75,7 +79,8 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
     return QHttpNetworkHeaderPrivate::operator==(other)
         && (operation == other.operation)
         && (ssl == other.ssl)
-        && (uploadByteDevice == other.uploadByteDevice);
+        && (uploadByteDevice == other.uploadByteDevice)
+        && (uploadFileDescriptor == other.uploadFileDescriptor);
 }
 
 QByteArray QHttpNetworkRequestPrivate::methodName() const
@@ -291,6 +296,16 @@ void QHttpNetworkRequest::setWithCredentials(bool b)
     d->withCredentials = b;
 }
 
+bool QHttpNetworkRequest::isHttp2Direct() const
+{
+    return d->http2Direct;
+}
+
+void QHttpNetworkRequest::setHttp2Direct(bool b)
+{
+    d->http2Direct = b;
+}
+
 void QHttpNetworkRequest::setUploadByteDevice(QNonContiguousByteDevice *bd)
 {
     d->uploadByteDevice = bd;
@@ -301,6 +316,22 @@ QNonContiguousByteDevice* QHttpNetworkRequest::uploadByteDevice() const
     return d->uploadByteDevice;
 }
 
+void QHttpNetworkRequest::setUploadFileDescriptor(int fd, qint64 offset)
+{
+    d->uploadFileDescriptor = fd;
+    d->uploadFileOffset = offset;
+}
+
+int QHttpNetworkRequest::uploadFileDescriptor() const
+{
+    return d->uploadFileDescriptor;
+}
+
+qint64 QHttpNetworkRequest::uploadFileOffset() const
+{
+    return d->uploadFileOffset;
+}
+
 int QHttpNetworkRequest::majorVersion() const
 {
     return 1;
@@ -117,17 +117,27 @@ public:
     bool withCredentials() const;
     void setWithCredentials(bool b);
 
+    // speak HTTP/2 right away, without asking the server first (h2c with prior knowledge)
+    bool isHttp2Direct() const;
+    void setHttp2Direct(bool b);
+
     bool isSsl() const;
     void setSsl(bool);
 
     void setUploadByteDevice(QNonContiguousByteDevice *bd);
     QNonContiguousByteDevice* uploadByteDevice() const;
 
+    // the file behind the upload byte device, if the data can be sent from it directly
+    void setUploadFileDescriptor(int fd, qint64 offset);
+    int uploadFileDescriptor() const;
+    qint64 uploadFileOffset() const;
+
 private:
     QSharedDataPointer<QHttpNetworkRequestPrivate> d;
     friend class QHttpNetworkRequestPrivate;
     friend class QHttpNetworkConnectionPrivate;
     friend class QHttpNetworkConnectionChannel;
+    friend class QHttp2ProtocolHandler;
 };
 
 class QHttpNetworkRequestPrivate : public QHttpNetworkHeaderPrivate
@@ -147,10 +157,13 @@ public:
     QByteArray customVerb;
     QHttpNetworkRequest::Priority priority;
     mutable QNonContiguousByteDevice* uploadByteDevice;
+    int uploadFileDescriptor;
+    qint64 uploadFileOffset;
     bool autoDecompress;
     bool pipeliningAllowed;
     bool withCredentials;
     bool ssl;
+    bool http2Direct;
 };
 
 
@@ -103,7 +103,7 @@ static QNetworkReply::NetworkError statusCodeFromHttp(int httpStatusCode, const
 }
 
 
-static QByteArray makeCacheKey(QUrl &url, QNetworkProxy *proxy)
+static QByteArray makeCacheKey(QUrl &url, QNetworkProxy *proxy, bool http2)
 {
     QString result;
     QUrl copy = url;
@@ -142,7 +142,8 @@ static QByteArray makeCacheKey(QUrl &url, QNetworkProxy *proxy)
     Q_UNUSED(proxy)
 #endif
 
-    return "http-connection:" + result.toLatin1();
+    // an HTTP/2 connection can't take HTTP/1 requests, and the other way round
+    return (http2 ? "h2c-connection:" : "http-connection:") + result.toLatin1();
 }
 
 class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
@@ -151,11 +152,14 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt)
-        : QHttpNetworkConnection(hostName, port, encrypt)
+    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+                                       QHttpNetworkConnection::ConnectionType connectionType)
+        : QHttpNetworkConnection(hostName, port, encrypt, /*parent=*/0, connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt, QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, /*parent=*/0, networkSession)
+    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+                                       QHttpNetworkConnection::ConnectionType connectionType,
+                                       QSharedPointer<QNetworkSession> networkSession)
+        : QHttpNetworkConnection(hostName, port, encrypt, /*parent=*/0, networkSession, connectionType)
 #endif
     {
         setExpires(true);
@@ -194,6 +198,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     QObject(parent)
     , ssl(false)
     , downloadBufferMaximumSize(0)
+    , downloadFileDescriptor(-1)
     , readBufferMaxSize(0)
     , bytesEmitted(0)
     , pendingDownloadData(0)
@@ -201,6 +206,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , synchronous(false)
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
+    , isHttp2Used(false)
     , incomingContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
     , downloadBuffer(0)
@@ -252,14 +258,22 @@ void QHttpThreadDelegate::startRequest()
     QUrl urlCopy = httpRequest.url();
     urlCopy.setPort(urlCopy.port(ssl ? 443 : 80));
 
+    // HTTP/2 with prior knowledge is only spoken in clear text and straight to the server
+    bool http2 = httpRequest.isHttp2Direct() && !ssl;
+
 #ifndef QT_NO_NETWORKPROXY
     if (transparentProxy.type() != QNetworkProxy::NoProxy)
-        cacheKey = makeCacheKey(urlCopy, &transparentProxy);
+        http2 = false;
+    if (cacheProxy.type() != QNetworkProxy::NoProxy)
+        http2 = false;
+
+    if (transparentProxy.type() != QNetworkProxy::NoProxy)
+        cacheKey = makeCacheKey(urlCopy, &transparentProxy, http2);
     else if (cacheProxy.type() != QNetworkProxy::NoProxy)
-        cacheKey = makeCacheKey(urlCopy, &cacheProxy);
+        cacheKey = makeCacheKey(urlCopy, &cacheProxy, http2);
     else
 #endif
-        cacheKey = makeCacheKey(urlCopy, 0);
+        cacheKey = makeCacheKey(urlCopy, 0, http2);
 
 
     // the http object is actually a QHttpNetworkConnection
@@ -267,10 +281,12 @@ void QHttpThreadDelegate::startRequest()
     if (httpConnection == 0) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
+        QHttpNetworkConnection::ConnectionType connectionType = http2
+                ? QHttpNetworkConnection::ConnectionTypeHTTP2 : QHttpNetworkConnection::ConnectionTypeHTTP;
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl);
+        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl, connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl, networkSession);
+        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl, connectionType, networkSession);
 #endif
 #ifndef QT_NO_SSL
         // Set the QSslConfiguration from this QNetworkRequest.
@@ -526,8 +542,13 @@ void QHttpThreadDelegate::headerChangedSlot()
         emit sslConfigurationChanged(httpReply->sslConfiguration());
 #endif
 
+    // Does the user want the body in a file, and is that possible with this reply?
+    if (downloadFileDescriptor != -1)
+        httpReply->setDownloadFileDescriptor(downloadFileDescriptor);
+    bool writingToFile = (httpReply->downloadFileDescriptor() != -1);
+
     // Is using a zerocopy buffer allowed by user and possible with this reply?
-    if (httpReply->supportsUserProvidedDownloadBuffer()
+    if (!writingToFile && httpReply->supportsUserProvidedDownloadBuffer()
         && (downloadBufferMaximumSize > 0) && (httpReply->contentLength() <= downloadBufferMaximumSize)) {
         QT_TRY {
             char *buf = new char[httpReply->contentLength()]; // throws if allocation fails
@@ -545,6 +566,7 @@ void QHttpThreadDelegate::headerChangedSlot()
     incomingStatusCode = httpReply->statusCode();
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
+    isHttp2Used = httpReply->isHttp2Used();
     incomingContentLength = httpReply->contentLength();
 
     emit downloadMetaData(incomingHeaders,
@@ -552,7 +574,9 @@ void QHttpThreadDelegate::headerChangedSlot()
                           incomingReasonPhrase,
                           isPipeliningUsed,
                           downloadBuffer,
-                          incomingContentLength);
+                          incomingContentLength,
+                          writingToFile,
+                          isHttp2Used);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -568,15 +592,16 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingStatusCode = httpReply->statusCode();
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
+    isHttp2Used = httpReply->isHttp2Used();
     incomingContentLength = httpReply->contentLength();
 }
 
 
 void QHttpThreadDelegate::dataReadProgressSlot(qint64 done, qint64 total)
 {
-    // If we don't have a download buffer don't attempt to go this codepath
+    // If we don't have a download buffer or file don't attempt to go this codepath
     // It is not used by QNetworkAccessHttpBackend
-    if (downloadBuffer.isNull())
+    if (downloadBuffer.isNull() && (!httpReply || httpReply->downloadFileDescriptor() == -1))
         return;
 
     pendingDownloadProgress->fetchAndAddRelease(1);
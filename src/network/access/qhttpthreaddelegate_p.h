@@ -93,6 +93,7 @@ public:
 #endif
     QHttpNetworkRequest httpRequest;
     qint64 downloadBufferMaximumSize;
+    int downloadFileDescriptor;
     qint64 readBufferMaxSize;
     qint64 bytesEmitted;
     // From backend, modified by us for signal compression
@@ -111,6 +112,7 @@ public:
     int incomingStatusCode;
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
+    bool isHttp2Used;
     qint64 incomingContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
@@ -139,7 +141,7 @@ signals:
     void sslErrors(const QList<QSslError> &, bool *, QList<QSslError> *);
     void sslConfigurationChanged(const QSslConfiguration);
 #endif
-    void downloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64);
+    void downloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64,bool,bool);
     void downloadProgress(qint64, qint64);
     void downloadData(QByteArray);
     void error(QNetworkReply::NetworkError, const QString);
@@ -230,11 +232,13 @@ public:
 
     bool advanceReadPointer(qint64 a)
     {
-        if (m_data == 0)
-            return false;
-
-        m_amount -= a;
-        m_data += a;
+        // Data sent straight from the upload file (see
+        // QHttpNetworkRequest::uploadFileDescriptor()) never passed through
+        // us, it is only reported to the main thread
+        if (m_data != 0) {
+            m_amount -= a;
+            m_data += a;
+        }
 
         // To main thread to inform about our state
         emit processedData(a);
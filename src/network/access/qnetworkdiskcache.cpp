@@ -45,6 +45,7 @@
 #include "qnetworkdiskcache.h"
 #include "qnetworkdiskcache_p.h"
 #include "QtCore/qscopedpointer.h"
+#include "private/qcompressor_p.h"
 
 #include <qfile.h>
 #include <qdir.h>
@@ -681,7 +682,62 @@ void QCacheItem::writeCompressedData(QFile *device) const
 {
     QDataStream out(device);
 
-    out << qCompress(data.data());
+    // Stream the data through the compressor, producing the same bytes as
+    // "out << qCompress(data.data())" without holding the compressed copy:
+    // the byte array size, the uncompressed size and the zlib stream.
+    const QByteArray &uncompressed = data.data();
+    const qint64 sizePos = device->pos();
+    out << quint32(0) << quint32(uncompressed.size());
+
+    QCompressor compressor(device, QCompressor::ZlibFormat);
+    if (!compressor.open(QIODevice::WriteOnly))
+        return;
+    compressor.write(uncompressed);
+    compressor.close();
+
+    const qint64 endPos = device->pos();
+    device->seek(sizePos);
+    out << quint32(endPos - sizePos - sizeof(quint32));
+    device->seek(endPos);
+}
+
+/*!
+    Reads data written by writeCompressedData() from \a device.
+    Returns false if it is corrupt.
+ */
+bool QCacheItem::readCompressedData(QFile *device)
+{
+    QDataStream in(device);
+    quint32 compressedSize;
+    quint32 uncompressedSize = 0;
+    in >> compressedSize;
+    if (compressedSize != 0xffffffff && compressedSize >= sizeof(quint32))
+        in >> uncompressedSize;
+
+    QByteArray uncompressed;
+    if (uncompressedSize) {
+        // don't trust the stored size blindly
+        uncompressed.resize(int(qMin(uncompressedSize, quint32(2 * MAX_COMPRESSION_SIZE))));
+        QDecompressor decompressor(device, QDecompressor::ZlibFormat);
+        if (!decompressor.open(QIODevice::ReadOnly))
+            return false;
+        int size = 0;
+        while (!decompressor.atEnd()) {
+            if (size == uncompressed.size())
+                uncompressed.resize(2 * size);
+            const qint64 haveRead = decompressor.read(uncompressed.data() + size, uncompressed.size() - size);
+            if (haveRead <= 0)
+                break;
+            size += int(haveRead);
+        }
+        if (!decompressor.atEnd() || quint32(size) != uncompressedSize)
+            return false;
+        uncompressed.resize(size);
+    }
+
+    data.setData(uncompressed);
+    data.open(QBuffer::ReadOnly);
+    return true;
 }
 
 /*!
@@ -706,14 +762,10 @@ bool QCacheItem::read(QFile *device, bool readData)
         return false;
 
     bool compressed;
-    QByteArray dataBA;
     in >> metaData;
     in >> compressed;
-    if (readData && compressed) {
-        in >> dataBA;
-        data.setData(qUncompress(dataBA));
-        data.open(QBuffer::ReadOnly);
-    }
+    if (readData && compressed && !readCompressedData(device))
+        return false;
 
     // quick and dirty check if metadata's URL field and the file's name are in synch
     QString expectedFilename = QNetworkDiskCachePrivate::uniqueFileName(metaData.url());
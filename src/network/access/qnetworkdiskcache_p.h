@@ -90,6 +90,7 @@ public:
     }
     void writeHeader(QFile *device) const;
     void writeCompressedData(QFile *device) const;
+    bool readCompressedData(QFile *device);
     bool read(QFile *device, bool readData);
 
     bool canCompress() const;
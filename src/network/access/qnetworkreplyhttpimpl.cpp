@@ -52,12 +52,16 @@
 #include "qnetworkcookie_p.h"
 #include "QtCore/qdatetime.h"
 #include "QtCore/qelapsedtimer.h"
+#include "QtCore/qfile.h"
 #include "QtNetwork/qsslconfiguration.h"
 #include "qhttpthreaddelegate_p.h"
 #include "qthread.h"
 #include "QtCore/qcoreapplication.h"
 
 #include "qnetworkcookiejar.h"
+#ifndef QT_NO_COMPRESS
+#include "private/qcompressor_p.h"
+#endif
 
 #ifndef QT_NO_HTTP
 
@@ -180,6 +184,10 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
 #ifndef QT_NO_SSL
     d->sslConfiguration = request.sslConfiguration();
 #endif
+#ifndef QT_NO_COMPRESS
+    if (outgoingData && request.attribute(QNetworkRequest::CompressUploadDataAttribute, false).toBool())
+        d->uploadCompressor = new QCompressor(QCompressor::GzipFormat);
+#endif
 
     // FIXME Later maybe set to Unbuffered, especially if it is zerocopy or from cache?
     QIODevice::open(QIODevice::ReadOnly);
@@ -200,6 +208,12 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
                 previousDataSize = d->outgoingDataBuffer->size();
                 d->outgoingDataBuffer->append(d->outgoingData->readAll());
             } while (d->outgoingDataBuffer->size() != previousDataSize);
+#ifndef QT_NO_COMPRESS
+            if (d->uploadCompressor) {
+                const QByteArray uncompressed = d->outgoingDataBuffer->readAll();
+                d->compressOutgoingData(uncompressed.constData(), uncompressed.size(), true);
+            }
+#endif
             d->_q_startOperation();
             return;
         }
@@ -209,7 +223,12 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
     if (outgoingData) {
         // there is data to be uploaded, e.g. HTTP POST.
 
-        if (!d->outgoingData->isSequential()) {
+        bool compressing = false;
+#ifndef QT_NO_COMPRESS
+        // the compressed size is only known once all data has been seen
+        compressing = d->uploadCompressor != 0;
+#endif
+        if (!d->outgoingData->isSequential() && !compressing) {
             // fixed size non-sequential (random-access)
             // just start the operation
             QMetaObject::invokeMethod(this, "_q_startOperation", Qt::QueuedConnection);
@@ -219,7 +238,7 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
                     request.attribute(QNetworkRequest::DoNotBufferUploadDataAttribute,
                                   false).toBool();
 
-            if (bufferingDisallowed) {
+            if (bufferingDisallowed && !compressing) {
                 // if a valid content-length header for the request was supplied, we can disable buffering
                 // if not, we will buffer anyway
                 if (request.header(QNetworkRequest::ContentLengthHeader).isValid()) {
@@ -429,6 +448,9 @@ QNetworkReplyHttpImplPrivate::QNetworkReplyHttpImplPrivate()
     , state(Idle)
     , statusCode(0)
     , outgoingData(0)
+#ifndef QT_NO_COMPRESS
+    , uploadCompressor(0)
+#endif
     , bytesUploaded(-1)
     , cacheLoadDevice(0)
     , loadingFromCache(false)
@@ -440,6 +462,7 @@ QNetworkReplyHttpImplPrivate::QNetworkReplyHttpImplPrivate()
     , downloadBufferReadPosition(0)
     , downloadBufferCurrentSize(0)
     , downloadZerocopyBuffer(0)
+    , downloadWrittenToFile(false)
     , pendingDownloadDataEmissions(new QAtomicInt())
     , pendingDownloadProgressEmissions(new QAtomicInt())
     #ifndef QT_NO_SSL
@@ -454,6 +477,9 @@ QNetworkReplyHttpImplPrivate::~QNetworkReplyHttpImplPrivate()
     Q_Q(QNetworkReplyHttpImpl);
     // This will do nothing if the request was already finished or aborted
     emit q->abortHttpRequest();
+#ifndef QT_NO_COMPRESS
+    delete uploadCompressor;
+#endif
 }
 
 /*
@@ -744,9 +770,19 @@ void QNetworkReplyHttpImplPrivate::postRequest()
     foreach (const QByteArray &header, headers)
         httpRequest.setHeaderField(header, request.rawHeader(header));
 
+#ifndef QT_NO_COMPRESS
+    if (uploadCompressor && outgoingDataBuffer) {
+        httpRequest.setHeaderField("Content-Encoding", "gzip");
+        httpRequest.setContentLength(outgoingDataBuffer->size());
+    }
+#endif
+
     if (request.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute).toBool() == true)
         httpRequest.setPipeliningAllowed(true);
 
+    if (request.attribute(QNetworkRequest::Http2DirectAttribute).toBool() == true)
+        httpRequest.setHttp2Direct(true);
+
     if (static_cast<QNetworkRequest::LoadControl>
         (request.attribute(QNetworkRequest::AuthenticationReuseAttribute,
                              QNetworkRequest::Automatic).toInt()) == QNetworkRequest::Manual)
@@ -794,6 +830,11 @@ void QNetworkReplyHttpImplPrivate::postRequest()
             delegate->downloadBufferMaximumSize = 128*1024;
         }
 
+        // The body can be written to a file by the HTTP thread directly
+        QVariant downloadFileDescriptorAttribute = request.attribute(QNetworkRequest::DownloadFileDescriptorAttribute);
+        if (downloadFileDescriptorAttribute.isValid())
+            delegate->downloadFileDescriptor = downloadFileDescriptorAttribute.toInt();
+
 
         // These atomic integers are used for signal compression
         delegate->pendingDownloadData = pendingDownloadDataEmissions;
@@ -806,8 +847,8 @@ void QNetworkReplyHttpImplPrivate::postRequest()
         QObject::connect(delegate, SIGNAL(downloadFinished()),
                 q, SLOT(replyFinished()),
                 Qt::QueuedConnection);
-        QObject::connect(delegate, SIGNAL(downloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64)),
-                q, SLOT(replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64)),
+        QObject::connect(delegate, SIGNAL(downloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64,bool,bool)),
+                q, SLOT(replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64,bool,bool)),
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadProgress(qint64,qint64)),
                 q, SLOT(replyDownloadProgressSlot(qint64,qint64)),
@@ -852,6 +893,12 @@ void QNetworkReplyHttpImplPrivate::postRequest()
             forwardUploadDevice->setParent(delegate); // needed to make sure it is moved on moveToThread()
             delegate->httpRequest.setUploadByteDevice(forwardUploadDevice);
 
+            // A local file can be sent by the HTTP thread straight from disk,
+            // the byte devices are then only used for the progress reporting.
+            QFile *file = qobject_cast<QFile *>(outgoingData);
+            if (file && !outgoingDataBuffer && !file->isSequential() && file->handle() != -1)
+                delegate->httpRequest.setUploadFileDescriptor(file->handle(), file->pos());
+
             // From main thread to user thread:
             QObject::connect(q, SIGNAL(haveUploadData(QByteArray,bool,qint64)),
                              forwardUploadDevice, SLOT(haveDataSlot(QByteArray,bool,qint64)), Qt::QueuedConnection);
@@ -902,7 +949,9 @@ void QNetworkReplyHttpImplPrivate::postRequest()
                      delegate->incomingReasonPhrase,
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
-                     delegate->incomingContentLength);
+                     delegate->incomingContentLength,
+                     false,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
             httpError(delegate->incomingErrorCode, delegate->incomingErrorDetail);
         } else {
@@ -912,7 +961,9 @@ void QNetworkReplyHttpImplPrivate::postRequest()
                      delegate->incomingReasonPhrase,
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
-                     delegate->incomingContentLength);
+                     delegate->incomingContentLength,
+                     false,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
         }
 
@@ -1069,7 +1120,9 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
         (QList<QPair<QByteArray,QByteArray> > hm,
          int sc,QString rp,bool pu,
          QSharedPointer<char> db,
-         qint64 contentLength)
+         qint64 contentLength,
+         bool writtenToFile,
+         bool http2Used)
 {
     Q_Q(QNetworkReplyHttpImpl);
     Q_UNUSED(contentLength);
@@ -1077,6 +1130,14 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
     statusCode = sc;
     reasonPhrase = rp;
 
+    // The body goes to the user's file; it never passes through us and can't be cached
+    if (writtenToFile) {
+        downloadWrittenToFile = true;
+        cacheEnabled = false;
+        q->setAttribute(QNetworkRequest::DownloadFileDescriptorAttribute,
+                        request.attribute(QNetworkRequest::DownloadFileDescriptorAttribute));
+    }
+
     // Download buffer
     if (!db.isNull()) {
         downloadBufferPointer = db;
@@ -1086,6 +1147,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData
     }
 
     q->setAttribute(QNetworkRequest::HttpPipeliningWasUsedAttribute, pu);
+    q->setAttribute(QNetworkRequest::Http2WasUsedAttribute, http2Used);
 
     // reconstruct the HTTP header
     QList<QPair<QByteArray, QByteArray> > headerMap = hm;
@@ -1160,7 +1222,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadProgressSlot(qint64 bytesReceive
     if (!q->isOpen())
         return;
 
-    // we can be sure here that there is a download buffer
+    // we can be sure here that there is a download buffer or file
 
     int pendingSignals = (int)pendingDownloadProgressEmissions->fetchAndAddAcquire(-1) - 1;
     if (pendingSignals > 0) {
@@ -1172,6 +1234,16 @@ void QNetworkReplyHttpImplPrivate::replyDownloadProgressSlot(qint64 bytesReceive
     if (!q->isOpen())
         return;
 
+    if (downloadWrittenToFile) {
+        // nothing to read, only tell about the progress
+        bytesDownloaded = bytesReceived;
+        if (downloadProgressSignalChoke.elapsed() >= progressSignalInterval) {
+            downloadProgressSignalChoke.restart();
+            emit q->downloadProgress(bytesDownloaded, bytesTotal);
+        }
+        return;
+    }
+
     if (cacheEnabled && isCachingAllowed() && bytesReceived == bytesTotal) {
         // Write everything in one go if we use a download buffer. might be more performant.
         initCacheSaveDevice();
@@ -1690,6 +1762,17 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingDataFinished()
     QObject::disconnect(outgoingData, SIGNAL(readyRead()), q, SLOT(_q_bufferOutgoingData()));
     QObject::disconnect(outgoingData, SIGNAL(readChannelFinished()), q, SLOT(_q_bufferOutgoingDataFinished()));
 
+#ifndef QT_NO_COMPRESS
+    if (uploadCompressor) {
+        const QByteArray remaining = outgoingData->readAll();
+        if (!compressOutgoingData(remaining.constData(), remaining.size(), true)) {
+            error(QNetworkReply::UnknownContentError, uploadCompressor->errorString());
+            finished();
+            return;
+        }
+    }
+#endif
+
     // finally, start the request
     QMetaObject::invokeMethod(q, "_q_startOperation", Qt::QueuedConnection);
 }
@@ -1706,6 +1789,34 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingData()
         QObject::connect(outgoingData, SIGNAL(readChannelFinished()), q, SLOT(_q_bufferOutgoingDataFinished()));
     }
 
+#ifndef QT_NO_COMPRESS
+    if (uploadCompressor) {
+        // read into a scratch buffer and append the compressed data only.
+        // A random-access device (QBuffer, QFile) has all of its data available
+        // now and does not emit readChannelFinished(), so it is compressed in
+        // one go and read() returning 0 means its end has been reached.
+        const bool sequential = outgoingData->isSequential();
+        char buffer[16 * 1024];
+        forever {
+            const qint64 bytesRead = outgoingData->read(buffer, sizeof buffer);
+            if (bytesRead == -1 || (bytesRead == 0 && !sequential)) {
+                // EOF has been reached, the compressed stream is completed there.
+                _q_bufferOutgoingDataFinished();
+                break;
+            } else if (bytesRead == 0) {
+                break;
+            } else if (!compressOutgoingData(buffer, bytesRead, false)) {
+                QObject::disconnect(outgoingData, SIGNAL(readyRead()), q, SLOT(_q_bufferOutgoingData()));
+                QObject::disconnect(outgoingData, SIGNAL(readChannelFinished()), q, SLOT(_q_bufferOutgoingDataFinished()));
+                error(QNetworkReply::UnknownContentError, uploadCompressor->errorString());
+                finished();
+                break;
+            }
+        }
+        return;
+    }
+#endif
+
     qint64 bytesBuffered = 0;
     qint64 bytesToBuffer = 0;
 
@@ -1737,6 +1848,20 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingData()
     }
 }
 
+#ifndef QT_NO_COMPRESS
+bool QNetworkReplyHttpImplPrivate::compressOutgoingData(const char *data, qint64 size, bool atEnd)
+{
+    QByteDataBuffer compressed;
+    if (size > 0 && !uploadCompressor->compress(data, size, &compressed))
+        return false;
+    if (atEnd && !uploadCompressor->finish(&compressed))
+        return false;
+    while (!compressed.isEmpty())
+        outgoingDataBuffer->append(compressed.read());
+    return true;
+}
+#endif
+
 #ifndef QT_NO_BEARERMANAGEMENT
 void QNetworkReplyHttpImplPrivate::_q_networkSessionConnected()
 {
@@ -77,6 +77,9 @@
 QT_BEGIN_NAMESPACE
 
 class QIODevice;
+#ifndef QT_NO_COMPRESS
+class QCompressor;
+#endif
 
 class QNetworkReplyHttpImplPrivate;
 class QNetworkReplyHttpImpl: public QNetworkReply
@@ -111,7 +114,7 @@ public:
     // From reply
     Q_PRIVATE_SLOT(d_func(), void replyDownloadData(QByteArray))
     Q_PRIVATE_SLOT(d_func(), void replyFinished())
-    Q_PRIVATE_SLOT(d_func(), void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64))
+    Q_PRIVATE_SLOT(d_func(), void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64,bool,bool))
     Q_PRIVATE_SLOT(d_func(), void replyDownloadProgressSlot(qint64,qint64))
     Q_PRIVATE_SLOT(d_func(), void httpAuthenticationRequired(const QHttpNetworkRequest &, QAuthenticator *))
     Q_PRIVATE_SLOT(d_func(), void httpError(QNetworkReply::NetworkError, const QString &))
@@ -208,6 +211,10 @@ public:
     QSharedPointer<QNonContiguousByteDevice> uploadByteDevice;
     QIODevice *outgoingData;
     QSharedPointer<QRingBuffer> outgoingDataBuffer;
+#ifndef QT_NO_COMPRESS
+    QCompressor *uploadCompressor;
+    bool compressOutgoingData(const char *data, qint64 size, bool atEnd);
+#endif
     void emitReplyUploadProgress(qint64 bytesSent, qint64 bytesTotal); // dup?
     qint64 bytesUploaded;
 
@@ -250,6 +257,9 @@ public:
     QSharedPointer<char> downloadBufferPointer;
     char* downloadZerocopyBuffer;
 
+    // set when the HTTP thread writes the body to the DownloadFileDescriptorAttribute file
+    bool downloadWrittenToFile;
+
     // Will be increased by HTTP thread:
     QSharedPointer<QAtomicInt> pendingDownloadDataEmissions;
     QSharedPointer<QAtomicInt> pendingDownloadProgressEmissions;
@@ -276,7 +286,7 @@ public:
     // From HTTP thread:
     void replyDownloadData(QByteArray);
     void replyFinished();
-    void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64);
+    void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,int,QString,bool,QSharedPointer<char>,qint64,bool,bool);
     void replyDownloadProgressSlot(qint64,qint64);
     void httpAuthenticationRequired(const QHttpNetworkRequest &request, QAuthenticator *auth);
     void httpError(QNetworkReply::NetworkError error, const QString &errorString);
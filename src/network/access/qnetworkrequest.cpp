@@ -246,6 +246,43 @@ QT_BEGIN_NAMESPACE
         The QNetworkSession ConnectInBackground property will be set according to
         this attribute.
 
+    \value DownloadFileDescriptorAttribute
+        Type: QMetaType::Int
+        Requests: the file descriptor of a regular file opened for writing.
+        If the reply body has a known length and needs no decoding, it is
+        written to the file at its current position instead of being made
+        available through QNetworkReply::read(); only downloadProgress() is
+        emitted for it. On Linux the data is moved from the socket to the
+        file with splice() without being copied into the application. The
+        file must not be written to until the reply has finished.
+        Replies: set to the same descriptor if the body was written to it.
+        (This value was introduced in 5.2.)
+
+    \value CompressUploadDataAttribute
+        Requests only, type: QMetaType::Bool (default: false)
+        Indicates whether the data uploaded with an HTTP request is
+        gzip-compressed on the fly and sent with a "Content-Encoding: gzip"
+        header. The server has to support compressed request bodies.
+        Since the compressed size has to be sent in the Content-Length
+        header, the upload data is always buffered, overriding
+        DoNotBufferUploadDataAttribute.
+        (This value was introduced in 5.2.)
+
+    \value Http2DirectAttribute
+        Requests only, type: QMetaType::Bool (default: false)
+        Indicates whether an http:// request is sent with HTTP/2 right
+        away, without asking the server to upgrade first. This only works
+        with servers known to support HTTP/2 in clear text. All such
+        requests to the same server are multiplexed over a single
+        connection. Ignored for https:// and when a proxy is used.
+        (This value was introduced in 5.2.)
+
+    \value Http2WasUsedAttribute
+        Replies only, type: QMetaType::Bool
+        Indicates whether HTTP/2 was used for receiving
+        this reply.
+        (This value was introduced in 5.2.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -86,6 +86,10 @@ public:
         DownloadBufferAttribute, // internal
         SynchronousRequestAttribute, // internal
         BackgroundRequestAttribute,
+        DownloadFileDescriptorAttribute,
+        CompressUploadDataAttribute,
+        Http2DirectAttribute,
+        Http2WasUsedAttribute,
 
         User = 1000,
         UserMax = 32767
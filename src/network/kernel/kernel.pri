@@ -7,6 +7,7 @@ HEADERS += kernel/qauthenticator.h \
 	   kernel/qauthenticator_p.h \
            kernel/qdnslookup.h \
            kernel/qdnslookup_p.h \
+           kernel/qdnshostresolver_p.h \
            kernel/qhostaddress.h \
            kernel/qhostaddress_p.h \
            kernel/qhostinfo.h \
@@ -19,6 +20,7 @@ HEADERS += kernel/qauthenticator.h \
 
 SOURCES += kernel/qauthenticator.cpp \
            kernel/qdnslookup.cpp \
+           kernel/qdnshostresolver.cpp \
            kernel/qhostaddress.cpp \
            kernel/qhostinfo.cpp \
            kernel/qurlinfo.cpp \
@@ -0,0 +1,476 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+// for rand_s, _CRT_RAND_S must be #defined before #including stdlib.h.
+// put it at the beginning so some indirect inclusion doesn't break it
+#ifndef _CRT_RAND_S
+#define _CRT_RAND_S
+#endif
+#include <stdlib.h>
+
+#include "qdnshostresolver_p.h"
+#include "qhostinfo_p.h"
+
+#include <qdatetime.h>
+#include <qnetworkproxy.h>
+#include <qudpsocket.h>
+#include <qurl.h>
+
+#ifdef Q_OS_UNIX
+#include "private/qcore_unix_p.h"
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+#ifndef QT_NO_UDPSOCKET
+
+QT_BEGIN_NAMESPACE
+
+//#define QDNSHOSTRESOLVER_DEBUG
+
+// Each round of queries waits this long for an answer before the next
+// name server is tried.
+static const int attemptTimeout = 2000; // milliseconds
+static const int retryTimerInterval = 250; // milliseconds
+
+// The ports that each lookup picks its source port from at random.
+static const int firstSourcePort = 1024;
+static const int sourcePortCount = 65536 - firstSourcePort;
+static const int bindAttempts = 8;
+
+/*
+    Query ids and source ports are the only thing that keeps a forged answer
+    out of the cache, so they must not be predictable. In order of
+    decreasing precedence they come from:
+    - under Linux, the getrandom system call;
+    - under Unix, /dev/urandom;
+    - under Windows, rand_s;
+    - as a general fallback, a timestamp and the address of a stack-local
+      variable.
+*/
+static quint16 randomId()
+{
+    quint16 id = 0;
+
+#if defined(Q_OS_LINUX) && defined(__NR_getrandom)
+    if (syscall(__NR_getrandom, &id, sizeof(id), 0) == sizeof(id))
+        return id;
+#endif
+
+#ifdef Q_OS_UNIX
+    int randomfd = qt_safe_open("/dev/urandom", O_RDONLY);
+    if (randomfd != -1) {
+        const qint64 size = qt_safe_read(randomfd, reinterpret_cast<char *>(&id), sizeof(id));
+        qt_safe_close(randomfd);
+        if (size == sizeof(id))
+            return id;
+    }
+#endif // Q_OS_UNIX
+
+#if defined(Q_OS_WIN32) && !defined(Q_CC_GNU)
+    unsigned int value;
+    if (rand_s(&value) == 0)
+        return quint16(value);
+#endif // Q_OS_WIN32
+
+    const quint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    const quintptr address = reinterpret_cast<quintptr>(&id);
+    return quint16(qrand() ^ timestamp ^ (timestamp >> 16) ^ address ^ (address >> 16));
+}
+
+
+QDnsHostResolver::QDnsHostResolver(QHostInfoLookupManager *manager)
+    : manager(manager),
+      configuredPort(53),
+      port(53)
+{
+}
+
+QDnsHostResolver::~QDnsHostResolver()
+{
+    QList<PendingLookup *> lookups = pendingByName.values();
+    for (int i = 0; i < lookups.size(); ++i) {
+        qDeleteAll(lookups.at(i)->waiters);
+        for (int j = 0; j < SocketCount; ++j)
+            delete lookups.at(i)->sockets[j];
+        delete lookups.at(i);
+    }
+
+    QMutexLocker locker(&mutex);
+    qDeleteAll(incoming);
+}
+
+void QDnsHostResolver::setNameServers(const QList<QHostAddress> &servers, quint16 port)
+{
+    QMutexLocker locker(&mutex);
+    configuredServers = servers;
+    configuredPort = port;
+    QMetaObject::invokeMethod(this, "_q_processRequests", Qt::QueuedConnection);
+}
+
+// called from QHostInfoLookupManager, in any thread
+void QDnsHostResolver::lookup(QHostInfoRunnable *request)
+{
+    QMutexLocker locker(&mutex);
+    incoming.append(request);
+    if (incoming.size() == 1)
+        QMetaObject::invokeMethod(this, "_q_processRequests", Qt::QueuedConnection);
+}
+
+void QDnsHostResolver::_q_processRequests()
+{
+    QList<QHostInfoRunnable *> requests;
+    {
+        QMutexLocker locker(&mutex);
+        requests.swap(incoming);
+        servers = configuredServers;
+        port = configuredPort;
+    }
+    if (servers.isEmpty()) {
+        servers = QDnsLookupRunnable::systemNameServers();
+        port = 53;
+    }
+
+    for (int i = 0; i < requests.size(); ++i)
+        startLookup(requests.at(i));
+}
+
+void QDnsHostResolver::startLookup(QHostInfoRunnable *request)
+{
+    const QString &name = request->toBeLookedUp;
+
+    // a lookup for the same name may have completed since this one was queued
+    if (manager->cache.isEnabled()) {
+        bool valid = false;
+        QHostInfo info = manager->cache.get(name, &valid);
+        if (valid) {
+            manager->dnsLookupFinished(request, info);
+            return;
+        }
+    }
+
+    // join a lookup that is already in flight
+    PendingLookup *lookup = pendingByName.value(name);
+    if (lookup) {
+        lookup->waiters.append(request);
+        return;
+    }
+
+    const QByteArray aceName = QUrl::toAce(name);
+    const QByteArray probe = QDnsLookupRunnable::buildQuery(0, QDnsLookup::A, aceName);
+    QUdpSocket *socket = 0;
+    if (!servers.isEmpty() && !probe.isEmpty())
+        socket = createSocket(servers.first());
+    if (!socket) {
+        // no name server, no raw DNS support, a name we cannot encode or no
+        // socket: let the system resolver deal with it
+        manager->scheduleLookup(request);
+        return;
+    }
+
+    lookup = new PendingLookup;
+    lookup->name = name;
+    lookup->aceName = aceName;
+    lookup->attempt = 0;
+    for (int i = 0; i < SocketCount; ++i)
+        lookup->sockets[i] = 0;
+    lookup->sockets[socketIndex(servers.first())] = socket;
+    lookup->waiters.append(request);
+    lookup->queryId[IPv4Query] = randomId();
+    do {
+        lookup->queryId[IPv6Query] = randomId();
+    } while (lookup->queryId[IPv6Query] == lookup->queryId[IPv4Query]);
+    for (int i = 0; i < QueryCount; ++i)
+        lookup->answered[i] = false;
+    pendingByName.insert(name, lookup);
+    pendingBySocket.insert(socket, lookup);
+
+#if defined(QDNSHOSTRESOLVER_DEBUG)
+    qDebug("QDnsHostResolver: looking up \"%s\"", aceName.constData());
+#endif
+    sendQueries(lookup);
+}
+
+void QDnsHostResolver::sendQueries(PendingLookup *lookup)
+{
+    const QHostAddress &server = servers.at(lookup->attempt % servers.size());
+
+    // the name servers may use both protocols, each needs its own socket
+    QUdpSocket *&socket = lookup->sockets[socketIndex(server)];
+    if (!socket) {
+        socket = createSocket(server);
+        if (socket)
+            pendingBySocket.insert(socket, lookup);
+    }
+
+    // without a socket this attempt times out and the next server is tried
+    for (int i = 0; socket && i < QueryCount; ++i) {
+        if (lookup->answered[i])
+            continue;
+        const int type = (i == IPv4Query) ? QDnsLookup::A : QDnsLookup::AAAA;
+        socket->writeDatagram(QDnsLookupRunnable::buildQuery(lookup->queryId[i], type, lookup->aceName),
+                              server, port);
+    }
+    ++lookup->attempt;
+    lookup->sent.start();
+
+    if (!retryTimer.isActive())
+        retryTimer.start(retryTimerInterval, this);
+}
+
+void QDnsHostResolver::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != retryTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    // try every name server twice before giving up
+    const int maxAttempts = qMax(2, 2 * servers.size());
+
+    QList<PendingLookup *> expired;
+    QHash<QString, PendingLookup *>::const_iterator it = pendingByName.constBegin();
+    for ( ; it != pendingByName.constEnd(); ++it) {
+        PendingLookup *lookup = it.value();
+        if (!lookup->sent.hasExpired(attemptTimeout))
+            continue;
+        if (lookup->attempt >= maxAttempts)
+            expired.append(lookup);
+        else
+            sendQueries(lookup);
+    }
+
+    for (int i = 0; i < expired.size(); ++i)
+        finishLookup(expired.at(i));
+
+    if (pendingByName.isEmpty())
+        retryTimer.stop();
+}
+
+void QDnsHostResolver::_q_readDatagrams()
+{
+    // requests that were queued before the answer arrived share it
+    _q_processRequests();
+
+    QUdpSocket *socket = qobject_cast<QUdpSocket *>(sender());
+    PendingLookup *lookup = pendingBySocket.value(socket);
+    if (!lookup)
+        return;
+
+    while (socket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(qMax(int(socket->pendingDatagramSize()), 0));
+        QHostAddress senderAddress;
+        quint16 senderPort = 0;
+        const qint64 size = socket->readDatagram(datagram.data(), datagram.size(),
+                                                 &senderAddress, &senderPort);
+
+        // Only the name servers we asked may answer; the 12 byte header
+        // carries the query id and the QR bit that marks a response.
+        if (size < 12 || senderPort != port || !servers.contains(senderAddress))
+            continue;
+        const uchar *data = reinterpret_cast<const uchar *>(datagram.constData());
+        if (!(data[2] & 0x80))
+            continue;
+        const quint16 id = (data[0] << 8) | data[1];
+        int which;
+        if (id == lookup->queryId[IPv4Query])
+            which = IPv4Query;
+        else if (id == lookup->queryId[IPv6Query])
+            which = IPv6Query;
+        else
+            continue;
+        if (lookup->answered[which] || !isValidReply(lookup, which, data, int(size)))
+            continue;
+        lookup->answered[which] = true;
+        QDnsLookupRunnable::parseReply(data, int(size), &lookup->replies[which]);
+
+        // a name that does not exist has no records of the other type either
+        if (lookup->replies[which].error == QDnsLookup::NotFoundError
+            || (lookup->answered[IPv4Query] && lookup->answered[IPv6Query])) {
+            finishLookup(lookup);
+            return;
+        }
+    }
+}
+
+// Checks that the question section of a reply repeats the question that
+// was asked, so that an answer for another name cannot end up in the cache.
+bool QDnsHostResolver::isValidReply(PendingLookup *lookup, int which, const uchar *data, int size) const
+{
+    const int questionCount = (data[4] << 8) | data[5];
+    if (questionCount != 1)
+        return false;
+
+    // the question name comes first and is never compressed
+    QByteArray name;
+    int pos = 12;
+    while (pos < size && data[pos]) {
+        const int length = data[pos];
+        if (length > 63 || pos + 1 + length > size)
+            return false;
+        if (!name.isEmpty())
+            name += '.';
+        name.append(reinterpret_cast<const char *>(data) + pos + 1, length);
+        pos += 1 + length;
+    }
+    if (pos + 5 > size)
+        return false;
+    ++pos;
+
+    const int type = (data[pos] << 8) | data[pos + 1];
+    const int dnsClass = (data[pos + 2] << 8) | data[pos + 3];
+    const int expectedType = (which == IPv4Query) ? QDnsLookup::A : QDnsLookup::AAAA;
+    if (type != expectedType || dnsClass != 1) // IN
+        return false;
+
+    QByteArray expectedName = lookup->aceName;
+    if (expectedName.endsWith('.'))
+        expectedName.chop(1);
+    return qstricmp(name.constData(), expectedName.constData()) == 0;
+}
+
+void QDnsHostResolver::finishLookup(PendingLookup *lookup)
+{
+    QHostInfo info;
+    info.setHostName(lookup->name);
+
+    QList<QHostAddress> addresses;
+    quint32 ttl = 0xffffffff;
+    bool notFound = false;
+    bool failed = false;
+    QString errorString;
+
+    for (int i = 0; i < QueryCount; ++i) {
+        if (!lookup->answered[i]) {
+            failed = true;
+            continue;
+        }
+        const QDnsLookupReply &reply = lookup->replies[i];
+        if (reply.error == QDnsLookup::NotFoundError) {
+            notFound = true;
+        } else if (reply.error != QDnsLookup::NoError) {
+            failed = true;
+            errorString = reply.errorString;
+        } else {
+            const QAbstractSocket::NetworkLayerProtocol protocol =
+                    (i == IPv4Query) ? QAbstractSocket::IPv4Protocol : QAbstractSocket::IPv6Protocol;
+            for (int j = 0; j < reply.hostAddressRecords.size(); ++j) {
+                const QDnsHostAddressRecord &record = reply.hostAddressRecords.at(j);
+                if (record.value().protocol() != protocol || addresses.contains(record.value()))
+                    continue;
+                addresses.append(record.value());
+                ttl = qMin(ttl, record.timeToLive());
+            }
+        }
+    }
+
+    if (!addresses.isEmpty()) {
+        info.setAddresses(addresses);
+        finishLookup(lookup, info, int(qMin(ttl, quint32(0x7fffffff))));
+    } else if (notFound || !failed) {
+        info.setError(QHostInfo::HostNotFound);
+        info.setErrorString(QHostInfoAgent::tr("Host not found"));
+        finishLookup(lookup, info, -1);
+    } else {
+        info.setError(QHostInfo::UnknownError);
+        info.setErrorString(errorString.isEmpty()
+                            ? QHostInfoAgent::tr("Host lookup timed out")
+                            : errorString);
+        finishLookup(lookup, info, -1);
+    }
+}
+
+void QDnsHostResolver::finishLookup(PendingLookup *lookup, const QHostInfo &info, int ttl)
+{
+#if defined(QDNSHOSTRESOLVER_DEBUG)
+    qDebug("QDnsHostResolver: \"%s\" resolved to %d address(es), error %d",
+           lookup->aceName.constData(), info.addresses().size(), int(info.error()));
+#endif
+    pendingByName.remove(lookup->name);
+    for (int i = 0; i < SocketCount; ++i) {
+        if (!lookup->sockets[i])
+            continue;
+        pendingBySocket.remove(lookup->sockets[i]);
+        // this may be called from the socket's readyRead() signal
+        lookup->sockets[i]->deleteLater();
+    }
+
+    if (manager->cache.isEnabled())
+        manager->cache.put(lookup->name, info, ttl);
+
+    for (int i = 0; i < lookup->waiters.size(); ++i)
+        manager->dnsLookupFinished(lookup->waiters.at(i), info);
+    delete lookup;
+}
+
+int QDnsHostResolver::socketIndex(const QHostAddress &server)
+{
+    return server.protocol() == QAbstractSocket::IPv6Protocol ? IPv6Socket : IPv4Socket;
+}
+
+// Every lookup uses its own socket on a random port, so that a forged
+// answer has to guess the port as well as the query id. The socket is
+// bound to the protocol of the name server it talks to.
+QUdpSocket *QDnsHostResolver::createSocket(const QHostAddress &server)
+{
+    const QHostAddress any(server.protocol() == QAbstractSocket::IPv6Protocol
+                           ? QHostAddress::AnyIPv6 : QHostAddress::AnyIPv4);
+    QUdpSocket *socket = new QUdpSocket(this);
+    socket->setProxy(QNetworkProxy::NoProxy);
+    bool bound = false;
+    for (int i = 0; i < bindAttempts && !bound; ++i) {
+        const quint16 sourcePort = quint16(firstSourcePort + (randomId() % sourcePortCount));
+        bound = socket->bind(any, sourcePort);
+    }
+    // fall back to a port picked by the system
+    if (!bound && !socket->bind(any, 0)) {
+        delete socket;
+        return 0;
+    }
+    connect(socket, SIGNAL(readyRead()), this, SLOT(_q_readDatagrams()));
+    return socket;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_UDPSOCKET
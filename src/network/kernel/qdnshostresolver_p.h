@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDNSHOSTRESOLVER_P_H
+#define QDNSHOSTRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qbasictimer.h"
+#include "QtCore/qelapsedtimer.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qmutex.h"
+#include "QtCore/qobject.h"
+#include "QtNetwork/qhostaddress.h"
+#include "QtNetwork/qhostinfo.h"
+#include "private/qdnslookup_p.h"
+
+#ifndef QT_NO_UDPSOCKET
+
+QT_BEGIN_NAMESPACE
+
+class QUdpSocket;
+class QHostInfoRunnable;
+class QHostInfoLookupManager;
+
+// Resolves host names by talking to the name servers directly over UDP,
+// so that no thread is blocked while a lookup is outstanding. Requests
+// for a name that is already being resolved share the same queries.
+class QDnsHostResolver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QDnsHostResolver(QHostInfoLookupManager *manager);
+    ~QDnsHostResolver();
+
+    // thread-safe
+    void setNameServers(const QList<QHostAddress> &servers, quint16 port);
+    void lookup(QHostInfoRunnable *request);
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private Q_SLOTS:
+    void _q_processRequests();
+    void _q_readDatagrams();
+
+private:
+    enum { IPv4Query, IPv6Query, QueryCount };
+    enum { IPv4Socket, IPv6Socket, SocketCount };
+
+    struct PendingLookup {
+        QString name;
+        QByteArray aceName;
+        quint16 queryId[QueryCount];
+        bool answered[QueryCount];
+        QDnsLookupReply replies[QueryCount];
+        int attempt;
+        QElapsedTimer sent;
+        QUdpSocket *sockets[SocketCount];
+        QList<QHostInfoRunnable *> waiters;
+    };
+
+    void startLookup(QHostInfoRunnable *request);
+    void sendQueries(PendingLookup *lookup);
+    void finishLookup(PendingLookup *lookup, const QHostInfo &info, int ttl);
+    void finishLookup(PendingLookup *lookup);
+    static int socketIndex(const QHostAddress &server);
+    QUdpSocket *createSocket(const QHostAddress &server);
+    bool isValidReply(PendingLookup *lookup, int which, const uchar *data, int size) const;
+
+    QHostInfoLookupManager *manager;
+
+    QMutex mutex; // protects incoming and the name server configuration
+    QList<QHostInfoRunnable *> incoming;
+    QList<QHostAddress> configuredServers;
+    quint16 configuredPort;
+
+    QList<QHostAddress> servers;
+    quint16 port;
+    QHash<QString, PendingLookup *> pendingByName;
+    QHash<QUdpSocket *, PendingLookup *> pendingBySocket;
+    QBasicTimer retryTimer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_UDPSOCKET
+
+#endif // QDNSHOSTRESOLVER_P_H
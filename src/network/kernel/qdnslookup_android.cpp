@@ -51,4 +51,25 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     return;
 }
 
+QList<QHostAddress> QDnsLookupRunnable::systemNameServers()
+{
+    return QList<QHostAddress>();
+}
+
+QByteArray QDnsLookupRunnable::buildQuery(quint16 id, int requestType, const QByteArray &requestName)
+{
+    Q_UNUSED(id)
+    Q_UNUSED(requestType)
+    Q_UNUSED(requestName)
+    return QByteArray();
+}
+
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength, QDnsLookupReply *reply)
+{
+    Q_UNUSED(response)
+    Q_UNUSED(responseLength)
+    reply->error = QDnsLookup::ResolverError;
+    reply->errorString = tr("Not yet supported on Android");
+}
+
 QT_END_NAMESPACE
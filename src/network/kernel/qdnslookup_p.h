@@ -117,6 +117,11 @@ public:
     { }
     void run();
 
+    // Wire format helpers, shared with the asynchronous QHostInfo backend.
+    static QList<QHostAddress> systemNameServers();
+    static QByteArray buildQuery(quint16 id, int requestType, const QByteArray &requestName);
+    static void parseReply(const unsigned char *response, int responseLength, QDnsLookupReply *reply);
+
 signals:
     void finished(const QDnsLookupReply &reply);
 
@@ -104,7 +104,7 @@ static void resolveLibrary()
         local_res_nquery = res_nquery_proto(lib.resolve("res_nquery"));
 }
 
-void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestName, QDnsLookupReply *reply)
+static void ensureLibraryResolved()
 {
     // Load dn_expand, res_ninit and res_nquery on demand.
     static QBasicAtomicInt triedResolve = Q_BASIC_ATOMIC_INITIALIZER(false);
@@ -115,6 +115,11 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             triedResolve.storeRelease(true);
         }
     }
+}
+
+void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestName, QDnsLookupReply *reply)
+{
+    ensureLibraryResolved();
 
     // If dn_expand, res_ninit or res_nquery is missing, fail.
     if (!local_dn_expand || !local_res_nclose || !local_res_ninit || !local_res_nquery) {
@@ -141,8 +146,75 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     memset(response, 0, sizeof(response));
     const int responseLength = local_res_nquery(&state, requestName, C_IN, requestType, response, sizeof(response));
 
+    parseReply(response, responseLength, reply);
+}
+
+QList<QHostAddress> QDnsLookupRunnable::systemNameServers()
+{
+    QList<QHostAddress> servers;
+
+    ensureLibraryResolved();
+    if (!local_res_nclose || !local_res_ninit)
+        return servers;
+
+    struct __res_state state;
+    memset(&state, 0, sizeof(state));
+    if (local_res_ninit(&state) < 0)
+        return servers;
+    QScopedPointer<struct __res_state, QDnsLookupStateDeleter> state_ptr(&state);
+
+    for (int i = 0; i < state.nscount; ++i) {
+        if (state.nsaddr_list[i].sin_family == AF_INET)
+            servers.append(QHostAddress(ntohl(state.nsaddr_list[i].sin_addr.s_addr)));
+    }
+    return servers;
+}
+
+QByteArray QDnsLookupRunnable::buildQuery(quint16 id, int requestType, const QByteArray &requestName)
+{
+    QByteArray packet;
+    packet.reserve(int(sizeof(HEADER)) + requestName.size() + 6);
+
+    // Header: recursion desired, one question.
+    packet.append(char(id >> 8));
+    packet.append(char(id & 0xff));
+    packet.append(char(0x01));
+    packet.append(char(0x00));
+    packet.append("\0\1\0\0\0\0\0\0", 8);
+
+    // Question name, one length-prefixed label at a time.
+    int from = 0;
+    while (from < requestName.size()) {
+        int dot = requestName.indexOf('.', from);
+        if (dot < 0)
+            dot = requestName.size();
+        const int length = dot - from;
+        if (length == 0 || length > 63)
+            return QByteArray();
+        packet.append(char(length));
+        packet.append(requestName.constData() + from, length);
+        from = dot + 1;
+    }
+    packet.append(char(0));
+
+    packet.append(char(requestType >> 8));
+    packet.append(char(requestType & 0xff));
+    packet.append(char(C_IN >> 8));
+    packet.append(char(C_IN & 0xff));
+    return packet;
+}
+
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength, QDnsLookupReply *reply)
+{
+    ensureLibraryResolved();
+    if (!local_dn_expand) {
+        reply->error = QDnsLookup::ResolverError;
+        reply->errorString = tr("Resolver functions not found");
+        return;
+    }
+
     // Check the response header.
-    HEADER *header = (HEADER*)response;
+    const HEADER *header = (const HEADER*)response;
     const int answerCount = ntohs(header->ancount);
     switch (header->rcode) {
     case NOERROR:
@@ -178,7 +250,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
 
     // Skip the query host, type (2 bytes) and class (2 bytes).
     char host[PACKETSZ], answer[PACKETSZ];
-    unsigned char *p = response + sizeof(HEADER);
+    const unsigned char *p = response + sizeof(HEADER);
     int status = local_dn_expand(response, response + responseLength, p, host, sizeof(host));
     if (status < 0) {
         reply->error = QDnsLookup::InvalidReplyError;
@@ -199,6 +271,11 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         const QString name = QUrl::fromAce(host);
 
         p += status;
+        if (p + 10 > response + responseLength) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+            return;
+        }
         const quint16 type = (p[0] << 8) | p[1];
         p += 2; // RR type
         p += 2; // RR class
@@ -207,6 +284,12 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
         const quint16 size = (p[0] << 8) | p[1];
         p += 2;
 
+        if (p + size > response + responseLength) {
+            reply->error = QDnsLookup::InvalidReplyError;
+            reply->errorString = tr("Invalid reply received");
+            return;
+        }
+
         if (type == QDnsLookup::A) {
             if (size != 4) {
                 reply->error = QDnsLookup::InvalidReplyError;
@@ -228,7 +311,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             QDnsHostAddressRecord record;
             record.d->name = name;
             record.d->timeToLive = ttl;
-            record.d->value = QHostAddress(p);
+            record.d->value = QHostAddress(const_cast<quint8 *>(p));
             reply->hostAddressRecords.append(record);
         } else if (type == QDnsLookup::CNAME) {
             status = local_dn_expand(response, response + responseLength, p, answer, sizeof(answer));
@@ -299,7 +382,7 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
             record.d->weight = weight;
             reply->serviceRecords.append(record);
         } else if (type == QDnsLookup::TXT) {
-            unsigned char *txt = p;
+            const unsigned char *txt = p;
             QDnsTextRecord record;
             record.d->name = name;
             record.d->timeToLive = ttl;
@@ -332,6 +415,27 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     return;
 }
 
+QList<QHostAddress> QDnsLookupRunnable::systemNameServers()
+{
+    return QList<QHostAddress>();
+}
+
+QByteArray QDnsLookupRunnable::buildQuery(quint16 id, int requestType, const QByteArray &requestName)
+{
+    Q_UNUSED(id)
+    Q_UNUSED(requestType)
+    Q_UNUSED(requestName)
+    return QByteArray();
+}
+
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength, QDnsLookupReply *reply)
+{
+    Q_UNUSED(response)
+    Q_UNUSED(responseLength)
+    reply->error = QDnsLookup::ResolverError;
+    reply->errorString = tr("Resolver library can't be loaded: No runtime library loading support");
+}
+
 #endif /* ifndef QT_NO_LIBRARY */
 
 QT_END_NAMESPACE
@@ -148,4 +148,25 @@ void QDnsLookupRunnable::query(const int requestType, const QByteArray &requestN
     DnsRecordListFree(dns_records, DnsFreeRecordList);
 }
 
+QList<QHostAddress> QDnsLookupRunnable::systemNameServers()
+{
+    return QList<QHostAddress>();
+}
+
+QByteArray QDnsLookupRunnable::buildQuery(quint16 id, int requestType, const QByteArray &requestName)
+{
+    Q_UNUSED(id)
+    Q_UNUSED(requestType)
+    Q_UNUSED(requestName)
+    return QByteArray();
+}
+
+void QDnsLookupRunnable::parseReply(const unsigned char *response, int responseLength, QDnsLookupReply *reply)
+{
+    Q_UNUSED(response)
+    Q_UNUSED(responseLength)
+    reply->error = QDnsLookup::ResolverError;
+    reply->errorString = tr("Raw DNS messages are not supported on this platform");
+}
+
 QT_END_NAMESPACE
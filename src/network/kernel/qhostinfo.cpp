@@ -41,6 +41,7 @@
 
 #include "qhostinfo.h"
 #include "qhostinfo_p.h"
+#include "qdnshostresolver_p.h"
 
 #include "QtCore/qscopedpointer.h"
 #include <qabstracteventdispatcher.h>
@@ -110,7 +111,8 @@ Q_GLOBAL_STATIC(QHostInfoLookupManager, theHostInfoLookupManager)
     but also changes the order of signal emissions when using lookupHost()
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
-    for performance improvements.
+    for performance improvements. Failed lookups are not cached unless a
+    negative cache lifetime has been configured.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492}
 */
@@ -201,7 +203,8 @@ int QHostInfo::lookupHost(const QString &name, QObject *receiver,
         QHostInfoRunnable* runnable = new QHostInfoRunnable(name, id);
         if (receiver)
             QObject::connect(&runnable->resultEmitter, SIGNAL(resultsReady(QHostInfo)), receiver, member, Qt::QueuedConnection);
-        manager->scheduleLookup(runnable);
+        if (!manager->scheduleDnsLookup(runnable))
+            manager->scheduleLookup(runnable);
     }
     return id;
 }
@@ -504,7 +507,8 @@ void QHostInfoRunnable::run()
     // thread goes back to QThreadPool
 }
 
-QHostInfoLookupManager::QHostInfoLookupManager() : mutex(QMutex::Recursive), wasDeleted(false)
+QHostInfoLookupManager::QHostInfoLookupManager()
+    : mutex(QMutex::Recursive), wasDeleted(false), dnsBackendEnabled(false), dnsResolver(0)
 {
     moveToThread(QCoreApplicationPrivate::mainThread());
     connect(QCoreApplication::instance(), SIGNAL(destroyed()), SLOT(waitForThreadPoolDone()), Qt::DirectConnection);
@@ -517,6 +521,22 @@ QHostInfoLookupManager::~QHostInfoLookupManager()
 
     // don't qDeleteAll currentLookups, the QThreadPool has ownership
     clear();
+
+    // the resolver deletes itself when its thread finishes
+    dnsThread.quit();
+    dnsThread.wait();
+}
+
+void QHostInfoLookupManager::waitForThreadPoolDone()
+{
+    threadPool.waitForDone();
+
+    QMutexLocker locker(&mutex);
+    dnsBackendEnabled = false;
+    dnsResolver = 0;
+    locker.unlock();
+    dnsThread.quit();
+    dnsThread.wait();
 }
 
 void QHostInfoLookupManager::clear()
@@ -581,6 +601,10 @@ void QHostInfoLookupManager::work()
         // try to start the new ones
         QMutableListIterator<QHostInfoRunnable*> iterator(scheduledLookups);
         while (iterator.hasNext()) {
+            // with all threads busy nothing else can start; don't walk a long queue for nothing
+            if (currentLookups.size() >= threadPool.maxThreadCount())
+                break;
+
             QHostInfoRunnable *scheduled = iterator.next();
 
             // check if a lookup for this host is already running, then postpone
@@ -617,6 +641,56 @@ void QHostInfoLookupManager::scheduleLookup(QHostInfoRunnable *r)
     work();
 }
 
+// called by QHostInfo
+bool QHostInfoLookupManager::scheduleDnsLookup(QHostInfoRunnable *r)
+{
+#ifndef QT_NO_UDPSOCKET
+    if (wasDeleted)
+        return false;
+
+    // Literal addresses need a reverse lookup, and single-label names are
+    // left to the system resolver, which knows about the hosts file and the
+    // configured search domains.
+    const QString &name = r->toBeLookedUp;
+    if (!name.contains(QLatin1Char('.')) || !QHostAddress(name).isNull())
+        return false;
+
+    QMutexLocker locker(&this->mutex);
+    if (!dnsBackendEnabled || !dnsResolver)
+        return false;
+    dnsResolver->lookup(r);
+    return true;
+#else
+    Q_UNUSED(r);
+    return false;
+#endif
+}
+
+void QHostInfoLookupManager::setDnsBackendEnabled(bool e, const QList<QHostAddress> &nameServers, quint16 port)
+{
+#ifndef QT_NO_UDPSOCKET
+    if (wasDeleted)
+        return;
+
+    QMutexLocker locker(&this->mutex);
+    dnsBackendEnabled = e;
+    if (!e)
+        return;
+
+    if (!dnsResolver) {
+        dnsResolver = new QDnsHostResolver(this);
+        dnsResolver->moveToThread(&dnsThread);
+        connect(&dnsThread, SIGNAL(finished()), dnsResolver, SLOT(deleteLater()));
+        dnsThread.start();
+    }
+    dnsResolver->setNameServers(nameServers, port);
+#else
+    Q_UNUSED(e);
+    Q_UNUSED(nameServers);
+    Q_UNUSED(port);
+#endif
+}
+
 // called by QHostInfo
 void QHostInfoLookupManager::abortLookup(int id)
 {
@@ -667,6 +741,22 @@ void QHostInfoLookupManager::lookupFinished(QHostInfoRunnable *r)
     work();
 }
 
+// called from QDnsHostResolver
+void QHostInfoLookupManager::dnsLookupFinished(QHostInfoRunnable *r, QHostInfo info)
+{
+    bool aborted;
+    {
+        QMutexLocker locker(&this->mutex);
+        aborted = abortedLookups.removeAll(r->id) > 0;
+    }
+
+    if (!aborted) {
+        info.setLookupId(r->id);
+        r->resultEmitter.emitResultsReady(info);
+    }
+    delete r;
+}
+
 // This function returns immediately when we had a result in the cache, else it will later emit a signal
 QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char *member, bool *valid, int *id)
 {
@@ -705,9 +795,39 @@ void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e)
     }
 }
 
+// Successful lookups are kept for \a seconds, or for the time to live of the
+// DNS records if that is shorter. Failed lookups are kept for \a negativeSeconds;
+// 0 disables negative caching.
+void qt_qhostinfo_set_cache_max_age(int seconds, int negativeSeconds)
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (manager) {
+        manager->cache.setMaxAge(seconds, negativeSeconds);
+    }
+}
+
+void qt_qhostinfo_set_cache_size(int entries)
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (manager) {
+        manager->cache.setMaxEntries(entries);
+    }
+}
+
+// Resolves dotted host names with non-blocking queries sent straight to the
+// name servers instead of blocking a thread in getaddrinfo(). If \a nameServers
+// is empty, the system's configured name servers are used.
+void qt_qhostinfo_enable_dns_backend(bool e, const QList<QHostAddress> &nameServers, quint16 port)
+{
+    QHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (manager) {
+        manager->setDnsBackendEnabled(e, nameServers, port);
+    }
+}
+
 // cache for 60 seconds
 // cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+QHostInfoCache::QHostInfoCache() : max_age(60), negative_max_age(0), enabled(true), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled = false;
@@ -726,6 +846,19 @@ void QHostInfoCache::setEnabled(bool e)
     enabled = e;
 }
 
+void QHostInfoCache::setMaxAge(int seconds, int negativeSeconds)
+{
+    QMutexLocker locker(&this->mutex);
+    max_age = qMax(seconds, 0);
+    negative_max_age = qMax(negativeSeconds, 0);
+}
+
+void QHostInfoCache::setMaxEntries(int entries)
+{
+    QMutexLocker locker(&this->mutex);
+    cache.setMaxCost(qMax(entries, 1));
+}
+
 
 QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 {
@@ -734,7 +867,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     *valid = false;
     if (cache.contains(name)) {
         QHostInfoCacheElement *element = cache.object(name);
-        if (element->age.elapsed() < max_age*1000)
+        if (element->age.elapsed() < element->lifetime)
             *valid = true;
         return element->info;
 
@@ -746,18 +879,28 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
     return QHostInfo();
 }
 
-void QHostInfoCache::put(const QString &name, const QHostInfo &info)
+// \a ttl is the time to live in seconds reported by the name server, or -1
+void QHostInfoCache::put(const QString &name, const QHostInfo &info, int ttl)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    QMutexLocker locker(&this->mutex);
+
+    int lifetime;
+    if (info.error() == QHostInfo::NoError)
+        lifetime = (ttl >= 0) ? qMin(ttl, max_age) : max_age;
+    else if (info.error() == QHostInfo::HostNotFound)
+        lifetime = negative_max_age;
+    else
+        lifetime = 0; // don't cache transient failures
+
+    if (lifetime <= 0)
         return;
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
     element->age = QElapsedTimer();
     element->age.start();
+    element->lifetime = qint64(lifetime) * 1000;
 
-    QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
 }
 
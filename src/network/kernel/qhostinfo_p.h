@@ -126,23 +126,34 @@ QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *rec
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
 
+// Resolver tuning for applications that resolve many distinct hosts.
+void Q_NETWORK_EXPORT qt_qhostinfo_set_cache_max_age(int seconds, int negativeSeconds);
+void Q_NETWORK_EXPORT qt_qhostinfo_set_cache_size(int entries);
+void Q_NETWORK_EXPORT qt_qhostinfo_enable_dns_backend(bool e,
+                                                      const QList<QHostAddress> &nameServers = QList<QHostAddress>(),
+                                                      quint16 port = 53);
+
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
-    const int max_age; // seconds
+    int max_age; // seconds
+    int negative_max_age; // seconds, 0 disables caching of failed lookups
 
     QHostInfo get(const QString &name, bool *valid);
-    void put(const QString &name, const QHostInfo &info);
+    void put(const QString &name, const QHostInfo &info, int ttl = -1);
     void clear();
 
     bool isEnabled();
     void setEnabled(bool e);
+    void setMaxAge(int seconds, int negativeSeconds);
+    void setMaxEntries(int entries);
 private:
     bool enabled;
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        qint64 lifetime; // milliseconds
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
@@ -178,6 +189,8 @@ protected:
 
 };
 
+class QDnsHostResolver;
+
 class QHostInfoLookupManager : public QAbstractHostInfoLookupManager
 {
     Q_OBJECT
@@ -191,11 +204,16 @@ public:
     // called from QHostInfo
     void scheduleLookup(QHostInfoRunnable *r);
     void abortLookup(int id);
+    bool scheduleDnsLookup(QHostInfoRunnable *r);
+    void setDnsBackendEnabled(bool e, const QList<QHostAddress> &nameServers, quint16 port);
 
     // called from QHostInfoRunnable
     void lookupFinished(QHostInfoRunnable *r);
     bool wasAborted(int id);
 
+    // called from QDnsHostResolver
+    void dnsLookupFinished(QHostInfoRunnable *r, QHostInfo info);
+
     friend class QHostInfoRunnable;
 protected:
     QList<QHostInfoRunnable*> currentLookups; // in progress
@@ -210,8 +228,13 @@ protected:
 
     bool wasDeleted;
 
+    // asynchronous DNS backend, runs in its own thread once enabled
+    bool dnsBackendEnabled;
+    QDnsHostResolver *dnsResolver;
+    QThread dnsThread;
+
 private slots:
-    void waitForThreadPoolDone() { threadPool.waitForDone(); }
+    void waitForThreadPoolDone();
 };
 
 QT_END_NAMESPACE
@@ -443,6 +443,7 @@
 
 #include "private/qhostinfo_p.h"
 #include "private/qnetworksession_p.h"
+#include "private/qnativesocketengine_p.h"
 
 #include <qabstracteventdispatcher.h>
 #include <qhostaddress.h>
@@ -459,6 +460,10 @@
 
 #include <private/qthread_p.h>
 
+#ifdef Q_OS_UNIX
+#include <private/qcore_unix_p.h>
+#endif
+
 #ifdef QABSTRACTSOCKET_DEBUG
 #include <qdebug.h>
 #endif
@@ -550,6 +555,9 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       cachedSocketDescriptor(-1),
       readBufferMaxSize(0),
       writeBuffer(QABSTRACTSOCKET_BUFFERSIZE),
+      fileBytesWritten(0),
+      pendingFileWrite(false),
+      receivingFile(false),
       isBuffered(false),
       blockingTimeout(30000),
       connectTimer(0),
@@ -590,6 +598,12 @@ void QAbstractSocketPrivate::resetSocketLayer()
         socketEngine = 0;
         cachedSocketDescriptor = -1;
     }
+    fileBytesWritten = 0;
+    pendingFileWrite = false;
+    if (receivingFile) {
+        receivingFile = false;
+        isBuffered = true;
+    }
     if (connectTimer)
         connectTimer->stop();
     if (disconnectTimer)
@@ -798,6 +812,18 @@ bool QAbstractSocketPrivate::canWriteNotification()
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::canWriteNotification() flushing");
 #endif
+    if (pendingFileWrite && writeBuffer.isEmpty()) {
+        // sendFile() is waiting for room in the socket
+        Q_Q(QAbstractSocket);
+        pendingFileWrite = false;
+        if (socketEngine)
+            socketEngine->setWriteNotificationEnabled(false);
+        qint64 written = fileBytesWritten;
+        fileBytesWritten = 0;
+        emit q->bytesWritten(written);
+        return true;
+    }
+
     int tmp = writeBuffer.size();
     flush();
 
@@ -900,6 +926,133 @@ bool QAbstractSocketPrivate::flush()
     return true;
 }
 
+/*! \internal
+
+    Writes up to \a maxSize bytes of the file \a fileDescriptor, starting at
+    \a offset, straight to the socket. Only possible while nothing is waiting
+    in the write buffer. Returns the number of bytes written, -1 on error or
+    -2 if the socket cannot send files.
+*/
+qint64 QAbstractSocketPrivate::sendFile(int fileDescriptor, qint64 offset, qint64 maxSize)
+{
+#ifdef Q_OS_UNIX
+    Q_Q(QAbstractSocket);
+#ifndef QT_NO_SSL
+    if (qobject_cast<QSslSocket *>(q))
+        return -2; // the data has to go through the encryption layer
+#endif
+    QNativeSocketEngine *engine = qobject_cast<QNativeSocketEngine *>(socketEngine);
+    if (!engine || !engine->isValid() || state != QAbstractSocket::ConnectedState
+        || !writeBuffer.isEmpty())
+        return -2;
+
+    qint64 written = engine->sendFile(fileDescriptor, offset, maxSize);
+    if (written < 0) {
+        socketError = engine->error();
+        q->setErrorString(engine->errorString());
+        emit q->error(socketError);
+        q->abort();
+        return -1;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::sendFile() %lld bytes written to the network", written);
+#endif
+
+    fileBytesWritten += written;
+    if (written < maxSize) {
+        // the socket is full, let the caller know when it can take more
+        pendingFileWrite = true;
+        engine->setWriteNotificationEnabled(true);
+    }
+    return written;
+#else
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(maxSize);
+    return -2;
+#endif
+}
+
+/*! \internal
+
+    Moves up to \a maxSize bytes received on the socket to the file
+    \a fileDescriptor, starting with any data already in the read buffer.
+    Until \a maxSize bytes have been moved the socket stops buffering incoming
+    data and readyRead() only signals that more is available. Returns the
+    number of bytes moved, -1 on error or -2 if the socket cannot receive
+    files.
+*/
+qint64 QAbstractSocketPrivate::receiveFile(int fileDescriptor, qint64 maxSize)
+{
+#ifdef Q_OS_UNIX
+    Q_Q(QAbstractSocket);
+#ifndef QT_NO_SSL
+    if (qobject_cast<QSslSocket *>(q))
+        return -2; // the data has to go through the encryption layer
+#endif
+    QNativeSocketEngine *engine = qobject_cast<QNativeSocketEngine *>(socketEngine);
+    if (!engine || socketType != QAbstractSocket::TcpSocket || (!isBuffered && !receivingFile))
+        return -2;
+
+    qint64 done = 0;
+    while (done < maxSize && !buffer.isEmpty()) {
+        char block[4096];
+        qint64 blockSize = buffer.peek(block, int(qMin<qint64>(maxSize - done, sizeof block)));
+        qint64 written = qt_safe_write(fileDescriptor, block, blockSize);
+        if (written <= 0) {
+            // the rest of the data cannot go anywhere
+            socketError = QAbstractSocket::UnknownSocketError;
+            q->setErrorString(qt_error_string());
+            emit q->error(socketError);
+            q->abort();
+            return -1;
+        }
+        buffer.skip(int(written));
+        done += written;
+    }
+
+    if (done < maxSize && engine->isValid()) {
+        // don't let the read notifier pull the data we want into the buffer
+        receivingFile = true;
+        isBuffered = false;
+
+        while (done < maxSize) {
+            qint64 moved = engine->receiveFile(fileDescriptor, maxSize - done);
+            if (moved == -2)
+                break;
+            if (moved < 0) {
+                receivingFile = false;
+                isBuffered = true;
+                socketError = engine->error();
+                q->setErrorString(engine->errorString());
+                emit q->error(socketError);
+                q->abort();
+                return -1;
+            }
+            done += moved;
+        }
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::receiveFile() %lld bytes moved to the file", done);
+#endif
+
+    if (done == maxSize && receivingFile) {
+        receivingFile = false;
+        isBuffered = true;
+    }
+    // unbuffered reading disables the notifier until the data has been read
+    if (socketEngine && socketEngine->isValid() && !socketEngine->isReadNotificationEnabled())
+        socketEngine->setReadNotificationEnabled(true);
+    return done;
+#else
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(maxSize);
+    return -2;
+#endif
+}
+
 #ifndef QT_NO_NETWORKPROXY
 /*! \internal
 
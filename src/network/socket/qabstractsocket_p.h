@@ -145,6 +145,17 @@ public:
     qint64 readBufferMaxSize;
     QRingBuffer writeBuffer;
 
+    // Moving data between the socket and a file without copying it through
+    // the read and write buffers (used by QHttpNetworkConnection). Both return
+    // -2 if the socket cannot do this and the caller should use read()/write().
+    // Once sendFile() has filled the socket, bytesWritten() is emitted when it
+    // can take more data.
+    qint64 sendFile(int fileDescriptor, qint64 offset, qint64 maxSize);
+    qint64 receiveFile(int fileDescriptor, qint64 maxSize);
+    qint64 fileBytesWritten;
+    bool pendingFileWrite;
+    bool receivingFile;
+
     bool isBuffered;
     int blockingTimeout;
 
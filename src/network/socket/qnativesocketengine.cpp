@@ -165,6 +165,9 @@ QNativeSocketEnginePrivate::QNativeSocketEnginePrivate() :
     writeNotifier(0),
     exceptNotifier(0)
 {
+#ifdef Q_OS_LINUX
+    splicePipe[0] = splicePipe[1] = -1;
+#endif
 }
 
 /*! \internal
@@ -807,6 +810,57 @@ qint64 QNativeSocketEngine::bytesToWrite() const
     return 0;
 }
 
+/*!
+    Writes up to \a maxSize bytes of the file referred to by \a fileDescriptor,
+    starting at \a offset, to the socket. The file's own offset is not changed.
+    Where the platform supports it the data is sent without being copied
+    into user space.
+
+    Returns the number of bytes written, which is 0 when the socket cannot
+    accept more data right now, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::sendFile(int fileDescriptor, qint64 offset, qint64 maxSize)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeSendFile(fileDescriptor, offset, maxSize);
+}
+
+/*!
+    Moves up to \a maxSize bytes from the socket to the current position of
+    the file referred to by \a fileDescriptor. Where the platform supports
+    it the data is not copied into user space.
+
+    Returns the number of bytes moved, -2 if no data was available, or -1 if
+    an error occurred (including the remote host closing the connection).
+*/
+qint64 QNativeSocketEngine::receiveFile(int fileDescriptor, qint64 maxSize)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::receiveFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::receiveFile(), QAbstractSocket::ConnectedState, -1);
+
+    qint64 readBytes = d->nativeReceiveFile(fileDescriptor, maxSize);
+
+    // Handle remote close
+    if (readBytes == 0) {
+        d->setError(QAbstractSocket::RemoteHostClosedError,
+                    QNativeSocketEnginePrivate::RemoteHostClosedErrorString);
+        close();
+        return -1;
+    } else if (readBytes == -1) {
+        if (!d->hasSetSocketError) {
+            d->hasSetSocketError = true;
+            d->socketError = QAbstractSocket::NetworkError;
+            d->socketErrorString = qt_error_string();
+        }
+        close();
+        return -1;
+    }
+    return readBytes;
+}
+
 /*!
     Reads up to \a maxSize bytes into \a data from the socket.
     Returns the number of bytes read, or -1 if an error occurred.
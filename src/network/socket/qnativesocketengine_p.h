@@ -141,6 +141,9 @@ public:
     qint64 read(char *data, qint64 maxlen);
     qint64 write(const char *data, qint64 len);
 
+    qint64 sendFile(int fileDescriptor, qint64 offset, qint64 maxSize);
+    qint64 receiveFile(int fileDescriptor, qint64 maxSize);
+
     qint64 readDatagram(char *data, qint64 maxlen, QHostAddress *addr = 0,
                             quint16 *port = 0);
     qint64 writeDatagram(const char *data, qint64 len, const QHostAddress &addr,
@@ -207,6 +210,9 @@ public:
 #ifdef Q_OS_WIN
     QWindowsSockInit winSock;
 #endif
+#ifdef Q_OS_LINUX
+    int splicePipe[2]; // used by nativeReceiveFile(), created on demand
+#endif
 
     enum ErrorString {
         NonBlockingInitFailedErrorString,
@@ -269,6 +275,8 @@ public:
                                   const QHostAddress &host, quint16 port);
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 maxSize);
+    qint64 nativeReceiveFile(int fileDescriptor, qint64 maxSize);
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
 		     bool *selectForRead, bool *selectForWrite) const;
@@ -64,6 +64,10 @@
 
 #include <netinet/tcp.h>
 
+#ifdef Q_OS_LINUX
+#include <sys/sendfile.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if defined QNATIVESOCKETENGINE_DEBUG
@@ -1036,6 +1040,14 @@ void QNativeSocketEnginePrivate::nativeClose()
 #endif
 
     qt_safe_close(socketDescriptor);
+
+#ifdef Q_OS_LINUX
+    if (splicePipe[0] != -1) {
+        qt_safe_close(splicePipe[0]);
+        qt_safe_close(splicePipe[1]);
+        splicePipe[0] = splicePipe[1] = -1;
+    }
+#endif
 }
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
@@ -1072,6 +1084,151 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+static bool writeToFile(int fileDescriptor, const char *data, qint64 length)
+{
+    while (length > 0) {
+        qint64 written = qt_safe_write(fileDescriptor, data, length);
+        if (written <= 0)
+            return false;
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 maxSize)
+{
+    Q_Q(QNativeSocketEngine);
+
+    ssize_t writtenBytes;
+#if defined(Q_OS_LINUX)
+    qt_ignore_sigpipe();
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+    off64_t fileOffset = offset;
+    EINTR_LOOP(writtenBytes, ::sendfile64(socketDescriptor, fileDescriptor, &fileOffset, size_t(maxSize)));
+#  else
+    off_t fileOffset = offset;
+    EINTR_LOOP(writtenBytes, ::sendfile(socketDescriptor, fileDescriptor, &fileOffset, size_t(maxSize)));
+#  endif
+    if (writtenBytes < 0 && (errno == EINVAL || errno == ENOSYS))
+#endif
+    {
+        // no sendfile() for this kind of file; read a block and write it out instead
+        char buffer[16384];
+        ssize_t readBytes;
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+        EINTR_LOOP(readBytes, ::pread64(fileDescriptor, buffer, size_t(qMin<qint64>(maxSize, sizeof buffer)), offset));
+#else
+        EINTR_LOOP(readBytes, ::pread(fileDescriptor, buffer, size_t(qMin<qint64>(maxSize, sizeof buffer)), offset));
+#endif
+        if (readBytes < 0 || (readBytes == 0 && maxSize > 0)) {
+            // the file ends before maxSize bytes were sent
+            setError(QAbstractSocket::UnknownSocketError, ReadErrorString);
+            return -1;
+        }
+        writtenBytes = qt_safe_write_nosignal(socketDescriptor, buffer, readBytes);
+    }
+#if defined(Q_OS_LINUX)
+    else if (writtenBytes == 0 && maxSize > 0) {
+        // a full socket fails with EAGAIN, so nothing sent means the end of the file
+        setError(QAbstractSocket::UnknownSocketError, ReadErrorString);
+        return -1;
+    }
+#endif
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %i",
+           fileDescriptor, offset, maxSize, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveFile(int fileDescriptor, qint64 maxSize)
+{
+#if defined(Q_OS_LINUX)
+    // splice() needs a pipe on one side, so the data goes socket -> pipe -> file
+    if (splicePipe[0] != -1 || qt_safe_pipe(splicePipe, O_NONBLOCK) == 0) {
+        ssize_t r;
+        EINTR_LOOP(r, ::splice(socketDescriptor, 0, splicePipe[1], 0,
+                               size_t(qMin<qint64>(maxSize, 65536)),
+                               SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+        if (r > 0) {
+            qint64 left = r;
+            while (left > 0) {
+                ssize_t written;
+                EINTR_LOOP(written, ::splice(splicePipe[0], 0, fileDescriptor, 0, size_t(left), SPLICE_F_MOVE));
+                if (written > 0) {
+                    left -= written;
+                    continue;
+                }
+
+                if (written < 0 && errno == EINVAL) {
+                    // the file cannot be spliced into (e.g. it was opened with O_APPEND)
+                    char buffer[16384];
+                    qint64 readBytes = qt_safe_read(splicePipe[0], buffer, qMin<qint64>(left, sizeof buffer));
+                    if (readBytes > 0 && writeToFile(fileDescriptor, buffer, readBytes)) {
+                        left -= readBytes;
+                        continue;
+                    }
+                }
+
+                // don't leave stale data behind in the pipe
+                qt_safe_close(splicePipe[0]);
+                qt_safe_close(splicePipe[1]);
+                splicePipe[0] = splicePipe[1] = -1;
+                setError(QAbstractSocket::UnknownSocketError, WriteErrorString);
+                return -1;
+            }
+            return r;
+        }
+
+        if (r == 0)
+            return 0;
+        switch (errno) {
+#if EWOULDBLOCK-0 && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            return -2;
+        case ECONNRESET:
+            return 0;
+        case EINVAL:
+        case ENOSYS:
+            break; // fall back to copying
+        default:
+            return -1;
+        }
+    }
+#endif
+
+    char buffer[16384];
+    qint64 readBytes = nativeRead(buffer, qMin<qint64>(maxSize, sizeof buffer));
+    if (readBytes > 0 && !writeToFile(fileDescriptor, buffer, readBytes)) {
+        setError(QAbstractSocket::UnknownSocketError, WriteErrorString);
+        return -1;
+    }
+    return readBytes;
+}
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -53,6 +53,7 @@
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
 #include <qmutex.h>
+#include <qendian.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 
@@ -61,6 +62,12 @@
 
 #include <stdlib.h>
 #include <math.h>
+
+// single-row mode (PQsetSingleRowMode) was added in libpq 9.2
+#if defined(PG_VERSION_NUM) && PG_VERSION_NUM >= 90200
+#define QT_PSQL_SINGLE_ROW_MODE
+#endif
+
 // below code taken from an example at http://www.gnu.org/software/hello/manual/autoconf/Function-Portability.html
 #ifndef isnan
     # define isnan(x) \
@@ -85,6 +92,7 @@
 
 // workaround for postgres defining their OIDs in a private header file
 #define QBOOLOID 16
+#define QNAMEOID 19
 #define QINT8OID 20
 #define QINT2OID 21
 #define QINT4OID 23
@@ -103,6 +111,9 @@
 #define QREGPROCOID 24
 #define QXIDOID 28
 #define QCIDOID 29
+#define QTEXTOID 25
+#define QBPCHAROID 1042
+#define QVARCHAROID 1043
 
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
@@ -122,6 +133,8 @@ inline void qPQfreemem(void *buffer)
     PQfreemem(buffer);
 }
 
+class QPSQLResultPrivate;
+
 class QPSQLDriverPrivate : public QSqlDriverPrivate
 {
 public:
@@ -132,25 +145,45 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        hasIntegerDatetimes(false),
+        streamingResult(0),
+        asyncSent(false)
     { dbmsType = PostgreSQL; }
 
     QPSQLDriver *q;
     PGconn *connection;
     bool isUtf8;
     QPSQLDriver::Protocol pro;
-    QSocketNotifier *sn;
+    mutable QSocketNotifier *sn; // notifications and QSqlAsyncQuery results
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    bool hasIntegerDatetimes;
+    // the forward-only result whose rows are still arriving on the connection
+    mutable QPSQLResultPrivate *streamingResult;
+    // the results of QSqlAsyncQuery in the order they were started; the
+    // first one is running on the connection if asyncSent is true
+    mutable QList<QPSQLResultPrivate *> asyncQueue;
+    mutable bool asyncSent;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    bool sendQuery(const QString &stmt) const;
+    void finishStreaming() const;
+    void queueAsync(QPSQLResultPrivate *result) const;
+    void sendAsync() const;
+    void readAsyncResults() const;
+    void finishAsync(const QPSQLResultPrivate *until = 0) const;
+    void abandonAsync(QPSQLResultPrivate *result) const;
+    void abortAsync() const;
+    void checkNotifications() const;
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
     void detectBackslashEscape();
+    void detectIntegerDatetimes();
 };
 
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
@@ -177,13 +210,19 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
     }
 }
 
-PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+void QPSQLDriverPrivate::checkNotifications() const
 {
-    PGresult *result = PQexec(connection, stmt);
     if (seid.size() && !pendingNotifyCheck) {
         pendingNotifyCheck = true;
         QMetaObject::invokeMethod(q, "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
     }
+}
+
+PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+{
+    finishStreaming();
+    PGresult *result = PQexec(connection, stmt);
+    checkNotifications();
     return result;
 }
 
@@ -192,6 +231,15 @@ PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
     return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
 }
 
+bool QPSQLDriverPrivate::sendQuery(const QString &stmt) const
+{
+    finishStreaming();
+    const int sent = PQsendQuery(connection, isUtf8 ? stmt.toUtf8().constData()
+                                                    : stmt.toLocal8Bit().constData());
+    checkNotifications();
+    return sent;
+}
+
 class QPSQLResultPrivate : public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLResult)
@@ -200,7 +248,13 @@ public:
       : QSqlResultPrivate(),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        rowOffset(0),
+        preparedQueriesEnabled(false),
+        singleRowMode(false),
+        streaming(false),
+        binaryResults(false),
+        batchStmtRows(0),
+        asyncPending(false)
     { }
 
     QString fieldSerial(int i) const { return QLatin1Char('$') + QString::number(i + 1); }
@@ -208,17 +262,44 @@ public:
     const QPSQLDriverPrivate * privDriver() const {Q_Q(const QPSQLResult); return reinterpret_cast<const QPSQLDriver *>(q->driver())->d; }
 
     PGresult *result;
+    // rows of a single-row mode result that were read ahead because
+    // another statement needed the connection
+    QList<PGresult *> bufferedRows;
     int currentSize;
+    int rowOffset; // the row index of the first row in result
     bool preparedQueriesEnabled;
+    bool singleRowMode;
+    bool streaming; // more rows are waiting on the connection
+    bool binaryResults; // the prepared statement returns its rows in binary format
     QString preparedStmtId;
+    QString preparedQuery; // the prepared statement text, with $n placeholders
+    QVector<Oid> paramTypes;
+    int batchStmtRows; // the rows of the prepared multi-row INSERT used by execBatch()
+    // a statement started by QSqlAsyncQuery, with $n placeholders
+    QSqlResultAsyncExec asyncRequest;
+    QString asyncQuery;
+    QVector<QVariant> asyncValues;
+    bool asyncPending; // queued or running on the connection
 
     bool processResults();
+    bool execute(const QString &stmt);
+    bool executePrepared(const QVector<QVariant> &values);
+    bool executeBatch(const QVector<QVariantList> &columns, const QString &head,
+                      const QStringList &segments, const QVector<int> &params);
+    bool startStreaming();
+    bool fetchNextRow();
+    void bufferRemainingRows();
+    void discardRemainingRows();
+    bool sendAsyncQuery();
+    void addAsyncResult(PGresult *next);
+    void completeAsync(bool sent);
 };
 
 static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
                             const QPSQLDriverPrivate *p, PGresult* result = 0)
 {
-    const char *s = PQerrorMessage(p->connection);
+    // the connection may have moved on since a buffered result was received
+    const char *s = result ? PQresultErrorMessage(result) : PQerrorMessage(p->connection);
     QString msg = p->isUtf8 ? QString::fromUtf8(s) : QString::fromLocal8Bit(s);
     if (result) {
       const char *sCode = PQresultErrorField(result, PG_DIAG_SQLSTATE);
@@ -250,6 +331,651 @@ bool QPSQLResultPrivate::processResults()
     return false;
 }
 
+bool QPSQLResultPrivate::execute(const QString &stmt)
+{
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    Q_Q(QPSQLResult);
+    if (q->isForwardOnly()) {
+        // Forward-only queries are read one row at a time instead of
+        // loading the whole result set into memory first
+        if (!privDriver()->sendQuery(stmt)) {
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to create query"), QSqlError::StatementError, privDriver()));
+            return false;
+        }
+        return startStreaming();
+    }
+#endif
+    result = privDriver()->exec(stmt);
+    return processResults();
+}
+
+// Encodes value in the binary format of the parameter type, fails if
+// the value has to be converted by the server
+static bool qEncodeBinaryParam(Oid type, const QVariant &value, QByteArray *out)
+{
+    const int valueType = value.userType();
+    const bool isIntegral = valueType == QMetaType::Int || valueType == QMetaType::UInt
+            || valueType == QMetaType::LongLong || valueType == QMetaType::ULongLong
+            || valueType == QMetaType::Short || valueType == QMetaType::UShort;
+
+    switch (type) {
+    case QINT2OID:
+    case QINT4OID:
+    case QINT8OID: {
+        if (!isIntegral)
+            return false;
+        if (valueType == QMetaType::ULongLong && value.toULongLong() > quint64(Q_INT64_C(0x7fffffffffffffff)))
+            return false;
+        const qint64 n = value.toLongLong();
+        if (type == QINT2OID) {
+            if (n < -32768 || n > 32767)
+                return false;
+            out->resize(2);
+            qToBigEndian<qint16>(qint16(n), reinterpret_cast<uchar *>(out->data()));
+        } else if (type == QINT4OID) {
+            if (n < INT_MIN || n > INT_MAX)
+                return false;
+            out->resize(4);
+            qToBigEndian<qint32>(qint32(n), reinterpret_cast<uchar *>(out->data()));
+        } else {
+            out->resize(8);
+            qToBigEndian<qint64>(n, reinterpret_cast<uchar *>(out->data()));
+        }
+        return true;
+    }
+    case QFLOAT4OID:
+    case QFLOAT8OID: {
+        if (!isIntegral && valueType != QMetaType::Double && valueType != QMetaType::Float)
+            return false;
+        if (type == QFLOAT4OID) {
+            const float f = value.toFloat();
+            quint32 bits;
+            memcpy(&bits, &f, sizeof(bits));
+            out->resize(4);
+            qToBigEndian<quint32>(bits, reinterpret_cast<uchar *>(out->data()));
+        } else {
+            const double d = value.toDouble();
+            quint64 bits;
+            memcpy(&bits, &d, sizeof(bits));
+            out->resize(8);
+            qToBigEndian<quint64>(bits, reinterpret_cast<uchar *>(out->data()));
+        }
+        return true;
+    }
+    case QBOOLOID:
+        if (valueType != QMetaType::Bool)
+            return false;
+        *out = QByteArray(1, value.toBool() ? 1 : 0);
+        return true;
+    case QBYTEAOID:
+        if (valueType != QMetaType::QByteArray)
+            return false;
+        *out = value.toByteArray();
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+// Text format of value as a parameter, mirrors QPSQLDriver::formatValue()
+// without the quoting. Returns false for values that are sent as NULL.
+static bool qEncodeTextParam(const QVariant &value, bool isUtf8, QByteArray *out)
+{
+    switch (value.type()) {
+#ifndef QT_NO_DATESTRING
+    case QVariant::DateTime: {
+        const QDateTime dateTime = value.toDateTime();
+        if (!dateTime.isValid())
+            return false;
+        const QDate dt = dateTime.date();
+        const QTime tm = dateTime.time();
+        // msecs need to be right aligned otherwise psql interprets them wrong
+        *out = QString(QString::number(dt.year()) + QLatin1Char('-')
+                       + QString::number(dt.month()) + QLatin1Char('-')
+                       + QString::number(dt.day()) + QLatin1Char(' ')
+                       + tm.toString() + QLatin1Char('.')
+                       + QString::number(tm.msec()).rightJustified(3, QLatin1Char('0'))).toLatin1();
+        return true;
+    }
+    case QVariant::Date:
+        if (!value.toDate().isValid())
+            return false;
+        *out = value.toDate().toString(Qt::ISODate).toLatin1();
+        return true;
+    case QVariant::Time:
+        if (!value.toTime().isValid())
+            return false;
+        *out = value.toTime().toString(QLatin1String("hh:mm:ss.zzz")).toLatin1();
+        return true;
+#endif
+    case QVariant::Bool:
+        *out = value.toBool() ? "TRUE" : "FALSE";
+        return true;
+    case QVariant::ByteArray:
+        *out = value.toByteArray();
+        return true;
+    case QVariant::Double: {
+        const double val = value.toDouble();
+        if (isnan(val)) {
+            *out = "NaN";
+            return true;
+        }
+        const int res = isinf(val);
+        if (res == 1) {
+            *out = "Infinity";
+            return true;
+        } else if (res == -1) {
+            *out = "-Infinity";
+            return true;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    const QString str = value.toString();
+    *out = isUtf8 ? str.toUtf8() : str.toLocal8Bit();
+    return true;
+}
+
+// Encodes a parameter for PQexecPrepared() and friends, binary if the type
+// allows it. Returns false if the parameter has to be sent as NULL.
+static bool qEncodeParam(Oid type, const QVariant &value, bool isUtf8, QByteArray *data, int *format)
+{
+    if (value.isNull())
+        return false;
+    if (type != InvalidOid && qEncodeBinaryParam(type, value, data)) {
+        *format = 1;
+        return true;
+    }
+    *format = 0;
+    return qEncodeTextParam(value, isUtf8, data);
+}
+
+// The parameter arrays of PQexecParams() and friends
+struct QPSQLParams
+{
+    QPSQLParams(const QVector<QVariant> &values, const QVector<Oid> &types, bool isUtf8)
+        : data(values.count()), pointers(values.count()), lengths(values.count()),
+          formats(values.count())
+    {
+        for (int i = 0; i < values.count(); ++i) {
+            const Oid type = i < types.count() ? types.at(i) : InvalidOid;
+            if (!qEncodeParam(type, values.at(i), isUtf8, &data[i], &formats[i]))
+                continue;
+            pointers[i] = data.at(i).constData();
+            lengths[i] = data.at(i).size();
+        }
+    }
+
+    QVector<QByteArray> data;
+    QVector<const char *> pointers;
+    QVector<int> lengths;
+    QVector<int> formats;
+};
+
+bool QPSQLResultPrivate::executePrepared(const QVector<QVariant> &values)
+{
+    Q_Q(QPSQLResult);
+    const QPSQLDriverPrivate *drv = privDriver();
+    const int count = values.count();
+    const QPSQLParams params(values, paramTypes, drv->isUtf8);
+
+    const QByteArray stmtId = preparedStmtId.toLatin1();
+    drv->finishStreaming();
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    if (q->isForwardOnly()) {
+        const int sent = PQsendQueryPrepared(drv->connection, stmtId.constData(), count,
+                                             params.pointers.constData(), params.lengths.constData(),
+                                             params.formats.constData(), binaryResults ? 1 : 0);
+        drv->checkNotifications();
+        if (!sent) {
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to create query"), QSqlError::StatementError, drv));
+            return false;
+        }
+        return startStreaming();
+    }
+#else
+    Q_UNUSED(q);
+#endif
+    result = PQexecPrepared(drv->connection, stmtId.constData(), count,
+                            params.pointers.constData(), params.lengths.constData(),
+                            params.formats.constData(), binaryResults ? 1 : 0);
+    drv->checkNotifications();
+    return processResults();
+}
+
+// Splits "INSERT ... VALUES (<tuple>)" into the part up to the tuple and
+// the tuple itself, with the tuple broken up at its $n placeholders. Fails
+// for anything it cannot safely repeat the tuple of, e.g. placeholders
+// outside the tuple, several tuples, RETURNING or ON CONFLICT clauses,
+// comments and dollar quoted strings.
+static bool qSplitInsertStatement(const QString &stmt, int paramCount, QString *head,
+                                  QStringList *segments, QVector<int> *params)
+{
+    const int n = stmt.size();
+    int i = 0;
+    while (i < n && stmt.at(i).isSpace())
+        ++i;
+    if (stmt.mid(i, 6).compare(QLatin1String("INSERT"), Qt::CaseInsensitive) != 0)
+        return false;
+
+    int depth = 0;
+    int tupleStart = -1;
+    int tupleEnd = -1;
+    bool afterValues = false;
+    QChar quote;
+    QString segment;
+    for (; i < n; ++i) {
+        const QChar ch = stmt.at(i);
+        if (!quote.isNull()) {
+            if (ch == QLatin1Char('\\'))
+                return false;
+            if (ch == quote)
+                quote = QChar();
+        } else if (ch == QLatin1Char('\'') || ch == QLatin1Char('"')) {
+            quote = ch;
+        } else if (ch == QLatin1Char('$')) {
+            int end = i + 1;
+            int number = 0;
+            while (end < n && stmt.at(end).isDigit())
+                number = number * 10 + stmt.at(end++).digitValue();
+            if (end == i + 1 || tupleStart < 0 || tupleEnd >= 0 || number < 1 || number > paramCount)
+                return false;
+            segments->append(segment);
+            segment.clear();
+            params->append(number - 1);
+            i = end - 1;
+            continue;
+        } else if ((ch == QLatin1Char('-') || ch == QLatin1Char('/')) && i + 1 < n
+                   && stmt.at(i + 1) == (ch == QLatin1Char('-') ? QLatin1Char('-') : QLatin1Char('*'))) {
+            return false;
+        } else if (ch == QLatin1Char('(')) {
+            if (depth == 0 && afterValues) {
+                if (tupleStart >= 0)
+                    return false;
+                tupleStart = i;
+                afterValues = false;
+            }
+            ++depth;
+        } else if (ch == QLatin1Char(')')) {
+            if (--depth < 0)
+                return false;
+            if (depth == 0 && tupleStart >= 0 && tupleEnd < 0) {
+                tupleEnd = i;
+                segment += ch;
+                continue;
+            }
+        } else if (depth == 0 && tupleEnd >= 0) {
+            // only a terminating semicolon may follow the tuple
+            if (!ch.isSpace() && ch != QLatin1Char(';'))
+                return false;
+            continue;
+        } else if (depth == 0 && (ch == QLatin1Char('v') || ch == QLatin1Char('V'))
+                   && (i == 0 || !stmt.at(i - 1).isLetterOrNumber())
+                   && stmt.mid(i, 6).compare(QLatin1String("VALUES"), Qt::CaseInsensitive) == 0
+                   && (i + 6 == n || !stmt.at(i + 6).isLetterOrNumber())) {
+            if (tupleStart >= 0)
+                return false;
+            afterValues = true;
+            head->append(stmt.mid(i, 6));
+            i += 5;
+            continue;
+        } else if (afterValues && !ch.isSpace()) {
+            return false;
+        }
+        if (tupleStart < 0)
+            head->append(ch);
+        else
+            segment += ch;
+    }
+    if (tupleEnd < 0 || depth != 0 || !quote.isNull())
+        return false;
+    segments->append(segment);
+    return true;
+}
+
+// The multi-row INSERT for count rows, the placeholders of row r are
+// numbered from r * paramCount + 1
+static QString qMultiRowInsert(const QString &head, const QStringList &segments,
+                               const QVector<int> &params, int paramCount, int count)
+{
+    QString stmt = head;
+    for (int r = 0; r < count; ++r) {
+        if (r)
+            stmt += QLatin1Char(',');
+        for (int j = 0; j < params.count(); ++j) {
+            stmt += segments.at(j);
+            stmt += QLatin1Char('$');
+            stmt += QString::number(r * paramCount + params.at(j) + 1);
+        }
+        stmt += segments.last();
+    }
+    return stmt;
+}
+
+// Inserts the rows with multi-row INSERT statements of up to batchRowLimit
+// rows each, instead of sending every row on its own
+bool QPSQLResultPrivate::executeBatch(const QVector<QVariantList> &columns, const QString &head,
+                                      const QStringList &segments, const QVector<int> &params)
+{
+    static const int batchRowLimit = 1000;
+    static const int maxParams = 65535;
+
+    Q_Q(QPSQLResult);
+    const QPSQLDriverPrivate *drv = privDriver();
+    const int paramCount = columns.count();
+    const int rowCount = columns.at(0).count();
+    const int chunkRows = qMax(1, qMin(qMin(rowCount, batchRowLimit), maxParams / paramCount));
+    const QByteArray batchStmtId = (preparedStmtId + QLatin1String("_batch")).toLatin1();
+
+    QVector<Oid> types;
+    if (paramTypes.count() == paramCount) {
+        types.resize(chunkRows * paramCount);
+        for (int i = 0; i < types.count(); ++i)
+            types[i] = paramTypes.at(i % paramCount);
+    }
+
+    drv->finishStreaming();
+    if (chunkRows > 1 && batchStmtRows != chunkRows) {
+        if (batchStmtRows) {
+            PQclear(PQexec(drv->connection, ("DEALLOCATE " + batchStmtId).constData()));
+            batchStmtRows = 0;
+        }
+        const QString stmt = qMultiRowInsert(head, segments, params, paramCount, chunkRows);
+        result = PQprepare(drv->connection, batchStmtId.constData(),
+                           drv->isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData(),
+                           chunkRows * paramCount, types.isEmpty() ? 0 : types.constData());
+        if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to prepare statement"), QSqlError::StatementError, drv, result));
+            drv->checkNotifications();
+            return false;
+        }
+        PQclear(result);
+        result = 0;
+        batchStmtRows = chunkRows;
+    }
+
+    // several statements only insert all rows or none inside a transaction
+    const bool ownTransaction = rowCount > chunkRows
+            && PQtransactionStatus(drv->connection) == PQTRANS_IDLE;
+    if (ownTransaction)
+        PQclear(PQexec(drv->connection, "BEGIN"));
+
+    QVector<QByteArray> data(chunkRows * paramCount);
+    QVector<const char *> pointers(data.count());
+    QVector<int> lengths(data.count());
+    QVector<int> formats(data.count());
+    bool ok = true;
+    for (int first = 0; ok && first < rowCount; first += chunkRows) {
+        const int count = qMin(chunkRows, rowCount - first);
+        for (int r = 0; r < count; ++r) {
+            for (int c = 0; c < paramCount; ++c) {
+                const int i = r * paramCount + c;
+                const Oid type = types.isEmpty() ? InvalidOid : types.at(i);
+                if (qEncodeParam(type, columns.at(c).at(first + r), drv->isUtf8, &data[i], &formats[i])) {
+                    pointers[i] = data.at(i).constData();
+                    lengths[i] = data.at(i).size();
+                } else {
+                    pointers[i] = 0;
+                    lengths[i] = 0;
+                    formats[i] = 0;
+                }
+            }
+        }
+        if (result)
+            PQclear(result);
+        if (count == batchStmtRows) {
+            result = PQexecPrepared(drv->connection, batchStmtId.constData(), count * paramCount,
+                                    pointers.constData(), lengths.constData(), formats.constData(), 0);
+        } else {
+            const QString stmt = qMultiRowInsert(head, segments, params, paramCount, count);
+            result = PQexecParams(drv->connection,
+                                  drv->isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData(),
+                                  count * paramCount, types.isEmpty() ? 0 : types.constData(),
+                                  pointers.constData(), lengths.constData(), formats.constData(), 0);
+        }
+        ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    }
+    if (!ok) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to execute batch"), QSqlError::StatementError, drv, result));
+    }
+    if (ownTransaction) {
+        PGresult *res = PQexec(drv->connection, ok ? "COMMIT" : "ROLLBACK");
+        if (ok && PQresultStatus(res) != PGRES_COMMAND_OK) {
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to execute batch"), QSqlError::TransactionError, drv, res));
+            ok = false;
+        }
+        PQclear(res);
+    }
+    drv->checkNotifications();
+    if (!ok)
+        return false;
+    q->setSelect(false);
+    q->setActive(true);
+    return true;
+}
+
+bool QPSQLResultPrivate::startStreaming()
+{
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    Q_Q(QPSQLResult);
+    const QPSQLDriverPrivate *drv = privDriver();
+    PQsetSingleRowMode(drv->connection);
+    result = PQgetResult(drv->connection);
+    if (PQresultStatus(result) == PGRES_SINGLE_TUPLE) {
+        singleRowMode = true;
+        streaming = true;
+        drv->streamingResult = this;
+        q->setSelect(true);
+        q->setActive(true);
+        currentSize = -1;
+        return true;
+    }
+
+    // no rows at all, collect the remaining results the way PQexec() does
+    while (PGresult *next = PQgetResult(drv->connection)) {
+        if (PQresultStatus(result) == PGRES_FATAL_ERROR) {
+            PQclear(next);
+        } else {
+            PQclear(result);
+            result = next;
+        }
+    }
+#endif
+    return processResults();
+}
+
+bool QPSQLResultPrivate::fetchNextRow()
+{
+    PGresult *next = 0;
+    if (!bufferedRows.isEmpty())
+        next = bufferedRows.takeFirst();
+    else if (streaming)
+        next = PQgetResult(privDriver()->connection);
+
+    if (next && PQresultStatus(next) == PGRES_SINGLE_TUPLE) {
+        PQclear(result);
+        result = next;
+        ++rowOffset;
+        return true;
+    }
+
+    // either the end of the result set or an error in the middle of it
+    if (next && PQresultStatus(next) != PGRES_TUPLES_OK) {
+        Q_Q(QPSQLResult);
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to fetch row"), QSqlError::StatementError, privDriver(), next));
+    }
+    if (next)
+        PQclear(next);
+    discardRemainingRows();
+    return false;
+}
+
+void QPSQLResultPrivate::bufferRemainingRows()
+{
+    while (PGresult *next = PQgetResult(privDriver()->connection))
+        bufferedRows.append(next);
+    streaming = false;
+    privDriver()->streamingResult = 0;
+}
+
+void QPSQLResultPrivate::discardRemainingRows()
+{
+    for (int i = 0; i < bufferedRows.count(); ++i)
+        PQclear(bufferedRows.at(i));
+    bufferedRows.clear();
+    if (streaming) {
+        while (PGresult *next = PQgetResult(privDriver()->connection))
+            PQclear(next);
+        streaming = false;
+        privDriver()->streamingResult = 0;
+    }
+}
+
+void QPSQLDriverPrivate::finishStreaming() const
+{
+    // Only one statement can run on a connection at a time. The rows of
+    // an unfinished forward-only result are kept in memory so that it
+    // remains usable after the other statement.
+    if (streamingResult)
+        streamingResult->bufferRemainingRows();
+    // statements of QSqlAsyncQuery that were started before go first
+    if (!asyncQueue.isEmpty())
+        finishAsync();
+}
+
+bool QPSQLResultPrivate::sendAsyncQuery()
+{
+    const QPSQLDriverPrivate *drv = privDriver();
+    const QByteArray stmt = drv->isUtf8 ? asyncQuery.toUtf8() : asyncQuery.toLocal8Bit();
+    // PQsendQueryParams() does not take several statements at once
+    if (asyncValues.isEmpty())
+        return PQsendQuery(drv->connection, stmt.constData());
+
+    // the parameter types are left to the server, as for an unprepared query
+    const QPSQLParams params(asyncValues, QVector<Oid>(), drv->isUtf8);
+    return PQsendQueryParams(drv->connection, stmt.constData(), asyncValues.count(), 0,
+                             params.pointers.constData(), params.lengths.constData(),
+                             params.formats.constData(), 0);
+}
+
+void QPSQLResultPrivate::addAsyncResult(PGresult *next)
+{
+    // keep the last result, or the first error, the way PQexec() does
+    if (!result) {
+        result = next;
+    } else if (PQresultStatus(result) == PGRES_FATAL_ERROR) {
+        PQclear(next);
+    } else {
+        PQclear(result);
+        result = next;
+    }
+}
+
+void QPSQLResultPrivate::completeAsync(bool sent)
+{
+    Q_Q(QPSQLResult);
+    asyncPending = false;
+    if (!sent || !processResults()) {
+        if (!q->lastError().isValid())
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to create query"), QSqlError::StatementError, privDriver()));
+    }
+    asyncRequest.notify();
+}
+
+void QPSQLDriverPrivate::queueAsync(QPSQLResultPrivate *result) const
+{
+    // the results are read as they arrive, from the event loop
+    if (!sn) {
+        sn = new QSocketNotifier(PQsocket(connection), QSocketNotifier::Read);
+        QObject::connect(sn, SIGNAL(activated(int)), q, SLOT(_q_handleNotification(int)));
+    }
+    result->asyncPending = true;
+    asyncQueue.append(result);
+    sendAsync();
+}
+
+void QPSQLDriverPrivate::sendAsync() const
+{
+    while (!asyncSent && !asyncQueue.isEmpty()) {
+        if (streamingResult)
+            streamingResult->bufferRemainingRows();
+        QPSQLResultPrivate *result = asyncQueue.first();
+        if (result->sendAsyncQuery()) {
+            asyncSent = true;
+            return;
+        }
+        asyncQueue.removeFirst();
+        result->completeAsync(false);
+    }
+}
+
+void QPSQLDriverPrivate::readAsyncResults() const
+{
+    // the input has been consumed already, PQgetResult() must not block
+    while (asyncSent && !PQisBusy(connection)) {
+        QPSQLResultPrivate *result = asyncQueue.first();
+        if (PGresult *next = PQgetResult(connection)) {
+            result->addAsyncResult(next);
+            continue;
+        }
+        asyncQueue.removeFirst();
+        asyncSent = false;
+        result->completeAsync(true);
+        sendAsync();
+    }
+}
+
+void QPSQLDriverPrivate::finishAsync(const QPSQLResultPrivate *until) const
+{
+    // Waits for the statements in the order they were started, up to and
+    // including until, or all of them. The ones after until keep running.
+    while (!asyncQueue.isEmpty() && (!until || until->asyncPending)) {
+        sendAsync();
+        if (!asyncSent)
+            break;
+        QPSQLResultPrivate *result = asyncQueue.takeFirst();
+        while (PGresult *next = PQgetResult(connection))
+            result->addAsyncResult(next);
+        asyncSent = false;
+        result->completeAsync(true);
+    }
+    sendAsync();
+    checkNotifications();
+}
+
+void QPSQLDriverPrivate::abandonAsync(QPSQLResultPrivate *result) const
+{
+    if (asyncSent && asyncQueue.first() == result) {
+        // the statement is running already, its result has to be read
+        while (PGresult *next = PQgetResult(connection))
+            PQclear(next);
+        asyncQueue.removeFirst();
+        asyncSent = false;
+        sendAsync();
+    } else {
+        asyncQueue.removeOne(result);
+    }
+    result->asyncPending = false;
+}
+
+void QPSQLDriverPrivate::abortAsync() const
+{
+    // the connection is going away, nothing more is sent
+    asyncSent = false;
+    while (!asyncQueue.isEmpty())
+        asyncQueue.takeFirst()->completeAsync(false);
+}
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -296,6 +1022,171 @@ static QVariant::Type qDecodePSQLType(int t)
     return type;
 }
 
+// Whether values of the type can be decoded from the binary result format
+static bool qIsBinaryType(Oid t, bool integerDatetimes)
+{
+    switch (t) {
+    case QBOOLOID:
+    case QINT2OID:
+    case QINT4OID:
+    case QINT8OID:
+    case QFLOAT4OID:
+    case QFLOAT8OID:
+    case QNUMERICOID:
+    case QBYTEAOID:
+    case QTEXTOID:
+    case QVARCHAROID:
+    case QBPCHAROID:
+    case QNAMEOID:
+        return true;
+#ifndef QT_NO_DATESTRING
+    case QDATEOID:
+    case QTIMEOID:
+    case QTIMESTAMPOID:
+        // the binary format of float datetimes is not supported
+        return integerDatetimes;
+#endif
+    default:
+        break;
+    }
+    return false;
+}
+
+static QVariant qNumericValue(const char *val, QSql::NumericalPrecisionPolicy policy)
+{
+    if (policy != QSql::HighPrecision) {
+        QVariant retval;
+        bool convert;
+        double dbl=QString::fromLatin1(val).toDouble(&convert);
+        if (policy == QSql::LowPrecisionInt64)
+            retval = (qlonglong)dbl;
+        else if (policy == QSql::LowPrecisionInt32)
+            retval = (int)dbl;
+        else if (policy == QSql::LowPrecisionDouble)
+            retval = dbl;
+        if (!convert)
+            return QVariant();
+        return retval;
+    }
+    return QString::fromLatin1(val);
+}
+
+// Converts a binary numeric to the text the server would have sent
+static QByteArray qNumericToText(const char *val, int len)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(val);
+    if (len < 8)
+        return QByteArray();
+    const int ndigits = qFromBigEndian<quint16>(data);
+    const int weight = qFromBigEndian<qint16>(data + 2);
+    const int sign = qFromBigEndian<quint16>(data + 4);
+    const int dscale = qFromBigEndian<quint16>(data + 6);
+    if (len < 8 + 2 * ndigits)
+        return QByteArray();
+    if (sign == 0xC000)
+        return QByteArray("NaN");
+    if (sign == 0xD000)
+        return QByteArray("Infinity");
+    if (sign == 0xF000)
+        return QByteArray("-Infinity");
+
+    // the digits are base 10000, weight is the exponent of the first one
+    QByteArray text;
+    char buf[8];
+    if (sign == 0x4000)
+        text += '-';
+    if (weight < 0)
+        text += '0';
+    for (int i = 0; i <= weight; ++i) {
+        const int digit = i < ndigits ? qFromBigEndian<quint16>(data + 8 + 2 * i) : 0;
+        qsnprintf(buf, sizeof(buf), i ? "%04d" : "%d", digit);
+        text += buf;
+    }
+    if (dscale > 0) {
+        text += '.';
+        for (int i = weight + 1, written = 0; written < dscale; ++i) {
+            const int digit = (i >= 0 && i < ndigits) ? qFromBigEndian<quint16>(data + 8 + 2 * i) : 0;
+            qsnprintf(buf, sizeof(buf), "%04d", digit);
+            const int n = qMin(4, dscale - written);
+            text.append(buf, n);
+            written += n;
+        }
+    }
+    return text;
+}
+
+static double qDecodeBinaryFloat(int ptype, const uchar *data)
+{
+    if (ptype == QFLOAT4OID) {
+        const quint32 bits = qFromBigEndian<quint32>(data);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+    const quint64 bits = qFromBigEndian<quint64>(data);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Decodes a value of one of the types accepted by qIsBinaryType(). The
+// resulting types are the same as for the text format.
+static QVariant qDecodeBinaryValue(int ptype, const char *val, int len, bool isUtf8,
+                                   QSql::NumericalPrecisionPolicy policy)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(val);
+    switch (ptype) {
+    case QBOOLOID:
+        return QVariant(bool(val[0] != 0));
+    case QINT2OID:
+        return QVariant(int(qFromBigEndian<qint16>(data)));
+    case QINT4OID:
+        return QVariant(int(qFromBigEndian<qint32>(data)));
+    case QINT8OID: {
+        const qint64 n = qFromBigEndian<qint64>(data);
+        if (n < 0)
+            return QVariant(qlonglong(n));
+        return QVariant(qulonglong(n));
+    }
+    case QFLOAT4OID:
+    case QFLOAT8OID:
+        return QVariant(qDecodeBinaryFloat(ptype, data));
+    case QNUMERICOID:
+        return qNumericValue(qNumericToText(val, len).constData(), policy);
+    case QBYTEAOID:
+        return QVariant(QByteArray(val, len));
+#ifndef QT_NO_DATESTRING
+    // dates and times count from 2000-01-01 00:00:00
+    case QDATEOID: {
+        const qint32 days = qFromBigEndian<qint32>(data);
+        if (days == INT_MAX || days == INT_MIN) // +/- infinity
+            return QVariant(QDate());
+        return QVariant(QDate(2000, 1, 1).addDays(days));
+    }
+    case QTIMEOID: {
+        const qint64 usecs = qFromBigEndian<qint64>(data);
+        return QVariant(QTime(0, 0).addMSecs(int(usecs / 1000)));
+    }
+    case QTIMESTAMPOID: {
+        const qint64 usecs = qFromBigEndian<qint64>(data);
+        if (usecs == Q_INT64_C(0x7fffffffffffffff) || usecs == -Q_INT64_C(0x7fffffffffffffff) - 1)
+            return QVariant(QDateTime());
+        const qint64 usecsPerDay = Q_INT64_C(86400000000);
+        qint64 days = usecs / usecsPerDay;
+        qint64 rest = usecs % usecsPerDay;
+        if (rest < 0) {
+            rest += usecsPerDay;
+            --days;
+        }
+        return QVariant(QDateTime(QDate(2000, 1, 1).addDays(days), QTime(0, 0).addMSecs(int(rest / 1000))));
+    }
+#endif
+    default:
+        break;
+    }
+    return isUtf8 ? QString::fromUtf8(val, len) : QString::fromLatin1(val, len);
+}
+
 void QPSQLResultPrivate::deallocatePreparedStmt()
 {
     const QString stmt = QLatin1String("DEALLOCATE ") + preparedStmtId;
@@ -304,6 +1195,10 @@ void QPSQLResultPrivate::deallocatePreparedStmt()
     if (PQresultStatus(result) != PGRES_COMMAND_OK)
         qWarning("Unable to free statement: %s", PQerrorMessage(privDriver()->connection));
     PQclear(result);
+    if (batchStmtRows) {
+        PQclear(privDriver()->exec(stmt + QLatin1String("_batch")));
+        batchStmtRows = 0;
+    }
     preparedStmtId.clear();
 }
 
@@ -332,6 +1227,11 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+    if (d->asyncPending)
+        d->privDriver()->abandonAsync(d);
+    d->discardRemainingRows();
+    d->singleRowMode = false;
+    d->rowOffset = 0;
     if (d->result)
         PQclear(d->result);
     d->result = 0;
@@ -342,11 +1242,21 @@ void QPSQLResult::cleanup()
 
 bool QPSQLResult::fetch(int i)
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
     if (!isActive())
         return false;
     if (i < 0)
         return false;
+    if (d->singleRowMode) {
+        if (i < d->rowOffset)
+            return false;
+        while (i > d->rowOffset) {
+            if (!d->fetchNextRow())
+                return false;
+        }
+        setAt(i);
+        return true;
+    }
     if (i >= d->currentSize)
         return false;
     if (at() == i)
@@ -362,7 +1272,17 @@ bool QPSQLResult::fetchFirst()
 
 bool QPSQLResult::fetchLast()
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
+    if (d->singleRowMode) {
+        if (!isActive())
+            return false;
+        while (d->fetchNextRow())
+            ;
+        if (lastError().isValid())
+            return false;
+        setAt(d->rowOffset);
+        return true;
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
@@ -375,9 +1295,13 @@ QVariant QPSQLResult::data(int i)
     }
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const int row = at() - d->rowOffset;
+    const char *val = PQgetvalue(d->result, row, i);
+    if (PQgetisnull(d->result, row, i))
         return QVariant(type);
+    if (PQfformat(d->result, i) == 1)
+        return qDecodeBinaryValue(ptype, val, PQgetlength(d->result, row, i),
+                                  d->privDriver()->isUtf8, numericalPrecisionPolicy());
     switch (type) {
     case QVariant::Bool:
         return QVariant((bool)(val[0] == 't'));
@@ -385,29 +1309,14 @@ QVariant QPSQLResult::data(int i)
         return d->privDriver()->isUtf8 ? QString::fromUtf8(val) : QString::fromLatin1(val);
     case QVariant::LongLong:
         if (val[0] == '-')
-            return QString::fromLatin1(val).toLongLong();
+            return qlonglong(strtoll(val, 0, 10));
         else
-            return QString::fromLatin1(val).toULongLong();
+            return qulonglong(strtoull(val, 0, 10));
     case QVariant::Int:
         return atoi(val);
     case QVariant::Double:
-        if (ptype == QNUMERICOID) {
-            if (numericalPrecisionPolicy() != QSql::HighPrecision) {
-                QVariant retval;
-                bool convert;
-                double dbl=QString::fromLatin1(val).toDouble(&convert);
-                if (numericalPrecisionPolicy() == QSql::LowPrecisionInt64)
-                    retval = (qlonglong)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionInt32)
-                    retval = (int)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionDouble)
-                    retval = dbl;
-                if (!convert)
-                    return QVariant();
-                return retval;
-            }
-            return QString::fromLatin1(val);
-        }
+        if (ptype == QNUMERICOID)
+            return qNumericValue(val, numericalPrecisionPolicy());
         return QString::fromLatin1(val).toDouble();
     case QVariant::Date:
         if (val[0] == '\0') {
@@ -470,8 +1379,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int row = at() - d->rowOffset;
+    PQgetvalue(d->result, row, field);
+    return PQgetisnull(d->result, row, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -482,8 +1392,7 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
-    d->result = d->privDriver()->exec(query);
-    return d->processResults();
+    return d->execute(query);
 }
 
 int QPSQLResult::size()
@@ -544,33 +1453,109 @@ QSqlRecord QPSQLResult::record() const
     return info;
 }
 
-void QPSQLResult::virtual_hook(int id, void *data)
+void QPSQLResult::detachFromResultSet()
 {
-    Q_ASSERT(data);
-
-    QSqlResult::virtual_hook(id, data);
+    Q_D(QPSQLResult);
+    d->discardRemainingRows();
 }
 
-static QString qCreateParamString(const QVector<QVariant> boundValues, const QSqlDriver *driver)
+// Answers QSqlQuery's typed accessors from the PGresult buffer. Types that
+// have no direct representation are left to the QVariant conversion.
+static void qFetchTypedValue(const PGresult *result, int row, bool isUtf8,
+                             QSqlResultTypedValue *value)
 {
-    if (boundValues.isEmpty())
-        return QString();
+    const int i = value->index;
+    if (PQgetisnull(result, row, i)) {
+        value->setNull();
+        return;
+    }
+    const Oid ptype = PQftype(result, i);
+    const char *val = PQgetvalue(result, row, i);
+    const int len = PQgetlength(result, row, i);
+    const bool wantsText = value->type == QMetaType::QByteArray;
+    if (PQfformat(result, i) == 1) {
+        const uchar *data = reinterpret_cast<const uchar *>(val);
+        switch (ptype) {
+        case QINT2OID:
+            if (!wantsText)
+                value->setLongLong(qFromBigEndian<qint16>(data));
+            break;
+        case QINT4OID:
+            if (!wantsText)
+                value->setLongLong(qFromBigEndian<qint32>(data));
+            break;
+        case QINT8OID:
+            if (!wantsText)
+                value->setLongLong(qFromBigEndian<qint64>(data));
+            break;
+        case QFLOAT4OID:
+        case QFLOAT8OID:
+            if (!wantsText)
+                value->setDouble(qDecodeBinaryFloat(ptype, data));
+            break;
+        case QTEXTOID:
+        case QVARCHAROID:
+        case QBPCHAROID:
+        case QNAMEOID:
+            // libpq terminates binary values as well
+            value->setText(val, len, isUtf8);
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+    switch (qDecodePSQLType(ptype)) {
+    case QVariant::Int:
+    case QVariant::LongLong:
+        if (!wantsText)
+            value->setText(val, len, isUtf8);
+        break;
+    case QVariant::Double:
+        if (!wantsText)
+            value->setDoubleText(val, len);
+        break;
+    case QVariant::String:
+        value->setText(val, len, isUtf8);
+        break;
+    default:
+        break;
+    }
+}
 
-    QString params;
-    QSqlField f;
-    for (int i = 0; i < boundValues.count(); ++i) {
-        const QVariant &val = boundValues.at(i);
+void QPSQLResult::virtual_hook(int id, void *data)
+{
+    Q_ASSERT(data);
 
-        f.setType(val.type());
-        if (val.isNull())
-            f.clear();
-        else
-            f.setValue(val);
-        if(!params.isNull())
-            params.append(QLatin1String(", "));
-        params.append(driver->formatValue(f));
+    switch (id) {
+    case QSqlResult::FetchTypedValue: {
+        Q_D(QPSQLResult);
+        QSqlResultTypedValue *value = static_cast<QSqlResultTypedValue *>(data);
+        if (d->result && value->index >= 0 && value->index < PQnfields(d->result))
+            qFetchTypedValue(d->result, at() - d->rowOffset, d->privDriver()->isUtf8, value);
+        break; }
+    case QSqlResult::ExecAsync: {
+        Q_D(QPSQLResult);
+        if (!driver() || !driver()->isOpen() || driver()->isOpenError())
+            break;
+        QSqlResultAsyncExec *request = static_cast<QSqlResultAsyncExec *>(data);
+        cleanup();
+        d->binaryResults = false;
+        d->asyncRequest = *request;
+        d->asyncQuery = d->positionalToNamedBinding(executedQuery());
+        d->asyncValues = boundValues();
+        request->handled = true;
+        d->privDriver()->queueAsync(d);
+        break; }
+    case QSqlResult::WaitForAsync: {
+        Q_D(QPSQLResult);
+        if (d->asyncPending)
+            d->privDriver()->finishAsync(d);
+        *static_cast<bool *>(data) = true;
+        break; }
+    default:
+        QSqlResult::virtual_hook(id, data);
     }
-    return params;
 }
 
 Q_GLOBAL_STATIC(QMutex, qMutex)
@@ -594,21 +1579,44 @@ bool QPSQLResult::prepare(const QString &query)
     if (!d->preparedStmtId.isEmpty())
         d->deallocatePreparedStmt();
 
+    const QPSQLDriverPrivate *drv = d->privDriver();
     const QString stmtId = qMakePreparedStmtId();
-    const QString stmt = QString::fromLatin1("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
+    const QString stmt = d->positionalToNamedBinding(query);
 
-    PGresult *result = d->privDriver()->exec(stmt);
+    drv->finishStreaming();
+    PGresult *result = PQprepare(drv->connection, stmtId.toLatin1().constData(),
+                                 drv->isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData(),
+                                 0, 0);
 
     if (PQresultStatus(result) != PGRES_COMMAND_OK) {
         setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
-                                "Unable to prepare statement"), QSqlError::StatementError, d->privDriver(), result));
+                                "Unable to prepare statement"), QSqlError::StatementError, drv, result));
         PQclear(result);
         d->preparedStmtId.clear();
+        drv->checkNotifications();
         return false;
     }
-
     PQclear(result);
     d->preparedStmtId = stmtId;
+    d->preparedQuery = stmt;
+
+    // The parameter types decide which values can be sent in binary
+    // format; rows are received in binary if every column type allows it.
+    d->paramTypes.clear();
+    d->binaryResults = false;
+    result = PQdescribePrepared(drv->connection, stmtId.toLatin1().constData());
+    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+        const int paramCount = PQnparams(result);
+        d->paramTypes.resize(paramCount);
+        for (int i = 0; i < paramCount; ++i)
+            d->paramTypes[i] = PQparamtype(result, i);
+        const int fieldCount = PQnfields(result);
+        d->binaryResults = fieldCount > 0;
+        for (int i = 0; i < fieldCount && d->binaryResults; ++i)
+            d->binaryResults = qIsBinaryType(PQftype(result, i), drv->hasIntegerDatetimes);
+    }
+    PQclear(result);
+    drv->checkNotifications();
     return true;
 }
 
@@ -620,16 +1628,57 @@ bool QPSQLResult::exec()
 
     cleanup();
 
-    QString stmt;
-    const QString params = qCreateParamString(boundValues(), driver());
-    if (params.isEmpty())
-        stmt = QString::fromLatin1("EXECUTE %1").arg(d->preparedStmtId);
-    else
-        stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId).arg(params);
+    return d->executePrepared(boundValues());
+}
 
-    d->result = d->privDriver()->exec(stmt);
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    const QVector<QVariant> values = boundValues();
+    if (!d->preparedQueriesEnabled || d->preparedStmtId.isEmpty() || values.isEmpty())
+        return QSqlResult::execBatch(arrayBind);
+
+    const int paramCount = values.count();
+    QVector<QVariantList> columns(paramCount);
+    for (int i = 0; i < paramCount; ++i)
+        columns[i] = values.at(i).toList();
+    const int rowCount = columns.at(0).count();
+    for (int i = 1; i < paramCount; ++i) {
+        if (columns.at(i).count() != rowCount) {
+            setLastError(QSqlError(QCoreApplication::translate("QPSQLResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
 
-    return d->processResults();
+    // only plain INSERT ... VALUES statements can be turned into a multi-row insert
+    QString head;
+    QStringList segments;
+    QVector<int> params;
+    if (rowCount < 2 || !qSplitInsertStatement(d->preparedQuery, paramCount, &head, &segments, &params)) {
+        // the rows are executed one by one, within one transaction
+        const QPSQLDriverPrivate *drv = d->privDriver();
+        drv->finishStreaming();
+        const bool ownTransaction = rowCount > 1
+                && PQtransactionStatus(drv->connection) == PQTRANS_IDLE;
+        if (ownTransaction)
+            PQclear(PQexec(drv->connection, "BEGIN"));
+        bool ok = QSqlResult::execBatch(arrayBind);
+        if (ownTransaction) {
+            PGresult *res = PQexec(drv->connection, ok ? "COMMIT" : "ROLLBACK");
+            if (ok && PQresultStatus(res) != PGRES_COMMAND_OK) {
+                setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                             "Unable to execute batch"), QSqlError::TransactionError, drv, res));
+                ok = false;
+            }
+            PQclear(res);
+        }
+        return ok;
+    }
+
+    cleanup();
+    setLastError(QSqlError());
+    return d->executeBatch(columns, head, segments, params);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -651,6 +1700,13 @@ void QPSQLDriverPrivate::setDatestyle()
     PQclear(result);
 }
 
+void QPSQLDriverPrivate::detectIntegerDatetimes()
+{
+    // reported by servers since 8.0, the only choice since 10
+    const char *value = PQparameterStatus(connection, "integer_datetimes");
+    hasIntegerDatetimes = value && qstrcmp(value, "on") == 0;
+}
+
 void QPSQLDriverPrivate::detectBackslashEscape()
 {
     // standard_conforming_strings option introduced in 8.2
@@ -707,6 +1763,9 @@ static QPSQLDriver::Protocol qMakePSQLVersion(int vMaj, int vMin)
         return QPSQLDriver::Version9;
         break;
     default:
+        // newer servers are treated like 9.x
+        if (vMaj > 9)
+            return QPSQLDriver::Version9;
         break;
     }
     return QPSQLDriver::VersionUnknown;
@@ -780,6 +1839,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
     if (conn) {
         d->pro = d->getPSQLVersion();
         d->detectBackslashEscape();
+        d->detectIntegerDatetimes();
         setOpen(true);
         setOpenError(false);
     }
@@ -792,6 +1852,9 @@ void QPSQLDriver::init()
 
 QPSQLDriver::~QPSQLDriver()
 {
+    d->abortAsync();
+    if (d->streamingResult)
+        d->streamingResult->streaming = false;
     if (d->connection)
         PQfinish(d->connection);
 }
@@ -812,8 +1875,8 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
         return true;
     case PreparedQueries:
     case PositionalPlaceholders:
-        return d->pro >= QPSQLDriver::Version82;
     case BatchOperations:
+        return d->pro >= QPSQLDriver::Version82;
     case NamedPlaceholders:
     case SimpleLocking:
     case FinishQuery:
@@ -881,6 +1944,7 @@ bool QPSQLDriver::open(const QString & db,
 
     d->pro = d->getPSQLVersion();
     d->detectBackslashEscape();
+    d->detectIntegerDatetimes();
     d->isUtf8 = d->setEncodingUtf8();
     d->setDatestyle();
 
@@ -900,6 +1964,13 @@ void QPSQLDriver::close()
             d->sn = 0;
         }
 
+        // rows that are still on the way are lost with the connection
+        d->abortAsync();
+        if (d->streamingResult) {
+            d->streamingResult->streaming = false;
+            d->streamingResult = 0;
+        }
+
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
@@ -1393,7 +2464,8 @@ bool QPSQLDriver::unsubscribeFromNotification(const QString &name)
 
     d->seid.removeAll(name);
 
-    if (d->seid.isEmpty()) {
+    // the socket notifier also reads the results of QSqlAsyncQuery
+    if (d->seid.isEmpty() && d->asyncQueue.isEmpty()) {
         disconnect(d->sn, SIGNAL(activated(int)), this, SLOT(_q_handleNotification(int)));
         delete d->sn;
         d->sn = 0;
@@ -1411,6 +2483,7 @@ void QPSQLDriver::_q_handleNotification(int)
 {
     d->pendingNotifyCheck = false;
     PQconsumeInput(d->connection);
+    d->readAsyncResults();
 
     PGnotify *notify = 0;
     while((notify = PQnotifies(d->connection)) != 0) {
@@ -96,6 +96,8 @@ protected:
     QVariant lastInsertId() const;
     bool prepare(const QString& query);
     bool exec();
+    bool execBatch(bool arrayBind = false);
+    void detachFromResultSet();
 };
 
 class QPSQLDriverPrivate;
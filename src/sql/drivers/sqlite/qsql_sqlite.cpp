@@ -41,16 +41,21 @@
 
 #include "qsql_sqlite_p.h"
 
+#include <qcache.h>
 #include <qcoreapplication.h>
+#include <qmutex.h>
+#include <qthread.h>
 #include <qvariant.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
 #include <qsqlindex.h>
 #include <qsqlquery.h>
 #include <QtSql/private/qsqlcachedresult_p.h>
+#include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 #include <qstringlist.h>
 #include <qvector.h>
+#include <qwaitcondition.h>
 #include <qdebug.h>
 
 #if defined Q_OS_WIN
@@ -114,6 +119,7 @@ class QSQLiteResult : public QSqlCachedResult
 {
     friend class QSQLiteDriver;
     friend class QSQLiteResultPrivate;
+    friend class QSQLiteAsyncWorker;
 public:
     explicit QSQLiteResult(const QSQLiteDriver* db);
     ~QSQLiteResult();
@@ -121,9 +127,12 @@ public:
 
 protected:
     bool gotoNext(QSqlCachedResult::ValueCache& row, int idx);
+    QVariant data(int i);
+    bool isNull(int i);
     bool reset(const QString &query);
     bool prepare(const QString &query);
     bool exec();
+    bool execBatch(bool arrayBind = false);
     int size();
     int numRowsAffected();
     QVariant lastInsertId() const;
@@ -135,12 +144,74 @@ private:
     QSQLiteResultPrivate* d;
 };
 
+#if (SQLITE_VERSION_NUMBER >= 3003011)
+// statements prepared with sqlite3_prepare16() cannot be kept, they
+// fail with SQLITE_SCHEMA instead of being prepared again when needed
+# define QT_SQLITE_STATEMENT_CACHE
+#endif
+
+enum { DefaultStatementCacheSize = 16 };
+
+// a statement that is not used by any result, owned by the statement cache
+struct QSQLiteCachedStatement
+{
+    explicit QSQLiteCachedStatement(sqlite3_stmt *statement) : stmt(statement) { }
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *take()
+    {
+        sqlite3_stmt *statement = stmt;
+        stmt = 0;
+        return statement;
+    }
+
+    sqlite3_stmt *stmt;
+};
+
+// Executes the statements of QSqlAsyncQuery on a connection, one after
+// the other. Only used for connections opened in serialized mode
+// (QSQLITE_OPEN_FULLMUTEX), which the thread the driver lives in can use
+// at the same time.
+class QSQLiteAsyncWorker : public QThread
+{
+public:
+    QSQLiteAsyncWorker() : running(0), stopping(false) { }
+
+    void enqueue(QSQLiteResult *result);
+    void waitFor(const QSQLiteResult *result);
+    void remove(QSQLiteResult *result);
+    void stop();
+
+protected:
+    void run();
+
+private:
+    QMutex mutex;
+    QWaitCondition queued;
+    QWaitCondition finished;
+    QList<QSQLiteResult *> jobs;
+    QSQLiteResult *running;
+    bool stopping;
+};
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
 public:
-    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0) { dbmsType = SQLite; }
+    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0), utf8(false), asyncWorker(0)
+    {
+        dbmsType = SQLite;
+        statements.setMaxCost(DefaultStatementCacheSize);
+    }
+    void stopAsyncWorker();
+
     sqlite3 *access;
     QList <QSQLiteResult *> results;
+    bool utf8; // use the UTF-8 API, the database stores its text in UTF-8
+    // finished statements by query text, for prepare() to pick up again;
+    // the asynchronous worker uses it as well
+    QCache<QString, QSQLiteCachedStatement> statements;
+    QMutex statementsMutex;
+    QSQLiteAsyncWorker *asyncWorker; // started by the first QSqlAsyncQuery
 };
 
 
@@ -150,24 +221,128 @@ public:
     QSQLiteResultPrivate(QSQLiteResult *res);
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    void readRow(QSqlCachedResult::ValueCache &values, int idx);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
+    void execAsync();
 
     QSQLiteResult* q;
     sqlite3 *access;
+    QSQLiteDriverPrivate *drv_d;
 
     sqlite3_stmt *stmt;
+    QString stmtQuery; // the query text stmt goes back into the statement cache with
+    bool utf8;
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
+    bool forwardOnly;
+    bool rowPending; // current row not yet copied into the cache (forward only)
     QSqlRecord rInf;
     QVector<QVariant> firstRow;
+
+    QSqlResultAsyncExec asyncRequest;
+    bool asyncPending; // queued or running in the worker, guarded by its mutex
+    bool executedAsync;
+    // read in the worker, the connection may have moved on since
+    int asyncRowsAffected;
+    qint64 asyncInsertId;
 };
 
-QSQLiteResultPrivate::QSQLiteResultPrivate(QSQLiteResult* res) : q(res), access(0),
-    stmt(0), skippedStatus(false), skipRow(false)
+QSQLiteResultPrivate::QSQLiteResultPrivate(QSQLiteResult* res) : q(res), access(0), drv_d(0),
+    stmt(0), utf8(false), skippedStatus(false), skipRow(false), forwardOnly(false), rowPending(false),
+    asyncPending(false), executedAsync(false), asyncRowsAffected(-1), asyncInsertId(0)
+{
+}
+
+void QSQLiteResultPrivate::execAsync()
 {
+    // runs in the worker thread, nothing else touches the result meanwhile
+    if (q->prepare(q->executedQuery()) && q->exec()) {
+        asyncRowsAffected = sqlite3_changes(access);
+        asyncInsertId = sqlite3_last_insert_rowid(access);
+        // read all the rows, navigating the result must not block
+        if (q->isSelect()) {
+            q->fetchLast();
+            q->setAt(QSql::BeforeFirstRow);
+        }
+    }
+    executedAsync = true;
+    asyncRequest.notify();
+}
+
+void QSQLiteAsyncWorker::enqueue(QSQLiteResult *result)
+{
+    QMutexLocker locker(&mutex);
+    result->d->asyncPending = true;
+    jobs.append(result);
+    queued.wakeOne();
+}
+
+void QSQLiteAsyncWorker::waitFor(const QSQLiteResult *result)
+{
+    QMutexLocker locker(&mutex);
+    while (result->d->asyncPending)
+        finished.wait(&mutex);
+}
+
+void QSQLiteAsyncWorker::remove(QSQLiteResult *result)
+{
+    QMutexLocker locker(&mutex);
+    jobs.removeOne(result);
+    while (running == result)
+        finished.wait(&mutex);
+    result->d->asyncPending = false;
+}
+
+void QSQLiteAsyncWorker::stop()
+{
+    QList<QSQLiteResult *> dropped;
+    {
+        QMutexLocker locker(&mutex);
+        dropped.swap(jobs);
+        for (int i = 0; i < dropped.count(); ++i)
+            dropped.at(i)->d->asyncPending = false;
+        stopping = true;
+        queued.wakeOne();
+    }
+    // the statement that is running already is finished first
+    wait();
+
+    for (int i = 0; i < dropped.count(); ++i) {
+        QSQLiteResult *result = dropped.at(i);
+        result->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                             "Unable to execute statement"), QString(), QSqlError::ConnectionError));
+        result->d->asyncRequest.notify();
+    }
+}
+
+void QSQLiteAsyncWorker::run()
+{
+    QMutexLocker locker(&mutex);
+    forever {
+        while (jobs.isEmpty() && !stopping)
+            queued.wait(&mutex);
+        if (jobs.isEmpty())
+            return;
+        running = jobs.takeFirst();
+        locker.unlock();
+        running->d->execAsync();
+        locker.relock();
+        running->d->asyncPending = false;
+        running = 0;
+        finished.wakeAll();
+    }
+}
+
+void QSQLiteDriverPrivate::stopAsyncWorker()
+{
+    if (!asyncWorker)
+        return;
+    asyncWorker->stop();
+    delete asyncWorker;
+    asyncWorker = 0;
 }
 
 void QSQLiteResultPrivate::cleanup()
@@ -176,6 +351,7 @@ void QSQLiteResultPrivate::cleanup()
     rInf.clear();
     skippedStatus = false;
     skipRow = false;
+    rowPending = false;
     q->setAt(QSql::BeforeFirstRow);
     q->setActive(false);
     q->cleanup();
@@ -183,11 +359,22 @@ void QSQLiteResultPrivate::cleanup()
 
 void QSQLiteResultPrivate::finalize()
 {
+    rowPending = false;
     if (!stmt)
         return;
 
-    sqlite3_finalize(stmt);
+    // the driver is gone if the connection was removed while the query was alive
+    if (!stmtQuery.isEmpty() && q->driver() && drv_d->access == access
+            && drv_d->statements.maxCost() > 0) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        QMutexLocker locker(&drv_d->statementsMutex);
+        drv_d->statements.insert(stmtQuery, new QSQLiteCachedStatement(stmt));
+    } else {
+        sqlite3_finalize(stmt);
+    }
     stmt = 0;
+    stmtQuery.clear();
 }
 
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
@@ -199,13 +386,19 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     q->init(nCols);
 
     for (int i = 0; i < nCols; ++i) {
-        QString colName = QString(reinterpret_cast<const QChar *>(
-                    sqlite3_column_name16(stmt, i))
-                    ).remove(QLatin1Char('"'));
-
-        // must use typeName for resolving the type to match QSqliteDriver::record
-        QString typeName = QString(reinterpret_cast<const QChar *>(
-                    sqlite3_column_decltype16(stmt, i)));
+        QString colName;
+        QString typeName;
+        if (utf8) {
+            colName = QString::fromUtf8(sqlite3_column_name(stmt, i)).remove(QLatin1Char('"'));
+            // must use typeName for resolving the type to match QSqliteDriver::record
+            typeName = QString::fromUtf8(sqlite3_column_decltype(stmt, i));
+        } else {
+            colName = QString(reinterpret_cast<const QChar *>(
+                        sqlite3_column_name16(stmt, i))
+                        ).remove(QLatin1Char('"'));
+            typeName = QString(reinterpret_cast<const QChar *>(
+                        sqlite3_column_decltype16(stmt, i)));
+        }
         // sqlite3_column_type is documented to have undefined behavior if the result set is empty
         int stp = emptyResultset ? -1 : sqlite3_column_type(stmt, i);
 
@@ -244,22 +437,22 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
 bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch)
 {
     int res;
-    int i;
 
     if (skipRow) {
         // already fetched
         Q_ASSERT(!initialFetch);
         skipRow = false;
-        for(int i=0;i<firstRow.count();i++)
-            values[i]=firstRow[i];
+        if (forwardOnly) {
+            // the statement is still positioned on the first row
+            rowPending = skippedStatus;
+        } else {
+            for(int i=0;i<firstRow.count();i++)
+                values[i]=firstRow[i];
+        }
         return skippedStatus;
     }
     skipRow = initialFetch;
-
-    if(initialFetch) {
-        firstRow.clear();
-        firstRow.resize(sqlite3_column_count(stmt));
-    }
+    rowPending = false;
 
     if (!stmt) {
         q->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult", "Unable to fetch row"),
@@ -269,49 +462,27 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     }
     res = sqlite3_step(stmt);
 
+    // a statement that outlived a schema change is prepared again by
+    // sqlite3_step(), so the column count is only known after it
+    if(initialFetch) {
+        firstRow.clear();
+        firstRow.resize(sqlite3_column_count(stmt));
+    }
+
     switch(res) {
     case SQLITE_ROW:
         // check to see if should fill out columns
         if (rInf.isEmpty())
             // must be first call.
             initColumns(false);
-        if (idx < 0 && !initialFetch)
+        if (forwardOnly) {
+            // converted on demand by data(), typed access reads the statement directly
+            rowPending = true;
             return true;
-        for (i = 0; i < rInf.count(); ++i) {
-            switch (sqlite3_column_type(stmt, i)) {
-            case SQLITE_BLOB:
-                values[i + idx] = QByteArray(static_cast<const char *>(
-                            sqlite3_column_blob(stmt, i)),
-                            sqlite3_column_bytes(stmt, i));
-                break;
-            case SQLITE_INTEGER:
-                values[i + idx] = sqlite3_column_int64(stmt, i);
-                break;
-            case SQLITE_FLOAT:
-                switch(q->numericalPrecisionPolicy()) {
-                    case QSql::LowPrecisionInt32:
-                        values[i + idx] = sqlite3_column_int(stmt, i);
-                        break;
-                    case QSql::LowPrecisionInt64:
-                        values[i + idx] = sqlite3_column_int64(stmt, i);
-                        break;
-                    case QSql::LowPrecisionDouble:
-                    case QSql::HighPrecision:
-                    default:
-                        values[i + idx] = sqlite3_column_double(stmt, i);
-                        break;
-                };
-                break;
-            case SQLITE_NULL:
-                values[i + idx] = QVariant(QVariant::String);
-                break;
-            default:
-                values[i + idx] = QString(reinterpret_cast<const QChar *>(
-                            sqlite3_column_text16(stmt, i)),
-                            sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
-                break;
-            }
         }
+        if (idx < 0 && !initialFetch)
+            return true;
+        readRow(values, idx);
         return true;
     case SQLITE_DONE:
         if (rInf.isEmpty())
@@ -342,26 +513,132 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     return false;
 }
 
+void QSQLiteResultPrivate::readRow(QSqlCachedResult::ValueCache &values, int idx)
+{
+    rowPending = false;
+    for (int i = 0; i < rInf.count(); ++i) {
+        switch (sqlite3_column_type(stmt, i)) {
+        case SQLITE_BLOB:
+            values[i + idx] = QByteArray(static_cast<const char *>(
+                        sqlite3_column_blob(stmt, i)),
+                        sqlite3_column_bytes(stmt, i));
+            break;
+        case SQLITE_INTEGER:
+            values[i + idx] = sqlite3_column_int64(stmt, i);
+            break;
+        case SQLITE_FLOAT:
+            switch(q->numericalPrecisionPolicy()) {
+                case QSql::LowPrecisionInt32:
+                    values[i + idx] = sqlite3_column_int(stmt, i);
+                    break;
+                case QSql::LowPrecisionInt64:
+                    values[i + idx] = sqlite3_column_int64(stmt, i);
+                    break;
+                case QSql::LowPrecisionDouble:
+                case QSql::HighPrecision:
+                default:
+                    values[i + idx] = sqlite3_column_double(stmt, i);
+                    break;
+            };
+            break;
+        case SQLITE_NULL:
+            values[i + idx] = QVariant(QVariant::String);
+            break;
+        default:
+            if (utf8) {
+                // sqlite3_column_text() must be called before sqlite3_column_bytes()
+                const char *text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, i));
+                values[i + idx] = QString::fromUtf8(text, sqlite3_column_bytes(stmt, i));
+            } else {
+                values[i + idx] = QString(reinterpret_cast<const QChar *>(
+                            sqlite3_column_text16(stmt, i)),
+                            sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+            }
+            break;
+        }
+    }
+}
+
 QSQLiteResult::QSQLiteResult(const QSQLiteDriver* db)
     : QSqlCachedResult(db)
 {
     d = new QSQLiteResultPrivate(this);
     d->access = db->d->access;
+    d->drv_d = db->d;
     db->d->results.append(this);
 }
 
 QSQLiteResult::~QSQLiteResult()
 {
     const QSqlDriver *sqlDriver = driver();
-    if (sqlDriver)
-        qobject_cast<const QSQLiteDriver *>(sqlDriver)->d->results.removeOne(this);
+    if (sqlDriver) {
+        QSQLiteDriverPrivate *drv_d = qobject_cast<const QSQLiteDriver *>(sqlDriver)->d;
+        if (drv_d->asyncWorker)
+            drv_d->asyncWorker->remove(this);
+        drv_d->results.removeOne(this);
+    }
     d->cleanup();
     delete d;
 }
 
+static void qFetchTypedValue(sqlite3_stmt *stmt, QSqlResultTypedValue *value)
+{
+    const int i = value->index;
+    switch (sqlite3_column_type(stmt, i)) {
+    case SQLITE_NULL:
+        value->setNull();
+        break;
+    case SQLITE_INTEGER:
+        if (value->type != QMetaType::QByteArray)
+            value->setLongLong(sqlite3_column_int64(stmt, i));
+        break;
+    case SQLITE_FLOAT:
+        if (value->type != QMetaType::QByteArray)
+            value->setDouble(sqlite3_column_double(stmt, i));
+        break;
+    case SQLITE_TEXT:
+        // sqlite3_column_text() must be called before sqlite3_column_bytes()
+        value->setText(reinterpret_cast<const char *>(sqlite3_column_text(stmt, i)),
+                       sqlite3_column_bytes(stmt, i), true);
+        break;
+    default:
+        break;
+    }
+}
+
 void QSQLiteResult::virtual_hook(int id, void *data)
 {
-    QSqlCachedResult::virtual_hook(id, data);
+    switch (id) {
+    case QSqlResult::FetchTypedValue: {
+        // only forward only queries keep the statement on the current row
+        QSqlResultTypedValue *value = static_cast<QSqlResultTypedValue *>(data);
+        if (d->forwardOnly && d->stmt && at() >= 0
+                && value->index >= 0 && value->index < d->rInf.count())
+            qFetchTypedValue(d->stmt, value);
+        break; }
+    case QSqlResult::ExecAsync: {
+        // the worker shares the connection, which needs to be serialized;
+        // otherwise QSqlAsyncQuery executes the statement synchronously
+        if (!driver() || !driver()->isOpen() || driver()->isOpenError()
+                || !sqlite3_db_mutex(d->access))
+            break;
+        QSqlResultAsyncExec *request = static_cast<QSqlResultAsyncExec *>(data);
+        d->asyncRequest = *request;
+        request->handled = true;
+        if (!d->drv_d->asyncWorker) {
+            d->drv_d->asyncWorker = new QSQLiteAsyncWorker;
+            d->drv_d->asyncWorker->start();
+        }
+        d->drv_d->asyncWorker->enqueue(this);
+        break; }
+    case QSqlResult::WaitForAsync:
+        if (driver() && d->drv_d->asyncWorker)
+            d->drv_d->asyncWorker->waitFor(this);
+        *static_cast<bool *>(data) = true;
+        break;
+    default:
+        QSqlCachedResult::virtual_hook(id, data);
+    }
 }
 
 bool QSQLiteResult::reset(const QString &query)
@@ -380,36 +657,107 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
-    const void *pzTail = NULL;
+    d->utf8 = d->drv_d->utf8;
 
+#ifdef QT_SQLITE_STATEMENT_CACHE
+    d->drv_d->statementsMutex.lock();
+    QSQLiteCachedStatement *cached = d->drv_d->statements.take(query);
+    d->drv_d->statementsMutex.unlock();
+    if (cached) {
+        d->stmt = cached->take();
+        d->stmtQuery = query;
+        delete cached;
+        return true;
+    }
+#endif
+
+    int res;
+    bool tail;
+    if (d->utf8) {
+        const QByteArray utf8Query = query.toUtf8();
+        const char *pzTail = NULL;
 #if (SQLITE_VERSION_NUMBER >= 3003011)
-    int res = sqlite3_prepare16_v2(d->access, query.constData(), (query.size() + 1) * sizeof(QChar),
+        res = sqlite3_prepare_v2(d->access, utf8Query.constData(), utf8Query.size() + 1,
+                                 &d->stmt, &pzTail);
+#else
+        res = sqlite3_prepare(d->access, utf8Query.constData(), utf8Query.size() + 1,
+                              &d->stmt, &pzTail);
+#endif
+        tail = pzTail && !QString::fromUtf8(pzTail).trimmed().isEmpty();
+    } else {
+        const void *pzTail = NULL;
+#if (SQLITE_VERSION_NUMBER >= 3003011)
+        res = sqlite3_prepare16_v2(d->access, query.constData(), (query.size() + 1) * sizeof(QChar),
                                    &d->stmt, &pzTail);
 #else
-    int res = sqlite3_prepare16(d->access, query.constData(), (query.size() + 1) * sizeof(QChar),
+        res = sqlite3_prepare16(d->access, query.constData(), (query.size() + 1) * sizeof(QChar),
                                 &d->stmt, &pzTail);
 #endif
+        tail = pzTail && !QString(reinterpret_cast<const QChar *>(pzTail)).trimmed().isEmpty();
+    }
 
     if (res != SQLITE_OK) {
         setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
                      "Unable to execute statement"), QSqlError::StatementError, res));
         d->finalize();
         return false;
-    } else if (pzTail && !QString(reinterpret_cast<const QChar *>(pzTail)).trimmed().isEmpty()) {
+    } else if (tail) {
         setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
             "Unable to execute multiple statements at a time"), QSqlError::StatementError, SQLITE_MISUSE));
         d->finalize();
         return false;
     }
+#ifdef QT_SQLITE_STATEMENT_CACHE
+    if (d->stmt)
+        d->stmtQuery = query;
+#endif
     return true;
 }
 
+// Binds value to the parameter at index (1-based). Strings and byte arrays
+// are not copied, the bound values must outlive the statement execution.
+static int qBindValue(sqlite3_stmt *stmt, int index, const QVariant &value)
+{
+    if (value.isNull())
+        return sqlite3_bind_null(stmt, index);
+
+    switch (value.type()) {
+    case QVariant::ByteArray: {
+        const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
+        return sqlite3_bind_blob(stmt, index, ba->constData(), ba->size(), SQLITE_STATIC);
+    }
+    case QVariant::Int:
+    case QVariant::Bool:
+        return sqlite3_bind_int(stmt, index, value.toInt());
+    case QVariant::Double:
+        return sqlite3_bind_double(stmt, index, value.toDouble());
+    case QVariant::UInt:
+    case QVariant::LongLong:
+        return sqlite3_bind_int64(stmt, index, value.toLongLong());
+    case QVariant::String: {
+        // lifetime of string == lifetime of its qvariant
+        const QString *str = static_cast<const QString*>(value.constData());
+        return sqlite3_bind_text16(stmt, index, str->utf16(),
+                                   (str->size()) * sizeof(QChar), SQLITE_STATIC);
+    }
+    default: {
+        QString str = value.toString();
+        // SQLITE_TRANSIENT makes sure that sqlite buffers the data
+        return sqlite3_bind_text16(stmt, index, str.utf16(),
+                                   (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
+    }
+    }
+}
+
 bool QSQLiteResult::exec()
 {
     const QVector<QVariant> values = boundValues();
 
     d->skippedStatus = false;
     d->skipRow = false;
+    d->rowPending = false;
+    d->forwardOnly = isForwardOnly();
+    d->executedAsync = false;
     d->rInf.clear();
     clearValues();
     setLastError(QSqlError());
@@ -424,43 +772,7 @@ bool QSQLiteResult::exec()
     int paramCount = sqlite3_bind_parameter_count(d->stmt);
     if (paramCount == values.count()) {
         for (int i = 0; i < paramCount; ++i) {
-            res = SQLITE_OK;
-            const QVariant value = values.at(i);
-
-            if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
-            } else {
-                switch (value.type()) {
-                case QVariant::ByteArray: {
-                    const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
-                                            ba->size(), SQLITE_STATIC);
-                    break; }
-                case QVariant::Int:
-                case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
-                    break;
-                case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
-                    break;
-                case QVariant::UInt:
-                case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
-                    break;
-                case QVariant::String: {
-                    // lifetime of string == lifetime of its qvariant
-                    const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
-                                              (str->size()) * sizeof(QChar), SQLITE_STATIC);
-                    break; }
-                default: {
-                    QString str = value.toString();
-                    // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
-                    break; }
-                }
-            }
+            res = qBindValue(d->stmt, i + 1, values.at(i));
             if (res != SQLITE_OK) {
                 setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
@@ -484,11 +796,107 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_UNUSED(arrayBind);
+
+    const QVector<QVariant> values = boundValues();
+    if (values.isEmpty() || !d->stmt)
+        return false;
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rowPending = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+    setSelect(false);
+    setActive(false);
+
+    const int paramCount = values.count();
+    if (sqlite3_bind_parameter_count(d->stmt) != paramCount) {
+        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                        "Parameter count mismatch"), QString(), QSqlError::StatementError));
+        return false;
+    }
+    QVector<QVariantList> columns(paramCount);
+    for (int i = 0; i < paramCount; ++i)
+        columns[i] = values.at(i).toList();
+    const int rowCount = columns.at(0).count();
+    for (int i = 1; i < paramCount; ++i) {
+        if (columns.at(i).count() != rowCount) {
+            setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    // The statement is reset and rebound for every row instead of going
+    // through exec(). The savepoint turns the rows into a single
+    // transaction unless one is open already, and makes the batch atomic.
+    int res = sqlite3_exec(d->access, "SAVEPOINT qt_batch", 0, 0, 0);
+    if (res != SQLITE_OK) {
+        setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to execute statement"), QSqlError::StatementError, res));
+        return false;
+    }
+    for (int row = 0; row < rowCount; ++row) {
+        res = sqlite3_reset(d->stmt);
+        for (int i = 0; i < paramCount && res == SQLITE_OK; ++i)
+            res = qBindValue(d->stmt, i + 1, columns.at(i).at(row));
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to bind parameters"), QSqlError::StatementError, res));
+            break;
+        }
+        res = sqlite3_step(d->stmt);
+        if (res != SQLITE_DONE && res != SQLITE_ROW) {
+            // sqlite3_reset() returns the specific error code
+            res = sqlite3_reset(d->stmt);
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to execute statement"), QSqlError::StatementError, res));
+            break;
+        }
+    }
+    sqlite3_reset(d->stmt);
+    sqlite3_clear_bindings(d->stmt);
+
+    if (lastError().isValid()) {
+        sqlite3_exec(d->access, "ROLLBACK TO qt_batch", 0, 0, 0);
+        sqlite3_exec(d->access, "RELEASE qt_batch", 0, 0, 0);
+        return false;
+    }
+    res = sqlite3_exec(d->access, "RELEASE qt_batch", 0, 0, 0);
+    if (res != SQLITE_OK) {
+        setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to execute statement"), QSqlError::StatementError, res));
+        sqlite3_exec(d->access, "ROLLBACK TO qt_batch", 0, 0, 0);
+        sqlite3_exec(d->access, "RELEASE qt_batch", 0, 0, 0);
+        return false;
+    }
+    setActive(true);
+    return true;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     return d->fetchNext(row, idx, false);
 }
 
+QVariant QSQLiteResult::data(int i)
+{
+    if (d->rowPending && at() >= 0)
+        d->readRow(cache(), 0);
+    return QSqlCachedResult::data(i);
+}
+
+bool QSQLiteResult::isNull(int i)
+{
+    if (d->rowPending && at() >= 0)
+        return i < 0 || i >= d->rInf.count() || sqlite3_column_type(d->stmt, i) == SQLITE_NULL;
+    return QSqlCachedResult::isNull(i);
+}
+
 int QSQLiteResult::size()
 {
     return -1;
@@ -496,13 +904,15 @@ int QSQLiteResult::size()
 
 int QSQLiteResult::numRowsAffected()
 {
+    if (d->executedAsync)
+        return d->asyncRowsAffected;
     return sqlite3_changes(d->access);
 }
 
 QVariant QSQLiteResult::lastInsertId() const
 {
     if (isActive()) {
-        qint64 id = sqlite3_last_insert_rowid(d->access);
+        qint64 id = d->executedAsync ? d->asyncInsertId : sqlite3_last_insert_rowid(d->access);
         if (id)
             return id;
     }
@@ -518,6 +928,7 @@ QSqlRecord QSQLiteResult::record() const
 
 void QSQLiteResult::detachFromResultSet()
 {
+    d->rowPending = false;
     if (d->stmt)
         sqlite3_reset(d->stmt);
 }
@@ -535,11 +946,26 @@ QSQLiteDriver::QSQLiteDriver(QObject * parent)
     d = new QSQLiteDriverPrivate();
 }
 
+// The UTF-8 API saves SQLite from converting every text value to UTF-16,
+// unless the database stores its text as UTF-16 anyway
+static bool qIsUtf8Database(sqlite3 *access)
+{
+    sqlite3_stmt *stmt = 0;
+    if (sqlite3_prepare(access, "PRAGMA encoding", -1, &stmt, 0) != SQLITE_OK)
+        return false;
+    bool utf8 = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        utf8 = qstrcmp(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)), "UTF-8") == 0;
+    sqlite3_finalize(stmt);
+    return utf8;
+}
+
 QSQLiteDriver::QSQLiteDriver(sqlite3 *connection, QObject *parent)
     : QSqlDriver(parent)
 {
     d = new QSQLiteDriverPrivate();
     d->access = connection;
+    d->utf8 = qIsUtf8Database(connection);
     setOpen(true);
     setOpenError(false);
 }
@@ -547,6 +973,7 @@ QSQLiteDriver::QSQLiteDriver(sqlite3 *connection, QObject *parent)
 
 QSQLiteDriver::~QSQLiteDriver()
 {
+    d->stopAsyncWorker();
 }
 
 bool QSQLiteDriver::hasFeature(DriverFeature f) const
@@ -561,10 +988,10 @@ bool QSQLiteDriver::hasFeature(DriverFeature f) const
     case SimpleLocking:
     case FinishQuery:
     case LowPrecisionNumbers:
+    case BatchOperations:
         return true;
     case QuerySize:
     case NamedPlaceholders:
-    case BatchOperations:
     case EventNotifications:
     case MultipleResultSets:
     case CancelQuery:
@@ -585,7 +1012,11 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
     if (db.isEmpty())
         return false;
     bool sharedCache = false;
+    bool utf16Api = false;
+    bool fullMutex = false;
     int openMode = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, timeOut=5000;
+    int statementCacheSize = DefaultStatementCacheSize;
+    QStringList pragmas;
     QStringList opts=QString(conOpts).remove(QLatin1Char(' ')).split(QLatin1Char(';'));
     foreach(const QString &option, opts) {
         if (option.startsWith(QLatin1String("QSQLITE_BUSY_TIMEOUT="))) {
@@ -596,14 +1027,59 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
         }
         if (option == QLatin1String("QSQLITE_OPEN_READONLY"))
             openMode = SQLITE_OPEN_READONLY;
+        if (option == QLatin1String("QSQLITE_OPEN_FULLMUTEX"))
+            fullMutex = true;
         if (option == QLatin1String("QSQLITE_ENABLE_SHARED_CACHE"))
             sharedCache = true;
+        if (option == QLatin1String("QSQLITE_UTF16_API"))
+            utf16Api = true;
+        if (option.startsWith(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE="))) {
+            bool ok;
+            int size = option.mid(29).toInt(&ok);
+            if (ok && size >= 0)
+                statementCacheSize = size;
+        }
+        if (option.startsWith(QLatin1String("QSQLITE_JOURNAL_MODE="))) {
+            const QString mode = option.mid(21).toUpper();
+            static const char * const modes[] = { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" };
+            for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+                if (mode == QLatin1String(modes[i]))
+                    pragmas.append(QLatin1String("PRAGMA journal_mode=") + mode);
+            }
+        }
+        if (option.startsWith(QLatin1String("QSQLITE_MMAP_SIZE="))) {
+            bool ok;
+            qint64 size = option.mid(18).toLongLong(&ok);
+            if (ok && size >= 0)
+                pragmas.append(QLatin1String("PRAGMA mmap_size=") + QString::number(size));
+        }
     }
 
     sqlite3_enable_shared_cache(sharedCache);
 
+#ifdef SQLITE_OPEN_FULLMUTEX
+    // lets QSqlAsyncQuery execute statements in a thread of its own
+    if (fullMutex)
+        openMode |= SQLITE_OPEN_FULLMUTEX;
+#else
+    Q_UNUSED(fullMutex);
+#endif
+
     if (sqlite3_open_v2(db.toUtf8().constData(), &d->access, openMode, NULL) == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
+        foreach (const QString &pragma, pragmas) {
+            const int res = sqlite3_exec(d->access, pragma.toLatin1().constData(), 0, 0, 0);
+            if (res != SQLITE_OK) {
+                setLastError(qMakeError(d->access, tr("Error opening database"),
+                             QSqlError::ConnectionError, res));
+                sqlite3_close(d->access);
+                d->access = 0;
+                setOpenError(true);
+                return false;
+            }
+        }
+        d->utf8 = !utf16Api && qIsUtf8Database(d->access);
+        d->statements.setMaxCost(statementCacheSize);
         setOpen(true);
         setOpenError(false);
         return true;
@@ -623,9 +1099,11 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 void QSQLiteDriver::close()
 {
     if (isOpen()) {
+        d->stopAsyncWorker();
         foreach (QSQLiteResult *result, d->results) {
             result->d->finalize();
         }
+        d->statements.clear();
 
         if (sqlite3_close(d->access) != SQLITE_OK)
             setLastError(qMakeError(d->access, tr("Error closing database"),
@@ -1,6 +1,8 @@
 HEADERS +=      kernel/qsql.h \
                 kernel/qsqlquery.h \
                 kernel/qsqldatabase.h \
+                kernel/qsqlconnectionpool.h \
+                kernel/qsqlasyncquery.h \
                 kernel/qsqlfield.h \
                 kernel/qsqlrecord.h \
                 kernel/qsqldriver.h \
@@ -15,6 +17,8 @@ HEADERS +=      kernel/qsql.h \
 
 SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqldatabase.cpp \
+                kernel/qsqlconnectionpool.cpp \
+                kernel/qsqlasyncquery.cpp \
                 kernel/qsqlfield.cpp \
                 kernel/qsqlrecord.cpp \
                 kernel/qsqldriver.cpp \
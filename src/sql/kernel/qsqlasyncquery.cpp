@@ -0,0 +1,420 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlasyncquery.h"
+
+#include "qsqldriver.h"
+#include "qsqlerror.h"
+#include "qsqlresult.h"
+#include "qsqlresult_p.h"
+#include "qvariant.h"
+#include "qvector.h"
+#include "private/qobject_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSqlAsyncQueryPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSqlAsyncQuery)
+
+public:
+    struct Binding
+    {
+        Binding(const QString &name = QString(), int position = -1,
+                const QVariant &val = QVariant())
+            : placeholder(name), pos(position), value(val)
+        { }
+        QString placeholder;
+        int pos;
+        QVariant value;
+    };
+
+    QSqlAsyncQueryPrivate() : result(0), bindCount(0), tag(0), running(false) { }
+
+    void init(const QSqlDatabase &database);
+    void bind(QSqlResult *res) const;
+    void bind(QSqlQuery *q) const;
+    void startExec();
+    void waitForExec();
+    void _q_execFinished(int id);
+
+    QSqlDatabase db;
+    QSqlQuery query;
+    QSqlResult *result; // owned by query
+    QString queryText;
+    QVector<Binding> bindings;
+    int bindCount;
+    int tag; // identifies the execution the driver reports back for
+    bool running;
+};
+
+void QSqlAsyncQueryPrivate::init(const QSqlDatabase &database)
+{
+    db = database;
+    result = db.driver()->createResult();
+    query = QSqlQuery(result);
+}
+
+void QSqlAsyncQueryPrivate::bind(QSqlResult *res) const
+{
+    for (int i = 0; i < bindings.count(); ++i) {
+        const Binding &b = bindings.at(i);
+        if (b.pos < 0)
+            res->bindValue(b.placeholder, b.value, QSql::In);
+        else
+            res->bindValue(b.pos, b.value, QSql::In);
+    }
+}
+
+void QSqlAsyncQueryPrivate::bind(QSqlQuery *q) const
+{
+    for (int i = 0; i < bindings.count(); ++i) {
+        const Binding &b = bindings.at(i);
+        if (b.pos < 0)
+            q->bindValue(b.placeholder, b.value);
+        else
+            q->bindValue(b.pos, b.value);
+    }
+}
+
+void QSqlAsyncQueryPrivate::startExec()
+{
+    Q_Q(QSqlAsyncQuery);
+
+    // Every execution gets a result of its own. The driver only sees the
+    // query text and the bound values; it runs the statement in one go
+    // instead of going through prepare() and exec(), which would block.
+    result = db.driver()->createResult();
+    query = QSqlQuery(result);
+    running = true;
+    ++tag;
+
+    QSqlResultPrivate *rd = result->d_func();
+    rd->clear();
+    rd->sql = queryText;
+    rd->executedQuery = rd->namedToPositionalBinding(queryText);
+    bind(result);
+
+    QSqlResultAsyncExec request(q, "_q_execFinished", tag);
+    result->virtual_hook(QSqlResult::ExecAsync, &request);
+    if (request.handled)
+        return;
+
+    // the driver cannot run the query in the background
+    if (query.prepare(queryText)) {
+        bind(&query);
+        query.exec();
+    }
+    request.notify();
+}
+
+void QSqlAsyncQueryPrivate::waitForExec()
+{
+    bool finished = false;
+    result->virtual_hook(QSqlResult::WaitForAsync, &finished);
+    // the queued notification still emits finished()
+    running = false;
+}
+
+void QSqlAsyncQueryPrivate::_q_execFinished(int id)
+{
+    Q_Q(QSqlAsyncQuery);
+    // a late notification for an execution that has been replaced
+    if (id != tag)
+        return;
+    running = false;
+    emit q->finished();
+}
+
+/*!
+    \class QSqlAsyncQuery
+    \brief The QSqlAsyncQuery class executes SQL statements without
+    blocking the calling thread.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.2
+
+    QSqlQuery::exec() only returns once the database has executed the
+    statement, which freezes a user interface for the duration of a
+    slow query. QSqlAsyncQuery hands the statement to the driver and
+    returns immediately; the finished() signal is emitted from the event
+    loop once the result is ready:
+
+    \snippet code/src_sql_kernel_qsqlasyncquery.cpp 0
+
+    The results are read with the QSqlQuery returned by query(), which
+    must not be used before the query has finished. Select statements
+    are fully read by the time finished() is emitted, so navigating the
+    result does not block either.
+
+    Several QSqlAsyncQuery objects can be running on the same connection
+    at the same time; the driver executes them one after the other, in
+    the order exec() was called.
+
+    How the statements are executed depends on the driver:
+
+    \list
+    \li The PostgreSQL driver (QPSQL) sends the statement and reads the
+        result as it arrives on the connection, in the thread of the
+        connection. A QSqlQuery that executes a statement on the
+        connection in the meantime first waits for the asynchronous
+        queries that were started before it.
+    \li The SQLite driver (QSQLITE) executes the statements in a
+        background thread owned by the connection, if the connection is
+        in serialized mode, which the \c QSQLITE_OPEN_FULLMUTEX option
+        ensures (see QSqlDatabase::setConnectOptions()). A QSqlQuery that
+        executes a statement on the connection in the meantime does not
+        wait for them. Otherwise exec() blocks as with other drivers.
+    \li All other drivers execute the statement in exec(), so that
+        exec() blocks as QSqlQuery::exec() does. The finished() signal
+        is still emitted from the event loop.
+    \endlist
+
+    A QSqlAsyncQuery can only be used from the thread that created its
+    connection, and that thread needs to run an event loop for
+    finished() to be emitted. waitForFinished() blocks until the query
+    has finished instead.
+
+    \sa QSqlQuery, {Threads and the SQL Module}
+*/
+
+/*!
+    \fn void QSqlAsyncQuery::finished()
+
+    This signal is emitted when the query started by exec() has
+    finished, successfully or not. Use query() to read the result and
+    lastError() to find out what went wrong.
+*/
+
+/*!
+    Constructs a QSqlAsyncQuery for the default database connection,
+    with the given \a parent.
+
+    \sa QSqlDatabase::database()
+*/
+QSqlAsyncQuery::QSqlAsyncQuery(QObject *parent)
+    : QObject(*new QSqlAsyncQueryPrivate, parent)
+{
+    Q_D(QSqlAsyncQuery);
+    d->init(QSqlDatabase::database());
+}
+
+/*!
+    Constructs a QSqlAsyncQuery for the database connection \a db, with
+    the given \a parent.
+*/
+QSqlAsyncQuery::QSqlAsyncQuery(const QSqlDatabase &db, QObject *parent)
+    : QObject(*new QSqlAsyncQueryPrivate, parent)
+{
+    Q_D(QSqlAsyncQuery);
+    d->init(db);
+}
+
+/*!
+    Destroys the object. A query that is still running is waited for.
+*/
+QSqlAsyncQuery::~QSqlAsyncQuery()
+{
+    waitForFinished();
+}
+
+/*!
+    Returns the database connection the query is executed on.
+*/
+QSqlDatabase QSqlAsyncQuery::database() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->db;
+}
+
+/*!
+    Sets the \a query to be executed by exec() and clears the bound
+    values. The query may contain placeholders for binding values, as
+    for QSqlQuery::prepare().
+
+    The query is not sent to the database before exec() is called, so
+    errors in it are only reported when the query has finished. Returns
+    false if the query is empty; otherwise returns true.
+
+    \sa bindValue(), exec()
+*/
+bool QSqlAsyncQuery::prepare(const QString &query)
+{
+    Q_D(QSqlAsyncQuery);
+    if (query.isEmpty()) {
+        qWarning("QSqlAsyncQuery::prepare: empty query");
+        return false;
+    }
+    d->queryText = query;
+    d->bindings.clear();
+    d->bindCount = 0;
+    return true;
+}
+
+/*!
+    Binds the value \a val to the \a placeholder of the prepared query.
+
+    \sa QSqlQuery::bindValue()
+*/
+void QSqlAsyncQuery::bindValue(const QString &placeholder, const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    d->bindings.append(QSqlAsyncQueryPrivate::Binding(placeholder, -1, val));
+}
+
+/*!
+    \overload
+
+    Binds the value \a val to the placeholder at position \a pos of the
+    prepared query. The first placeholder has position 0.
+*/
+void QSqlAsyncQuery::bindValue(int pos, const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    d->bindings.append(QSqlAsyncQueryPrivate::Binding(QString(), pos, val));
+}
+
+/*!
+    Binds the value \a val to the next placeholder of the prepared query.
+
+    \sa QSqlQuery::addBindValue()
+*/
+void QSqlAsyncQuery::addBindValue(const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    d->bindings.append(QSqlAsyncQueryPrivate::Binding(QString(), d->bindCount++, val));
+}
+
+/*!
+    Starts executing \a query, which must not contain placeholders.
+    Returns false if the query could not be started; otherwise returns
+    true and emits finished() later.
+
+    \sa prepare(), isRunning()
+*/
+bool QSqlAsyncQuery::exec(const QString &query)
+{
+    if (!prepare(query))
+        return false;
+    return exec();
+}
+
+/*!
+    \overload
+
+    Starts executing the prepared query with the values bound to it.
+
+    Returns false if the query could not be started, because the
+    connection is not open, no query has been prepared or the previous
+    query is still running. Otherwise returns true; errors in executing
+    the query are reported by lastError() once the query has finished.
+
+    \sa prepare(), finished()
+*/
+bool QSqlAsyncQuery::exec()
+{
+    Q_D(QSqlAsyncQuery);
+    if (d->running) {
+        qWarning("QSqlAsyncQuery::exec: the previous query is still running");
+        return false;
+    }
+    if (!d->db.isOpen() || d->db.isOpenError()) {
+        qWarning("QSqlAsyncQuery::exec: database not open");
+        return false;
+    }
+    if (d->queryText.isEmpty()) {
+        qWarning("QSqlAsyncQuery::exec: empty query");
+        return false;
+    }
+    d->startExec();
+    return true;
+}
+
+/*!
+    Returns true if a query has been started with exec() and has not
+    finished yet; otherwise returns false.
+*/
+bool QSqlAsyncQuery::isRunning() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->running;
+}
+
+/*!
+    Blocks until the running query has finished, and returns true if it
+    was executed successfully; otherwise returns false.
+
+    The finished() signal is still emitted from the event loop
+    afterwards.
+*/
+bool QSqlAsyncQuery::waitForFinished()
+{
+    Q_D(QSqlAsyncQuery);
+    if (d->running)
+        d->waitForExec();
+    return d->query.isActive();
+}
+
+/*!
+    Returns the query that holds the result of the last execution.
+
+    The returned query must not be used while isRunning() is true. It
+    remains valid after another exec(), which uses a new QSqlQuery.
+*/
+QSqlQuery QSqlAsyncQuery::query() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->query;
+}
+
+/*!
+    Returns information about the error of the last execution, if any.
+*/
+QSqlError QSqlAsyncQuery::lastError() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->query.lastError();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qsqlasyncquery.cpp"
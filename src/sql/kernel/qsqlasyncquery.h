@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLASYNCQUERY_H
+#define QSQLASYNCQUERY_H
+
+#include <QtCore/qobject.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqlquery.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlError;
+class QVariant;
+class QSqlAsyncQueryPrivate;
+
+class Q_SQL_EXPORT QSqlAsyncQuery : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QSqlAsyncQuery)
+
+public:
+    explicit QSqlAsyncQuery(QObject *parent = 0);
+    explicit QSqlAsyncQuery(const QSqlDatabase &db, QObject *parent = 0);
+    ~QSqlAsyncQuery();
+
+    QSqlDatabase database() const;
+
+    bool prepare(const QString &query);
+    void bindValue(const QString &placeholder, const QVariant &val);
+    void bindValue(int pos, const QVariant &val);
+    void addBindValue(const QVariant &val);
+
+    bool exec(const QString &query);
+    bool exec();
+    bool isRunning() const;
+    bool waitForFinished();
+
+    QSqlQuery query() const;
+    QSqlError lastError() const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    Q_DISABLE_COPY(QSqlAsyncQuery)
+    Q_PRIVATE_SLOT(d_func(), void _q_execFinished(int))
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLASYNCQUERY_H
@@ -278,9 +278,9 @@ bool QSqlCachedResult::cacheNext()
     if (d->atEnd)
         return false;
 
-    if(isForwardOnly()) {
-        d->cache.clear();
-        d->cache.resize(d->colCount);
+    if (d->forwardOnly) {
+        // reset the single row in place instead of reallocating it for every row
+        d->cache.fill(QVariant());
     }
 
     if (!gotoNext(d->cache, d->nextIndex())) {
@@ -0,0 +1,727 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlconnectionpool.h"
+
+#include "qcache.h"
+#include "qcoreapplication.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qsqlerror.h"
+#include "qsqlquery.h"
+#include "qthread.h"
+#include "qwaitcondition.h"
+
+#include <limits.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QSqlPooledConnection
+{
+    QSqlPooledConnection(const QString &name, int cacheSize)
+        : connectionName(name), thread(QThread::currentThreadId()), inUse(true), evicted(false)
+    {
+        statements.setMaxCost(cacheSize);
+    }
+
+    QString connectionName;
+    Qt::HANDLE thread; // the thread that opened the connection, and the only one closing it
+    bool inUse;
+    bool evicted; // to be closed by its thread instead of being handed out again
+    QElapsedTimer idleTime;
+    // only touched by the thread that has the connection checked out
+    QCache<QString, QSqlQuery> statements;
+};
+
+class QSqlConnectionPoolPrivate
+{
+public:
+    QSqlConnectionPoolPrivate(const QString &name)
+        : templateName(name),
+          minimumSize(0),
+          maximumSize(qMax(2, QThread::idealThreadCount())),
+          idleTimeout(60000),
+          statementCacheSize(32),
+          opening(0),
+          waitingForRoom(0),
+          reservedSlots(0),
+          serial(0)
+    { }
+
+    bool isFull() const
+    { return connections.count() + opening + reservedSlots >= maximumSize; }
+
+    QSqlPooledConnection *takeIdle(Qt::HANDLE thread);
+    QList<QSqlPooledConnection *> takeClosable(Qt::HANDLE thread);
+    bool evictIdle(Qt::HANDLE thread);
+    void remove(QSqlPooledConnection *conn);
+    void freeSlot();
+    QSqlPooledConnection *connection(const QSqlDatabase &db, const char *where) const;
+    static void closeConnection(QSqlPooledConnection *conn);
+
+    mutable QMutex mutex;
+    QWaitCondition released;
+    QString templateName;
+    int minimumSize;
+    int maximumSize;
+    int idleTimeout;
+    int statementCacheSize;
+    QString healthCheckQuery;
+    QHash<QString, QSqlPooledConnection *> connections;
+    int opening; // connections being opened outside the lock
+    int waitingForRoom; // threads in acquire() waiting for the pool to shrink
+    int reservedSlots; // room made for those threads, which others can't take
+    int serial;
+    QSqlError error;
+};
+
+/*
+    Checks out an idle connection that was opened by \a thread. Must be
+    called with the mutex locked.
+*/
+QSqlPooledConnection *QSqlConnectionPoolPrivate::takeIdle(Qt::HANDLE thread)
+{
+    QHash<QString, QSqlPooledConnection *>::const_iterator it = connections.constBegin();
+    for (; it != connections.constEnd(); ++it) {
+        QSqlPooledConnection *conn = it.value();
+        if (!conn->inUse && !conn->evicted && conn->thread == thread) {
+            conn->inUse = true;
+            return conn;
+        }
+    }
+    return 0;
+}
+
+/*
+    Removes the idle connections of \a thread that were evicted or have
+    been idle for longer than the idle timeout, keeping at least
+    minimumSize connections. The caller closes them after unlocking the
+    mutex. The connections of other threads are left to those threads.
+*/
+QList<QSqlPooledConnection *> QSqlConnectionPoolPrivate::takeClosable(Qt::HANDLE thread)
+{
+    QList<QSqlPooledConnection *> closable;
+    const QList<QSqlPooledConnection *> all = connections.values();
+    for (int i = 0; i < all.count(); ++i) {
+        QSqlPooledConnection *conn = all.at(i);
+        if (conn->inUse || conn->thread != thread)
+            continue;
+        const bool expired = idleTimeout >= 0 && conn->idleTime.elapsed() >= idleTimeout
+                && connections.count() > minimumSize;
+        if (conn->evicted || expired) {
+            remove(conn);
+            closable.append(conn);
+        }
+    }
+    return closable;
+}
+
+/*
+    Marks the connection of another thread than \a thread that has been
+    idle the longest as evicted, so that its thread closes it the next
+    time it acquires or releases a connection. Returns false if there is
+    no such connection. Must be called with the mutex locked.
+*/
+bool QSqlConnectionPoolPrivate::evictIdle(Qt::HANDLE thread)
+{
+    QSqlPooledConnection *oldest = 0;
+    QHash<QString, QSqlPooledConnection *>::const_iterator it = connections.constBegin();
+    for (; it != connections.constEnd(); ++it) {
+        QSqlPooledConnection *conn = it.value();
+        if (conn->inUse || conn->evicted || conn->thread == thread)
+            continue;
+        if (!oldest || conn->idleTime.elapsed() > oldest->idleTime.elapsed())
+            oldest = conn;
+    }
+    if (oldest)
+        oldest->evicted = true;
+    return oldest != 0;
+}
+
+/*
+    Takes \a conn out of the pool; the caller closes it after unlocking
+    the mutex.
+*/
+void QSqlConnectionPoolPrivate::remove(QSqlPooledConnection *conn)
+{
+    connections.remove(conn->connectionName);
+    freeSlot();
+}
+
+/*
+    Called when the pool has room for one more connection. Threads that
+    are waiting for room get it before any other thread can open a
+    connection, including the thread that made the room.
+*/
+void QSqlConnectionPoolPrivate::freeSlot()
+{
+    if (reservedSlots < waitingForRoom)
+        ++reservedSlots;
+    released.wakeAll();
+}
+
+/*
+    Returns the checked out pool connection for \a db, or 0 with a warning
+    unless \a db is invalid. Must be called with the mutex locked.
+*/
+QSqlPooledConnection *QSqlConnectionPoolPrivate::connection(const QSqlDatabase &db,
+                                                            const char *where) const
+{
+    if (!db.isValid())
+        return 0;
+    QSqlPooledConnection *conn = connections.value(db.connectionName());
+    if (!conn || !conn->inUse) {
+        qWarning("QSqlConnectionPool::%s: connection '%s' is not checked out from this pool",
+                 where, db.connectionName().toLocal8Bit().constData());
+        return 0;
+    }
+    return conn;
+}
+
+void QSqlConnectionPoolPrivate::closeConnection(QSqlPooledConnection *conn)
+{
+    conn->statements.clear();
+    QSqlDatabase::database(conn->connectionName, false).close();
+    QSqlDatabase::removeDatabase(conn->connectionName);
+    delete conn;
+}
+
+static void qCloseConnections(const QList<QSqlPooledConnection *> &connections)
+{
+    for (int i = 0; i < connections.count(); ++i)
+        QSqlConnectionPoolPrivate::closeConnection(connections.at(i));
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class keeps a set of open database
+    connections that threads can check out and return.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.2
+
+    A QSqlDatabase connection can only be used from the thread that
+    created it, so a server that handles requests in several threads
+    needs one connection per thread. QSqlConnectionPool manages such
+    connections: acquire() hands out an open connection for the
+    calling thread and release() puts it back for the next request.
+
+    The pooled connections are clones of the \l{QSqlDatabase}{database
+    connection} the pool is created for, which acts as the template and
+    does not need to be open:
+
+    \snippet code/src_sql_kernel_qsqlconnectionpool.cpp 0
+
+    A connection is only ever handed out to, and closed by, the thread
+    that opened it. If the pool has reached maximumSize(), acquire()
+    waits until another thread makes room: a thread that releases a
+    connection while others are waiting closes it instead of keeping it
+    idle, and an idle connection of another thread is marked to be
+    closed by that thread the next time it calls into the pool. A
+    thread that stops using the pool should therefore call
+    removeIdleConnections() before it finishes.
+
+    Connections that have been idle for idleTimeout() milliseconds are
+    closed, but the pool keeps at least minimumSize() of them. Before an
+    idle connection is handed out again it is checked with the
+    healthCheckQuery(), and reopened if that fails.
+
+    Each pooled connection has a cache of prepared queries.
+    cachedQuery() only prepares a statement the first time it is used
+    on a connection, which saves a round trip to the server for drivers
+    with real prepared statements:
+
+    \snippet code/src_sql_kernel_qsqlconnectionpool.cpp 1
+
+    Queries on a pooled connection have to be destroyed before the
+    connection is released, since the pool may close it afterwards.
+
+    All functions of QSqlConnectionPool are thread-safe.
+
+    \sa QSqlDatabase::cloneDatabase(), {Threads and the SQL Module}
+*/
+
+/*!
+    Constructs a connection pool that opens clones of the database
+    connection called \a connectionName.
+
+    No connections are opened until acquire() is called.
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QString &connectionName)
+    : d(new QSqlConnectionPoolPrivate(connectionName))
+{
+}
+
+/*!
+    Closes all the pooled connections and destroys the pool.
+
+    All connections should have been released before; queries on
+    connections that are still in use stop working. Since this closes
+    the connections of all threads, the pool should only be destroyed
+    once the threads using it are done, for example after
+    QThreadPool::waitForDone().
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    QList<QSqlPooledConnection *> connections;
+    {
+        QMutexLocker locker(&d->mutex);
+        connections = d->connections.values();
+        d->connections.clear();
+    }
+    for (int i = 0; i < connections.count(); ++i) {
+        if (connections.at(i)->inUse)
+            qWarning("QSqlConnectionPool: connection '%s' is still in use",
+                     connections.at(i)->connectionName.toLocal8Bit().constData());
+    }
+    qCloseConnections(connections);
+    delete d;
+}
+
+/*!
+    Returns the name of the database connection the pooled connections
+    are cloned from.
+*/
+QString QSqlConnectionPool::connectionName() const
+{
+    return d->templateName;
+}
+
+/*!
+    Sets the number of connections that are kept open when they are
+    idle to \a size. The default is 0.
+
+    The pool never opens connections in advance: a connection belongs
+    to the thread that opened it, and the pool cannot know which threads
+    are going to call acquire(). The minimum is only reached once that
+    many connections have been in use, and it does not keep
+    removeIdleConnections() from closing them.
+
+    \sa idleTimeout()
+*/
+void QSqlConnectionPool::setMinimumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->minimumSize = qMax(0, size);
+}
+
+/*!
+    Returns the number of connections that are kept open when idle.
+*/
+int QSqlConnectionPool::minimumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->minimumSize;
+}
+
+/*!
+    Sets the maximum number of open connections to \a size. The default
+    is QThread::idealThreadCount(), but at least 2.
+
+    Lowering the maximum does not close connections that are open
+    already; the pool shrinks as they expire.
+*/
+void QSqlConnectionPool::setMaximumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maximumSize = qMax(1, size);
+    d->released.wakeAll();
+}
+
+/*!
+    Returns the maximum number of open connections.
+*/
+int QSqlConnectionPool::maximumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumSize;
+}
+
+/*!
+    Sets the time in milliseconds after which an idle connection is
+    closed to \a msecs. The default is 60000 (one minute); a negative
+    value keeps idle connections open until the pool is destroyed.
+
+    Expired connections are closed the next time a connection is
+    acquired or released, by the thread doing that.
+
+    \sa minimumSize(), removeIdleConnections()
+*/
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    QMutexLocker locker(&d->mutex);
+    d->idleTimeout = msecs;
+}
+
+/*!
+    Returns the time in milliseconds after which an idle connection is
+    closed.
+*/
+int QSqlConnectionPool::idleTimeout() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the statement that is executed on an idle connection before it
+    is handed out again to \a query, for example \c{SELECT 1}. If it
+    fails, the connection is closed and opened again.
+
+    By default no statement is executed and only
+    QSqlDatabase::isOpen() is checked.
+*/
+void QSqlConnectionPool::setHealthCheckQuery(const QString &query)
+{
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckQuery = query;
+}
+
+/*!
+    Returns the statement used to check idle connections.
+*/
+QString QSqlConnectionPool::healthCheckQuery() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckQuery;
+}
+
+/*!
+    Sets the number of prepared queries cachedQuery() keeps per
+    connection to \a size. The least recently used query is dropped
+    when the cache is full. The default is 32; 0 disables the cache.
+
+    The new size applies to a connection when it is released.
+*/
+void QSqlConnectionPool::setStatementCacheSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->statementCacheSize = qMax(0, size);
+}
+
+/*!
+    Returns the number of prepared queries kept per connection.
+*/
+int QSqlConnectionPool::statementCacheSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->statementCacheSize;
+}
+
+/*!
+    Checks out an open connection for the calling thread. If all
+    connections are in use and the pool is at its maximum size, waits
+    up to \a timeout milliseconds for one to be released; a negative
+    \a timeout waits forever.
+
+    Returns an invalid QSqlDatabase if no connection could be opened or
+    the timeout expired; lastError() holds the reason.
+
+    The connection must be used in the calling thread only, and handed
+    back with release() when done.
+*/
+QSqlDatabase QSqlConnectionPool::acquire(int timeout)
+{
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<QSqlPooledConnection *> stale;
+    {
+        QMutexLocker locker(&d->mutex);
+        stale = d->takeClosable(thread);
+    }
+    qCloseConnections(stale);
+
+    QSqlPooledConnection *conn = 0;
+    QString newName;
+    QString healthCheckQuery;
+    {
+        QMutexLocker locker(&d->mutex);
+        bool waiting = false;
+        bool evictionRequested = false;
+        bool openNew = false;
+        forever {
+            conn = d->takeIdle(thread);
+            if (conn)
+                break;
+            if (waiting && d->reservedSlots > 0) {
+                // room that another thread made for the waiting ones
+                --d->reservedSlots;
+                openNew = true;
+                break;
+            }
+            if (!d->isFull()) {
+                openNew = true;
+                break;
+            }
+            if (!waiting) {
+                waiting = true;
+                ++d->waitingForRoom;
+            }
+            // connections are only closed by the thread that opened them, so
+            // ask the thread of the longest idle one to close it
+            if (!evictionRequested)
+                evictionRequested = d->evictIdle(thread);
+            const qint64 remaining = timeout - timer.elapsed();
+            if (timeout >= 0 && remaining <= 0) {
+                d->error = QSqlError(QCoreApplication::translate("QSqlConnectionPool",
+                                     "Timed out waiting for a connection"),
+                                     QString(), QSqlError::ConnectionError);
+                break;
+            }
+            d->released.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(remaining));
+        }
+        if (waiting) {
+            --d->waitingForRoom;
+            // don't hold back room for threads that gave up
+            if (d->reservedSlots > d->waitingForRoom) {
+                d->reservedSlots = d->waitingForRoom;
+                d->released.wakeAll();
+            }
+        }
+        if (conn) {
+            healthCheckQuery = d->healthCheckQuery;
+        } else if (openNew) {
+            newName = QString::fromLatin1("qt_sql_pool_%1_%2")
+                    .arg(quintptr(this), 0, 16).arg(d->serial++);
+            ++d->opening;
+        }
+    }
+
+    if (conn) {
+        QSqlDatabase db = QSqlDatabase::database(conn->connectionName, false);
+        if (db.isOpen()) {
+            if (healthCheckQuery.isEmpty())
+                return db;
+            QSqlQuery query(db);
+            if (query.exec(healthCheckQuery))
+                return db;
+        }
+        conn->statements.clear();
+        db.close();
+        if (db.open())
+            return db;
+
+        QMutexLocker locker(&d->mutex);
+        d->error = db.lastError();
+        d->remove(conn);
+        locker.unlock();
+        db = QSqlDatabase();
+        QSqlConnectionPoolPrivate::closeConnection(conn);
+        return QSqlDatabase();
+    }
+    if (newName.isEmpty())
+        return QSqlDatabase();
+
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::database(d->templateName, false),
+                                                  newName);
+    const bool ok = db.isValid() && db.open();
+
+    QMutexLocker locker(&d->mutex);
+    --d->opening;
+    if (ok) {
+        d->connections.insert(newName, new QSqlPooledConnection(newName, d->statementCacheSize));
+        return db;
+    }
+    if (db.isValid())
+        d->error = db.lastError();
+    else
+        d->error = QSqlError(QCoreApplication::translate("QSqlConnectionPool",
+                             "Invalid template connection"), QString(), QSqlError::ConnectionError);
+    d->freeSlot();
+    locker.unlock();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(newName);
+    return QSqlDatabase();
+}
+
+/*!
+    Returns the connection \a db, which must have been checked out with
+    acquire(), to the pool and resets \a db to an invalid QSqlDatabase.
+    Does nothing if \a db is invalid.
+
+    Queries from cachedQuery() are finished, but the connection is
+    returned as is otherwise; a transaction that was started on it
+    should be committed or rolled back first.
+
+    If other threads are waiting for room in the pool, the connection is
+    closed right away. Otherwise it may be closed the next time this
+    thread calls acquire(), release() or removeIdleConnections(), or
+    when the pool is destroyed. All QSqlQuery objects on the connection,
+    including the ones returned by cachedQuery(), and all other copies
+    of \a db must have been destroyed before.
+*/
+void QSqlConnectionPool::release(QSqlDatabase &db)
+{
+    QSqlPooledConnection *conn;
+    {
+        QMutexLocker locker(&d->mutex);
+        conn = d->connection(db, "release");
+        if (!conn)
+            return;
+    }
+
+    const QList<QString> keys = conn->statements.keys();
+    for (int i = 0; i < keys.count(); ++i) {
+        if (QSqlQuery *query = conn->statements.object(keys.at(i)))
+            query->finish();
+    }
+    db = QSqlDatabase();
+
+    QList<QSqlPooledConnection *> stale;
+    {
+        QMutexLocker locker(&d->mutex);
+        conn->statements.setMaxCost(d->statementCacheSize);
+        conn->inUse = false;
+        conn->idleTime.start();
+        if (d->waitingForRoom > d->reservedSlots) {
+            // other threads wait for room, and only this one may close the connection
+            d->remove(conn);
+            stale.append(conn);
+        }
+        stale += d->takeClosable(QThread::currentThreadId());
+    }
+    qCloseConnections(stale);
+}
+
+/*!
+    Returns a query for \a statement prepared on the connection \a db,
+    which must have been checked out with acquire().
+
+    The first time a statement is used on a connection it is prepared
+    and kept in the connection's cache; later calls return the cached
+    query, so only the values have to be bound before exec(). The
+    returned query shares its state with the cached one and has to be
+    destroyed before the connection is released.
+
+    If the statement cannot be prepared, the returned query is not
+    cached and its lastError() describes the problem.
+
+    \sa statementCacheSize(), QSqlQuery::prepare()
+*/
+QSqlQuery QSqlConnectionPool::cachedQuery(const QSqlDatabase &db, const QString &statement)
+{
+    QSqlPooledConnection *conn;
+    {
+        QMutexLocker locker(&d->mutex);
+        conn = d->connection(db, "cachedQuery");
+    }
+    if (conn) {
+        if (QSqlQuery *query = conn->statements.object(statement))
+            return *query;
+    }
+
+    QSqlQuery query(db);
+    if (query.prepare(statement) && conn)
+        conn->statements.insert(statement, new QSqlQuery(query));
+    return query;
+}
+
+/*!
+    Returns the number of open connections, including those in use.
+*/
+int QSqlConnectionPool::size() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->connections.count();
+}
+
+/*!
+    Returns the number of open connections that are not in use and can
+    be handed out again.
+*/
+int QSqlConnectionPool::idleCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    int count = 0;
+    QHash<QString, QSqlPooledConnection *>::const_iterator it = d->connections.constBegin();
+    for (; it != d->connections.constEnd(); ++it) {
+        if (!it.value()->inUse && !it.value()->evicted)
+            ++count;
+    }
+    return count;
+}
+
+/*!
+    Closes the connections of the calling thread that are not in use,
+    regardless of minimumSize() and idleTimeout(). Idle connections of
+    other threads are not handed out anymore, and are closed by their
+    threads the next time they call acquire(), release() or this
+    function.
+
+    A thread should call this before it finishes, so that the pool can
+    open connections for other threads instead.
+*/
+void QSqlConnectionPool::removeIdleConnections()
+{
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    QList<QSqlPooledConnection *> idle;
+    {
+        QMutexLocker locker(&d->mutex);
+        const QList<QSqlPooledConnection *> all = d->connections.values();
+        for (int i = 0; i < all.count(); ++i) {
+            QSqlPooledConnection *conn = all.at(i);
+            if (conn->inUse)
+                continue;
+            if (conn->thread == thread) {
+                d->remove(conn);
+                idle.append(conn);
+            } else {
+                conn->evicted = true;
+            }
+        }
+    }
+    qCloseConnections(idle);
+}
+
+/*!
+    Returns information about the last error that made acquire() fail.
+*/
+QSqlError QSqlConnectionPool::lastError() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->error;
+}
+
+QT_END_NAMESPACE
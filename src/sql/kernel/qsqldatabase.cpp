@@ -95,6 +95,7 @@
 #include "qsqlindex.h"
 #include "private/qfactoryloader_p.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqldriver_p.h"
 #include "qmutex.h"
 #include "qhash.h"
 #include <stdlib.h>
@@ -202,6 +203,11 @@ void QSqlDatabasePrivate::cleanConnections()
     dict->clear();
 }
 
+static inline QSqlDriverPrivate *qSqlDriverPrivate(QSqlDriver *driver)
+{
+    return static_cast<QSqlDriverPrivate *>(QObjectPrivate::get(driver));
+}
+
 static bool qDriverDictInit = false;
 static void cleanDriverDict()
 {
@@ -907,7 +913,11 @@ bool QSqlDatabase::transaction()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->beginTransaction();
+    if (!d->driver->beginTransaction())
+        return false;
+    // lets QSqlTableModel::submitAll() know that it must not start one
+    qSqlDriverPrivate(d->driver)->inTransaction = true;
+    return true;
 }
 
 /*!
@@ -928,7 +938,10 @@ bool QSqlDatabase::commit()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->commitTransaction();
+    if (!d->driver->commitTransaction())
+        return false;
+    qSqlDriverPrivate(d->driver)->inTransaction = false;
+    return true;
 }
 
 /*!
@@ -949,7 +962,10 @@ bool QSqlDatabase::rollback()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->rollbackTransaction();
+    if (!d->driver->rollbackTransaction())
+        return false;
+    qSqlDriverPrivate(d->driver)->inTransaction = false;
+    return true;
 }
 
 /*!
@@ -1263,8 +1279,13 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li
     \list
     \li QSQLITE_BUSY_TIMEOUT
+    \li QSQLITE_OPEN_FULLMUTEX
     \li QSQLITE_OPEN_READONLY
     \li QSQLITE_ENABLE_SHARED_CACHE
+    \li QSQLITE_JOURNAL_MODE
+    \li QSQLITE_MMAP_SIZE
+    \li QSQLITE_STATEMENT_CACHE_SIZE
+    \li QSQLITE_UTF16_API
     \endlist
 
     \li
@@ -260,6 +260,8 @@ bool QSqlDriver::isOpenError() const
 void QSqlDriver::setOpen(bool open)
 {
     d_func()->isOpen = open;
+    if (!open)
+        d_func()->inTransaction = false;
 }
 
 /*!
@@ -274,8 +276,10 @@ void QSqlDriver::setOpen(bool open)
 void QSqlDriver::setOpenError(bool error)
 {
     d_func()->isOpenError = error;
-    if (error)
+    if (error) {
         d_func()->isOpen = false;
+        d_func()->inTransaction = false;
+    }
 }
 
 /*!
@@ -71,18 +71,20 @@ public:
     QSqlDriver *q_func();
     uint isOpen : 1;
     uint isOpenError : 1;
+    uint inTransaction : 1; // started with QSqlDatabase::transaction()
     QSqlError error;
     QSql::NumericalPrecisionPolicy precisionPolicy;
     DBMSType dbmsType;
 };
 
 inline QSqlDriverPrivate::QSqlDriverPrivate()
-    : QObjectPrivate(), isOpen(false), isOpenError(false), precisionPolicy(QSql::LowPrecisionDouble),
+    : QObjectPrivate(), isOpen(false), isOpenError(false), inTransaction(false),
+      precisionPolicy(QSql::LowPrecisionDouble),
       dbmsType(UnknownDB)
 {
 }
 
-QSqlDriverPrivate::~QSqlDriverPrivate()
+inline QSqlDriverPrivate::~QSqlDriverPrivate()
 {
 }
 
@@ -49,6 +49,7 @@
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
 #include "qvector.h"
 #include "qmap.h"
 
@@ -423,6 +424,107 @@ QVariant QSqlQuery::value(const QString& name) const
     return QVariant();
 }
 
+void QSqlQuery::fetchTypedValue(QSqlResultTypedValue &value) const
+{
+    if (!isActive() || !isValid() || value.index < 0) {
+        qWarning("QSqlQuery::value: not positioned on a valid record");
+        return;
+    }
+    d->sqlResult->virtual_hook(QSqlResult::FetchTypedValue, &value);
+    if (!value.handled)
+        value.setVariant(d->sqlResult->data(value.index));
+}
+
+/*!
+    \since 5.2
+
+    Returns the value of field \a index in the current record as an
+    integer. If \a ok is not 0, *\a ok is set to true if the value
+    could be converted, and to false if the field is NULL, does not
+    exist or cannot be represented as an \c int.
+
+    Unlike value(), this function lets the SQLite and PostgreSQL drivers
+    read the value directly from their row buffers without creating a
+    QVariant, which makes it the faster choice for scanning large result
+    sets. Other drivers convert the value returned by value().
+
+    \sa valueLongLong(), valueDouble(), valueUtf8(), isNull()
+*/
+
+int QSqlQuery::valueInt(int index, bool *ok) const
+{
+    QSqlResultTypedValue value(index, QMetaType::Int);
+    fetchTypedValue(value);
+    const bool inRange = qlonglong(int(value.intValue)) == value.intValue;
+    if (ok)
+        *ok = value.ok && inRange;
+    return inRange ? int(value.intValue) : 0;
+}
+
+/*!
+    \since 5.2
+
+    Returns the value of field \a index in the current record as a 64-bit
+    integer. If \a ok is not 0, *\a ok is set to true if the value could
+    be converted, and to false otherwise.
+
+    \sa valueInt()
+*/
+
+qlonglong QSqlQuery::valueLongLong(int index, bool *ok) const
+{
+    QSqlResultTypedValue value(index, QMetaType::LongLong);
+    fetchTypedValue(value);
+    if (ok)
+        *ok = value.ok;
+    return value.intValue;
+}
+
+/*!
+    \since 5.2
+
+    Returns the value of field \a index in the current record as a
+    double. If \a ok is not 0, *\a ok is set to true if the value could
+    be converted, and to false otherwise.
+
+    The numerical precision policy of the query does not apply to this
+    function.
+
+    \sa valueInt()
+*/
+
+double QSqlQuery::valueDouble(int index, bool *ok) const
+{
+    QSqlResultTypedValue value(index, QMetaType::Double);
+    fetchTypedValue(value);
+    if (ok)
+        *ok = value.ok;
+    return value.doubleValue;
+}
+
+/*!
+    \since 5.2
+
+    Returns the text of field \a index in the current record encoded as
+    UTF-8, or a null QByteArray if the field is NULL.
+
+    When the database connection delivers UTF-8 text, the returned byte
+    array does not copy the data but refers to the driver's buffer for the
+    current row. It stays valid until the query is positioned on another
+    record, executed again, finished or destroyed, or until value() is
+    called for the current record. Copy the data (for example by calling
+    QString::fromUtf8() or QByteArray::detach() on it) to keep it longer.
+
+    \sa value(), valueInt()
+*/
+
+QByteArray QSqlQuery::valueUtf8(int index) const
+{
+    QSqlResultTypedValue value(index, QMetaType::QByteArray);
+    fetchTypedValue(value);
+    return value.utf8;
+}
+
 /*!
     Returns the current internal position of the query. The first
     record is at position zero. If the position is invalid, the
@@ -1004,6 +1106,12 @@ bool QSqlQuery::exec()
   example, you cannot mix integer and string variants within a
   QVariantList.
 
+  \note The SQLite and PostgreSQL drivers execute the whole batch
+  atomically: if one of the rows fails, none of them is applied.
+  The PostgreSQL driver sends simple \c{INSERT ... VALUES} statements
+  as multi-row inserts, so subqueries in the \c VALUES list do not
+  see rows inserted by the same batch.
+
   The \a mode parameter indicates how the bound QVariantList will be
   interpreted.  If \a mode is \c ValuesAsRows, every variant within
   the QVariantList will be interpreted as a value for a new row. \c
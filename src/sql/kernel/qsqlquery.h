@@ -56,6 +56,7 @@ class QSqlResult;
 class QSqlRecord;
 template <class Key, class T> class QMap;
 class QSqlQueryPrivate;
+struct QSqlResultTypedValue;
 
 class Q_SQL_EXPORT QSqlQuery
 {
@@ -85,6 +86,10 @@ public:
     bool exec(const QString& query);
     QVariant value(int i) const;
     QVariant value(const QString& name) const;
+    int valueInt(int index, bool *ok = 0) const;
+    qlonglong valueLongLong(int index, bool *ok = 0) const;
+    double valueDouble(int index, bool *ok = 0) const;
+    QByteArray valueUtf8(int index) const;
 
     void setNumericalPrecisionPolicy(QSql::NumericalPrecisionPolicy precisionPolicy);
     QSql::NumericalPrecisionPolicy numericalPrecisionPolicy() const;
@@ -115,6 +120,7 @@ public:
     bool nextResult();
 
 private:
+    void fetchTypedValue(QSqlResultTypedValue &value) const;
     QSqlQueryPrivate* d;
 };
 
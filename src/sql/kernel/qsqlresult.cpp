@@ -51,8 +51,13 @@
 #include "qsqldriver.h"
 #include "qpointer.h"
 #include "qsqlresult_p.h"
+#include "qnumeric.h"
+#include "private/qlocale_tools_p.h"
 #include <QDebug>
 
+#include <errno.h>
+#include <stdlib.h>
+
 QT_BEGIN_NAMESPACE
 
 QString QSqlResultPrivate::holderAt(int index) const
@@ -172,6 +177,161 @@ QString QSqlResultPrivate::namedToPositionalBinding(const QString &query)
     return result;
 }
 
+void QSqlResultTypedValue::setNull()
+{
+    handled = true;
+    ok = false;
+    intValue = 0;
+    doubleValue = 0.0;
+    utf8 = QByteArray();
+}
+
+void QSqlResultTypedValue::setLongLong(qlonglong value)
+{
+    handled = true;
+    ok = true;
+    intValue = value;
+    doubleValue = double(value);
+}
+
+void QSqlResultTypedValue::setDouble(double value)
+{
+    handled = true;
+    doubleValue = value;
+    // like QVariant, an integer request rounds a floating point value, but
+    // NaN, infinity and values out of the 64-bit range don't convert
+    const bool integral = qIsFinite(value) && qAbs(value) < 9223372036854775808.0;
+    intValue = integral ? qRound64(value) : 0;
+    ok = type == QMetaType::Double || integral;
+}
+
+static inline bool qIsTrailingSpace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    return p == end;
+}
+
+// The spellings of NaN and infinity used by the databases ("NaN",
+// "Infinity" and "-Infinity" for PostgreSQL) and by QString::number()
+static bool qParseNonFinite(const char *text, int length, double *value)
+{
+    while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == '\t'))
+        --length;
+    const QByteArray word = QByteArray::fromRawData(text, length).toLower();
+    if (word == "nan") {
+        *value = qQNaN();
+        return true;
+    }
+    if (word == "inf" || word == "+inf" || word == "infinity" || word == "+infinity") {
+        *value = qInf();
+        return true;
+    }
+    if (word == "-inf" || word == "-infinity") {
+        *value = -qInf();
+        return true;
+    }
+    return false;
+}
+
+void QSqlResultTypedValue::setDoubleText(const char *text, int length)
+{
+    double value;
+    if (qParseNonFinite(text, length, &value)) {
+        setDouble(value);
+        return;
+    }
+    bool valid = false;
+    const char *pos = 0;
+    value = qstrtod(text, &pos, &valid);
+    if (valid && pos != text && qIsTrailingSpace(pos, text + length)) {
+        setDouble(value);
+    } else {
+        handled = true;
+        ok = false;
+        intValue = 0;
+        doubleValue = 0.0;
+    }
+}
+
+void QSqlResultTypedValue::setText(const char *text, int length, bool isUtf8)
+{
+    const char *end = text + length;
+    switch (type) {
+    case QMetaType::Int:
+    case QMetaType::LongLong: {
+        // only integral text converts, as with QVariant; "12.5" is not an integer
+        char *pos = 0;
+        errno = 0;
+        const qlonglong value = strtoll(text, &pos, 10);
+        handled = true;
+        ok = pos != text && errno == 0 && qIsTrailingSpace(pos, end);
+        intValue = ok ? value : 0;
+        doubleValue = double(intValue);
+        break;
+    }
+    case QMetaType::Double:
+        setDoubleText(text, length);
+        break;
+    case QMetaType::QByteArray:
+        if (!isUtf8)
+            return; // let QSqlQuery convert it
+        handled = true;
+        ok = true;
+        utf8 = QByteArray::fromRawData(text, length);
+        break;
+    default:
+        break;
+    }
+}
+
+void QSqlResultTypedValue::setVariant(const QVariant &value)
+{
+    if (value.isNull()) {
+        setNull();
+        return;
+    }
+    switch (value.type()) {
+    case QVariant::String:
+    case QVariant::ByteArray: {
+        QByteArray text = value.type() == QVariant::String ? value.toString().toUtf8() : value.toByteArray();
+        setText(text.constData(), text.size(), true);
+        if (type == QMetaType::QByteArray)
+            utf8 = text; // own the converted data
+        return;
+    }
+    default:
+        break;
+    }
+    handled = true;
+    switch (type) {
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+        intValue = value.toLongLong(&ok);
+        doubleValue = double(intValue);
+        break;
+    case QMetaType::Double:
+        doubleValue = value.toDouble(&ok);
+        intValue = qRound64(doubleValue);
+        break;
+    case QMetaType::QByteArray:
+        ok = value.canConvert(QVariant::String);
+        utf8 = value.toString().toUtf8();
+        break;
+    default:
+        ok = false;
+        break;
+    }
+}
+
+void QSqlResultAsyncExec::notify() const
+{
+    // the receiver lives in the thread that started the query, which is
+    // not necessarily the one the driver finishes it in
+    if (receiver)
+        QMetaObject::invokeMethod(receiver, member, Qt::QueuedConnection, Q_ARG(int, tag));
+}
+
 /*!
     \class QSqlResult
     \brief The QSqlResult class provides an abstract interface for
@@ -207,6 +367,21 @@ QString QSqlResultPrivate::namedToPositionalBinding(const QString &query)
 /*!
     \enum QSqlResult::VirtualHookOperation
     \internal
+
+    \value FetchTypedValue \a data points to a QSqlResultTypedValue that
+    asks for the value of a field of the current row as a specific type.
+    Drivers that do not handle it leave the request untouched and
+    QSqlQuery converts data() instead.
+
+    \value ExecAsync \a data points to a QSqlResultAsyncExec. The driver
+    starts executing the query set up on the result without waiting for
+    it and calls QSqlResultAsyncExec::notify() when it has finished.
+    Drivers that do not handle it leave the request untouched and
+    QSqlAsyncQuery executes the query synchronously instead.
+
+    \value WaitForAsync \a data points to a bool, which the driver sets
+    to true after waiting for the query started with ExecAsync to
+    finish.
 */
 
 /*!
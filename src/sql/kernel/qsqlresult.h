@@ -62,6 +62,7 @@ class Q_SQL_EXPORT QSqlResult
     Q_DECLARE_PRIVATE(QSqlResult)
     friend class QSqlQuery;
     friend class QSqlTableModelPrivate;
+    friend class QSqlAsyncQueryPrivate;
 
 public:
     virtual ~QSqlResult();
@@ -124,7 +125,7 @@ protected:
     virtual QSqlRecord record() const;
     virtual QVariant lastInsertId() const;
 
-    enum VirtualHookOperation { };
+    enum VirtualHookOperation { FetchTypedValue, ExecAsync, WaitForAsync };
     virtual void virtual_hook(int id, void *data);
     virtual bool execBatch(bool arrayBind = false);
     virtual void detachFromResultSet();
@@ -68,6 +68,55 @@ struct QHolder {
     int holderPos;
 };
 
+// Passed to QSqlResult::virtual_hook() with QSqlResult::FetchTypedValue by
+// QSqlQuery's typed accessors. Drivers that can answer the request straight
+// from their own buffers call one of the setters, which marks the request
+// as handled; otherwise QSqlQuery falls back to converting data().
+struct Q_SQL_EXPORT QSqlResultTypedValue
+{
+    QSqlResultTypedValue(int field, int metaType)
+        : index(field), type(metaType), handled(false), ok(false), intValue(0), doubleValue(0.0)
+    { }
+
+    void setNull();
+    void setLongLong(qlonglong value);
+    void setDouble(double value);
+    // text must be '\0' terminated at text[length]; it is borrowed, not copied.
+    // An integer request only accepts integral text.
+    void setText(const char *text, int length, bool isUtf8);
+    // the text of a floating point column; an integer request rounds it
+    void setDoubleText(const char *text, int length);
+    void setVariant(const QVariant &value);
+
+    int index;
+    int type; // QMetaType::Int, LongLong, Double or QByteArray (UTF-8 text)
+    bool handled;
+    bool ok;
+    qlonglong intValue;
+    double doubleValue;
+    QByteArray utf8;
+};
+
+// Passed to QSqlResult::virtual_hook() with QSqlResult::ExecAsync by
+// QSqlAsyncQuery, after the query text and the bound values have been
+// set on the result. Drivers that can run the statement without blocking
+// the calling thread keep a copy, mark the request as handled and call
+// notify() once the result is ready to be read.
+struct Q_SQL_EXPORT QSqlResultAsyncExec
+{
+    QSqlResultAsyncExec(QObject *obj = 0, const char *slot = 0, int id = 0)
+        : receiver(obj), member(slot), tag(id), handled(false)
+    { }
+
+    // queues a call of member(tag) on receiver, from any thread
+    void notify() const;
+
+    QPointer<QObject> receiver;
+    const char *member;
+    int tag;
+    bool handled;
+};
+
 class Q_SQL_EXPORT QSqlResultPrivate
 {
 
@@ -1,11 +1,13 @@
 HEADERS +=      models/qsqlquerymodel.h \
                 models/qsqlquerymodel_p.h \
+                models/qsqlquerymodelfetcher_p.h \
                 models/qsqltablemodel.h \
                 models/qsqltablemodel_p.h \
                 models/qsqlrelationaldelegate.h \
                 models/qsqlrelationaltablemodel.h
 
 SOURCES +=      models/qsqlquerymodel.cpp \
+                models/qsqlquerymodelfetcher.cpp \
                 models/qsqltablemodel.cpp \
                 models/qsqlrelationaldelegate.cpp \
                 models/qsqlrelationaltablemodel.cpp
@@ -41,14 +41,17 @@
 
 #include "qsqlquerymodel.h"
 #include "qsqlquerymodel_p.h"
+#include "qsqlquerymodelfetcher_p.h"
 
 #include <qdebug.h>
 #include <qsqldriver.h>
 #include <qsqlfield.h>
+#include <qthread.h>
 
 QT_BEGIN_NAMESPACE
 
 #define QSQL_PREFETCH 255
+#define QSQL_FETCH_BLOCK 256
 
 void QSqlQueryModelPrivate::prefetch(int limit)
 {
@@ -89,6 +92,178 @@ QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
 
+void QSqlQueryModelPrivate::startFetching(const QString &queryText, const QSqlDatabase &db)
+{
+    Q_Q(QSqlQueryModel);
+    q->beginResetModel();
+    stopFetching(false);
+
+    // only the columns are needed here, the rows come from the fetcher
+    QSqlQuery columnQuery(QSqlQueryModelFetcher::windowStatement(queryText, 0, 0), db);
+    QSqlRecord newRec = columnQuery.record();
+    if (colOffsets.size() != newRec.count() || newRec != rec)
+        initColOffsets(newRec.count());
+
+    error = QSqlError();
+    query = columnQuery;
+    rec = newRec;
+    bottom = q->createIndex(-1, rec.count() - 1);
+    atEnd = true;
+    rowCountKnown = false;
+
+    if (!columnQuery.isActive()) {
+        error = columnQuery.lastError();
+        q->endResetModel();
+        return;
+    }
+
+    blocks.setMaxCost(qMax(cacheSize, 2 * QSQL_FETCH_BLOCK));
+    fetcher = new QSqlQueryModelFetcher(db, queryText, fetchGeneration, QSQL_FETCH_BLOCK);
+    fetchThread = new QThread;
+    fetcher->moveToThread(fetchThread);
+    QObject::connect(fetchThread, SIGNAL(finished()), fetcher, SLOT(deleteLater()));
+    QObject::connect(fetcher, SIGNAL(blockFetched(int,int,QVariantList)),
+                     q, SLOT(_q_blockFetched(int,int,QVariantList)));
+    QObject::connect(fetcher, SIGNAL(blockDropped(int,int)),
+                     q, SLOT(_q_blockDropped(int,int)));
+    QObject::connect(fetcher, SIGNAL(rowsCounted(int,int)),
+                     q, SLOT(_q_rowsCounted(int,int)));
+    QObject::connect(fetcher, SIGNAL(failed(int,QString,QString,int)),
+                     q, SLOT(_q_fetchFailed(int,QString,QString,int)));
+    fetchThread->start();
+    // open() fetches the first block on its own
+    pendingBlocks.insert(0);
+    QMetaObject::invokeMethod(fetcher, "open", Qt::QueuedConnection);
+
+    q->endResetModel();
+    q->queryChange();
+}
+
+void QSqlQueryModelPrivate::stopFetching(bool wait)
+{
+    if (!fetchThread)
+        return;
+
+    ++fetchGeneration;
+    fetcher->stop();
+    fetchThread->quit();
+    if (wait) {
+        fetchThread->wait();
+        delete fetchThread;
+    } else {
+        // don't block on a statement that is still running, the thread
+        // cleans up after itself. Calling deleteLater() twice is fine.
+        QObject::connect(fetchThread, SIGNAL(finished()), fetchThread, SLOT(deleteLater()));
+        if (fetchThread->isFinished())
+            fetchThread->deleteLater();
+    }
+    fetchThread = 0;
+    fetcher = 0;
+    blocks.clear();
+    pendingBlocks.clear();
+}
+
+QVariant QSqlQueryModelPrivate::fetchedValue(int row, int column)
+{
+    const int block = row / QSQL_FETCH_BLOCK;
+    const int blockRow = row % QSQL_FETCH_BLOCK;
+    if (const QVector<QVariantList> *rows = blocks.object(block)) {
+        // read ahead when the view gets close to the next block
+        if (blockRow >= QSQL_FETCH_BLOCK / 2)
+            requestBlock(block + 1);
+        return blockRow < rows->count() ? rows->at(blockRow).value(column) : QVariant();
+    }
+
+    // the next block is asked for first, so that it is fetched last
+    requestBlock(block + 1);
+    requestBlock(block);
+    return QVariant();
+}
+
+void QSqlQueryModelPrivate::requestBlock(int block)
+{
+    // before the count arrives the rows grow block by block
+    const int first = block * QSQL_FETCH_BLOCK;
+    if (first > bottom.row() + (rowCountKnown ? 0 : 1))
+        return;
+    if (pendingBlocks.contains(block) || blocks.contains(block))
+        return;
+    pendingBlocks.insert(block);
+    QMetaObject::invokeMethod(fetcher, "fetch", Qt::QueuedConnection, Q_ARG(int, block));
+}
+
+void QSqlQueryModelPrivate::resizeFetchedRows(int count)
+{
+    Q_Q(QSqlQueryModel);
+    const int last = count - 1;
+    if (last > bottom.row()) {
+        q->beginInsertRows(QModelIndex(), bottom.row() + 1, last);
+        bottom = q->createIndex(last, rec.count() - 1);
+        q->endInsertRows();
+    } else if (last < bottom.row()) {
+        q->beginRemoveRows(QModelIndex(), last + 1, bottom.row());
+        bottom = q->createIndex(last, rec.count() - 1);
+        q->endRemoveRows();
+    }
+}
+
+void QSqlQueryModelPrivate::_q_blockFetched(int generation, int block, const QVariantList &rows)
+{
+    Q_Q(QSqlQueryModel);
+    if (generation != fetchGeneration)
+        return;
+    pendingBlocks.remove(block);
+    if (rows.isEmpty())
+        return;
+
+    QVector<QVariantList> *values = new QVector<QVariantList>;
+    values->reserve(rows.count());
+    for (int i = 0; i < rows.count(); ++i)
+        values->append(rows.at(i).toList());
+    blocks.insert(block, values, values->count());
+
+    // until the count arrives, the rows seen so far are all we know of
+    const int first = block * QSQL_FETCH_BLOCK;
+    int last = first + rows.count() - 1;
+    if (!rowCountKnown && last > bottom.row())
+        resizeFetchedRows(last + 1);
+    last = qMin(last, bottom.row());
+    if (last >= first && rec.count())
+        emit q->dataChanged(q->createIndex(first, 0), q->createIndex(last, rec.count() - 1));
+}
+
+void QSqlQueryModelPrivate::_q_blockDropped(int generation, int block)
+{
+    Q_Q(QSqlQueryModel);
+    if (generation != fetchGeneration)
+        return;
+    pendingBlocks.remove(block);
+
+    // makes the view ask for the rows again if they are still visible
+    const int first = block * QSQL_FETCH_BLOCK;
+    const int last = qMin(first + QSQL_FETCH_BLOCK - 1, bottom.row());
+    if (last >= first && rec.count())
+        emit q->dataChanged(q->createIndex(first, 0), q->createIndex(last, rec.count() - 1));
+}
+
+void QSqlQueryModelPrivate::_q_rowsCounted(int generation, int count)
+{
+    if (generation != fetchGeneration)
+        return;
+    rowCountKnown = true;
+    resizeFetchedRows(count);
+}
+
+void QSqlQueryModelPrivate::_q_fetchFailed(int generation, const QString &driverText,
+                                           const QString &databaseText, int type)
+{
+    if (generation != fetchGeneration)
+        return;
+    error = QSqlError(driverText, databaseText, QSqlError::ErrorType(type));
+    // keep what was fetched, but don't ask for more
+    fetcher->stop();
+}
+
 void QSqlQueryModelPrivate::initColOffsets(int size)
 {
     colOffsets.resize(size);
@@ -146,6 +321,9 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
     a query, the model will fetch rows incrementally.
     See fetchMore() for more information.
 
+    For very large results, the model can read the rows in the
+    background instead, see setFetchInBackground().
+
     \sa QSqlTableModel, QSqlRelationalTableModel, QSqlQuery,
         {Model/View Programming}, {Query Model Example}
 */
@@ -172,6 +350,8 @@ QSqlQueryModel::QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent)
 */
 QSqlQueryModel::~QSqlQueryModel()
 {
+    Q_D(QSqlQueryModel);
+    d->stopFetching(true);
 }
 
 /*!
@@ -214,6 +394,104 @@ bool QSqlQueryModel::canFetchMore(const QModelIndex &parent) const
     return (!parent.isValid() && !d->atEnd);
 }
 
+/*!
+    \since 5.2
+
+    Sets whether setQuery(const QString &, const QSqlDatabase &) reads the
+    rows of the result in the background to \a enable. The default is
+    false.
+
+    A model that fetches in the background executes the query on a
+    thread of its own, through a copy of the database connection (see
+    QSqlDatabase::cloneDatabase()). It asks for the rows in blocks as
+    they are needed and only keeps the last cacheSize() rows it has
+    read, so a view can scroll through millions of rows without
+    blocking the user interface or holding the whole result in memory.
+    Until the block that holds a row has arrived, data() returns an
+    invalid QVariant for it and dataChanged() is emitted once it is
+    there. rowCount() grows with the rows that have been read until a
+    \c{SELECT COUNT(*)} for the query, which runs after the first
+    block, returns the final number.
+
+    The rows are read from a cursor that stays open while the view
+    scrolls on, so reading the result from top to bottom costs about as
+    much as executing the query once. When the view jumps to another
+    part of the result, the query is executed again with an \c OFFSET
+    (with PostgreSQL, the cursor is moved instead), and the database
+    steps over all rows before the new position once. This limits the
+    mode to the SQLite, PostgreSQL and MySQL drivers. With other
+    drivers, with in-memory SQLite databases and for queries passed in
+    as a QSqlQuery, the model fetches its rows as before. The query
+    should have an \c{ORDER BY} clause, as a jump executes it anew, and
+    it only sees committed data.
+
+    With PostgreSQL the cursor is declared \c{WITH HOLD}, which stores
+    the whole result on the server the first time the view scrolls past
+    the first block. With SQLite, the open cursor keeps other
+    connections from writing to the database until all rows have been
+    read, unless the database uses write-ahead logging.
+
+    query() returns a query that describes the columns of the result
+    but holds no rows. If reading a block fails, lastError() returns the
+    error and no further rows are read.
+
+    The setting takes effect the next time a query is set.
+
+    \sa setCacheSize(), setQuery()
+*/
+void QSqlQueryModel::setFetchInBackground(bool enable)
+{
+    Q_D(QSqlQueryModel);
+    d->fetchInBackground = enable;
+}
+
+/*!
+    \since 5.2
+
+    Returns true if the model reads the rows of queries set by text in
+    the background.
+
+    \sa setFetchInBackground()
+*/
+bool QSqlQueryModel::fetchInBackground() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->fetchInBackground;
+}
+
+/*!
+    \since 5.2
+
+    Sets the number of rows a model that fetches in the background
+    keeps in memory to \a rows. The rows that were used least recently
+    are discarded first, and read again when they are needed. The
+    default is 10000 rows; the model always keeps at least two blocks of
+    256 rows.
+
+    \sa cacheSize(), setFetchInBackground()
+*/
+void QSqlQueryModel::setCacheSize(int rows)
+{
+    Q_D(QSqlQueryModel);
+    d->cacheSize = qMax(rows, 0);
+    if (d->fetcher)
+        d->blocks.setMaxCost(qMax(d->cacheSize, 2 * QSQL_FETCH_BLOCK));
+}
+
+/*!
+    \since 5.2
+
+    Returns the number of rows a model that fetches in the background
+    keeps in memory.
+
+    \sa setCacheSize()
+*/
+int QSqlQueryModel::cacheSize() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->cacheSize;
+}
+
 /*! \internal
  */
 void QSqlQueryModel::beginInsertRows(const QModelIndex &parent, int first, int last)
@@ -353,6 +631,11 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+    if (d->fetcher) {
+        if (!dItem.isValid() || dItem.row() > d->bottom.row())
+            return v;
+        return const_cast<QSqlQueryModelPrivate *>(d)->fetchedValue(dItem.row(), dItem.column());
+    }
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -412,6 +695,7 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
 {
     Q_D(QSqlQueryModel);
     beginResetModel();
+    d->stopFetching(false);
 
     QSqlRecord newRec = query.record();
     bool columnsChanged = (newRec != d->rec);
@@ -466,10 +750,20 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     Example:
     \snippet code/src_sql_models_qsqlquerymodel.cpp 1
 
-    \sa query(), queryChange(), lastError()
+    If fetchInBackground() is true, the rows are read in the background.
+
+    \sa query(), queryChange(), lastError(), setFetchInBackground()
 */
 void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
 {
+    Q_D(QSqlQueryModel);
+    if (d->fetchInBackground) {
+        const QSqlDatabase database = db.isValid() ? db : QSqlDatabase::database();
+        if (QSqlQueryModelFetcher::canFetch(database)) {
+            d->startFetching(query, database);
+            return;
+        }
+    }
     setQuery(QSqlQuery(query, db));
 }
 
@@ -479,6 +773,7 @@ void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
 void QSqlQueryModel::clear()
 {
     Q_D(QSqlQueryModel);
+    d->stopFetching(false);
     d->error = QSqlError();
     d->atEnd = true;
     d->query.clear();
@@ -678,3 +973,5 @@ QModelIndex QSqlQueryModel::indexInQuery(const QModelIndex &item) const
 }
 
 QT_END_NAMESPACE
+
+#include "moc_qsqlquerymodel.cpp"
@@ -87,6 +87,11 @@ public:
     void fetchMore(const QModelIndex &parent = QModelIndex());
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
 
+    void setFetchInBackground(bool enable);
+    bool fetchInBackground() const;
+    void setCacheSize(int rows);
+    int cacheSize() const;
+
 protected:
     void beginInsertRows(const QModelIndex &parent, int first, int last);
     void endInsertRows();
@@ -107,6 +112,12 @@ protected:
     virtual QModelIndex indexInQuery(const QModelIndex &item) const;
     void setLastError(const QSqlError &error);
     QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent = 0);
+
+private:
+    Q_PRIVATE_SLOT(d_func(), void _q_blockFetched(int, int, const QVariantList &))
+    Q_PRIVATE_SLOT(d_func(), void _q_blockDropped(int, int))
+    Q_PRIVATE_SLOT(d_func(), void _q_rowsCounted(int, int))
+    Q_PRIVATE_SLOT(d_func(), void _q_fetchFailed(int, const QString &, const QString &, int))
 };
 
 QT_END_NAMESPACE
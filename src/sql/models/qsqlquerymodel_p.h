@@ -57,23 +57,40 @@
 #include "QtSql/qsqlerror.h"
 #include "QtSql/qsqlquery.h"
 #include "QtSql/qsqlrecord.h"
+#include "QtCore/qcache.h"
 #include "QtCore/qhash.h"
+#include "QtCore/qset.h"
 #include "QtCore/qvarlengtharray.h"
 #include "QtCore/qvector.h"
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQueryModelFetcher;
+class QThread;
+
 class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0), fetchInBackground(false),
+        rowCountKnown(false), cacheSize(10000), fetchGeneration(0), fetchThread(0), fetcher(0) {}
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
+    void startFetching(const QString &query, const QSqlDatabase &db);
+    void stopFetching(bool wait);
+    QVariant fetchedValue(int row, int column);
+    void requestBlock(int block);
+    void resizeFetchedRows(int count);
+    void _q_blockFetched(int generation, int block, const QVariantList &rows);
+    void _q_blockDropped(int generation, int block);
+    void _q_rowsCounted(int generation, int count);
+    void _q_fetchFailed(int generation, const QString &driverText, const QString &databaseText,
+                        int type);
+
     mutable QSqlQuery query;
     mutable QSqlError error;
     QModelIndex bottom;
@@ -82,6 +99,16 @@ public:
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
+
+    // fetching in the background, see setFetchInBackground()
+    uint fetchInBackground : 1;
+    uint rowCountKnown : 1;
+    int cacheSize;
+    int fetchGeneration; // tells the answers for an earlier query apart
+    QThread *fetchThread;
+    QSqlQueryModelFetcher *fetcher;
+    QCache<int, QVector<QVariantList> > blocks; // cost is the number of rows
+    QSet<int> pendingBlocks;
 };
 
 // helpers for building SQL expressions
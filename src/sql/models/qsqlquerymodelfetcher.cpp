@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlquerymodelfetcher_p.h"
+#include "qsqlquerymodel.h"
+#include "qsqlquerymodel_p.h"
+
+#include <qsqldriver.h>
+#include <qsqlerror.h>
+#include <qsqlquery.h>
+#include <qsqlrecord.h>
+
+QT_BEGIN_NAMESPACE
+
+typedef QSqlQueryModelSql Sql;
+
+// requests the model has not seen an answer for yet; older ones are
+// dropped, as the view has scrolled past them in the meantime
+enum { MaxPendingRequests = 8 };
+
+// the query without a trailing semicolon
+static QString qStatement(const QString &query)
+{
+    QString inner = query.trimmed();
+    while (inner.endsWith(QLatin1Char(';'))) {
+        inner.chop(1);
+        inner = inner.trimmed();
+    }
+    return inner;
+}
+
+static QString qSubquery(const QString &query)
+{
+    return Sql::paren(qStatement(query));
+}
+
+QSqlQueryModelFetcher::QSqlQueryModelFetcher(const QSqlDatabase &db, const QString &query,
+                                             int generation, int blockSize)
+    : source(db), query(query), generation(generation), blockSize(blockSize),
+      // a PostgreSQL connection runs one statement at a time, so a streamed
+      // result is read into memory as soon as another statement, such as
+      // the COUNT query, runs; the rows are kept in a cursor on the server
+      serverCursor(db.driverName().startsWith(QLatin1String("QPSQL"))),
+      cursorBlock(-1), scheduled(false)
+{
+}
+
+QSqlQueryModelFetcher::~QSqlQueryModelFetcher()
+{
+    if (connectionName.isEmpty())
+        return;
+    cursor = QSqlQuery();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void QSqlQueryModelFetcher::stop()
+{
+    stopped.store(1);
+}
+
+/*
+    Returns true if the rows of a query on \a db can be read in blocks
+    by another connection.
+*/
+bool QSqlQueryModelFetcher::canFetch(const QSqlDatabase &db)
+{
+    if (!db.isValid())
+        return false;
+    // the statements built by windowStatement() need LIMIT and OFFSET
+    const QString driverName = db.driverName();
+    if (driverName == QLatin1String("QSQLITE"))
+        return db.databaseName() != QLatin1String(":memory:");
+    return driverName.startsWith(QLatin1String("QPSQL"))
+            || driverName.startsWith(QLatin1String("QMYSQL"));
+}
+
+/*
+    Returns a statement that selects \a limit rows of \a query, starting
+    with row \a offset.
+*/
+QString QSqlQueryModelFetcher::windowStatement(const QString &query, int limit, int offset)
+{
+    return windowStatement(query, QString::number(limit), offset);
+}
+
+QString QSqlQueryModelFetcher::windowStatement(const QString &query, const QString &limit, int offset)
+{
+    return Sql::concat(Sql::concat(Sql::select(QLatin1String("*")),
+                                   Sql::from(Sql::concat(qSubquery(query), QLatin1String("qt_window")))),
+                       QLatin1String("LIMIT ") + limit
+                       + QLatin1String(" OFFSET ") + QString::number(offset));
+}
+
+void QSqlQueryModelFetcher::open()
+{
+    if (stopped.load())
+        return;
+
+    connectionName = QLatin1String("qt_sql_modelfetcher_")
+            + QString::number(quintptr(this), 16);
+    db = QSqlDatabase::cloneDatabase(source, connectionName);
+    source = QSqlDatabase();
+    if (!db.open()) {
+        fail(db.lastError());
+        return;
+    }
+
+    // show the first rows as soon as possible, the count can take a while;
+    // the cursor is opened later, MySQL can't run the count while it is
+    {
+        QSqlQuery first(db);
+        first.setForwardOnly(true);
+        bool atEnd;
+        if (!first.exec(windowStatement(query, blockSize, 0))) {
+            fail(first.lastError());
+            return;
+        }
+        if (!readBlock(first, 0, &atEnd))
+            return;
+    }
+
+    QSqlQuery count(db);
+    count.setForwardOnly(true);
+    if (!count.exec(Sql::concat(Sql::select(QLatin1String("COUNT(*)")),
+                                Sql::from(Sql::concat(qSubquery(query), QLatin1String("qt_count")))))
+            || !count.next()) {
+        fail(count.lastError());
+        return;
+    }
+    if (!stopped.load())
+        emit rowsCounted(generation, int(qMin(count.value(0).toLongLong(), qlonglong(INT_MAX))));
+}
+
+void QSqlQueryModelFetcher::fetch(int block)
+{
+    requests.removeOne(block);
+    requests.append(block);
+    if (requests.count() > MaxPendingRequests)
+        emit blockDropped(generation, requests.takeFirst());
+
+    // let the requests that are queued already come in first, so
+    // that the most recent one is served next
+    if (!scheduled) {
+        scheduled = true;
+        QMetaObject::invokeMethod(this, "processRequests", Qt::QueuedConnection);
+    }
+}
+
+void QSqlQueryModelFetcher::processRequests()
+{
+    scheduled = false;
+    if (stopped.load() || requests.isEmpty() || !db.isOpen())
+        return;
+
+    if (!fetchBlock(requests.takeLast()))
+        return;
+
+    if (!requests.isEmpty()) {
+        scheduled = true;
+        QMetaObject::invokeMethod(this, "processRequests", Qt::QueuedConnection);
+    }
+}
+
+bool QSqlQueryModelFetcher::fetchBlock(int block)
+{
+    if (block != cursorBlock && !seek(block))
+        return false;
+
+    bool atEnd;
+    if (serverCursor) {
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        if (!q.exec(QLatin1String("FETCH ") + QString::number(blockSize)
+                    + QLatin1String(" FROM qt_fetch"))) {
+            cursorBlock = -1;
+            fail(q.lastError());
+            return false;
+        }
+        if (!readBlock(q, block, &atEnd))
+            return false;
+    } else if (!readBlock(cursor, block, &atEnd)) {
+        return false;
+    }
+
+    if (atEnd) {
+        // nothing to read ahead, don't keep the result open
+        if (!serverCursor)
+            cursor = QSqlQuery();
+        cursorBlock = -1;
+    } else {
+        cursorBlock = block + 1;
+    }
+    return true;
+}
+
+/*
+    Positions the cursor on the first row of \a block. The database still
+    steps over the rows before it, but only once per jump instead of for
+    every block.
+*/
+bool QSqlQueryModelFetcher::seek(int block)
+{
+    cursorBlock = -1;
+    const int offset = block * blockSize;
+
+    if (serverCursor) {
+        if (!cursor.isActive()) {
+            // a held cursor outlives the statement's transaction, so it
+            // keeps no locks; the rows are stored on the server instead
+            cursor = QSqlQuery(db);
+            if (!cursor.exec(QLatin1String("DECLARE qt_fetch SCROLL CURSOR WITH HOLD FOR ")
+                             + qStatement(query))) {
+                fail(cursor.lastError());
+                cursor = QSqlQuery();
+                return false;
+            }
+        }
+        QSqlQuery move(db);
+        if (!move.exec(QLatin1String("MOVE ABSOLUTE ") + QString::number(offset)
+                       + QLatin1String(" IN qt_fetch"))) {
+            fail(move.lastError());
+            return false;
+        }
+    } else {
+        cursor = QSqlQuery(db);
+        cursor.setForwardOnly(true);
+        QString statement = query;
+        if (offset > 0) {
+            // SQLite takes a negative limit for no limit, MySQL needs the largest one
+            statement = windowStatement(query, db.driverName() == QLatin1String("QSQLITE")
+                                               ? QString::fromLatin1("-1")
+                                               : QString::fromLatin1("18446744073709551615"),
+                                        offset);
+        }
+        if (!cursor.exec(statement)) {
+            fail(cursor.lastError());
+            cursor = QSqlQuery();
+            return false;
+        }
+    }
+    cursorBlock = block;
+    return true;
+}
+
+/*
+    Reads up to blockSize rows of \a q and hands them to the model as
+    \a block. \a atEnd is set to true if the result has no more rows.
+*/
+bool QSqlQueryModelFetcher::readBlock(QSqlQuery &q, int block, bool *atEnd)
+{
+    const int columns = q.record().count();
+    QVariantList rows;
+    rows.reserve(blockSize);
+    while (rows.count() < blockSize && q.next()) {
+        QVariantList row;
+        row.reserve(columns);
+        for (int i = 0; i < columns; ++i)
+            row.append(q.value(i));
+        rows.append(QVariant(row));
+    }
+    *atEnd = rows.count() < blockSize;
+    if (stopped.load())
+        return false;
+    emit blockFetched(generation, block, rows);
+    return true;
+}
+
+void QSqlQueryModelFetcher::fail(const QSqlError &error)
+{
+    requests.clear();
+    if (!stopped.load())
+        emit failed(generation, error.driverText(), error.databaseText(), error.type());
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLQUERYMODELFETCHER_P_H
+#define QSQLQUERYMODELFETCHER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of qsqlquerymodel.cpp .  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qatomic.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qobject.h"
+#include "QtCore/qvariant.h"
+#include "QtSql/qsqldatabase.h"
+#include "QtSql/qsqlquery.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSqlError;
+
+// Reads the rows of a QSqlQueryModel in blocks on a thread of its own,
+// through its own copy of the model's connection. Lives in that thread;
+// the model talks to it with queued calls only.
+//
+// The blocks are read from a cursor that stays open, so reading them in
+// order costs no more than reading the result once. Only a jump to
+// another block positions the cursor again.
+class QSqlQueryModelFetcher : public QObject
+{
+    Q_OBJECT
+public:
+    QSqlQueryModelFetcher(const QSqlDatabase &db, const QString &query, int generation, int blockSize);
+    ~QSqlQueryModelFetcher();
+
+    // may be called from any thread
+    void stop();
+
+    static bool canFetch(const QSqlDatabase &db);
+    static QString windowStatement(const QString &query, int limit, int offset);
+
+public slots:
+    void open();
+    void fetch(int block);
+
+signals:
+    void blockFetched(int generation, int block, const QVariantList &rows);
+    void blockDropped(int generation, int block);
+    void rowsCounted(int generation, int count);
+    void failed(int generation, const QString &driverText, const QString &databaseText, int type);
+
+private slots:
+    void processRequests();
+
+private:
+    static QString windowStatement(const QString &query, const QString &limit, int offset);
+    bool fetchBlock(int block);
+    bool seek(int block);
+    bool readBlock(QSqlQuery &q, int block, bool *atEnd);
+    void fail(const QSqlError &error);
+
+    QSqlDatabase source;
+    QSqlDatabase db;
+    QString connectionName;
+    QString query;
+    int generation;
+    int blockSize;
+    bool serverCursor; // a PostgreSQL cursor instead of cursor
+    QSqlQuery cursor;
+    int cursorBlock; // the block the cursor reads next, or -1
+    QList<int> requests; // most recent last
+    bool scheduled;
+    QAtomicInt stopped;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLQUERYMODELFETCHER_P_H
@@ -50,6 +50,7 @@
 #include "qsqlresult.h"
 
 #include "qsqltablemodel_p.h"
+#include "private/qsqldriver_p.h"
 
 #include <qdebug.h>
 
@@ -152,12 +153,8 @@ void QSqlTableModelPrivate::revertCachedRow(int row)
     }
 }
 
-bool QSqlTableModelPrivate::exec(const QString &stmt, bool prepStatement,
-                                 const QSqlRecord &rec, const QSqlRecord &whereValues)
+void QSqlTableModelPrivate::initEditQuery()
 {
-    if (stmt.isEmpty())
-        return false;
-
     // lazy initialization of editQuery
     if (editQuery.driver() != db.driver())
         editQuery = QSqlQuery(db);
@@ -166,6 +163,42 @@ bool QSqlTableModelPrivate::exec(const QString &stmt, bool prepStatement,
     // from the table to make sure the editQuery succeeds
     if (db.driver()->hasFeature(QSqlDriver::SimpleLocking))
         const_cast<QSqlResult *>(query.result())->detachFromResultSet();
+}
+
+bool QSqlTableModelPrivate::exec(const QString &stmt, bool prepStatement,
+                                 const QSqlRecord &rec, const QSqlRecord &whereValues)
+{
+    if (stmt.isEmpty())
+        return false;
+
+    batched = false;
+    if (batching) {
+        // statements must reach the database in the order they were made
+        if (stmt != batchStatement && !execBatch())
+            return false;
+        if (prepStatement) {
+            QVariantList params;
+            int i;
+            for (i = 0; i < rec.count(); ++i)
+                if (rec.isGenerated(i))
+                    params.append(rec.value(i));
+            for (i = 0; i < whereValues.count(); ++i)
+                if (whereValues.isGenerated(i) && !whereValues.isNull(i))
+                    params.append(whereValues.value(i));
+
+            if (!params.isEmpty()) {
+                // the same statement text always has the same placeholders
+                batchStatement = stmt;
+                batchValues.resize(params.count());
+                for (i = 0; i < params.count(); ++i)
+                    batchValues[i].append(params.at(i));
+                batched = true;
+                return true;
+            }
+        }
+    }
+
+    initEditQuery();
 
     if (prepStatement) {
         if (editQuery.lastQuery() != stmt) {
@@ -195,6 +228,139 @@ bool QSqlTableModelPrivate::exec(const QString &stmt, bool prepStatement,
     return true;
 }
 
+/*
+    Executes the statements collected by exec() while batching, if any.
+    On success the rows they belong to are moved to executedRows.
+*/
+bool QSqlTableModelPrivate::execBatch()
+{
+    if (batchStatement.isEmpty())
+        return true;
+
+    initEditQuery();
+
+    bool ok = editQuery.lastQuery() == batchStatement || editQuery.prepare(batchStatement);
+    if (ok) {
+        for (int i = 0; i < batchValues.count(); ++i)
+            editQuery.bindValue(i, batchValues.at(i));
+        ok = editQuery.execBatch();
+    }
+    if (ok)
+        executedRows += batchRows;
+    else
+        error = editQuery.lastError();
+
+    batchStatement.clear();
+    batchValues.clear();
+    batchRows.clear();
+    return ok;
+}
+
+void QSqlTableModelPrivate::clearBatch()
+{
+    batching = false;
+    batched = false;
+    batchStatement.clear();
+    batchValues.clear();
+    batchRows.clear();
+    executedRows.clear();
+}
+
+bool QSqlTableModelPrivate::submitRow(int row, const ModifiedRow &mrow)
+{
+    Q_Q(QSqlTableModel);
+    switch (mrow.op()) {
+    case Insert:
+        return q->insertRowIntoTable(mrow.rec());
+    case Update:
+        return q->updateRowInTable(row, mrow.rec());
+    case Delete:
+        return q->deleteRowFromTable(row);
+    case None:
+        Q_ASSERT_X(false, "QSqlTableModel::submitAll()", "Invalid cache operation");
+        break;
+    }
+    return true;
+}
+
+/*
+    submitAll() for OnManualSubmit when the driver supports prepared
+    queries. The row operations still go through insertRowIntoTable(),
+    updateRowInTable() and deleteRowFromTable(), but exec() only
+    collects their bound values, which are then written with one
+    execBatch() call per run of identical statements.
+*/
+bool QSqlTableModelPrivate::submitAllBatched()
+{
+    Q_Q(QSqlTableModel);
+
+    QSqlDriver *driver = db.driver();
+    const bool ownTransaction = driver->hasFeature(QSqlDriver::Transactions)
+            && !static_cast<QSqlDriverPrivate *>(QObjectPrivate::get(driver))->inTransaction
+            && db.transaction();
+
+    bool success = true;
+    bool needsSelect = false;
+    batching = true;
+
+    foreach (int row, cache.keys()) {
+        // be sure cache *still* contains the row since overriden methods could have called select()
+        CacheMap::iterator it = cache.find(row);
+        if (it == cache.end())
+            continue;
+
+        const ModifiedRow &mrow = it.value();
+        if (mrow.submitted())
+            continue;
+
+        const Op op = mrow.op();
+        success = submitRow(row, mrow);
+        if (!success)
+            break;
+
+        if (batched)
+            batchRows.append(row);
+        else
+            executedRows.append(row);
+        if (op != Update)
+            needsSelect = true;
+    }
+
+    if (success)
+        success = execBatch();
+
+    if (ownTransaction) {
+        if (success && !db.commit()) {
+            error = db.lastError();
+            success = false;
+        }
+        if (!success) {
+            db.rollback();
+            executedRows.clear();
+        }
+    }
+
+    const QList<int> rows = executedRows;
+    clearBatch();
+
+    for (int i = 0; i < rows.count(); ++i) {
+        CacheMap::iterator it = cache.find(rows.at(i));
+        if (it != cache.end())
+            it.value().setSubmitted();
+    }
+
+    if (!success)
+        return false;
+    if (needsSelect)
+        return q->select();
+
+    // only updates; the cache now holds what was written
+    const int lastColumn = q->columnCount() - 1;
+    for (int i = 0; i < rows.count(); ++i)
+        emit q->dataChanged(q->createIndex(rows.at(i), 0), q->createIndex(rows.at(i), lastColumn));
+    return true;
+}
+
 /*!
     \class QSqlTableModel
     \brief The QSqlTableModel class provides an editable data model
@@ -723,6 +889,16 @@ bool QSqlTableModel::deleteRowFromTable(int row)
     In OnManualSubmit, on success the model will be repopulated.
     Any views presenting it will lose their selections.
 
+    In OnManualSubmit, if the driver supports prepared queries,
+    consecutive rows that need the same statement are written with a
+    single QSqlQuery::execBatch() call, and all of them are written
+    inside one transaction, unless a transaction was already started
+    with QSqlDatabase::transaction(). If only existing rows were
+    updated, the model is not repopulated: the values that were
+    written are kept, so changes made by database triggers and the
+    effect on the sort order or the filter only show up after the
+    next select().
+
     Note: In OnManualSubmit mode, already submitted changes won't
     be cleared from the cache when submitAll() fails. This allows
     transactions to be rolled back and resubmitted without
@@ -734,6 +910,9 @@ bool QSqlTableModel::submitAll()
 {
     Q_D(QSqlTableModel);
 
+    if (d->strategy == OnManualSubmit && d->db.driver()->hasFeature(QSqlDriver::PreparedQueries))
+        return d->submitAllBatched();
+
     bool success = true;
 
     foreach (int row, d->cache.keys()) {
@@ -746,20 +925,7 @@ bool QSqlTableModel::submitAll()
         if (mrow.submitted())
             continue;
 
-        switch (mrow.op()) {
-        case QSqlTableModelPrivate::Insert:
-            success = insertRowIntoTable(mrow.rec());
-            break;
-        case QSqlTableModelPrivate::Update:
-            success = updateRowInTable(row, mrow.rec());
-            break;
-        case QSqlTableModelPrivate::Delete:
-            success = deleteRowFromTable(row);
-            break;
-        case QSqlTableModelPrivate::None:
-            Q_ASSERT_X(false, "QSqlTableModel::submitAll()", "Invalid cache operation");
-            break;
-        }
+        success = d->submitRow(row, mrow);
 
         if (success) {
             if (d->strategy != OnManualSubmit && mrow.op() == QSqlTableModelPrivate::Insert) {
@@ -68,14 +68,19 @@ public:
         : sortColumn(-1),
           sortOrder(Qt::AscendingOrder),
           strategy(QSqlTableModel::OnRowChange),
-          busyInsertingRows(false)
+          busyInsertingRows(false),
+          batching(false),
+          batched(false)
     {}
     void clear();
     virtual void clearCache();
     QSqlRecord record(const QVector<QVariant> &values) const;
 
+    void initEditQuery();
     bool exec(const QString &stmt, bool prepStatement,
               const QSqlRecord &rec, const QSqlRecord &whereValues);
+    bool execBatch();
+    void clearBatch();
     virtual void revertCachedRow(int row);
     virtual int nameToIndex(const QString &name) const;
     QString strippedFieldName(const QString &name) const;
@@ -91,6 +96,14 @@ public:
     bool busyInsertingRows;
 
     QSqlQuery editQuery;
+    // submitAll() collects the bound values of consecutive prepared
+    // statements with the same text and executes them with execBatch()
+    bool batching;
+    bool batched; // the last exec() call was added to the batch
+    QString batchStatement;
+    QVector<QVariantList> batchValues;
+    QList<int> batchRows;
+    QList<int> executedRows;
     QSqlIndex primaryIndex;
     QString tableName;
     QString filter;
@@ -185,6 +198,9 @@ public:
 
     typedef QMap<int, ModifiedRow> CacheMap;
     CacheMap cache;
+
+    bool submitRow(int row, const ModifiedRow &mrow);
+    bool submitAllBatched();
 };
 
 class QSqlTableModelSql: public QSqlQueryModelSql
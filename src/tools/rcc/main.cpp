@@ -66,6 +66,7 @@ void showHelp(const QString &argv0, const QString &error)
         "  -root path           prefix resource access path with root path\n"
         "  -no-compress         disable all compression\n"
         "  -binary              output a binary file for use as a dynamic resource\n"
+        "  -align bytes         align uncompressed data in binary output to bytes\n"
         "  -namespace           turn off namespace macros\n"
         "  -project             Output a resource file containing all\n"
         "                       files from the current directory\n"
@@ -178,6 +179,15 @@ int runRcc(int argc, char *argv[])
                 library.setCompressThreshold(args[++i].toInt());
             } else if (opt == QLatin1String("-binary")) {
                 library.setFormat(RCCResourceLibrary::Binary);
+            } else if (opt == QLatin1String("-align")) {
+                if (!(i < argc-1)) {
+                    errorMsg = QLatin1String("Missing alignment");
+                    break;
+                }
+                const int alignment = args[++i].toInt();
+                if (alignment <= 0 || (alignment & (alignment - 1)))
+                    errorMsg = QLatin1String("Alignment must be a power of two");
+                library.setDataAlignment(alignment);
             } else if (opt == QLatin1String("-namespace")) {
                 library.setUseNameSpace(!library.useNameSpace());
             } else if (opt == QLatin1String("-verbose")) {
@@ -216,9 +216,6 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
 {
     const bool text = (lib.m_format == RCCResourceLibrary::C_Code);
 
-    //capture the offset
-    m_dataOffset = offset;
-
     //find the data to be written
     QFile file(m_fileInfo.absoluteFilePath());
     if (!file.open(QFile::ReadOnly)) {
@@ -241,6 +238,20 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     }
 #endif // QT_NO_COMPRESS
 
+    // pad, so that the payload after the length starts on the requested
+    // boundary of the file, which stays aligned when the file is mmap'ed
+    if (lib.m_format == RCCResourceLibrary::Binary && lib.m_dataAlignment > 1
+        && !(m_flags & Compressed)) {
+        const int mask = lib.m_dataAlignment - 1;
+        const int padding = (lib.m_dataAlignment - ((lib.m_out.size() + 4) & mask)) & mask;
+        for (int i = 0; i < padding; ++i)
+            lib.writeChar(0);
+        offset += padding;
+    }
+
+    //capture the offset
+    m_dataOffset = offset;
+
     // some info
     if (text) {
         lib.writeString("  // ");
@@ -343,6 +354,7 @@ RCCResourceLibrary::RCCResourceLibrary()
     m_verbose(false),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
+    m_dataAlignment(1),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
@@ -93,6 +93,10 @@ public:
     void setCompressThreshold(int t) { m_compressThreshold = t; }
     int compressThreshold() const { return m_compressThreshold; }
 
+    // only applies to uncompressed files in Binary format
+    void setDataAlignment(int a) { m_dataAlignment = a; }
+    int dataAlignment() const { return m_dataAlignment; }
+
     void setResourceRoot(const QString &root) { m_resourceRoot = root; }
     QString resourceRoot() const { return m_resourceRoot; }
 
@@ -141,6 +145,7 @@ private:
     bool m_verbose;
     int m_compressLevel;
     int m_compressThreshold;
+    int m_dataAlignment;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
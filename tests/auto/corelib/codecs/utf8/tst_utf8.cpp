@@ -150,6 +150,14 @@ void tst_Utf8::roundTrip_data()
                                     ' ', 0x10FFFD, ' ',
                                     0x20AC, 'd', 'e', 'f', 0 };
     QTest::newRow("utf8_8") << QByteArray(utf8_8) << QString::fromUcs4(utf32_8);
+
+    // long runs of ASCII, broken up at different offsets in blocks of 16
+    static const char utf8_9[] = "This is a standard US-ASCII message\302\240with non-ASCII "
+                                 "characters\342\202\254in between, 0123456789abcdef\303\251";
+    const QString utf16_9 = QLatin1String("This is a standard US-ASCII message") + QChar(0x00A0)
+            + QLatin1String("with non-ASCII characters") + QChar(0x20AC)
+            + QLatin1String("in between, 0123456789abcdef") + QChar(0x00E9);
+    QTest::newRow("utf8_9") << QByteArray(utf8_9) << utf16_9;
 }
 
 void tst_Utf8::roundTrip()
@@ -1,6 +1,7 @@
 TEMPLATE=subdirs
 SUBDIRS=\
     qabstractfileengine \
+    qasyncfile \
     qbuffer \
     qdatastream \
     qdataurl \
@@ -44,6 +45,7 @@ SUBDIRS=\
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
     qabstractfileengine \
+    qasyncfile \
     qfileinfo \
     qipaddress \
     qurlinternal
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qasyncfile
+QT = core-private testlib
+SOURCES = tst_qasyncfile.cpp
@@ -0,0 +1,280 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QAsyncFile>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QTemporaryDir>
+#ifdef QT_BUILD_INTERNAL
+#include <private/qasyncfile_p.h>
+#endif
+
+class tst_QAsyncFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void readWrite_data();
+    void readWrite();
+    void readPastEnd_data();
+    void readPastEnd();
+    void openErrors();
+    void notOpen();
+    void closeWaitsForPendingRequests_data();
+    void closeWaitsForPendingRequests();
+    void futureWatcher();
+
+private:
+    void populateBackends();
+    bool openWithBackend(QAsyncFile *file, QIODevice::OpenMode mode);
+    QString createFile(const QString &name, const QByteArray &contents);
+
+    QTemporaryDir tempDir;
+};
+
+void tst_QAsyncFile::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+}
+
+void tst_QAsyncFile::populateBackends()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("default") << QString();
+#ifdef QT_BUILD_INTERNAL
+    QTest::newRow("threadpool") << QString::fromLatin1("threadpool");
+#ifdef QT_ASYNCFILE_IO_URING
+    if (QAsyncFileBackend::ioUringBackend())
+        QTest::newRow("io_uring") << QString::fromLatin1("io_uring");
+#endif
+#endif
+}
+
+bool tst_QAsyncFile::openWithBackend(QAsyncFile *file, QIODevice::OpenMode mode)
+{
+    if (!file->open(mode))
+        return false;
+#ifdef QT_BUILD_INTERNAL
+    QFETCH(QString, backend);
+    if (backend == QLatin1String("threadpool"))
+        QAsyncFilePrivate::get(file)->backend = QAsyncFileBackend::threadPoolBackend();
+#ifdef QT_ASYNCFILE_IO_URING
+    else if (backend == QLatin1String("io_uring"))
+        QAsyncFilePrivate::get(file)->backend = QAsyncFileBackend::ioUringBackend();
+#endif
+#endif
+    return true;
+}
+
+QString tst_QAsyncFile::createFile(const QString &name, const QByteArray &contents)
+{
+    const QString fileName = tempDir.path() + QLatin1Char('/') + name;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(contents) != contents.size())
+        return QString();
+    return fileName;
+}
+
+void tst_QAsyncFile::readWrite_data()
+{
+    populateBackends();
+}
+
+void tst_QAsyncFile::readWrite()
+{
+    const int blockCount = 200;
+    const int blockSize = 4096;
+    const QString fileName = createFile(QLatin1String("readWrite"), QByteArray());
+    QVERIFY(!fileName.isEmpty());
+
+    QAsyncFile file(fileName);
+    QVERIFY(openWithBackend(&file, QIODevice::ReadWrite));
+    QVERIFY(file.isOpen());
+    QCOMPARE(file.openMode(), QIODevice::ReadWrite);
+
+    // write all the blocks at once, in a scrambled order
+    QList<QFuture<qint64> > writes;
+    for (int i = 0; i < blockCount; ++i) {
+        const int block = (i * 7) % blockCount;
+        writes << file.write(qint64(block) * blockSize, QByteArray(blockSize, char('a' + block % 26)));
+    }
+    for (int i = 0; i < writes.size(); ++i)
+        QCOMPARE(writes[i].result(), qint64(blockSize));
+    file.waitForPendingRequests();
+    QCOMPARE(file.pendingRequests(), 0);
+    QCOMPARE(file.size(), qint64(blockCount) * blockSize);
+
+    QList<QFuture<QByteArray> > reads;
+    for (int i = 0; i < blockCount; ++i)
+        reads << file.read(qint64(i) * blockSize, blockSize);
+    for (int i = 0; i < reads.size(); ++i)
+        QCOMPARE(reads[i].result(), QByteArray(blockSize, char('a' + i % 26)));
+
+    // a read spanning several blocks
+    QByteArray expected;
+    for (int i = 2; i < 5; ++i)
+        expected += QByteArray(blockSize, char('a' + i % 26));
+    QCOMPARE(file.read(2 * blockSize, 3 * blockSize).result(), expected);
+
+    QCOMPARE(file.error(), QFileDevice::NoError);
+    file.close();
+    QVERIFY(!file.isOpen());
+
+    QFile check(fileName);
+    QVERIFY(check.open(QIODevice::ReadOnly));
+    check.seek(10 * blockSize);
+    QCOMPARE(check.read(blockSize), QByteArray(blockSize, 'k'));
+}
+
+void tst_QAsyncFile::readPastEnd_data()
+{
+    populateBackends();
+}
+
+void tst_QAsyncFile::readPastEnd()
+{
+    QByteArray contents;
+    for (int i = 0; i < 1000; ++i)
+        contents += char(i % 251);
+    const QString fileName = createFile(QLatin1String("readPastEnd"), contents);
+    QVERIFY(!fileName.isEmpty());
+
+    QAsyncFile file(fileName);
+    QVERIFY(openWithBackend(&file, QIODevice::ReadOnly));
+    QCOMPARE(file.size(), qint64(1000));
+
+    QFuture<QByteArray> tail = file.read(900, 500);
+    QFuture<QByteArray> atEnd = file.read(1000, 10);
+    QFuture<QByteArray> pastEnd = file.read(5000, 10);
+    QFuture<QByteArray> nothing = file.read(10, 0);
+    QCOMPARE(tail.result(), contents.mid(900));
+    QVERIFY(atEnd.result().isEmpty());
+    QVERIFY(pastEnd.result().isEmpty());
+    QVERIFY(nothing.result().isEmpty());
+    QCOMPARE(file.error(), QFileDevice::NoError);
+}
+
+void tst_QAsyncFile::openErrors()
+{
+    QAsyncFile missing(tempDir.path() + QLatin1String("/does-not-exist"));
+    QVERIFY(!missing.open(QIODevice::ReadOnly));
+    QVERIFY(!missing.isOpen());
+    QCOMPARE(missing.error(), QFileDevice::OpenError);
+    QVERIFY(!missing.errorString().isEmpty());
+
+    const QString fileName = createFile(QLatin1String("openErrors"), "data");
+    QAsyncFile file(fileName);
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::open: Append mode is not supported");
+    QVERIFY(!file.open(QIODevice::WriteOnly | QIODevice::Append));
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.error(), QFileDevice::NoError);
+    QTest::ignoreMessage(QtWarningMsg, qPrintable(QString::fromLatin1("QAsyncFile::open: File (%1) already open").arg(fileName)));
+    QVERIFY(!file.open(QIODevice::ReadOnly));
+}
+
+void tst_QAsyncFile::notOpen()
+{
+    const QString fileName = createFile(QLatin1String("notOpen"), "data");
+    QAsyncFile file(fileName);
+
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::read: File not open");
+    QFuture<QByteArray> read = file.read(0, 4);
+    QVERIFY(read.isFinished());
+    QVERIFY(read.result().isEmpty());
+
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::write: File not open");
+    QCOMPARE(file.write(0, "data").result(), qint64(-1));
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::write: ReadOnly file");
+    QCOMPARE(file.write(0, "data").result(), qint64(-1));
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::read: Called with negative offset or maxSize");
+    QVERIFY(file.read(-1, 4).result().isEmpty());
+    file.close();
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::read: WriteOnly file");
+    QVERIFY(file.read(0, 4).result().isEmpty());
+}
+
+void tst_QAsyncFile::closeWaitsForPendingRequests_data()
+{
+    populateBackends();
+}
+
+void tst_QAsyncFile::closeWaitsForPendingRequests()
+{
+    const QString fileName = createFile(QLatin1String("close"), QByteArray(1024 * 1024, 'x'));
+    QVERIFY(!fileName.isEmpty());
+
+    QList<QFuture<QByteArray> > reads;
+    {
+        QAsyncFile file(fileName);
+        QVERIFY(openWithBackend(&file, QIODevice::ReadOnly));
+        for (int i = 0; i < 500; ++i)
+            reads << file.read((i * 4093) % (1024 * 1024), 2048);
+    }
+    for (int i = 0; i < reads.size(); ++i) {
+        QVERIFY(reads[i].isFinished());
+        QCOMPARE(reads[i].result().size(), qMin(2048, 1024 * 1024 - (i * 4093) % (1024 * 1024)));
+    }
+}
+
+void tst_QAsyncFile::futureWatcher()
+{
+    const QString fileName = createFile(QLatin1String("watcher"), "hello, world");
+    QAsyncFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QFutureWatcher<QByteArray> watcher;
+    QSignalSpy spy(&watcher, SIGNAL(finished()));
+    watcher.setFuture(file.read(7, 100));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(watcher.result(), QByteArray("world"));
+}
+
+QTEST_GUILESS_MAIN(tst_QAsyncFile)
+#include "tst_qasyncfile.moc"
@@ -189,6 +189,12 @@ private slots:
 
     void floatingPointPrecision();
 
+    void streamVectorOfNumbers_data();
+    void streamVectorOfNumbers();
+    void readVectorPastEnd();
+    void readWriteArray();
+    void readIntoExistingBuffer();
+
     void compatibility_Qt3();
     void compatibility_Qt2();
 
@@ -3192,6 +3198,183 @@ void tst_QDataStream::floatingPointPrecision()
 
 }
 
+void tst_QDataStream::streamVectorOfNumbers_data()
+{
+    QTest::addColumn<int>("version");
+    QTest::addColumn<int>("byteOrder");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("Qt_5_1/big/double") << int(QDataStream::Qt_5_1) << int(QDataStream::BigEndian) << int(QDataStream::DoublePrecision);
+    QTest::newRow("Qt_5_1/little/double") << int(QDataStream::Qt_5_1) << int(QDataStream::LittleEndian) << int(QDataStream::DoublePrecision);
+    QTest::newRow("Qt_5_1/big/single") << int(QDataStream::Qt_5_1) << int(QDataStream::BigEndian) << int(QDataStream::SinglePrecision);
+    QTest::newRow("Qt_5_1/little/single") << int(QDataStream::Qt_5_1) << int(QDataStream::LittleEndian) << int(QDataStream::SinglePrecision);
+    QTest::newRow("Qt_4_5/big/single") << int(QDataStream::Qt_4_5) << int(QDataStream::BigEndian) << int(QDataStream::SinglePrecision);
+    QTest::newRow("Qt_3_1/big/double") << int(QDataStream::Qt_3_1) << int(QDataStream::BigEndian) << int(QDataStream::DoublePrecision);
+    QTest::newRow("Qt_3_1/little/double") << int(QDataStream::Qt_3_1) << int(QDataStream::LittleEndian) << int(QDataStream::DoublePrecision);
+}
+
+template <typename T>
+static void checkVectorOfNumbers(int version, QDataStream::ByteOrder byteOrder,
+                                 QDataStream::FloatingPointPrecision precision)
+{
+    QVector<T> vector;
+    for (int i = 0; i < 1000; ++i)
+        vector.append(T(qint64(i) * 1234567 - 500) + T(i % 7) / T(2));
+
+    // the vector must be streamed exactly like its elements one by one
+    QByteArray elementwise;
+    {
+        QDataStream stream(&elementwise, QIODevice::WriteOnly);
+        stream.setVersion(version);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(precision);
+        stream << quint32(vector.size());
+        for (int i = 0; i < vector.size(); ++i)
+            stream << vector.at(i);
+    }
+    QByteArray whole;
+    {
+        QDataStream stream(&whole, QIODevice::WriteOnly);
+        stream.setVersion(version);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(precision);
+        stream << vector;
+    }
+    QCOMPARE(whole, elementwise);
+
+    QVector<T> expected;
+    {
+        QDataStream stream(elementwise);
+        stream.setVersion(version);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(precision);
+        quint32 count;
+        stream >> count;
+        for (quint32 i = 0; i < count; ++i) {
+            T t;
+            stream >> t;
+            expected.append(t);
+        }
+    }
+
+    QDataStream stream(whole);
+    stream.setVersion(version);
+    stream.setByteOrder(byteOrder);
+    stream.setFloatingPointPrecision(precision);
+    QVector<T> result;
+    stream >> result;
+    QCOMPARE(stream.status(), QDataStream::Ok);
+    QVERIFY(stream.atEnd());
+    QCOMPARE(result, expected);
+}
+
+void tst_QDataStream::streamVectorOfNumbers()
+{
+    QFETCH(int, version);
+    QFETCH(int, byteOrder);
+    QFETCH(int, precision);
+    const QDataStream::ByteOrder order = QDataStream::ByteOrder(byteOrder);
+    const QDataStream::FloatingPointPrecision floatPrecision = QDataStream::FloatingPointPrecision(precision);
+
+    checkVectorOfNumbers<qint8>(version, order, floatPrecision);
+    checkVectorOfNumbers<quint8>(version, order, floatPrecision);
+    checkVectorOfNumbers<qint16>(version, order, floatPrecision);
+    checkVectorOfNumbers<quint16>(version, order, floatPrecision);
+    checkVectorOfNumbers<qint32>(version, order, floatPrecision);
+    checkVectorOfNumbers<quint32>(version, order, floatPrecision);
+    checkVectorOfNumbers<qint64>(version, order, floatPrecision);
+    checkVectorOfNumbers<quint64>(version, order, floatPrecision);
+    checkVectorOfNumbers<float>(version, order, floatPrecision);
+    checkVectorOfNumbers<double>(version, order, floatPrecision);
+}
+
+void tst_QDataStream::readVectorPastEnd()
+{
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << quint32(5) << qint32(1) << qint32(2) << qint32(3);
+        stream << qint16(4); // half of the fourth element
+    }
+
+    QDataStream stream(data);
+    QVector<qint32> vector(10, -1);
+    stream >> vector;
+    QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+    QCOMPARE(vector, QVector<qint32>() << 1 << 2 << 3 << 0 << 0);
+}
+
+void tst_QDataStream::readWriteArray()
+{
+    const quint16 shorts[] = { 0x0102, 0x0304, 0x0506, 0x0708, 0x090a, 0x0b0c, 0x0d0e, 0x0f10, 0x1112 };
+    const quint32 ints[] = { 0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10, 0x11121314 };
+    const quint64 longs[] = { Q_UINT64_C(0x0102030405060708), Q_UINT64_C(0x090a0b0c0d0e0f10),
+                              Q_UINT64_C(0x1112131415161718) };
+
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setByteOrder(QDataStream::BigEndian);
+        QCOMPARE(stream.writeArray(reinterpret_cast<const char *>(shorts), 9, 2), 9);
+        QCOMPARE(stream.writeArray(reinterpret_cast<const char *>(ints), 5, 4), 5);
+        QCOMPARE(stream.writeArray(reinterpret_cast<const char *>(longs), 3, 8), 3);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        QCOMPARE(stream.writeArray(reinterpret_cast<const char *>(ints), 5, 4), 5);
+    }
+    QCOMPARE(data.size(), 18 + 20 + 24 + 20);
+    QCOMPARE(data.left(4), QByteArray("\x01\x02\x03\x04"));
+    QCOMPARE(data.mid(18, 4), QByteArray("\x01\x02\x03\x04"));
+    QCOMPARE(data.mid(38, 8), QByteArray("\x01\x02\x03\x04\x05\x06\x07\x08"));
+    QCOMPARE(data.mid(62, 4), QByteArray("\x04\x03\x02\x01"));
+
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::BigEndian);
+    quint16 readShorts[9];
+    quint32 readInts[5];
+    quint64 readLongs[3];
+    QCOMPARE(stream.readArray(reinterpret_cast<char *>(readShorts), 9, 2), 9);
+    QVERIFY(!memcmp(readShorts, shorts, sizeof(shorts)));
+    QCOMPARE(stream.readArray(reinterpret_cast<char *>(readInts), 5, 4), 5);
+    QVERIFY(!memcmp(readInts, ints, sizeof(ints)));
+    QCOMPARE(stream.readArray(reinterpret_cast<char *>(readLongs), 3, 8), 3);
+    QVERIFY(!memcmp(readLongs, longs, sizeof(longs)));
+    stream.setByteOrder(QDataStream::LittleEndian);
+    memset(readInts, 0, sizeof(readInts));
+    QCOMPARE(stream.readArray(reinterpret_cast<char *>(readInts), 5, 4), 5);
+    QVERIFY(!memcmp(readInts, ints, sizeof(ints)));
+
+    QCOMPARE(stream.readArray(reinterpret_cast<char *>(readInts), 5, 4), 0);
+    QVERIFY(stream.atEnd());
+}
+
+void tst_QDataStream::readIntoExistingBuffer()
+{
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << QVector<double>(1000, 1.5) << QVector<double>(900, 2.5);
+        stream << QByteArray(1000, 'a') << QByteArray(900, 'b');
+    }
+
+    QDataStream stream(data);
+    QVector<double> vector;
+    stream >> vector;
+    QCOMPARE(vector, QVector<double>(1000, 1.5));
+    const double *vectorData = vector.constData();
+    stream >> vector;
+    QCOMPARE(vector, QVector<double>(900, 2.5));
+    QCOMPARE(vector.constData(), vectorData);
+
+    QByteArray array;
+    stream >> array;
+    QCOMPARE(array, QByteArray(1000, 'a'));
+    const char *arrayData = array.constData();
+    stream >> array;
+    QCOMPARE(array, QByteArray(900, 'b'));
+    QCOMPARE(array.constData(), arrayData);
+    QCOMPARE(stream.status(), QDataStream::Ok);
+}
+
 QTEST_MAIN(tst_QDataStream)
 #include "tst_qdatastream.moc"
 
@@ -79,6 +79,15 @@ private slots:
     void QTBUG2331();
     void QTBUG2331_data() { basicTest_data(); }
 
+    void recursiveWatch_data() { basicTest_data(); }
+    void recursiveWatch();
+    void removeRecursivePath();
+
+    void coalescing_data() { basicTest_data(); }
+    void coalescing();
+
+    void queueOverflow();
+
 private:
     QString m_tempDirPattern;
 };
@@ -580,5 +589,185 @@ void tst_QFileSystemWatcher::QTBUG2331()
     QCOMPARE(watcher.directories(), QStringList());
 }
 
+static QStringList sorted(QStringList list)
+{
+    list.sort();
+    return list;
+}
+
+void tst_QFileSystemWatcher::recursiveWatch()
+{
+    QFETCH(QString, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+    QDir rootDir(root);
+    QVERIFY(rootDir.mkpath("a/b/c"));
+    QVERIFY(rootDir.mkpath("d"));
+    QFile file(root + QStringLiteral("/a/file.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_") + backend);
+    QVERIFY(watcher.addRecursivePath(root));
+    QCOMPARE(sorted(watcher.directories()),
+             QStringList() << root << root + "/a" << root + "/a/b" << root + "/a/b/c" << root + "/d");
+    QVERIFY(watcher.files().isEmpty());
+
+    // adding the tree again doesn't add anything
+    QVERIFY(watcher.addRecursivePath(root));
+    QCOMPARE(watcher.directories().count(), 5);
+
+    QSignalSpy changedSpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QVERIFY(changedSpy.isValid());
+
+    // the poller can't see changes within the same second
+    if (backend == QLatin1String("poller"))
+        QTest::qWait(2000);
+
+    // new subdirectories, and their own subdirectories, get watched
+    QVERIFY(rootDir.mkpath("a/b/new/deep"));
+    QTRY_VERIFY(watcher.directories().contains(root + "/a/b/new/deep"));
+    QVERIFY(watcher.directories().contains(root + "/a/b/new"));
+    QVERIFY(!changedSpy.isEmpty());
+    QCOMPARE(changedSpy.first().first().toString(), root + QStringLiteral("/a/b"));
+
+    if (backend == QLatin1String("poller"))
+        QTest::qWait(2000);
+    changedSpy.clear();
+    QFile newFile(root + QStringLiteral("/a/b/new/deep/file.txt"));
+    QVERIFY(newFile.open(QIODevice::WriteOnly));
+    newFile.close();
+    QTRY_VERIFY(!changedSpy.isEmpty());
+    QCOMPARE(changedSpy.first().first().toString(), root + QStringLiteral("/a/b/new/deep"));
+}
+
+void tst_QFileSystemWatcher::removeRecursivePath()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+    QDir rootDir(root);
+    QVERIFY(rootDir.mkpath("tree/a/b"));
+    QVERIFY(rootDir.mkpath("tree/c"));
+    QVERIFY(rootDir.mkpath("other"));
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addPath(root + "/other"));
+    QVERIFY(!watcher.addRecursivePath(root + "/does-not-exist"));
+    QVERIFY(watcher.addRecursivePath(root + "/tree/"));
+    QCOMPARE(watcher.directories().count(), 5);
+
+    // removing the root removes the whole tree, but nothing else
+    QVERIFY(watcher.removePath(root + "/tree"));
+    QCOMPARE(watcher.directories(), QStringList() << root + "/other");
+
+    // the tree is not watched any more
+    QVERIFY(rootDir.mkpath("tree/d"));
+    QTest::qWait(500);
+    QCOMPARE(watcher.directories(), QStringList() << root + "/other");
+}
+
+void tst_QFileSystemWatcher::coalescing()
+{
+    QFETCH(QString, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    QFile testFile(temporaryDirectory.path() + QStringLiteral("/testfile.txt"));
+    QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    testFile.close();
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_") + backend);
+    QCOMPARE(watcher.coalescingInterval(), 0);
+    watcher.setCoalescingInterval(1500);
+    QCOMPARE(watcher.coalescingInterval(), 1500);
+    QVERIFY(watcher.addPath(testFile.fileName()));
+    QVERIFY(watcher.addPath(temporaryDirectory.path()));
+
+    QSignalSpy fileSpy(&watcher, SIGNAL(fileChanged(QString)));
+    QSignalSpy directorySpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QSignalSpy batchSpy(&watcher, SIGNAL(pathsChanged(QStringList)));
+    QVERIFY(fileSpy.isValid());
+    QVERIFY(directorySpy.isValid());
+    QVERIFY(batchSpy.isValid());
+
+    if (backend == QLatin1String("poller"))
+        QTest::qWait(2000);
+
+    // a burst of changes is reported once per path
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Append));
+        testFile.write("hello");
+        testFile.close();
+        QFile other(temporaryDirectory.path() + QStringLiteral("/other") + QString::number(i));
+        QVERIFY(other.open(QIODevice::WriteOnly));
+        other.close();
+        QCoreApplication::processEvents();
+    }
+
+    QTRY_COMPARE(batchSpy.count(), 1);
+    QCOMPARE(fileSpy.count(), 1);
+    QCOMPARE(fileSpy.first().first().toString(), testFile.fileName());
+    QCOMPARE(directorySpy.count(), 1);
+    QCOMPARE(directorySpy.first().first().toString(), temporaryDirectory.path());
+    QCOMPARE(batchSpy.first().first().toStringList(),
+             QStringList() << testFile.fileName() << temporaryDirectory.path());
+
+    // changes that are pending when the interval is reset are delivered right away
+    if (backend == QLatin1String("poller"))
+        QTest::qWait(2000);
+    batchSpy.clear();
+    fileSpy.clear();
+    QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Append));
+    testFile.write("hello");
+    testFile.close();
+    QTest::qWait(backend == QLatin1String("poller") ? 1200 : 100);
+    QCOMPARE(fileSpy.count(), 0);
+    watcher.setCoalescingInterval(0);
+    QCOMPARE(fileSpy.count(), 1);
+    QCOMPARE(batchSpy.count(), 1);
+}
+
+void tst_QFileSystemWatcher::queueOverflow()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Lost notifications are only reported by the inotify backend");
+#else
+    QFile limitFile(QStringLiteral("/proc/sys/fs/inotify/max_queued_events"));
+    if (!limitFile.open(QIODevice::ReadOnly))
+        QSKIP("Cannot determine the size of the inotify queue");
+    const int limit = limitFile.readAll().trimmed().toInt();
+    if (limit <= 0 || limit > 100000)
+        QSKIP("The inotify queue is too large to overflow it in a test");
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_native"));
+    QVERIFY(watcher.addRecursivePath(root));
+    QSignalSpy rescanSpy(&watcher, SIGNAL(rescanRequired()));
+    QVERIFY(rescanSpy.isValid());
+
+    // without returning to the event loop, create more events than the
+    // kernel queues; the directory created last is only noticed by the rescan
+    QFile file(root + QStringLiteral("/file"));
+    for (int i = 0; i < limit / 2 + 1; ++i) {
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+        QVERIFY(file.remove());
+    }
+    QVERIFY(QDir(root).mkdir("late"));
+
+    QTRY_VERIFY(rescanSpy.count() >= 1);
+    QVERIFY(watcher.directories().contains(root + QStringLiteral("/late")));
+#endif
+}
+
 QTEST_MAIN(tst_QFileSystemWatcher)
 #include "tst_qfilesystemwatcher.moc"
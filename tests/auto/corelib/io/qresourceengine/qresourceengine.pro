@@ -8,18 +8,21 @@ RESOURCES += testqrc/test.qrc
 runtime_resource.target = runtime_resource.rcc
 runtime_resource.depends = $$PWD/testqrc/test.qrc
 runtime_resource.commands = $$QMAKE_RCC -root /runtime_resource/ -binary $${runtime_resource.depends} -o $${runtime_resource.target}
-QMAKE_EXTRA_TARGETS = runtime_resource
-PRE_TARGETDEPS += $${runtime_resource.target}
+aligned_resource.target = aligned_resource.rcc
+aligned_resource.depends = $$PWD/testqrc/test.qrc
+aligned_resource.commands = $$QMAKE_RCC -root /aligned_resource/ -binary -no-compress -align 4096 $${aligned_resource.depends} -o $${aligned_resource.target}
+QMAKE_EXTRA_TARGETS = runtime_resource aligned_resource
+PRE_TARGETDEPS += $${runtime_resource.target} $${aligned_resource.target}
 
 TESTDATA += \
     parentdir.txt \
     testqrc/*
 
-# Special case needed for runtime_resource.rcc installation,
+# Special case needed for the .rcc files installation,
 # since it does not exist at qmake runtime.
 load(testcase)  # to get value of target.path
 runtime_resource_install.CONFIG = no_check_exist
-runtime_resource_install.files = $$OUT_PWD/$${runtime_resource.target}
+runtime_resource_install.files = $$OUT_PWD/$${runtime_resource.target} $$OUT_PWD/$${aligned_resource.target}
 runtime_resource_install.path = $${target.path}
 INSTALLS += runtime_resource_install
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
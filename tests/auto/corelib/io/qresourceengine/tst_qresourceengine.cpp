@@ -59,6 +59,8 @@ private slots:
     void searchPath();
     void doubleSlashInRoot();
     void setLocale();
+    void compressedResource();
+    void alignedPayload();
 };
 
 
@@ -457,6 +459,56 @@ void tst_QResourceEngine::setLocale()
     QLocale::setDefault(QLocale::system());
 }
 
+void tst_QResourceEngine::compressedResource()
+{
+    QFile source(QFINDTESTDATA("testqrc/aliasdir/compressme.txt"));
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    const QByteArray contents = source.readAll();
+
+    // the de_CH variant of the file is compressed
+    QLocale::setDefault(QLocale("de_CH"));
+    QFile file(":/aliasdir/aliasdir.txt");
+    QVERIFY(QResource(file.fileName()).isCompressed());
+
+    // opening it again is served from the cache of uncompressed data
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), qint64(contents.size()));
+
+        uchar *address = file.map(0, file.size());
+        QVERIFY(address);
+        QCOMPARE(QByteArray(reinterpret_cast<char *>(address), file.size()), contents);
+        QVERIFY(file.unmap(address));
+        QCOMPARE(file.readAll(), contents);
+        file.close();
+    }
+
+    QLocale::setDefault(QLocale::system());
+}
+
+void tst_QResourceEngine::alignedPayload()
+{
+    const QString rcc = QFINDTESTDATA("aligned_resource.rcc");
+    QVERIFY(QResource::registerResource(rcc));
+
+    const QStringList files = QStringList() << "search_file.txt" << "test/testdir.txt"
+                                            << "test/abc/123/+++/currentdir.txt";
+    foreach (const QString &name, files) {
+        QFile file(":/aligned_resource/" + name);
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(name));
+
+        uchar *address = file.map(0, file.size());
+        QVERIFY(address);
+#if defined(Q_OS_UNIX) && !defined(Q_OS_NACL) && !defined(Q_OS_INTEGRITY)
+        // the .rcc file is memory mapped, so the file alignment is kept
+        QCOMPARE(quintptr(address) % 4096, quintptr(0));
+#endif
+        QCOMPARE(QByteArray(reinterpret_cast<char *>(address), file.size()), file.readAll());
+    }
+
+    QVERIFY(QResource::unregisterResource(rcc));
+}
+
 QTEST_MAIN(tst_QResourceEngine)
 
 #include "tst_qresourceengine.moc"
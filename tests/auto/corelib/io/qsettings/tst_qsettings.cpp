@@ -141,6 +141,9 @@ private slots:
     void rainersSyncBugOnMac_data();
     void rainersSyncBugOnMac();
     void recursionBug();
+#ifdef QT_BUILD_INTERNAL
+    void indexedFormat();
+#endif
 
     void testByteArray_data();
     void testByteArray();
@@ -252,6 +255,7 @@ static void populateWithFormats()
 
     QTest::newRow("native") << QSettings::NativeFormat;
     QTest::newRow("ini") << QSettings::IniFormat;
+    QTest::newRow("indexed") << QSettings::IndexedFormat;
     QTest::newRow("custom1") << QSettings::CustomFormat1;
     QTest::newRow("custom2") << QSettings::CustomFormat2;
 }
@@ -2570,6 +2574,7 @@ void tst_QSettings::testCaseSensitivity()
 #endif
             break;
         case QSettings::IniFormat:
+        case QSettings::IndexedFormat:
             cs = false;
             break;
         case QSettings::CustomFormat1:
@@ -3177,6 +3182,71 @@ void tst_QSettings::recursionBug()
     }
 }
 
+#ifdef QT_BUILD_INTERNAL
+void tst_QSettings::indexedFormat()
+{
+    const QString fileName = settingsPath("indexed.qsi");
+
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        for (int i = 0; i < 1000; ++i)
+            settings.setValue(QString("group%1/key%2").arg(i % 10).arg(i), i);
+        settings.setValue("point", QPoint(1, 2));
+    }
+    const qint64 compactedSize = QFileInfo(fileName).size();
+    QVERIFY(compactedSize > 0);
+
+    // small changes are appended to the file instead of rewriting it
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.value("group3/key3").toInt(), 3);
+        settings.setValue("group3/key3", "changed");
+        settings.remove("group4");
+    }
+    const qint64 journaledSize = QFileInfo(fileName).size();
+    QVERIFY(journaledSize > compactedSize);
+    QVERIFY(journaledSize < 2 * compactedSize);
+
+    QConfFile::clearCache();
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("group3/key3").toString(), QString("changed"));
+        QCOMPARE(settings.value("group5/key5").toInt(), 5);
+        QCOMPARE(settings.value("point"), QVariant(QPoint(1, 2)));
+        QVERIFY(!settings.contains("group4/key4"));
+        QCOMPARE(settings.childGroups().size(), 9);
+        settings.beginGroup("group5");
+        QCOMPARE(settings.childKeys().size(), 100);
+        settings.endGroup();
+        QCOMPARE(settings.allKeys().size(), 901);
+
+        // once the journal gets too large, the file is compacted
+        for (int i = 0; i < 20; ++i) {
+            settings.setValue("big", QByteArray(8192, char('a' + i)));
+            settings.sync();
+        }
+    }
+    QVERIFY(QFileInfo(fileName).size() < compactedSize + 10 * 8192);
+
+    QConfFile::clearCache();
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.value("big").toByteArray(), QByteArray(8192, 't'));
+        QCOMPARE(settings.value("group3/key3").toString(), QString("changed"));
+        QCOMPARE(settings.allKeys().size(), 902);
+        settings.clear();
+    }
+
+    QConfFile::clearCache();
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QVERIFY(settings.allKeys().isEmpty());
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+}
+#endif
+
 #if defined(Q_OS_WIN)
 
 static DWORD readKeyType(HKEY handle, const QString &rSubKey)
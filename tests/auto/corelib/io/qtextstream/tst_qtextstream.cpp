@@ -89,6 +89,10 @@ private slots:
     void readLineMaxlen_data();
     void readLineMaxlen();
     void readLinesFromBufferCRCR();
+    void readLineInto_data();
+    void readLineInto();
+    void readLineIntoNull();
+    void readLineAcrossBufferBoundaries();
 
     // all
     void readAllFromDevice_data();
@@ -587,6 +591,88 @@ void tst_QTextStream::readLinesFromBufferCRCR()
     }
 }
 
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineInto_data()
+{
+    generateLineData(false);
+}
+
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineInto()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, lines);
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QTextStream stream(&buffer);
+    QStringList list;
+    QString line;
+    while (stream.readLineInto(&line))
+        list << line;
+
+    QCOMPARE(list, lines);
+    QVERIFY(line.isEmpty());
+    QVERIFY(!stream.readLineInto(&line));
+}
+
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineIntoNull()
+{
+    QString data = QLatin1String("first\nsecond\nthird");
+    QTextStream stream(&data, QIODevice::ReadOnly);
+
+    QVERIFY(stream.readLineInto(0));
+    QString line;
+    QVERIFY(stream.readLineInto(&line));
+    QCOMPARE(line, QString("second"));
+    QVERIFY(stream.readLineInto(0));
+    QVERIFY(!stream.readLineInto(0));
+
+    QTextStream noDevice;
+    QTest::ignoreMessage(QtWarningMsg, "QTextStream: No device");
+    QVERIFY(!noDevice.readLineInto(&line));
+    QVERIFY(line.isEmpty());
+}
+
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineAcrossBufferBoundaries()
+{
+    // lines of every length around the size of the read buffer, so that
+    // line feeds and "\r\n" pairs end up split at every kind of boundary
+    QByteArray data;
+    QStringList lines;
+    for (int length = 16370; length < 16400; ++length) {
+        QByteArray line(length, 'a' + length % 26);
+        lines << QString::fromLatin1(line);
+        data += line;
+        data += (length % 2) ? "\r\n" : "\n";
+    }
+    for (int length = 0; length < 20; ++length) {
+        QByteArray line(length, 'x');
+        lines << QString::fromLatin1(line);
+        data += line;
+        data += "\r\n";
+    }
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QTextStream stream(&buffer);
+    QStringList list;
+    QString line;
+    while (stream.readLineInto(&line))
+        list << line;
+    QCOMPARE(list, lines);
+
+    QVERIFY(buffer.reset());
+    stream.setDevice(&buffer);
+    list.clear();
+    while (!stream.atEnd())
+        list << stream.readLine();
+    QCOMPARE(list, lines);
+}
+
 // ------------------------------------------------------------------------------
 void tst_QTextStream::readLineFromString_data()
 {
@@ -199,10 +199,13 @@ void tst_QMimeDatabase::mimeTypeForFileName_data()
     QTest::newRow("desktop file") << "foo.desktop" << "application/x-desktop";
     QTest::newRow("old kdelnk file is x-desktop too") << "foo.kdelnk" << "application/x-desktop";
     QTest::newRow("double-extension file") << "foo.tar.bz2" << "application/x-bzip-compressed-tar";
+    QTest::newRow("double-extension file, upper case") << "FOO.TAR.BZ2" << "application/x-bzip-compressed-tar";
+    QTest::newRow("double-extension file, more dots") << "foo.1.2.tar.bz2" << "application/x-bzip-compressed-tar";
     QTest::newRow("single-extension file") << "foo.bz2" << "application/x-bzip";
     QTest::newRow(".doc should assume msword") << "somefile.doc" << "application/msword"; // #204139
     QTest::newRow("glob that uses [] syntax, 1") << "Makefile" << "text/x-makefile";
     QTest::newRow("glob that uses [] syntax, 2") << "makefile" << "text/x-makefile";
+    QTest::newRow("glob that uses [] syntax, 3") << "foo.anim7" << "video/x-anim";
     QTest::newRow("glob that ends with *, no extension") << "README" << "text/x-readme";
     QTest::newRow("glob that ends with *, extension") << "README.foo" << "text/x-readme";
     QTest::newRow("glob that ends with *, also matches *.txt. Higher weight wins.") << "README.txt" << "text/plain";
@@ -473,6 +476,13 @@ void tst_QMimeDatabase::mimeTypeForData_data()
     QTest::newRow("PDF magic") << QByteArray("%PDF-") << "application/pdf";
     QTest::newRow("PHP, High-priority rule") << QByteArray("<?php") << "application/x-php";
     QTest::newRow("unknown") << QByteArray("\001abc?}") << "application/octet-stream";
+
+    // all of these start with the same string rule, the sub-rules and the
+    // masked rules decide
+    const QByteArray elfHeader("\177ELF\001\001\001\000\000\000\000\000\000\000\000\000", 16);
+    QTest::newRow("ELF executable") << elfHeader + QByteArray("\002\000\003\000", 4) << "application/x-executable";
+    QTest::newRow("ELF shared library") << elfHeader + QByteArray("\003\000\003\000", 4) << "application/x-sharedlib";
+    QTest::newRow("ELF core dump") << elfHeader + QByteArray("\004\000\003\000", 4) << "application/x-core";
 }
 
 void tst_QMimeDatabase::mimeTypeForData()
@@ -54,6 +54,7 @@ class tst_QFreeList : public QObject
 private slots:
     void basicTest();
     void customized();
+    void bulkTest();
     void threadedTest();
 };
 
@@ -125,6 +126,37 @@ void tst_QFreeList::customized()
     customFreeList.release(next);
 }
 
+void tst_QFreeList::bulkTest()
+{
+    QFreeList<int> intFreeList;
+    int ids[100];
+    intFreeList.next(ids, 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(ids[i], i);
+        intFreeList[ids[i]] = i;
+    }
+
+    // release every other id in one go, they come back in the same order
+    int odd[50];
+    for (int i = 0; i < 50; ++i)
+        odd[i] = 2 * i + 1;
+    intFreeList.release(odd, 50);
+    int again[50];
+    intFreeList.next(again, 50);
+    for (int i = 0; i < 50; ++i) {
+        QCOMPARE(again[i], odd[i]);
+        QCOMPARE(intFreeList.at(again[i]), odd[i]);
+    }
+
+    // bulk and single operations mix
+    intFreeList.release(again, 50);
+    QCOMPARE(intFreeList.next(), 1);
+    intFreeList.release(1);
+    intFreeList.next(again, 50);
+    QCOMPARE(again[0], 1);
+    QCOMPARE(intFreeList.next(), 100);
+}
+
 enum { TimeLimit = 3000 };
 
 class FreeListThread : public QThread
@@ -0,0 +1,346 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QFreeListPool>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QVector>
+#include <QtCore/QSet>
+#include <QtTest/QtTest>
+
+class tst_QFreeListPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createAndDestroy();
+    void reuse();
+    void alignment();
+    void owns();
+    void bulkDestroy();
+    void manyObjects();
+    void crossThread();
+    void classAllocator();
+};
+
+struct Counted
+{
+    Counted() : value(42) { ++alive; }
+    ~Counted() { --alive; }
+    int value;
+    static int alive;
+};
+int Counted::alive = 0;
+
+struct Q_DECL_ALIGN(64) Aligned
+{
+    char data[24];
+};
+
+void tst_QFreeListPool::createAndDestroy()
+{
+    QFreeListPool<Counted> pool;
+    Counted *c = pool.create();
+    QVERIFY(c);
+    QCOMPARE(c->value, 42);
+    QCOMPARE(Counted::alive, 1);
+    pool.destroy(c);
+    QCOMPARE(Counted::alive, 0);
+
+    // destroying a null pointer is a no-op
+    pool.destroy(static_cast<Counted *>(0));
+}
+
+void tst_QFreeListPool::reuse()
+{
+    QFreeListPool<Counted> pool;
+    Counted *c = pool.allocate();
+    pool.deallocate(c);
+    // the slot is handed out again from the calling thread's cache
+    QCOMPARE(pool.allocate(), c);
+    pool.deallocate(c);
+}
+
+void tst_QFreeListPool::alignment()
+{
+    QFreeListPool<Aligned> pool;
+    QVector<Aligned *> objects;
+    for (int i = 0; i < 1000; ++i) {
+        Aligned *a = pool.allocate();
+        QCOMPARE(quintptr(a) % Q_ALIGNOF(Aligned), quintptr(0));
+        objects << a;
+    }
+    pool.deallocate(objects.constData(), objects.size());
+}
+
+void tst_QFreeListPool::owns()
+{
+    QFreeListPool<Counted> pool;
+    QFreeListPool<Counted> other;
+    Counted *c = pool.create();
+    Counted onStack;
+    QVERIFY(pool.owns(c));
+    QVERIFY(!other.owns(c));
+    QVERIFY(!pool.owns(&onStack));
+    QVERIFY(!pool.owns(0));
+    pool.destroy(c);
+}
+
+void tst_QFreeListPool::bulkDestroy()
+{
+    QFreeListPool<Counted> pool;
+    QVector<Counted *> objects;
+    for (int i = 0; i < 200; ++i)
+        objects << pool.create();
+    QCOMPARE(Counted::alive, 200);
+    QCOMPARE(objects.toList().toSet().size(), 200);
+
+    pool.destroy(objects.constData(), objects.size());
+    QCOMPARE(Counted::alive, 0);
+
+    // all slots are available again and nothing is handed out twice
+    QVector<Counted *> again;
+    for (int i = 0; i < 200; ++i)
+        again << pool.allocate();
+    QCOMPARE(again.toList().toSet().size(), 200);
+    pool.deallocate(again.constData(), again.size());
+}
+
+void tst_QFreeListPool::manyObjects()
+{
+    // enough objects to need more than the first few blocks
+    QFreeListPool<Counted> pool;
+    QVector<Counted *> objects;
+    objects.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        Counted *c = pool.create();
+        c->value = i;
+        objects << c;
+    }
+    for (int i = 0; i < objects.size(); ++i) {
+        QVERIFY(pool.owns(objects.at(i)));
+        QCOMPARE(objects.at(i)->value, i);
+    }
+    for (int i = 0; i < objects.size(); i += 2)
+        pool.destroy(objects.at(i));
+    for (int i = 1; i < objects.size(); i += 2)
+        pool.destroy(objects.at(i));
+    QCOMPARE(Counted::alive, 0);
+}
+
+enum { ObjectCount = 200000, BatchSize = 100 };
+
+class Queue
+{
+public:
+    void put(const QVector<Counted *> &batch)
+    {
+        QMutexLocker locker(&mutex);
+        batches.append(batch);
+        waitCondition.wakeOne();
+    }
+    QVector<Counted *> take()
+    {
+        QMutexLocker locker(&mutex);
+        while (batches.isEmpty())
+            waitCondition.wait(&mutex);
+        return batches.takeFirst();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition waitCondition;
+    QList<QVector<Counted *> > batches;
+};
+
+class Producer : public QThread
+{
+public:
+    Producer(QFreeListPool<Counted> *pool, Queue *queue, int id)
+        : pool(pool), queue(queue), id(id) { }
+
+    void run()
+    {
+        QVector<Counted *> batch;
+        for (int i = 0; i < ObjectCount; ++i) {
+            Counted *c = pool->allocate();
+            c->value = id;
+            batch << c;
+            if (batch.size() == BatchSize) {
+                queue->put(batch);
+                batch.clear();
+            }
+        }
+        queue->put(QVector<Counted *>());
+    }
+
+    QFreeListPool<Counted> *pool;
+    Queue *queue;
+    int id;
+};
+
+class Consumer : public QThread
+{
+public:
+    Consumer(QFreeListPool<Counted> *pool, Queue *queue, int producerCount)
+        : pool(pool), queue(queue), producerCount(producerCount), errors(0) { }
+
+    void run()
+    {
+        int finished = 0;
+        int batches = 0;
+        while (finished < producerCount) {
+            const QVector<Counted *> batch = queue->take();
+            if (batch.isEmpty()) {
+                ++finished;
+                continue;
+            }
+            for (int i = 0; i < batch.size(); ++i) {
+                if (batch.at(i)->value < 0 || batch.at(i)->value >= producerCount)
+                    ++errors;
+                batch.at(i)->value = -1;
+            }
+            // alternate between single and bulk returns
+            if (++batches % 2) {
+                pool->deallocate(batch.constData(), batch.size());
+            } else {
+                for (int i = 0; i < batch.size(); ++i)
+                    pool->deallocate(batch.at(i));
+            }
+        }
+    }
+
+    QFreeListPool<Counted> *pool;
+    Queue *queue;
+    int producerCount;
+    int errors;
+};
+
+void tst_QFreeListPool::crossThread()
+{
+    // objects allocated in one thread and returned in another must never
+    // be handed out twice
+    const int ProducerCount = 3;
+    QFreeListPool<Counted> pool;
+    Queue queue;
+    Consumer consumer(&pool, &queue, ProducerCount);
+    QList<Producer *> producers;
+    for (int i = 0; i < ProducerCount; ++i)
+        producers << new Producer(&pool, &queue, i);
+
+    consumer.start();
+    foreach (Producer *producer, producers)
+        producer->start();
+    foreach (Producer *producer, producers)
+        QVERIFY(producer->wait(60000));
+    QVERIFY(consumer.wait(60000));
+    qDeleteAll(producers);
+
+    QCOMPARE(consumer.errors, 0);
+}
+
+// the class-specific operator new and delete from the documentation
+class PooledEvent : public QEvent
+{
+public:
+    PooledEvent(int value) : QEvent(QEvent::User), value(value) { }
+
+    static void *operator new(size_t size)
+    {
+        return size == sizeof(PooledEvent) ? pool()->allocate() : ::operator new(size);
+    }
+    static void operator delete(void *ptr, size_t size)
+    {
+        if (size == sizeof(PooledEvent))
+            pool()->deallocate(static_cast<PooledEvent *>(ptr));
+        else
+            ::operator delete(ptr);
+    }
+
+    static QFreeListPool<PooledEvent> *pool()
+    {
+        // never destroyed, events may still be posted at exit
+        static QFreeListPool<PooledEvent> *pool = new QFreeListPool<PooledEvent>;
+        return pool;
+    }
+
+    int value;
+};
+
+class LargerPooledEvent : public PooledEvent
+{
+public:
+    LargerPooledEvent(int value) : PooledEvent(value), extra(0) { }
+    qint64 extra;
+};
+
+class EventReceiver : public QObject
+{
+public:
+    EventReceiver() : sum(0) { }
+    bool event(QEvent *e)
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+        sum += static_cast<PooledEvent *>(e)->value;
+        return true;
+    }
+    int sum;
+};
+
+void tst_QFreeListPool::classAllocator()
+{
+    EventReceiver receiver;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            PooledEvent *e = i % 10 ? new PooledEvent(1) : new LargerPooledEvent(1);
+            QCOMPARE(PooledEvent::pool()->owns(e), bool(i % 10));
+            QCoreApplication::postEvent(&receiver, e);
+        }
+        QCOMPARE(receiver.sum, round * 1000);
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::User);
+        QCOMPARE(receiver.sum, (round + 1) * 1000);
+    }
+}
+
+QTEST_MAIN(tst_QFreeListPool)
+#include "tst_qfreelistpool.moc"
@@ -53,6 +53,9 @@
 
 #include <qlocale.h>
 #include <qnumeric.h>
+#ifdef QT_BUILD_INTERNAL
+#include <private/qlocale_tools_p.h>
+#endif
 
 #if defined(Q_OS_LINUX) && !defined(__UCLIBC__)
 #    define QT_USE_FENV
@@ -108,6 +111,12 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void shortestDouble_data();
+    void shortestDouble();
+    void shortestDoubleRoundTrip();
+#ifdef QT_BUILD_INTERNAL
+    void fastDoubleConversion();
+#endif
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -911,6 +920,121 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+void tst_QLocale::shortestDouble_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0.1 g")          << 0.1 << 'g' << QString("0.1");
+    QTest::newRow("1/3 g")          << 1.0 / 3 << 'g' << QString("0.3333333333333333");
+    QTest::newRow("0.1+0.2 g")      << 0.1 + 0.2 << 'g' << QString("0.30000000000000004");
+    QTest::newRow("123456 g")       << 123456.0 << 'g' << QString("123456");
+    QTest::newRow("1e21 g")         << 1e21 << 'g' << QString("1e+21");
+    QTest::newRow("0.000123 g")     << 0.000123 << 'g' << QString("0.000123");
+    QTest::newRow("0.0000123 g")    << 0.0000123 << 'g' << QString("1.23e-05");
+    QTest::newRow("min denormal g") << 4.9406564584124654e-324 << 'g' << QString("5e-324");
+    QTest::newRow("max g")          << 1.7976931348623157e308 << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("-2.5 g")         << -2.5 << 'g' << QString("-2.5");
+    QTest::newRow("0 g")            << 0.0 << 'g' << QString("0");
+    QTest::newRow("0.1 e")          << 0.1 << 'e' << QString("1e-01");
+    QTest::newRow("1234.5 e")       << 1234.5 << 'e' << QString("1.2345e+03");
+    QTest::newRow("0.1 f")          << 0.1 << 'f' << QString("0.1");
+    QTest::newRow("1e21 f")         << 1e21 << 'f' << QString("1000000000000000000000");
+    QTest::newRow("1234.5 f")       << 1234.5 << 'f' << QString("1234.5");
+}
+
+void tst_QLocale::shortestDouble()
+{
+    QFETCH(double, num);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    QCOMPARE(QString::number(num, format, QLocale::FloatingPointShortest), expected);
+    QLocale c(QLocale::C);
+    c.setNumberOptions(QLocale::OmitGroupSeparator);
+    QCOMPARE(c.toString(num, format, QLocale::FloatingPointShortest), expected);
+    QCOMPARE(QByteArray::number(num, format, QLocale::FloatingPointShortest), expected.toLatin1());
+}
+
+void tst_QLocale::shortestDoubleRoundTrip()
+{
+    // a deterministic pseudo-random walk over all bit patterns
+    quint64 state = Q_UINT64_C(88172645463325252);
+    for (int i = 0; i < 20000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (!qIsFinite(d))
+            continue;
+
+        const QString s = QString::number(d, 'g', QLocale::FloatingPointShortest);
+        bool ok;
+        QCOMPARE(s.toDouble(&ok), d);
+        QVERIFY(ok);
+        QCOMPARE(s.toLatin1().toDouble(&ok), d);
+        QVERIFY(ok);
+        // never longer than the 17 digits that always round-trip
+        QVERIFY(s.length() <= QString::number(d, 'g', 17).length());
+    }
+}
+
+#ifdef QT_BUILD_INTERNAL
+void tst_QLocale::fastDoubleConversion()
+{
+    // the fast paths must produce exactly what qdtoa and qstrtod produce
+    quint64 state = Q_UINT64_C(2463534242);
+    for (int i = 0; i < 20000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        if (i % 2) {
+            memcpy(&d, &state, sizeof(d));
+            if (!qIsFinite(d))
+                continue;
+        } else {
+            d = double(state % 100000000) / double(1 + (state >> 40) % 10000);
+        }
+
+        const int precision = i % 18;
+        const struct { QLocalePrivate::DoubleForm form; int mode; int ndigits; } cases[] = {
+            { QLocalePrivate::DFSignificantDigits, 0, 0 },
+            { QLocalePrivate::DFSignificantDigits, 2, precision },
+            { QLocalePrivate::DFExponent, 2, precision % 17 + 1 },
+            { QLocalePrivate::DFDecimal, 3, precision % 10 }
+        };
+        for (int c = 0; c < int(sizeof(cases) / sizeof(cases[0])); ++c) {
+            if (cases[c].form == QLocalePrivate::DFDecimal && (qAbs(d) > 1e20 || qAbs(d) < 1e-20))
+                continue;
+            int fastPrecision = cases[c].mode == 0 ? int(QLocale::FloatingPointShortest)
+                                                   : cases[c].form == QLocalePrivate::DFExponent
+                                                     ? cases[c].ndigits - 1 : cases[c].ndigits;
+            char buf[1200];
+            bool sign;
+            int length, decpt;
+            qt_doubleToAscii(d, cases[c].form, fastPrecision, buf, sizeof(buf), sign, length, decpt);
+
+            int refDecpt, refSign;
+            char *rve = 0, *resultBuffer = 0;
+            const QByteArray ref = qdtoa(d, cases[c].mode, cases[c].ndigits, &refDecpt, &refSign, &rve, &resultBuffer);
+            free(resultBuffer);
+
+            QCOMPARE(QByteArray(buf, length), ref);
+            if (ref != "0")
+                QCOMPARE(decpt, refDecpt);
+        }
+
+        const QByteArray text = QByteArray::number(d, 'g', 17);
+        bool ok;
+        QCOMPARE(qt_asciiToDouble(text.constData(), text.size(), &ok), d);
+        QVERIFY(ok);
+    }
+}
+#endif
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
@@ -16,6 +16,7 @@ SUBDIRS=\
     qelapsedtimer \
     qexplicitlyshareddatapointer \
     qfreelist \
+    qfreelistpool \
     qhash \
     qline \
     qlist \
@@ -10,10 +10,14 @@ SUBDIRS=\
    qnetworkcachemetadata \
    qftp \
    qhttpnetworkreply \
+   qhpack \
+   http2 \
    qabstractnetworkcache \
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
           qhttpnetworkconnection \
           qhttpnetworkreply \
+          qhpack \
+          http2 \
           qftp \
 
@@ -0,0 +1,7 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_http2
+SOURCES  += tst_http2.cpp
+requires(contains(QT_CONFIG,private_tests))
+
+QT = core-private network-private testlib
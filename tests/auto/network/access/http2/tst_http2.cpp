@@ -0,0 +1,627 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include "private/qhpack_p.h"
+#include "private/qhttp2protocolhandler_p.h"
+
+typedef QHttp2ProtocolHandler H2;
+
+static const char connectionPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+static quint32 readUInt32(const char *data)
+{
+    return qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(data));
+}
+
+static void appendUInt32(QByteArray *out, quint32 value)
+{
+    uchar buffer[4];
+    qToBigEndian<quint32>(value, buffer);
+    out->append(reinterpret_cast<const char *>(buffer), 4);
+}
+
+static void appendSetting(QByteArray *out, quint16 id, quint32 value)
+{
+    uchar buffer[2];
+    qToBigEndian<quint16>(id, buffer);
+    out->append(reinterpret_cast<const char *>(buffer), 2);
+    appendUInt32(out, value);
+}
+
+// A minimal cleartext HTTP/2 server (prior knowledge) that serves
+// resources from memory, stores uploads, and can be told to misbehave.
+//   /reset        is answered with RST_STREAM (INTERNAL_ERROR)
+//   /refuse-once  is refused with RST_STREAM (REFUSED_STREAM) the first time
+//   /hang         is never answered
+class Http2Server : public QTcpServer
+{
+    Q_OBJECT
+public:
+    Http2Server()
+        : initialWindowSize(H2::DefaultWindowSize), maxConcurrentStreams(100),
+          holdResponses(0), goAwayWhenHeld(false),
+          connectionCount(0), maxWaitingRequests(0), settingsAcks(0), clientDisabledPush(false),
+          clientInitialWindowSize(H2::DefaultWindowSize), windowStalls(0), refused(0)
+    {
+        listen(QHostAddress::LocalHost);
+        connect(this, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+    }
+
+    ~Http2Server()
+    {
+        qDeleteAll(connections);
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QLatin1String("http://127.0.0.1:") + QString::number(serverPort()) + path);
+    }
+
+    // configuration
+    QHash<QByteArray, QByteArray> resources;
+    quint32 initialWindowSize; // our SETTINGS_INITIAL_WINDOW_SIZE, limits the uploads
+    quint32 maxConcurrentStreams;
+    int holdResponses; // don't answer before this many requests are waiting
+    bool goAwayWhenHeld; // then answer only the first, send GOAWAY and close
+
+    // what has been seen
+    int connectionCount;
+    int maxWaitingRequests;
+    int settingsAcks;
+    bool clientDisabledPush;
+    quint32 clientInitialWindowSize;
+    int windowStalls; // times a response had to wait for a WINDOW_UPDATE
+    int refused;
+    QList<quint32> resetCodes; // RST_STREAM error codes sent by the client
+    QHash<QByteArray, QByteArray> uploads;
+
+private slots:
+    void acceptConnection()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            ++connectionCount;
+            Connection *c = new Connection;
+            c->socket = socket;
+            connections.insert(socket, c);
+            connect(socket, SIGNAL(readyRead()), this, SLOT(readFrames()));
+            connect(socket, SIGNAL(disconnected()), this, SLOT(connectionClosed()));
+
+            // the server preface
+            QByteArray settings;
+            appendSetting(&settings, H2::MaxConcurrentStreamsSetting, maxConcurrentStreams);
+            appendSetting(&settings, H2::InitialWindowSizeSetting, initialWindowSize);
+            writeFrame(c, H2::SettingsFrame, H2::NoFlags, 0, settings);
+        }
+    }
+
+    void connectionClosed()
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        delete connections.take(socket);
+        socket->deleteLater();
+    }
+
+    void readFrames()
+    {
+        Connection *c = connections.value(qobject_cast<QTcpSocket *>(sender()));
+        if (!c)
+            return;
+        c->buffer += c->socket->readAll();
+
+        if (!c->prefaceReceived) {
+            const int prefaceSize = sizeof(connectionPreface) - 1;
+            if (c->buffer.size() < prefaceSize)
+                return;
+            if (!c->buffer.startsWith(connectionPreface)) {
+                c->socket->abort();
+                return;
+            }
+            c->buffer.remove(0, prefaceSize);
+            c->prefaceReceived = true;
+        }
+
+        while (c->buffer.size() >= H2::FrameHeaderSize) {
+            const char *header = c->buffer.constData();
+            const int length = (uchar(header[0]) << 16) | (uchar(header[1]) << 8) | uchar(header[2]);
+            if (c->buffer.size() < H2::FrameHeaderSize + length)
+                break;
+            const quint8 type = header[3];
+            const quint8 flags = header[4];
+            const quint32 streamId = readUInt32(header + 5) & H2::MaxStreamId;
+            const QByteArray payload = c->buffer.mid(H2::FrameHeaderSize, length);
+            c->buffer.remove(0, H2::FrameHeaderSize + length);
+            handleFrame(c, type, flags, streamId, payload);
+        }
+
+        answerRequests(c);
+        sendData(c);
+    }
+
+private:
+    struct Stream
+    {
+        Stream() : id(0), sendWindow(0), sent(0), complete(false), answered(false) {}
+        quint32 id;
+        QByteArray method;
+        QByteArray path;
+        QByteArray body;
+        QByteArray response;
+        qint64 sendWindow;
+        int sent;
+        bool complete; // the whole request has been received
+        bool answered;
+    };
+
+    struct Connection
+    {
+        Connection() : socket(0), prefaceReceived(false), sendWindow(H2::DefaultWindowSize),
+            peerInitialWindow(H2::DefaultWindowSize), headerStream(0), headerEndStream(false),
+            closeWhenDone(false) {}
+        QTcpSocket *socket;
+        QByteArray buffer;
+        bool prefaceReceived;
+        QHPackEncoder encoder;
+        QHPackDecoder decoder;
+        QMap<quint32, Stream> streams;
+        qint64 sendWindow;
+        qint64 peerInitialWindow;
+        quint32 headerStream;
+        bool headerEndStream;
+        QByteArray headerBlock;
+        bool closeWhenDone;
+    };
+
+    void writeFrame(Connection *c, quint8 type, quint8 flags, quint32 streamId, const QByteArray &payload)
+    {
+        char header[H2::FrameHeaderSize];
+        header[0] = char(payload.size() >> 16);
+        header[1] = char(payload.size() >> 8);
+        header[2] = char(payload.size());
+        header[3] = char(type);
+        header[4] = char(flags);
+        qToBigEndian<quint32>(streamId, reinterpret_cast<uchar *>(header + 5));
+        c->socket->write(header, H2::FrameHeaderSize);
+        c->socket->write(payload);
+    }
+
+    void writeRstStream(Connection *c, quint32 streamId, quint32 errorCode)
+    {
+        QByteArray payload;
+        appendUInt32(&payload, errorCode);
+        writeFrame(c, H2::RstStreamFrame, H2::NoFlags, streamId, payload);
+    }
+
+    void writeHeaders(Connection *c, quint32 streamId, int statusCode, int contentLength)
+    {
+        QHPackHeaderList headers;
+        headers << qMakePair(QByteArray(":status"), QByteArray::number(statusCode))
+                << qMakePair(QByteArray("content-length"), QByteArray::number(contentLength));
+        QByteArray block;
+        c->encoder.encode(headers, &block);
+        writeFrame(c, H2::HeadersFrame, H2::EndHeadersFlag | (contentLength ? 0 : H2::EndStreamFlag),
+                   streamId, block);
+    }
+
+    void handleFrame(Connection *c, quint8 type, quint8 flags, quint32 streamId, const QByteArray &payload)
+    {
+        switch (type) {
+        case H2::SettingsFrame:
+            if (flags & H2::AckFlag) {
+                ++settingsAcks;
+                return;
+            }
+            for (int i = 0; i + 6 <= payload.size(); i += 6) {
+                const quint16 id = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(payload.constData() + i));
+                const quint32 value = readUInt32(payload.constData() + i + 2);
+                if (id == H2::EnablePushSetting) {
+                    clientDisabledPush = value == 0;
+                } else if (id == H2::InitialWindowSizeSetting) {
+                    for (QMap<quint32, Stream>::iterator it = c->streams.begin(); it != c->streams.end(); ++it)
+                        it->sendWindow += qint64(value) - c->peerInitialWindow;
+                    c->peerInitialWindow = value;
+                    clientInitialWindowSize = value;
+                }
+            }
+            writeFrame(c, H2::SettingsFrame, H2::AckFlag, 0, QByteArray());
+            return;
+        case H2::WindowUpdateFrame: {
+            const quint32 increment = readUInt32(payload.constData()) & H2::MaxWindowSize;
+            if (streamId == 0)
+                c->sendWindow += increment;
+            else if (c->streams.contains(streamId))
+                c->streams[streamId].sendWindow += increment;
+            return;
+        }
+        case H2::HeadersFrame:
+            c->headerStream = streamId;
+            c->headerEndStream = flags & H2::EndStreamFlag;
+            c->headerBlock = payload;
+            break;
+        case H2::ContinuationFrame:
+            c->headerBlock += payload;
+            break;
+        case H2::DataFrame: {
+            if (!payload.isEmpty()) {
+                // give the window back right away
+                QByteArray increment;
+                appendUInt32(&increment, payload.size());
+                writeFrame(c, H2::WindowUpdateFrame, H2::NoFlags, 0, increment);
+                if (!(flags & H2::EndStreamFlag))
+                    writeFrame(c, H2::WindowUpdateFrame, H2::NoFlags, streamId, increment);
+            }
+            if (!c->streams.contains(streamId))
+                return;
+            Stream &stream = c->streams[streamId];
+            stream.body += payload;
+            if (flags & H2::EndStreamFlag)
+                requestComplete(c, stream);
+            return;
+        }
+        case H2::RstStreamFrame:
+            resetCodes.append(readUInt32(payload.constData()));
+            c->streams.remove(streamId);
+            return;
+        case H2::PingFrame:
+            if (!(flags & H2::AckFlag))
+                writeFrame(c, H2::PingFrame, H2::AckFlag, 0, payload);
+            return;
+        default:
+            return;
+        }
+
+        // a complete header block opens a stream
+        if (!(flags & H2::EndHeadersFlag))
+            return;
+        QHPackHeaderList headers;
+        if (!c->decoder.decode(c->headerBlock.constData(), c->headerBlock.size(), &headers)) {
+            c->socket->abort();
+            return;
+        }
+        Stream stream;
+        stream.id = c->headerStream;
+        stream.sendWindow = c->peerInitialWindow;
+        for (int i = 0; i < headers.size(); ++i) {
+            if (headers.at(i).first == ":method")
+                stream.method = headers.at(i).second;
+            else if (headers.at(i).first == ":path")
+                stream.path = headers.at(i).second;
+        }
+        Stream &inserted = *c->streams.insert(stream.id, stream);
+        if (c->headerEndStream)
+            requestComplete(c, inserted);
+    }
+
+    void requestComplete(Connection *c, Stream &stream)
+    {
+        stream.complete = true;
+        int waiting = 0;
+        foreach (const Stream &s, c->streams) {
+            if (s.complete && !s.answered)
+                ++waiting;
+        }
+        maxWaitingRequests = qMax(maxWaitingRequests, waiting);
+    }
+
+    void answerRequests(Connection *c)
+    {
+        QList<quint32> waiting;
+        for (QMap<quint32, Stream>::const_iterator it = c->streams.constBegin(); it != c->streams.constEnd(); ++it) {
+            if (it->complete && !it->answered)
+                waiting.append(it.key());
+        }
+        if (waiting.isEmpty() || waiting.size() < holdResponses)
+            return;
+        holdResponses = 0;
+
+        if (goAwayWhenHeld) {
+            // only the oldest request is going to be answered on this connection
+            goAwayWhenHeld = false;
+            const quint32 lastStreamId = waiting.first();
+            QByteArray payload;
+            appendUInt32(&payload, lastStreamId);
+            appendUInt32(&payload, H2::NoError);
+            writeFrame(c, H2::GoawayFrame, H2::NoFlags, 0, payload);
+            for (QMap<quint32, Stream>::iterator it = c->streams.begin(); it != c->streams.end(); ) {
+                if (it.key() > lastStreamId)
+                    it = c->streams.erase(it);
+                else
+                    ++it;
+            }
+            waiting = QList<quint32>() << lastStreamId;
+            c->closeWhenDone = true;
+        }
+
+        foreach (quint32 id, waiting) {
+            Stream &stream = c->streams[id];
+            stream.answered = true;
+            if (stream.path == "/hang")
+                continue;
+            if (stream.path == "/reset" || (stream.path == "/refuse-once" && !refused)) {
+                const bool refuse = stream.path == "/refuse-once";
+                refused += refuse;
+                writeRstStream(c, id, refuse ? H2::RefusedStreamError : H2::InternalError);
+                c->streams.remove(id);
+                continue;
+            }
+            if (stream.method == "PUT" || stream.method == "POST") {
+                uploads.insert(stream.path, stream.body);
+                writeHeaders(c, id, 200, 0);
+                c->streams.remove(id);
+                continue;
+            }
+            const bool found = resources.contains(stream.path) || stream.path == "/refuse-once";
+            stream.response = resources.value(stream.path);
+            writeHeaders(c, id, found ? 200 : 404, stream.response.size());
+            if (stream.response.isEmpty())
+                c->streams.remove(id);
+        }
+    }
+
+    void sendData(Connection *c)
+    {
+        for (QMap<quint32, Stream>::iterator it = c->streams.begin(); it != c->streams.end(); ) {
+            Stream &stream = *it;
+            while (stream.answered && stream.sent < stream.response.size()) {
+                const qint64 window = qMin(stream.sendWindow, c->sendWindow);
+                if (window <= 0) {
+                    ++windowStalls;
+                    break;
+                }
+                const int chunk = int(qMin(qMin<qint64>(window, H2::DefaultMaxFrameSize),
+                                           qint64(stream.response.size() - stream.sent)));
+                const bool last = stream.sent + chunk == stream.response.size();
+                writeFrame(c, H2::DataFrame, last ? H2::EndStreamFlag : H2::NoFlags, stream.id,
+                           stream.response.mid(stream.sent, chunk));
+                stream.sent += chunk;
+                stream.sendWindow -= chunk;
+                c->sendWindow -= chunk;
+            }
+            if (stream.answered && !stream.response.isEmpty() && stream.sent == stream.response.size())
+                it = c->streams.erase(it);
+            else
+                ++it;
+        }
+
+        if (c->closeWhenDone && c->streams.isEmpty())
+            c->socket->disconnectFromHost();
+    }
+
+    QHash<QTcpSocket *, Connection *> connections;
+};
+
+class tst_Http2: public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void settings();
+    void concurrentRequests();
+    void largeDownload();
+    void largeUpload();
+    void goAwayWithActiveStreams();
+    void resetStream();
+    void refusedStreamIsRetried();
+    void abortResetsStream();
+};
+
+static QNetworkRequest http2Request(const QUrl &url)
+{
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    return request;
+}
+
+static bool allFinished(const QList<QNetworkReply *> &replies)
+{
+    foreach (QNetworkReply *reply, replies) {
+        if (!reply->isFinished())
+            return false;
+    }
+    return true;
+}
+
+static QByteArray resourceData(int size, char seed)
+{
+    QByteArray data;
+    data.resize(size);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(seed + i * 13 + i / 1000);
+    return data;
+}
+
+void tst_Http2::settings()
+{
+    Http2Server server;
+    server.resources.insert("/small", "hello");
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.get(http2Request(server.url("/small")));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 10000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QByteArray("hello"));
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+
+    // both sides acknowledge each other's SETTINGS
+    QCOMPARE(server.settingsAcks, 1);
+    QVERIFY(server.clientDisabledPush);
+    QCOMPARE(server.clientInitialWindowSize, quint32(H2::StreamReceiveWindow));
+    delete reply;
+}
+
+void tst_Http2::concurrentRequests()
+{
+    const int count = 10;
+    Http2Server server;
+    for (int i = 0; i < count; ++i)
+        server.resources.insert("/resource" + QByteArray::number(i), resourceData(1000 + i, char(i)));
+    // nothing is answered before all requests are there, so they have to be multiplexed
+    server.holdResponses = count;
+    QNetworkAccessManager manager;
+
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i)
+        replies << manager.get(http2Request(server.url("/resource" + QString::number(i))));
+    QTRY_VERIFY_WITH_TIMEOUT(allFinished(replies), 10000);
+
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QVERIFY(replies.at(i)->readAll() == resourceData(1000 + i, char(i)));
+    }
+    QCOMPARE(server.connectionCount, 1);
+    QCOMPARE(server.maxWaitingRequests, count);
+    qDeleteAll(replies);
+}
+
+void tst_Http2::largeDownload()
+{
+    // more than both the default window and the one the client announces
+    const QByteArray data = resourceData(3 * H2::StreamReceiveWindow + 123, 'a');
+    Http2Server server;
+    server.resources.insert("/large", data);
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.get(http2Request(server.url("/large")));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 20000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    const QByteArray received = reply->readAll();
+    QCOMPARE(received.size(), data.size());
+    QVERIFY(received == data);
+    // the server had to wait for WINDOW_UPDATEs from the client
+    QVERIFY(server.windowStalls > 0);
+    delete reply;
+}
+
+void tst_Http2::largeUpload()
+{
+    const QByteArray data = resourceData(1024 * 1024 + 17, 'u');
+    Http2Server server;
+    server.initialWindowSize = H2::DefaultMaxFrameSize;
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.put(http2Request(server.url("/upload")), data);
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 20000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.uploads.value("/upload").size(), data.size());
+    QVERIFY(server.uploads.value("/upload") == data);
+    delete reply;
+}
+
+void tst_Http2::goAwayWithActiveStreams()
+{
+    const int count = 5;
+    Http2Server server;
+    for (int i = 0; i < count; ++i)
+        server.resources.insert("/resource" + QByteArray::number(i), resourceData(100000 + i, char(i)));
+    server.holdResponses = count;
+    server.goAwayWhenHeld = true;
+    QNetworkAccessManager manager;
+
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < count; ++i)
+        replies << manager.get(http2Request(server.url("/resource" + QString::number(i))));
+    QTRY_VERIFY_WITH_TIMEOUT(allFinished(replies), 10000);
+
+    // the streams the server did not process are sent again on a new connection
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QVERIFY(replies.at(i)->readAll() == resourceData(100000 + i, char(i)));
+    }
+    QCOMPARE(server.connectionCount, 2);
+    qDeleteAll(replies);
+}
+
+void tst_Http2::resetStream()
+{
+    Http2Server server;
+    server.resources.insert("/small", "hello");
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.get(http2Request(server.url("/reset")));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 10000);
+    QCOMPARE(reply->error(), QNetworkReply::ProtocolFailure);
+    delete reply;
+
+    // only the stream is gone, the connection is still used
+    reply = manager.get(http2Request(server.url("/small")));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 10000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QByteArray("hello"));
+    QCOMPARE(server.connectionCount, 1);
+    delete reply;
+}
+
+void tst_Http2::refusedStreamIsRetried()
+{
+    Http2Server server;
+    server.resources.insert("/refuse-once", "second time lucky");
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.get(http2Request(server.url("/refuse-once")));
+    QTRY_VERIFY_WITH_TIMEOUT(reply->isFinished(), 10000);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QByteArray("second time lucky"));
+    QCOMPARE(server.refused, 1);
+    delete reply;
+}
+
+void tst_Http2::abortResetsStream()
+{
+    Http2Server server;
+    QNetworkAccessManager manager;
+
+    QNetworkReply *reply = manager.get(http2Request(server.url("/hang")));
+    QTRY_COMPARE_WITH_TIMEOUT(server.maxWaitingRequests, 1, 10000);
+    reply->abort();
+    QCOMPARE(reply->error(), QNetworkReply::OperationCanceledError);
+
+    QTRY_COMPARE_WITH_TIMEOUT(server.resetCodes.size(), 1, 10000);
+    QCOMPARE(server.resetCodes.first(), quint32(H2::CancelError));
+    delete reply;
+}
+
+QTEST_MAIN(tst_Http2)
+#include "tst_http2.moc"
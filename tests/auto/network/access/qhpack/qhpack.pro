@@ -0,0 +1,7 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_qhpack
+SOURCES  += tst_qhpack.cpp
+requires(contains(QT_CONFIG,private_tests))
+
+QT = core-private network-private testlib
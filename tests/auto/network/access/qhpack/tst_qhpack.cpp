@@ -0,0 +1,297 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include "private/qhpack_p.h"
+
+Q_DECLARE_METATYPE(QHPackHeaderList)
+
+class tst_QHPack: public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void huffman_data();
+    void huffman();
+    void huffmanInvalid_data();
+    void huffmanInvalid();
+    void requestSequence_data();
+    void requestSequence();
+    void responseSequence();
+    void sensitiveFields();
+    void tableSizeUpdate();
+    void invalidBlocks_data();
+    void invalidBlocks();
+};
+
+static QHPackHeaderList fields(const char *list)
+{
+    // "name: value\n" lines
+    QHPackHeaderList result;
+    foreach (const QByteArray &line, QByteArray(list).split('\n')) {
+        if (line.isEmpty())
+            continue;
+        int colon = line.indexOf(": ", 1);
+        result << qMakePair(line.left(colon), line.mid(colon + 2));
+    }
+    return result;
+}
+
+void tst_QHPack::huffman_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("encoded");
+
+    // RFC 7541, Appendix C.4 and C.6
+    QTest::newRow("www.example.com") << QByteArray("www.example.com")
+                                     << QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4ff");
+    QTest::newRow("no-cache") << QByteArray("no-cache") << QByteArray::fromHex("a8eb10649cbf");
+    QTest::newRow("custom-key") << QByteArray("custom-key") << QByteArray::fromHex("25a849e95ba97d7f");
+    QTest::newRow("302") << QByteArray("302") << QByteArray::fromHex("6402");
+    QTest::newRow("date") << QByteArray("Mon, 21 Oct 2013 20:13:21 GMT")
+                          << QByteArray::fromHex("d07abe941054d444a8200595040b8166e082a62d1bff");
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+
+    QByteArray all;
+    for (int i = 0; i < 256; ++i)
+        all += char(i);
+    QByteArray encoded;
+    qHuffmanEncode(all, &encoded);
+    QTest::newRow("all-octets") << all << encoded;
+}
+
+void tst_QHPack::huffman()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, encoded);
+
+    QByteArray out;
+    qHuffmanEncode(data, &out);
+    QCOMPARE(out.toHex(), encoded.toHex());
+    QCOMPARE(qHuffmanEncodedSize(data), encoded.size());
+
+    QByteArray decoded;
+    QVERIFY(qHuffmanDecode(encoded.constData(), encoded.size(), &decoded));
+    QCOMPARE(decoded, data);
+}
+
+void tst_QHPack::huffmanInvalid_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+
+    // "0" is 00000, padded with zeros instead of ones
+    QTest::newRow("zero-padding") << QByteArray::fromHex("00");
+    // a whole octet of padding
+    QTest::newRow("long-padding") << QByteArray::fromHex("07ff");
+    // EOS must not appear in the data
+    QTest::newRow("eos") << QByteArray::fromHex("ffffffff");
+}
+
+void tst_QHPack::huffmanInvalid()
+{
+    QFETCH(QByteArray, encoded);
+
+    QByteArray decoded;
+    QVERIFY(!qHuffmanDecode(encoded.constData(), encoded.size(), &decoded));
+}
+
+void tst_QHPack::requestSequence_data()
+{
+    QTest::addColumn<bool>("compressStrings");
+    QTest::addColumn<QByteArray>("block1");
+    QTest::addColumn<QByteArray>("block2");
+    QTest::addColumn<QByteArray>("block3");
+
+    // RFC 7541, Appendix C.3 and C.4
+    QTest::newRow("plain") << false
+        << QByteArray::fromHex("828684410f7777772e6578616d706c652e636f6d")
+        << QByteArray::fromHex("828684be58086e6f2d6361636865")
+        << QByteArray::fromHex("828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565");
+    QTest::newRow("huffman") << true
+        << QByteArray::fromHex("828684418cf1e3c2e5f23a6ba0ab90f4ff")
+        << QByteArray::fromHex("828684be5886a8eb10649cbf")
+        << QByteArray::fromHex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf");
+}
+
+void tst_QHPack::requestSequence()
+{
+    QFETCH(bool, compressStrings);
+    QFETCH(QByteArray, block1);
+    QFETCH(QByteArray, block2);
+    QFETCH(QByteArray, block3);
+
+    const QHPackHeaderList request1 = fields(":method: GET\n:scheme: http\n:path: /\n"
+                                             ":authority: www.example.com\n");
+    const QHPackHeaderList request2 = fields(":method: GET\n:scheme: http\n:path: /\n"
+                                             ":authority: www.example.com\ncache-control: no-cache\n");
+    const QHPackHeaderList request3 = fields(":method: GET\n:scheme: https\n:path: /index.html\n"
+                                             ":authority: www.example.com\ncustom-key: custom-value\n");
+
+    QHPackEncoder encoder;
+    encoder.setCompressStrings(compressStrings);
+    QHPackDecoder decoder;
+
+    QByteArray out;
+    encoder.encode(request1, &out);
+    QCOMPARE(out.toHex(), block1.toHex());
+    out.clear();
+    encoder.encode(request2, &out);
+    QCOMPARE(out.toHex(), block2.toHex());
+    out.clear();
+    encoder.encode(request3, &out);
+    QCOMPARE(out.toHex(), block3.toHex());
+
+    QHPackHeaderList headers;
+    QVERIFY(decoder.decode(block1.constData(), block1.size(), &headers));
+    QCOMPARE(headers, request1);
+    headers.clear();
+    QVERIFY(decoder.decode(block2.constData(), block2.size(), &headers));
+    QCOMPARE(headers, request2);
+    headers.clear();
+    QVERIFY(decoder.decode(block3.constData(), block3.size(), &headers));
+    QCOMPARE(headers, request3);
+}
+
+void tst_QHPack::responseSequence()
+{
+    // RFC 7541, Appendix C.6: a 256 octet table, entries get evicted
+    QHPackDecoder decoder(256);
+
+    const QByteArray block1 = QByteArray::fromHex(
+        "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+        "6e919d29ad171863c78f0b97c8e9ae82ae43d3");
+    const QByteArray block2 = QByteArray::fromHex("4883640effc1c0bf");
+    const QByteArray block3 = QByteArray::fromHex(
+        "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960"
+        "d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007");
+
+    QHPackHeaderList headers;
+    QVERIFY(decoder.decode(block1.constData(), block1.size(), &headers));
+    QCOMPARE(headers, fields(":status: 302\ncache-control: private\n"
+                             "date: Mon, 21 Oct 2013 20:13:21 GMT\nlocation: https://www.example.com\n"));
+    headers.clear();
+    QVERIFY(decoder.decode(block2.constData(), block2.size(), &headers));
+    QCOMPARE(headers, fields(":status: 307\ncache-control: private\n"
+                             "date: Mon, 21 Oct 2013 20:13:21 GMT\nlocation: https://www.example.com\n"));
+    headers.clear();
+    QVERIFY(decoder.decode(block3.constData(), block3.size(), &headers));
+    QCOMPARE(headers, fields(":status: 200\ncache-control: private\n"
+                             "date: Mon, 21 Oct 2013 20:13:22 GMT\nlocation: https://www.example.com\n"
+                             "content-encoding: gzip\n"
+                             "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1\n"));
+}
+
+void tst_QHPack::sensitiveFields()
+{
+    QHPackEncoder encoder;
+    encoder.setCompressStrings(false);
+    QHPackDecoder decoder;
+    const QHPackHeaderList request = fields("authorization: Basic dXNlcjpwYXNz\n");
+
+    // never indexed, the credentials don't end up in the table
+    for (int i = 0; i < 2; ++i) {
+        QByteArray out;
+        encoder.encode(request, &out);
+        QCOMPARE(int(uchar(out.at(0)) & 0xf0), 0x10);
+        QHPackHeaderList headers;
+        QVERIFY(decoder.decode(out.constData(), out.size(), &headers));
+        QCOMPARE(headers, request);
+    }
+}
+
+void tst_QHPack::tableSizeUpdate()
+{
+    QHPackEncoder encoder;
+    QHPackDecoder decoder;
+    const QHPackHeaderList request = fields("x-custom: some value\n");
+
+    QByteArray out;
+    encoder.encode(request, &out);
+    QHPackHeaderList headers;
+    QVERIFY(decoder.decode(out.constData(), out.size(), &headers));
+
+    // the peer shrinks the table, the next block starts with the update
+    encoder.setMaxTableSize(0);
+    out.clear();
+    encoder.encode(request, &out);
+    QCOMPARE(int(uchar(out.at(0))), 0x20);
+    headers.clear();
+    QVERIFY(decoder.decode(out.constData(), out.size(), &headers));
+    QCOMPARE(headers, request);
+
+    // growing beyond what the decoder allowed is an error
+    QHPackDecoder strictDecoder(100);
+    const QByteArray update = QByteArray::fromHex("3f4682");
+    QVERIFY(!strictDecoder.decode(update.constData(), update.size(), &headers));
+
+    QHPackTable table(64);
+    table.add("name", "value"); // 41 octets
+    QCOMPARE(table.size(), quint32(41));
+    table.add("other", "value"); // 42 octets, evicts the first one
+    QCOMPARE(table.dynamicCount(), 1);
+    QCOMPARE(table.size(), quint32(42));
+    table.setMaxSize(0);
+    QCOMPARE(table.dynamicCount(), 0);
+}
+
+void tst_QHPack::invalidBlocks_data()
+{
+    QTest::addColumn<QByteArray>("block");
+
+    QTest::newRow("index-zero") << QByteArray::fromHex("80");
+    QTest::newRow("index-out-of-range") << QByteArray::fromHex("be");
+    QTest::newRow("truncated-string") << QByteArray::fromHex("400a6375");
+    QTest::newRow("truncated-integer") << QByteArray::fromHex("ff");
+    QTest::newRow("integer-overflow") << QByteArray::fromHex("ffffffffffffffffff7f");
+    QTest::newRow("late-size-update") << QByteArray::fromHex("8220");
+}
+
+void tst_QHPack::invalidBlocks()
+{
+    QFETCH(QByteArray, block);
+
+    QHPackDecoder decoder;
+    QHPackHeaderList headers;
+    QVERIFY(!decoder.decode(block.constData(), block.size(), &headers));
+}
+
+QTEST_MAIN(tst_QHPack)
+#include "tst_qhpack.moc"
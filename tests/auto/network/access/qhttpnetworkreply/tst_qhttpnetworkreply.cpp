@@ -113,6 +113,26 @@ void tst_QHttpNetworkReply::parseHeader_data()
                                                     "Vary: User-Agent\r\n")
                                       << (QStringList() << "Vary")
                                       << (QStringList() << "Accept-Language, Cookie, User-Agent");
+
+    QTest::newRow("lowercase-field") << QByteArray("content-type: text/html\r\n"
+                                                   "x-custom-header:  value \r\n")
+                                     << (QStringList() << "Content-Type" << "X-Custom-Header")
+                                     << (QStringList() << "text/html" << "value");
+    QTest::newRow("lf-only") << QByteArray("Content-Length: 1024\n"
+                                           "Content-Encoding:\tgzip\n"
+                                           "\n")
+                             << (QStringList() << "Content-Length" << "Content-Encoding")
+                             << (QStringList() << "1024" << "gzip");
+    QTest::newRow("tab-continued") << QByteArray("Content-Type: text/html;\r\n"
+                                                 "\tcharset=utf-8\r\n"
+                                                 "Content-Length: 1024\r\n")
+                                   << (QStringList() << "Content-Type" << "Content-Length")
+                                   << (QStringList() << "text/html; charset=utf-8" << "1024");
+    QTest::newRow("garbage-line") << QByteArray("Content-Type: text/html\r\n"
+                                                "garbage\r\n"
+                                                "Content-Length: 1024\r\n")
+                                  << (QStringList() << "Content-Type" << "Content-Length")
+                                  << (QStringList() << "text/html" << "1024");
 }
 
 void tst_QHttpNetworkReply::parseHeader()
@@ -68,6 +68,7 @@
 #include <QtNetwork/QHttpPart>
 #include <QtNetwork/QHttpMultiPart>
 #include <QtNetwork/QNetworkProxyQuery>
+#include <QtCore/private/qcompressor_p.h>
 #ifndef QT_NO_SSL
 #include <QtNetwork/qsslerror.h>
 #include <QtNetwork/qsslconfiguration.h>
@@ -381,6 +382,16 @@ private Q_SLOTS:
     void getFromHttpIntoBuffer2();
     void getFromHttpIntoBufferCanReadLine();
 
+    void putFromFileToHttp();
+    void putFromFileToHttpBrokenConnection();
+#ifndef QT_NO_COMPRESS
+    void putCompressedToHttp_data();
+    void putCompressedToHttp();
+#endif
+    void getFromHttpIntoFileDescriptor();
+    void getFromHttpIntoFileDescriptorBrokenConnection();
+    void getFromHttpIntoReadOnlyFileDescriptor();
+
     void ioGetFromHttpWithoutContentLength();
 
     void ioGetFromHttpBrokenChunkedEncoding();
@@ -626,6 +637,113 @@ public slots:
     }
 };
 
+// Collects the body of one request, as announced by its Content-Length
+// header, before answering it with an empty 200 reply. With abortAfter set
+// the connection is dropped once that many body bytes have arrived.
+class BodyReceivingServer: public QTcpServer
+{
+    Q_OBJECT
+public:
+    QByteArray receivedHeader;
+    QByteArray receivedBody;
+    qint64 abortAfter;
+
+    BodyReceivingServer() : abortAfter(-1), client(0)
+    {
+        listen(QHostAddress::LocalHost);
+        connect(this, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+    }
+
+private slots:
+    void acceptConnection()
+    {
+        client = nextPendingConnection();
+        data.clear();
+        connect(client, SIGNAL(readyRead()), this, SLOT(readRequest()));
+    }
+
+    void readRequest()
+    {
+        data += client->readAll();
+        const int headerEnd = data.indexOf("\r\n\r\n");
+        if (headerEnd == -1)
+            return;
+
+        const QByteArray header = data.left(headerEnd + 4);
+        qint64 contentLength = 0;
+        foreach (const QByteArray &line, header.split('\n')) {
+            if (line.toLower().startsWith("content-length:"))
+                contentLength = line.mid(15).trimmed().toLongLong();
+        }
+        const qint64 bodySize = data.size() - header.size();
+        if (abortAfter >= 0 && bodySize >= abortAfter) {
+            disconnect(client, 0, this, 0);
+            client->abort();
+            return;
+        }
+        if (bodySize < contentLength)
+            return;
+
+        receivedHeader = header;
+        receivedBody = data.mid(header.size(), contentLength);
+        disconnect(client, 0, this, 0);
+        client->write("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n");
+        client->disconnectFromHost();
+    }
+
+private:
+    QTcpSocket *client;
+    QByteArray data;
+};
+
+// A sequential device that hands out its data a chunk at a time from the event loop
+class ChunkedSequentialDevice: public QIODevice
+{
+    Q_OBJECT
+public:
+    ChunkedSequentialDevice(const QByteArray &data)
+        : data(data), pos(0), chunkEnd(0), finished(false)
+    {
+        open(QIODevice::ReadOnly);
+        QTimer::singleShot(0, this, SLOT(nextChunk()));
+    }
+
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const { return chunkEnd - pos + QIODevice::bytesAvailable(); }
+    bool atEnd() const { return finished && pos == data.size() && QIODevice::atEnd(); }
+
+protected:
+    qint64 readData(char *dest, qint64 maxSize)
+    {
+        if (finished && pos == data.size())
+            return -1;
+        const qint64 size = qMin(maxSize, chunkEnd - pos);
+        memcpy(dest, data.constData() + pos, size);
+        pos += size;
+        return size;
+    }
+    qint64 writeData(const char *, qint64) { return -1; }
+
+private slots:
+    void nextChunk()
+    {
+        chunkEnd = qMin(chunkEnd + 64 * 1024, qint64(data.size()));
+        emit readyRead();
+        if (chunkEnd < data.size()) {
+            QTimer::singleShot(0, this, SLOT(nextChunk()));
+        } else {
+            finished = true;
+            emit readChannelFinished();
+        }
+    }
+
+private:
+    QByteArray data;
+    qint64 pos;
+    qint64 chunkEnd;
+    bool finished;
+};
+
 class MyCookieJar: public QNetworkCookieJar
 {
 public:
@@ -6270,6 +6388,181 @@ void tst_QNetworkReply::getFromHttpIntoBufferCanReadLine()
 
 
 // Is handled somewhere else too, introduced this special test to have it more accessible
+static QByteArray fileTransferData(int size)
+{
+    QByteArray data;
+    data.resize(size);
+    for (int i = 0; i < size; ++i)
+        data[i] = char((i * 7 + i / 4096) & 0xff);
+    return data;
+}
+
+// A QFile upload over plain HTTP is sent straight from the file descriptor
+void tst_QNetworkReply::putFromFileToHttp()
+{
+    const QByteArray data = fileTransferData(3 * 1024 * 1024 + 123);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.seek(0));
+
+    BodyReceivingServer server;
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/upload"));
+    QNetworkReplyPtr reply(manager.put(request, &file));
+    QSignalSpy uploadProgress(reply.data(), SIGNAL(uploadProgress(qint64,qint64)));
+
+    QVERIFY(waitForFinish(reply) == Success);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.receivedBody.size(), data.size());
+    QVERIFY(server.receivedBody == data);
+    bool uploadCompleted = false;
+    for (int i = 0; i < uploadProgress.count(); ++i)
+        uploadCompleted |= uploadProgress.at(i).at(0).toLongLong() == data.size();
+    QVERIFY(uploadCompleted);
+}
+
+void tst_QNetworkReply::putFromFileToHttpBrokenConnection()
+{
+    const QByteArray data = fileTransferData(8 * 1024 * 1024);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.seek(0));
+
+    BodyReceivingServer server;
+    server.abortAfter = 256 * 1024;
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/upload"));
+    QNetworkReplyPtr reply(manager.put(request, &file));
+
+    QVERIFY(waitForFinish(reply) == Failure);
+    QVERIFY(reply->error() != QNetworkReply::NoError);
+}
+
+#ifndef QT_NO_COMPRESS
+void tst_QNetworkReply::putCompressedToHttp_data()
+{
+    QTest::addColumn<QString>("device");
+    QTest::newRow("buffer") << "buffer";
+    QTest::newRow("file") << "file";
+    QTest::newRow("sequential") << "sequential";
+}
+
+// CompressUploadDataAttribute sends a gzip body whatever the kind of device
+void tst_QNetworkReply::putCompressedToHttp()
+{
+    QFETCH(QString, device);
+
+    QByteArray data;
+    for (int i = 0; i < 20000; ++i)
+        data += "line " + QByteArray::number(i) + " of the upload\n";
+
+    QBuffer buffer(&data);
+    QTemporaryFile file;
+    QScopedPointer<ChunkedSequentialDevice> sequential;
+    QIODevice *outgoing = 0;
+    if (device == "buffer") {
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        outgoing = &buffer;
+    } else if (device == "file") {
+        QVERIFY(file.open());
+        QCOMPARE(file.write(data), qint64(data.size()));
+        QVERIFY(file.seek(0));
+        outgoing = &file;
+    } else {
+        sequential.reset(new ChunkedSequentialDevice(data));
+        outgoing = sequential.data();
+    }
+
+    BodyReceivingServer server;
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/upload"));
+    request.setAttribute(QNetworkRequest::CompressUploadDataAttribute, true);
+    QNetworkReplyPtr reply(manager.put(request, outgoing));
+
+    QVERIFY(waitForFinish(reply) == Success);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(server.receivedHeader.toLower().contains("content-encoding: gzip"));
+    QVERIFY(server.receivedBody.size() < data.size());
+
+    QBuffer compressed(&server.receivedBody);
+    QVERIFY(compressed.open(QIODevice::ReadOnly));
+    QDecompressor decompressor(&compressed, QDecompressor::GzipFormat);
+    QVERIFY(decompressor.open(QIODevice::ReadOnly));
+    const QByteArray inflated = decompressor.readAll();
+    QCOMPARE(inflated.size(), data.size());
+    QVERIFY(inflated == data);
+}
+#endif // QT_NO_COMPRESS
+
+// With DownloadFileDescriptorAttribute the body goes to the file, not to the reply
+void tst_QNetworkReply::getFromHttpIntoFileDescriptor()
+{
+    const QByteArray data = fileTransferData(2 * 1024 * 1024 + 77);
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: " + QByteArray::number(data.size())
+                          + "\r\n\r\n" + data);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileDescriptorAttribute, file.handle());
+    QNetworkReplyPtr reply(manager.get(request));
+    QSignalSpy downloadProgress(reply.data(), SIGNAL(downloadProgress(qint64,qint64)));
+
+    QVERIFY(waitForFinish(reply) == Success);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::DownloadFileDescriptorAttribute).toInt(), file.handle());
+    QCOMPARE(reply->bytesAvailable(), qint64(0));
+    QVERIFY(!downloadProgress.isEmpty());
+    QCOMPARE(downloadProgress.last().at(0).toLongLong(), qint64(data.size()));
+
+    QFile written(file.fileName());
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    const QByteArray received = written.readAll();
+    QCOMPARE(received.size(), data.size());
+    QVERIFY(received == data);
+}
+
+void tst_QNetworkReply::getFromHttpIntoFileDescriptorBrokenConnection()
+{
+    // the server announces more data than it sends before closing
+    const QByteArray data = fileTransferData(512 * 1024);
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: " + QByteArray::number(2 * data.size())
+                          + "\r\n\r\n" + data);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileDescriptorAttribute, file.handle());
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY(waitForFinish(reply) == Failure);
+    QCOMPARE(reply->error(), QNetworkReply::RemoteHostClosedError);
+
+    // what did arrive is in the file
+    QFile written(file.fileName());
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    QVERIFY(written.readAll() == data);
+}
+
+void tst_QNetworkReply::getFromHttpIntoReadOnlyFileDescriptor()
+{
+    const QByteArray data = fileTransferData(512 * 1024);
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: " + QByteArray::number(data.size())
+                          + "\r\n\r\n" + data);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QFile readOnly(file.fileName());
+    QVERIFY(readOnly.open(QIODevice::ReadOnly));
+
+    // writing the body fails, which must fail the reply
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadFileDescriptorAttribute, readOnly.handle());
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY(waitForFinish(reply) == Failure);
+    QVERIFY(reply->error() != QNetworkReply::NoError);
+    QCOMPARE(file.size(), qint64(0));
+}
+
 void tst_QNetworkReply::ioGetFromHttpWithoutContentLength()
 {
     QByteArray dataToSend("HTTP/1.0 200 OK\r\n\r\nHALLO! 123!");
@@ -58,6 +58,7 @@
 #include <QTcpSocket>
 #include <private/qthread_p.h>
 #include <QTcpServer>
+#include <QUdpSocket>
 
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/qnetworkconfigmanager.h>
@@ -95,6 +96,110 @@
 
 const char * const lupinellaIp = "10.3.4.6";
 
+// A minimal name server on the loopback interface that answers A and AAAA
+// queries from a fixed table and NXDOMAIN for everything else. With forge
+// set, every real answer is preceded by forged ones that must be ignored.
+class DnsStandIn : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DnsStandIn(const QHostAddress &address = QHostAddress(QHostAddress::LocalHost))
+        : queries(0), forge(false)
+    {
+        socket.bind(address, 0);
+        connect(&socket, SIGNAL(readyRead()), this, SLOT(readQueries()));
+    }
+
+    bool isBound() const { return socket.state() == QAbstractSocket::BoundState; }
+    quint16 port() const { return socket.localPort(); }
+
+    // another loopback address, to send answers from the right port but
+    // the wrong host
+    bool bindImpostor()
+    {
+        return impostor.bind(QHostAddress("127.0.0.2"), port());
+    }
+
+    QMultiHash<QByteArray, QHostAddress> records;
+    int queries;
+    bool forge;
+
+private slots:
+    void readQueries()
+    {
+        while (socket.hasPendingDatagrams()) {
+            QByteArray query;
+            query.resize(int(socket.pendingDatagramSize()));
+            QHostAddress sender;
+            quint16 senderPort;
+            socket.readDatagram(query.data(), query.size(), &sender, &senderPort);
+            ++queries;
+
+            QByteArray name;
+            int pos = 12;
+            while (pos < query.size() && query.at(pos)) {
+                const int length = uchar(query.at(pos));
+                if (!name.isEmpty())
+                    name += '.';
+                name += query.mid(pos + 1, length);
+                pos += length + 1;
+            }
+            const int type = (uchar(query.at(pos + 1)) << 8) | uchar(query.at(pos + 2));
+
+            if (forge) {
+                const QList<QHostAddress> bogus = QList<QHostAddress>()
+                        << QHostAddress("6.6.6.6") << QHostAddress("fd66::6");
+                if (impostor.state() == QAbstractSocket::BoundState)
+                    impostor.writeDatagram(reply(query, pos, type, bogus), sender, senderPort);
+                QByteArray otherQuestion = reply(query, pos, type, bogus);
+                otherQuestion[13] = 'x'; // first letter of the question name
+                socket.writeDatagram(otherQuestion, sender, senderPort);
+            }
+
+            QByteArray answer = reply(query, pos, type, records.values(name));
+            if (!records.contains(name))
+                answer[3] = char(0x83); // NXDOMAIN
+            socket.writeDatagram(answer, sender, senderPort);
+        }
+    }
+
+private:
+    static QByteArray reply(const QByteArray &query, int pos, int type, const QList<QHostAddress> &addresses)
+    {
+        QByteArray reply = query.left(pos + 5);
+        reply[2] = char(0x81); // response, recursion desired
+        reply[3] = char(0x80); // recursion available, no error
+        int answers = 0;
+        foreach (const QHostAddress &address, addresses) {
+            const bool isIPv4 = address.protocol() == QAbstractSocket::IPv4Protocol;
+            if (isIPv4 != (type == 1))
+                continue;
+            reply += QByteArray::fromHex("c00c");
+            reply += char(0);
+            reply += char(type);
+            reply += QByteArray::fromHex("00010000012c"); // class IN, ttl 300
+            if (isIPv4) {
+                const quint32 ip4 = address.toIPv4Address();
+                reply += QByteArray::fromHex("0004");
+                reply += char(ip4 >> 24);
+                reply += char(ip4 >> 16);
+                reply += char(ip4 >> 8);
+                reply += char(ip4);
+            } else {
+                const Q_IPV6ADDR ip6 = address.toIPv6Address();
+                reply += QByteArray::fromHex("0010");
+                reply += QByteArray(reinterpret_cast<const char *>(&ip6), 16);
+            }
+            ++answers;
+        }
+        reply[7] = char(answers);
+        return reply;
+    }
+
+    QUdpSocket socket;
+    QUdpSocket impostor;
+};
+
 
 class tst_QHostInfo : public QObject
 {
@@ -133,6 +238,12 @@ private slots:
 
     void cache();
 
+    void dnsBackend();
+    void dnsBackendDeduplication();
+    void dnsBackendForgedReplies();
+    void dnsBackendIPv6Server();
+    void negativeCache();
+
     void abortHostLookup();
     void abortHostLookupInDifferentThread();
 protected slots:
@@ -248,6 +359,8 @@ void tst_QHostInfo::init()
 
 void tst_QHostInfo::cleanup()
 {
+    qt_qhostinfo_enable_dns_backend(false);
+    qt_qhostinfo_set_cache_max_age(60, 0);
 }
 
 void tst_QHostInfo::lookupIPv4_data()
@@ -590,6 +703,136 @@ void tst_QHostInfo::cache()
     QCOMPARE(lookupsDoneCounter, 2);
 }
 
+void tst_QHostInfo::dnsBackend()
+{
+    DnsStandIn server;
+    server.records.insert("www.standin.test", QHostAddress("10.1.2.3"));
+    server.records.insert("www.standin.test", QHostAddress("fd00::1"));
+    qt_qhostinfo_enable_dns_backend(true, QList<QHostAddress>() << QHostAddress::LocalHost, server.port());
+
+    lookupDone = false;
+    QHostInfo::lookupHost("www.standin.test", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.hostName(), QString("www.standin.test"));
+    QCOMPARE(lookupResults.addresses().count(), 2);
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("10.1.2.3")));
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("fd00::1")));
+
+    lookupDone = false;
+    QHostInfo::lookupHost("missing.standin.test", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    QVERIFY(lookupResults.addresses().isEmpty());
+}
+
+void tst_QHostInfo::dnsBackendDeduplication()
+{
+    DnsStandIn server;
+    server.records.insert("dedup.standin.test", QHostAddress("10.1.2.4"));
+    qt_qhostinfo_enable_dns_backend(true, QList<QHostAddress>() << QHostAddress::LocalHost, server.port());
+
+    const int COUNT = 10;
+    lookupsDoneCounter = 0;
+    for (int i = 0; i < COUNT; i++)
+        QHostInfo::lookupHost("dedup.standin.test", this, SLOT(resultsReady(QHostInfo)));
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 10000 && lookupsDoneCounter < COUNT)
+        QTestEventLoop::instance().enterLoop(2);
+    QCOMPARE(lookupsDoneCounter, COUNT);
+    QCOMPARE(lookupResults.addresses(), QList<QHostAddress>() << QHostAddress("10.1.2.4"));
+
+    // one A and one AAAA query, shared by all lookups
+    QCOMPARE(server.queries, 2);
+}
+
+void tst_QHostInfo::dnsBackendForgedReplies()
+{
+    DnsStandIn server;
+    server.records.insert("forged.standin.test", QHostAddress("10.1.2.5"));
+    server.records.insert("forged.standin.test", QHostAddress("fd00::5"));
+    server.forge = true;
+    if (!server.bindImpostor())
+        qWarning("Cannot bind to 127.0.0.2, not testing answers from the wrong host");
+    qt_qhostinfo_enable_dns_backend(true, QList<QHostAddress>() << QHostAddress::LocalHost, server.port());
+
+    lookupDone = false;
+    QHostInfo::lookupHost("forged.standin.test", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.addresses().count(), 2);
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("10.1.2.5")));
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("fd00::5")));
+}
+
+void tst_QHostInfo::dnsBackendIPv6Server()
+{
+    DnsStandIn server(QHostAddress::LocalHostIPv6);
+    if (!server.isBound())
+        QSKIP("Cannot bind to ::1");
+    server.records.insert("ipv6.standin.test", QHostAddress("10.1.2.6"));
+    server.records.insert("ipv6.standin.test", QHostAddress("fd00::6"));
+    qt_qhostinfo_enable_dns_backend(true, QList<QHostAddress>() << QHostAddress::LocalHostIPv6, server.port());
+
+    lookupDone = false;
+    QHostInfo::lookupHost("ipv6.standin.test", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.addresses().count(), 2);
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("10.1.2.6")));
+    QVERIFY(lookupResults.addresses().contains(QHostAddress("fd00::6")));
+}
+
+void tst_QHostInfo::negativeCache()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    DnsStandIn server;
+    qt_qhostinfo_enable_dns_backend(true, QList<QHostAddress>() << QHostAddress::LocalHost, server.port());
+    qt_qhostinfo_set_cache_max_age(60, 60);
+
+    lookupDone = false;
+    bool valid = true;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup("nothing.standin.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(lookupDone);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    const int queries = server.queries;
+
+    // the failure is answered from the cache without asking the server again
+    result = qt_qhostinfo_lookup("nothing.standin.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.error(), QHostInfo::HostNotFound);
+    QCOMPARE(server.queries, queries);
+
+    // without negative caching every lookup goes to the server
+    qt_qhostinfo_clear_cache();
+    qt_qhostinfo_set_cache_max_age(60, 0);
+    for (int i = 0; i < 2; ++i) {
+        lookupDone = false;
+        result = qt_qhostinfo_lookup("nothing.standin.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+        QVERIFY(!valid);
+        QTestEventLoop::instance().enterLoop(10);
+        QVERIFY(lookupDone);
+    }
+    QVERIFY(server.queries > queries + 1);
+}
+
 void tst_QHostInfo::resultsReady(const QHostInfo &hi)
 {
     lookupDone = true;
@@ -7,5 +7,7 @@ SUBDIRS=\
    qsqlquery \
    qsqlrecord \
    qsqlthread \
+   qsqlconnectionpool \
+   qsqlasyncquery \
    qsql \
    qsqlresult \
@@ -0,0 +1,16 @@
+CONFIG += testcase
+TARGET = tst_qsqlasyncquery
+SOURCES  += tst_qsqlasyncquery.cpp
+
+QT = core sql testlib core-private sql-private
+
+
+wince*: {
+   plugFiles.files = ../../../plugins/sqldrivers
+   plugFiles.path    = .
+   DEPLOYMENT += plugFiles
+   LIBS += -lws2
+} else {
+   win32:LIBS += -lws2_32
+}
+
@@ -0,0 +1,382 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include "../qsqldatabase/tst_databases.h"
+
+#include <QtCore>
+#include <QtSql>
+
+const QString qtest(qTableName("qtest", __FILE__));
+
+class tst_QSqlAsyncQuery : public QObject
+{
+    Q_OBJECT
+
+public:
+    void generic_data(const QString &engine=QString());
+    tst_Databases dbs;
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void exec_data() { generic_data(); }
+    void exec();
+    void bindValues_data() { generic_data(); }
+    void bindValues();
+    void manyInFlight_data() { generic_data(); }
+    void manyInFlight();
+    void waitForFinished_data() { generic_data(); }
+    void waitForFinished();
+    void error_data() { generic_data(); }
+    void error();
+    void destroyWhileRunning_data() { generic_data(); }
+    void destroyWhileRunning();
+    void psql_doesNotBlock_data() { generic_data("QPSQL"); }
+    void psql_doesNotBlock();
+    void psql_syncQueryWaits_data() { generic_data("QPSQL"); }
+    void psql_syncQueryWaits();
+    void sqlite_fullMutex_data() { generic_data("QSQLITE"); }
+    void sqlite_fullMutex();
+};
+
+void tst_QSqlAsyncQuery::generic_data(const QString& engine)
+{
+    if ( dbs.fillTestTable(engine) == 0 ) {
+        if(engine.isEmpty())
+           QSKIP( "No database drivers are available in this Qt configuration");
+        else
+           QSKIP( (QString("No database drivers of type %1 are available in this Qt configuration").arg(engine)).toLocal8Bit());
+    }
+}
+
+void tst_QSqlAsyncQuery::initTestCase()
+{
+    dbs.open();
+    for (int i = 0; i < dbs.dbNames.count(); ++i) {
+        QSqlDatabase db = QSqlDatabase::database(dbs.dbNames.at(i));
+        QSqlQuery q(db);
+        tst_Databases::safeDropTable(db, qtest);
+        QVERIFY_SQL(q, exec("create table " + qtest + "(id int NOT NULL primary key, name varchar(20))"));
+        for (int id = 1; id <= 3; ++id)
+            QVERIFY_SQL(q, exec(QString("insert into " + qtest + " values(%1, 'name %1')").arg(id)));
+    }
+}
+
+void tst_QSqlAsyncQuery::cleanupTestCase()
+{
+    for (int i = 0; i < dbs.dbNames.count(); ++i)
+        tst_Databases::safeDropTable(QSqlDatabase::database(dbs.dbNames.at(i)), qtest);
+    dbs.close();
+}
+
+void tst_QSqlAsyncQuery::exec()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery query(db);
+    QCOMPARE(query.database().connectionName(), db.connectionName());
+    QVERIFY(!query.isRunning());
+
+    QSignalSpy spy(&query, SIGNAL(finished()));
+    QVERIFY(query.exec("select id, name from " + qtest + " order by id"));
+    QVERIFY(query.isRunning());
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY(!query.isRunning());
+
+    QSqlQuery q = query.query();
+    QVERIFY_SQL(q, isActive());
+    QVERIFY(q.isSelect());
+    for (int id = 1; id <= 3; ++id) {
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), id);
+        QCOMPARE(q.value(1).toString(), QString("name %1").arg(id));
+    }
+    QVERIFY(!q.next());
+    // the rows have been read, the result can be navigated freely
+    QVERIFY(q.first());
+    QCOMPARE(q.value(0).toInt(), 1);
+    QCOMPARE(q.executedQuery(), "select id, name from " + qtest + " order by id");
+
+    // another execution gets a new result, the old one stays usable
+    QVERIFY(query.exec("select count(*) from " + qtest));
+    QTRY_COMPARE(spy.count(), 2);
+    QSqlQuery count = query.query();
+    QVERIFY(count.next());
+    QCOMPARE(count.value(0).toInt(), 3);
+    QVERIFY(q.last());
+    QCOMPARE(q.value(0).toInt(), 3);
+}
+
+void tst_QSqlAsyncQuery::bindValues()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery query(db);
+    QSignalSpy spy(&query, SIGNAL(finished()));
+
+    QVERIFY(query.prepare("select name from " + qtest + " where id = ? or id = ? order by id"));
+    query.addBindValue(1);
+    query.addBindValue(3);
+    QVERIFY(query.exec());
+    QTRY_COMPARE(spy.count(), 1);
+    QSqlQuery q = query.query();
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString(), QString("name 1"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString(), QString("name 3"));
+
+    QVERIFY(query.prepare("select name from " + qtest + " where id = :id"));
+    query.bindValue(":id", 2);
+    QVERIFY(query.exec());
+    QTRY_COMPARE(spy.count(), 2);
+    q = query.query();
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString(), QString("name 2"));
+
+    // bound values are kept for the next execution
+    QVERIFY(query.exec());
+    QTRY_COMPARE(spy.count(), 3);
+    q = query.query();
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString(), QString("name 2"));
+
+    QVERIFY(query.prepare("insert into " + qtest + " values (?, ?)"));
+    query.bindValue(1, QString("name 10"));
+    query.bindValue(0, 10);
+    QVERIFY(query.exec());
+    QTRY_COMPARE(spy.count(), 4);
+    QVERIFY_SQL(query.query(), isActive());
+    QCOMPARE(query.query().numRowsAffected(), 1);
+
+    QSqlQuery check(db);
+    QVERIFY_SQL(check, exec("select name from " + qtest + " where id = 10"));
+    QVERIFY(check.next());
+    QCOMPARE(check.value(0).toString(), QString("name 10"));
+    QVERIFY_SQL(check, exec("delete from " + qtest + " where id = 10"));
+}
+
+void tst_QSqlAsyncQuery::manyInFlight()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    enum { QueryCount = 10 };
+    QObject owner;
+    QList<QSqlAsyncQuery *> queries;
+    for (int i = 0; i < QueryCount; ++i) {
+        QSqlAsyncQuery *query = new QSqlAsyncQuery(db, &owner);
+        query->prepare("select name from " + qtest + " where id = ?");
+        query->addBindValue(i % 3 + 1);
+        queries.append(query);
+    }
+    QSignalSpy spy(queries.last(), SIGNAL(finished()));
+    for (int i = 0; i < QueryCount; ++i)
+        QVERIFY(queries.at(i)->exec());
+    QTRY_COMPARE(spy.count(), 1);
+
+    // all of them have finished by the time the last one has
+    for (int i = 0; i < QueryCount; ++i) {
+        QVERIFY(!queries.at(i)->isRunning());
+        QSqlQuery q = queries.at(i)->query();
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toString(), QString("name %1").arg(i % 3 + 1));
+    }
+}
+
+void tst_QSqlAsyncQuery::waitForFinished()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery first(db);
+    QSqlAsyncQuery second(db);
+    QSignalSpy spy(&second, SIGNAL(finished()));
+    QVERIFY(first.exec("select id from " + qtest));
+    QVERIFY(second.exec("select name from " + qtest + " order by id"));
+    QVERIFY(second.waitForFinished());
+    QVERIFY(!second.isRunning());
+    QSqlQuery q = second.query();
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString(), QString("name 1"));
+
+    // finished() is still emitted, once
+    QTRY_COMPARE(spy.count(), 1);
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+
+    QVERIFY(first.waitForFinished());
+    QVERIFY(first.query().isActive());
+}
+
+void tst_QSqlAsyncQuery::error()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery query(db);
+    QSignalSpy spy(&query, SIGNAL(finished()));
+    QVERIFY(query.exec("select nonexistent from " + qtest));
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY(!query.query().isActive());
+    QVERIFY(query.lastError().isValid());
+    QCOMPARE(query.lastError().type(), QSqlError::StatementError);
+
+    // the connection is still usable
+    QVERIFY(query.exec("select id from " + qtest));
+    QVERIFY(query.waitForFinished());
+    QVERIFY(!query.lastError().isValid());
+
+    QTest::ignoreMessage(QtWarningMsg, "QSqlAsyncQuery::prepare: empty query");
+    QVERIFY(!query.exec(QString()));
+
+    QVERIFY(query.exec("select id from " + qtest));
+    QTest::ignoreMessage(QtWarningMsg, "QSqlAsyncQuery::exec: the previous query is still running");
+    QVERIFY(!query.exec());
+    QVERIFY(query.waitForFinished());
+}
+
+void tst_QSqlAsyncQuery::destroyWhileRunning()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery *first = new QSqlAsyncQuery(db);
+    QSqlAsyncQuery *second = new QSqlAsyncQuery(db);
+    QVERIFY(first->exec("select id from " + qtest));
+    QVERIFY(second->exec("select name from " + qtest));
+    delete first;
+    delete second;
+    QTest::qWait(10);
+
+    QSqlAsyncQuery third(db);
+    QVERIFY(third.exec("select count(*) from " + qtest));
+    QVERIFY(third.waitForFinished());
+    QSqlQuery q = third.query();
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+}
+
+void tst_QSqlAsyncQuery::psql_doesNotBlock()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery query(db);
+    QSignalSpy spy(&query, SIGNAL(finished()));
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(query.exec("select pg_sleep(0.5)"));
+    QVERIFY(timer.elapsed() < 250);
+    QVERIFY(query.isRunning());
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 5000);
+    QVERIFY(timer.elapsed() >= 450);
+    QVERIFY_SQL(query.query(), isActive());
+}
+
+void tst_QSqlAsyncQuery::psql_syncQueryWaits()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlAsyncQuery query(db);
+    QSignalSpy spy(&query, SIGNAL(finished()));
+    QVERIFY(query.prepare("insert into " + qtest + " values (?, ?)"));
+    query.addBindValue(11);
+    query.addBindValue(QString("name 11"));
+    QVERIFY(query.exec());
+
+    // a synchronous query on the connection runs after the insert
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("select name from " + qtest + " where id = 11"));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toString(), QString("name 11"));
+    QVERIFY(!query.isRunning() || query.waitForFinished());
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY_SQL(q, exec("delete from " + qtest + " where id = 11"));
+}
+
+void tst_QSqlAsyncQuery::sqlite_fullMutex()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    if (db.databaseName() == ":memory:")
+        QSKIP("In-memory databases cannot be shared with another connection");
+
+    {
+        // only serialized connections execute statements in the background
+        QSqlDatabase serialized = QSqlDatabase::cloneDatabase(db, "tst_QSqlAsyncQuery_fullmutex");
+        serialized.setConnectOptions("QSQLITE_OPEN_FULLMUTEX");
+        QVERIFY_SQL(serialized, open());
+
+        QSqlAsyncQuery query(serialized);
+        QSignalSpy spy(&query, SIGNAL(finished()));
+        QVERIFY(query.exec("select name from " + qtest + " where id = 2"));
+        // the connection can be used while the worker runs the statement
+        QSqlQuery sync(serialized);
+        QVERIFY_SQL(sync, exec("select count(*) from " + qtest));
+        QVERIFY(sync.next());
+        QCOMPARE(sync.value(0).toInt(), 3);
+        QTRY_COMPARE(spy.count(), 1);
+        QSqlQuery q = query.query();
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toString(), QString("name 2"));
+    }
+    QSqlDatabase::removeDatabase("tst_QSqlAsyncQuery_fullmutex");
+}
+
+QTEST_MAIN(tst_QSqlAsyncQuery)
+#include "tst_qsqlasyncquery.moc"
@@ -0,0 +1,494 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include "../qsqldatabase/tst_databases.h"
+
+#include <QtCore>
+#include <QtSql>
+
+const QString qtest(qTableName("qtest", __FILE__));
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    void generic_data(const QString &engine=QString());
+    tst_Databases dbs;
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void acquireRelease_data() { generic_data(); }
+    void acquireRelease();
+    void maximumSize_data() { generic_data(); }
+    void maximumSize();
+    void waitForRelease_data() { generic_data(); }
+    void waitForRelease();
+    void evictIdleConnection_data() { generic_data(); }
+    void evictIdleConnection();
+    void threadedQueries_data() { generic_data(); }
+    void threadedQueries();
+    void idleTimeout_data() { generic_data(); }
+    void idleTimeout();
+    void healthCheck_data() { generic_data(); }
+    void healthCheck();
+    void statementCache_data() { generic_data(); }
+    void statementCache();
+    void invalidTemplate();
+};
+
+class PoolReleaseThread : public QThread
+{
+public:
+    PoolReleaseThread(QSqlConnectionPool *pool, QObject *parent = 0)
+        : QThread(parent), pool(pool), acquired(false) {}
+
+    void run()
+    {
+        QSqlDatabase db = pool->acquire();
+        acquired = db.isValid();
+        ready.release();
+        msleep(200);
+        pool->release(db);
+    }
+
+    QSqlConnectionPool *pool;
+    QSemaphore ready;
+    bool acquired;
+};
+
+class PoolIdleThread : public QThread
+{
+public:
+    PoolIdleThread(QSqlConnectionPool *pool, QObject *parent = 0)
+        : QThread(parent), pool(pool), acquired(false) {}
+
+    void run()
+    {
+        QSqlDatabase db = pool->acquire();
+        acquired = db.isValid();
+        pool->release(db);
+        idle.release();
+        proceed.acquire();
+        pool->removeIdleConnections();
+    }
+
+    QSqlConnectionPool *pool;
+    QSemaphore idle;
+    QSemaphore proceed;
+    bool acquired;
+};
+
+class PoolQueryThread : public QThread
+{
+public:
+    enum { Iterations = 20 };
+
+    PoolQueryThread(QSqlConnectionPool *pool, QObject *parent = 0)
+        : QThread(parent), pool(pool), failures(0) {}
+
+    void run()
+    {
+        for (int i = 0; i < Iterations; ++i) {
+            QSqlDatabase db = pool->acquire();
+            if (!db.isOpen()) {
+                ++failures;
+                continue;
+            }
+            {
+                QSqlQuery q = pool->cachedQuery(db, "select name from " + qtest + " where id = ?");
+                q.addBindValue(i % 3 + 1);
+                if (!q.exec() || !q.next() || q.value(0).toString() != QString("name %1").arg(i % 3 + 1))
+                    ++failures;
+            }
+            pool->release(db);
+        }
+        pool->removeIdleConnections();
+    }
+
+    QSqlConnectionPool *pool;
+    int failures;
+};
+
+void tst_QSqlConnectionPool::generic_data(const QString& engine)
+{
+    if ( dbs.fillTestTable(engine) == 0 ) {
+        if(engine.isEmpty())
+           QSKIP( "No database drivers are available in this Qt configuration");
+        else
+           QSKIP( (QString("No database drivers of type %1 are available in this Qt configuration").arg(engine)).toLocal8Bit());
+    }
+}
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    dbs.open();
+    for (int i = 0; i < dbs.dbNames.count(); ++i) {
+        QSqlDatabase db = QSqlDatabase::database(dbs.dbNames.at(i));
+        QSqlQuery q(db);
+        tst_Databases::safeDropTable(db, qtest);
+        QVERIFY_SQL(q, exec("create table " + qtest + "(id int NOT NULL primary key, name varchar(20))"));
+        for (int id = 1; id <= 3; ++id)
+            QVERIFY_SQL(q, exec(QString("insert into " + qtest + " values(%1, 'name %1')").arg(id)));
+    }
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    for (int i = 0; i < dbs.dbNames.count(); ++i)
+        tst_Databases::safeDropTable(QSqlDatabase::database(dbs.dbNames.at(i)), qtest);
+    dbs.close();
+}
+
+void tst_QSqlConnectionPool::acquireRelease()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    QCOMPARE(pool.connectionName(), dbName);
+    QCOMPARE(pool.size(), 0);
+
+    QSqlDatabase conn = pool.acquire();
+    QVERIFY(conn.isOpen());
+    QVERIFY(conn.connectionName() != dbName);
+    QCOMPARE(conn.driverName(), db.driverName());
+    QCOMPARE(conn.databaseName(), db.databaseName());
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+
+    {
+        QSqlQuery q(conn);
+        QVERIFY_SQL(q, exec("select id from " + qtest + " order by id"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 1);
+    }
+
+    const QString name = conn.connectionName();
+    pool.release(conn);
+    QVERIFY(!conn.isValid());
+    QCOMPARE(pool.idleCount(), 1);
+
+    // the same thread gets its connection back
+    conn = pool.acquire();
+    QCOMPARE(conn.connectionName(), name);
+    QCOMPARE(pool.size(), 1);
+
+    QSqlDatabase second = pool.acquire();
+    QVERIFY(second.isOpen());
+    QVERIFY(second.connectionName() != name);
+    QCOMPARE(pool.size(), 2);
+
+    pool.release(conn);
+    pool.release(second);
+    QCOMPARE(pool.idleCount(), 2);
+
+    pool.removeIdleConnections();
+    QCOMPARE(pool.size(), 0);
+    QVERIFY(!QSqlDatabase::contains(name));
+}
+
+void tst_QSqlConnectionPool::maximumSize()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    pool.setMaximumSize(2);
+    QCOMPARE(pool.maximumSize(), 2);
+
+    QSqlDatabase first = pool.acquire();
+    QSqlDatabase second = pool.acquire();
+    QVERIFY(first.isOpen());
+    QVERIFY(second.isOpen());
+
+    QElapsedTimer timer;
+    timer.start();
+    QSqlDatabase third = pool.acquire(100);
+    QVERIFY(!third.isValid());
+    QVERIFY(timer.elapsed() >= 90);
+    QCOMPARE(pool.lastError().type(), QSqlError::ConnectionError);
+    QCOMPARE(pool.size(), 2);
+
+    const QString name = second.connectionName();
+    pool.release(second);
+    third = pool.acquire(0);
+    QVERIFY(third.isOpen());
+    QCOMPARE(third.connectionName(), name);
+
+    pool.release(first);
+    pool.release(third);
+}
+
+void tst_QSqlConnectionPool::waitForRelease()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    pool.setMaximumSize(1);
+
+    PoolReleaseThread thread(&pool);
+    thread.start();
+    thread.ready.acquire();
+    QVERIFY(thread.acquired);
+
+    // the other thread closes its connection when releasing it, making room for this one
+    QSqlDatabase conn = pool.acquire(5000);
+    QVERIFY(conn.isOpen());
+    QCOMPARE(pool.size(), 1);
+    {
+        QSqlQuery q(conn);
+        QVERIFY_SQL(q, exec("select count(*) from " + qtest));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 3);
+    }
+
+    pool.release(conn);
+    QVERIFY(thread.wait(5000));
+}
+
+void tst_QSqlConnectionPool::evictIdleConnection()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    pool.setMaximumSize(1);
+
+    PoolIdleThread thread(&pool);
+    thread.start();
+    thread.idle.acquire();
+    QVERIFY(thread.acquired);
+    QCOMPARE(pool.idleCount(), 1);
+
+    // the idle connection belongs to the other thread, which has to close it
+    QSqlDatabase conn = pool.acquire(100);
+    QVERIFY(!conn.isValid());
+    QCOMPARE(pool.lastError().type(), QSqlError::ConnectionError);
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+
+    thread.proceed.release();
+    conn = pool.acquire(5000);
+    QVERIFY(conn.isOpen());
+    QCOMPARE(pool.size(), 1);
+
+    pool.release(conn);
+    QVERIFY(thread.wait(5000));
+}
+
+void tst_QSqlConnectionPool::threadedQueries()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    pool.setMaximumSize(3);
+
+    QList<PoolQueryThread *> threads;
+    for (int i = 0; i < 6; ++i)
+        threads << new PoolQueryThread(&pool);
+    foreach (PoolQueryThread *thread, threads)
+        thread->start();
+    foreach (PoolQueryThread *thread, threads) {
+        QVERIFY(thread->wait(60000));
+        QCOMPARE(thread->failures, 0);
+    }
+    qDeleteAll(threads);
+
+    QVERIFY(pool.size() <= 3);
+    QCOMPARE(pool.idleCount(), pool.size());
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    pool.setMinimumSize(1);
+    pool.setMaximumSize(3);
+    QCOMPARE(pool.minimumSize(), 1);
+
+    QList<QSqlDatabase> connections;
+    for (int i = 0; i < 3; ++i)
+        connections << pool.acquire();
+    QCOMPARE(pool.size(), 3);
+    for (int i = 0; i < connections.count(); ++i)
+        pool.release(connections[i]);
+    QCOMPARE(pool.idleCount(), 3);
+
+    pool.setIdleTimeout(0);
+    QCOMPARE(pool.idleTimeout(), 0);
+    QSqlDatabase conn = pool.acquire();
+    QVERIFY(conn.isOpen());
+    pool.release(conn);
+
+    // the pool shrinks down to its minimum size
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+void tst_QSqlConnectionPool::healthCheck()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlConnectionPool pool(dbName);
+    QSqlDatabase conn = pool.acquire();
+    const QString name = conn.connectionName();
+    conn.close();
+    pool.release(conn);
+
+    // a closed connection is opened again
+    conn = pool.acquire();
+    QCOMPARE(conn.connectionName(), name);
+    QVERIFY(conn.isOpen());
+    pool.release(conn);
+
+    pool.setHealthCheckQuery("select count(*) from " + qtest);
+    QCOMPARE(pool.healthCheckQuery(), QString("select count(*) from " + qtest));
+    conn = pool.acquire();
+    QVERIFY(conn.isOpen());
+    {
+        QSqlQuery q(conn);
+        QVERIFY_SQL(q, exec("select id from " + qtest));
+    }
+    pool.release(conn);
+
+    pool.setHealthCheckQuery("select * from " + qTableName("nonexistent", __FILE__));
+    conn = pool.acquire();
+    QVERIFY(conn.isOpen());
+    pool.release(conn);
+}
+
+void tst_QSqlConnectionPool::statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString byId = "select name from " + qtest + " where id = ?";
+    const QString all = "select name from " + qtest;
+
+    QSqlConnectionPool pool(dbName);
+    QCOMPARE(pool.statementCacheSize(), 32);
+    QSqlDatabase conn = pool.acquire();
+
+    const QSqlResult *byIdResult;
+    {
+        QSqlQuery q = pool.cachedQuery(conn, byId);
+        byIdResult = q.result();
+        q.addBindValue(2);
+        QVERIFY_SQL(q, exec());
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QString("name 2"));
+    }
+    {
+        QSqlQuery q = pool.cachedQuery(conn, byId);
+        QCOMPARE(q.result(), byIdResult);
+        q.addBindValue(3);
+        QVERIFY_SQL(q, exec());
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QString("name 3"));
+    }
+    QVERIFY(pool.cachedQuery(conn, all).result() != byIdResult);
+    {
+        QSqlQuery invalid = pool.cachedQuery(conn, "select from where");
+        QVERIFY(invalid.lastError().isValid() || !invalid.exec());
+    }
+
+    // the least recently used statement is dropped
+    pool.setStatementCacheSize(1);
+    pool.release(conn);
+    conn = pool.acquire();
+    {
+        QSqlQuery q = pool.cachedQuery(conn, all);
+        QCOMPARE(pool.cachedQuery(conn, all).result(), q.result());
+        QSqlQuery other = pool.cachedQuery(conn, byId);
+        QVERIFY(pool.cachedQuery(conn, all).result() != q.result());
+    }
+
+    pool.setStatementCacheSize(0);
+    pool.release(conn);
+    conn = pool.acquire();
+    {
+        QSqlQuery q = pool.cachedQuery(conn, all);
+        QVERIFY(pool.cachedQuery(conn, all).result() != q.result());
+    }
+    pool.release(conn);
+}
+
+void tst_QSqlConnectionPool::invalidTemplate()
+{
+    QSqlConnectionPool pool(QLatin1String("tst_QSqlConnectionPool_nonexistent"));
+    QSqlDatabase conn = pool.acquire();
+    QVERIFY(!conn.isValid());
+    QVERIFY(pool.lastError().isValid());
+    QCOMPARE(pool.size(), 0);
+    pool.release(conn);
+
+    QSqlDatabase other = QSqlDatabase::addDatabase("QSQLITE", "tst_QSqlConnectionPool_other");
+    if (other.isValid()) {
+        QTest::ignoreMessage(QtWarningMsg, "QSqlConnectionPool::release: connection "
+                             "'tst_QSqlConnectionPool_other' is not checked out from this pool");
+        pool.release(other);
+    }
+    other = QSqlDatabase();
+    QSqlDatabase::removeDatabase("tst_QSqlConnectionPool_other");
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "tst_qsqlconnectionpool.moc"
@@ -198,6 +198,9 @@ private slots:
     void sqlite_enable_cache_mode_data() { generic_data("QSQLITE"); }
     void sqlite_enable_cache_mode();
 
+    void sqlite_connectOptions_data() { generic_data("QSQLITE"); }
+    void sqlite_connectOptions();
+
 private:
     void createTestTables(QSqlDatabase db);
     void dropTestTables(QSqlDatabase db);
@@ -2224,5 +2227,67 @@ void tst_QSqlDatabase::sqlite_enable_cache_mode()
     QVERIFY_SQL(q2, exec("select * from "+qTableName("qtest", __FILE__)));
 }
 
+void tst_QSqlDatabase::sqlite_connectOptions()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("connopts", __FILE__);
+    const QString text = QString::fromUtf8("\303\251t\303\251 \342\202\254 10");
+
+    const QStringList options = QStringList()
+            << QString() << "QSQLITE_UTF16_API" << "QSQLITE_STATEMENT_CACHE_SIZE=0"
+            << "QSQLITE_STATEMENT_CACHE_SIZE=1";
+    foreach (const QString &option, options) {
+        db.close();
+        db.setConnectOptions(option);
+        QVERIFY_SQL(db, open());
+        tst_Databases::safeDropTable(db, tableName);
+
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("create table " + tableName + " (id int, t varchar(20))"));
+        QVERIFY_SQL(q, prepare("insert into " + tableName + " values (?, ?)"));
+        q.addBindValue(1);
+        q.addBindValue(text);
+        QVERIFY_SQL(q, exec());
+
+        // the same statement text over and over again, across a schema change
+        const QString select = "select * from " + tableName;
+        for (int i = 0; i < 3; ++i) {
+            QSqlQuery q2(db);
+            QVERIFY_SQL(q2, exec(select));
+            QVERIFY(q2.next());
+            QCOMPARE(q2.value(1).toString(), text);
+            QCOMPARE(q2.record().count(), i ? 3 : 2);
+            if (!i)
+                QVERIFY_SQL(q, exec("alter table " + tableName + " add column c int"));
+        }
+        q.finish();
+        tst_Databases::safeDropTable(db, tableName);
+    }
+
+    if (!dbName.endsWith(":memory:")) {
+        db.close();
+        db.setConnectOptions("QSQLITE_JOURNAL_MODE=WAL");
+        QVERIFY_SQL(db, open());
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("pragma journal_mode"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString().toLower(), QString("wal"));
+        q.finish();
+
+        db.close();
+        db.setConnectOptions("QSQLITE_JOURNAL_MODE=DELETE");
+        QVERIFY_SQL(db, open());
+        QVERIFY_SQL(q, exec("pragma journal_mode"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString().toLower(), QString("delete"));
+    }
+
+    db.close();
+    db.setConnectOptions();
+    QVERIFY_SQL(db, open());
+}
+
 QTEST_MAIN(tst_QSqlDatabase)
 #include "tst_qsqldatabase.moc"
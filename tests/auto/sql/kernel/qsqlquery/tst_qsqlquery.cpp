@@ -105,6 +105,8 @@ private slots:
     // forwardOnly mode need special treatment
     void forwardOnly_data() { generic_data(); }
     void forwardOnly();
+    void typedValues_data() { generic_data(); }
+    void typedValues();
 
     // bug specific tests
     void bitField_data() {generic_data("QTDS"); }
@@ -155,6 +157,10 @@ private slots:
     void invalidQuery();
     void batchExec_data() { generic_data(); }
     void batchExec();
+    void batchExecNullsAndDates_data() { generic_data(); }
+    void batchExecNullsAndDates();
+    void batchExecManyRows_data() { generic_data(); }
+    void batchExecManyRows();
     void oraArrayBind_data() { generic_data(); }
     void oraArrayBind();
     void lastInsertId_data() { generic_data(); }
@@ -203,6 +209,10 @@ private slots:
 
     void QTBUG_5251_data() { generic_data("QPSQL"); }
     void QTBUG_5251();
+    void psql_forwardOnlyStreaming_data() { generic_data("QPSQL"); }
+    void psql_forwardOnlyStreaming();
+    void psql_preparedBinaryResults_data() { generic_data("QPSQL"); }
+    void psql_preparedBinaryResults();
     void QTBUG_6421_data() { generic_data("QOCI"); }
     void QTBUG_6421();
     void QTBUG_6618_data() { generic_data("QODBC"); }
@@ -1360,6 +1370,113 @@ void tst_QSqlQuery::forwardOnly()
     QCOMPARE( q.at(), int( QSql::AfterLastRow ) );
 }
 
+void tst_QSqlQuery::typedValues()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    const QString tableName(qTableName("typedvalues", __FILE__));
+    tst_Databases::safeDropTable( db, tableName );
+
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int, big bigint, dbl double precision, txt varchar(20))" ) );
+    QVERIFY_SQL( q, exec( "insert into " + tableName + " values (1, 9000000000, 1.5, 'text1')" ) );
+    QVERIFY_SQL( q, exec( "insert into " + tableName + " values (2, -3, -0.25, '42')" ) );
+    QVERIFY_SQL( q, exec( "insert into " + tableName + " values (3, NULL, NULL, NULL)" ) );
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " values (4, 0, 0, ?)" ) );
+    q.addBindValue( QString::fromUtf8( "\xc3\xa6\xc3\xb8\xc3\xa5" ) );
+    QVERIFY_SQL( q, exec() );
+
+    for ( int forwardOnly = 0; forwardOnly < 2; ++forwardOnly ) {
+        q.setForwardOnly( forwardOnly );
+        QVERIFY_SQL( q, exec( "select id, big, dbl, txt from " + tableName + " order by id" ) );
+
+        bool ok = true;
+        QTest::ignoreMessage( QtWarningMsg, "QSqlQuery::value: not positioned on a valid record" );
+        QCOMPARE( q.valueInt( 0, &ok ), 0 );
+        QVERIFY( !ok );
+
+        QVERIFY( q.next() );
+        QCOMPARE( q.valueInt( 0, &ok ), 1 );
+        QVERIFY( ok );
+        QCOMPARE( q.valueLongLong( 1, &ok ), Q_INT64_C(9000000000) );
+        QVERIFY( ok );
+        QCOMPARE( q.valueInt( 1, &ok ), 0 );
+        QVERIFY( !ok );
+        QCOMPARE( q.valueDouble( 2, &ok ), 1.5 );
+        QVERIFY( ok );
+        QCOMPARE( q.valueUtf8( 3 ), QByteArray( "text1" ) );
+        q.valueInt( 3, &ok );
+        QVERIFY( !ok );
+        QCOMPARE( q.value( 3 ).toString(), QString( "text1" ) );
+        QCOMPARE( q.valueUtf8( 3 ), QByteArray( "text1" ) );
+
+        QVERIFY( q.next() );
+        QCOMPARE( q.valueInt( 0 ), 2 );
+        QCOMPARE( q.valueLongLong( 1 ), Q_INT64_C(-3) );
+        QCOMPARE( q.valueInt( 1 ), -3 );
+        QCOMPARE( q.valueDouble( 2 ), -0.25 );
+        QCOMPARE( q.valueInt( 3, &ok ), 42 );
+        QVERIFY( ok );
+        QCOMPARE( q.valueDouble( 0 ), 2.0 );
+
+        QVERIFY( q.next() );
+        QCOMPARE( q.valueInt( 0 ), 3 );
+        QCOMPARE( q.valueLongLong( 1, &ok ), Q_INT64_C(0) );
+        QVERIFY( !ok );
+        QCOMPARE( q.valueDouble( 2, &ok ), 0.0 );
+        QVERIFY( !ok );
+        QVERIFY( q.valueUtf8( 3 ).isNull() );
+        QVERIFY( q.isNull( 3 ) );
+
+        QVERIFY( q.next() );
+        QCOMPARE( q.valueUtf8( 3 ), QByteArray( "\xc3\xa6\xc3\xb8\xc3\xa5" ) );
+        QCOMPARE( QString::fromUtf8( q.valueUtf8( 3 ) ), q.value( 3 ).toString() );
+        QVERIFY( !q.isNull( 3 ) );
+
+        QVERIFY( !q.next() );
+        if ( !forwardOnly ) {
+            QVERIFY( q.first() );
+            QCOMPARE( q.valueLongLong( 1 ), Q_INT64_C(9000000000) );
+            QCOMPARE( q.valueUtf8( 3 ), QByteArray( "text1" ) );
+        }
+    }
+
+    // only integral text is an integer, NaN and infinities are doubles
+    if ( db.driverName().startsWith( "QSQLITE" ) || db.driverName().startsWith( "QPSQL" ) ) {
+        QVERIFY_SQL( q, exec( "insert into " + tableName + " values (5, 0, 'NaN', '12.5')" ) );
+        QVERIFY_SQL( q, exec( "insert into " + tableName + " values (6, 0, 'Infinity', '-Infinity')" ) );
+        QVERIFY_SQL( q, exec( "select dbl, txt from " + tableName + " where id >= 5 order by id" ) );
+
+        bool ok = false;
+        QVERIFY( q.next() );
+        QVERIFY( qIsNaN( q.valueDouble( 0, &ok ) ) );
+        QVERIFY( ok );
+        QCOMPARE( q.valueLongLong( 0, &ok ), Q_INT64_C(0) );
+        QVERIFY( !ok );
+        QCOMPARE( q.valueInt( 1, &ok ), 0 );
+        QVERIFY( !ok );
+        QCOMPARE( q.valueLongLong( 1, &ok ), Q_INT64_C(0) );
+        QVERIFY( !ok );
+        QCOMPARE( q.valueDouble( 1, &ok ), 12.5 );
+        QVERIFY( ok );
+
+        QVERIFY( q.next() );
+        double value = q.valueDouble( 0, &ok );
+        QVERIFY( qIsInf( value ) && value > 0 );
+        QVERIFY( ok );
+        q.valueInt( 0, &ok );
+        QVERIFY( !ok );
+        value = q.valueDouble( 1, &ok );
+        QVERIFY( qIsInf( value ) && value < 0 );
+        QVERIFY( ok );
+        q.valueLongLong( 1, &ok );
+        QVERIFY( !ok );
+    }
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
 void tst_QSqlQuery::query_exec()
 {
     QFETCH( QString, dbName );
@@ -2101,6 +2218,10 @@ void tst_QSqlQuery::batchExec()
 
     if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
         QSKIP( "Database can't do BatchOperations");
+    // the date column keeps the time of day and NULLs sort last here;
+    // batchExecNullsAndDates() covers the databases where they don't
+    if ( db.driverName().startsWith( "QSQLITE" ) || db.driverName().startsWith( "QPSQL" ) )
+        QSKIP( "Test relies on Oracle date and NULL ordering semantics");
 
     QSqlQuery q( db );
     const QString tableName = qTableName( "qtest_batch", __FILE__ );
@@ -2148,6 +2269,135 @@ void tst_QSqlQuery::batchExec()
     QVERIFY( q.value( 3 ).isNull() );
 }
 
+void tst_QSqlQuery::batchExecNullsAndDates()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
+        QSKIP( "Database can't do BatchOperations");
+
+    QSqlQuery q( db );
+    const QString tableName = qTableName( "qtest_batch_dates", __FILE__ );
+    tst_Databases::safeDropTable( db, tableName );
+
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int, name varchar(20), dt date, num numeric(8, 4))" ) );
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, name, dt, num) values (?, ?, ?, ?)" ) );
+
+    QVariantList intCol;
+    intCol << 1 << 2 << QVariant( QVariant::Int );
+
+    QVariantList charCol;
+    charCol << QLatin1String( "harald" ) << QLatin1String( "boris" ) << QVariant( QVariant::String );
+
+    QVariantList dateCol;
+    QDate dt = QDate::currentDate();
+    dateCol << dt << dt.addDays( -1 ) << QVariant( QVariant::Date );
+
+    QVariantList numCol;
+    numCol << 2.3 << 3.4 << QVariant( QVariant::Double );
+
+    q.addBindValue( intCol );
+    q.addBindValue( charCol );
+    q.addBindValue( dateCol );
+    q.addBindValue( numCol );
+
+    QVERIFY_SQL( q, execBatch() );
+    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName + " where id is not null order by id" ) );
+
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toInt(), 1 );
+    QCOMPARE( q.value( 1 ).toString(), QString( "harald" ) );
+    QCOMPARE( q.value( 2 ).toDate(), dt );
+    QCOMPARE( q.value( 3 ).toDouble(), 2.3 );
+
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toInt(), 2 );
+    QCOMPARE( q.value( 1 ).toString(), QString( "boris" ) );
+    QCOMPARE( q.value( 2 ).toDate(), dt.addDays( -1 ) );
+    QCOMPARE( q.value( 3 ).toDouble(), 3.4 );
+    QVERIFY( !q.next() );
+
+    // NULLs sort first on some databases and last on others
+    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName + " where id is null" ) );
+    QVERIFY( q.next() );
+    QVERIFY( q.value( 0 ).isNull() );
+    QVERIFY( q.value( 1 ).isNull() );
+    QVERIFY( q.value( 2 ).isNull() );
+    QVERIFY( q.value( 3 ).isNull() );
+
+    q.finish();
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::batchExecManyRows()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
+        QSKIP( "Database can't do BatchOperations");
+
+    QSqlQuery q( db );
+    const QString tableName = qTableName( "qtest_batchrows", __FILE__ );
+    tst_Databases::safeDropTable( db, tableName );
+
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int not null primary key, name varchar(20))" ) );
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, name) values (?, 'row ' || ?)" ) );
+
+    // more rows than a single statement takes on drivers that insert several rows at once
+    const int rowCount = 2500;
+    QVariantList ids, names;
+    for ( int i = 0; i < rowCount; ++i ) {
+        ids << i;
+        names << ( i % 100 ? QVariant( QString::number( i ) ) : QVariant( QVariant::String ) );
+    }
+    q.addBindValue( ids );
+    q.addBindValue( names );
+    QVERIFY_SQL( q, execBatch() );
+
+    QVERIFY_SQL( q, exec( "select count(*) from " + tableName + " where name is not null" ) );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toInt(), rowCount - rowCount / 100 );
+    QVERIFY_SQL( q, exec( "select name from " + tableName + " where id = 1234" ) );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toString(), QString( "row 1234" ) );
+
+    // statements other than inserts
+    QVERIFY_SQL( q, prepare( "update " + tableName + " set name = ? where id = ?" ) );
+    q.addBindValue( QVariantList() << QString( "first" ) << QString( "second" ) );
+    q.addBindValue( QVariantList() << 0 << 1 );
+    QVERIFY_SQL( q, execBatch() );
+    QVERIFY_SQL( q, exec( "select name from " + tableName + " where id < 2 order by id" ) );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toString(), QString( "first" ) );
+    QVERIFY( q.next() );
+    QCOMPARE( q.value( 0 ).toString(), QString( "second" ) );
+
+    // a failing row fails the whole batch
+    ids.clear();
+    names.clear();
+    for ( int i = 0; i < 10; ++i ) {
+        ids << ( i == 5 ? 0 : rowCount + i );
+        names << QString( "dup" );
+    }
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id, name) values (?, ?)" ) );
+    q.addBindValue( ids );
+    q.addBindValue( names );
+    QVERIFY( !q.execBatch() );
+    QVERIFY( q.lastError().isValid() );
+    if ( db.driverName().startsWith( "QSQLITE" ) || db.driverName().startsWith( "QPSQL" ) ) {
+        QVERIFY_SQL( q, exec( "select count(*) from " + tableName ) );
+        QVERIFY( q.next() );
+        QCOMPARE( q.value( 0 ).toInt(), rowCount );
+    }
+
+    q.finish();
+    tst_Databases::safeDropTable( db, tableName );
+}
+
 void tst_QSqlQuery::oraArrayBind()
 {
     QFETCH( QString, dbName );
@@ -2156,6 +2406,8 @@ void tst_QSqlQuery::oraArrayBind()
 
     if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
         QSKIP( "Database can't do BatchOperations");
+    if ( !db.driverName().startsWith( "QOCI" ) )
+        QSKIP( "Oracle specific test");
 
     QSqlQuery q( db );
 
@@ -3144,6 +3396,137 @@ void tst_QSqlQuery::QTBUG_5251()
 
 }
 
+void tst_QSqlQuery::psql_forwardOnlyStreaming()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, exec("SELECT x, 'row' || x FROM generate_series(1, 1000) AS x"));
+    QCOMPARE(q.record().count(), 2);
+    for (int i = 1; i <= 10; ++i) {
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), i);
+    }
+
+    // another statement needs the connection while rows are still pending
+    QSqlQuery q2(db);
+    QVERIFY_SQL(q2, exec("SELECT 42"));
+    QVERIFY(q2.next());
+    QCOMPARE(q2.value(0).toInt(), 42);
+
+    int expected = 11;
+    while (q.next()) {
+        QCOMPARE(q.value(0).toInt(), expected);
+        QCOMPARE(q.value(1).toString(), QString("row%1").arg(expected));
+        ++expected;
+    }
+    QCOMPARE(expected, 1001);
+    QCOMPARE(q.at(), int(QSql::AfterLastRow));
+
+    // abandon a result half way through
+    QVERIFY_SQL(q, exec("SELECT x FROM generate_series(1, 1000) AS x"));
+    QVERIFY(q.next());
+    QVERIFY_SQL(q, exec("SELECT x FROM generate_series(1, 3) AS x"));
+    QVERIFY(q.last());
+    QCOMPARE(q.at(), 2);
+    QCOMPARE(q.value(0).toInt(), 3);
+
+    QVERIFY_SQL(q, prepare("SELECT x FROM generate_series(1, ?) AS x"));
+    q.addBindValue(5);
+    QVERIFY_SQL(q, exec());
+    int rows = 0;
+    while (q.next())
+        ++rows;
+    QCOMPARE(rows, 5);
+
+    // an error in the middle of the result set is reported by next()
+    rows = 0;
+    if (q.exec("SELECT 1 / (500 - x) FROM generate_series(1, 1000) AS x")) {
+        while (q.next())
+            ++rows;
+        QCOMPARE(rows, 499);
+    }
+    QVERIFY(q.lastError().isValid());
+    QVERIFY_SQL(q, exec("SELECT 1"));
+    QVERIFY(q.next());
+}
+
+void tst_QSqlQuery::psql_preparedBinaryResults()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    const QString tableName(qTableName("binaryresults", __FILE__));
+    tst_Databases::safeDropTable( db, tableName );
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id int4, i2 int2, i8 int8, f4 float4, "
+                        "f8 float8, num numeric(20, 6), b bool, d date, t time, ts timestamp, "
+                        "ba bytea, txt text, vc varchar(20))"));
+
+    const QDateTime dateTime(QDate(1999, 12, 31), QTime(23, 59, 58, 250));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    q.addBindValue(1);
+    q.addBindValue(-12);
+    q.addBindValue(Q_INT64_C(-9000000000));
+    q.addBindValue(1.5);
+    q.addBindValue(-2.25e100);
+    q.addBindValue(QString("-12345.000125"));
+    q.addBindValue(true);
+    q.addBindValue(dateTime.date());
+    q.addBindValue(dateTime.time());
+    q.addBindValue(dateTime);
+    q.addBindValue(QByteArray("\0\x01\xff'\\", 5));
+    q.addBindValue(QString::fromUtf8("\xc3\xa6\xc3\xb8\xc3\xa5"));
+    q.addBindValue(QString("vc"));
+    QVERIFY_SQL(q, exec());
+
+    q.bindValue(0, 2);
+    for (int i = 1; i < 13; ++i)
+        q.bindValue(i, QVariant(QVariant::String));
+    QVERIFY_SQL(q, exec());
+
+    // the same values come back whether the rows are sent as text or binary
+    QSqlQuery text(db);
+    QVERIFY_SQL(text, exec("SELECT * FROM " + tableName + " ORDER BY id"));
+    QVERIFY_SQL(q, prepare("SELECT * FROM " + tableName + " WHERE id >= ? ORDER BY id"));
+    q.addBindValue(0);
+    QVERIFY_SQL(q, exec());
+    for (int row = 0; row < 2; ++row) {
+        QVERIFY(text.next());
+        QVERIFY(q.next());
+        for (int i = 0; i < 13; ++i) {
+            QCOMPARE(q.isNull(i), text.isNull(i));
+            QCOMPARE(q.value(i).type(), text.value(i).type());
+            QCOMPARE(q.value(i), text.value(i));
+        }
+    }
+    QVERIFY(!q.next());
+
+    QVERIFY_SQL(q, exec());
+    QVERIFY(q.next());
+    QCOMPARE(q.value(1).toInt(), -12);
+    QCOMPARE(q.value(2).toLongLong(), Q_INT64_C(-9000000000));
+    QCOMPARE(q.value(4).toDouble(), -2.25e100);
+    QCOMPARE(q.value(5).toString(), QString("-12345.000125"));
+    QCOMPARE(q.value(9).toDateTime(), dateTime);
+    QCOMPARE(q.value(10).toByteArray(), QByteArray("\0\x01\xff'\\", 5));
+    QCOMPARE(q.value(11).toString(), QString::fromUtf8("\xc3\xa6\xc3\xb8\xc3\xa5"));
+
+    q.setNumericalPrecisionPolicy(QSql::LowPrecisionDouble);
+    QVERIFY_SQL(q, prepare("SELECT num, num * 0, -num / 100000000000 FROM " + tableName + " WHERE id = 1"));
+    QVERIFY_SQL(q, exec());
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toDouble(), -12345.000125);
+    QCOMPARE(q.value(1).toDouble(), 0.0);
+    QVERIFY(qAbs(q.value(2).toDouble() - 0.00000012345000125) < 1e-20);
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
 void tst_QSqlQuery::QTBUG_6421()
 {
     QFETCH( QString, dbName );
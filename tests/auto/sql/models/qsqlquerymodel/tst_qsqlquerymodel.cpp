@@ -83,6 +83,8 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void fetchInBackground_data() { generic_data(); }
+    void fetchInBackground();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -499,6 +501,60 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::fetchInBackground()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    if (!db.driverName().startsWith("QSQLITE") && !db.driverName().startsWith("QPSQL")
+            && !db.driverName().startsWith("QMYSQL"))
+        QSKIP("Fetching in the background is not supported by this driver");
+    if (db.databaseName() == ":memory:")
+        QSKIP("In-memory databases cannot be shared with another connection");
+
+    QSqlQueryModel model;
+    model.setFetchInBackground(true);
+    model.setCacheSize(512);
+    QVERIFY(model.fetchInBackground());
+    QCOMPARE(model.cacheSize(), 512);
+
+    QSignalSpy dataChangedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    model.setQuery("select id, name from " + qTableName("many", __FILE__) + " order by id", db);
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+    QCOMPARE(model.columnCount(), 2);
+    QVERIFY(!model.canFetchMore());
+
+    // the rows come in while the event loop runs
+    QTRY_COMPARE(model.rowCount(), 2048);
+    QVERIFY(!dataChangedSpy.isEmpty());
+
+    // a placeholder until the block holding the row has been read
+    QVERIFY(!model.data(model.index(1500, 0)).isValid());
+    QTRY_COMPARE(model.data(model.index(1500, 0)).toInt(), 1500);
+    QCOMPARE(model.data(model.index(1500, 1)).toString(), QString("harry"));
+    QCOMPARE(model.record(1500).value(0).toInt(), 1500);
+
+    // more rows than the cache holds, going back evicted rows are read again
+    for (int row = 0; row < 2048; row += 200)
+        QTRY_COMPARE(model.data(model.index(row, 0)).toInt(), row);
+    for (int row = 2047; row >= 0; row -= 300)
+        QTRY_COMPARE(model.data(model.index(row, 0)).toInt(), row);
+
+    model.setQuery("select id from " + qTableName("many", __FILE__) + " where id < 10 order by id", db);
+    QCOMPARE(model.columnCount(), 1);
+    QTRY_COMPARE(model.rowCount(), 10);
+    QTRY_COMPARE(model.data(model.index(9, 0)).toInt(), 9);
+
+    model.setQuery("select nonexistent from " + qTableName("many", __FILE__), db);
+    QVERIFY(model.lastError().isValid());
+    QCOMPARE(model.rowCount(), 0);
+
+    // a QSqlQuery is never fetched in the background
+    model.setQuery(QSqlQuery("select id from " + qTableName("many", __FILE__) + " order by id", db));
+    QVERIFY(!model.lastError().isValid());
+    QCOMPARE(model.data(model.index(0, 0)).toInt(), 0);
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
@@ -83,6 +83,8 @@ private slots:
     void insertColumns();
     void submitAll_data() { generic_data(); }
     void submitAll();
+    void submitAllBatched_data() { generic_data(); }
+    void submitAllBatched();
     void setData_data()  { generic_data(); }
     void setData();
     void setRecord_data()  { generic_data(); }
@@ -1068,6 +1070,87 @@ void tst_QSqlTableModel::submitAll()
     QCOMPARE(model.data(model.index(1, 1)).toString(), QString("trond"));
 }
 
+void tst_QSqlTableModel::submitAllBatched()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QString tbl = qTableName("pktest", __FILE__);
+    QSqlQuery q(db);
+    q.exec("DELETE FROM " + tbl);
+    for (int i = 0; i < 20; ++i)
+        QVERIFY_SQL(q, exec(QString("INSERT INTO %1 (id, a) VALUES (%2, 'x%2')").arg(tbl).arg(i)));
+
+    QSqlTableModel model(0, db);
+    model.setEditStrategy(QSqlTableModel::OnManualSubmit);
+    model.setTable(tbl);
+    model.setSort(0, Qt::AscendingOrder);
+    QVERIFY_SQL(model, select());
+    QCOMPARE(model.rowCount(), 20);
+
+    // updates only: the written values are kept, the model is not reset
+    for (int i = 0; i < 20; ++i)
+        QVERIFY(model.setData(model.index(i, 1), QString("y%1").arg(i)));
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy dataChangedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QVERIFY_SQL(model, submitAll());
+    QVERIFY(!model.isDirty());
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(dataChangedSpy.count(), 20);
+    QCOMPARE(model.data(model.index(7, 1)).toString(), QString("y7"));
+
+    QVERIFY_SQL(q, exec("SELECT id, a FROM " + tbl + " ORDER BY id"));
+    for (int i = 0; i < 20; ++i) {
+        QVERIFY(q.next());
+        QCOMPARE(q.value(1).toString(), QString("y%1").arg(i));
+    }
+    QVERIFY(!q.next());
+
+    // inserts and deletes repopulate the model
+    for (int i = 20; i < 25; ++i) {
+        QSqlRecord rec = model.record();
+        rec.setValue(0, i);
+        rec.setValue(1, QString("z%1").arg(i));
+        QVERIFY(model.insertRecord(-1, rec));
+    }
+    QVERIFY(model.removeRows(0, 2));
+    QVERIFY(model.setData(model.index(2, 1), "changed"));
+    QVERIFY_SQL(model, submitAll());
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 23);
+    QCOMPARE(model.data(model.index(0, 0)).toInt(), 2);
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("changed"));
+    QCOMPARE(model.data(model.index(22, 1)).toString(), QString("z24"));
+
+    // a transaction started by the caller is used as it is
+    if (db.driver()->hasFeature(QSqlDriver::Transactions)) {
+        QVERIFY_SQL(db, transaction());
+        QVERIFY(model.setData(model.index(1, 1), "rolledback"));
+        QVERIFY_SQL(model, submitAll());
+        QVERIFY_SQL(db, rollback());
+        QVERIFY_SQL(model, select());
+        QCOMPARE(model.data(model.index(1, 1)).toString(), QString("y3"));
+    }
+
+    // a failing row makes the whole submit fail and keeps the changes
+    QSqlRecord rec = model.record();
+    rec.setValue(0, 5);
+    rec.setValue(1, "duplicate");
+    QVERIFY(model.setData(model.index(0, 1), "lost"));
+    QVERIFY(model.insertRecord(-1, rec));
+    QFAIL_SQL(model, submitAll());
+    QVERIFY(model.isDirty());
+    if (db.driver()->hasFeature(QSqlDriver::Transactions)) {
+        QVERIFY_SQL(q, exec("SELECT a FROM " + tbl + " WHERE id = 2"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QString("changed"));
+    }
+
+    model.revertAll();
+    QVERIFY_SQL(q, exec("DELETE FROM " + tbl));
+}
+
 void tst_QSqlTableModel::removeRow()
 {
     QFETCH(QString, dbName);
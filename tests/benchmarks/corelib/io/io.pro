@@ -1,10 +1,13 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qdatastream \
         qdir \
         qdiriterator \
         qfile \
+        qfilesystemwatcher \
         #qfileinfo \    # FIXME: broken
         qiodevice \
         qprocess \
         qtemporaryfile
 
+contains(QT_CONFIG,private_tests):SUBDIRS += qasyncfile qcompressor qsettings
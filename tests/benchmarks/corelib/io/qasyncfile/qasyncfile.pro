@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qasyncfile
+QT = core core-private testlib
+
+SOURCES += tst_qasyncfile.cpp
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QAsyncFile>
+#include <QtCore/QTemporaryDir>
+#include <private/qasyncfile_p.h>
+
+class tst_QAsyncFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void randomReads_data();
+    void randomReads();
+
+private:
+    QTemporaryDir tempDir;
+    QString fileName;
+    QVector<qint64> offsets;
+};
+
+static const qint64 FileSize = Q_INT64_C(128) * 1024 * 1024;
+static const int BlockSize = 4096;
+static const int ReadCount = 4096;
+
+void tst_QAsyncFile::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    fileName = tempDir.path() + QLatin1String("/large");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QByteArray chunk(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < chunk.size(); ++i)
+        chunk[i] = char(i * 31);
+    for (qint64 written = 0; written < FileSize; written += chunk.size())
+        QCOMPARE(file.write(chunk), qint64(chunk.size()));
+    file.close();
+
+    qsrand(42);
+    offsets.reserve(ReadCount);
+    for (int i = 0; i < ReadCount; ++i)
+        offsets << (qint64(qrand()) * qrand()) % (FileSize / BlockSize) * BlockSize;
+}
+
+void tst_QAsyncFile::randomReads_data()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("QFile") << QString::fromLatin1("QFile");
+    QTest::newRow("threadpool") << QString::fromLatin1("threadpool");
+#ifdef QT_ASYNCFILE_IO_URING
+    if (QAsyncFileBackend::ioUringBackend())
+        QTest::newRow("io_uring") << QString::fromLatin1("io_uring");
+#endif
+}
+
+// ReadCount random 4 KB reads, all of them in flight at the same time for
+// QAsyncFile, one after the other for QFile.
+void tst_QAsyncFile::randomReads()
+{
+    QFETCH(QString, backend);
+    qint64 total = 0;
+
+    if (backend == QLatin1String("QFile")) {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+        QByteArray buffer(BlockSize, Qt::Uninitialized);
+        QBENCHMARK {
+            total = 0;
+            for (int i = 0; i < ReadCount; ++i) {
+                file.seek(offsets.at(i));
+                total += file.read(buffer.data(), BlockSize);
+            }
+        }
+    } else {
+        QAsyncFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        if (backend == QLatin1String("threadpool"))
+            QAsyncFilePrivate::get(&file)->backend = QAsyncFileBackend::threadPoolBackend();
+#ifdef QT_ASYNCFILE_IO_URING
+        else
+            QAsyncFilePrivate::get(&file)->backend = QAsyncFileBackend::ioUringBackend();
+#endif
+
+        QVector<QFuture<QByteArray> > reads(ReadCount);
+        QBENCHMARK {
+            total = 0;
+            for (int i = 0; i < ReadCount; ++i)
+                reads[i] = file.read(offsets.at(i), BlockSize);
+            for (int i = 0; i < ReadCount; ++i)
+                total += reads[i].result().size();
+        }
+    }
+    QCOMPARE(total, qint64(ReadCount) * BlockSize);
+}
+
+QTEST_MAIN(tst_QAsyncFile)
+
+#include "tst_qasyncfile.moc"
@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QIODevice>
+#include <QBuffer>
+#include <QByteArray>
+
+#include <qtest.h>
+
+#include <private/qcompressor_p.h>
+#include <private/qbytedata_p.h>
+
+// Produces 'size' bytes of text-like data without keeping them in memory,
+// so that gigabyte sized streams can be pushed through the (de)compressor.
+class GeneratorDevice : public QIODevice
+{
+public:
+    GeneratorDevice(qint64 size)
+        : remaining(size), offset(0)
+    {
+        static const char * const words[] = {
+            "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+            "elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore"
+        };
+        const int wordCount = sizeof words / sizeof words[0];
+        quint32 seed = 42;
+        while (pattern.size() < 256 * 1024) {
+            seed = seed * 1103515245 + 12345;
+            pattern += words[(seed >> 16) % wordCount];
+            pattern += ((seed >> 8) & 7) ? ' ' : '\n';
+        }
+        pattern.truncate(256 * 1024);
+        open(ReadOnly);
+    }
+
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const { return remaining + QIODevice::bytesAvailable(); }
+    bool atEnd() const { return remaining == 0 && QIODevice::atEnd(); }
+
+    const QByteArray &block() const { return pattern; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize)
+    {
+        if (remaining == 0)
+            return -1;
+        qint64 total = qMin(maxSize, remaining);
+        qint64 done = 0;
+        while (done < total) {
+            const qint64 chunk = qMin<qint64>(total - done, pattern.size() - offset);
+            memcpy(data + done, pattern.constData() + offset, chunk);
+            done += chunk;
+            offset = (offset + chunk) % pattern.size();
+        }
+        remaining -= total;
+        return total;
+    }
+
+    qint64 writeData(const char *, qint64) { return -1; }
+
+private:
+    QByteArray pattern;
+    qint64 remaining;
+    qint64 offset;
+};
+
+// Counts what is written to it and throws the data away.
+class NullDevice : public QIODevice
+{
+public:
+    NullDevice() : written(0) { open(WriteOnly); }
+    qint64 written;
+
+protected:
+    qint64 readData(char *, qint64) { return -1; }
+    qint64 writeData(const char *, qint64 size) { written += size; return size; }
+};
+
+class tst_qcompressor : public QObject
+{
+    Q_OBJECT
+private slots:
+    void compressDevice_data() { size_data(); }
+    void compressDevice();
+    void compressBuffer_data() { size_data(); }
+    void compressBuffer();
+    void decompressDevice_data() { size_data(); }
+    void decompressDevice();
+    void decompressBuffer_data() { size_data(); }
+    void decompressBuffer();
+    void qUncompressBaseline_data();
+    void qUncompressBaseline();
+
+private:
+    void size_data();
+    QByteArray compressedStream(qint64 size);
+};
+
+void tst_qcompressor::size_data()
+{
+    QTest::addColumn<qint64>("size");
+    QTest::newRow("1000k")    << qint64(1000 * 1024);
+    QTest::newRow("100000k")  << qint64(100000 * 1024);
+    QTest::newRow("1000000k") << qint64(1000000 * 1024);
+}
+
+QByteArray tst_qcompressor::compressedStream(qint64 size)
+{
+    GeneratorDevice input(size);
+    QCompressor compressor(&input, QCompressor::GzipFormat);
+    compressor.open(QIODevice::ReadOnly);
+    QByteArray result;
+    char buffer[64 * 1024];
+    qint64 read;
+    while ((read = compressor.read(buffer, sizeof buffer)) > 0)
+        result.append(buffer, read);
+    return result;
+}
+
+// pull mode: reading from a compressor wrapped around the source device
+void tst_qcompressor::compressDevice()
+{
+    QFETCH(qint64, size);
+
+    qint64 total = 0;
+    QBENCHMARK {
+        GeneratorDevice input(size);
+        QCompressor compressor(&input, QCompressor::GzipFormat);
+        QVERIFY(compressor.open(QIODevice::ReadOnly));
+        char buffer[64 * 1024];
+        qint64 read;
+        total = 0;
+        while ((read = compressor.read(buffer, sizeof buffer)) > 0)
+            total += read;
+    }
+    QVERIFY(total > 0);
+    QVERIFY(total < size);
+}
+
+// push mode: feeding chunks as they would arrive from a socket
+void tst_qcompressor::compressBuffer()
+{
+    QFETCH(qint64, size);
+
+    qint64 total = 0;
+    QBENCHMARK {
+        GeneratorDevice input(size);
+        QCompressor compressor(QCompressor::GzipFormat);
+        QByteDataBuffer output;
+        char buffer[16 * 1024];
+        qint64 read;
+        total = 0;
+        while ((read = input.read(buffer, sizeof buffer)) > 0) {
+            QVERIFY(compressor.compress(buffer, read, &output));
+            total += output.byteAmount();
+            output.clear();
+        }
+        QVERIFY(compressor.finish(&output));
+        total += output.byteAmount();
+    }
+    QVERIFY(total > 0);
+    QVERIFY(total < size);
+}
+
+void tst_qcompressor::decompressDevice()
+{
+    QFETCH(qint64, size);
+
+    const QByteArray compressed = compressedStream(size);
+    qint64 total = 0;
+    QBENCHMARK {
+        QByteArray data = compressed;
+        QBuffer source(&data);
+        source.open(QIODevice::ReadOnly);
+        QDecompressor decompressor(&source);
+        QVERIFY(decompressor.open(QIODevice::ReadOnly));
+        NullDevice sink;
+        char buffer[64 * 1024];
+        qint64 read;
+        while ((read = decompressor.read(buffer, sizeof buffer)) > 0)
+            sink.write(buffer, read);
+        total = sink.written;
+    }
+    QCOMPARE(total, size);
+}
+
+void tst_qcompressor::decompressBuffer()
+{
+    QFETCH(qint64, size);
+
+    const QByteArray compressed = compressedStream(size);
+    qint64 total = 0;
+    QBENCHMARK {
+        QDecompressor decompressor;
+        QByteDataBuffer output;
+        const int chunkSize = 16 * 1024;
+        total = 0;
+        for (int i = 0; i < compressed.size(); i += chunkSize) {
+            QVERIFY(decompressor.decompress(compressed.constData() + i,
+                                            qMin(chunkSize, compressed.size() - i), &output));
+            total += output.byteAmount();
+            output.clear();
+        }
+        QVERIFY(decompressor.atEnd());
+    }
+    QCOMPARE(total, size);
+}
+
+void tst_qcompressor::qUncompressBaseline_data()
+{
+    QTest::addColumn<qint64>("size");
+    QTest::newRow("1000k")    << qint64(1000 * 1024);
+    QTest::newRow("100000k")  << qint64(100000 * 1024);
+}
+
+// qCompress()/qUncompress() need the whole stream in memory, which is
+// exactly what QCompressor avoids; kept for comparing raw throughput.
+void tst_qcompressor::qUncompressBaseline()
+{
+    QFETCH(qint64, size);
+
+    GeneratorDevice input(size);
+    const QByteArray compressed = qCompress(input.readAll());
+    qint64 total = 0;
+    QBENCHMARK {
+        total = qUncompress(compressed).size();
+    }
+    QCOMPARE(total, size);
+}
+
+QTEST_MAIN(tst_qcompressor)
+
+#include "main.moc"
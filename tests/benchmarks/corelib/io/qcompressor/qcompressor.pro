@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qcompressor
+
+QT = core core-private testlib
+
+CONFIG += release
+
+SOURCES += main.cpp
@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDataStream>
+#include <QVector>
+
+#include <qtest.h>
+
+class tst_QDataStream : public QObject
+{
+    Q_OBJECT
+private slots:
+    void writeVector_data();
+    void writeVector();
+    void readVector_data();
+    void readVector();
+    void readByteArray_data();
+    void readByteArray();
+
+private:
+    void addVectorData();
+};
+
+enum ElementType { Int32, Float, Double };
+enum Method { Elementwise, Vector };
+
+Q_DECLARE_METATYPE(QDataStream::ByteOrder)
+
+static const int ElementCount = 1000000;
+
+template <typename T>
+static void writeElements(QDataStream &stream, const QVector<T> &vector, Method method)
+{
+    if (method == Vector) {
+        stream << vector;
+    } else {
+        // what operator<<() did before it wrote arrays in bulk
+        stream << quint32(vector.size());
+        for (int i = 0; i < vector.size(); ++i)
+            stream << vector.at(i);
+    }
+}
+
+template <typename T>
+static void readElements(QDataStream &stream, QVector<T> &vector, Method method)
+{
+    if (method == Vector) {
+        stream >> vector;
+    } else {
+        vector.clear();
+        quint32 count;
+        stream >> count;
+        vector.resize(count);
+        for (quint32 i = 0; i < count; ++i)
+            stream >> vector[i];
+    }
+}
+
+void tst_QDataStream::addVectorData()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("method");
+    QTest::addColumn<QDataStream::ByteOrder>("byteOrder");
+
+    const char *typeNames[] = { "qint32", "float", "double" };
+    for (int type = Int32; type <= Double; ++type) {
+        for (int method = Elementwise; method <= Vector; ++method) {
+            for (int order = 0; order < 2; ++order) {
+                const QDataStream::ByteOrder byteOrder = order ? QDataStream::LittleEndian : QDataStream::BigEndian;
+                const QByteArray name = QByteArray(typeNames[type])
+                        + (method == Vector ? ", vector" : ", elementwise")
+                        + (byteOrder == QDataStream::BigEndian ? ", big endian" : ", little endian");
+                QTest::newRow(name) << type << method << byteOrder;
+            }
+        }
+    }
+}
+
+void tst_QDataStream::writeVector_data()
+{
+    addVectorData();
+}
+
+void tst_QDataStream::writeVector()
+{
+    QFETCH(int, type);
+    QFETCH(int, method);
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+
+    const QVector<qint32> ints(ElementCount, 0x01020304);
+    const QVector<float> floats(ElementCount, 1.5f);
+    const QVector<double> doubles(ElementCount, 2.5);
+    QByteArray data;
+    data.reserve(ElementCount * sizeof(double) + 4);
+
+    QBENCHMARK {
+        data.resize(0);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        QDataStream stream(&buffer);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(type == Float ? QDataStream::SinglePrecision
+                                                       : QDataStream::DoublePrecision);
+        if (type == Int32)
+            writeElements(stream, ints, Method(method));
+        else if (type == Float)
+            writeElements(stream, floats, Method(method));
+        else
+            writeElements(stream, doubles, Method(method));
+    }
+}
+
+void tst_QDataStream::readVector_data()
+{
+    addVectorData();
+}
+
+void tst_QDataStream::readVector()
+{
+    QFETCH(int, type);
+    QFETCH(int, method);
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(type == Float ? QDataStream::SinglePrecision
+                                                       : QDataStream::DoublePrecision);
+        if (type == Int32)
+            stream << QVector<qint32>(ElementCount, 0x01020304);
+        else if (type == Float)
+            stream << QVector<float>(ElementCount, 1.5f);
+        else
+            stream << QVector<double>(ElementCount, 2.5);
+    }
+
+    QVector<qint32> ints;
+    QVector<float> floats;
+    QVector<double> doubles;
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QDataStream stream(&buffer);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(type == Float ? QDataStream::SinglePrecision
+                                                       : QDataStream::DoublePrecision);
+        if (type == Int32)
+            readElements(stream, ints, Method(method));
+        else if (type == Float)
+            readElements(stream, floats, Method(method));
+        else
+            readElements(stream, doubles, Method(method));
+    }
+}
+
+void tst_QDataStream::readByteArray_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("1 kB") << 1024;
+    QTest::newRow("64 kB") << 64 * 1024;
+    QTest::newRow("4 MB") << 4 * 1024 * 1024;
+}
+
+void tst_QDataStream::readByteArray()
+{
+    QFETCH(int, size);
+
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        for (int i = 0; i < 16; ++i)
+            stream << QByteArray(size, 'a' + i);
+    }
+
+    QByteArray array;
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QDataStream stream(&buffer);
+        for (int i = 0; i < 16; ++i)
+            stream >> array;
+    }
+}
+
+QTEST_MAIN(tst_QDataStream)
+
+#include "main.moc"
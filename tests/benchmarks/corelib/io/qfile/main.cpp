@@ -42,6 +42,7 @@
 #include <QDebug>
 #include <QTemporaryFile>
 #include <QString>
+#include <QTextStream>
 #include <QDirIterator>
 
 #include <private/qfsfileengine_p.h>
@@ -87,6 +88,11 @@ public:
         PosixBenchmark,
         QFileFromPosixBenchmark
     };
+    enum LineReader {
+        QFileReadLine,
+        QTextStreamReadLine,
+        QTextStreamReadLineInto
+    };
 private slots:
     void initTestCase();
     void cleanupTestCase();
@@ -116,6 +122,9 @@ private slots:
     void readBigFile_posix();
     void readBigFile_Win32();
 
+    void readLines_data();
+    void readLines();
+
 private:
     void readBigFile_data(BenchmarkType type, QIODevice::OpenModeFlag t, QIODevice::OpenModeFlag b);
     void readBigFile();
@@ -123,6 +132,7 @@ private:
     void readSmallFiles();
     void createFile();
     void fillFile(int factor=FACTOR);
+    void fillLines(int factor=FACTOR);
     void removeFile();
     void createSmallFiles();
     void removeSmallFiles();
@@ -131,6 +141,7 @@ private:
 };
 
 Q_DECLARE_METATYPE(tst_qfile::BenchmarkType)
+Q_DECLARE_METATYPE(tst_qfile::LineReader)
 Q_DECLARE_METATYPE(QIODevice::OpenMode)
 Q_DECLARE_METATYPE(QIODevice::OpenModeFlag)
 
@@ -167,6 +178,22 @@ void tst_qfile::fillFile(int factor)
     QTest::qSleep(2000);
 }
 
+void tst_qfile::fillLines(int factor)
+{
+    // rows of 80 columns with a few non-ASCII characters, like a log file
+    QFile tmpFile(filename);
+    tmpFile.open(QIODevice::WriteOnly);
+    QByteArray row(80, ' ');
+    for (int i = 0; i < factor; ++i) {
+        row.fill('0' + i % ('z' - '0'));
+        if (i % 16 == 0)
+            row.replace(40, 2, "\xc3\xa9");
+        tmpFile.write(row.constData(), 80);
+        tmpFile.write("\n");
+    }
+    tmpFile.close();
+}
+
 void tst_qfile::initTestCase()
 {
 }
@@ -716,6 +743,66 @@ void tst_qfile::readSmallFiles()
     delete[] buffer;
 }
 
+void tst_qfile::readLines_data()
+{
+    QTest::addColumn<tst_qfile::LineReader>("reader");
+    QTest::addColumn<QByteArray>("codec");
+    QTest::addColumn<QFile::OpenModeFlag>("textMode");
+
+    QTest::newRow("QFile::readLine") << QFileReadLine << QByteArray() << QIODevice::NotOpen;
+    QTest::newRow("QFile::readLine, Text") << QFileReadLine << QByteArray() << QIODevice::Text;
+    QTest::newRow("readLine, UTF-8") << QTextStreamReadLine << QByteArray("UTF-8") << QIODevice::NotOpen;
+    QTest::newRow("readLine, Latin-1") << QTextStreamReadLine << QByteArray("ISO-8859-1") << QIODevice::NotOpen;
+    QTest::newRow("readLine, UTF-8, Text") << QTextStreamReadLine << QByteArray("UTF-8") << QIODevice::Text;
+    QTest::newRow("readLineInto, UTF-8") << QTextStreamReadLineInto << QByteArray("UTF-8") << QIODevice::NotOpen;
+    QTest::newRow("readLineInto, Latin-1") << QTextStreamReadLineInto << QByteArray("ISO-8859-1") << QIODevice::NotOpen;
+    QTest::newRow("readLineInto, UTF-8, Text") << QTextStreamReadLineInto << QByteArray("UTF-8") << QIODevice::Text;
+}
+
+void tst_qfile::readLines()
+{
+    QFETCH(tst_qfile::LineReader, reader);
+    QFETCH(QByteArray, codec);
+    QFETCH(QFile::OpenModeFlag, textMode);
+
+    createFile();
+    fillLines(FACTOR / 4);
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly | textMode));
+    int lines = 0;
+    QBENCHMARK {
+        lines = 0;
+        file.reset();
+        switch (reader) {
+        case QFileReadLine: {
+            char buffer[128];
+            while (file.readLine(buffer, sizeof(buffer)) > 0)
+                ++lines;
+            break;
+        }
+        case QTextStreamReadLine: {
+            QTextStream stream(&file);
+            stream.setCodec(codec);
+            while (!stream.readLine().isNull())
+                ++lines;
+            break;
+        }
+        case QTextStreamReadLineInto: {
+            QTextStream stream(&file);
+            stream.setCodec(codec);
+            QString line;
+            while (stream.readLineInto(&line))
+                ++lines;
+            break;
+        }
+        }
+    }
+    QCOMPARE(lines, FACTOR / 4);
+    file.close();
+    removeFile();
+}
+
 QTEST_MAIN(tst_qfile)
 
 #include "main.moc"
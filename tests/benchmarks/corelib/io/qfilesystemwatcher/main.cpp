@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QSignalSpy>
+#include <QStringList>
+#include <QTemporaryDir>
+
+#include <qtest.h>
+
+class tst_QFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void addPaths_data();
+    void addPaths();
+    void removePaths_data() { addPaths_data(); }
+    void removePaths();
+    void addRecursivePath();
+    void deliverChanges_data() { addPaths_data(); }
+    void deliverChanges();
+
+private:
+    QStringList directories(int count) const;
+
+    QTemporaryDir tree;
+    QStringList allDirectories;
+    int watchLimit;
+};
+
+// The tree is Fanout x Fanout directories below the root. Watching 500,000
+// directories needs a larger Fanout and a fs.inotify.max_user_watches of at
+// least that size; rows that exceed the limit of the system are skipped.
+static const int Fanout = 200;
+
+void tst_QFileSystemWatcher::initTestCase()
+{
+    watchLimit = -1;
+#ifdef Q_OS_LINUX
+    QFile limitFile(QStringLiteral("/proc/sys/fs/inotify/max_user_watches"));
+    if (limitFile.open(QIODevice::ReadOnly))
+        watchLimit = limitFile.readAll().trimmed().toInt();
+#endif
+
+    QVERIFY(tree.isValid());
+    QDir root(tree.path());
+    for (int i = 0; i < Fanout; ++i) {
+        const QString top = QString::number(i);
+        QVERIFY(root.mkdir(top));
+        allDirectories.append(root.filePath(top));
+    }
+    for (int i = 0; i < Fanout; ++i) {
+        for (int j = 0; j < Fanout; ++j) {
+            const QString sub = QString::number(i) + QLatin1Char('/') + QString::number(j);
+            QVERIFY(root.mkdir(sub));
+            allDirectories.append(root.filePath(sub));
+        }
+    }
+}
+
+// returns the root and count - 1 directories below it
+QStringList tst_QFileSystemWatcher::directories(int count) const
+{
+    return QStringList() << tree.path() << allDirectories.mid(0, count - 1);
+}
+
+void tst_QFileSystemWatcher::addPaths_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("40000") << 40000;
+}
+
+#define SKIP_IF_OVER_LIMIT(count) \
+    if (watchLimit >= 0 && count + 100 > watchLimit) \
+        QSKIP("The system's limit on watched paths is too low")
+
+void tst_QFileSystemWatcher::addPaths()
+{
+    QFETCH(int, count);
+    SKIP_IF_OVER_LIMIT(count);
+    const QStringList paths = directories(count);
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(paths).isEmpty());
+    }
+}
+
+void tst_QFileSystemWatcher::removePaths()
+{
+    QFETCH(int, count);
+    SKIP_IF_OVER_LIMIT(count);
+    const QStringList paths = directories(count);
+
+    QFileSystemWatcher watcher;
+    QBENCHMARK {
+        QVERIFY(watcher.addPaths(paths).isEmpty());
+        QVERIFY(watcher.removePaths(paths).isEmpty());
+    }
+}
+
+void tst_QFileSystemWatcher::addRecursivePath()
+{
+    SKIP_IF_OVER_LIMIT(allDirectories.count() + 1);
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addRecursivePath(tree.path()));
+    }
+}
+
+void tst_QFileSystemWatcher::deliverChanges()
+{
+    QFETCH(int, count);
+    SKIP_IF_OVER_LIMIT(count);
+    const QStringList paths = directories(count);
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addPaths(paths).isEmpty());
+    QSignalSpy spy(&watcher, SIGNAL(directoryChanged(QString)));
+
+    // touch 1000 watched directories and wait until each one was reported
+    QStringList touched;
+    for (int i = 0; i < 1000; ++i)
+        touched.append(paths.at(i * (count / 1000)) + QStringLiteral("/touched"));
+
+    QBENCHMARK {
+        foreach (const QString &path, touched) {
+            QFile file(path);
+            file.open(QIODevice::WriteOnly);
+            file.close();
+            file.remove();
+        }
+        QSet<QString> reported;
+        while (reported.size() < touched.count()) {
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+            for (int i = 0; i < spy.count(); ++i)
+                reported.insert(spy.at(i).first().toString());
+            spy.clear();
+        }
+    }
+}
+
+QTEST_MAIN(tst_QFileSystemWatcher)
+
+#include "main.moc"
@@ -50,6 +50,10 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+#ifdef Q_OS_UNIX
+    void spawnRate_data();
+    void spawnRate();
+#endif
 
 #endif // QT_NO_PROCESS
 };
@@ -103,6 +107,37 @@ void tst_QProcess::echoTest_performance()
 }
 #endif // Q_OS_WINCE
 
+#ifdef Q_OS_UNIX
+void tst_QProcess::spawnRate_data()
+{
+    QTest::addColumn<int>("residentMegabytes");
+
+    QTest::newRow("small parent") << 0;
+    QTest::newRow("256 MB parent") << 256;
+    QTest::newRow("1 GB parent") << 1024;
+}
+
+// The cost of starting a child used to grow with the memory the parent had
+// mapped, since fork() copies its page tables.
+void tst_QProcess::spawnRate()
+{
+    QFETCH(int, residentMegabytes);
+
+    QByteArray ballast;
+    ballast.fill('x', residentMegabytes * 1024 * 1024);
+
+    QBENCHMARK {
+        for (int i = 0; i < 50; ++i) {
+            QProcess process;
+            process.start(QLatin1String("/bin/true"));
+            QVERIFY(process.waitForFinished());
+            QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+            QCOMPARE(process.exitCode(), 0);
+        }
+    }
+}
+#endif // Q_OS_UNIX
+
 #endif // QT_NO_PROCESS
 
 QTEST_MAIN(tst_QProcess)
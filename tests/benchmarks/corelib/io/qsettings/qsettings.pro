@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qsettings
+QT = core core-private testlib
+
+SOURCES += tst_qsettings.cpp
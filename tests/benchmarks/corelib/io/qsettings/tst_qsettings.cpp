@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+#include <private/qsettings_p.h>
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void openAndReadKey_data();
+    void openAndReadKey();
+    void setValueAndSync_data();
+    void setValueAndSync();
+
+private:
+    void populateFormats();
+    QString fileName(QSettings::Format format) const;
+
+    QTemporaryDir tempDir;
+};
+
+static const int KeyCount = 20000;
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+
+    const QSettings::Format formats[] = { QSettings::IniFormat, QSettings::IndexedFormat };
+    for (int f = 0; f < 2; ++f) {
+        QSettings settings(fileName(formats[f]), formats[f]);
+        for (int i = 0; i < KeyCount; ++i)
+            settings.setValue(QString::fromLatin1("group%1/key%2").arg(i % 100).arg(i),
+                              QString::fromLatin1("value %1").arg(i));
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+}
+
+QString tst_QSettings::fileName(QSettings::Format format) const
+{
+    return tempDir.path() + (format == QSettings::IniFormat ? "/bench.ini" : "/bench.qsi");
+}
+
+void tst_QSettings::populateFormats()
+{
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("ini") << int(QSettings::IniFormat);
+    QTest::newRow("indexed") << int(QSettings::IndexedFormat);
+}
+
+void tst_QSettings::openAndReadKey_data()
+{
+    populateFormats();
+}
+
+// Cold start: a process opening a large settings file to read one key.
+void tst_QSettings::openAndReadKey()
+{
+    QFETCH(int, format);
+    const QString path = fileName(QSettings::Format(format));
+    QVariant value;
+
+    QBENCHMARK {
+        QConfFile::clearCache();
+        QSettings settings(path, QSettings::Format(format));
+        value = settings.value(QLatin1String("group42/key12342"));
+    }
+    QCOMPARE(value.toString(), QString::fromLatin1("value 12342"));
+}
+
+void tst_QSettings::setValueAndSync_data()
+{
+    populateFormats();
+}
+
+// Changing a single key in a large file and writing it back.
+void tst_QSettings::setValueAndSync()
+{
+    QFETCH(int, format);
+    QSettings settings(fileName(QSettings::Format(format)), QSettings::Format(format));
+    int counter = 0;
+
+    QBENCHMARK {
+        settings.setValue(QLatin1String("group7/counter"), ++counter);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "tst_qsettings.moc"
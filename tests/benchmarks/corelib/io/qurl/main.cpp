@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include <qurl.h>
+#include <private/qurlview_p.h>
 #include <qtest.h>
 
 class tst_qurl: public QObject
@@ -61,9 +62,15 @@ private slots:
     void equality_data();
     void equality();
     void qmlPropertyWriteUseCase();
+    void bulkParse_data();
+    void bulkParse();
+    void bulkHost_data();
+    void bulkHost();
 
 private:
     void generateFirstRunData();
+    void generateParserData();
+    QStringList generateUrls();
 };
 
 void tst_qurl::emptyUrl()
@@ -216,6 +223,98 @@ void tst_qurl::qmlPropertyWriteUseCase()
     }
 }
 
+void tst_qurl::generateParserData()
+{
+    QTest::addColumn<bool>("useView");
+
+    QTest::newRow("QUrl") << false;
+#ifdef QT_BUILD_INTERNAL
+    QTest::newRow("QUrlView") << true;
+#endif
+}
+
+// a crawler-like mix of 10000 URLs
+QStringList tst_qurl::generateUrls()
+{
+    static const char * const hosts[] = {
+        "www.example.com", "qt-project.org", "Downloads.Example.ORG:8080", "user:secret@ftp.example.net",
+        "127.0.0.1", "[::1]:8443", "cdn-7.static.example-images.com"
+    };
+    static const char * const paths[] = {
+        "/", "/index.html", "/doc/qt-5.1/qurl.html", "/search", "/a/b/c/d/e/f.png", "/path%20with%20spaces/",
+        "/~user/blog/2013/07/15/low-allocation-parsing"
+    };
+    static const char * const queries[] = {
+        "", "?q=qt", "?id=12345&session=abcdef0123456789", "?utf8=%E2%9C%93&page=2"
+    };
+
+    QStringList urls;
+    for (int i = 0; i < 10000; ++i) {
+        QString url = QLatin1String(i % 5 ? "http://" : "https://");
+        url += QLatin1String(hosts[i % 7]);
+        url += QLatin1String(paths[(i / 7) % 7]);
+        url += QLatin1String(queries[(i / 49) % 4]);
+        if (i % 11 == 0)
+            url += QLatin1String("#section-") + QString::number(i);
+        urls << url;
+    }
+    return urls;
+}
+
+void tst_qurl::bulkParse_data()
+{
+    generateParserData();
+}
+
+void tst_qurl::bulkParse()
+{
+    QFETCH(bool, useView);
+    const QStringList urls = generateUrls();
+
+    int valid = 0;
+    if (useView) {
+#ifdef QT_BUILD_INTERNAL // QUrlView is not exported otherwise
+        QBENCHMARK {
+            foreach (const QString &s, urls)
+                valid += QUrlView(s).isValid();
+        }
+#endif
+    } else {
+        QBENCHMARK {
+            foreach (const QString &s, urls)
+                valid += QUrl(s).isValid();
+        }
+    }
+    QVERIFY(valid >= urls.size());
+}
+
+void tst_qurl::bulkHost_data()
+{
+    generateParserData();
+}
+
+void tst_qurl::bulkHost()
+{
+    QFETCH(bool, useView);
+    const QStringList urls = generateUrls();
+
+    int length = 0;
+    if (useView) {
+#ifdef QT_BUILD_INTERNAL // QUrlView is not exported otherwise
+        QBENCHMARK {
+            foreach (const QString &s, urls)
+                length += QUrlView(s).host().length();
+        }
+#endif
+    } else {
+        QBENCHMARK {
+            foreach (const QString &s, urls)
+                length += QUrl(s).host().length();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
 QTEST_MAIN(tst_qurl)
 
 #include "main.moc"
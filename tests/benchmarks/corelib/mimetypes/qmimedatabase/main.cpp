@@ -48,8 +48,14 @@ class tst_QMimeDatabase: public QObject
 
 private slots:
     void inheritsPerformance();
+    void mimeTypeForFileName();
+    void mimeTypeForData_data();
+    void mimeTypeForData();
 };
 
+// These use the mime.cache provider if there is a mime.cache file;
+// run with QT_NO_MIME_CACHE=1 to measure the XML provider instead.
+
 void tst_QMimeDatabase::inheritsPerformance()
 {
     // Check performance of inherits().
@@ -83,5 +89,53 @@ void tst_QMimeDatabase::inheritsPerformance()
     // parsing XML, and then keeps being around 4.5 MB for all the in-memory hashes.
 }
 
+void tst_QMimeDatabase::mimeTypeForFileName()
+{
+    // a mix of simple and double extensions, globs with wildcards and
+    // literal file names, and names that match nothing
+    QStringList fileNames;
+    fileNames << QLatin1String("main.cpp") << QLatin1String("qstring.h") << QLatin1String("README")
+              << QLatin1String("Makefile") << QLatin1String("image.PNG") << QLatin1String("photo.jpeg")
+              << QLatin1String("archive.tar.gz") << QLatin1String("archive.tar.bz2") << QLatin1String("doc.pdf")
+              << QLatin1String("notes.txt") << QLatin1String("core") << QLatin1String("backup~")
+              << QLatin1String("song.mp3") << QLatin1String("movie.anim5") << QLatin1String("index.html")
+              << QLatin1String("my.file.with.dots") << QLatin1String("CMakeLists.txt") << QLatin1String("noextension");
+    QMimeDatabase db;
+    QVERIFY(db.mimeTypeForFile(fileNames.first(), QMimeDatabase::MatchExtension).isValid());
+
+    QBENCHMARK {
+        foreach (const QString &fileName, fileNames)
+            db.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension);
+    }
+}
+
+void tst_QMimeDatabase::mimeTypeForData_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray elf("\177ELF\002\001\001\000\000\000\000\000\000\000\000\000\002\000\076\000", 20);
+    elf += QByteArray(4096 - elf.size(), '\0');
+    QByteArray text;
+    while (text.size() < 4096)
+        text += "The quick brown fox jumps over the lazy dog.\n";
+
+    QTest::newRow("pdf") << QByteArray("%PDF-1.4\n%\xe2\xe3\xcf\xd3\n");
+    QTest::newRow("png") << QByteArray("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+    QTest::newRow("elf") << elf;
+    QTest::newRow("text") << text;
+    QTest::newRow("binary") << QByteArray(4096, '\1');
+}
+
+void tst_QMimeDatabase::mimeTypeForData()
+{
+    QFETCH(QByteArray, data);
+    QMimeDatabase db;
+    QVERIFY(db.mimeTypeForData(data).isValid());
+
+    QBENCHMARK {
+        db.mimeTypeForData(data);
+    }
+}
+
 QTEST_MAIN(tst_QMimeDatabase)
 #include "main.moc"
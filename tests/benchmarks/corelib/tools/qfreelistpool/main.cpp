@@ -0,0 +1,211 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFreeListPool>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QTest>
+
+// roughly the size of a small event
+struct Object
+{
+    void *data[8];
+};
+
+enum Allocator { Malloc, Pool, PoolBulk };
+Q_DECLARE_METATYPE(Allocator)
+
+enum { ObjectCount = 100000, BatchSize = 64 };
+
+class tst_QFreeListPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sameThread_data();
+    void sameThread();
+    void crossThread_data();
+    void crossThread();
+};
+
+static void populate()
+{
+    QTest::addColumn<Allocator>("allocator");
+    QTest::newRow("malloc") << Malloc;
+    QTest::newRow("pool") << Pool;
+    QTest::newRow("pool (bulk)") << PoolBulk;
+}
+
+static inline Object *allocate(QFreeListPool<Object> &pool, Allocator allocator)
+{
+    return allocator == Malloc ? new Object : pool.create();
+}
+
+static inline void release(QFreeListPool<Object> &pool, Allocator allocator,
+                           Object * const *objects, int count)
+{
+    switch (allocator) {
+    case Malloc:
+        for (int i = 0; i < count; ++i)
+            delete objects[i];
+        break;
+    case Pool:
+        for (int i = 0; i < count; ++i)
+            pool.destroy(objects[i]);
+        break;
+    case PoolBulk:
+        pool.destroy(objects, count);
+        break;
+    }
+}
+
+void tst_QFreeListPool::sameThread_data()
+{
+    populate();
+}
+
+void tst_QFreeListPool::sameThread()
+{
+    QFETCH(Allocator, allocator);
+    QFreeListPool<Object> pool;
+    Object *batch[BatchSize];
+
+    QBENCHMARK {
+        for (int i = 0; i < ObjectCount / BatchSize; ++i) {
+            for (int j = 0; j < BatchSize; ++j)
+                batch[j] = allocate(pool, allocator);
+            release(pool, allocator, batch, BatchSize);
+        }
+    }
+}
+
+// hands batches of objects from the producer to the consumer
+class Channel
+{
+public:
+    Channel() : count(0), done(false) { }
+
+    void put(Object * const *objects)
+    {
+        QMutexLocker locker(&mutex);
+        while (count == Capacity)
+            notFull.wait(&mutex);
+        memcpy(batches[count++], objects, sizeof(batches[0]));
+        notEmpty.wakeOne();
+    }
+    void finish()
+    {
+        QMutexLocker locker(&mutex);
+        done = true;
+        notEmpty.wakeOne();
+    }
+    bool take(Object **objects)
+    {
+        QMutexLocker locker(&mutex);
+        while (count == 0 && !done)
+            notEmpty.wait(&mutex);
+        if (count == 0)
+            return false;
+        memcpy(objects, batches[--count], sizeof(batches[0]));
+        notFull.wakeOne();
+        return true;
+    }
+
+private:
+    enum { Capacity = 16 };
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    Object *batches[Capacity][BatchSize];
+    int count;
+    bool done;
+};
+
+class Producer : public QThread
+{
+public:
+    Producer(QFreeListPool<Object> *pool, Allocator allocator, Channel *channel)
+        : pool(pool), allocator(allocator), channel(channel) { }
+
+    void run()
+    {
+        Object *batch[BatchSize];
+        for (int i = 0; i < ObjectCount / BatchSize; ++i) {
+            for (int j = 0; j < BatchSize; ++j)
+                batch[j] = allocate(*pool, allocator);
+            channel->put(batch);
+        }
+        channel->finish();
+    }
+
+    QFreeListPool<Object> *pool;
+    Allocator allocator;
+    Channel *channel;
+};
+
+void tst_QFreeListPool::crossThread_data()
+{
+    populate();
+}
+
+void tst_QFreeListPool::crossThread()
+{
+    // objects are allocated in one thread and freed in another, like
+    // posted events
+    QFETCH(Allocator, allocator);
+    QFreeListPool<Object> pool;
+    Object *batch[BatchSize];
+
+    QBENCHMARK {
+        Channel channel;
+        Producer producer(&pool, allocator, &channel);
+        producer.start();
+        while (channel.take(batch))
+            release(pool, allocator, batch, BatchSize);
+        producer.wait();
+    }
+}
+
+QTEST_MAIN(tst_QFreeListPool)
+
+#include "main.moc"
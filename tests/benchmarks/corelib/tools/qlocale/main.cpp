@@ -0,0 +1,292 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocale>
+#include <qnumeric.h>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <qtest.h>
+
+class tst_QLocale : public QObject
+{
+    Q_OBJECT
+private slots:
+    void toString_data();
+    void toString();
+    void byteArrayNumber_data();
+    void byteArrayNumber();
+    void toDouble_data();
+    void toDouble();
+    void byteArrayToDouble_data();
+    void byteArrayToDouble();
+    void textStreamWrite_data();
+    void textStreamWrite();
+    void textStreamRead_data();
+    void textStreamRead();
+    void jsonWrite_data();
+    void jsonWrite();
+    void jsonRead_data();
+    void jsonRead();
+
+private:
+    void addData();
+    void addFormatData();
+};
+
+static QVector<double> testDoubles(int kind)
+{
+    QVector<double> result;
+    result.reserve(1000);
+    quint64 state = Q_UINT64_C(88172645463325252);
+    while (result.size() < 1000) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        switch (kind) {
+        case 0: // prices and measurements, as found in CSV files
+            d = double(state % 10000000) / 100;
+            break;
+        case 1: // results of computations, needing all 17 digits
+            d = double(state >> 11) / double(Q_UINT64_C(1) << 53) * 1000;
+            break;
+        default: // any bit pattern
+            memcpy(&d, &state, sizeof(d));
+            if (!qIsFinite(d))
+                continue;
+            break;
+        }
+        result.append(d);
+    }
+    return result;
+}
+
+void tst_QLocale::addData()
+{
+    QTest::addColumn<int>("kind");
+    QTest::newRow("short") << 0;
+    QTest::newRow("computed") << 1;
+    QTest::newRow("random bits") << 2;
+}
+
+void tst_QLocale::addFormatData()
+{
+    QTest::addColumn<int>("kind");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+    for (int kind = 0; kind < 3; ++kind) {
+        const char *name = kind == 0 ? "short" : kind == 1 ? "computed" : "random bits";
+        QTest::newRow(QByteArray(name).append(", 'g' 6")) << kind << 'g' << 6;
+        QTest::newRow(QByteArray(name).append(", 'g' 17")) << kind << 'g' << 17;
+        QTest::newRow(QByteArray(name).append(", 'g' shortest")) << kind << 'g' << int(QLocale::FloatingPointShortest);
+        QTest::newRow(QByteArray(name).append(", 'e' 6")) << kind << 'e' << 6;
+        if (kind != 2)
+            QTest::newRow(QByteArray(name).append(", 'f' 2")) << kind << 'f' << 2;
+    }
+}
+
+void tst_QLocale::toString_data()
+{
+    addFormatData();
+}
+
+void tst_QLocale::toString()
+{
+    QFETCH(int, kind);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QVector<double> numbers = testDoubles(kind);
+
+    QBENCHMARK {
+        for (int i = 0; i < numbers.size(); ++i)
+            QString::number(numbers.at(i), format, precision);
+    }
+}
+
+void tst_QLocale::byteArrayNumber_data()
+{
+    addFormatData();
+}
+
+void tst_QLocale::byteArrayNumber()
+{
+    QFETCH(int, kind);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QVector<double> numbers = testDoubles(kind);
+
+    QBENCHMARK {
+        for (int i = 0; i < numbers.size(); ++i)
+            QByteArray::number(numbers.at(i), format, precision);
+    }
+}
+
+void tst_QLocale::toDouble_data()
+{
+    addData();
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+    QStringList strings;
+    for (int i = 0; i < numbers.size(); ++i)
+        strings.append(QString::number(numbers.at(i), 'g', QLocale::FloatingPointShortest));
+
+    QBENCHMARK {
+        for (int i = 0; i < strings.size(); ++i)
+            strings.at(i).toDouble();
+    }
+}
+
+void tst_QLocale::byteArrayToDouble_data()
+{
+    addData();
+}
+
+void tst_QLocale::byteArrayToDouble()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+    QList<QByteArray> strings;
+    for (int i = 0; i < numbers.size(); ++i)
+        strings.append(QByteArray::number(numbers.at(i), 'g', QLocale::FloatingPointShortest));
+
+    QBENCHMARK {
+        for (int i = 0; i < strings.size(); ++i)
+            strings.at(i).toDouble();
+    }
+}
+
+void tst_QLocale::textStreamWrite_data()
+{
+    addData();
+}
+
+void tst_QLocale::textStreamWrite()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+
+    QBENCHMARK {
+        QString output;
+        QTextStream stream(&output);
+        stream.setRealNumberPrecision(QLocale::FloatingPointShortest);
+        for (int i = 0; i < numbers.size(); ++i)
+            stream << numbers.at(i) << ',';
+        stream.flush();
+    }
+}
+
+void tst_QLocale::textStreamRead_data()
+{
+    addData();
+}
+
+void tst_QLocale::textStreamRead()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+    QString input;
+    {
+        QTextStream stream(&input);
+        stream.setRealNumberPrecision(QLocale::FloatingPointShortest);
+        for (int i = 0; i < numbers.size(); ++i)
+            stream << numbers.at(i) << ' ';
+    }
+
+    QBENCHMARK {
+        QTextStream stream(&input, QIODevice::ReadOnly);
+        double d;
+        for (int i = 0; i < numbers.size(); ++i)
+            stream >> d;
+    }
+}
+
+void tst_QLocale::jsonWrite_data()
+{
+    addData();
+}
+
+void tst_QLocale::jsonWrite()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+    QJsonArray array;
+    for (int i = 0; i < numbers.size(); ++i)
+        array.append(numbers.at(i));
+    const QJsonDocument document(array);
+
+    QBENCHMARK {
+        document.toJson();
+    }
+}
+
+void tst_QLocale::jsonRead_data()
+{
+    addData();
+}
+
+void tst_QLocale::jsonRead()
+{
+    QFETCH(int, kind);
+    const QVector<double> numbers = testDoubles(kind);
+    QJsonArray array;
+    for (int i = 0; i < numbers.size(); ++i)
+        array.append(numbers.at(i));
+    const QByteArray json = QJsonDocument(array).toJson();
+
+    QBENCHMARK {
+        QJsonDocument::fromJson(json);
+    }
+}
+
+QTEST_MAIN(tst_QLocale)
+
+#include "main.moc"
@@ -4,7 +4,9 @@ SUBDIRS = \
         containers-sequential \
         qbytearray \
         qcontiguouscache \
+        qfreelistpool \
         qlist \
+        qlocale \
         qmap \
         qrect \
         qregexp \
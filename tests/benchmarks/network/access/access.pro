@@ -4,3 +4,6 @@ SUBDIRS = \
         qnetworkreply \
         qnetworkreply_from_cache \
         qnetworkdiskcache
+
+contains(QT_CONFIG,private_tests):SUBDIRS += \
+        qhttpnetworkreply
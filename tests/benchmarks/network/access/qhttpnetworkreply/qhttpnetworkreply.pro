@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = tst_bench_qhttpnetworkreply
+
+QT -= gui
+QT += core-private network network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_qhttpnetworkreply.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
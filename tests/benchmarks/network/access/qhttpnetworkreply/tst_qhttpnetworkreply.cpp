@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+// This file contains benchmarks for parsing HTTP response headers.
+
+#include <QtTest/QtTest>
+#include <QtCore/qbytearraymatcher.h>
+#include "private/qhttpnetworkconnection_p.h"
+
+class tst_QHttpNetworkReply : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseHeader_data();
+    void parseHeader();
+    void parseHeaderLegacy_data();
+    void parseHeaderLegacy();
+};
+
+// The parser used by QHttpNetworkReply up to Qt 5.1, kept for comparison
+static QList<QPair<QByteArray, QByteArray> > legacyParseHeader(const QByteArray &header)
+{
+    QList<QPair<QByteArray, QByteArray> > fields;
+    const QByteArrayMatcher lf("\n");
+    const QByteArrayMatcher colon(":");
+    int i = 0;
+    while (i < header.count()) {
+        int j = colon.indexIn(header, i); // field-name
+        if (j == -1)
+            break;
+        const QByteArray field = header.mid(i, j - i).trimmed();
+        j++;
+        // any number of LWS is allowed before and after the value
+        QByteArray value;
+        do {
+            i = lf.indexIn(header, j);
+            if (i == -1)
+                break;
+            if (!value.isEmpty())
+                value += ' ';
+            // check if we have CRLF or only LF
+            bool hasCR = (i && header[i-1] == '\r');
+            int length = i -(hasCR ? 1: 0) - j;
+            value += header.mid(j, length).trimmed();
+            j = ++i;
+        } while (i < header.count() && (header.at(i) == ' ' || header.at(i) == '\t'));
+        if (i == -1)
+            break; // something is wrong
+
+        fields.append(qMakePair(field, value));
+    }
+    return fields;
+}
+
+void tst_QHttpNetworkReply::parseHeader_data()
+{
+    QTest::addColumn<QByteArray>("header");
+
+    QTest::newRow("api") << QByteArray(
+            "Date: Mon, 15 Jul 2013 10:21:03 GMT\r\n"
+            "Server: nginx/1.4.1\r\n"
+            "Content-Type: application/json; charset=utf-8\r\n"
+            "Content-Length: 1834\r\n"
+            "Connection: keep-alive\r\n"
+            "Cache-Control: no-cache\r\n"
+            "\r\n");
+    QTest::newRow("static-asset") << QByteArray(
+            "Accept-Ranges: bytes\r\n"
+            "Age: 86023\r\n"
+            "Cache-Control: public, max-age=31536000\r\n"
+            "Content-Encoding: gzip\r\n"
+            "Content-Type: application/javascript\r\n"
+            "Date: Mon, 15 Jul 2013 10:21:03 GMT\r\n"
+            "ETag: \"4f1a3b2c-1e2f4\"\r\n"
+            "Expires: Tue, 15 Jul 2014 10:21:03 GMT\r\n"
+            "Last-Modified: Fri, 12 Jul 2013 08:00:00 GMT\r\n"
+            "Server: ECS (fra/D4E3)\r\n"
+            "Vary: Accept-Encoding\r\n"
+            "X-Cache: HIT\r\n"
+            "Content-Length: 38912\r\n"
+            "\r\n");
+    QTest::newRow("web-page") << QByteArray(
+            "Date: Mon, 15 Jul 2013 10:21:03 GMT\r\n"
+            "Expires: -1\r\n"
+            "Cache-Control: private, max-age=0\r\n"
+            "Content-Type: text/html; charset=UTF-8\r\n"
+            "Set-Cookie: PREF=ID=58ef2d8a0bd4:FF=0:TM=1373883663:LM=1373883663:S=QqS0fGfT; expires=Wed, 15-Jul-2015 10:21:03 GMT; path=/; domain=.example.com\r\n"
+            "Set-Cookie: NID=67=Xq0ZJIhKf1p1HhY8Vw2ObVt6aLtN3y0rZbKCo6Ghz; expires=Tue, 14-Jan-2014 10:21:03 GMT; path=/; domain=.example.com; HttpOnly\r\n"
+            "Set-Cookie: session=0d7e3ab1c2; path=/; secure; HttpOnly\r\n"
+            "P3P: CP=\"This is not a P3P policy!\"\r\n"
+            "Server: gws\r\n"
+            "X-XSS-Protection: 1; mode=block\r\n"
+            "X-Frame-Options: SAMEORIGIN\r\n"
+            "Strict-Transport-Security: max-age=31536000\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n");
+    QTest::newRow("lowercase") << QByteArray(
+            "server: cloudflare-nginx\r\n"
+            "date: Mon, 15 Jul 2013 10:21:03 GMT\r\n"
+            "content-type: image/png\r\n"
+            "content-length: 4521\r\n"
+            "connection: keep-alive\r\n"
+            "last-modified: Fri, 12 Jul 2013 08:00:00 GMT\r\n"
+            "cache-control: public, max-age=604800\r\n"
+            "accept-ranges: bytes\r\n"
+            "\r\n");
+}
+
+void tst_QHttpNetworkReply::parseHeader()
+{
+    QFETCH(QByteArray, header);
+
+    QBENCHMARK {
+        QHttpNetworkReply reply;
+        reply.parseHeader(header);
+    }
+}
+
+void tst_QHttpNetworkReply::parseHeaderLegacy_data()
+{
+    parseHeader_data();
+}
+
+void tst_QHttpNetworkReply::parseHeaderLegacy()
+{
+    QFETCH(QByteArray, header);
+
+    QBENCHMARK {
+        QHttpNetworkReply reply;
+        QList<QPair<QByteArray, QByteArray> > fields = legacyParseHeader(header);
+        Q_UNUSED(fields);
+    }
+}
+
+QTEST_MAIN(tst_QHttpNetworkReply)
+
+#include "tst_qhttpnetworkreply.moc"
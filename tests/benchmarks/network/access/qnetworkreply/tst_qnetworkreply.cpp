@@ -50,6 +50,8 @@
 #include <QtNetwork/qtcpserver.h>
 #include "../../../../auto/network-settings.h"
 
+#include <ctime>
+
 
 Q_DECLARE_METATYPE(QSharedPointer<char>)
 
@@ -425,6 +427,39 @@ public slots:
     }
 };
 
+// Reads a file through the generic QIODevice interface, so that QNetworkAccessManager
+// cannot recognize it as a QFile and has to copy the upload data through user space.
+class FileProxyDevice : public QIODevice
+{
+    QFile *file;
+public:
+    FileProxyDevice(QFile *f) : file(f) { open(ReadOnly); }
+    qint64 size() const { return file->size(); }
+    bool seek(qint64 pos) { QIODevice::seek(pos); return file->seek(pos); }
+    bool reset() { QIODevice::seek(0); return file->seek(0); }
+protected:
+    qint64 readData(char *data, qint64 maxlen) { return file->read(data, maxlen); }
+    qint64 writeData(const char *, qint64) { return -1; }
+};
+
+class HttpDownloadToFileClient : QObject {
+    Q_OBJECT
+    QIODevice *device;
+    QFile *file;
+public:
+    HttpDownloadToFileClient(QIODevice *dev, QFile *f) : device(dev), file(f) {
+        connect(dev, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+    }
+
+public slots:
+    void readyReadSlot() {
+        char buffer[64*1024];
+        qint64 read;
+        while ((read = device->read(buffer, sizeof buffer)) > 0)
+            file->write(buffer, read);
+    }
+};
+
 class HttpDownloadPerformanceClient : QObject {
     Q_OBJECT;
     QIODevice *device;
@@ -470,6 +505,10 @@ private slots:
     void httpDownloadPerformance();
     void httpDownloadPerformanceDownloadBuffer_data();
     void httpDownloadPerformanceDownloadBuffer();
+    void httpUploadFromFile_data();
+    void httpUploadFromFile();
+    void httpDownloadToFile_data();
+    void httpDownloadToFile();
     void httpsRequestChain();
     void httpsUpload();
 
@@ -750,6 +789,103 @@ void tst_qnetworkreply::httpDownloadPerformanceDownloadBuffer()
     }
 }
 
+void tst_qnetworkreply::httpUploadFromFile_data()
+{
+    QTest::addColumn<bool>("uploadFromFileDescriptor");
+
+    QTest::newRow("sendfile") << true;
+    QTest::newRow("copy") << false;
+}
+
+void tst_qnetworkreply::httpUploadFromFile()
+{
+    QFETCH(bool, uploadFromFileDescriptor);
+#if defined(Q_OS_WINCE_WM)
+    // Show some mercy to non-desktop platform/s
+    enum {UploadSize = 4*1024*1024}; // 4 MB
+#else
+    enum {UploadSize = 128*1024*1024}; // 128 MB
+#endif
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray block(1024*1024, '@');
+    for (int i = 0; i < UploadSize / block.size(); ++i)
+        QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.seek(0));
+    FileProxyDevice proxy(&file);
+
+    ThreadedDataReaderHttpServer reader;
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(reader.serverPort()) + "/?bare=1"));
+    request.setHeader(QNetworkRequest::ContentLengthHeader, UploadSize);
+
+    QElapsedTimer timer;
+    std::clock_t cpu = std::clock();
+    timer.start();
+    QNetworkReplyPtr reply(manager.put(request, uploadFromFileDescriptor ? static_cast<QIODevice *>(&file)
+                                                                         : static_cast<QIODevice *>(&proxy)));
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+    QTestEventLoop::instance().enterLoop(40);
+    const qint64 elapsed = qMax(timer.elapsed(), qint64(1));
+    cpu = std::clock() - cpu;
+    reader.exit();
+    reader.wait();
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    qDebug() << "tst_QNetworkReply::httpUploadFromFile" << elapsed << "msec,"
+             << ((UploadSize/1024.0)/(elapsed/1000.0)) << "kB/sec,"
+             << (cpu * 1000 / CLOCKS_PER_SEC) << "msec CPU";
+}
+
+void tst_qnetworkreply::httpDownloadToFile_data()
+{
+    QTest::addColumn<bool>("downloadToFileDescriptor");
+
+    QTest::newRow("splice") << true;
+    QTest::newRow("copy") << false;
+}
+
+void tst_qnetworkreply::httpDownloadToFile()
+{
+    QFETCH(bool, downloadToFileDescriptor);
+#if defined(Q_OS_WINCE_WM)
+    // Show some mercy to non-desktop platform/s
+    enum {DownloadSize = 4*1024*1024}; // 4 MB
+#else
+    enum {DownloadSize = 128*1024*1024}; // 128 MB
+#endif
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    HttpDownloadPerformanceServer server(DownloadSize, true, false);
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/?bare=1"));
+    if (downloadToFileDescriptor)
+        request.setAttribute(QNetworkRequest::DownloadFileDescriptorAttribute, file.handle());
+
+    QElapsedTimer timer;
+    std::clock_t cpu = std::clock();
+    timer.start();
+    QNetworkReplyPtr reply(manager.get(request));
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()), Qt::QueuedConnection);
+    // without the attribute the application has to copy the data itself
+    QScopedPointer<HttpDownloadToFileClient> client;
+    if (!downloadToFileDescriptor)
+        client.reset(new HttpDownloadToFileClient(reply.data(), &file));
+    QTestEventLoop::instance().enterLoop(40);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    file.flush();
+    const qint64 elapsed = qMax(timer.elapsed(), qint64(1));
+    cpu = std::clock() - cpu;
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::DownloadFileDescriptorAttribute).isValid(), downloadToFileDescriptor);
+    QCOMPARE(file.size(), qint64(DownloadSize));
+
+    qDebug() << "tst_QNetworkReply::httpDownloadToFile" << elapsed << "msec,"
+             << ((DownloadSize/1024.0)/(elapsed/1000.0)) << "kB/sec,"
+             << (cpu * 1000 / CLOCKS_PER_SEC) << "msec CPU";
+}
+
 
 class HttpsRequestChainHelper : public QObject {
     Q_OBJECT
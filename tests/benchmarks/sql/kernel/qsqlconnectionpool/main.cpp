@@ -0,0 +1,221 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Strategy { ConnectionPerRequest, ConnectionPerThread, Pool };
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void requests_data();
+    void requests();
+
+private:
+    QTemporaryDir dir;
+};
+
+Q_DECLARE_METATYPE(tst_QSqlConnectionPool::Strategy)
+
+static const char templateName[] = "tst_bench_qsqlconnectionpool";
+static const int rowCount = 1000;
+
+// Runs a number of short requests, each looking up a few rows, the way a
+// server thread would
+class RequestThread : public QThread
+{
+public:
+    enum { Requests = 200, LookupsPerRequest = 5 };
+
+    RequestThread(tst_QSqlConnectionPool::Strategy strategy, QSqlConnectionPool *pool, int seed)
+        : strategy(strategy), pool(pool), seed(seed), failures(0) {}
+
+    static bool lookup(QSqlQuery &query, int id)
+    {
+        query.bindValue(0, id);
+        return query.exec() && query.next() && !query.value(0).toString().isEmpty();
+    }
+
+    bool request(QSqlQuery &query, int n)
+    {
+        for (int i = 0; i < LookupsPerRequest; ++i) {
+            if (!lookup(query, (seed * 7919 + n * 31 + i) % rowCount))
+                return false;
+        }
+        return true;
+    }
+
+    void run()
+    {
+        const QString statement = QLatin1String("SELECT name FROM items WHERE id = ?");
+        const QString threadName = QString::fromLatin1("%1_%2").arg(templateName).arg(seed);
+
+        switch (strategy) {
+        case tst_QSqlConnectionPool::ConnectionPerRequest:
+            for (int n = 0; n < Requests; ++n) {
+                {
+                    QSqlDatabase db = QSqlDatabase::cloneDatabase(
+                                QSqlDatabase::database(templateName, false), threadName);
+                    if (!db.open()) {
+                        ++failures;
+                        continue;
+                    }
+                    QSqlQuery query(db);
+                    if (!query.prepare(statement) || !request(query, n))
+                        ++failures;
+                }
+                QSqlDatabase::removeDatabase(threadName);
+            }
+            break;
+        case tst_QSqlConnectionPool::ConnectionPerThread: {
+            {
+                QSqlDatabase db = QSqlDatabase::cloneDatabase(
+                            QSqlDatabase::database(templateName, false), threadName);
+                if (!db.open()) {
+                    ++failures;
+                    break;
+                }
+                QSqlQuery query(db);
+                query.prepare(statement);
+                for (int n = 0; n < Requests; ++n) {
+                    if (!request(query, n))
+                        ++failures;
+                }
+            }
+            QSqlDatabase::removeDatabase(threadName);
+            break; }
+        case tst_QSqlConnectionPool::Pool:
+            for (int n = 0; n < Requests; ++n) {
+                QSqlDatabase db = pool->acquire();
+                if (!db.isOpen()) {
+                    ++failures;
+                    continue;
+                }
+                {
+                    QSqlQuery query = pool->cachedQuery(db, statement);
+                    if (!request(query, n))
+                        ++failures;
+                }
+                pool->release(db);
+            }
+            break;
+        }
+    }
+
+    tst_QSqlConnectionPool::Strategy strategy;
+    QSqlConnectionPool *pool;
+    int seed;
+    int failures;
+};
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable("QSQLITE"))
+        QSKIP("The SQLite driver is not available");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", templateName);
+    db.setDatabaseName(dir.path() + QLatin1String("/bench.db"));
+    QVERIFY(db.open());
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec("CREATE TABLE items (id INTEGER PRIMARY KEY, name VARCHAR(40))"));
+    QVERIFY(q.prepare("INSERT INTO items VALUES (?, ?)"));
+    QVariantList ids, names;
+    for (int i = 0; i < rowCount; ++i) {
+        ids << i;
+        names << QString::fromLatin1("item %1").arg(i);
+    }
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    QVERIFY(q.execBatch());
+    db.close();
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    QSqlDatabase::removeDatabase(templateName);
+}
+
+void tst_QSqlConnectionPool::requests_data()
+{
+    QTest::addColumn<Strategy>("strategy");
+    QTest::addColumn<int>("threadCount");
+
+    const int counts[] = { 1, 4, 8 };
+    for (int i = 0; i < 3; ++i) {
+        const QByteArray threads = " " + QByteArray::number(counts[i]) + " threads";
+        QTest::newRow("connection per request," + threads) << ConnectionPerRequest << counts[i];
+        QTest::newRow("connection per thread," + threads) << ConnectionPerThread << counts[i];
+        QTest::newRow("pool," + threads) << Pool << counts[i];
+    }
+}
+
+void tst_QSqlConnectionPool::requests()
+{
+    QFETCH(Strategy, strategy);
+    QFETCH(int, threadCount);
+
+    QSqlConnectionPool pool(templateName);
+    pool.setMaximumSize(threadCount);
+
+    QBENCHMARK {
+        QList<RequestThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new RequestThread(strategy, &pool, i);
+        foreach (RequestThread *thread, threads)
+            thread->start();
+        foreach (RequestThread *thread, threads) {
+            thread->wait();
+            QCOMPARE(thread->failures, 0);
+        }
+        qDeleteAll(threads);
+    }
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qsqlconnectionpool
+
+SOURCES += main.cpp
+
+QT = core sql testlib
@@ -63,6 +63,18 @@ public slots:
 private slots:
     void benchmark_data() { generic_data(); }
     void benchmark();
+    void fetchThroughput_data() { generic_data(); }
+    void fetchThroughput();
+    void fetchThroughputPrepared_data() { generic_data(); }
+    void fetchThroughputPrepared();
+    void rowScanVariant_data() { generic_data(); }
+    void rowScanVariant();
+    void rowScanTyped_data() { generic_data(); }
+    void rowScanTyped();
+    void batchInsert_data() { generic_data(); }
+    void batchInsert();
+    void sqliteQueries_data();
+    void sqliteQueries();
 
 private:
     // returns all database connections
@@ -70,6 +82,8 @@ private:
     void dropTestTables( QSqlDatabase db );
     void createTestTables( QSqlDatabase db );
     void populateTestTables( QSqlDatabase db );
+    void fetchRows(bool prepared);
+    void scanRows(bool typed);
 
     tst_Databases dbs;
 };
@@ -270,4 +284,245 @@ void tst_QSqlQuery::benchmark()
     tst_Databases::safeDropTable( db, tableName );
 }
 
+void tst_QSqlQuery::fetchRows(bool prepared)
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const int rowCount = 10000;
+    QSqlQuery q(db);
+    const QString tableName(qTableName("fetchThroughput", __FILE__));
+    tst_Databases::safeDropTable( db, tableName );
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, big BIGINT, val DOUBLE PRECISION, "
+                        "ts " + tst_Databases::dateTimeTypeName(db) + ", "
+                        "data " + tst_Databases::blobTypeName(db) + ")"));
+
+    db.transaction();
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?, ?, ?)"));
+    const QDateTime start(QDate(2013, 1, 1), QTime(0, 0));
+    for (int i = 0; i < rowCount; ++i) {
+        q.bindValue(0, i);
+        q.bindValue(1, qlonglong(i) * 1000000007);
+        q.bindValue(2, i * 0.25);
+        q.bindValue(3, start.addSecs(i));
+        q.bindValue(4, QByteArray(16, char(i)));
+        QVERIFY_SQL(q, exec());
+    }
+    db.commit();
+
+    const QString select = "SELECT id, big, val, ts, data FROM " + tableName;
+    q.setForwardOnly(true);
+    if (prepared)
+        QVERIFY_SQL(q, prepare(select + " WHERE id >= ?"));
+
+    QBENCHMARK {
+        if (prepared) {
+            q.bindValue(0, 0);
+            QVERIFY_SQL(q, exec());
+        } else {
+            QVERIFY_SQL(q, exec(select));
+        }
+        int rows = 0;
+        qint64 sum = 0;
+        while (q.next()) {
+            sum += q.value(0).toInt() + q.value(1).toLongLong() + qint64(q.value(2).toDouble())
+                    + q.value(3).toDateTime().date().day() + q.value(4).toByteArray().size();
+            ++rows;
+        }
+        QCOMPARE(rows, rowCount);
+        QVERIFY(sum > 0);
+    }
+
+    q.finish();
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::fetchThroughput()
+{
+    fetchRows(false);
+}
+
+void tst_QSqlQuery::fetchThroughputPrepared()
+{
+    fetchRows(true);
+}
+
+void tst_QSqlQuery::scanRows(bool typed)
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const int rowCount = 50000;
+    QSqlQuery q(db);
+    const QString tableName(qTableName("rowScan", __FILE__));
+    tst_Databases::safeDropTable( db, tableName );
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, big BIGINT, val DOUBLE PRECISION, "
+                        "txt VARCHAR(40))"));
+
+    db.transaction();
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?, ?)"));
+    for (int i = 0; i < rowCount; ++i) {
+        q.bindValue(0, i);
+        q.bindValue(1, qlonglong(i) * 1000000007);
+        q.bindValue(2, i * 0.25);
+        q.bindValue(3, QString("some text for row %1").arg(i));
+        QVERIFY_SQL(q, exec());
+    }
+    db.commit();
+
+    q.setForwardOnly(true);
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec("SELECT id, big, val, txt FROM " + tableName));
+        int rows = 0;
+        qint64 sum = 0;
+        if (typed) {
+            while (q.next()) {
+                sum += q.valueInt(0) + q.valueLongLong(1) + qint64(q.valueDouble(2))
+                        + q.valueUtf8(3).size();
+                ++rows;
+            }
+        } else {
+            while (q.next()) {
+                sum += q.value(0).toInt() + q.value(1).toLongLong() + qint64(q.value(2).toDouble())
+                        + q.value(3).toString().size();
+                ++rows;
+            }
+        }
+        QCOMPARE(rows, rowCount);
+        QVERIFY(sum > 0);
+    }
+
+    q.finish();
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::batchInsert()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const int rowCount = 10000;
+    QSqlQuery q(db);
+    const QString tableName(qTableName("batchInsert", __FILE__));
+    tst_Databases::safeDropTable( db, tableName );
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT, big BIGINT, val DOUBLE PRECISION, "
+                        "txt VARCHAR(40))"));
+
+    QVariantList ids, bigs, vals, texts;
+    for (int i = 0; i < rowCount; ++i) {
+        ids << i;
+        bigs << qlonglong(i) * 1000000007;
+        vals << i * 0.25;
+        texts << QString("some text for row %1").arg(i);
+    }
+
+    QSqlQuery clear(db);
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?, ?)"));
+    QBENCHMARK {
+        QVERIFY_SQL(clear, exec("DELETE FROM " + tableName));
+        q.bindValue(0, ids);
+        q.bindValue(1, bigs);
+        q.bindValue(2, vals);
+        q.bindValue(3, texts);
+        QVERIFY_SQL(q, execBatch());
+    }
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), rowCount);
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::sqliteQueries_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<QString>("options");
+
+    bool found = false;
+    foreach (const QString &dbName, dbs.dbNames) {
+        if (!QSqlDatabase::database(dbName, false).driverName().startsWith("QSQLITE"))
+            continue;
+        found = true;
+        QTest::newRow(qPrintable(dbName + ":default")) << dbName << QString();
+        QTest::newRow(qPrintable(dbName + ":utf16")) << dbName << QString("QSQLITE_UTF16_API");
+        QTest::newRow(qPrintable(dbName + ":nocache"))
+                << dbName << QString("QSQLITE_STATEMENT_CACHE_SIZE=0");
+    }
+    if (!found)
+        QSKIP("No database drivers of type QSQLITE are available in this Qt configuration");
+}
+
+// many short queries, each from a fresh QSqlQuery, as an application would
+// issue them, followed by a scan over a text-heavy result
+void tst_QSqlQuery::sqliteQueries()
+{
+    QFETCH( QString, dbName );
+    QFETCH( QString, options );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+    db.close();
+    db.setConnectOptions(options);
+    QVERIFY_SQL(db, open());
+
+    const int rowCount = 5000;
+    const QString tableName(qTableName("sqliteQueries", __FILE__));
+    {
+        QSqlQuery q(db);
+        tst_Databases::safeDropTable( db, tableName );
+        QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INT PRIMARY KEY, txt VARCHAR(200))"));
+        QVariantList ids, texts;
+        for (int i = 0; i < rowCount; ++i) {
+            ids << i;
+            texts << QString("some longer text for row %1, long enough to need a few blocks "
+                             "of conversion when it is read back").arg(i);
+        }
+        QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+        q.addBindValue(ids);
+        q.addBindValue(texts);
+        QVERIFY_SQL(q, execBatch());
+    }
+
+    const QString lookup = "SELECT txt FROM " + tableName + " WHERE id = ?";
+    const QString scan = "SELECT id, txt FROM " + tableName;
+    QBENCHMARK {
+        int size = 0;
+        for (int i = 0; i < 1000; ++i) {
+            QSqlQuery q(db);
+            QVERIFY_SQL(q, prepare(lookup));
+            q.addBindValue((i * 7) % rowCount);
+            QVERIFY_SQL(q, exec());
+            QVERIFY(q.next());
+            size += q.value(0).toString().size();
+        }
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        QVERIFY_SQL(q, exec(scan));
+        while (q.next())
+            size += q.value(1).toString().size();
+        QVERIFY(size > 0);
+    }
+
+    tst_Databases::safeDropTable( db, tableName );
+    db.close();
+    db.setConnectOptions();
+    QVERIFY_SQL(db, open());
+}
+
+void tst_QSqlQuery::rowScanVariant()
+{
+    scanRows(false);
+}
+
+void tst_QSqlQuery::rowScanTyped()
+{
+    scanRows(true);
+}
+
 #include "main.moc"